@@ -110,6 +110,110 @@ typedef enum {
     RAID5
 } Fam_Redundancy_Level;
 
+/**
+ * Type of the elements of a data item operated on by the memory server
+ */
+typedef enum {
+    FAM_INT32,
+    FAM_INT64,
+    FAM_UINT32,
+    FAM_UINT64,
+    FAM_FLOAT,
+    FAM_DOUBLE
+} Fam_Data_Type;
+
+/**
+ * Reduction computed by fam_reduce()
+ */
+typedef enum {
+    /** Sum of the elements; 0 if there are none */
+    FAM_REDUCE_SUM,
+    /** Smallest element */
+    FAM_REDUCE_MIN,
+    /** Largest element */
+    FAM_REDUCE_MAX
+} Fam_Reduce_Op;
+
+/**
+ * Comparison of a record field against a constant in a fam_scan() term
+ */
+typedef enum {
+    FAM_CMP_EQ,
+    FAM_CMP_NE,
+    FAM_CMP_LT,
+    FAM_CMP_LE,
+    FAM_CMP_GT,
+    FAM_CMP_GE
+} Fam_Compare_Op;
+
+/**
+ * Constant of a fam_scan() term; the member matching the type of the term
+ * is used
+ */
+typedef union {
+    int32_t i32;
+    int64_t i64;
+    uint32_t u32;
+    uint64_t u64;
+    float f32;
+    double f64;
+} Fam_Scan_Value;
+
+/**
+ * Term of a fam_scan() predicate: the field of the given type at byte
+ * offset fieldOffset of a record, compared with op against value
+ */
+typedef struct {
+    uint64_t fieldOffset;
+    Fam_Data_Type type;
+    Fam_Compare_Op op;
+    Fam_Scan_Value value;
+} Fam_Scan_Term;
+
+/** Largest number of terms of a fam_scan() predicate */
+#define FAM_SCAN_MAX_TERMS 4
+
+/**
+ * How the terms of a fam_scan() predicate are combined
+ */
+typedef enum {
+    /** A record matches if all of the terms match */
+    FAM_SCAN_AND,
+    /** A record matches if any of the terms matches */
+    FAM_SCAN_OR
+} Fam_Scan_Combine;
+
+/**
+ * Predicate of fam_scan(), of 1 to FAM_SCAN_MAX_TERMS terms
+ */
+typedef struct {
+    Fam_Scan_Combine combine;
+    uint32_t numTerms;
+    Fam_Scan_Term terms[FAM_SCAN_MAX_TERMS];
+} Fam_Scan_Predicate;
+
+/**
+ * What fam_scan() writes to the destination data item
+ */
+typedef enum {
+    /** Nothing; only the matches are counted */
+    FAM_SCAN_COUNT,
+    /** The index of each matching record, as a uint64_t */
+    FAM_SCAN_INDICES,
+    /** A copy of each matching record */
+    FAM_SCAN_RECORDS
+} Fam_Scan_Output;
+
+/**
+ * Kinds of lock created by fam_lock_create()
+ */
+typedef enum {
+    /** Held by one holder at a time */
+    FAM_LOCK_MUTEX,
+    /** Held by any number of readers, or by one writer */
+    FAM_LOCK_RW
+} Fam_Lock_Type;
+
 /**
  * FAM Global descriptor represents both the region and data item in FAM.
  */
@@ -123,6 +227,25 @@ typedef struct {
     uint64_t offset;
 } Fam_Global_Descriptor;
 
+/**
+ * Team of PEs running collectives through FAM, from fam_team_create().
+ * Opaque to applications.
+ */
+class Fam_Team;
+
+/**
+ * Handle of a lock in FAM, from fam_lock_create() or fam_lock_open().
+ * Opaque to applications.
+ */
+class Fam_Lock;
+typedef Fam_Lock fam_lock_t;
+
+/**
+ * Handle of a control operation in progress, from fam_allocate_async(),
+ * fam_lookup_async() or fam_deallocate_async(). Opaque to applications.
+ */
+class Fam_Async_Handle;
+
 /**
  * Structure defining a FAM descriptor. Descriptors are PE independent data
  * structures that enable the OpenFAM library to uniquely locate an area of
@@ -157,8 +280,24 @@ class Fam_Descriptor {
     uint64_t get_size();
     // get memory server id
     uint64_t get_memserver_id();
+    // set offset of the data item within the memory registered with its key
+    void set_key_offset(uint64_t keyOffset);
+    // get offset of the data item within the memory registered with its key
+    uint64_t get_key_offset();
+    // mark the data item as carved out of a chunk by fam_allocate_local_pool
+    void set_pool_item();
+    // true if the data item was allocated by fam_allocate_local_pool
+    bool is_pool_item();
+    // mark a pool item deallocated, false if it already was
+    bool release_pool_item();
+    // allocated on a cache line boundary
+    static void *operator new(size_t size);
+    static void operator delete(void *ptr);
 
   private:
+    friend struct Fam_Descriptor_Access;
+    // fields the datapath reads on every operation, kept in one cache line
+    alignas(64) unsigned char hot_[64];
     class FamDescriptorImpl_;
     FamDescriptorImpl_ *fdimpl_;
 };
@@ -208,6 +347,113 @@ typedef struct {
     void *base;
 } Fam_Region_Item_Info;
 
+/**
+ * Memory server of the statistics of operations that are not bound to one
+ * memory server, such as fam_create_region, or run without memory servers
+ */
+#define FAM_STATS_NO_MEMSERVER UINT64_MAX
+
+/**
+ * Transfer size bound of the largest size class, which has no upper bound
+ */
+#define FAM_STATS_NO_SIZE_LIMIT UINT64_MAX
+
+/**
+ * Latency statistics of one API for one memory server and transfer size
+ * class. Latencies are in nanoseconds; percentiles are upper bounds of the
+ * histogram bucket they fall in.
+ */
+typedef struct {
+    /** Name of the API, as in fam_counters.tbl */
+    const char *api;
+    /** Memory server the operations went to, or FAM_STATS_NO_MEMSERVER */
+    uint64_t memoryServerId;
+    /** Largest transfer size in bytes counted in this size class */
+    uint64_t maxBytes;
+    /** Number of calls recorded */
+    uint64_t count;
+    /** Sum of the latencies of all calls */
+    uint64_t total;
+    /** Median, 99th and 99.9th percentile, and largest latency */
+    uint64_t p50;
+    uint64_t p99;
+    uint64_t p999;
+    uint64_t max;
+} Fam_Stats_Entry;
+
+/**
+ * Point in time copy of the latency statistics, from fam_stats_snapshot()
+ */
+typedef struct {
+    /** Number of entries; only combinations with recorded calls appear */
+    uint64_t numEntries;
+    Fam_Stats_Entry *entries;
+} Fam_Stats_Snapshot;
+
+/**
+ * Usage of a region whose heap is open on a memory server. Only data items
+ * allocated since the memory server opened the heap are counted.
+ */
+typedef struct {
+    uint64_t regionId;
+    /** Live data items, and the bytes requested for them */
+    uint64_t numDataitems;
+    uint64_t allocatedBytes;
+    /** Bytes taken from the heap for those data items, after rounding up
+     * to the object or slab class size */
+    uint64_t reservedBytes;
+    /** Passes of the heap maintenance thread merging free space, and the
+     * time spent in them in nanoseconds */
+    uint64_t numMerges;
+    uint64_t totalMergeNs;
+    /** Bytes freed to the heap and not merged yet */
+    uint64_t freedBytesSinceMerge;
+    /** Allocations which failed and requested a merge */
+    uint64_t allocFailures;
+} Fam_Server_Region_Stats;
+
+/**
+ * Calls of one RPC served by a memory server
+ */
+typedef struct {
+    /** Name of the RPC, as in fam_rpc.proto */
+    char *rpc;
+    uint64_t calls;
+    /** Sum and largest of the time spent in the handler, in nanoseconds */
+    uint64_t totalNs;
+    uint64_t maxNs;
+} Fam_Server_Rpc_Stats;
+
+/**
+ * State of a memory server, from fam_server_stats()
+ */
+typedef struct {
+    uint64_t memoryServerId;
+    /** Heaps open, and memory regions registered with libfabric */
+    uint64_t numHeaps;
+    uint64_t numMemoryRegistrations;
+    /** PEs connected to the memory server */
+    uint64_t numClients;
+    /** Copy requests being served, and served in total */
+    uint64_t copiesInProgress;
+    uint64_t numCopies;
+    /** Passes of the libfabric progress thread; 0 with providers which do
+     * not need manual progress */
+    uint64_t progressLoops;
+    /** Startup recovery: 1 once all existing regions are open, the regions
+     * found, opened and failed to open, and the time taken in nanoseconds */
+    uint64_t ready;
+    uint64_t recoveryRegions;
+    uint64_t recoveredRegions;
+    uint64_t recoveryFailures;
+    uint64_t recoveryNs;
+    uint64_t numRegions;
+    Fam_Server_Region_Stats *regions;
+    /** RPCs called at least once */
+    uint64_t numRpcs;
+    Fam_Server_Rpc_Stats *rpcs;
+} Fam_Server_Stats;
+
 /**
  * Structure defining FAM options. This structure holds system wide information
  * required to initialize the OpenFAM library and the associated program using
@@ -237,6 +483,21 @@ typedef struct {
     char *numConsumer;
     /** FAM runtime - Default, pmix*/
     char *runtime;
+    /** Size of the chunks leased by fam_allocate_local_pool; 1MiB by
+     * default */
+    char *localPoolChunkSize;
+    /** Depth of the queue of each thread posting nonblocking operations in
+     * shared memory model; 1024 by default */
+    char *asyncQueueDepth;
+    /** When shared memory writes are made persistent; FAM_PERSIST_EAGER
+     * by default, FAM_PERSIST_DEFERRED defers it to fam_quiet */
+    char *persistMode;
+    /** Latency statistics of API calls; FAM_STATS_DISABLE by default,
+     * FAM_STATS_ENABLE records them for fam_stats_snapshot */
+    char *famStats;
+    /** Trace of API calls and fabric operations; FAM_TRACE_DISABLE by
+     * default, FAM_TRACE_ENABLE records it for fam_trace_dump */
+    char *famTrace;
 } Fam_Options;
 
 class fam {
@@ -375,6 +636,28 @@ class fam {
                                  mode_t accessPermissions,
                                  Fam_Region_Descriptor *region);
 
+    /**
+     * Allocate some unnamed space within a region from a chunk of FAM leased
+     * by this PE. Only the lease of a new chunk requires a round trip to the
+     * memory server; items larger than LOCAL_POOL_CHUNK_SIZE are allocated
+     * as with fam_allocate. Items are released with fam_deallocate, and the
+     * chunk is returned to the memory server once all its items are
+     * deallocated.
+     * Items carved out of a chunk can not be used with
+     * fam_change_permissions, fam_map, fam_copy, fam_reduce or fam_scan,
+     * which act on whole data items on the memory server.
+     * @param nybtes - size of the space to allocate in bytes.
+     * @param accessPermissions - permissions associated with this space
+     * @param region - descriptor of the region within which the space is being
+     * allocated.
+     * @return - descriptor that can be used within the program to refer to this
+     * space
+     * @see #fam_deallocate()
+     */
+    Fam_Descriptor *fam_allocate_local_pool(uint64_t nbytes,
+                                            mode_t accessPermissions,
+                                            Fam_Region_Descriptor *region);
+
     /**
      * Deallocate allocated space in memory
      * @param descriptor - descriptor associated with the space.
@@ -382,6 +665,64 @@ class fam {
      */
     void fam_deallocate(Fam_Descriptor *descriptor);
 
+    /**
+     * fam_allocate_async - starts fam_allocate() and returns without waiting
+     * for the memory server, so that a PE can have many allocations, lookups
+     * and deallocations in flight, on all memory servers at once.
+     * @param name - name of the data item
+     * @param nbytes - size of the data item in bytes
+     * @param accessPermissions - permissions of the data item
+     * @param region - region within which the data item is allocated
+     * @return - handle to pass to fam_async_wait(), which returns the
+     * descriptor of the data item
+     * @see #fam_allocate()
+     */
+    Fam_Async_Handle *fam_allocate_async(const char *name, uint64_t nbytes,
+                                         mode_t accessPermissions,
+                                         Fam_Region_Descriptor *region);
+
+    /**
+     * fam_lookup_async - starts fam_lookup() and returns without waiting for
+     * the memory server.
+     * @param itemName - name of the data item
+     * @param regionName - name of the region containing the data item
+     * @return - handle to pass to fam_async_wait(), which returns the
+     * descriptor of the data item
+     * @see #fam_lookup()
+     */
+    Fam_Async_Handle *fam_lookup_async(const char *itemName,
+                                       const char *regionName);
+
+    /**
+     * fam_deallocate_async - starts fam_deallocate() and returns without
+     * waiting for the memory server. The descriptor must not be used, nor
+     * deleted, until the operation has completed.
+     * @param descriptor - descriptor of the data item
+     * @return - handle to pass to fam_async_wait(), which returns NULL
+     * @see #fam_deallocate()
+     */
+    Fam_Async_Handle *fam_deallocate_async(Fam_Descriptor *descriptor);
+
+    /**
+     * fam_async_test - checks whether an asynchronous operation has
+     * completed, without waiting for it
+     * @param handle - handle of the operation
+     * @return - true if fam_async_wait() would return without waiting
+     */
+    bool fam_async_test(Fam_Async_Handle *handle);
+
+    /**
+     * fam_async_wait - waits for an asynchronous operation to complete, and
+     * releases its handle. Every handle must be waited for exactly once.
+     * @param handle - handle of the operation
+     * @return - descriptor of the data item allocated or looked up, NULL for
+     * a deallocation
+     * @throws Fam_InvalidOption_Exception.
+     * @throws Fam_Allocator_Exception - the exception the operation would
+     * have thrown if called synchronously
+     */
+    Fam_Descriptor *fam_async_wait(Fam_Async_Handle *handle);
+
     /**
      * Change permissions associated with a data item descriptor.
      * @param descriptor - descriptor associated with some data item
@@ -480,7 +821,10 @@ class fam {
 
     /**
      * Map a data item in FAM to the local virtual address space, and return its
-     * pointer.
+     * pointer. With memory servers, the data item is paged into the local
+     * address space on demand, and stores are written back to FAM by
+     * fam_fence(), fam_quiet() and fam_unmap(). This requires the
+     * FAM_THREAD_MULTIPLE thread model.
      * @param descriptor - descriptor to be mapped
      * @return pointer within the process virtual address space that can be used
      * to directly access the data item in FAM
@@ -680,6 +1024,60 @@ class fam {
      * @param waitObj - unique tag to copy operation
      */
     void fam_copy_wait(void *waitObj);
+
+    // REDUCTION Subgroup
+
+    /**
+     * fam_reduce - reduces an array of elements of a data item where it
+     * resides, and returns only the result. The memory server reads the
+     * elements from its local memory; pending non-blocking writes of the
+     * PE are not waited for, so call fam_quiet() first if needed.
+     * @param descriptor - valid descriptor to a data item in FAM.
+     * @param offset - byte offset of the first element within the data item
+     * @param count - number of elements to reduce
+     * @param type - type of the elements
+     * @param op - reduction to compute
+     * @param result - receives a sum as an int64_t for signed types, a
+     * uint64_t for unsigned types and a double for FAM_FLOAT and FAM_DOUBLE,
+     * or a minimum or maximum as an element of the given type. Integer sums
+     * wrap around; floating point sums are not accumulated in element order.
+     * @throws Fam_InvalidOption_Exception.
+     * @throws Fam_Allocator_Exception - excptObj->fam_error() may return:
+     *         FAM_ERR_NOPERM, FAM_ERR_NOTFOUND, FAM_ERR_OUTOFRANGE,
+     *         FAM_ERR_INVALID, FAM_ERR_GRPC
+     */
+    void fam_reduce(Fam_Descriptor *descriptor, uint64_t offset,
+                    uint64_t count, Fam_Data_Type type, Fam_Reduce_Op op,
+                    void *result);
+
+    /**
+     * fam_scan - filters an array of fixed size records of a data item
+     * where it resides. The memory server evaluates the predicate over every
+     * record and writes the indices or copies of the matching records, in
+     * record order, to the destination data item. The destination must be
+     * on the same memory server as the source. Pending non-blocking writes
+     * of the PE are not waited for, so call fam_quiet() first if needed.
+     * @param source - valid descriptor to a data item in FAM.
+     * @param offset - byte offset of the first record within the data item
+     * @param recordSize - size of a record in bytes
+     * @param numRecords - number of records to scan
+     * @param predicate - predicate the records are matched against
+     * @param output - what is written for a matching record
+     * @param destination - valid descriptor to the data item written to, or
+     * NULL with FAM_SCAN_COUNT
+     * @param destOffset - byte offset within the destination at which the
+     * results are written. Results that do not fit are not written.
+     * @return - number of matching records, including those not written
+     * @throws Fam_InvalidOption_Exception.
+     * @throws Fam_Allocator_Exception - excptObj->fam_error() may return:
+     *         FAM_ERR_NOPERM, FAM_ERR_NOTFOUND, FAM_ERR_OUTOFRANGE,
+     *         FAM_ERR_INVALID, FAM_ERR_GRPC
+     */
+    uint64_t fam_scan(Fam_Descriptor *source, uint64_t offset,
+                      uint64_t recordSize, uint64_t numRecords,
+                      Fam_Scan_Predicate *predicate, Fam_Scan_Output output,
+                      Fam_Descriptor *destination, uint64_t destOffset);
+
     // ATOMICS Group
 
     // NON fetching routines
@@ -1019,7 +1417,8 @@ class fam {
      * issued by the calling PE thread before the fence are ordered before FAM
      * operations issued by the calling thread after the fence Note that method
      * this does NOT order load/store accesses by the processor to FAM enabled
-     * by fam_map().
+     * by fam_map(), except that with memory servers, stores to mapped data
+     * items are written back to FAM before the fence.
      */
     void fam_fence(void);
 
@@ -1027,10 +1426,265 @@ class fam {
      * fam_quiet - blocks the calling PE thread until all its pending FAM
      * operations (put, scatter, atomics, copy) are completed. Note that method
      * this does NOT order or wait for completion of load/store accesses by the
-     * processor to FAM enabled by fam_map().
+     * processor to FAM enabled by fam_map(), except that with memory servers,
+     * stores to mapped data items are written back to FAM.
      */
     void fam_quiet(void);
 
+    // COLLECTIVES Routines - synchronize and combine data across PEs through
+    // FAM atomics and data path operations, without the runtime
+
+    /**
+     * fam_team_create - creates a team of all PE_COUNT PEs, identified by
+     * PE_ID. Must be called by all of them with the same arguments. PE 0
+     * allocates a scratch data item with the given name in the region,
+     * which must not already exist; the others look it up. Waits until all
+     * PEs have joined.
+     * @param name - name of the scratch data item
+     * @param regionName - name of the region holding the scratch data item
+     * @param maxBytes - largest broadcast or allreduce of the team, in bytes.
+     * The scratch data item takes about PE_COUNT + 3 times maxBytes.
+     * @return - team to pass to the collectives
+     * @throws Fam_InvalidOption_Exception, Fam_Timeout_Exception.
+     * @throws Fam_Allocator_Exception - excptObj->fam_error() may return:
+     *         FAM_ERR_NOPERM, FAM_ERR_NOTFOUND, FAM_ERR_ALREADYEXIST,
+     *         FAM_ERR_GRPC
+     */
+    Fam_Team *fam_team_create(const char *name, const char *regionName,
+                              uint64_t maxBytes);
+
+    /**
+     * fam_team_create - creates a team of numPEs PEs, as above, for PEs
+     * that are not started by a runtime, such as with RUNTIME NONE.
+     * @param numPEs - number of PEs in the team
+     * @param myPE - index of the calling PE in the team, from 0 to numPEs - 1
+     */
+    Fam_Team *fam_team_create(const char *name, const char *regionName,
+                              uint64_t maxBytes, int numPEs, int myPE);
+
+    /**
+     * fam_team_destroy - leaves a team after a last barrier. Must be called by
+     * all PEs of the team. PE 0 deallocates the scratch data item once all
+     * PEs have left.
+     * @param team - team from fam_team_create()
+     */
+    void fam_team_destroy(Fam_Team *team);
+
+    /**
+     * fam_barrier - suspends the calling PE until all PEs of the team have
+     * called fam_barrier. A dissemination barrier over FAM atomics, taking
+     * log2 of the number of PEs rounds. Blocking FAM operations completed
+     * before the barrier are visible to all PEs after it; call fam_quiet()
+     * first for non-blocking ones.
+     * @param team - team from fam_team_create()
+     */
+    void fam_barrier(Fam_Team *team);
+
+    /**
+     * fam_broadcast - copies data from the root PE of the team to all others.
+     * Must be called by all PEs of the team.
+     * @param team - team from fam_team_create()
+     * @param data - data to send at the root, buffer to receive into at the
+     * other PEs
+     * @param nbytes - size of the data, at most the maxBytes of the team
+     * @param root - PE sending the data
+     * @throws Fam_InvalidOption_Exception.
+     */
+    void fam_broadcast(Fam_Team *team, void *data, uint64_t nbytes,
+                       int root);
+
+    /**
+     * fam_allreduce - combines arrays of all PEs of the team element by
+     * element, and returns the result to all of them. Must be called by all
+     * PEs of the team. Sums are computed in the element type, so integer sums
+     * wrap around, and floating point sums may differ in the last bits from
+     * sums made in another order.
+     * @param team - team from fam_team_create()
+     * @param data - elements of the calling PE, replaced by the result
+     * @param count - number of elements, at most maxBytes of the team in size
+     * @param type - type of the elements
+     * @param op - reduction to compute
+     * @throws Fam_InvalidOption_Exception.
+     */
+    void fam_allreduce(Fam_Team *team, void *data, uint64_t count,
+                       Fam_Data_Type type, Fam_Reduce_Op op);
+
+    // LOCKS Routines - mutual exclusion between PEs on FAM data, through
+    // queue locks kept in data items and used with FAM atomics
+
+    /**
+     * fam_lock_create - allocates a data item holding a lock, and opens it.
+     * Handing the lock over costs a constant number of FAM atomics whatever
+     * the number of waiters, each of which polls a word of its own.
+     * @param name - name of the data item
+     * @param region - region in which to allocate the data item
+     * @param type - FAM_LOCK_MUTEX or FAM_LOCK_RW
+     * @param maxHolders - largest number of handles open on the lock at once
+     * @return - handle of the lock, to be closed with fam_lock_close() or
+     * fam_lock_destroy()
+     * @throws Fam_InvalidOption_Exception.
+     * @throws Fam_Allocator_Exception - excptObj->fam_error() may return:
+     *         FAM_ERR_NOPERM, FAM_ERR_ALREADYEXIST, FAM_ERR_GRPC
+     */
+    fam_lock_t *fam_lock_create(const char *name,
+                                Fam_Region_Descriptor *region,
+                                Fam_Lock_Type type, uint64_t maxHolders);
+
+    /**
+     * fam_lock_open - opens a lock created by fam_lock_create(). Every thread
+     * contending for the lock needs a handle of its own.
+     * @param name - name of the data item holding the lock
+     * @param regionName - name of the region holding the data item
+     * @return - handle of the lock, to be closed with fam_lock_close()
+     * @throws Fam_InvalidOption_Exception.
+     * @throws Fam_Allocator_Exception - excptObj->fam_error() may return:
+     *         FAM_ERR_NOPERM, FAM_ERR_NOTFOUND, FAM_ERR_RESOURCE if maxHolders
+     *         handles are open already, FAM_ERR_GRPC
+     */
+    fam_lock_t *fam_lock_open(const char *name, const char *regionName);
+
+    /**
+     * fam_lock_close - closes a handle of a lock, which must not be held
+     * through it
+     * @param lock - handle of the lock
+     * @throws Fam_InvalidOption_Exception.
+     */
+    void fam_lock_close(fam_lock_t *lock);
+
+    /**
+     * fam_lock_destroy - closes a handle of a lock and deallocates the data
+     * item holding the lock. No other handle may be open on the lock.
+     * @param lock - handle of the lock
+     * @throws Fam_InvalidOption_Exception, Fam_Allocator_Exception.
+     */
+    void fam_lock_destroy(fam_lock_t *lock);
+
+    /**
+     * fam_lock - waits in the queue of the lock until it holds the lock; for
+     * a FAM_LOCK_RW lock, as the only writer.
+     * @param lock - handle of the lock, not holding it
+     * @throws Fam_InvalidOption_Exception.
+     */
+    void fam_lock(fam_lock_t *lock);
+
+    /**
+     * fam_trylock - takes the lock as fam_lock() does, if no PE holds it or
+     * waits for it
+     * @param lock - handle of the lock, not holding it
+     * @return - true if the lock was taken
+     * @throws Fam_InvalidOption_Exception.
+     */
+    bool fam_trylock(fam_lock_t *lock);
+
+    /**
+     * fam_timedlock - retries fam_trylock() with a growing pause until it
+     * succeeds or the timeout expires. A timed waiter does not join the
+     * queue, so it only gets the lock at a moment when no PE holds it or
+     * waits for it: while PEs waiting in fam_lock() or fam_rdlock() keep
+     * the queue busy, it fails at the timeout however long it is. Use
+     * fam_lock() where a PE has to be sure to get the lock in turn.
+     * @param lock - handle of the lock, not holding it
+     * @param timeoutUsec - timeout in microseconds
+     * @return - true if the lock was taken
+     * @throws Fam_InvalidOption_Exception.
+     */
+    bool fam_timedlock(fam_lock_t *lock, uint64_t timeoutUsec);
+
+    /**
+     * fam_rdlock - waits in the queue of a FAM_LOCK_RW lock until it holds
+     * the lock as a reader. Readers queued one behind the other are let in
+     * together; a reader queued behind a writer waits for it.
+     * @param lock - handle of the lock, not holding it
+     * @throws Fam_InvalidOption_Exception.
+     */
+    void fam_rdlock(fam_lock_t *lock);
+
+    /**
+     * fam_tryrdlock - takes the lock as fam_rdlock() does, if no PE is
+     * queued on it
+     * @param lock - handle of the lock, not holding it
+     * @return - true if the lock was taken
+     * @throws Fam_InvalidOption_Exception.
+     */
+    bool fam_tryrdlock(fam_lock_t *lock);
+
+    /**
+     * fam_timedrdlock - retries fam_tryrdlock() with a growing pause until
+     * it succeeds or the timeout expires. Like fam_timedlock(), it does not
+     * join the queue and only succeeds while no PE is queued on the lock,
+     * even if the lock is held by readers only; under steady contention it
+     * fails at the timeout. Use fam_rdlock() to wait in turn.
+     * @param lock - handle of the lock, not holding it
+     * @param timeoutUsec - timeout in microseconds
+     * @return - true if the lock was taken
+     * @throws Fam_InvalidOption_Exception.
+     */
+    bool fam_timedrdlock(fam_lock_t *lock, uint64_t timeoutUsec);
+
+    /**
+     * fam_unlock - releases the lock held through the handle, and hands it to
+     * the next PE in its queue, if any. Blocking FAM operations completed
+     * while holding the lock are visible to the next holder; call fam_quiet()
+     * first for non-blocking ones.
+     * @param lock - handle of the lock, holding it
+     * @throws Fam_InvalidOption_Exception.
+     */
+    void fam_unlock(fam_lock_t *lock);
+
+    // STATISTICS Routines - latency of the OpenFAM API calls of the PE
+
+    /**
+     * fam_stats_snapshot - returns the latency histograms recorded so far by
+     * all threads of the PE, per API, memory server and transfer size class.
+     * Statistics are recorded only if the FAM_STATS option is
+     * FAM_STATS_ENABLE; otherwise the snapshot has no entries.
+     * @return - snapshot to be released with fam_stats_free()
+     * @see #fam_stats_json()
+     */
+    Fam_Stats_Snapshot *fam_stats_snapshot(void);
+
+    /**
+     * fam_stats_free - releases a snapshot from fam_stats_snapshot()
+     * @param snapshot - snapshot to be released
+     */
+    void fam_stats_free(Fam_Stats_Snapshot *snapshot);
+
+    /**
+     * fam_stats_json - formats a snapshot as a JSON document
+     * @param snapshot - snapshot from fam_stats_snapshot()
+     * @return - NUL terminated JSON text, to be released with free()
+     */
+    char *fam_stats_json(Fam_Stats_Snapshot *snapshot);
+
+    /**
+     * fam_server_stats - returns the state of a memory server: open heaps,
+     * registered memory, usage of each open region, calls and handler
+     * latency of each RPC, copies and progress thread activity. Counters
+     * are read without stopping the memory server, so they are not a
+     * consistent point in time view.
+     * @param memoryServerId - memory server to query
+     * @return - statistics to be released with fam_server_stats_free()
+     * @throws Fam_Allocator_Exception - excptObj->fam_error() may return:
+     *         FAM_ERR_RPC_CLIENT_NOTFOUND, FAM_ERR_GRPC
+     */
+    Fam_Server_Stats *fam_server_stats(uint64_t memoryServerId);
+
+    /**
+     * fam_server_stats_free - releases statistics from fam_server_stats()
+     * @param stats - statistics to be released
+     */
+    void fam_server_stats_free(Fam_Server_Stats *stats);
+
+    /**
+     * fam_trace_dump - writes the recent API calls and fabric operations of
+     * all threads of the PE to a file, as Chrome trace-event JSON. Calls are
+     * traced only if the FAM_TRACE option is FAM_TRACE_ENABLE, in which case
+     * SIGUSR2 also dumps the trace to fam_trace.<pid>.json.
+     * @param path - file to write the trace to
+     * @return - 0 on success, -1 if the file could not be written
+     */
+    int fam_trace_dump(const char *path);
+
     /**
      * fam() - constructor for fam class
      */
@@ -33,6 +33,7 @@
 #include <sys/types.h>
 
 #include "fam/fam.h"
+#include "common/fam_async_handle.h"
 #include "common/fam_internal.h"
 
 namespace openfam {
@@ -66,6 +67,45 @@ class Fam_Allocator {
                                                  uint64_t memoryServerId) = 0;
     virtual Fam_Descriptor *lookup(const char *itemName, const char *regionName,
                                    uint64_t memoryServerId) = 0;
+
+    /*
+     * Asynchronous allocate, lookup and deallocate. Allocators without a
+     * control path to overlap complete them before returning.
+     */
+    virtual Fam_Async_Handle *allocate_async(const char *name,
+                                             uint64_t nbytes,
+                                             mode_t accessPermissions,
+                                             Fam_Region_Descriptor *region) {
+        Fam_Async_Handle *handle = new Fam_Async_Handle();
+        try {
+            handle->complete(allocate(name, nbytes, accessPermissions, region));
+        } catch (...) {
+            handle->fail(std::current_exception());
+        }
+        return handle;
+    }
+    virtual Fam_Async_Handle *lookup_async(const char *itemName,
+                                           const char *regionName,
+                                           uint64_t memoryServerId) {
+        Fam_Async_Handle *handle = new Fam_Async_Handle();
+        try {
+            handle->complete(lookup(itemName, regionName, memoryServerId));
+        } catch (...) {
+            handle->fail(std::current_exception());
+        }
+        return handle;
+    }
+    virtual Fam_Async_Handle *deallocate_async(Fam_Descriptor *descriptor) {
+        Fam_Async_Handle *handle = new Fam_Async_Handle();
+        try {
+            deallocate(descriptor);
+            handle->complete(NULL);
+        } catch (...) {
+            handle->fail(std::current_exception());
+        }
+        return handle;
+    }
+
     virtual Fam_Region_Item_Info
     check_permission_get_info(Fam_Region_Descriptor *descriptor) = 0;
     virtual Fam_Region_Item_Info
@@ -77,12 +117,24 @@ class Fam_Allocator {
 
     virtual void wait_for_copy(void *waitObj) = 0;
 
+    virtual void reduce(Fam_Descriptor *descriptor, uint64_t offset,
+                        uint64_t count, Fam_Data_Type type, Fam_Reduce_Op op,
+                        void *result) = 0;
+
+    virtual uint64_t scan(Fam_Descriptor *src, uint64_t offset,
+                          uint64_t recordSize, uint64_t numRecords,
+                          Fam_Scan_Predicate *predicate,
+                          Fam_Scan_Output output, Fam_Descriptor *dest,
+                          uint64_t destOffset) = 0;
+
     virtual void *fam_map(Fam_Descriptor *descriptor) = 0;
     virtual void fam_unmap(void *local, Fam_Descriptor *descriptor) = 0;
 
     virtual void acquire_CAS_lock(Fam_Descriptor *descriptor) = 0;
     virtual void release_CAS_lock(Fam_Descriptor *descriptor) = 0;
 
+    virtual Fam_Server_Stats *get_server_stats(uint64_t memoryServerId) = 0;
+
     virtual int get_addr_size(size_t *addrSize, uint64_t nodeId) = 0;
     virtual int get_addr(void *addr, size_t addrSize, uint64_t nodeId) = 0;
 };
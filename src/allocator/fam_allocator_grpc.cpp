@@ -53,14 +53,42 @@ Fam_Allocator_Grpc::Fam_Allocator_Grpc(MemServerMap name, uint64_t port) {
                                       "server name not found");
     }
     rpcClients = new RpcClientMap();
+    mapPager = NULL;
 
     for (auto obj = name.begin(); obj != name.end(); ++obj) {
         Fam_Rpc_Client *client = new Fam_Rpc_Client((obj->second).c_str(), port);
         rpcClients->insert({ obj->first, client });
     }
+
+    // Access the memory of a memory server on this host directly. This is
+    // limited to a single such server, since the heaps opened here are
+    // found by region id in the NVMM root this process sees.
+    localBypass = NULL;
+    std::string hostId = fam_host_id();
+    uint64_t numColocated = 0;
+    uint64_t colocatedId = 0;
+    for (auto rpcClient : *rpcClients) {
+        if (!hostId.empty() && rpcClient.second->get_host_id() == hostId) {
+            numColocated++;
+            colocatedId = rpcClient.first;
+        }
+    }
+    if (numColocated == 1) {
+        try {
+            localBypass = new Fam_Local_Bypass(colocatedId);
+        } catch (...) {
+            // Keep the datapath on libfabric
+            localBypass = NULL;
+        }
+    }
 }
 
 Fam_Allocator_Grpc::~Fam_Allocator_Grpc() {
+    // Operations in flight complete before the thread sees the shutdown
+    controlCq.Shutdown();
+    if (controlThread.joinable())
+        controlThread.join();
+    delete localBypass;
     if (rpcClients != NULL) {
         for (auto rpc_client : *rpcClients) {
             delete rpc_client.second;
@@ -93,6 +121,10 @@ Fam_Region_Descriptor *Fam_Allocator_Grpc::create_region(
 
 void Fam_Allocator_Grpc::destroy_region(Fam_Region_Descriptor *descriptor) {
     Fam_Rpc_Client *rpcClient = get_rpc_client(descriptor->get_memserver_id());
+    if (localBypass != NULL) {
+        Fam_Global_Descriptor global = descriptor->get_global_descriptor();
+        localBypass->forget_region(global.regionId);
+    }
     return rpcClient->destroy_region(descriptor);
 }
 
@@ -114,6 +146,50 @@ void Fam_Allocator_Grpc::deallocate(Fam_Descriptor *descriptor) {
     return rpcClient->deallocate(descriptor);
 }
 
+::grpc::CompletionQueue *Fam_Allocator_Grpc::control_queue() {
+    std::call_once(controlStart, [this]() {
+        controlThread =
+            std::thread(&Fam_Allocator_Grpc::complete_control_ops, this);
+    });
+    return &controlCq;
+}
+
+void Fam_Allocator_Grpc::complete_control_ops() {
+    void *tag;
+    bool ok;
+    while (controlCq.Next(&tag, &ok))
+        Fam_Rpc_Client::complete_dataitem(tag, ok);
+}
+
+Fam_Async_Handle *
+Fam_Allocator_Grpc::allocate_async(const char *name, uint64_t nbytes,
+                                   mode_t accessPermissions,
+                                   Fam_Region_Descriptor *region) {
+    Fam_Rpc_Client *rpcClient = get_rpc_client(region->get_memserver_id());
+    Fam_Async_Handle *handle = new Fam_Async_Handle();
+    rpcClient->allocate_async(name, nbytes, accessPermissions, region,
+                              control_queue(), handle);
+    return handle;
+}
+
+Fam_Async_Handle *Fam_Allocator_Grpc::lookup_async(const char *itemName,
+                                                   const char *regionName,
+                                                   uint64_t memoryServerId) {
+    Fam_Rpc_Client *rpcClient = get_rpc_client(memoryServerId);
+    Fam_Async_Handle *handle = new Fam_Async_Handle();
+    rpcClient->lookup_async(itemName, regionName, memoryServerId,
+                            control_queue(), handle);
+    return handle;
+}
+
+Fam_Async_Handle *
+Fam_Allocator_Grpc::deallocate_async(Fam_Descriptor *descriptor) {
+    Fam_Rpc_Client *rpcClient = get_rpc_client(descriptor->get_memserver_id());
+    Fam_Async_Handle *handle = new Fam_Async_Handle();
+    rpcClient->deallocate_async(descriptor, control_queue(), handle);
+    return handle;
+}
+
 int Fam_Allocator_Grpc::change_permission(Fam_Region_Descriptor *descriptor,
                                           mode_t accessPermissions) {
     Fam_Rpc_Client *rpcClient = get_rpc_client(descriptor->get_memserver_id());
@@ -165,14 +241,47 @@ void Fam_Allocator_Grpc::wait_for_copy(void *waitObj) {
     return rpcClient->wait_for_copy(waitObj);
 }
 
+void Fam_Allocator_Grpc::reduce(Fam_Descriptor *descriptor, uint64_t offset,
+                                uint64_t count, Fam_Data_Type type,
+                                Fam_Reduce_Op op, void *result) {
+    Fam_Rpc_Client *rpcClient = get_rpc_client(descriptor->get_memserver_id());
+    rpcClient->reduce(descriptor, offset, count, type, op, result);
+}
+
+uint64_t Fam_Allocator_Grpc::scan(Fam_Descriptor *src, uint64_t offset,
+                                  uint64_t recordSize, uint64_t numRecords,
+                                  Fam_Scan_Predicate *predicate,
+                                  Fam_Scan_Output output, Fam_Descriptor *dest,
+                                  uint64_t destOffset) {
+    uint64_t memoryServerId = src->get_memserver_id();
+    if ((dest != NULL) && (dest->get_memserver_id() != memoryServerId)) {
+        throw Fam_Allocator_Exception(
+            FAM_ERR_INVALID,
+            "Destination dataitem is not on the memory server of the source");
+    }
+    Fam_Rpc_Client *rpcClient = get_rpc_client(memoryServerId);
+    return rpcClient->scan(src, offset, recordSize, numRecords, predicate,
+                           output, dest, destOffset);
+}
+
+void Fam_Allocator_Grpc::set_map_pager(Fam_Map_Pager *pager) {
+    mapPager = pager;
+}
+
+Fam_Local_Bypass *Fam_Allocator_Grpc::get_local_bypass() {
+    return localBypass;
+}
+
 void *Fam_Allocator_Grpc::fam_map(Fam_Descriptor *descriptor) {
-    FAM_UNIMPLEMENTED_GRPC();
-    return NULL;
+    if (mapPager == NULL)
+        FAM_UNIMPLEMENTED_GRPC();
+    return mapPager->map(descriptor);
 }
 
 void Fam_Allocator_Grpc::fam_unmap(void *local, Fam_Descriptor *descriptor) {
-    FAM_UNIMPLEMENTED_GRPC();
-    return;
+    if (mapPager == NULL)
+        FAM_UNIMPLEMENTED_GRPC();
+    mapPager->unmap(local);
 }
 
 void Fam_Allocator_Grpc::acquire_CAS_lock(Fam_Descriptor *descriptor) {
@@ -185,6 +294,12 @@ void Fam_Allocator_Grpc::release_CAS_lock(Fam_Descriptor *descriptor) {
     return rpcClient->release_CAS_lock(descriptor);
 }
 
+Fam_Server_Stats *
+Fam_Allocator_Grpc::get_server_stats(uint64_t memoryServerId) {
+    Fam_Rpc_Client *rpcClient = get_rpc_client(memoryServerId);
+    return rpcClient->get_stats(memoryServerId);
+}
+
 int Fam_Allocator_Grpc::get_addr_size(size_t *addrSize,
                                       uint64_t memoryServerId = 0) {
     Fam_Rpc_Client *rpcClient = get_rpc_client(memoryServerId);
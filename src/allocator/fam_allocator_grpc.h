@@ -30,7 +30,12 @@
 #ifndef FAM_ALLOCATOR_GRPC_H_
 #define FAM_ALLOCATOR_GRPC_H_
 
+#include <mutex>
+#include <thread>
+
 #include "allocator/fam_allocator.h"
+#include "common/fam_local_bypass.h"
+#include "common/fam_map_pager.h"
 #include "rpc/fam_rpc_client.h"
 
 namespace openfam {
@@ -62,6 +67,20 @@ class Fam_Allocator_Grpc : public Fam_Allocator {
                              Fam_Region_Descriptor *region);
     void deallocate(Fam_Descriptor *descriptor);
 
+    /**
+     * allocate_async, lookup_async, deallocate_async - Start the RPC to
+     * the memory server and return without waiting for its reply. Replies
+     * of all memory servers are received by one completion queue thread,
+     * started by the first such call, which completes the handles.
+     */
+    Fam_Async_Handle *allocate_async(const char *name, uint64_t nbytes,
+                                     mode_t accessPermissions,
+                                     Fam_Region_Descriptor *region);
+    Fam_Async_Handle *lookup_async(const char *itemName,
+                                   const char *regionName,
+                                   uint64_t memoryServerId);
+    Fam_Async_Handle *deallocate_async(Fam_Descriptor *descriptor);
+
     int change_permission(Fam_Region_Descriptor *descriptor,
                           mode_t accessPermissions);
     int change_permission(Fam_Descriptor *descriptor, mode_t accessPermissions);
@@ -78,6 +97,49 @@ class Fam_Allocator_Grpc : public Fam_Allocator {
 
     void wait_for_copy(void *waitObj);
 
+    /**
+     * reduce - Reduce elements of a data item on its memory server.
+     * @param descriptor - Descriptor associated with the data item in FAM
+     * @param offset - Byte offset of the first element
+     * @param count - Number of elements
+     * @param type - Type of the elements
+     * @param op - Reduction to compute
+     * @param result - Result, fam_reduce_result_size() bytes long
+     */
+    void reduce(Fam_Descriptor *descriptor, uint64_t offset, uint64_t count,
+                Fam_Data_Type type, Fam_Reduce_Op op, void *result);
+
+    /**
+     * scan - Filter records of a data item on its memory server.
+     * @param src - Descriptor associated with the data item scanned
+     * @param offset - Byte offset of the first record
+     * @param recordSize - Size of a record
+     * @param numRecords - Number of records
+     * @param predicate - Predicate the records are matched against
+     * @param output - Results written for the matching records
+     * @param dest - Descriptor associated with the data item written
+     * @param destOffset - Byte offset of the first result
+     * @return - Number of matching records
+     */
+    uint64_t scan(Fam_Descriptor *src, uint64_t offset, uint64_t recordSize,
+                  uint64_t numRecords, Fam_Scan_Predicate *predicate,
+                  Fam_Scan_Output output, Fam_Descriptor *dest,
+                  uint64_t destOffset);
+
+    /**
+     * set_map_pager - Set the pager that backs data items mapped with
+     * fam_map. Without a pager, fam_map is not supported.
+     * @param pager - Pager that serves faults over the data path.
+     */
+    void set_map_pager(Fam_Map_Pager *pager);
+
+    /**
+     * get_local_bypass - Get the shared-memory access to the memory server
+     * that runs on this host, if any.
+     * @return - Bypass for the co-located memory server, or NULL.
+     */
+    Fam_Local_Bypass *get_local_bypass();
+
     /**
      * fam_map - Map a data item in FAM to the process virtual address space.
      * @param descriptor - Descriptor associated with the data item in FAM.
@@ -108,12 +170,27 @@ class Fam_Allocator_Grpc : public Fam_Allocator {
      */
     virtual void release_CAS_lock(Fam_Descriptor *descriptor);
 
+    /**
+     * get_server_stats - Read the statistics of a memory server.
+     * @param memoryServerId - Id of the memory server
+     */
+    virtual Fam_Server_Stats *get_server_stats(uint64_t memoryServerId);
+
     virtual int get_addr_size(size_t *addrSize, uint64_t nodeId);
 
     virtual int get_addr(void *addr, size_t addrSize, uint64_t nodeId);
 
   private:
+    ::grpc::CompletionQueue *control_queue();
+    void complete_control_ops();
+
     RpcClientMap *rpcClients;
+    // Completion queue of the asynchronous data item operations
+    ::grpc::CompletionQueue controlCq;
+    std::thread controlThread;
+    std::once_flag controlStart;
+    Fam_Map_Pager *mapPager;
+    Fam_Local_Bypass *localBypass;
 };
 
 } // namespace openfam
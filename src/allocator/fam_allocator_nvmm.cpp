@@ -29,6 +29,7 @@
  */
 #include <iostream>
 #include <stdint.h>   // needed
+#include <string.h>
 #include <sys/stat.h> // needed for mode_t
 
 #include "allocator/fam_allocator_nvmm.h"
@@ -380,4 +381,78 @@ void Fam_Allocator_NVMM::fam_unmap(void *local, Fam_Descriptor *descriptor) {
     return;
 }
 
+void Fam_Allocator_NVMM::reduce(Fam_Descriptor *descriptor, uint64_t offset,
+                                uint64_t count, Fam_Data_Type type,
+                                Fam_Reduce_Op op, void *result) {
+    Fam_Global_Descriptor globalDescriptor =
+        descriptor->get_global_descriptor();
+
+    try {
+        allocator->reduce(globalDescriptor.regionId, globalDescriptor.offset,
+                          offset, count, type, op, uid, gid, result);
+    }
+    catch (Memserver_Exception &e) {
+        throw Fam_Allocator_Exception((enum Fam_Error)e.fam_error(),
+                                      e.fam_error_msg());
+    }
+}
+
+uint64_t Fam_Allocator_NVMM::scan(Fam_Descriptor *src, uint64_t offset,
+                                  uint64_t recordSize, uint64_t numRecords,
+                                  Fam_Scan_Predicate *predicate,
+                                  Fam_Scan_Output output, Fam_Descriptor *dest,
+                                  uint64_t destOffset) {
+    Fam_Global_Descriptor globalDescriptor = src->get_global_descriptor();
+    Fam_Global_Descriptor destGlobalDescriptor = {0, 0};
+    uint64_t matches = 0;
+
+    if (dest != NULL)
+        destGlobalDescriptor = dest->get_global_descriptor();
+    try {
+        allocator->scan(globalDescriptor.regionId, globalDescriptor.offset,
+                        offset, recordSize, numRecords, predicate, output,
+                        destGlobalDescriptor.regionId,
+                        destGlobalDescriptor.offset, destOffset, uid, gid,
+                        &matches);
+    }
+    catch (Memserver_Exception &e) {
+        throw Fam_Allocator_Exception((enum Fam_Error)e.fam_error(),
+                                      e.fam_error_msg());
+    }
+    return matches;
+}
+
+Fam_Server_Stats *
+Fam_Allocator_NVMM::get_server_stats(uint64_t memoryServerId) {
+    std::vector<Heap_Maintenance_Stats> heapStats;
+    allocator->get_heap_stats(heapStats);
+
+    Fam_Server_Stats *stats = new Fam_Server_Stats();
+    memset(stats, 0, sizeof(Fam_Server_Stats));
+    stats->memoryServerId = memoryServerId;
+    stats->numHeaps = allocator->get_num_heaps();
+    Memserver_Recovery_Status recovery;
+    allocator->get_recovery_status(recovery);
+    stats->ready = recovery.ready;
+    stats->recoveryRegions = recovery.numRegions;
+    stats->recoveredRegions = recovery.numRecovered;
+    stats->recoveryFailures = recovery.numFailed;
+    stats->recoveryNs = recovery.recoveryNs;
+    stats->numRegions = heapStats.size();
+    if (stats->numRegions)
+        stats->regions = new Fam_Server_Region_Stats[stats->numRegions];
+    for (uint64_t i = 0; i < stats->numRegions; i++) {
+        Fam_Server_Region_Stats *region = &stats->regions[i];
+        region->regionId = heapStats[i].regionId;
+        region->numDataitems = heapStats[i].numDataitems;
+        region->allocatedBytes = heapStats[i].allocatedBytes;
+        region->reservedBytes = heapStats[i].reservedBytes;
+        region->numMerges = heapStats[i].numMerges;
+        region->totalMergeNs = heapStats[i].totalMergeNs;
+        region->freedBytesSinceMerge = heapStats[i].freedBytesSinceMerge;
+        region->allocFailures = heapStats[i].allocFailures;
+    }
+    return stats;
+}
+
 } // namespace openfam
@@ -74,6 +74,35 @@ class Fam_Allocator_NVMM : public Fam_Allocator {
     }
 
     void wait_for_copy(void *waitObj) {}
+
+    /**
+     * reduce - Reduce elements of a data item in this process.
+     * @param descriptor - Descriptor associated with the data item in FAM
+     * @param offset - Byte offset of the first element
+     * @param count - Number of elements
+     * @param type - Type of the elements
+     * @param op - Reduction to compute
+     * @param result - Result, fam_reduce_result_size() bytes long
+     */
+    void reduce(Fam_Descriptor *descriptor, uint64_t offset, uint64_t count,
+                Fam_Data_Type type, Fam_Reduce_Op op, void *result);
+
+    /**
+     * scan - Filter records of a data item in this process.
+     * @param src - Descriptor associated with the data item scanned
+     * @param offset - Byte offset of the first record
+     * @param recordSize - Size of a record
+     * @param numRecords - Number of records
+     * @param predicate - Predicate the records are matched against
+     * @param output - Results written for the matching records
+     * @param dest - Descriptor associated with the data item written
+     * @param destOffset - Byte offset of the first result
+     * @return - Number of matching records
+     */
+    uint64_t scan(Fam_Descriptor *src, uint64_t offset, uint64_t recordSize,
+                  uint64_t numRecords, Fam_Scan_Predicate *predicate,
+                  Fam_Scan_Output output, Fam_Descriptor *dest,
+                  uint64_t destOffset);
     /**
      * fam_map - Map a data item in FAM to the process virtual address space.
      * @param descriptor - Descriptor associated with the data item in FAM.
@@ -106,6 +135,13 @@ class Fam_Allocator_NVMM : public Fam_Allocator {
      */
     void release_CAS_lock(Fam_Descriptor *descriptor) {}
 
+    /**
+     * get_server_stats - Read the statistics of the heaps open in this
+     * process; there are no RPCs, copies or memory registrations to count.
+     * @param memoryServerId - Id of the memory server
+     */
+    Fam_Server_Stats *get_server_stats(uint64_t memoryServerId);
+
   private:
     Memserver_Allocator *allocator;
     uint32_t uid;
@@ -0,0 +1,332 @@
+/*
+ * fam_local_pool.cpp
+ * Copyright (c) 2019 Hewlett Packard Enterprise Development, LP. All rights
+ * reserved. Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ *    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * See https://spdx.org/licenses/BSD-3-Clause
+ *
+ */
+#include "allocator/fam_local_pool.h"
+#include "fam/fam_exception.h"
+
+namespace openfam {
+Fam_Local_Pool::Fam_Local_Pool(Fam_Allocator *famAlloc, uint64_t poolChunkSize,
+                               bool setBaseAddress) {
+    famAllocator = famAlloc;
+    chunkSize = poolChunkSize;
+    setBase = setBaseAddress;
+    arenas = new ArenaMap();
+    chunks = new ChunkMap();
+    releasedChunks = new ChunkList();
+    (void)pthread_rwlock_init(&poolLock, NULL);
+    (void)pthread_mutex_init(&leaseLock, NULL);
+}
+
+Fam_Local_Pool::~Fam_Local_Pool() {
+    for (auto arenaObj : *arenas)
+        delete arenaObj.second;
+    for (auto chunkObj : *chunks) {
+        delete chunkObj.second->descriptor;
+        delete chunkObj.second;
+    }
+    for (auto chunk : *releasedChunks) {
+        delete chunk->descriptor;
+        delete chunk;
+    }
+    delete arenas;
+    delete chunks;
+    delete releasedChunks;
+    pthread_rwlock_destroy(&poolLock);
+    pthread_mutex_destroy(&leaseLock);
+}
+
+Local_Pool_Arena *Fam_Local_Pool::get_arena(uint64_t regionId,
+                                            mode_t accessPermissions) {
+    ArenaKey key(regionId, accessPermissions);
+    Local_Pool_Arena *arena = NULL;
+
+    pthread_rwlock_rdlock(&poolLock);
+    auto arenaObj = arenas->find(key);
+    if (arenaObj != arenas->end())
+        arena = arenaObj->second;
+    pthread_rwlock_unlock(&poolLock);
+    if (arena)
+        return arena;
+
+    pthread_rwlock_wrlock(&poolLock);
+    arenaObj = arenas->find(key);
+    if (arenaObj == arenas->end()) {
+        arena = new Local_Pool_Arena();
+        arena->current.store(NULL);
+        arenas->insert({key, arena});
+    } else {
+        arena = arenaObj->second;
+    }
+    pthread_rwlock_unlock(&poolLock);
+    return arena;
+}
+
+/*
+ * Lease a new chunk from the memory server for the arena, unless another
+ * thread already replaced the exhausted chunk.
+ */
+void Fam_Local_Pool::lease_chunk(Local_Pool_Arena *arena,
+                                 Local_Pool_Chunk *exhausted,
+                                 mode_t accessPermissions,
+                                 Fam_Region_Descriptor *region) {
+    pthread_mutex_lock(&leaseLock);
+    if (arena->current.load() != exhausted) {
+        pthread_mutex_unlock(&leaseLock);
+        return;
+    }
+
+    Fam_Descriptor *descriptor;
+    Fam_Region_Item_Info itemInfo;
+    try {
+        descriptor =
+            famAllocator->allocate("", chunkSize, accessPermissions, region);
+        itemInfo = famAllocator->check_permission_get_info(descriptor);
+    } catch (...) {
+        pthread_mutex_unlock(&leaseLock);
+        throw;
+    }
+    descriptor->bind_key(itemInfo.key);
+    descriptor->set_size(itemInfo.size);
+    if (setBase)
+        descriptor->set_base_address(itemInfo.base);
+
+    Local_Pool_Chunk *chunk = new Local_Pool_Chunk();
+    chunk->descriptor = descriptor;
+    chunk->size = chunkSize;
+    chunk->used.store(0);
+    chunk->numItems.store(0);
+    chunk->retired.store(false);
+    chunk->released.store(false);
+
+    Fam_Global_Descriptor global = descriptor->get_global_descriptor();
+    pthread_rwlock_wrlock(&poolLock);
+    chunks->insert({ChunkKey(global.regionId, global.offset), chunk});
+    pthread_rwlock_unlock(&poolLock);
+
+    arena->current.store(chunk, std::memory_order_release);
+    pthread_mutex_unlock(&leaseLock);
+
+    if (exhausted) {
+        exhausted->retired.store(true);
+        put_chunk(exhausted);
+    }
+}
+
+/*
+ * Return a retired chunk to the memory server once all items carved out
+ * of it are deallocated. The chunk is removed from the chunk map first, as
+ * the memory server may hand out the same offset for a later chunk. Threads
+ * which loaded the chunk before it was retired may still read it, so it is
+ * only deleted when the pool is finalized or its region destroyed.
+ */
+void Fam_Local_Pool::put_chunk(Local_Pool_Chunk *chunk) {
+    if (!chunk->retired.load() || (chunk->numItems.load() != 0) ||
+        chunk->released.exchange(true))
+        return;
+
+    Fam_Global_Descriptor global = chunk->descriptor->get_global_descriptor();
+    pthread_rwlock_wrlock(&poolLock);
+    auto chunkObj = chunks->find(ChunkKey(global.regionId, global.offset));
+    if ((chunkObj != chunks->end()) && (chunkObj->second == chunk)) {
+        chunks->erase(chunkObj);
+        releasedChunks->push_back(chunk);
+    }
+    pthread_rwlock_unlock(&poolLock);
+
+    famAllocator->deallocate(chunk->descriptor);
+}
+
+/*
+ * Find the chunk the item was carved out of.
+ * Returns NULL if the item was not allocated from the pool.
+ */
+Local_Pool_Chunk *Fam_Local_Pool::find_chunk(Fam_Descriptor *descriptor) {
+    Local_Pool_Chunk *chunk = NULL;
+    Fam_Global_Descriptor global = descriptor->get_global_descriptor();
+
+    pthread_rwlock_rdlock(&poolLock);
+    auto chunkObj =
+        chunks->upper_bound(ChunkKey(global.regionId, global.offset));
+    if (chunkObj != chunks->begin()) {
+        chunkObj--;
+        Local_Pool_Chunk *candidate = chunkObj->second;
+        if ((chunkObj->first.first == global.regionId) &&
+            (global.offset < chunkObj->first.second + candidate->size))
+            chunk = candidate;
+    }
+    pthread_rwlock_unlock(&poolLock);
+    return chunk;
+}
+
+/*
+ * Carve an item of nbytes out of the chunk leased for the region and
+ * permissions, leasing a new chunk if the current one is exhausted.
+ * Returns NULL if nbytes can not be served from a chunk.
+ */
+Fam_Descriptor *Fam_Local_Pool::allocate(uint64_t nbytes,
+                                         mode_t accessPermissions,
+                                         Fam_Region_Descriptor *region) {
+    if ((nbytes == 0) || (nbytes > chunkSize))
+        return NULL;
+
+    uint64_t alignedSize =
+        (nbytes + LOCAL_POOL_ALIGN - 1) & ~((uint64_t)LOCAL_POOL_ALIGN - 1);
+    Fam_Global_Descriptor regionGlobal = region->get_global_descriptor();
+    Local_Pool_Arena *arena =
+        get_arena(regionGlobal.regionId, accessPermissions);
+
+    while (true) {
+        Local_Pool_Chunk *chunk =
+            arena->current.load(std::memory_order_acquire);
+        if (chunk) {
+            // Count the item before carving, so that the chunk is not
+            // released underneath a concurrent allocation
+            chunk->numItems.fetch_add(1);
+            uint64_t start = chunk->used.fetch_add(alignedSize);
+            if (start + alignedSize <= chunk->size) {
+                Fam_Descriptor *parent = chunk->descriptor;
+                Fam_Global_Descriptor global = parent->get_global_descriptor();
+                global.offset += start;
+
+                Fam_Descriptor *item = new Fam_Descriptor(global, nbytes);
+                item->bind_key(parent->get_key());
+                item->set_key_offset(parent->get_key_offset() + start);
+                item->set_pool_item();
+                if (setBase)
+                    item->set_base_address(
+                        (void *)((uint64_t)parent->get_base_address() + start));
+                return item;
+            }
+            chunk->numItems.fetch_sub(1);
+            put_chunk(chunk);
+        }
+        lease_chunk(arena, chunk, accessPermissions, region);
+    }
+}
+
+/*
+ * Deallocate an item carved out of a chunk. The memory of the chunk is
+ * returned to the memory server when all its items are deallocated.
+ * Returns false if the item was not allocated from the pool, throws if it
+ * was already deallocated. Nothing is left to release for an item whose
+ * region was destroyed.
+ */
+bool Fam_Local_Pool::deallocate(Fam_Descriptor *descriptor) {
+    if (!descriptor->is_pool_item())
+        return false;
+    if (!descriptor->release_pool_item())
+        throw Fam_InvalidOption_Exception("Data item already deallocated");
+
+    Local_Pool_Chunk *chunk = find_chunk(descriptor);
+    if (chunk == NULL)
+        return true;
+
+    uint64_t items = chunk->numItems.load();
+    while ((items != 0) &&
+           !chunk->numItems.compare_exchange_weak(items, items - 1))
+        ;
+    put_chunk(chunk);
+    return true;
+}
+
+/*
+ * Forget the chunks leased from a region which is being destroyed.
+ */
+void Fam_Local_Pool::release_region(Fam_Region_Descriptor *region) {
+    uint64_t regionId = region->get_global_descriptor().regionId;
+
+    pthread_rwlock_wrlock(&poolLock);
+    for (auto arenaObj = arenas->begin(); arenaObj != arenas->end();) {
+        if (arenaObj->first.first == regionId) {
+            delete arenaObj->second;
+            arenaObj = arenas->erase(arenaObj);
+        } else {
+            arenaObj++;
+        }
+    }
+    for (auto chunkObj = chunks->begin(); chunkObj != chunks->end();) {
+        if (chunkObj->first.first == regionId) {
+            delete chunkObj->second->descriptor;
+            delete chunkObj->second;
+            chunkObj = chunks->erase(chunkObj);
+        } else {
+            chunkObj++;
+        }
+    }
+    for (auto chunkObj = releasedChunks->begin();
+         chunkObj != releasedChunks->end();) {
+        Local_Pool_Chunk *chunk = *chunkObj;
+        if (chunk->descriptor->get_global_descriptor().regionId == regionId) {
+            delete chunk->descriptor;
+            delete chunk;
+            chunkObj = releasedChunks->erase(chunkObj);
+        } else {
+            chunkObj++;
+        }
+    }
+    pthread_rwlock_unlock(&poolLock);
+}
+
+/*
+ * Return chunks without any live item to the memory server. Chunks with
+ * items the application did not deallocate are left to be reclaimed with
+ * their region; the pool no longer tracks them.
+ */
+void Fam_Local_Pool::finalize() {
+    ChunkMap leased;
+    pthread_rwlock_wrlock(&poolLock);
+    leased.swap(*chunks);
+    for (auto arenaObj : *arenas)
+        delete arenaObj.second;
+    arenas->clear();
+    pthread_rwlock_unlock(&poolLock);
+
+    // put_chunk() takes the pool lock, the chunks are no longer in the map
+    for (auto chunkObj : leased) {
+        Local_Pool_Chunk *chunk = chunkObj.second;
+        chunk->retired.store(true);
+        try {
+            put_chunk(chunk);
+        } catch (...) {
+            // Memory of the chunk is reclaimed with its region
+        }
+        delete chunk->descriptor;
+        delete chunk;
+    }
+
+    pthread_rwlock_wrlock(&poolLock);
+    for (auto chunk : *releasedChunks) {
+        delete chunk->descriptor;
+        delete chunk;
+    }
+    releasedChunks->clear();
+    pthread_rwlock_unlock(&poolLock);
+}
+
+} // namespace openfam
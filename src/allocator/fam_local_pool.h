@@ -0,0 +1,116 @@
+/*
+ * fam_local_pool.h
+ * Copyright (c) 2019 Hewlett Packard Enterprise Development, LP. All rights
+ * reserved. Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ *    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * See https://spdx.org/licenses/BSD-3-Clause
+ *
+ */
+#ifndef FAM_LOCAL_POOL_H_
+#define FAM_LOCAL_POOL_H_
+
+#include <atomic>
+#include <map>
+#include <pthread.h>
+#include <sys/types.h>
+#include <utility>
+#include <vector>
+
+#include "allocator/fam_allocator.h"
+#include "common/fam_internal.h"
+#include "fam/fam.h"
+
+namespace openfam {
+
+/*
+ * Alignment of the items carved out of a leased chunk. Keeps 128-bit
+ * atomics within an item naturally aligned.
+ */
+#define LOCAL_POOL_ALIGN 64
+
+/*
+ * A chunk of FAM leased from the memory server.
+ * used - bytes carved out of the chunk so far, may exceed size once the
+ *        chunk is exhausted
+ * numItems - number of items carved out of the chunk and not yet
+ *            deallocated
+ * retired - chunk is exhausted and no longer used for new items
+ * released - chunk is returned to the memory server
+ */
+typedef struct {
+    Fam_Descriptor *descriptor;
+    uint64_t size;
+    std::atomic<uint64_t> used;
+    std::atomic<uint64_t> numItems;
+    std::atomic<bool> retired;
+    std::atomic<bool> released;
+} Local_Pool_Chunk;
+
+typedef struct {
+    std::atomic<Local_Pool_Chunk *> current;
+} Local_Pool_Arena;
+
+using ArenaKey = std::pair<uint64_t, mode_t>;
+using ArenaMap = std::map<ArenaKey, Local_Pool_Arena *>;
+using ChunkKey = std::pair<uint64_t, uint64_t>;
+using ChunkMap = std::map<ChunkKey, Local_Pool_Chunk *>;
+using ChunkList = std::vector<Local_Pool_Chunk *>;
+
+/*
+ * Client side allocator for small unnamed data items. A chunk is leased
+ * from the memory server once per region and permission, and items are
+ * carved out of it locally without any RPC. Descriptors of the items share
+ * the key of the chunk and carry the offset of the item within the chunk.
+ */
+class Fam_Local_Pool {
+  public:
+    Fam_Local_Pool(Fam_Allocator *famAlloc, uint64_t poolChunkSize,
+                   bool setBaseAddress);
+    ~Fam_Local_Pool();
+
+    Fam_Descriptor *allocate(uint64_t nbytes, mode_t accessPermissions,
+                             Fam_Region_Descriptor *region);
+    bool deallocate(Fam_Descriptor *descriptor);
+    void release_region(Fam_Region_Descriptor *region);
+    void finalize();
+
+  private:
+    Fam_Allocator *famAllocator;
+    uint64_t chunkSize;
+    bool setBase;
+    ArenaMap *arenas;
+    ChunkMap *chunks;
+    ChunkList *releasedChunks;
+    pthread_rwlock_t poolLock;
+    pthread_mutex_t leaseLock;
+
+    Local_Pool_Arena *get_arena(uint64_t regionId, mode_t accessPermissions);
+    void lease_chunk(Local_Pool_Arena *arena, Local_Pool_Chunk *exhausted,
+                     mode_t accessPermissions, Fam_Region_Descriptor *region);
+    Local_Pool_Chunk *find_chunk(Fam_Descriptor *descriptor);
+    void put_chunk(Local_Pool_Chunk *chunk);
+};
+
+} // namespace openfam
+#endif /* end of FAM_LOCAL_POOL_H_ */
@@ -30,21 +30,64 @@
 #include "allocator/memserver_allocator.h"
 
 namespace openfam {
-Memserver_Allocator::Memserver_Allocator() {
+static_assert(SLAB_MIN_CLASS_SIZE == MIN_OBJ_SIZE,
+              "slab objects must be aligned to MIN_OBJ_SIZE");
+
+/*
+ * enableSlabs - serve small dataitems from slabs. The slab state is kept in
+ * the memory of the process, so slabs must only be enabled when this is the
+ * only process allocating from the heaps, as in the memory server.
+ */
+Memserver_Allocator::Memserver_Allocator(bool enableSlabs) {
     StartNVMM();
     heapMap = new HeapMap();
+    useSlabs = enableSlabs;
+    slabTable = new SlabTable(ShelfId::kMaxPoolCount);
+    maintainerMap = new MaintainerMap();
     memoryManager = MemoryManager::GetInstance();
     metadataManager = FAM_Metadata_Manager::GetInstance();
     (void)pthread_mutex_init(&heapMapLock, NULL);
+    (void)pthread_mutex_init(&maintainerMapLock, NULL);
+    recoveryReady = true;
+    recoveryRegions = 0;
+    recoveredRegions = 0;
+    recoveryFailures = 0;
+    recoveryNs = 0;
     init_poolId_bmap();
 }
 
 Memserver_Allocator::~Memserver_Allocator() {
+    // The recovery thread uses the maps, and a joinable thread can not be
+    // destroyed
+    if (recoveryThread.joinable())
+        recoveryThread.join();
+    delete slabTable;
+    delete maintainerMap;
     delete heapMap;
     pthread_mutex_destroy(&heapMapLock);
+    pthread_mutex_destroy(&maintainerMapLock);
 }
 
 void Memserver_Allocator::memserver_allocator_finalize() {
+    // Heaps can not be closed while the recovery is opening them
+    if (recoveryThread.joinable())
+        recoveryThread.join();
+
+    // Return the cached slab objects before closing the heaps
+    for (auto &slabObj : *slabTable) {
+        std::shared_ptr<Memserver_Slab> slab = std::atomic_load(&slabObj);
+        if (slab)
+            slab->flush();
+    }
+
+    // Stop the maintenance threads before closing the heaps
+    MaintainerMap maintainers;
+    pthread_mutex_lock(&maintainerMapLock);
+    maintainers.swap(*maintainerMap);
+    pthread_mutex_unlock(&maintainerMapLock);
+    for (auto maintainerObj : maintainers)
+        maintainerObj.second->shutdown();
+
     HeapMap::iterator it = heapMap->begin();
     Heap *heap = 0;
 
@@ -159,6 +202,26 @@ int Memserver_Allocator::create_region(string name, uint64_t &regionId,
 
     pthread_mutex_unlock(&heapMapLock);
 
+    start_maintainer(regionId, heap, tmpSize);
+
+    // Small dataitems are allocated from slabs listed in the slab directory.
+    // If the directory can not be created, small dataitems of this region
+    // are allocated directly from the heap.
+    uint64_t slabDirOffset = 0;
+    if (useSlabs) {
+        slabDirOffset = Memserver_Slab::create_directory(heap);
+        if (slabDirOffset &&
+            (metadataManager->metadata_insert_slab_directory(
+                 regionId, slabDirOffset) != META_NO_ERROR)) {
+            Memserver_Slab::destroy_directory(heap, slabDirOffset);
+            slabDirOffset = 0;
+        }
+        // Replace any slab left from an earlier region with the same Id
+        std::atomic_store(&(*slabTable)[regionId],
+                          std::make_shared<Memserver_Slab>(heap, regionId,
+                                                           slabDirOffset));
+    }
+
     // Register the region into metadata service
     region.regionId = regionId;
     strncpy(region.name, name.c_str(), metadataManager->metadata_maxkeylen());
@@ -170,6 +233,10 @@ int Memserver_Allocator::create_region(string name, uint64_t &regionId,
     ret = metadataManager->metadata_insert_region(regionId, name, &region);
     if (ret != META_NO_ERROR) {
         message << "Can not insert region into metadata service, ";
+        remove_slab(regionId);
+        if (slabDirOffset)
+            metadataManager->metadata_delete_slab_directory(regionId);
+        stop_maintainer(regionId);
         ret = heap->Close();
         if (ret != NO_ERROR) {
             message << "Can not close heap, ";
@@ -234,6 +301,14 @@ int Memserver_Allocator::destroy_region(uint64_t regionId, uint32_t uid,
 
     HeapMap::iterator it = get_heap(regionId, heap);
 
+    remove_slab(regionId);
+    stop_maintainer(regionId);
+    ret = metadataManager->metadata_delete_slab_directory(regionId);
+    if ((ret != META_NO_ERROR) && (ret != META_KEY_DOES_NOT_EXIST)) {
+        message << "Can not remove slab directory from metadata service";
+        throw Memserver_Exception(REGION_NOT_REMOVED, message.str().c_str());
+    }
+
     if (it != heapMap->end()) {
         pthread_mutex_lock(&heapMapLock);
         heapMap->erase(it);
@@ -319,6 +394,11 @@ int Memserver_Allocator::resize_region(uint64_t regionId, uint32_t uid,
         throw Memserver_Exception(RESIZE_FAILED, message.str().c_str());
     }
 
+    std::shared_ptr<Memserver_Heap_Maintainer> maintainer =
+        get_maintainer(regionId);
+    if (maintainer)
+        maintainer->set_heap_size(nbytes);
+
     region.size = nbytes;
     // Update the size in the metadata service
     ret = metadataManager->metadata_modify_region(regionId, &region);
@@ -411,11 +491,35 @@ int Memserver_Allocator::allocate(string name, uint64_t regionId, size_t nbytes,
     else
         tmpSize = nbytes;
 
-    offset = heap->AllocOffset(tmpSize);
+    // Small dataitems are served from the slabs of the region
+    offset = 0;
+    if (Memserver_Slab::is_slab_size(tmpSize)) {
+        std::shared_ptr<Memserver_Slab> slab = get_slab(regionId, heap);
+        if (slab)
+            offset = slab->alloc(tmpSize);
+    }
+    bool fromSlab = (offset != 0);
+
+    std::shared_ptr<Memserver_Heap_Maintainer> maintainer =
+        get_maintainer(regionId);
+    if (maintainer)
+        maintainer->note_alloc();
+
+    if (!offset)
+        offset = heap->AllocOffset(tmpSize);
     if (!offset) {
-        try {
-            heap->Merge();
-        } catch (...) {
+        // Merge free space of the heap and retry once
+        bool merged = true;
+        if (maintainer) {
+            merged = maintainer->merge_now();
+        } else {
+            try {
+                heap->Merge();
+            } catch (...) {
+                merged = false;
+            }
+        }
+        if (!merged) {
             message << "Heap Merge() failed";
             throw Memserver_Exception(HEAP_MERGE_FAILED, message.str().c_str());
         }
@@ -445,9 +549,11 @@ int Memserver_Allocator::allocate(string name, uint64_t regionId, size_t nbytes,
                                                         &dataitem, name);
     if (ret != META_NO_ERROR) {
         message << "Can not insert dataitem into metadata service";
-        heap->Free(offset);
+        free_offset(regionId, heap, offset);
         throw Memserver_Exception(DATAITEM_NOT_INSERTED, message.str().c_str());
     }
+    if (maintainer)
+        maintainer->add_usage(nbytes, reserved_size(tmpSize, fromSlab));
 
     return ALLOC_NO_ERROR;
 }
@@ -494,9 +600,7 @@ int Memserver_Allocator::deallocate(uint64_t regionId, uint64_t offset,
     Heap *heap = 0;
 
     HeapMap::iterator it = get_heap(regionId, heap);
-    if (it != heapMap->end()) {
-        heap->Free(offset);
-    } else {
+    if (it == heapMap->end()) {
         // Heap not found in map. Get the heap from NVMM
         ret = open_heap(regionId);
         if (ret != ALLOC_NO_ERROR) {
@@ -509,7 +613,17 @@ int Memserver_Allocator::deallocate(uint64_t regionId, uint64_t offset,
             throw Memserver_Exception(RBT_HEAP_NOT_FOUND,
                                       message.str().c_str());
         }
-        heap->Free(offset);
+    }
+    bool fromSlab = free_offset(regionId, heap, offset);
+
+    std::shared_ptr<Memserver_Heap_Maintainer> maintainer =
+        get_maintainer(regionId);
+    if (maintainer) {
+        uint64_t tmpSize = std::max<uint64_t>(dataitem.size, MIN_OBJ_SIZE);
+        if (!fromSlab)
+            maintainer->note_free(tmpSize);
+        maintainer->remove_usage(dataitem.size,
+                                 reserved_size(tmpSize, fromSlab));
     }
     return ALLOC_NO_ERROR;
 }
@@ -737,16 +851,23 @@ int Memserver_Allocator::open_heap(uint64_t regionId) {
         if (heapObj == heapMap->end()) {
             heapMap->insert({regionId, heap});
         } else {
-            message << "Can not insert heap. regionId already found in map";
+            // Heap was opened by another thread in the meantime, e.g. by
+            // the startup recovery. Use the heap in the map.
             pthread_mutex_unlock(&heapMapLock);
             heap->Close();
             delete heap;
-            throw Memserver_Exception(RBT_HEAP_NOT_INSERTED,
-                                      message.str().c_str());
+            return ALLOC_NO_ERROR;
         }
 
         pthread_mutex_unlock(&heapMapLock);
 
+        Fam_Region_Metadata region;
+        uint64_t heapSize = 0;
+        if (metadataManager->metadata_find_region(regionId, region) ==
+            META_NO_ERROR)
+            heapSize = std::max<uint64_t>(region.size, MIN_REGION_SIZE);
+        start_maintainer(regionId, heap, heapSize);
+
         return ALLOC_NO_ERROR;
     }
     return ALLOC_NO_ERROR;
@@ -791,6 +912,133 @@ int Memserver_Allocator::copy(uint64_t regionId, uint64_t srcOffset,
     }
 }
 
+/*
+ * Reduce count elements of the given type, from byte offset start of the
+ * dataitem at offset, to a result of fam_reduce_result_size() bytes.
+ */
+int Memserver_Allocator::reduce(uint64_t regionId, uint64_t offset,
+                                uint64_t start, uint64_t count,
+                                Fam_Data_Type type, Fam_Reduce_Op op,
+                                uint32_t uid, uint32_t gid, void *result) {
+    ostringstream message;
+    message << "Error While reducing dataitem : ";
+    Fam_DataItem_Metadata dataitem;
+
+    get_dataitem(regionId, offset, uid, gid, dataitem);
+    if (!check_dataitem_permission(dataitem, 0, uid, gid)) {
+        message << "Not permitted to read dataitem";
+        throw Memserver_Exception(NO_PERMISSION, message.str().c_str());
+    }
+
+    uint64_t elementSize = fam_data_type_size(type);
+    if (elementSize == 0) {
+        message << "Invalid element type";
+        throw Memserver_Exception(INVALID_ARGUMENT, message.str().c_str());
+    }
+    if ((start > dataitem.size) ||
+        (count > (dataitem.size - start) / elementSize)) {
+        message << "Offset or count is beyond dataitem boundary";
+        throw Memserver_Exception(OUT_OF_RANGE, message.str().c_str());
+    }
+
+    void *base = get_local_pointer(regionId, offset + start);
+    if (base == NULL) {
+        message << "Failed to get local pointer to dataitem";
+        throw Memserver_Exception(NULL_POINTER_ACCESS, message.str().c_str());
+    }
+    if (fam_reduce_local(base, count, type, op, result) < 0) {
+        message << "Invalid reduction or no elements to reduce";
+        throw Memserver_Exception(INVALID_ARGUMENT, message.str().c_str());
+    }
+    return ALLOC_NO_ERROR;
+}
+
+/*
+ * Scan numRecords records of recordSize bytes, from byte offset start of
+ * the dataitem at offset, and write the results of the matching records
+ * from byte offset destStart of the dataitem at destOffset of region
+ * destRegionId. The destination is not used with FAM_SCAN_COUNT.
+ */
+int Memserver_Allocator::scan(uint64_t regionId, uint64_t offset,
+                              uint64_t start, uint64_t recordSize,
+                              uint64_t numRecords,
+                              const Fam_Scan_Predicate *predicate,
+                              Fam_Scan_Output output, uint64_t destRegionId,
+                              uint64_t destOffset, uint64_t destStart,
+                              uint32_t uid, uint32_t gid, uint64_t *matches) {
+    ostringstream message;
+    message << "Error While scanning dataitem : ";
+    Fam_DataItem_Metadata dataitem;
+    Fam_DataItem_Metadata destDataitem;
+    char *destBase = NULL;
+    uint64_t destSize = 0;
+
+    if (!fam_scan_output_valid(output)) {
+        message << "Invalid scan output";
+        throw Memserver_Exception(INVALID_ARGUMENT, message.str().c_str());
+    }
+
+    get_dataitem(regionId, offset, uid, gid, dataitem);
+    if (!check_dataitem_permission(dataitem, 0, uid, gid)) {
+        message << "Not permitted to read dataitem";
+        throw Memserver_Exception(NO_PERMISSION, message.str().c_str());
+    }
+    if ((recordSize == 0) ||
+        !fam_scan_predicate_valid(predicate, recordSize)) {
+        message << "Invalid record size or predicate";
+        throw Memserver_Exception(INVALID_ARGUMENT, message.str().c_str());
+    }
+    if ((start > dataitem.size) ||
+        (numRecords > (dataitem.size - start) / recordSize)) {
+        message << "Offset or number of records is beyond dataitem boundary";
+        throw Memserver_Exception(OUT_OF_RANGE, message.str().c_str());
+    }
+    char *base = (char *)get_local_pointer(regionId, offset + start);
+    if (base == NULL) {
+        message << "Failed to get local pointer to dataitem";
+        throw Memserver_Exception(NULL_POINTER_ACCESS, message.str().c_str());
+    }
+
+    if (output != FAM_SCAN_COUNT) {
+        get_dataitem(destRegionId, destOffset, uid, gid, destDataitem);
+        if (!check_dataitem_permission(destDataitem, 1, uid, gid)) {
+            message << "Not permitted to write destination dataitem";
+            throw Memserver_Exception(NO_PERMISSION, message.str().c_str());
+        }
+        if (destStart > destDataitem.size) {
+            message << "Destination offset is beyond dataitem boundary";
+            throw Memserver_Exception(OUT_OF_RANGE, message.str().c_str());
+        }
+        destSize = destDataitem.size - destStart;
+        destBase = (char *)get_local_pointer(destRegionId,
+                                             destOffset + destStart);
+        if (destBase == NULL) {
+            message << "Failed to get local pointer to destination dataitem";
+            throw Memserver_Exception(NULL_POINTER_ACCESS,
+                                      message.str().c_str());
+        }
+        if ((destBase < base + numRecords * recordSize) &&
+            (base < destBase + destSize)) {
+            message << "Destination overlaps the records scanned";
+            throw Memserver_Exception(INVALID_ARGUMENT, message.str().c_str());
+        }
+    }
+
+    if (fam_scan_local(base, recordSize, numRecords, predicate, output,
+                       destBase, destSize, matches) < 0) {
+        message << "Invalid predicate";
+        throw Memserver_Exception(INVALID_ARGUMENT, message.str().c_str());
+    }
+    if (destBase != NULL) {
+        uint64_t resultSize = fam_scan_result_size(output, recordSize);
+        uint64_t written = destSize / resultSize;
+        if (written > *matches)
+            written = *matches;
+        openfam_persist(destBase, written * resultSize);
+    }
+    return ALLOC_NO_ERROR;
+}
+
 HeapMap::iterator Memserver_Allocator::get_heap(uint64_t regionId,
                                                 Heap *&heap) {
     pthread_mutex_lock(&heapMapLock);
@@ -803,6 +1051,229 @@ HeapMap::iterator Memserver_Allocator::get_heap(uint64_t regionId,
     return heapObj;
 }
 
+/*
+ * Get the slab allocator of the region, recovering its state from the
+ * slab directory on first use. Returns NULL if slabs are not enabled.
+ * Slabs are looked up by region Id without a lock; the returned reference
+ * keeps the slab alive while the region is being destroyed.
+ */
+std::shared_ptr<Memserver_Slab>
+Memserver_Allocator::get_slab(uint64_t regionId, Heap *heap) {
+    if (!useSlabs || (regionId >= slabTable->size()))
+        return NULL;
+
+    std::shared_ptr<Memserver_Slab> &slabObj = (*slabTable)[regionId];
+    std::shared_ptr<Memserver_Slab> slab = std::atomic_load(&slabObj);
+    if (!slab) {
+        // Regions created before slabs were enabled have no slab directory
+        uint64_t slabDirOffset = 0;
+        if (metadataManager->metadata_find_slab_directory(
+                regionId, slabDirOffset) != META_NO_ERROR)
+            slabDirOffset = 0;
+        std::shared_ptr<Memserver_Slab> newSlab =
+            std::make_shared<Memserver_Slab>(heap, regionId, slabDirOffset);
+        if (std::atomic_compare_exchange_strong(&slabObj, &slab, newSlab))
+            slab = newSlab;
+    }
+    slab->recover(metadataManager);
+    return slab;
+}
+
+/*
+ * The slab is deleted once the last thread using it releases its reference.
+ */
+void Memserver_Allocator::remove_slab(uint64_t regionId) {
+    if (regionId < slabTable->size())
+        std::atomic_store(&(*slabTable)[regionId],
+                          std::shared_ptr<Memserver_Slab>());
+}
+
+/*
+ * Free the memory at the given offset, either to the slab it was
+ * allocated from or to the heap. Returns true if it was freed to a slab.
+ */
+bool Memserver_Allocator::free_offset(uint64_t regionId, Heap *heap,
+                                      uint64_t offset) {
+    std::shared_ptr<Memserver_Slab> slab = get_slab(regionId, heap);
+    if (slab && slab->free(offset))
+        return true;
+    heap->Free(offset);
+    return false;
+}
+
+/*
+ * Bytes taken for an object of tmpSize, which is rounded up to its size
+ * class when served from a slab.
+ */
+uint64_t Memserver_Allocator::reserved_size(uint64_t tmpSize, bool fromSlab) {
+    return fromSlab ? Memserver_Slab::object_size(tmpSize) : tmpSize;
+}
+
+/*
+ * Start the maintenance thread, which merges free space of the heap in the
+ * background.
+ */
+void Memserver_Allocator::start_maintainer(uint64_t regionId, Heap *heap,
+                                           uint64_t heapSize) {
+    pthread_mutex_lock(&maintainerMapLock);
+    auto maintainerObj = maintainerMap->find(regionId);
+    if (maintainerObj == maintainerMap->end())
+        maintainerMap->insert(
+            {regionId, std::make_shared<Memserver_Heap_Maintainer>(
+                           heap, regionId, heapSize)});
+    pthread_mutex_unlock(&maintainerMapLock);
+}
+
+/*
+ * Stop the maintenance thread before the heap is closed. Allocations in
+ * progress may still hold the maintainer, which is deleted when the last
+ * of them drops it.
+ */
+void Memserver_Allocator::stop_maintainer(uint64_t regionId) {
+    std::shared_ptr<Memserver_Heap_Maintainer> maintainer;
+    pthread_mutex_lock(&maintainerMapLock);
+    auto maintainerObj = maintainerMap->find(regionId);
+    if (maintainerObj != maintainerMap->end()) {
+        maintainer = maintainerObj->second;
+        maintainerMap->erase(maintainerObj);
+    }
+    pthread_mutex_unlock(&maintainerMapLock);
+    // Joining the thread may wait for a merge in progress, do it outside
+    // of the map lock
+    if (maintainer)
+        maintainer->shutdown();
+}
+
+std::shared_ptr<Memserver_Heap_Maintainer>
+Memserver_Allocator::get_maintainer(uint64_t regionId) {
+    std::shared_ptr<Memserver_Heap_Maintainer> maintainer;
+    pthread_mutex_lock(&maintainerMapLock);
+    auto maintainerObj = maintainerMap->find(regionId);
+    if (maintainerObj != maintainerMap->end())
+        maintainer = maintainerObj->second;
+    pthread_mutex_unlock(&maintainerMapLock);
+    return maintainer;
+}
+
+/*
+ * Get the statistics of the maintenance threads of all open heaps.
+ */
+void Memserver_Allocator::get_heap_stats(
+    std::vector<Heap_Maintenance_Stats> &stats) {
+    pthread_mutex_lock(&maintainerMapLock);
+    for (auto maintainerObj : *maintainerMap) {
+        Heap_Maintenance_Stats heapStats;
+        maintainerObj.second->get_stats(heapStats);
+        stats.push_back(heapStats);
+    }
+    pthread_mutex_unlock(&maintainerMapLock);
+}
+
+/*
+ * Get the generation and size of the open heap of a region, for clients
+ * accessing the heap directly. Returns false if the heap is not open.
+ */
+bool Memserver_Allocator::get_heap_generation(uint64_t regionId,
+                                              uint64_t &generation,
+                                              uint64_t &heapSize) {
+    bool found = false;
+    pthread_mutex_lock(&maintainerMapLock);
+    auto maintainerObj = maintainerMap->find(regionId);
+    if (maintainerObj != maintainerMap->end()) {
+        generation = maintainerObj->second->get_generation();
+        heapSize = maintainerObj->second->get_heap_size();
+        found = true;
+    }
+    pthread_mutex_unlock(&maintainerMapLock);
+    return found;
+}
+
+uint64_t Memserver_Allocator::get_num_heaps() {
+    pthread_mutex_lock(&heapMapLock);
+    uint64_t numHeaps = heapMap->size();
+    pthread_mutex_unlock(&heapMapLock);
+    return numHeaps;
+}
+
+/*
+ * Open the heaps of all existing regions in the background, using
+ * numThreads threads. Client requests are served during the recovery,
+ * heaps not yet opened are opened on first access as before.
+ */
+void Memserver_Allocator::start_recovery(uint64_t numThreads) {
+    recoveryReady = false;
+    recoveryThread =
+        std::thread(&Memserver_Allocator::recover_regions, this, numThreads);
+}
+
+void Memserver_Allocator::recover_regions(uint64_t numThreads) {
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    // Regions in use are the ones reserved in the region Id bitmap and
+    // registered with the metadata service
+    std::vector<uint64_t> regions;
+    uint64_t regionId = MEMSERVER_REGIONID_START;
+    while (true) {
+        int64_t pos = (int64_t)bitmap_find(bmap, 1, regionId);
+        if (pos == BITMAP_NOTFOUND)
+            break;
+        regionId = (uint64_t)pos;
+        Fam_Region_Metadata region;
+        if (metadataManager->metadata_find_region(regionId, region) ==
+            META_NO_ERROR)
+            regions.push_back(regionId);
+        regionId++;
+    }
+    recoveryRegions = regions.size();
+
+    // Open the heaps and recover their slabs in parallel
+    std::atomic<uint64_t> next(0);
+    auto recover = [&]() {
+        uint64_t i;
+        while ((i = next.fetch_add(1)) < regions.size()) {
+            try {
+                Heap *heap = 0;
+                open_heap(regions[i]);
+                get_heap(regions[i], heap);
+                if (heap)
+                    get_slab(regions[i], heap);
+                recoveredRegions++;
+            } catch (...) {
+                recoveryFailures++;
+            }
+        }
+    };
+
+    if (numThreads > regions.size())
+        numThreads = regions.size();
+    std::vector<std::thread> threads;
+    for (uint64_t i = 1; i < numThreads; i++)
+        threads.push_back(std::thread(recover));
+    recover();
+    for (auto &thread : threads)
+        thread.join();
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    recoveryNs = (uint64_t)(end.tv_sec - start.tv_sec) * 1000000000UL +
+                 (uint64_t)end.tv_nsec - (uint64_t)start.tv_nsec;
+    recoveryReady = true;
+#if defined(FAM_DEBUG)
+    cout << "Memory server ready: recovered " << recoveredRegions << " of "
+         << recoveryRegions << " regions in " << recoveryNs / 1000000
+         << " ms" << endl;
+#endif
+}
+
+void Memserver_Allocator::get_recovery_status(
+    Memserver_Recovery_Status &status) {
+    status.ready = recoveryReady;
+    status.numRegions = recoveryRegions;
+    status.numRecovered = recoveredRegions;
+    status.numFailed = recoveryFailures;
+    status.recoveryNs = recoveryNs;
+}
+
 /*
  * Allocate the first free region id to be allocated.
  */
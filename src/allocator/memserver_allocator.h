@@ -30,9 +30,14 @@
 #ifndef MEMSERVER_ALLOCATOR_H_
 #define MEMSERVER_ALLOCATOR_H_
 
+#include <algorithm>
+#include <atomic>
 #include <iostream>
+#include <memory>
 #include <pthread.h>
 #include <sys/types.h> // needed for mode_t
+#include <thread>
+#include <vector>
 
 #include <nvmm/error_code.h>
 #include <nvmm/global_ptr.h>
@@ -41,8 +46,12 @@
 #include <nvmm/memory_manager.h>
 #include <nvmm/shelf_id.h>
 
+#include "allocator/memserver_heap_maintainer.h"
+#include "allocator/memserver_slab.h"
 #include "bitmap-manager/bitmap.h"
 #include "common/fam_internal.h"
+#include "common/fam_util_reduce.h"
+#include "common/fam_util_scan.h"
 #include "common/memserver_exception.h"
 #include "fam/fam.h"
 #include "metadata/fam_metadata_manager.h"
@@ -57,10 +66,28 @@ using namespace metadata;
 namespace openfam {
 
 using HeapMap = std::map<uint64_t, Heap *>;
+using SlabTable = std::vector<std::shared_ptr<Memserver_Slab>>;
+using MaintainerMap =
+    std::map<uint64_t, std::shared_ptr<Memserver_Heap_Maintainer>>;
+
+/*
+ * Progress of the startup recovery of existing regions.
+ * ready - recovery completed, all existing heaps are open
+ * numRegions - number of existing regions found at startup
+ * numRecovered/numFailed - regions whose heap was opened or failed to open
+ * recoveryNs - time taken by the recovery, in nanoseconds
+ */
+typedef struct {
+    bool ready;
+    uint64_t numRegions;
+    uint64_t numRecovered;
+    uint64_t numFailed;
+    uint64_t recoveryNs;
+} Memserver_Recovery_Status;
 
 class Memserver_Allocator {
   public:
-    Memserver_Allocator();
+    Memserver_Allocator(bool enableSlabs = false);
     ~Memserver_Allocator();
     void memserver_allocator_finalize();
     int create_region(string name, uint64_t &regionId, size_t nbytes,
@@ -96,6 +123,20 @@ class Memserver_Allocator {
     int copy(uint64_t regionId, uint64_t srcOffset, uint64_t srcCopyStart,
              uint64_t destOffset, uint64_t destCopyStart, uint32_t uid,
              uint32_t gid, size_t nbytes);
+    int reduce(uint64_t regionId, uint64_t offset, uint64_t start,
+               uint64_t count, Fam_Data_Type type, Fam_Reduce_Op op,
+               uint32_t uid, uint32_t gid, void *result);
+    int scan(uint64_t regionId, uint64_t offset, uint64_t start,
+             uint64_t recordSize, uint64_t numRecords,
+             const Fam_Scan_Predicate *predicate, Fam_Scan_Output output,
+             uint64_t destRegionId, uint64_t destOffset, uint64_t destStart,
+             uint32_t uid, uint32_t gid, uint64_t *matches);
+    void get_heap_stats(std::vector<Heap_Maintenance_Stats> &stats);
+    bool get_heap_generation(uint64_t regionId, uint64_t &generation,
+                             uint64_t &heapSize);
+    uint64_t get_num_heaps();
+    void start_recovery(uint64_t numThreads);
+    void get_recovery_status(Memserver_Recovery_Status &status);
 
   private:
     MemoryManager *memoryManager;
@@ -103,6 +144,25 @@ class Memserver_Allocator {
     HeapMap *heapMap;
     pthread_mutex_t heapMapLock;
     HeapMap::iterator get_heap(uint64_t regionId, Heap *&heap);
+    bool useSlabs;
+    SlabTable *slabTable;
+    std::shared_ptr<Memserver_Slab> get_slab(uint64_t regionId, Heap *heap);
+    void remove_slab(uint64_t regionId);
+    bool free_offset(uint64_t regionId, Heap *heap, uint64_t offset);
+    static uint64_t reserved_size(uint64_t tmpSize, bool fromSlab);
+    MaintainerMap *maintainerMap;
+    pthread_mutex_t maintainerMapLock;
+    void start_maintainer(uint64_t regionId, Heap *heap, uint64_t heapSize);
+    void stop_maintainer(uint64_t regionId);
+    std::shared_ptr<Memserver_Heap_Maintainer>
+    get_maintainer(uint64_t regionId);
+    std::thread recoveryThread;
+    std::atomic<bool> recoveryReady;
+    std::atomic<uint64_t> recoveryRegions;
+    std::atomic<uint64_t> recoveredRegions;
+    std::atomic<uint64_t> recoveryFailures;
+    std::atomic<uint64_t> recoveryNs;
+    void recover_regions(uint64_t numThreads);
     PoolId get_free_poolId();
     bitmap *bmap;
     void init_poolId_bmap();
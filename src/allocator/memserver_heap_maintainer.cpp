@@ -0,0 +1,254 @@
+/*
+ * memserver_heap_maintainer.cpp
+ * Copyright (c) 2019 Hewlett Packard Enterprise Development, LP. All rights
+ * reserved. Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ *    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * See https://spdx.org/licenses/BSD-3-Clause
+ *
+ */
+#include <time.h>
+
+#include "allocator/memserver_heap_maintainer.h"
+
+namespace openfam {
+
+static uint64_t realtime_ns() {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000UL + (uint64_t)ts.tv_nsec;
+}
+
+/*
+ * Generations handed to the heaps opened by this process, starting from
+ * the time the process started so that a heap opened after a restart gets
+ * a larger generation than any heap opened before
+ */
+static std::atomic<uint64_t> nextGeneration(realtime_ns());
+
+Memserver_Heap_Maintainer::Memserver_Heap_Maintainer(Heap *maintHeap,
+                                                     uint64_t maintRegionId,
+                                                     uint64_t maintHeapSize) {
+    heap = maintHeap;
+    regionId = maintRegionId;
+    stop = false;
+    generation = nextGeneration++;
+    heapSize = maintHeapSize;
+    lastActivityNs = now_ns();
+    freesSinceMerge = 0;
+    freedBytesSinceMerge = 0;
+    numMerges = 0;
+    numMergeFailures = 0;
+    allocFailures = 0;
+    lastMergeNs = 0;
+    totalMergeNs = 0;
+    numDataitems = 0;
+    allocatedBytes = 0;
+    reservedBytes = 0;
+    (void)pthread_mutex_init(&maintLock, NULL);
+    (void)pthread_cond_init(&maintCond, NULL);
+    (void)pthread_mutex_init(&mergeLock, NULL);
+    maintThread = std::thread(&Memserver_Heap_Maintainer::maintenance_thread,
+                              this);
+}
+
+Memserver_Heap_Maintainer::~Memserver_Heap_Maintainer() {
+    shutdown();
+    pthread_mutex_destroy(&maintLock);
+    pthread_cond_destroy(&maintCond);
+    pthread_mutex_destroy(&mergeLock);
+}
+
+/*
+ * Stops the maintenance thread. Must be called before the heap is closed;
+ * failed allocations no longer merge the heap afterwards.
+ */
+void Memserver_Heap_Maintainer::shutdown() {
+    pthread_mutex_lock(&maintLock);
+    stop = true;
+    pthread_cond_signal(&maintCond);
+    pthread_mutex_unlock(&maintLock);
+    if (maintThread.joinable())
+        maintThread.join();
+    // Wait for the merge of a failed allocation started before the stop
+    pthread_mutex_lock(&mergeLock);
+    pthread_mutex_unlock(&mergeLock);
+}
+
+uint64_t Memserver_Heap_Maintainer::now_ns() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000UL + (uint64_t)ts.tv_nsec;
+}
+
+void Memserver_Heap_Maintainer::note_alloc() {
+    lastActivityNs.store(now_ns(), std::memory_order_relaxed);
+}
+
+void Memserver_Heap_Maintainer::note_free(uint64_t nbytes) {
+    lastActivityNs.store(now_ns(), std::memory_order_relaxed);
+    freesSinceMerge.fetch_add(1, std::memory_order_relaxed);
+    freedBytesSinceMerge.fetch_add(nbytes, std::memory_order_relaxed);
+}
+
+void Memserver_Heap_Maintainer::set_heap_size(uint64_t nbytes) {
+    heapSize.store(nbytes, std::memory_order_relaxed);
+}
+
+void Memserver_Heap_Maintainer::add_usage(uint64_t nbytes, uint64_t reserved) {
+    numDataitems.fetch_add(1, std::memory_order_relaxed);
+    allocatedBytes.fetch_add(nbytes, std::memory_order_relaxed);
+    reservedBytes.fetch_add(reserved, std::memory_order_relaxed);
+}
+
+/*
+ * Dataitems allocated before the heap was opened are not counted, so their
+ * release must not take the counters below zero.
+ */
+void Memserver_Heap_Maintainer::remove_usage(uint64_t nbytes,
+                                             uint64_t reserved) {
+    subtract(numDataitems, 1);
+    subtract(allocatedBytes, nbytes);
+    subtract(reservedBytes, reserved);
+}
+
+void Memserver_Heap_Maintainer::subtract(std::atomic<uint64_t> &counter,
+                                         uint64_t value) {
+    uint64_t old = counter.load(std::memory_order_relaxed);
+    while (!counter.compare_exchange_weak(old, old > value ? old - value : 0,
+                                          std::memory_order_relaxed))
+        ;
+}
+
+/*
+ * Called when an allocation from the heap failed. Merges free space of the
+ * heap on the calling thread, so that the allocation can be retried once
+ * with the merged space. The heap is merged even if no block was freed
+ * since the last merge, as blocks freed before the heap was opened are not
+ * counted. Returns false if the merge failed, or if the heap is being
+ * closed.
+ */
+bool Memserver_Heap_Maintainer::merge_now() {
+    allocFailures++;
+    pthread_mutex_lock(&maintLock);
+    bool merged = !stop && merge();
+    pthread_mutex_unlock(&maintLock);
+    return merged;
+}
+
+void Memserver_Heap_Maintainer::get_stats(Heap_Maintenance_Stats &stats) {
+    stats.regionId = regionId;
+    stats.numMerges = numMerges;
+    stats.numMergeFailures = numMergeFailures;
+    stats.freesSinceMerge = freesSinceMerge;
+    stats.freedBytesSinceMerge = freedBytesSinceMerge;
+    stats.allocFailures = allocFailures;
+    stats.lastMergeNs = lastMergeNs;
+    stats.totalMergeNs = totalMergeNs;
+    stats.numDataitems = numDataitems;
+    stats.allocatedBytes = allocatedBytes;
+    stats.reservedBytes = reservedBytes;
+}
+
+/*
+ * The heap is considered fragmented when the blocks freed since the last
+ * merge, which can only be reused for allocations of their own size, make
+ * up HEAP_MAINT_FRAG_PERCENT of the free space of the heap.
+ */
+bool Memserver_Heap_Maintainer::is_fragmented() {
+    uint64_t freed = freedBytesSinceMerge.load(std::memory_order_relaxed);
+    uint64_t size = heapSize.load(std::memory_order_relaxed);
+    uint64_t reserved = reservedBytes.load(std::memory_order_relaxed);
+    uint64_t freeBytes = (size > reserved) ? size - reserved : 0;
+    return (freed > 0) && (freed * 100 >= freeBytes * HEAP_MAINT_FRAG_PERCENT);
+}
+
+/*
+ * Decide if free space of the heap should be merged now. Called with
+ * maintLock held.
+ */
+bool Memserver_Heap_Maintainer::should_merge() {
+    if (is_fragmented())
+        return true;
+    uint64_t frees = freesSinceMerge.load(std::memory_order_relaxed);
+    uint64_t idleNs =
+        now_ns() - lastActivityNs.load(std::memory_order_relaxed);
+    return (frees > 0) && (idleNs >= HEAP_MAINT_IDLE_MS * 1000000UL);
+}
+
+/*
+ * Merge free space of the heap. Called with maintLock held, the lock is
+ * dropped while merging so that get_stats() and the maintenance thread are
+ * not blocked; mergeLock, taken before maintLock is dropped, keeps the
+ * maintenance thread and failed allocations from merging the heap at the
+ * same time, and lets shutdown() wait for a merge in progress. Blocks
+ * freed while merging are left for the next merge. Returns false if the
+ * merge failed.
+ */
+bool Memserver_Heap_Maintainer::merge() {
+    pthread_mutex_lock(&mergeLock);
+    uint64_t frees = freesSinceMerge.load();
+    uint64_t freed = freedBytesSinceMerge.load();
+    pthread_mutex_unlock(&maintLock);
+
+    bool failed = false;
+    uint64_t start = now_ns();
+    try {
+        heap->Merge();
+    } catch (...) {
+        failed = true;
+    }
+    uint64_t elapsed = now_ns() - start;
+    pthread_mutex_unlock(&mergeLock);
+
+    pthread_mutex_lock(&maintLock);
+    subtract(freesSinceMerge, frees);
+    subtract(freedBytesSinceMerge, freed);
+    lastMergeNs = elapsed;
+    totalMergeNs += elapsed;
+    if (failed)
+        numMergeFailures++;
+    else
+        numMerges++;
+    return !failed;
+}
+
+void Memserver_Heap_Maintainer::maintenance_thread() {
+    pthread_mutex_lock(&maintLock);
+    while (!stop) {
+        if (should_merge()) {
+            merge();
+            continue;
+        }
+        struct timespec ts;
+        clock_gettime(CLOCK_REALTIME, &ts);
+        uint64_t nsec =
+            (uint64_t)ts.tv_nsec + HEAP_MAINT_INTERVAL_MS * 1000000UL;
+        ts.tv_sec += (time_t)(nsec / 1000000000UL);
+        ts.tv_nsec = (long)(nsec % 1000000000UL);
+        pthread_cond_timedwait(&maintCond, &maintLock, &ts);
+    }
+    pthread_mutex_unlock(&maintLock);
+}
+
+} // namespace openfam
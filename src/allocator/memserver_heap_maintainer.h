@@ -0,0 +1,139 @@
+/*
+ * memserver_heap_maintainer.h
+ * Copyright (c) 2019 Hewlett Packard Enterprise Development, LP. All rights
+ * reserved. Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ *    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * See https://spdx.org/licenses/BSD-3-Clause
+ *
+ */
+#ifndef MEMSERVER_HEAP_MAINTAINER_H_
+#define MEMSERVER_HEAP_MAINTAINER_H_
+
+#include <atomic>
+#include <pthread.h>
+#include <thread>
+
+#include <nvmm/heap.h>
+
+#include "common/fam_internal.h"
+
+using namespace std;
+using namespace nvmm;
+
+namespace openfam {
+
+/*
+ * The maintenance thread of a heap wakes up every HEAP_MAINT_INTERVAL_MS and
+ * merges free space of the heap when
+ * - the heap is fragmented: blocks freed since the last merge make up
+ *   HEAP_MAINT_FRAG_PERCENT of the free space of the heap, or
+ * - some blocks were freed and the heap was idle for HEAP_MAINT_IDLE_MS.
+ * Free space is estimated from the size of the heap and the bytes reserved
+ * for dataitems allocated since the heap was opened. An allocation that
+ * fails merges the heap itself and retries, see merge_now().
+ */
+#define HEAP_MAINT_INTERVAL_MS 100
+#define HEAP_MAINT_IDLE_MS 1000
+#define HEAP_MAINT_FRAG_PERCENT 25
+
+/*
+ * Statistics of the maintenance thread of a heap.
+ * freesSinceMerge/freedBytesSinceMerge - blocks freed to the heap since the
+ *     last merge, and their size
+ * allocFailures - allocations which failed and merged the heap to retry
+ * lastMergeNs/totalMergeNs - time spent in Merge(), in nanoseconds
+ * numDataitems/allocatedBytes - live dataitems allocated since the heap was
+ *     opened, and the bytes requested for them
+ * reservedBytes - bytes taken from the heap or its slabs for those dataitems,
+ *     after rounding up to the object or slab class size
+ */
+typedef struct {
+    uint64_t regionId;
+    uint64_t numMerges;
+    uint64_t numMergeFailures;
+    uint64_t freesSinceMerge;
+    uint64_t freedBytesSinceMerge;
+    uint64_t allocFailures;
+    uint64_t lastMergeNs;
+    uint64_t totalMergeNs;
+    uint64_t numDataitems;
+    uint64_t allocatedBytes;
+    uint64_t reservedBytes;
+} Heap_Maintenance_Stats;
+
+class Memserver_Heap_Maintainer {
+  public:
+    Memserver_Heap_Maintainer(Heap *heap, uint64_t regionId,
+                              uint64_t heapSize);
+    ~Memserver_Heap_Maintainer();
+
+    void shutdown();
+
+    void note_alloc();
+    void note_free(uint64_t nbytes);
+    void set_heap_size(uint64_t nbytes);
+    void add_usage(uint64_t nbytes, uint64_t reserved);
+    void remove_usage(uint64_t nbytes, uint64_t reserved);
+    bool merge_now();
+    void get_stats(Heap_Maintenance_Stats &stats);
+    uint64_t get_heap_size() {
+        return heapSize.load(std::memory_order_relaxed);
+    }
+    // Distinguishes the heaps opened for the same region id over time
+    uint64_t get_generation() { return generation; }
+
+  private:
+    Heap *heap;
+    uint64_t regionId;
+    std::thread maintThread;
+    pthread_mutex_t maintLock;
+    pthread_cond_t maintCond;
+    pthread_mutex_t mergeLock;
+    bool stop;
+    uint64_t generation;
+
+    std::atomic<uint64_t> heapSize;
+    std::atomic<uint64_t> lastActivityNs;
+    std::atomic<uint64_t> freesSinceMerge;
+    std::atomic<uint64_t> freedBytesSinceMerge;
+    std::atomic<uint64_t> numMerges;
+    std::atomic<uint64_t> numMergeFailures;
+    std::atomic<uint64_t> allocFailures;
+    std::atomic<uint64_t> lastMergeNs;
+    std::atomic<uint64_t> totalMergeNs;
+    std::atomic<uint64_t> numDataitems;
+    std::atomic<uint64_t> allocatedBytes;
+    std::atomic<uint64_t> reservedBytes;
+
+    static uint64_t now_ns();
+    static void subtract(std::atomic<uint64_t> &counter, uint64_t value);
+    bool is_fragmented();
+    bool should_merge();
+    bool merge();
+    void maintenance_thread();
+};
+
+} // namespace openfam
+
+#endif /* end of MEMSERVER_HEAP_MAINTAINER_H_ */
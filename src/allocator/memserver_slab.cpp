@@ -0,0 +1,445 @@
+/*
+ * memserver_slab.cpp
+ * Copyright (c) 2019 Hewlett Packard Enterprise Development, LP. All rights
+ * reserved. Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ *    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * See https://spdx.org/licenses/BSD-3-Clause
+ *
+ */
+#include <algorithm>
+#include <functional>
+#include <string.h>
+#include <thread>
+
+#include "allocator/memserver_slab.h"
+
+namespace openfam {
+Memserver_Slab::Memserver_Slab(Heap *slabHeap, uint64_t slabRegionId,
+                               uint64_t slabDirOffset) {
+    heap = slabHeap;
+    regionId = slabRegionId;
+    dirOffset = slabDirOffset;
+    slabIndex = new SlabIndex();
+    (void)pthread_mutex_init(&slabIndexLock, NULL);
+    for (uint32_t i = 0; i < SLAB_NUM_CLASSES; i++) {
+        (void)pthread_mutex_init(&classLock[i], NULL);
+        for (uint32_t j = 0; j < SLAB_NUM_CACHES; j++)
+            (void)pthread_mutex_init(&caches[i][j].lock, NULL);
+    }
+}
+
+Memserver_Slab::~Memserver_Slab() {
+    for (auto slabObj : *slabIndex)
+        delete slabObj.second;
+    delete slabIndex;
+    pthread_mutex_destroy(&slabIndexLock);
+    for (uint32_t i = 0; i < SLAB_NUM_CLASSES; i++) {
+        pthread_mutex_destroy(&classLock[i]);
+        for (uint32_t j = 0; j < SLAB_NUM_CACHES; j++)
+            pthread_mutex_destroy(&caches[i][j].lock);
+    }
+}
+
+/*
+ * Returns true if an allocation of nbytes is served by the slab layer.
+ */
+bool Memserver_Slab::is_slab_size(size_t nbytes) {
+    return (nbytes <= SLAB_MAX_CLASS_SIZE);
+}
+
+/*
+ * Returns the size of the slab objects an allocation of nbytes is served from.
+ */
+uint64_t Memserver_Slab::object_size(size_t nbytes) {
+    return SLAB_MIN_CLASS_SIZE << get_size_class(nbytes);
+}
+
+/*
+ * Allocate and initialize a slab directory block from the heap.
+ * Returns the offset of the block, or 0 if the heap is out of space.
+ */
+uint64_t Memserver_Slab::create_directory(Heap *heap) {
+    uint64_t offset = heap->AllocOffset(SLAB_DIR_SIZE);
+    if (!offset)
+        return 0;
+
+    Slab_Directory *dir = (Slab_Directory *)heap->OffsetToLocal(offset);
+    memset((void *)dir, 0, SLAB_DIR_SIZE);
+    dir->magic = SLAB_DIR_MAGIC;
+    dir->numEntries = SLAB_DIR_ENTRIES;
+    openfam_persist(dir, SLAB_DIR_SIZE);
+    return offset;
+}
+
+/*
+ * Free an unused slab directory block created by create_directory().
+ */
+void Memserver_Slab::destroy_directory(Heap *heap, uint64_t dirOffset) {
+    Slab_Directory *dir = (Slab_Directory *)heap->OffsetToLocal(dirOffset);
+    dir->magic = 0;
+    openfam_persist(&dir->magic, sizeof(uint64_t));
+    heap->Free(dirOffset);
+}
+
+uint32_t Memserver_Slab::get_size_class(size_t nbytes) {
+    uint32_t sizeClass = 0;
+    size_t classSize = SLAB_MIN_CLASS_SIZE;
+    while (classSize < nbytes) {
+        classSize <<= 1;
+        sizeClass++;
+    }
+    return sizeClass;
+}
+
+uint32_t Memserver_Slab::get_num_objects(uint32_t sizeClass) {
+    uint64_t objectSize = SLAB_MIN_CLASS_SIZE << sizeClass;
+    uint64_t numObjects = SLAB_TARGET_SIZE / objectSize;
+    if (numObjects > SLAB_MAX_OBJECTS)
+        numObjects = SLAB_MAX_OBJECTS;
+    if (numObjects < SLAB_MIN_OBJECTS)
+        numObjects = SLAB_MIN_OBJECTS;
+    return (uint32_t)numObjects;
+}
+
+uint32_t Memserver_Slab::get_cache_index() {
+    size_t hash = std::hash<std::thread::id>()(std::this_thread::get_id());
+    return (uint32_t)(hash % SLAB_NUM_CACHES);
+}
+
+/*
+ * Add the slab offset to a free entry of the slab directory, extending
+ * the directory if all entries are in use.
+ * Must be called with slabIndexLock held.
+ */
+uint64_t *Memserver_Slab::add_directory_entry(uint64_t slabOffset) {
+    uint64_t blockOffset = dirOffset;
+    while (blockOffset) {
+        Slab_Directory *dir =
+            (Slab_Directory *)heap->OffsetToLocal(blockOffset);
+        for (uint64_t i = 0; i < dir->numEntries; i++) {
+            if (dir->slabs[i] == 0) {
+                dir->slabs[i] = slabOffset;
+                openfam_persist(&dir->slabs[i], sizeof(uint64_t));
+                return &dir->slabs[i];
+            }
+        }
+        if (!dir->next) {
+            dir->next = create_directory(heap);
+            openfam_persist(&dir->next, sizeof(uint64_t));
+        }
+        blockOffset = dir->next;
+    }
+    return NULL;
+}
+
+/*
+ * Carve a new slab for the size class out of the heap.
+ * The slab header is persisted before the slab is added to the directory,
+ * so that recovery never sees a directory entry without a valid header.
+ * Must be called with classLock of the size class held.
+ */
+Slab_Info *Memserver_Slab::create_slab(uint32_t sizeClass) {
+    uint32_t numObjects = get_num_objects(sizeClass);
+    uint64_t objectSize = SLAB_MIN_CLASS_SIZE << sizeClass;
+
+    uint64_t offset =
+        heap->AllocOffset(SLAB_MIN_CLASS_SIZE + numObjects * objectSize);
+    if (!offset)
+        return NULL;
+
+    Slab_Header *header = (Slab_Header *)heap->OffsetToLocal(offset);
+    memset((void *)header, 0, sizeof(Slab_Header));
+    header->magic = SLAB_HEADER_MAGIC;
+    header->sizeClass = sizeClass;
+    header->numObjects = numObjects;
+    header->objectSize = objectSize;
+    // Bits beyond numObjects are kept set, so that a full slab has all
+    // bits of allocMap set
+    if (numObjects < SLAB_MAX_OBJECTS)
+        header->allocMap = ~((1UL << numObjects) - 1);
+    openfam_persist(header, sizeof(Slab_Header));
+
+    pthread_mutex_lock(&slabIndexLock);
+    uint64_t *dirEntry = add_directory_entry(offset);
+    if (dirEntry == NULL) {
+        pthread_mutex_unlock(&slabIndexLock);
+        heap->Free(offset);
+        return NULL;
+    }
+
+    Slab_Info *slab = new Slab_Info();
+    slab->offset = offset;
+    slab->header = header;
+    slab->dirEntry = dirEntry;
+    slab->sizeClass = sizeClass;
+    slab->numFree = numObjects;
+    slabIndex->insert({offset, slab});
+    pthread_mutex_unlock(&slabIndexLock);
+
+    partialSlabs[sizeClass].push_back(slab);
+    return slab;
+}
+
+/*
+ * Return an empty slab to the heap.
+ * Must be called with classLock of the size class held.
+ */
+void Memserver_Slab::release_slab(Slab_Info *slab) {
+    std::vector<Slab_Info *> &partial = partialSlabs[slab->sizeClass];
+    auto slabObj = std::find(partial.begin(), partial.end(), slab);
+    if (slabObj != partial.end())
+        partial.erase(slabObj);
+
+    pthread_mutex_lock(&slabIndexLock);
+    *slab->dirEntry = 0;
+    openfam_persist(slab->dirEntry, sizeof(uint64_t));
+    slabIndex->erase(slab->offset);
+    pthread_mutex_unlock(&slabIndexLock);
+
+    heap->Free(slab->offset);
+    delete slab;
+}
+
+/*
+ * Find the slab containing the object at the given offset.
+ * Returns NULL if the offset does not belong to any slab.
+ */
+Slab_Info *Memserver_Slab::find_slab(uint64_t offset) {
+    Slab_Info *slab = NULL;
+    pthread_mutex_lock(&slabIndexLock);
+    auto slabObj = slabIndex->upper_bound(offset);
+    if (slabObj != slabIndex->begin()) {
+        slabObj--;
+        Slab_Info *candidate = slabObj->second;
+        uint64_t start = candidate->offset + SLAB_MIN_CLASS_SIZE;
+        uint64_t end = start + candidate->header->numObjects *
+                                   candidate->header->objectSize;
+        if ((offset >= start) && (offset < end))
+            slab = candidate;
+    }
+    pthread_mutex_unlock(&slabIndexLock);
+    return slab;
+}
+
+/*
+ * Move up to SLAB_REFILL_BATCH free objects of the size class into the
+ * cache. The objects are marked allocated in the slab header before they
+ * are handed out; objects left in a cache at crash are reclaimed by recover().
+ * Must be called with the cache lock held.
+ */
+void Memserver_Slab::refill_cache(uint32_t sizeClass, Slab_Cache *cache) {
+    uint32_t needed = SLAB_REFILL_BATCH;
+
+    pthread_mutex_lock(&classLock[sizeClass]);
+    while (needed) {
+        if (partialSlabs[sizeClass].empty() && !create_slab(sizeClass))
+            break;
+
+        Slab_Info *slab = partialSlabs[sizeClass].back();
+        Slab_Header *header = slab->header;
+        uint64_t allocMap = header->allocMap;
+        while (needed && slab->numFree) {
+            uint32_t index = (uint32_t)__builtin_ctzll(~allocMap);
+            allocMap |= (1UL << index);
+            cache->objects.push_back(slab->offset + SLAB_MIN_CLASS_SIZE +
+                                     index * header->objectSize);
+            slab->numFree--;
+            needed--;
+        }
+        header->allocMap = allocMap;
+        openfam_persist(&header->allocMap, sizeof(uint64_t));
+
+        if (!slab->numFree)
+            partialSlabs[sizeClass].pop_back();
+    }
+    pthread_mutex_unlock(&classLock[sizeClass]);
+}
+
+/*
+ * Return count objects from the cache to their slabs. A slab which becomes
+ * empty is released to the heap, as long as the size class has another
+ * slab with free objects.
+ * Must be called with the cache lock held.
+ */
+void Memserver_Slab::drain_cache(uint32_t sizeClass, Slab_Cache *cache,
+                                 size_t count) {
+    pthread_mutex_lock(&classLock[sizeClass]);
+    while (count-- && !cache->objects.empty()) {
+        uint64_t offset = cache->objects.back();
+        cache->objects.pop_back();
+
+        Slab_Info *slab = find_slab(offset);
+        if (slab == NULL)
+            continue;
+
+        Slab_Header *header = slab->header;
+        uint64_t index =
+            (offset - slab->offset - SLAB_MIN_CLASS_SIZE) / header->objectSize;
+        header->allocMap &= ~(1UL << index);
+        openfam_persist(&header->allocMap, sizeof(uint64_t));
+
+        if (slab->numFree++ == 0)
+            partialSlabs[sizeClass].push_back(slab);
+
+        if ((slab->numFree == header->numObjects) &&
+            (partialSlabs[sizeClass].size() > 1))
+            release_slab(slab);
+    }
+    pthread_mutex_unlock(&classLock[sizeClass]);
+}
+
+/*
+ * Rebuild the in-memory slab state of the region from the persistent slab
+ * directory, once per slab. Threads calling recover() concurrently wait for
+ * the first one to finish, other regions are not blocked.
+ */
+void Memserver_Slab::recover(FAM_Metadata_Manager *metadataManager) {
+    std::call_once(recoverFlag, &Memserver_Slab::recover_directory, this,
+                   metadataManager);
+}
+
+/*
+ * Objects marked allocated in a slab header for which no dataitem exists in
+ * the metadata service (held in a cache or not yet registered at the time of
+ * a crash) are marked free again.
+ */
+void Memserver_Slab::recover_directory(FAM_Metadata_Manager *metadataManager) {
+    uint64_t blockOffset = dirOffset;
+    while (blockOffset) {
+        Slab_Directory *dir =
+            (Slab_Directory *)heap->OffsetToLocal(blockOffset);
+        if (dir->magic != SLAB_DIR_MAGIC)
+            break;
+
+        for (uint64_t i = 0; i < dir->numEntries; i++) {
+            if (dir->slabs[i] == 0)
+                continue;
+
+            Slab_Header *header =
+                (Slab_Header *)heap->OffsetToLocal(dir->slabs[i]);
+            if ((header->magic != SLAB_HEADER_MAGIC) ||
+                (header->sizeClass >= SLAB_NUM_CLASSES)) {
+                dir->slabs[i] = 0;
+                openfam_persist(&dir->slabs[i], sizeof(uint64_t));
+                continue;
+            }
+
+            uint64_t allocMap = header->allocMap;
+            uint32_t numFree = 0;
+            for (uint32_t j = 0; j < header->numObjects; j++) {
+                if (!(allocMap & (1UL << j))) {
+                    numFree++;
+                    continue;
+                }
+                uint64_t offset = dir->slabs[i] + SLAB_MIN_CLASS_SIZE +
+                                  j * header->objectSize;
+                Fam_DataItem_Metadata dataitem;
+                int ret = metadataManager->metadata_find_dataitem(
+                    offset / SLAB_MIN_CLASS_SIZE, regionId, dataitem);
+                if (ret != META_NO_ERROR) {
+                    allocMap &= ~(1UL << j);
+                    numFree++;
+                }
+            }
+            if (allocMap != header->allocMap) {
+                header->allocMap = allocMap;
+                openfam_persist(&header->allocMap, sizeof(uint64_t));
+            }
+
+            Slab_Info *slab = new Slab_Info();
+            slab->offset = dir->slabs[i];
+            slab->header = header;
+            slab->dirEntry = &dir->slabs[i];
+            slab->sizeClass = header->sizeClass;
+            slab->numFree = numFree;
+            slabIndex->insert({slab->offset, slab});
+            if (numFree)
+                partialSlabs[slab->sizeClass].push_back(slab);
+        }
+        blockOffset = dir->next;
+    }
+}
+
+/*
+ * Allocate an object for nbytes from the slab layer.
+ * Returns the offset of the object, or 0 if no space is left in the heap.
+ */
+uint64_t Memserver_Slab::alloc(size_t nbytes) {
+    uint32_t sizeClass = get_size_class(nbytes);
+    Slab_Cache *cache = &caches[sizeClass][get_cache_index()];
+    uint64_t offset = 0;
+
+    if (!dirOffset)
+        return 0;
+
+    pthread_mutex_lock(&cache->lock);
+    if (cache->objects.empty())
+        refill_cache(sizeClass, cache);
+    if (!cache->objects.empty()) {
+        offset = cache->objects.back();
+        cache->objects.pop_back();
+    }
+    pthread_mutex_unlock(&cache->lock);
+
+    return offset;
+}
+
+/*
+ * Free the object at the given offset.
+ * Returns false if the offset was not allocated from the slab layer.
+ */
+bool Memserver_Slab::free(uint64_t offset) {
+    if (!dirOffset)
+        return false;
+
+    Slab_Info *slab = find_slab(offset);
+    if (slab == NULL)
+        return false;
+
+    uint32_t sizeClass = slab->sizeClass;
+    Slab_Cache *cache = &caches[sizeClass][get_cache_index()];
+
+    pthread_mutex_lock(&cache->lock);
+    cache->objects.push_back(offset);
+    if (cache->objects.size() > SLAB_CACHE_MAX)
+        drain_cache(sizeClass, cache, SLAB_REFILL_BATCH);
+    pthread_mutex_unlock(&cache->lock);
+
+    return true;
+}
+
+/*
+ * Return all cached objects to their slabs.
+ */
+void Memserver_Slab::flush() {
+    for (uint32_t i = 0; i < SLAB_NUM_CLASSES; i++) {
+        for (uint32_t j = 0; j < SLAB_NUM_CACHES; j++) {
+            pthread_mutex_lock(&caches[i][j].lock);
+            drain_cache(i, &caches[i][j], caches[i][j].objects.size());
+            pthread_mutex_unlock(&caches[i][j].lock);
+        }
+    }
+}
+
+} // namespace openfam
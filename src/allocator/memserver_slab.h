@@ -0,0 +1,178 @@
+/*
+ * memserver_slab.h
+ * Copyright (c) 2019 Hewlett Packard Enterprise Development, LP. All rights
+ * reserved. Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ *    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * See https://spdx.org/licenses/BSD-3-Clause
+ *
+ */
+#ifndef MEMSERVER_SLAB_H_
+#define MEMSERVER_SLAB_H_
+
+#include <map>
+#include <mutex>
+#include <pthread.h>
+#include <vector>
+
+#include <nvmm/heap.h>
+
+#include "common/fam_internal.h"
+#include "metadata/fam_metadata_manager.h"
+
+using namespace std;
+using namespace nvmm;
+using namespace metadata;
+
+namespace openfam {
+
+/*
+ * Size classes served by the slab layer. Classes are powers of two from
+ * SLAB_MIN_CLASS_SIZE up to SLAB_MAX_CLASS_SIZE. Allocations larger than
+ * SLAB_MAX_CLASS_SIZE go directly to the NVMM heap.
+ * SLAB_MIN_CLASS_SIZE must be the same as MIN_OBJ_SIZE, as the dataitem Id
+ * is derived from the offset of the dataitem.
+ */
+#define SLAB_MIN_CLASS_SHIFT 7
+#define SLAB_MIN_CLASS_SIZE (1UL << SLAB_MIN_CLASS_SHIFT)
+#define SLAB_MAX_CLASS_SIZE (64UL * 1024)
+#define SLAB_NUM_CLASSES 10
+
+/*
+ * Each slab holds at most 64 objects, so that the allocation state of a slab
+ * fits in a single word of the slab header. Slabs of large classes are
+ * limited to SLAB_TARGET_SIZE bytes with a minimum of SLAB_MIN_OBJECTS.
+ */
+#define SLAB_MAX_OBJECTS 64
+#define SLAB_MIN_OBJECTS 4
+#define SLAB_TARGET_SIZE (256UL * 1024)
+
+/*
+ * Number of object caches per size class. A thread always uses the cache
+ * selected by its thread id, so that threads serving different clients
+ * rarely contend on the same cache lock.
+ */
+#define SLAB_NUM_CACHES 8
+#define SLAB_REFILL_BATCH 16
+#define SLAB_CACHE_MAX (2 * SLAB_REFILL_BATCH)
+
+#define SLAB_HEADER_MAGIC 0x46414d534c414231UL /* "FAMSLAB1" */
+#define SLAB_DIR_MAGIC 0x46414d534c444952UL    /* "FAMSLDIR" */
+#define SLAB_DIR_SIZE 4096
+#define SLAB_DIR_ENTRIES                                                       \
+    ((SLAB_DIR_SIZE - 3 * sizeof(uint64_t)) / sizeof(uint64_t))
+
+/*
+ * Persistent header at the start of each slab. The header occupies one
+ * SLAB_MIN_CLASS_SIZE block, so objects in the slab keep the alignment
+ * required for the dataitem Id.
+ * allocMap - bit i is set when object i is allocated or held in a cache,
+ *            bits beyond numObjects are always set
+ */
+typedef struct {
+    uint64_t magic;
+    uint32_t sizeClass;
+    uint32_t numObjects;
+    uint64_t objectSize;
+    uint64_t allocMap;
+    uint64_t reserved[12];
+} Slab_Header;
+
+/*
+ * Persistent slab directory of a region. Offset of the first directory block
+ * is recorded under the slab directory key of the region in the metadata
+ * service, further blocks are chained through next. An entry with value 0 is
+ * unused.
+ */
+typedef struct {
+    uint64_t magic;
+    uint64_t next;
+    uint64_t numEntries;
+    uint64_t slabs[SLAB_DIR_ENTRIES];
+} Slab_Directory;
+
+typedef struct {
+    uint64_t offset;
+    Slab_Header *header;
+    uint64_t *dirEntry;
+    uint32_t sizeClass;
+    uint32_t numFree;
+} Slab_Info;
+
+typedef struct {
+    pthread_mutex_t lock;
+    std::vector<uint64_t> objects;
+} Slab_Cache;
+
+using SlabIndex = std::map<uint64_t, Slab_Info *>;
+
+/*
+ * Slab allocator of a region. The free lists, partial slabs and object
+ * caches are kept in the memory of the process, so only one process may
+ * allocate from the slabs of a region. Slabs are therefore used by the
+ * memory server only; allocators sharing heaps between processes allocate
+ * directly from the heap.
+ * A slab with dirOffset 0 serves no allocations, it marks a region without
+ * a slab directory.
+ */
+class Memserver_Slab {
+  public:
+    Memserver_Slab(Heap *heap, uint64_t regionId, uint64_t dirOffset);
+    ~Memserver_Slab();
+
+    static bool is_slab_size(size_t nbytes);
+    static uint64_t object_size(size_t nbytes);
+    static uint64_t create_directory(Heap *heap);
+    static void destroy_directory(Heap *heap, uint64_t dirOffset);
+
+    void recover(FAM_Metadata_Manager *metadataManager);
+    uint64_t alloc(size_t nbytes);
+    bool free(uint64_t offset);
+    void flush();
+
+  private:
+    Heap *heap;
+    uint64_t regionId;
+    uint64_t dirOffset;
+    std::once_flag recoverFlag;
+    SlabIndex *slabIndex;
+    pthread_mutex_t slabIndexLock;
+    pthread_mutex_t classLock[SLAB_NUM_CLASSES];
+    std::vector<Slab_Info *> partialSlabs[SLAB_NUM_CLASSES];
+    Slab_Cache caches[SLAB_NUM_CLASSES][SLAB_NUM_CACHES];
+
+    static uint32_t get_size_class(size_t nbytes);
+    static uint32_t get_num_objects(uint32_t sizeClass);
+    uint32_t get_cache_index();
+    Slab_Info *create_slab(uint32_t sizeClass);
+    void release_slab(Slab_Info *slab);
+    uint64_t *add_directory_entry(uint64_t slabOffset);
+    Slab_Info *find_slab(uint64_t offset);
+    void recover_directory(FAM_Metadata_Manager *metadataManager);
+    void refill_cache(uint32_t sizeClass, Slab_Cache *cache);
+    void drain_cache(uint32_t sizeClass, Slab_Cache *cache, size_t count);
+};
+
+} // namespace openfam
+
+#endif /* end of MEMSERVER_SLAB_H_ */
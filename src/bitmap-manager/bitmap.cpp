@@ -36,6 +36,13 @@ static bool get(uint64_t, uint64_t);
 static void set(uint64_t *, uint64_t);
 static void reset(uint64_t *, uint64_t);
 
+/* search helpers */
+static uint64_t *get_summary(bitmap *);
+static void summary_mark_full(bitmap *, uint64_t);
+static void summary_mark_free(bitmap *, uint64_t);
+static int64_t find_in_words(bitmap *, bool, uint64_t, uint64_t, uint64_t,
+                             bool, bool);
+
 /* Registers the bitmap with fam_atomic and initialize the bitmap to 0*/
 int bitmap_init(bitmap *bmap) {
     uint64_t size = bmap->size;
@@ -50,12 +57,20 @@ int bitmap_init(bitmap *bmap) {
     for (uint64_t i = 0; i < size / sizeof(int64_t); i++) {
         fam_atomic_64_write((int64_t *)bmap->map + i, 0);
     }
+    bmap->hint = 0;
+    if (bmap->summary) {
+        uint64_t words = size / sizeof(uint64_t);
+        for (uint64_t i = 0; i < (words + BITSIZE - 1) / BITSIZE; i++)
+            bmap->summary[i] = 0;
+    }
     return 0;
 }
 
 void bitmap_free(bitmap *bmap) {
 
     fam_atomic_unregister_region(bmap->map, bmap->size);
+    free(bmap->summary);
+    bmap->summary = NULL;
 }
 
 /* Returns the value of the @n'th bit of the bitmap */
@@ -124,6 +139,7 @@ void bitmap_reset(bitmap *bmap, uint64_t n) {
         }
     } while (retry);
 
+    summary_mark_free(bmap, offset);
 }
 
 /* Check the n'th bit value and then sets the n'th bit 
@@ -171,46 +187,161 @@ int bitmap_reserve(bitmap *bmap, bool val, uint64_t n) {
         }
     } while (retry);
 
+    if (val)
+        summary_mark_free(bmap, offset);
+
     return 0;
 }
 
-/* Finds the first free "val" in bitmap after start bit 
+/* Finds a "val" bit in bitmap at or after start bit
  * and set/reset the bit and return the bit.
- * if val was 0, it will be set to 1 and if val is 1, it 
+ * if val was 0, it will be set to 1 and if val is 1, it
  * will be reset to 0 and bit position will be returned.
+ * The search starts at the word where the previous reservation
+ * succeeded and wraps around to start, so the bit returned is not
+ * necessarily the first "val" bit after start.
  */
 uint64_t bitmap_find_and_reserve(bitmap *bmap, bool val, uint64_t start) {
-    uint64_t i;
-    uint64_t size = bmap->size;
-
-    /* size is now the Bitmap size in bits */
-    for (i = start, size *= 8; i < size; i++) {
-        if (bitmap_get(bmap, i) == val) {
-            // If bitmap_reserve() fails to reserve the bit,
-            // try next available bit.
-            if (bitmap_reserve(bmap, val, i) == 0) {
-                return i; 
-            }
-        }
-    }
-
-    return BITMAP_NOTFOUND;
+    uint64_t words = bmap->size / sizeof(uint64_t);
+    uint64_t startWord = start / BITSIZE;
+    int64_t pos;
+
+    if (startWord >= words)
+        return BITMAP_NOTFOUND;
+
+    uint64_t hint = __atomic_load_n(&bmap->hint, __ATOMIC_RELAXED);
+    if ((hint <= startWord) || (hint >= words))
+        hint = startWord;
+
+    // Search from the hint to the end and then wrap around
+    pos = find_in_words(bmap, val, start, hint, words, true, true);
+    if ((pos == BITMAP_NOTFOUND) && (hint > startWord))
+        pos = find_in_words(bmap, val, start, startWord, hint, true, true);
+
+    // The summary may be stale if bits were released by another process
+    // sharing the bitmap, verify with a full scan before failing.
+    if ((pos == BITMAP_NOTFOUND) && !val && get_summary(bmap))
+        pos = find_in_words(bmap, val, start, startWord, words, true, false);
+
+    if (pos != BITMAP_NOTFOUND)
+        __atomic_store_n(&bmap->hint, (uint64_t)pos / BITSIZE,
+                         __ATOMIC_RELAXED);
+    return pos;
 }
 
 /* Finds the first n value in bitmap after start */
 /* size is the Bitmap size in bytes */
 uint64_t bitmap_find(bitmap *bmap, bool n, uint64_t start) {
-    uint64_t i;
-    uint64_t size = bmap->size;
+    uint64_t words = bmap->size / sizeof(uint64_t);
+
+    if (start / BITSIZE >= words)
+        return BITMAP_NOTFOUND;
+    return find_in_words(bmap, n, start, start / BITSIZE, words, false, false);
+}
+
+/* Searches words [first, last) of the bitmap for a "val" bit at or
+ * after start, one word at a time. If reserve is true the bit found is
+ * atomically flipped; a word whose eligible bits are all taken by other
+ * threads is skipped. If useSummary is true, words marked full in the
+ * summary are skipped.
+ */
+static int64_t find_in_words(bitmap *bmap, bool val, uint64_t start,
+                             uint64_t first, uint64_t last, bool reserve,
+                             bool useSummary) {
+    int64_t *map = (int64_t *)bmap->map;
+    uint64_t *summary = (!val && reserve) ? get_summary(bmap) : NULL;
+
+    for (uint64_t word = first; word < last; word++) {
+        if (summary && useSummary) {
+            uint64_t group =
+                __atomic_load_n(&summary[word / BITSIZE], __ATOMIC_RELAXED);
+            // Skip a group of full words at once
+            if ((word % BITSIZE == 0) && (group == ~0UL)) {
+                word += BITSIZE - 1;
+                continue;
+            }
+            if (get(group, word % BITSIZE))
+                continue;
+        }
 
-    /* size is now the Bitmap size in bits */
-    for (i = start, size *= 8; i < size; i++) {
-        if (bitmap_get(bmap, i) == n)
-            return i;
+        // Bits before start are not eligible
+        uint64_t mask = ~0UL;
+        if (word == start / BITSIZE)
+            mask <<= (start % BITSIZE);
+
+        uint64_t value = fam_atomic_64_read(map + word);
+        while (true) {
+            uint64_t candidates = (val ? value : ~value) & mask;
+            if (!candidates) {
+                if (summary && (value == ~0UL))
+                    summary_mark_full(bmap, word);
+                break;
+            }
+            uint64_t pos = (uint64_t)__builtin_ctzll(candidates);
+            if (!reserve)
+                return (int64_t)(word * BITSIZE + pos);
+
+            uint64_t newValue = value;
+            if (val)
+                reset(&newValue, pos);
+            else
+                set(&newValue, pos);
+            uint64_t result =
+                fam_atomic_64_compare_store(map + word, value, newValue);
+            if (result == value) {
+                if (summary && (newValue == ~0UL))
+                    summary_mark_full(bmap, word);
+                if (val)
+                    summary_mark_free(bmap, word);
+                return (int64_t)(word * BITSIZE + pos);
+            }
+            // Lost the race for the word, retry with its new value
+            value = result;
+        }
     }
     return BITMAP_NOTFOUND;
 }
 
+/* Returns the summary of the bitmap, allocating it on first use.
+ * Returns NULL if the bitmap is too small to need a summary.
+ */
+static uint64_t *get_summary(bitmap *bmap) {
+    uint64_t words = bmap->size / sizeof(uint64_t);
+    if (words < BITMAP_SUMMARY_MIN_WORDS)
+        return NULL;
+
+    uint64_t *summary = __atomic_load_n(&bmap->summary, __ATOMIC_ACQUIRE);
+    if (summary)
+        return summary;
+
+    uint64_t *newSummary = (uint64_t *)calloc((words + BITSIZE - 1) / BITSIZE,
+                                              sizeof(uint64_t));
+    if (!newSummary)
+        return NULL;
+    if (!__atomic_compare_exchange_n(&bmap->summary, &summary, newSummary,
+                                     false, __ATOMIC_ACQ_REL,
+                                     __ATOMIC_ACQUIRE)) {
+        // Another thread installed the summary first
+        free(newSummary);
+        return summary;
+    }
+    return newSummary;
+}
+
+static void summary_mark_full(bitmap *bmap, uint64_t word) {
+    uint64_t *summary = __atomic_load_n(&bmap->summary, __ATOMIC_ACQUIRE);
+    if (summary)
+        __atomic_fetch_or(&summary[word / BITSIZE], 1UL << (word % BITSIZE),
+                          __ATOMIC_RELAXED);
+}
+
+static void summary_mark_free(bitmap *bmap, uint64_t word) {
+    uint64_t *summary = __atomic_load_n(&bmap->summary, __ATOMIC_ACQUIRE);
+    if (summary)
+        __atomic_fetch_and(&summary[word / BITSIZE],
+                           ~(1UL << (word % BITSIZE)), __ATOMIC_RELAXED);
+}
+
 /* Returns the value of byte at bit position*/
 static bool get(uint64_t byte, uint64_t bit) { return (byte >> bit) & 1UL; }
 
@@ -41,9 +41,26 @@
 #define BITSIZE (8 * sizeof(uint64_t))
 #define BITMAP_NOTFOUND -1
 
+/*
+ * Bitmaps of at least BITMAP_SUMMARY_MIN_WORDS words keep a summary with
+ * one bit per word of the map, set when the word was found full by
+ * bitmap_find_and_reserve(). Searches skip words marked full.
+ */
+#define BITMAP_SUMMARY_MIN_WORDS 64
+
+/*
+ * map - bitmap words, accessed with fam atomics
+ * size - size of the map in bytes
+ * hint - word at which the next bitmap_find_and_reserve() starts
+ * summary - process local summary of full words, allocated on first use
+ * hint and summary are only search accelerators and must be zero
+ * initialized along with the struct.
+ */
 typedef struct bitmap {
     void *map;
     uint64_t size;
+    uint64_t hint;
+    uint64_t *summary;
 } bitmap;
 
 int bitmap_init(bitmap *bmap);
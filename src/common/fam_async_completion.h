@@ -0,0 +1,126 @@
+/*
+ * fam_async_completion.h
+ * Copyright (c) 2019 Hewlett Packard Enterprise Development, LP. All rights
+ * reserved. Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ *    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * See https://spdx.org/licenses/BSD-3-Clause
+ *
+ */
+#ifndef FAM_ASYNC_COMPLETION_H
+#define FAM_ASYNC_COMPLETION_H
+
+#include <atomic>
+#include <linux/futex.h>
+#include <stdint.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "fam/fam_exception.h"
+
+/*
+ * Number of polls of the completion count before a waiting thread sleeps
+ */
+#define FAM_COMPLETION_SPIN 1024
+
+namespace openfam {
+
+/*
+ * Completion record of the operations a context posts to the NVMM async
+ * engine in one direction. Consumers count completed operations and keep
+ * the first error in a preallocated slot, so that completing an operation
+ * never allocates memory. A waiting thread polls the count briefly and
+ * then sleeps on a futex, which consumers only wake when someone waits.
+ */
+class Fam_Async_Completion {
+  public:
+    Fam_Async_Completion()
+        : numDone(0), wakeSeq(0), numWaiters(0), errState(ERR_NONE),
+          errCode(FAM_NO_ERROR), errMsg(NULL) {}
+
+    void complete() {
+        numDone.fetch_add(1);
+        if (numWaiters.load() > 0) {
+            wakeSeq.fetch_add(1);
+            syscall(SYS_futex, &wakeSeq, FUTEX_WAKE_PRIVATE, INT32_MAX, NULL,
+                    NULL, 0);
+        }
+    }
+
+    /*
+     * Complete an operation that failed. msg must be a string literal;
+     * only the first error before it is taken is kept.
+     */
+    void complete_with_error(enum Fam_Error code, const char *msg) {
+        int state = ERR_NONE;
+        if (errState.compare_exchange_strong(state, ERR_BUSY)) {
+            errCode = code;
+            errMsg = msg;
+            errState.store(ERR_SET, std::memory_order_release);
+        }
+        complete();
+    }
+
+    /* Wait until count operations have completed */
+    void wait(uint64_t count) {
+        for (int i = 0; i < FAM_COMPLETION_SPIN; i++) {
+            if (numDone.load(std::memory_order_acquire) >= count)
+                return;
+        }
+        while (numDone.load() < count) {
+            int seq = wakeSeq.load();
+            numWaiters.fetch_add(1);
+            // A completion after this check changes wakeSeq, so the futex
+            // wait returns immediately rather than missing the wakeup
+            if (numDone.load() < count)
+                syscall(SYS_futex, &wakeSeq, FUTEX_WAIT_PRIVATE, seq, NULL,
+                        NULL, 0);
+            numWaiters.fetch_sub(1);
+        }
+    }
+
+    /* Returns true and clears the error if an operation failed */
+    bool take_error(enum Fam_Error &code, const char *&msg) {
+        if (errState.load(std::memory_order_acquire) != ERR_SET)
+            return false;
+        code = errCode;
+        msg = errMsg;
+        errState.store(ERR_NONE, std::memory_order_release);
+        return true;
+    }
+
+    uint64_t get_num_done() { return numDone.load(); }
+
+  private:
+    enum { ERR_NONE = 0, ERR_BUSY, ERR_SET };
+
+    std::atomic<uint64_t> numDone;
+    std::atomic<int> wakeSeq;
+    std::atomic<uint64_t> numWaiters;
+    std::atomic<int> errState;
+    enum Fam_Error errCode;
+    const char *errMsg;
+};
+
+} // namespace openfam
+#endif
@@ -0,0 +1,94 @@
+/*
+ * fam_async_handle.h
+ * Copyright (c) 2019 Hewlett Packard Enterprise Development, LP. All rights
+ * reserved. Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ *    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * See https://spdx.org/licenses/BSD-3-Clause
+ *
+ */
+#ifndef FAM_ASYNC_HANDLE_H
+#define FAM_ASYNC_HANDLE_H
+
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+
+#include "fam/fam.h"
+
+namespace openfam {
+
+/*
+ * Result of a control operation that completes in the background, such as
+ * an allocation made with fam_allocate_async. It is completed once, by the
+ * thread that sees the operation finish, with either the descriptor the
+ * operation returns or the exception it throws.
+ */
+class Fam_Async_Handle {
+  public:
+    Fam_Async_Handle() : completed(false), result(NULL) {}
+
+    /* Complete with the descriptor of the operation, NULL if it has none */
+    void complete(Fam_Descriptor *descriptor) {
+        std::lock_guard<std::mutex> guard(handleLock);
+        result = descriptor;
+        completed = true;
+        completion.notify_all();
+    }
+
+    /* Complete with the exception thrown by the operation */
+    void fail(std::exception_ptr exception) {
+        std::lock_guard<std::mutex> guard(handleLock);
+        error = exception;
+        completed = true;
+        completion.notify_all();
+    }
+
+    bool is_complete() {
+        std::lock_guard<std::mutex> guard(handleLock);
+        return completed;
+    }
+
+    /*
+     * Wait for the operation to complete. Returns its descriptor, or
+     * rethrows its exception.
+     */
+    Fam_Descriptor *wait() {
+        std::unique_lock<std::mutex> guard(handleLock);
+        while (!completed)
+            completion.wait(guard);
+        if (error)
+            std::rethrow_exception(error);
+        return result;
+    }
+
+  private:
+    std::mutex handleLock;
+    std::condition_variable completion;
+    bool completed;
+    Fam_Descriptor *result;
+    std::exception_ptr error;
+};
+
+} // namespace openfam
+#endif
@@ -28,28 +28,312 @@
  *
  */
 
-#include <boost/lockfree/queue.hpp>
 #include <boost/thread/thread.hpp>
 
 #include <boost/atomic.hpp>
-#include <boost/fiber/condition_variable.hpp>
 
+#include <atomic>
+#include <chrono>
 #include <iostream>
+#include <string.h>
+#include <linux/futex.h>
+#include <map>
+#include <memory>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#if defined(__x86_64__)
+#include <emmintrin.h>
+#endif
 
 #include "common/fam_async_qhandler.h"
+
+/*
+ * Maximum number of producer threads with a private ring at a time. The
+ * ring of an exited thread is reused by the next producer thread; further
+ * producer threads share a single ring guarded by a lock.
+ */
+#define QHANDLER_MAX_RINGS 256
+#define QHANDLER_MASK_WORDS (QHANDLER_MAX_RINGS / 64)
+
+/*
+ * An idle consumer spins for spinLimit polls, adapted between
+ * QHANDLER_MIN_SPIN and QHANDLER_MAX_SPIN, then yields the CPU
+ * QHANDLER_YIELD_COUNT times before parking on a futex.
+ */
+#define QHANDLER_MIN_SPIN 64
+#define QHANDLER_MAX_SPIN 16384
+#define QHANDLER_YIELD_COUNT 16
+
+/*
+ * Reads and writes of at least QHANDLER_CHUNK_THRESHOLD bytes are split into
+ * QHANDLER_CHUNK_SIZE chunks that the consumers execute in parallel. Writes
+ * of at least QHANDLER_NT_THRESHOLD bytes use non-temporal stores.
+ */
+#define QHANDLER_CHUNK_SIZE (256 * 1024)
+#define QHANDLER_CHUNK_THRESHOLD (1024 * 1024)
+#define QHANDLER_NT_THRESHOLD (64 * 1024)
+
+/*
+ * A thread completes at most QHANDLER_FENCE_BATCH writes with one fence,
+ * and holds back the completion of a write for at most
+ * QHANDLER_FENCE_DELAY_NS while it keeps executing other operations
+ */
+#define QHANDLER_FENCE_BATCH 64
+#define QHANDLER_FENCE_DELAY_NS 20000
+
 namespace openfam {
 
+static inline void qhandler_pause() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield" ::: "memory");
+#endif
+}
+
+/*
+ * Copy nbytes from src to dest and start writing dest back; dest is
+ * persistent after the next openfam_persist_fence() of this thread. Large
+ * copies are streamed with non-temporal stores, which bypass the cache and
+ * so need no flush. Only the unaligned head and tail are copied and
+ * flushed normally.
+ */
+static void persistent_copy(void *dest, void *src, uint64_t nbytes) {
+#if defined(__x86_64__)
+    if (nbytes >= QHANDLER_NT_THRESHOLD) {
+        char *to = (char *)dest;
+        const char *from = (const char *)src;
+        uint64_t head = (64 - ((uint64_t)to & 63)) & 63;
+        if (head) {
+            memcpy(to, from, head);
+            openfam_flush(to, head);
+            to += head;
+            from += head;
+            nbytes -= head;
+        }
+        uint64_t body = nbytes & ~(uint64_t)63;
+        for (uint64_t i = 0; i < body; i += 64) {
+            const __m128i *in = (const __m128i *)(from + i);
+            __m128i *out = (__m128i *)(to + i);
+            __m128i v0 = _mm_loadu_si128(in);
+            __m128i v1 = _mm_loadu_si128(in + 1);
+            __m128i v2 = _mm_loadu_si128(in + 2);
+            __m128i v3 = _mm_loadu_si128(in + 3);
+            _mm_stream_si128(out, v0);
+            _mm_stream_si128(out + 1, v1);
+            _mm_stream_si128(out + 2, v2);
+            _mm_stream_si128(out + 3, v3);
+        }
+        if (nbytes > body) {
+            memcpy(to + body, from + body, nbytes - body);
+            openfam_flush(to + body, nbytes - body);
+        }
+        return;
+    }
+#endif
+    memcpy(dest, src, nbytes);
+    openfam_flush(dest, nbytes);
+}
+
+/*
+ * Write nbytes from src to dest. With a persist log the range is recorded
+ * for fam_quiet to write back; otherwise it is written back and persistent
+ * after the next fence.
+ */
+static void write_data(void *dest, void *src, uint64_t nbytes,
+                       Fam_Persist_Log *persistLog) {
+    if (persistLog) {
+        memcpy(dest, src, nbytes);
+        persistLog->add(dest, nbytes);
+    } else {
+        persistent_copy(dest, src, nbytes);
+    }
+}
+
+/*
+ * Writes of each thread whose completion waits for the thread's next
+ * fence, so that a batch of writes is made persistent by a single fence.
+ */
+typedef struct {
+    Fam_Async_Completion *completions[QHANDLER_FENCE_BATCH];
+    uint64_t count;
+    uint64_t firstNs;
+} Pending_Writes;
+
+static thread_local Pending_Writes pendingWrites;
+
+static inline uint64_t qhandler_now_ns() {
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+static void publish_writes() {
+    if (!pendingWrites.count)
+        return;
+    openfam_persist_fence();
+    for (uint64_t i = 0; i < pendingWrites.count; i++)
+        pendingWrites.completions[i]->complete();
+    pendingWrites.count = 0;
+}
+
+static void complete_write(Fam_Async_Completion *completion,
+                           Fam_Persist_Log *persistLog) {
+    // Deferred writes are made persistent by fam_quiet
+    if (persistLog) {
+        completion->complete();
+        return;
+    }
+    if (pendingWrites.count == QHANDLER_FENCE_BATCH)
+        publish_writes();
+    if (!pendingWrites.count)
+        pendingWrites.firstNs = qhandler_now_ns();
+    pendingWrites.completions[pendingWrites.count++] = completion;
+}
+
+/*
+ * Publish the pending writes once the oldest has waited
+ * QHANDLER_FENCE_DELAY_NS, so that a consumer kept busy by reads does not
+ * hold back the completion of a partial batch, which fam_quiet waits for.
+ */
+static void publish_overdue_writes() {
+    if (pendingWrites.count &&
+        (qhandler_now_ns() - pendingWrites.firstNs >= QHANDLER_FENCE_DELAY_NS))
+        publish_writes();
+}
+
+/*
+ * Bounded ring of operations posted by one producer thread. Any consumer
+ * can claim an entry by advancing head. Each slot carries a sequence
+ * number, so that a consumer never reads a slot the producer is still
+ * writing and the producer never overwrites a slot not yet consumed.
+ */
+typedef struct {
+    std::atomic<uint64_t> seq;
+    Fam_Ops_Info opsInfo;
+} Ops_Slot;
+
+class Ops_Ring {
+  public:
+    Ops_Ring(uint64_t depth, bool isShared) {
+        uint64_t size = 2;
+        while (size < depth)
+            size <<= 1;
+        mask = size - 1;
+        slots = new Ops_Slot[size];
+        for (uint64_t i = 0; i < size; i++)
+            slots[i].seq.store(i, std::memory_order_relaxed);
+        head = 0;
+        tail = 0;
+        shared = isShared;
+        owned = true;
+        index = 0;
+        producerLock.clear();
+    }
+
+    ~Ops_Ring() { delete[] slots; }
+
+    /* Returns false if the ring is full */
+    bool push(Fam_Ops_Info &opsInfo) {
+        if (shared)
+            while (producerLock.test_and_set(std::memory_order_acquire))
+                ;
+        uint64_t pos = tail.load(std::memory_order_relaxed);
+        Ops_Slot *slot = &slots[pos & mask];
+        bool pushed = false;
+        if (slot->seq.load(std::memory_order_acquire) == pos) {
+            slot->opsInfo = opsInfo;
+            slot->seq.store(pos + 1, std::memory_order_release);
+            tail.store(pos + 1, std::memory_order_relaxed);
+            pushed = true;
+        }
+        if (shared)
+            producerLock.clear(std::memory_order_release);
+        return pushed;
+    }
+
+    /* Returns false if the ring is empty */
+    bool pop(Fam_Ops_Info &opsInfo) {
+        uint64_t pos = head.load(std::memory_order_relaxed);
+        while (true) {
+            Ops_Slot *slot = &slots[pos & mask];
+            int64_t diff =
+                (int64_t)(slot->seq.load(std::memory_order_acquire) -
+                          (pos + 1));
+            if (diff == 0) {
+                if (head.compare_exchange_weak(pos, pos + 1,
+                                               std::memory_order_relaxed)) {
+                    opsInfo = slot->opsInfo;
+                    slot->seq.store(pos + mask + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = head.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    bool empty() {
+        uint64_t pos = head.load(std::memory_order_relaxed);
+        return (slots[pos & mask].seq.load(std::memory_order_acquire) !=
+                pos + 1);
+    }
+
+  private:
+    // head and tail are kept on separate cache lines
+    std::atomic<uint64_t> head;
+    char headPad[64 - sizeof(std::atomic<uint64_t>)];
+    std::atomic<uint64_t> tail;
+    char tailPad[64 - sizeof(std::atomic<uint64_t>)];
+    std::atomic_flag producerLock;
+    bool shared;
+    Ops_Slot *slots;
+    uint64_t mask;
+
+  public:
+    // Cleared when the producer thread exits, the ring is then drained by
+    // the consumers and handed to the next producer thread
+    std::atomic<bool> owned;
+    // Position of a private ring in the rings of the queue handler
+    uint64_t index;
+};
+
+/*
+ * Private rings of the calling thread, per queue handler instance. The
+ * rings are handed back when the thread exits; holding a reference keeps
+ * a ring valid if its queue handler is deleted first.
+ */
+struct Ops_Ring_Owner {
+    std::map<uint64_t, std::shared_ptr<Ops_Ring>> rings;
+    ~Ops_Ring_Owner() {
+        for (auto ringObj : rings)
+            ringObj.second->owned.store(false, std::memory_order_release);
+    }
+};
+
+static thread_local Ops_Ring_Owner ringOwner;
+
+static std::atomic<uint64_t> qhandlerInstances(0);
+
 class Fam_Async_QHandler::FamAsyncQHandlerImpl_ {
   public:
-    FamAsyncQHandlerImpl_(uint64_t numConsumer) {
-        readCtr = 0;
-        writeCtr = 0;
-        readErrCtr = 0;
-        writeErrCtr = 0;
+    FamAsyncQHandlerImpl_(uint64_t numConsumer, uint64_t queueDepth) {
         run = true;
-        queue = new boost::lockfree::queue<Fam_Ops_Info>(1024);
-        readCQ = new boost::lockfree::queue<Fam_Async_Err *>(1024);
-        writeCQ = new boost::lockfree::queue<Fam_Async_Err *>(1024);
+        instanceId = qhandlerInstances++;
+        depth = queueDepth;
+        numConsumers = numConsumer;
+        consumerIds = 0;
+        numRings = 0;
+        for (uint64_t i = 0; i < QHANDLER_MASK_WORDS; i++)
+            occupied[i] = 0;
+        numParked = 0;
+        wakeSeq = 0;
+        (void)pthread_mutex_init(&ringLock, NULL);
+        sharedRing = new Ops_Ring(depth, true);
         for (uint64_t i = 0; i < numConsumer; i++) {
             consumerThreads.create_thread(boost::bind(
                 &FamAsyncQHandlerImpl_::nonblocking_ops_handler, this));
@@ -58,95 +342,103 @@ class Fam_Async_QHandler::FamAsyncQHandlerImpl_ {
 
     ~FamAsyncQHandlerImpl_() {
         run = false;
+        wakeSeq++;
+        syscall(SYS_futex, &wakeSeq, FUTEX_WAKE_PRIVATE, INT32_MAX, NULL,
+                NULL, 0);
         consumerThreads.join_all();
-        delete queue;
+        delete sharedRing;
+        pthread_mutex_destroy(&ringLock);
     }
 
     void nonblocking_ops_handler(void) {
         Fam_Ops_Info opsInfo;
+        uint64_t self = consumerIds++;
+        uint64_t spinLimit = QHANDLER_MIN_SPIN;
+        uint64_t idle = 0;
 
         while (run) {
-            if (queue->pop(opsInfo))
+            if (next_operation(self, opsInfo)) {
                 decode_and_execute(opsInfo);
+                publish_overdue_writes();
+                // Work arrived while spinning, spin longer next time
+                if (idle && (spinLimit < QHANDLER_MAX_SPIN))
+                    spinLimit <<= 1;
+                idle = 0;
+            } else if (pendingWrites.count) {
+                // Out of work, make the writes done so far persistent
+                publish_writes();
+            } else if (idle < spinLimit) {
+                idle++;
+                qhandler_pause();
+            } else if (idle < spinLimit + QHANDLER_YIELD_COUNT) {
+                idle++;
+                sched_yield();
+            } else {
+                // Spinning did not pay off, spin less next time
+                if (spinLimit > QHANDLER_MIN_SPIN)
+                    spinLimit >>= 1;
+                park();
+                idle = 0;
+            }
         }
+        publish_writes();
     }
 
     void initiate_operation(Fam_Ops_Info opsInfo) {
-        queue->push(opsInfo);
+        // Operations that fail validation are posted whole, so that the
+        // handler reports the error as before
+        if ((opsInfo.opsType != COPY) && (numConsumers > 1) &&
+            (opsInfo.nbytes >= QHANDLER_CHUNK_THRESHOLD) &&
+            is_valid(opsInfo)) {
+            post_chunks(opsInfo);
+            return;
+        }
+        post_operation(opsInfo);
         return;
     }
 
     void quiet(Fam_Context *famCtx) {
 
-        write_quiet(famCtx->get_num_tx_ops());
-        read_quiet(famCtx->get_num_rx_ops());
+        wait_for_completion(famCtx->get_tx_completion(),
+                            famCtx->get_num_tx_ops());
+        wait_for_completion(famCtx->get_rx_completion(),
+                            famCtx->get_num_rx_ops());
 
         return;
     }
 
-    void write_quiet(uint64_t ctr) {
-        {
-            std::unique_lock<boost::fibers::mutex> lk(writeMtx);
-            while (!(ctr == writeCtr.load(boost::memory_order_seq_cst))) {
-                writeCond.wait(lk);
-            }
-        }
-        if (writeErrCtr.load(boost::memory_order_seq_cst) != 0) {
-            writeErrCtr.store(0, boost::memory_order_seq_cst);
-            Fam_Async_Err *err;
-            while (writeCQ->pop(err)) {
-                if (!(err->get_error_code()))
-                    return;
-                else
-                    throw Fam_Datapath_Exception(err->get_error_code(),
-                                                 err->get_error_msg());
-            }
-        }
-    }
+    void wait_for_completion(Fam_Async_Completion *completion, uint64_t ctr) {
+        enum Fam_Error errCode;
+        const char *errMsg;
 
-    void read_quiet(uint64_t ctr) {
-        {
-            std::unique_lock<boost::fibers::mutex> lk(readMtx);
-            while (!(ctr == readCtr.load(boost::memory_order_seq_cst))) {
-                readCond.wait(lk);
-            }
-        }
-        if (readErrCtr.load(boost::memory_order_seq_cst) != 0) {
-            readErrCtr.store(0, boost::memory_order_seq_cst);
-            Fam_Async_Err *err;
-            while (readCQ->pop(err)) {
-                if (!(err->get_error_code()))
-                    return;
-                else
-                    throw Fam_Datapath_Exception(err->get_error_code(),
-                                                 err->get_error_msg());
-            }
-        }
+        completion->wait(ctr);
+        if (completion->take_error(errCode, errMsg))
+            throw Fam_Datapath_Exception(errCode, errMsg);
     }
 
     void wait_for_copy(void *waitObj) {
         Copy_Tag *tag = static_cast<Copy_Tag *>(waitObj);
-        {
-            std::unique_lock<boost::fibers::mutex> lk(copyMtx);
-            while (!tag->copyDone.load(boost::memory_order_seq_cst)) {
-                copyCond.wait(lk);
-            }
-        }
+        tag->copyDone.wait(1);
         return;
     }
 
     void decode_and_execute(Fam_Ops_Info opsInfo) {
+        if (opsInfo.chunk) {
+            chunk_handler(opsInfo);
+            return;
+        }
         switch (opsInfo.opsType) {
         case WRITE: {
             write_handler(opsInfo.src, opsInfo.dest, opsInfo.nbytes,
                           opsInfo.offset, opsInfo.upperBound, opsInfo.key,
-                          opsInfo.itemSize);
+                          opsInfo.itemSize, opsInfo.completion,
+                          opsInfo.persistLog);
             break;
         }
         case READ: {
             read_handler(opsInfo.src, opsInfo.dest, opsInfo.nbytes,
                          opsInfo.offset, opsInfo.upperBound, opsInfo.key,
-                         opsInfo.itemSize);
+                         opsInfo.itemSize, opsInfo.completion);
             break;
         }
         case COPY: {
@@ -163,93 +455,265 @@ class Fam_Async_QHandler::FamAsyncQHandlerImpl_ {
     }
 
     void write_handler(void *src, void *dest, uint64_t nbytes, uint64_t offset,
-                       uint64_t upperBound, uint64_t key, uint64_t itemSize) {
-        bool isError = false;
-        Fam_Async_Err *err = new Fam_Async_Err();
+                       uint64_t upperBound, uint64_t key, uint64_t itemSize,
+                       Fam_Async_Completion *completion,
+                       Fam_Persist_Log *persistLog) {
         if ((offset > itemSize) || (upperBound > itemSize)) {
-            err->set_error_code(FAM_ERR_OUTOFRANGE);
-            err->set_error_msg("offset or data size is out of bound");
-            writeErrCtr++;
-            isError = true;
+            completion->complete_with_error(
+                FAM_ERR_OUTOFRANGE, "offset or data size is out of bound");
         } else if ((key & FAM_WRITE_KEY_SHM) != FAM_WRITE_KEY_SHM) {
-            err->set_error_code(FAM_ERR_NOPERM);
-            err->set_error_msg("not permitted to write into dataitem");
-            writeErrCtr++;
-            isError = true;
+            completion->complete_with_error(
+                FAM_ERR_NOPERM, "not permitted to write into dataitem");
+        } else {
+            write_data(dest, src, nbytes, persistLog);
+            complete_write(completion, persistLog);
         }
+        return;
+    }
 
-        if (isError) {
-            writeCQ->push(err);
+    void read_handler(void *src, void *dest, uint64_t nbytes, uint64_t offset,
+                      uint64_t upperBound, uint64_t key, uint64_t itemSize,
+                      Fam_Async_Completion *completion) {
+        if ((offset > itemSize) || (upperBound > itemSize)) {
+            completion->complete_with_error(
+                FAM_ERR_OUTOFRANGE, "offset or data size is out of bound");
+        } else if ((key & FAM_READ_KEY_SHM) != FAM_READ_KEY_SHM) {
+            completion->complete_with_error(
+                FAM_ERR_NOPERM, "not permitted to read from dataitem");
         } else {
+            openfam_invalidate(src, nbytes);
             memcpy(dest, src, nbytes);
-            openfam_persist(dest, nbytes);
-            delete err;
+            completion->complete();
         }
+        return;
+    }
 
-        {
-            std::unique_lock<boost::fibers::mutex> lk(writeMtx);
-            writeCtr++;
-        }
-        writeCond.notify_one();
+    void copy_handler(void *src, void *dest, uint64_t nbytes, Copy_Tag *tag) {
+        persistent_copy(dest, src, nbytes);
+        openfam_persist_fence();
+        tag->copyDone.complete();
         return;
     }
 
-    void read_handler(void *src, void *dest, uint64_t nbytes, uint64_t offset,
-                      uint64_t upperBound, uint64_t key, uint64_t itemSize) {
-        bool isError = false;
-        Fam_Async_Err *err = new Fam_Async_Err();
-        if ((offset > itemSize) || (upperBound > itemSize)) {
-            err->set_error_code(FAM_ERR_OUTOFRANGE);
-            err->set_error_msg("offset or data size is out of bound");
-            readErrCtr++;
-            isError = true;
-        } else if ((key & FAM_READ_KEY_SHM) != FAM_READ_KEY_SHM) {
-            err->set_error_code(FAM_ERR_NOPERM);
-            err->set_error_msg("not permitted to read from dataitem");
-            readErrCtr++;
-            isError = true;
+  private:
+    void post_operation(Fam_Ops_Info &opsInfo) {
+        // If the ring of this thread is full, execute the operation here
+        // rather than waiting for the consumers
+        Ops_Ring *ring = get_producer_ring();
+        if (!ring->push(opsInfo)) {
+            decode_and_execute(opsInfo);
+            publish_writes();
+            return;
+        }
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (ring != sharedRing)
+            mark_occupied(ring->index);
+        wake_consumer();
+    }
+
+    bool is_valid(Fam_Ops_Info &opsInfo) {
+        uint64_t perm =
+            (opsInfo.opsType == WRITE) ? FAM_WRITE_KEY_SHM : FAM_READ_KEY_SHM;
+        return ((opsInfo.offset <= opsInfo.itemSize) &&
+                (opsInfo.upperBound <= opsInfo.itemSize) &&
+                ((opsInfo.key & perm) == perm));
+    }
+
+    /*
+     * Split a validated read or write into chunks. Each chunk wakes a
+     * consumer, so that idle consumers copy the chunks in parallel.
+     */
+    void post_chunks(Fam_Ops_Info &opsInfo) {
+        uint64_t count =
+            (opsInfo.nbytes + QHANDLER_CHUNK_SIZE - 1) / QHANDLER_CHUNK_SIZE;
+        Chunk_Tag *chunk = new Chunk_Tag();
+        chunk->pendingChunks.store(count, boost::memory_order_relaxed);
+
+        Fam_Ops_Info chunkInfo = opsInfo;
+        chunkInfo.chunk = chunk;
+        for (uint64_t i = 0; i < count; i++) {
+            uint64_t start = i * QHANDLER_CHUNK_SIZE;
+            chunkInfo.src = (void *)((uint64_t)opsInfo.src + start);
+            chunkInfo.dest = (void *)((uint64_t)opsInfo.dest + start);
+            chunkInfo.nbytes = opsInfo.nbytes - start;
+            if (chunkInfo.nbytes > QHANDLER_CHUNK_SIZE)
+                chunkInfo.nbytes = QHANDLER_CHUNK_SIZE;
+            post_operation(chunkInfo);
         }
+    }
 
-        if (isError) {
-            readCQ->push(err);
+    /*
+     * Copy one chunk. The chunk completing last counts the parent
+     * operation, so quiet sees a single completion per read or write.
+     */
+    void chunk_handler(Fam_Ops_Info &opsInfo) {
+        if (opsInfo.opsType == WRITE) {
+            // Each chunk is fenced by the thread that wrote it
+            write_data(opsInfo.dest, opsInfo.src, opsInfo.nbytes,
+                       opsInfo.persistLog);
+            if (!opsInfo.persistLog)
+                openfam_persist_fence();
         } else {
-            openfam_invalidate(src, nbytes);
-            memcpy(dest, src, nbytes);
-            delete err;
+            openfam_invalidate(opsInfo.src, opsInfo.nbytes);
+            memcpy(opsInfo.dest, opsInfo.src, opsInfo.nbytes);
         }
 
-        {
-            std::unique_lock<boost::fibers::mutex> lk(readMtx);
-            readCtr++;
+        if (opsInfo.chunk->pendingChunks.fetch_sub(
+                1, boost::memory_order_acq_rel) != 1)
+            return;
+        delete opsInfo.chunk;
+        opsInfo.completion->complete();
+    }
+
+    /*
+     * A private ring is marked occupied by its producer after each push,
+     * after a fence, and cleared by a consumer which found it empty. The
+     * consumer checks the ring again after clearing, so either it sees an
+     * operation pushed meanwhile or the producer sees the cleared bit.
+     */
+    void mark_occupied(uint64_t index) {
+        uint64_t bit = 1UL << (index % 64);
+        std::atomic<uint64_t> *word = &occupied[index / 64];
+        if (!(word->load(std::memory_order_relaxed) & bit))
+            word->fetch_or(bit);
+    }
+
+    void clear_occupied(uint64_t index) {
+        uint64_t bit = 1UL << (index % 64);
+        occupied[index / 64].fetch_and(~bit);
+        if (!rings[index]->empty())
+            occupied[index / 64].fetch_or(bit);
+    }
+
+    /*
+     * Pop from the occupied private rings, those served by consumer home
+     * if steal is false and those of the other consumers otherwise
+     */
+    bool pop_occupied(uint64_t home, bool steal, Fam_Ops_Info &opsInfo) {
+        for (uint64_t w = 0; w < QHANDLER_MASK_WORDS; w++) {
+            uint64_t bits = occupied[w].load(std::memory_order_acquire);
+            while (bits) {
+                uint64_t i = w * 64 + (uint64_t)__builtin_ctzll(bits);
+                bits &= bits - 1;
+                if ((i % numConsumers == home) == steal)
+                    continue;
+                if (rings[i]->pop(opsInfo))
+                    return true;
+                clear_occupied(i);
+            }
         }
-        readCond.notify_one();
-        return;
+        return false;
     }
 
-    void copy_handler(void *src, void *dest, uint64_t nbytes, Copy_Tag *tag) {
-        memcpy(dest, src, nbytes);
-        openfam_persist(dest, nbytes);
+    /*
+     * Find the next operation for consumer self, first in the rings it
+     * serves and then by stealing from the rings of the other consumers.
+     * Only the rings marked occupied are scanned.
+     */
+    bool next_operation(uint64_t self, Fam_Ops_Info &opsInfo) {
+        uint64_t home = self % numConsumers;
+
+        if (pop_occupied(home, false, opsInfo))
+            return true;
+        if ((home == 0) && sharedRing->pop(opsInfo))
+            return true;
+        if (pop_occupied(home, true, opsInfo))
+            return true;
+        return sharedRing->pop(opsInfo);
+    }
 
-        {
-            std::unique_lock<boost::fibers::mutex> lk(copyMtx);
-            tag->copyDone.store(true, boost::memory_order_seq_cst);
+    bool work_available() {
+        for (uint64_t w = 0; w < QHANDLER_MASK_WORDS; w++) {
+            if (occupied[w].load(std::memory_order_acquire))
+                return true;
         }
-        copyCond.notify_one();
-        return;
+        return !sharedRing->empty();
     }
 
-  private:
-    boost::lockfree::queue<Fam_Ops_Info> *queue;
-    boost::lockfree::queue<Fam_Async_Err *> *readCQ, *writeCQ;
+    /*
+     * Sleep until a producer posts an operation. The wake sequence is read
+     * before checking the rings, so a post after the check changes the
+     * sequence and the futex wait returns immediately.
+     */
+    void park() {
+        int seq = wakeSeq.load();
+        numParked++;
+        if (run && !work_available())
+            syscall(SYS_futex, &wakeSeq, FUTEX_WAIT_PRIVATE, seq, NULL, NULL,
+                    0);
+        numParked--;
+    }
+
+    void wake_consumer() {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (numParked.load(std::memory_order_relaxed) > 0) {
+            wakeSeq++;
+            syscall(SYS_futex, &wakeSeq, FUTEX_WAKE_PRIVATE, 1, NULL, NULL, 0);
+        }
+    }
+
+    /*
+     * Returns the ring of the calling thread. On the first operation
+     * posted by the thread, takes over the ring of an exited thread or
+     * registers a new ring; the shared ring is used once all
+     * QHANDLER_MAX_RINGS rings are owned.
+     */
+    Ops_Ring *get_producer_ring() {
+        static thread_local Ops_Ring *lastRing = NULL;
+        static thread_local uint64_t lastInstance = 0;
+        if (lastRing && (lastInstance == instanceId))
+            return lastRing;
+
+        Ops_Ring *ring = sharedRing;
+        auto ringObj = ringOwner.rings.find(instanceId);
+        if (ringObj != ringOwner.rings.end()) {
+            ring = ringObj->second.get();
+        } else {
+            std::shared_ptr<Ops_Ring> claimed;
+            pthread_mutex_lock(&ringLock);
+            uint64_t count = numRings.load(std::memory_order_relaxed);
+            for (uint64_t i = 0; i < count; i++) {
+                if (!rings[i]->owned.load(std::memory_order_acquire)) {
+                    claimed = rings[i];
+                    claimed->owned.store(true, std::memory_order_relaxed);
+                    break;
+                }
+            }
+            if (!claimed && (count < QHANDLER_MAX_RINGS)) {
+                claimed = std::make_shared<Ops_Ring>(depth, false);
+                claimed->index = count;
+                rings[count] = claimed;
+                numRings.store(count + 1, std::memory_order_release);
+            }
+            pthread_mutex_unlock(&ringLock);
+            if (claimed) {
+                ringOwner.rings.insert({instanceId, claimed});
+                ring = claimed.get();
+            }
+        }
+        lastRing = ring;
+        lastInstance = instanceId;
+        return ring;
+    }
+
+    uint64_t instanceId;
+    uint64_t depth;
+    uint64_t numConsumers;
+    std::atomic<uint64_t> consumerIds;
+    std::shared_ptr<Ops_Ring> rings[QHANDLER_MAX_RINGS];
+    std::atomic<uint64_t> occupied[QHANDLER_MASK_WORDS];
+    Ops_Ring *sharedRing;
+    std::atomic<uint64_t> numRings;
+    pthread_mutex_t ringLock;
+    std::atomic<int> wakeSeq;
+    std::atomic<uint64_t> numParked;
     boost::thread_group consumerThreads;
-    boost::fibers::condition_variable readCond, writeCond, copyCond;
-    boost::fibers::mutex readMtx, writeMtx, copyMtx;
-    boost::atomic_uint64_t readCtr, writeCtr, readErrCtr, writeErrCtr;
     boost::atomic<bool> run;
 };
 
-Fam_Async_QHandler::Fam_Async_QHandler(uint64_t numConsumer) {
-    fAsyncQHandler_ = new FamAsyncQHandlerImpl_(numConsumer);
+Fam_Async_QHandler::Fam_Async_QHandler(uint64_t numConsumer,
+                                       uint64_t queueDepth) {
+    fAsyncQHandler_ = new FamAsyncQHandlerImpl_(numConsumer, queueDepth);
 }
 
 Fam_Async_QHandler::~Fam_Async_QHandler() { delete fAsyncQHandler_; }
@@ -266,12 +730,9 @@ void Fam_Async_QHandler::quiet(Fam_Context *famCtx) {
     fAsyncQHandler_->quiet(famCtx);
 }
 
-void Fam_Async_QHandler::write_quiet(uint64_t ctr) {
-    fAsyncQHandler_->write_quiet(ctr);
-}
-
-void Fam_Async_QHandler::read_quiet(uint64_t ctr) {
-    fAsyncQHandler_->read_quiet(ctr);
+void Fam_Async_QHandler::wait_for_completion(Fam_Async_Completion *completion,
+                                             uint64_t ctr) {
+    fAsyncQHandler_->wait_for_completion(completion, ctr);
 }
 
 void Fam_Async_QHandler::wait_for_copy(void *waitObj) {
@@ -280,20 +741,25 @@ void Fam_Async_QHandler::wait_for_copy(void *waitObj) {
 
 void Fam_Async_QHandler::decode_and_execute(Fam_Ops_Info opsInfo) {
     fAsyncQHandler_->decode_and_execute(opsInfo);
+    publish_writes();
 }
 
 void Fam_Async_QHandler::write_handler(void *src, void *dest, uint64_t nbytes,
                                        uint64_t offset, uint64_t upperBound,
-                                       uint64_t key, uint64_t itemSize) {
+                                       uint64_t key, uint64_t itemSize,
+                                       Fam_Async_Completion *completion,
+                                       Fam_Persist_Log *persistLog) {
     fAsyncQHandler_->write_handler(src, dest, nbytes, offset, upperBound, key,
-                                   itemSize);
+                                   itemSize, completion, persistLog);
+    publish_writes();
 }
 
 void Fam_Async_QHandler::read_handler(void *src, void *dest, uint64_t nbytes,
                                       uint64_t offset, uint64_t upperBound,
-                                      uint64_t key, uint64_t itemSize) {
+                                      uint64_t key, uint64_t itemSize,
+                                      Fam_Async_Completion *completion) {
     fAsyncQHandler_->read_handler(src, dest, nbytes, offset, upperBound, key,
-                                  itemSize);
+                                  itemSize, completion);
 }
 
 void Fam_Async_QHandler::copy_handler(void *src, void *dest, uint64_t nbytes,
@@ -35,8 +35,10 @@
 
 #include <boost/atomic.hpp>
 
+#include "common/fam_async_completion.h"
 #include "common/fam_context.h"
 #include "common/fam_internal.h"
+#include "common/fam_util_persist.h"
 #include "fam/fam.h"
 #include "fam/fam_exception.h"
 
@@ -46,10 +48,24 @@ namespace openfam {
 
 typedef enum { WRITE = 0, READ, COPY } Fam_Ops_Type;
 
+/*
+ * Default number of operations each producer thread can have queued
+ * before it executes further operations itself.
+ */
+#define QHANDLER_DEFAULT_QUEUE_DEPTH 1024
+
 typedef struct {
-    boost::atomic<bool> copyDone;
+    Fam_Async_Completion copyDone;
 } Copy_Tag;
 
+/*
+ * Shared by the chunks of a large read or write; the chunk that brings
+ * pendingChunks to zero completes the parent operation.
+ */
+typedef struct {
+    boost::atomic<uint64_t> pendingChunks;
+} Chunk_Tag;
+
 typedef struct {
     Fam_Ops_Type opsType;
     void *src;
@@ -59,39 +75,32 @@ typedef struct {
     uint64_t upperBound;
     uint64_t key;
     uint64_t itemSize;
+    Fam_Async_Completion *completion;
+    Fam_Persist_Log *persistLog;
     Copy_Tag *tag;
+    Chunk_Tag *chunk;
 } Fam_Ops_Info;
 
-class Fam_Async_Err {
-  public:
-    Fam_Async_Err() : errorCode(FAM_NO_ERROR) {}
-    void set_error_code(enum Fam_Error code) { errorCode = code; }
-    void set_error_msg(const char *msg) { errorMsg = msg; }
-    Fam_Error get_error_code() { return errorCode; }
-    char const *get_error_msg() { return errorMsg.c_str(); }
-
-  private:
-    enum Fam_Error errorCode;
-    string errorMsg;
-};
-
 class Fam_Async_QHandler {
   public:
-    Fam_Async_QHandler(uint64_t numConsumer);
+    Fam_Async_QHandler(uint64_t numConsumer,
+                       uint64_t queueDepth = QHANDLER_DEFAULT_QUEUE_DEPTH);
     ~Fam_Async_QHandler();
 
     void nonblocking_ops_handler();
 
     void initiate_operation(Fam_Ops_Info opsInfo);
     void quiet(Fam_Context *famCtx);
-    void write_quiet(uint64_t ctr);
-    void read_quiet(uint64_t ctr);
+    void wait_for_completion(Fam_Async_Completion *completion, uint64_t ctr);
     void wait_for_copy(void *waitObj);
     void decode_and_execute(Fam_Ops_Info opsInfo);
     void write_handler(void *src, void *dest, uint64_t nbytes, uint64_t offset,
-                       uint64_t upperBound, uint64_t key, uint64_t itemSize);
+                       uint64_t upperBound, uint64_t key, uint64_t itemSize,
+                       Fam_Async_Completion *completion,
+                       Fam_Persist_Log *persistLog);
     void read_handler(void *src, void *dest, uint64_t nbytes, uint64_t offset,
-                      uint64_t upperBound, uint64_t key, uint64_t itemSize);
+                      uint64_t upperBound, uint64_t key, uint64_t itemSize,
+                      Fam_Async_Completion *completion);
     void copy_handler(void *src, void *dest, uint64_t nbytes, Copy_Tag *tag);
 
   private:
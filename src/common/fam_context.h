@@ -37,7 +37,9 @@
 #include <rdma/fi_domain.h>
 #include <rdma/fi_endpoint.h>
 
+#include "common/fam_async_completion.h"
 #include "common/fam_options.h"
+#include "common/fam_util_persist.h"
 
 class Fam_Context {
   public:
@@ -45,6 +47,8 @@ class Fam_Context {
         : numTxOps(0), numRxOps(0), isNVMM(true) {
         numLastRxFailCnt = 0;
         numLastTxFailCnt = 0;
+        txCredits = 0;
+        numPostedOps = numCompletedOps = 0;
         // Initialize ctxRWLock
         famThreadModel = famTM;
         if (famThreadModel == FAM_THREAD_MULTIPLE)
@@ -57,6 +61,9 @@ class Fam_Context {
         isNVMM = false;
         numLastRxFailCnt = 0;
         numLastTxFailCnt = 0;
+        // Operations in flight may not exceed the transmit queue size
+        txCredits = fi->tx_attr->size;
+        numPostedOps = numCompletedOps = 0;
 
         // Initialize ctxRWLock
         famThreadModel = famTM;
@@ -171,6 +178,16 @@ class Fam_Context {
 
     uint64_t get_num_rx_ops() { return numRxOps; }
 
+    openfam::Fam_Async_Completion *get_tx_completion() {
+        return &txCompletion;
+    }
+
+    openfam::Fam_Async_Completion *get_rx_completion() {
+        return &rxCompletion;
+    }
+
+    openfam::Fam_Persist_Log *get_persist_log() { return &persistLog; }
+
     int initialize_cntr(struct fid_domain *domain, struct fid_cntr **cntr) {
         int ret = 0;
         struct fi_cntr_attr cntrAttr;
@@ -215,6 +232,39 @@ class Fam_Context {
         __sync_fetch_and_add(&numLastRxFailCnt, cnt);
     }
 
+    /*
+     * Reserve room on the transmit queue for one more operation. Returns
+     * false if the operations in flight, as of the last completion count
+     * seen, already fill the queue; the caller then progresses completions
+     * and tries again.
+     */
+    bool reserve_credit() {
+        if (txCredits == 0)
+            return true;
+        uint64_t posted = __sync_add_and_fetch(&numPostedOps, 1);
+        if (posted - __atomic_load_n(&numCompletedOps, __ATOMIC_ACQUIRE) <=
+            txCredits)
+            return true;
+        __sync_fetch_and_sub(&numPostedOps, 1);
+        return false;
+    }
+
+    // Return the credit of an operation that could not be posted
+    void release_credit() {
+        if (txCredits != 0)
+            __sync_fetch_and_sub(&numPostedOps, 1);
+    }
+
+    // Record the number of operations the completion counters report done
+    void set_num_completed_ops(uint64_t completed) {
+        uint64_t last = __atomic_load_n(&numCompletedOps, __ATOMIC_RELAXED);
+        while (completed > last &&
+               !__atomic_compare_exchange_n(&numCompletedOps, &last, completed,
+                                            true, __ATOMIC_RELEASE,
+                                            __ATOMIC_RELAXED))
+            ;
+    }
+
   private:
     struct fid_ep *ep;
     struct fid_cq *txcq;
@@ -224,9 +274,16 @@ class Fam_Context {
 
     uint64_t numTxOps;
     uint64_t numRxOps;
+    openfam::Fam_Async_Completion txCompletion;
+    openfam::Fam_Async_Completion rxCompletion;
+    openfam::Fam_Persist_Log persistLog;
     bool isNVMM;
     uint64_t numLastTxFailCnt;
     uint64_t numLastRxFailCnt;
+    /* transmit queue size; 0 if operations are not flow controlled */
+    uint64_t txCredits;
+    uint64_t numPostedOps;
+    uint64_t numCompletedOps;
     Fam_Thread_Model famThreadModel;
     pthread_rwlock_t ctxRWLock;
 };
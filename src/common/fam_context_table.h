@@ -0,0 +1,175 @@
+/*
+ * fam_context_table.h
+ * Copyright (c) 2019 Hewlett Packard Enterprise Development, LP. All rights
+ * reserved. Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ *    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * See https://spdx.org/licenses/BSD-3-Clause
+ *
+ */
+#ifndef FAM_CONTEXT_TABLE_H
+#define FAM_CONTEXT_TABLE_H
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+class Fam_Context;
+
+/*
+ * Initial number of slots of a context table; kept a power of two
+ */
+#define FAM_CONTEXT_TABLE_SIZE 64
+
+namespace openfam {
+
+/*
+ * Region id to context table of the FAM_CONTEXT_REGION model. Lookups are
+ * lock free: the table is open addressed with linear probing, and a slot
+ * publishes its context before its key. Contexts are only removed by
+ * clear() at finalize, so a slot never changes once its key is set.
+ * Inserts must be serialized by the caller; a table more than half full
+ * is copied to one twice its size, and the old one is kept until the
+ * table is destroyed, since lookups may still be reading it.
+ */
+class Fam_Context_Table {
+  public:
+    Fam_Context_Table(uint64_t size = FAM_CONTEXT_TABLE_SIZE) {
+        table.store(new_table(size));
+        numEntries = 0;
+    }
+
+    ~Fam_Context_Table() {
+        for (auto oldTable : retired)
+            delete_table(oldTable);
+        delete_table(table.load());
+    }
+
+    /* Returns the context of the region, or NULL if it has none yet */
+    Fam_Context *find(uint64_t regionId) {
+        Table *cur = table.load(std::memory_order_acquire);
+        for (uint64_t idx = hash(regionId) & cur->mask;;
+             idx = (idx + 1) & cur->mask) {
+            uint64_t key = cur->slots[idx].key.load(std::memory_order_acquire);
+            if (key == regionId)
+                return cur->slots[idx].ctx.load(std::memory_order_relaxed);
+            if (key == EMPTY_KEY)
+                return NULL;
+        }
+    }
+
+    /* Add the context of a region that has none */
+    void insert(uint64_t regionId, Fam_Context *ctx) {
+        Table *cur = table.load(std::memory_order_relaxed);
+        if (2 * (numEntries + 1) > cur->mask + 1) {
+            Table *bigger = new_table(2 * (cur->mask + 1));
+            for (uint64_t idx = 0; idx <= cur->mask; idx++) {
+                uint64_t key = cur->slots[idx].key.load();
+                if (key != EMPTY_KEY)
+                    put(bigger, key, cur->slots[idx].ctx.load());
+            }
+            table.store(bigger, std::memory_order_release);
+            retired.push_back(cur);
+            cur = bigger;
+        }
+        put(cur, regionId, ctx);
+        numEntries++;
+    }
+
+    /*
+     * Call func(regionId, ctx) for every context. Contexts inserted while
+     * the table is walked may be skipped.
+     */
+    template <typename Func> void for_each(Func func) {
+        Table *cur = table.load(std::memory_order_acquire);
+        for (uint64_t idx = 0; idx <= cur->mask; idx++) {
+            uint64_t key = cur->slots[idx].key.load(std::memory_order_acquire);
+            if (key != EMPTY_KEY)
+                func(key, cur->slots[idx].ctx.load(std::memory_order_relaxed));
+        }
+    }
+
+    /* Forget every context; deleting them is up to the caller */
+    void clear() {
+        for (auto oldTable : retired)
+            delete_table(oldTable);
+        retired.clear();
+        Table *cur = table.load();
+        table.store(new_table(cur->mask + 1));
+        delete_table(cur);
+        numEntries = 0;
+    }
+
+  private:
+    static const uint64_t EMPTY_KEY = (uint64_t)-1;
+
+    struct Slot {
+        std::atomic<uint64_t> key;
+        std::atomic<Fam_Context *> ctx;
+    };
+
+    struct Table {
+        uint64_t mask;
+        Slot *slots;
+    };
+
+    static uint64_t hash(uint64_t regionId) {
+        // Region ids of one memory server are dense; spread them
+        uint64_t h = regionId * 0x9E3779B97F4A7C15ULL;
+        return h ^ (h >> 32);
+    }
+
+    static Table *new_table(uint64_t size) {
+        Table *newTable = new Table();
+        newTable->mask = size - 1;
+        newTable->slots = new Slot[size];
+        for (uint64_t idx = 0; idx < size; idx++) {
+            newTable->slots[idx].key.store(EMPTY_KEY,
+                                           std::memory_order_relaxed);
+            newTable->slots[idx].ctx.store(NULL, std::memory_order_relaxed);
+        }
+        return newTable;
+    }
+
+    static void delete_table(Table *oldTable) {
+        delete[] oldTable->slots;
+        delete oldTable;
+    }
+
+    static void put(Table *cur, uint64_t regionId, Fam_Context *ctx) {
+        uint64_t idx = hash(regionId) & cur->mask;
+        while (cur->slots[idx].key.load(std::memory_order_relaxed) !=
+               EMPTY_KEY)
+            idx = (idx + 1) & cur->mask;
+        cur->slots[idx].ctx.store(ctx, std::memory_order_relaxed);
+        cur->slots[idx].key.store(regionId, std::memory_order_release);
+    }
+
+    std::atomic<Table *> table;
+    uint64_t numEntries;
+    std::vector<Table *> retired;
+};
+
+} // namespace openfam
+#endif
@@ -70,6 +70,8 @@
 
 #include <nvmm/fam.h>
 
+#include "fam/fam.h"
+
 #ifdef __cplusplus
 /** C++ Header
  *  The header is defined as a single interface containing all desired methods
@@ -83,11 +85,23 @@ namespace openfam {
 #define FAM_WRITE_KEY_SHM ((uint64_t)0x2)
 #define FAM_RW_KEY_SHM (FAM_READ_KEY_SHM | FAM_WRITE_KEY_SHM)
 
+/*
+ * Bit set in the libfabric keys memory servers generate for data items
+ * the PE may write
+ */
+#define FAM_WRITE_KEY_FABRIC ((uint64_t)0x1)
+
 #define FAM_KEY_UNINITIALIZED ((uint64_t)-1)
 #define FAM_KEY_INVALID ((uint64_t)-2)
 #define FAM_FENCE_KEY ((uint64_t)-4)
 #define INVALID_OFFSET ((uint64_t)-1)
 #define FAM_INVALID_REGION ((uint64_t)-1)
+
+/*
+ * Trailing metadata of an RPC response that carries the time the memory
+ * server spent handling the request, in nanoseconds
+ */
+#define FAM_RPC_SERVER_TIME_KEY "fam-server-time-ns"
 /*
  * Region id 5-15 are reserved for MODC
  * Region id 16-20 are reserved for OpenFAM
@@ -103,8 +117,59 @@ namespace openfam {
 #define DATAITEMID_MASK ((1UL << DATAITEMID_BITS) - 1)
 #define DATAITEMID_SHIFT 1
 
+/*
+ * Fields every datapath operation on a data item reads, kept together in
+ * one cache line. key, size and keyOffset are set as the item is bound to
+ * its access key; fiAddr and context are resolved by the datapath the first
+ * time it sees the item, and bound is set once they are. The local fields
+ * are granted by the memory server along with the key, for access through
+ * its heap from the same host; localGeneration is 0 without a grant.
+ */
+struct alignas(64) Fam_Descriptor_Hot {
+    /* libfabric access key*/
+    uint64_t key;
+    uint64_t size;
+    /* offset of the item within the memory registered with key */
+    uint64_t keyOffset;
+    /* fabric address of the memory server holding the item */
+    uint64_t fiAddr;
+    void *context;
+    /* generation and size of the heap holding the item */
+    uint64_t localGeneration;
+    uint64_t localHeapSize;
+    bool bound;
+    bool localWrite;
+};
+
+/*
+ * The hot fields live in storage reserved inside Fam_Descriptor, so that
+ * the datapath reaches them without going through the descriptor's
+ * implementation object
+ */
+struct Fam_Descriptor_Access {
+    static_assert(sizeof(Fam_Descriptor_Hot) <= sizeof(Fam_Descriptor::hot_),
+                  "hot fields do not fit in Fam_Descriptor");
+    static Fam_Descriptor_Hot *hot(Fam_Descriptor *descriptor) {
+        return reinterpret_cast<Fam_Descriptor_Hot *>(descriptor->hot_);
+    }
+};
+
+inline Fam_Descriptor_Hot *fam_descriptor_hot(Fam_Descriptor *descriptor) {
+    return Fam_Descriptor_Access::hot(descriptor);
+}
+
+/*
+ * openfam_flush starts writing back the cache lines of a range without
+ * waiting for them; openfam_persist_fence waits for the write-backs and
+ * non-temporal stores issued so far by the calling thread. Callers
+ * persisting several ranges flush each and fence once.
+ */
+void openfam_flush(void *addr, uint64_t size);
+void openfam_persist_fence();
+
 inline void openfam_persist(void *addr, uint64_t size) {
-    fam_persist(addr, size);
+    openfam_flush(addr, size);
+    openfam_persist_fence();
 }
 
 inline void openfam_invalidate(void *addr, uint64_t size) {
@@ -31,6 +31,7 @@
 #include "common/fam_libfabric.h"
 #include "common/fam_context.h"
 #include "common/fam_options.h"
+#include "common/fam_trace.h"
 #include "common/fam_internal.h"
 #include "fam/fam.h"
 #include "fam/fam_exception.h"
@@ -524,27 +525,94 @@ int fabric_deregister_mr(fid_mr *&mr) {
     return 0;
 }
 
+/*
+ * Read the completion counters of the context, which also drives progress
+ * for providers that need it, and record how many operations are done
+ */
+static void fabric_progress(Fam_Context *famCtx) {
+    uint64_t txsuccess, txfail, rxsuccess, rxfail;
+    FI_CALL(txsuccess, fi_cntr_read, famCtx->get_txCntr());
+    FI_CALL(txfail, fi_cntr_readerr, famCtx->get_txCntr());
+    FI_CALL(rxsuccess, fi_cntr_read, famCtx->get_rxCntr());
+    FI_CALL(rxfail, fi_cntr_readerr, famCtx->get_rxCntr());
+    famCtx->set_num_completed_ops(txsuccess + txfail + rxsuccess + rxfail);
+}
+
+/*
+ * Take a credit for one operation on the transmit queue of the context. When
+ * the queue is full, progress completions until operations in flight finish
+ * rather than posting into it and getting -FI_EAGAIN back.
+ */
+static void fabric_acquire_credit(Fam_Context *famCtx) {
+    if (famCtx->reserve_credit())
+        return;
+
+    int timeout_retry_cnt = 0;
+    int timeout_wait_retry_cnt = 0;
+
+    LIBFABRIC_PROFILE_START_OPS(fabric_throttle);
+    Fam_Trace::phase(FAM_TRACE_WAIT);
+    do {
+        fabric_progress(famCtx);
+        if (famCtx->reserve_credit())
+            break;
+
+        if (timeout_retry_cnt < TIMEOUT_RETRY) {
+            timeout_retry_cnt++;
+        } else if (timeout_wait_retry_cnt < TIMEOUT_WAIT_RETRY) {
+            timeout_wait_retry_cnt++;
+            usleep(FABRIC_TIMEOUT * 1000);
+        } else {
+            throw Fam_Timeout_Exception("Timeout retry count exceeded INT_MAX");
+        }
+    } while (1);
+    Fam_Trace::phase(FAM_TRACE_SUBMIT);
+    LIBFABRIC_PROFILE_END_OPS(fabric_throttle);
+}
+
+/*
+ * Decide whether to post an operation again after the provider returned ret.
+ * Operations are posted once a credit is taken, so -FI_EAGAIN only means the
+ * provider is short of some other resource: progress completions and retry,
+ * backing off once the retries without waiting are used up. If the operation
+ * cannot be posted its credit is returned and an exception thrown.
+ */
 int fabric_retry(Fam_Context *famCtx, ssize_t ret, uint32_t *retry_cnt) {
 
     if (ret) {
-        if (ret == -FI_EAGAIN) {
-            struct fi_cq_err_entry err;
-            FI_CALL(ret, fi_cq_readerr, famCtx->get_txcq(), &err, 0);
-            if (ret == 1) {
-                const char *errmsg = fi_cq_strerror(
-                    famCtx->get_txcq(), err.prov_errno, err.err_data, NULL, 0);
-                throw Fam_Datapath_Exception(errmsg);
-            } else if (ret && ret != -FI_EAGAIN) {
-                throw Fam_Datapath_Exception("Reading from fabric CQ failed");
-            }
-            (*retry_cnt)++;
-            if ((*retry_cnt) <= MAX_RETRY_CNT) {
-                return 1;
+        try {
+            if (ret == -FI_EAGAIN) {
+                struct fi_cq_err_entry err;
+                FI_CALL(ret, fi_cq_readerr, famCtx->get_txcq(), &err, 0);
+                if (ret == 1) {
+                    const char *errmsg =
+                        fi_cq_strerror(famCtx->get_txcq(), err.prov_errno,
+                                       err.err_data, NULL, 0);
+                    throw Fam_Datapath_Exception(errmsg);
+                } else if (ret && ret != -FI_EAGAIN) {
+                    throw Fam_Datapath_Exception(
+                        "Reading from fabric CQ failed");
+                }
+                Fam_Trace::phase(FAM_TRACE_WAIT);
+                fabric_progress(famCtx);
+                (*retry_cnt)++;
+                if ((*retry_cnt) <= MAX_RETRY_CNT) {
+                    Fam_Trace::phase(FAM_TRACE_SUBMIT);
+                    return 1;
+                } else if ((*retry_cnt) <= MAX_RETRY_CNT + TIMEOUT_WAIT_RETRY) {
+                    usleep(FABRIC_TIMEOUT * 1000);
+                    Fam_Trace::phase(FAM_TRACE_SUBMIT);
+                    return 1;
+                } else {
+                    throw Fam_Timeout_Exception(
+                        "Fabric max retry count exceeded");
+                }
             } else {
-                throw Fam_Datapath_Exception("Fabric max retry count exceeded");
+                throw Fam_Datapath_Exception(fabric_strerror((int)ret));
             }
-        } else {
-            throw Fam_Datapath_Exception(fabric_strerror((int)ret));
+        } catch (...) {
+            famCtx->release_credit();
+            throw;
         }
     }
     return 0;
@@ -552,6 +620,7 @@ int fabric_retry(Fam_Context *famCtx, ssize_t ret, uint32_t *retry_cnt) {
 
 int fabric_completion_wait(Fam_Context *famCtx, fi_context *ctx) {
 
+    Fam_Trace::phase(FAM_TRACE_WAIT);
     ssize_t ret = 0;
     struct fi_cq_data_entry entry;
     int timeout_retry_cnt = 0;
@@ -593,6 +662,7 @@ int fabric_completion_wait(Fam_Context *famCtx, fi_context *ctx) {
 
 int fabric_completion_wait_multictx(Fam_Context *famCtx, fi_context *ctx,
                                     int64_t count) {
+    Fam_Trace::phase(FAM_TRACE_WAIT);
     ssize_t ret = 0;
     struct fi_cq_data_entry entry;
     int timeout_retry_cnt = 0;
@@ -654,6 +724,8 @@ int fabric_completion_wait_multictx(Fam_Context *famCtx, fi_context *ctx,
  */
 int fabric_write(uint64_t key, const void *local, size_t nbytes,
                  uint64_t offset, fi_addr_t fiAddr, Fam_Context *famCtx) {
+    Fam_Trace_Scope traceScope(trace_fabric_write, FAM_TRACE_SUBMIT, key,
+                               offset, nbytes);
 
     struct iovec iov = {.iov_base = (void *)local, .iov_len = nbytes};
 
@@ -677,6 +749,7 @@ int fabric_write(uint64_t key, const void *local, size_t nbytes,
     famCtx->aquire_RDLock();
 
     try {
+        fabric_acquire_credit(famCtx);
         do {
             FI_CALL(ret, fi_writemsg, famCtx->get_ep(), &msg,
                     FI_COMPLETION | FI_DELIVERY_COMPLETE);
@@ -712,6 +785,8 @@ int fabric_write(uint64_t key, const void *local, size_t nbytes,
  */
 int fabric_read(uint64_t key, const void *local, size_t nbytes, uint64_t offset,
                 fi_addr_t fiAddr, Fam_Context *famCtx) {
+    Fam_Trace_Scope traceScope(trace_fabric_read, FAM_TRACE_SUBMIT, key, offset,
+                               nbytes);
 
     struct iovec iov = {.iov_base = (void *)local, .iov_len = nbytes};
 
@@ -735,6 +810,7 @@ int fabric_read(uint64_t key, const void *local, size_t nbytes, uint64_t offset,
     famCtx->aquire_RDLock();
 
     try {
+        fabric_acquire_credit(famCtx);
         do {
             FI_CALL(ret, fi_readmsg, famCtx->get_ep(), &msg, FI_COMPLETION);
         } while (fabric_retry(famCtx, ret, &retry_cnt));
@@ -790,6 +866,7 @@ int fabric_read_write_multi_msg(uint64_t count, size_t iov_limit,
         uint32_t retry_cnt = 0;
 
         try {
+            fabric_acquire_credit(famCtx);
             do {
                 if (write) {
                     FI_CALL(ret, fi_writemsg, famCtx->get_ep(), &msg, flags);
@@ -836,6 +913,8 @@ int fabric_read_write_multi_msg(uint64_t count, size_t iov_limit,
  *  @param local - pointer to the local memory region
  *  @param nbytes - size of each element in bytes to be written to memory region
  *  registered with key
+ *  @param offset - offset of the item within the memory region registered
+ *  with key
  *  @param first - offset of first element in FAM to place for the stride access
  *  @param count - number of elements to be scattered from local memory
  *  @param stride - stride size in element
@@ -844,10 +923,13 @@ int fabric_read_write_multi_msg(uint64_t count, size_t iov_limit,
  *  @return - {true(0), false(1), errNo(<0)}
  */
 int fabric_scatter_stride_blocking(uint64_t key, const void *local,
-                                   size_t nbytes, uint64_t first,
-                                   uint64_t count, uint64_t stride,
-                                   fi_addr_t fiAddr, Fam_Context *famCtx,
-                                   size_t iov_limit) {
+                                   size_t nbytes, uint64_t offset,
+                                   uint64_t first, uint64_t count,
+                                   uint64_t stride, fi_addr_t fiAddr,
+                                   Fam_Context *famCtx, size_t iov_limit) {
+    Fam_Trace_Scope traceScope(trace_fabric_scatter_stride_blocking,
+                               FAM_TRACE_SUBMIT, key, offset + first * nbytes,
+                               count * nbytes);
 
     struct iovec *iov = new iovec[count];
     struct fi_rma_iov *rma_iov = new fi_rma_iov[count];
@@ -858,7 +940,7 @@ int fabric_scatter_stride_blocking(uint64_t key, const void *local,
         iov[i].iov_base = (void *)((uint64_t)local + (i * nbytes));
         iov[i].iov_len = nbytes;
 
-        rma_iov[i].addr = first * nbytes + (i * stride) * nbytes;
+        rma_iov[i].addr = offset + first * nbytes + (i * stride) * nbytes;
         rma_iov[i].len = nbytes;
         rma_iov[i].key = key;
     }
@@ -877,6 +959,8 @@ int fabric_scatter_stride_blocking(uint64_t key, const void *local,
  *  @param local - pointer to the local memory region
  *  @param nbytes - size of each element in bytes to be read from memory region
  *  registered with key
+ *  @param offset - offset of the item within the memory region registered
+ *  with key
  *  @param first - offset of first element in FAM to fetch for the stride access
  *  @param count - number of elements to be gathered to the local memory
  *  @param stride - stride size in element
@@ -888,9 +972,13 @@ int fabric_scatter_stride_blocking(uint64_t key, const void *local,
  */
 
 int fabric_gather_stride_blocking(uint64_t key, const void *local,
-                                  size_t nbytes, uint64_t first, uint64_t count,
+                                  size_t nbytes, uint64_t offset,
+                                  uint64_t first, uint64_t count,
                                   uint64_t stride, fi_addr_t fiAddr,
                                   Fam_Context *famCtx, size_t iov_limit) {
+    Fam_Trace_Scope traceScope(trace_fabric_gather_stride_blocking,
+                               FAM_TRACE_SUBMIT, key, offset + first * nbytes,
+                               count * nbytes);
 
     struct iovec *iov = new iovec[count];
     struct fi_rma_iov *rma_iov = new fi_rma_iov[count];
@@ -901,7 +989,7 @@ int fabric_gather_stride_blocking(uint64_t key, const void *local,
         iov[i].iov_base = (void *)((uint64_t)local + (i * nbytes));
         iov[i].iov_len = nbytes;
 
-        rma_iov[i].addr = first * nbytes + (i * stride) * nbytes;
+        rma_iov[i].addr = offset + first * nbytes + (i * stride) * nbytes;
         rma_iov[i].len = nbytes;
         rma_iov[i].key = key;
     }
@@ -921,6 +1009,8 @@ int fabric_gather_stride_blocking(uint64_t key, const void *local,
  *  @param local - pointer to the local memory region
  *  @param nbytes - size of each element in bytes to be written to memory region
  *  registered with key
+ *  @param offset - offset of the item within the memory region registered
+ *  with key
  *  @param count - number of elements to be scattered from local memory
  *  @param index - An array containing element indexes.
  *  @param fiAddr - fi_addr_t address
@@ -928,9 +1018,12 @@ int fabric_gather_stride_blocking(uint64_t key, const void *local,
  *  @return - {true(0), false(1), errNo(<0)}
  */
 int fabric_scatter_index_blocking(uint64_t key, const void *local,
-                                  size_t nbytes, uint64_t *index,
-                                  uint64_t count, fi_addr_t fiAddr,
-                                  Fam_Context *famCtx, size_t iov_limit) {
+                                  size_t nbytes, uint64_t offset,
+                                  uint64_t *index, uint64_t count,
+                                  fi_addr_t fiAddr, Fam_Context *famCtx,
+                                  size_t iov_limit) {
+    Fam_Trace_Scope traceScope(trace_fabric_scatter_index_blocking,
+                               FAM_TRACE_SUBMIT, key, offset, count * nbytes);
 
     struct iovec *iov = new iovec[count];
     struct fi_rma_iov *rma_iov = new fi_rma_iov[count];
@@ -940,7 +1033,7 @@ int fabric_scatter_index_blocking(uint64_t key, const void *local,
     for (uint64_t i = 0; i < count; i++) {
         iov[i].iov_base = (void *)((uint64_t)local + (i * nbytes));
         iov[i].iov_len = nbytes;
-        rma_iov[i].addr = index[i] * nbytes;
+        rma_iov[i].addr = offset + index[i] * nbytes;
         rma_iov[i].len = nbytes;
         rma_iov[i].key = key;
     }
@@ -960,6 +1053,8 @@ int fabric_scatter_index_blocking(uint64_t key, const void *local,
  *  @param local - pointer to the local memory region
  *  @param nbytes - size of each element in bytes to be read from memory region
  *  registered with key
+ *  @param offset - offset of the item within the memory region registered
+ *  with key
  *  @param count - number of elements to be gathered to the local memory
  *  @param index - An array containing element indexes.
  *  @param fiAddr - fi_addr_t address
@@ -967,9 +1062,11 @@ int fabric_scatter_index_blocking(uint64_t key, const void *local,
  *  @return - {true(0), false(1), errNo(<0)}
  */
 int fabric_gather_index_blocking(uint64_t key, const void *local, size_t nbytes,
-                                 uint64_t *index, uint64_t count,
-                                 fi_addr_t fiAddr, Fam_Context *famCtx,
-                                 size_t iov_limit) {
+                                 uint64_t offset, uint64_t *index,
+                                 uint64_t count, fi_addr_t fiAddr,
+                                 Fam_Context *famCtx, size_t iov_limit) {
+    Fam_Trace_Scope traceScope(trace_fabric_gather_index_blocking,
+                               FAM_TRACE_SUBMIT, key, offset, count * nbytes);
 
     struct iovec *iov = new iovec[count];
     struct fi_rma_iov *rma_iov = new fi_rma_iov[count];
@@ -980,7 +1077,7 @@ int fabric_gather_index_blocking(uint64_t key, const void *local, size_t nbytes,
         iov[i].iov_base = (void *)((uint64_t)local + (i * nbytes));
         iov[i].iov_len = nbytes;
 
-        rma_iov[i].addr = index[i] * nbytes;
+        rma_iov[i].addr = offset + index[i] * nbytes;
         rma_iov[i].len = nbytes;
         rma_iov[i].key = key;
     }
@@ -1008,6 +1105,8 @@ int fabric_gather_index_blocking(uint64_t key, const void *local, size_t nbytes,
 void fabric_write_nonblocking(uint64_t key, const void *local, size_t nbytes,
                               uint64_t offset, fi_addr_t fiAddr,
                               Fam_Context *famCtx) {
+    Fam_Trace_Scope traceScope(trace_fabric_write_nonblocking, FAM_TRACE_SUBMIT,
+                               key, offset, nbytes);
 
     struct iovec iov = {.iov_base = (void *)local, .iov_len = nbytes};
 
@@ -1030,6 +1129,7 @@ void fabric_write_nonblocking(uint64_t key, const void *local, size_t nbytes,
     uint32_t retry_cnt = 0;
 
     try {
+        fabric_acquire_credit(famCtx);
         do {
             FI_CALL(ret, fi_writemsg, famCtx->get_ep(), &msg, 0);
         } while (fabric_retry(famCtx, ret, &retry_cnt));
@@ -1059,6 +1159,8 @@ void fabric_write_nonblocking(uint64_t key, const void *local, size_t nbytes,
 void fabric_read_nonblocking(uint64_t key, const void *local, size_t nbytes,
                              uint64_t offset, fi_addr_t fiAddr,
                              Fam_Context *famCtx) {
+    Fam_Trace_Scope traceScope(trace_fabric_read_nonblocking, FAM_TRACE_SUBMIT,
+                               key, offset, nbytes);
 
     struct iovec iov = {.iov_base = (void *)local, .iov_len = nbytes};
 
@@ -1081,6 +1183,7 @@ void fabric_read_nonblocking(uint64_t key, const void *local, size_t nbytes,
     uint32_t retry_cnt = 0;
 
     try {
+        fabric_acquire_credit(famCtx);
         do {
             FI_CALL(ret, fi_readmsg, famCtx->get_ep(), &msg, 0);
         } while (fabric_retry(famCtx, ret, &retry_cnt));
@@ -1102,6 +1205,8 @@ void fabric_read_nonblocking(uint64_t key, const void *local, size_t nbytes,
  *  @param local - pointer to the local memory region
  *  @param nbytes - size of each element in bytes to be written to memory region
  *  registered with key
+ *  @param offset - offset of the item within the memory region registered
+ *  with key
  *  @param first - offset of first element in FAM to place for the stride access
  *  @param count - number of elements to be scattered from local memory
  *  @param stride - stride size in element
@@ -1110,10 +1215,13 @@ void fabric_read_nonblocking(uint64_t key, const void *local, size_t nbytes,
  *  @return - {true(0), false(1), errNo(<0)}
  */
 void fabric_scatter_stride_nonblocking(uint64_t key, const void *local,
-                                       size_t nbytes, uint64_t first,
-                                       uint64_t count, uint64_t stride,
-                                       fi_addr_t fiAddr, Fam_Context *famCtx,
-                                       size_t iov_limit) {
+                                       size_t nbytes, uint64_t offset,
+                                       uint64_t first, uint64_t count,
+                                       uint64_t stride, fi_addr_t fiAddr,
+                                       Fam_Context *famCtx, size_t iov_limit) {
+    Fam_Trace_Scope traceScope(trace_fabric_scatter_stride_nonblocking,
+                               FAM_TRACE_SUBMIT, key, offset + first * nbytes,
+                               count * nbytes);
 
     struct iovec *iov = new iovec[count];
     struct fi_rma_iov *rma_iov = new fi_rma_iov[count];
@@ -1122,7 +1230,7 @@ void fabric_scatter_stride_nonblocking(uint64_t key, const void *local,
         iov[i].iov_base = (void *)((uint64_t)local + (i * nbytes));
         iov[i].iov_len = nbytes;
 
-        rma_iov[i].addr = first * nbytes + (i * stride) * nbytes;
+        rma_iov[i].addr = offset + first * nbytes + (i * stride) * nbytes;
         rma_iov[i].len = nbytes;
         rma_iov[i].key = key;
     }
@@ -1142,6 +1250,8 @@ void fabric_scatter_stride_nonblocking(uint64_t key, const void *local,
  *  @param local - pointer to the local memory region
  *  @param nbytes - size of each element in bytes to be read from memory region
  *  registered with key
+ *  @param offset - offset of the item within the memory region registered
+ *  with key
  *  @param first - offset of first element in FAM to fetch for the stride access
  *  @param count - number of elements to be gathered to the local memory
  *  @param stride - stride size in element
@@ -1153,10 +1263,13 @@ void fabric_scatter_stride_nonblocking(uint64_t key, const void *local,
  */
 
 void fabric_gather_stride_nonblocking(uint64_t key, const void *local,
-                                      size_t nbytes, uint64_t first,
-                                      uint64_t count, uint64_t stride,
-                                      fi_addr_t fiAddr, Fam_Context *famCtx,
-                                      size_t iov_limit) {
+                                      size_t nbytes, uint64_t offset,
+                                      uint64_t first, uint64_t count,
+                                      uint64_t stride, fi_addr_t fiAddr,
+                                      Fam_Context *famCtx, size_t iov_limit) {
+    Fam_Trace_Scope traceScope(trace_fabric_gather_stride_nonblocking,
+                               FAM_TRACE_SUBMIT, key, offset + first * nbytes,
+                               count * nbytes);
 
     struct iovec *iov = new iovec[count];
     struct fi_rma_iov *rma_iov = new fi_rma_iov[count];
@@ -1165,7 +1278,7 @@ void fabric_gather_stride_nonblocking(uint64_t key, const void *local,
         iov[i].iov_base = (void *)((uint64_t)local + (i * nbytes));
         iov[i].iov_len = nbytes;
 
-        rma_iov[i].addr = first * nbytes + (i * stride) * nbytes;
+        rma_iov[i].addr = offset + first * nbytes + (i * stride) * nbytes;
         rma_iov[i].len = nbytes;
         rma_iov[i].key = key;
     }
@@ -1185,6 +1298,8 @@ void fabric_gather_stride_nonblocking(uint64_t key, const void *local,
  *  @param local - pointer to the local memory region
  *  @param nbytes - size of each element in bytes to be written to memory region
  *  registered with key
+ *  @param offset - offset of the item within the memory region registered
+ *  with key
  *  @param count - number of elements to be scattered from local memory
  *  @param index - An array containing element indexes.
  *  @param fiAddr - fi_addr_t address
@@ -1192,9 +1307,12 @@ void fabric_gather_stride_nonblocking(uint64_t key, const void *local,
  *  @return - {true(0), false(1), errNo(<0)}
  */
 void fabric_scatter_index_nonblocking(uint64_t key, const void *local,
-                                      size_t nbytes, uint64_t *index,
-                                      uint64_t count, fi_addr_t fiAddr,
-                                      Fam_Context *famCtx, size_t iov_limit) {
+                                      size_t nbytes, uint64_t offset,
+                                      uint64_t *index, uint64_t count,
+                                      fi_addr_t fiAddr, Fam_Context *famCtx,
+                                      size_t iov_limit) {
+    Fam_Trace_Scope traceScope(trace_fabric_scatter_index_nonblocking,
+                               FAM_TRACE_SUBMIT, key, offset, count * nbytes);
 
     struct iovec *iov = new iovec[count];
     struct fi_rma_iov *rma_iov = new fi_rma_iov[count];
@@ -1202,7 +1320,7 @@ void fabric_scatter_index_nonblocking(uint64_t key, const void *local,
     for (uint64_t i = 0; i < count; i++) {
         iov[i].iov_base = (void *)((uint64_t)local + (i * nbytes));
         iov[i].iov_len = nbytes;
-        rma_iov[i].addr = index[i] * nbytes;
+        rma_iov[i].addr = offset + index[i] * nbytes;
         rma_iov[i].len = nbytes;
         rma_iov[i].key = key;
     }
@@ -1222,6 +1340,8 @@ void fabric_scatter_index_nonblocking(uint64_t key, const void *local,
  *  @param local - pointer to the local memory region
  *  @param nbytes - size of each element in bytes to be read from memory region
  *  registered with key
+ *  @param offset - offset of the item within the memory region registered
+ *  with key
  *  @param count - number of elements to be gathered to the local memory
  *  @param index - An array containing element indexes.
  *  @param fiAddr - fi_addr_t address
@@ -1229,9 +1349,12 @@ void fabric_scatter_index_nonblocking(uint64_t key, const void *local,
  *  @return - {true(0), false(1), errNo(<0)}
  */
 void fabric_gather_index_nonblocking(uint64_t key, const void *local,
-                                     size_t nbytes, uint64_t *index,
-                                     uint64_t count, fi_addr_t fiAddr,
-                                     Fam_Context *famCtx, size_t iov_limit) {
+                                     size_t nbytes, uint64_t offset,
+                                     uint64_t *index, uint64_t count,
+                                     fi_addr_t fiAddr, Fam_Context *famCtx,
+                                     size_t iov_limit) {
+    Fam_Trace_Scope traceScope(trace_fabric_gather_index_nonblocking,
+                               FAM_TRACE_SUBMIT, key, offset, count * nbytes);
 
     struct iovec *iov = new iovec[count];
     struct fi_rma_iov *rma_iov = new fi_rma_iov[count];
@@ -1240,7 +1363,7 @@ void fabric_gather_index_nonblocking(uint64_t key, const void *local,
         iov[i].iov_base = (void *)((uint64_t)local + (i * nbytes));
         iov[i].iov_len = nbytes;
 
-        rma_iov[i].addr = index[i] * nbytes;
+        rma_iov[i].addr = offset + index[i] * nbytes;
         rma_iov[i].len = nbytes;
         rma_iov[i].key = key;
     }
@@ -1262,6 +1385,7 @@ void fabric_gather_index_nonblocking(uint64_t key, const void *local,
  * @param fiAddr - vector of fi_addr_t
  */
 void fabric_fence(fi_addr_t fiAddr, Fam_Context *famCtx) {
+    Fam_Trace_Scope traceScope(trace_fabric_fence, FAM_TRACE_SUBMIT);
 
     char *local = strdup("FENCE MSG");
     uint64_t nbytes = 10;
@@ -1290,6 +1414,7 @@ void fabric_fence(fi_addr_t fiAddr, Fam_Context *famCtx) {
     uint32_t retry_cnt = 0;
 
     try {
+        fabric_acquire_credit(famCtx);
         do {
             FI_CALL(ret, fi_writemsg, famCtx->get_ep(), &msg, FI_FENCE);
         } while (fabric_retry(famCtx, ret, &retry_cnt));
@@ -1313,6 +1438,7 @@ void fabric_fence(fi_addr_t fiAddr, Fam_Context *famCtx) {
  *
  */
 void fabric_put_quiet(Fam_Context *famCtx) {
+    Fam_Trace_Scope traceScope(trace_fabric_put_quiet, FAM_TRACE_WAIT);
 
     int timeout_retry_cnt = 0;
 
@@ -1366,6 +1492,7 @@ void fabric_put_quiet(Fam_Context *famCtx) {
 }
 
 void fabric_get_quiet(Fam_Context *famCtx) {
+    Fam_Trace_Scope traceScope(trace_fabric_get_quiet, FAM_TRACE_WAIT);
 
     int timeout_retry_cnt = 0;
 
@@ -1419,6 +1546,7 @@ void fabric_get_quiet(Fam_Context *famCtx) {
 }
 
 void fabric_quiet(Fam_Context *famCtx) {
+    Fam_Trace_Scope traceScope(trace_fabric_quiet, FAM_TRACE_WAIT);
 
     // Take Fam_Context Write lock
     famCtx->aquire_WRLock();
@@ -1441,6 +1569,9 @@ void fabric_quiet(Fam_Context *famCtx) {
 void fabric_atomic(uint64_t key, void *value, uint64_t offset, enum fi_op op,
                    enum fi_datatype datatype, fi_addr_t fiAddr,
                    Fam_Context *famCtx) {
+    Fam_Trace_Scope traceScope(trace_fabric_atomic, FAM_TRACE_SUBMIT, key,
+                               offset);
+
     struct fi_ioc iov = {.addr = value, .count = 1};
 
     struct fi_rma_ioc rma_iov = {.addr = offset, .count = 1, .key = key};
@@ -1464,6 +1595,7 @@ void fabric_atomic(uint64_t key, void *value, uint64_t offset, enum fi_op op,
     famCtx->aquire_RDLock();
 
     try {
+        fabric_acquire_credit(famCtx);
         do {
             FI_CALL(ret, fi_atomicmsg, famCtx->get_ep(), &msg, FI_INJECT);
         } while (fabric_retry(famCtx, ret, &retry_cnt));
@@ -1484,6 +1616,9 @@ void fabric_fetch_atomic(uint64_t key, void *value, void *result,
                          uint64_t offset, enum fi_op op,
                          enum fi_datatype datatype, fi_addr_t fiAddr,
                          Fam_Context *famCtx) {
+    Fam_Trace_Scope traceScope(trace_fabric_fetch_atomic, FAM_TRACE_SUBMIT, key,
+                               offset);
+
     struct fi_ioc iov = {.addr = value, .count = 1};
 
     struct fi_rma_ioc rma_iov = {.addr = offset, .count = 1, .key = key};
@@ -1510,6 +1645,7 @@ void fabric_fetch_atomic(uint64_t key, void *value, void *result,
     famCtx->aquire_RDLock();
 
     try {
+        fabric_acquire_credit(famCtx);
         do {
             FI_CALL(ret, fi_fetch_atomicmsg, famCtx->get_ep(), &msg,
                     &result_iov, 0, 1, FI_COMPLETION);
@@ -1535,6 +1671,9 @@ void fabric_compare_atomic(uint64_t key, void *compare, void *result,
                            void *value, uint64_t offset, enum fi_op op,
                            enum fi_datatype datatype, fi_addr_t fiAddr,
                            Fam_Context *famCtx) {
+    Fam_Trace_Scope traceScope(trace_fabric_compare_atomic, FAM_TRACE_SUBMIT,
+                               key, offset);
+
     struct fi_ioc iov = {.addr = value, .count = 1};
 
     struct fi_rma_ioc rma_iov = {.addr = offset, .count = 1, .key = key};
@@ -1563,6 +1702,7 @@ void fabric_compare_atomic(uint64_t key, void *compare, void *result,
     famCtx->aquire_RDLock();
 
     try {
+        fabric_acquire_credit(famCtx);
         do {
             FI_CALL(ret, fi_compare_atomicmsg, famCtx->get_ep(), &msg,
                     &compare_iov, 0, 1, &result_iov, 0, 1, FI_COMPLETION);
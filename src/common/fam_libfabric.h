@@ -84,25 +84,27 @@ int fabric_read(uint64_t key, const void *local, size_t nbytes, uint64_t offset,
                 fi_addr_t fiAddr, Fam_Context *famCtx);
 
 int fabric_scatter_stride_blocking(uint64_t key, const void *local,
-                                   size_t nbytes, uint64_t first,
-                                   uint64_t count, uint64_t stride,
-                                   fi_addr_t fiAddr, Fam_Context *famCtx,
-                                   size_t iov_limit);
+                                   size_t nbytes, uint64_t offset,
+                                   uint64_t first, uint64_t count,
+                                   uint64_t stride, fi_addr_t fiAddr,
+                                   Fam_Context *famCtx, size_t iov_limit);
 
 int fabric_gather_stride_blocking(uint64_t key, const void *local,
-                                  size_t nbytes, uint64_t first, uint64_t count,
+                                  size_t nbytes, uint64_t offset,
+                                  uint64_t first, uint64_t count,
                                   uint64_t stride, fi_addr_t fiAddr,
                                   Fam_Context *famCtx, size_t iov_limit);
 
 int fabric_scatter_index_blocking(uint64_t key, const void *local,
-                                  size_t nbytes, uint64_t *index,
-                                  uint64_t count, fi_addr_t fiAddr,
-                                  Fam_Context *famCtx, size_t iov_limit);
+                                  size_t nbytes, uint64_t offset,
+                                  uint64_t *index, uint64_t count,
+                                  fi_addr_t fiAddr, Fam_Context *famCtx,
+                                  size_t iov_limit);
 
 int fabric_gather_index_blocking(uint64_t key, const void *local, size_t nbytes,
-                                 uint64_t *index, uint64_t count,
-                                 fi_addr_t fiAddr, Fam_Context *famCtx,
-                                 size_t iov_limit);
+                                 uint64_t offset, uint64_t *index,
+                                 uint64_t count, fi_addr_t fiAddr,
+                                 Fam_Context *famCtx, size_t iov_limit);
 void fabric_write_nonblocking(uint64_t key, const void *local, size_t nbytes,
                               uint64_t offset, fi_addr_t fiAddr,
                               Fam_Context *famCtx);
@@ -112,26 +114,28 @@ void fabric_read_nonblocking(uint64_t key, const void *local, size_t nbytes,
                              Fam_Context *famCtx);
 
 void fabric_scatter_stride_nonblocking(uint64_t key, const void *local,
-                                       size_t nbytes, uint64_t first,
-                                       uint64_t count, uint64_t stride,
-                                       fi_addr_t fiAddr, Fam_Context *famCtx,
-                                       size_t iov_limit);
+                                       size_t nbytes, uint64_t offset,
+                                       uint64_t first, uint64_t count,
+                                       uint64_t stride, fi_addr_t fiAddr,
+                                       Fam_Context *famCtx, size_t iov_limit);
 
 void fabric_gather_stride_nonblocking(uint64_t key, const void *local,
-                                      size_t nbytes, uint64_t first,
-                                      uint64_t count, uint64_t stride,
-                                      fi_addr_t fiAddr, Fam_Context *famCtx,
-                                      size_t iov_limit);
+                                      size_t nbytes, uint64_t offset,
+                                      uint64_t first, uint64_t count,
+                                      uint64_t stride, fi_addr_t fiAddr,
+                                      Fam_Context *famCtx, size_t iov_limit);
 
 void fabric_scatter_index_nonblocking(uint64_t key, const void *local,
-                                      size_t nbytes, uint64_t *index,
-                                      uint64_t count, fi_addr_t fiAddr,
-                                      Fam_Context *famCtx, size_t iov_limit);
+                                      size_t nbytes, uint64_t offset,
+                                      uint64_t *index, uint64_t count,
+                                      fi_addr_t fiAddr, Fam_Context *famCtx,
+                                      size_t iov_limit);
 
 void fabric_gather_index_nonblocking(uint64_t key, const void *local,
-                                     size_t nbytes, uint64_t *index,
-                                     uint64_t count, fi_addr_t fiAddr,
-                                     Fam_Context *famCtx, size_t iov_limit);
+                                     size_t nbytes, uint64_t offset,
+                                     uint64_t *index, uint64_t count,
+                                     fi_addr_t fiAddr, Fam_Context *famCtx,
+                                     size_t iov_limit);
 
 void fabric_fence(fi_addr_t fiAddr, Fam_Context *context);
 
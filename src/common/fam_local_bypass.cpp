@@ -0,0 +1,168 @@
+/*
+ * fam_local_bypass.cpp
+ * Copyright (c) 2019 Hewlett Packard Enterprise Development, LP. All rights
+ * reserved. Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ *    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * See https://spdx.org/licenses/BSD-3-Clause
+ *
+ */
+#include <fstream>
+#include <unistd.h>
+
+#include <nvmm/error_code.h>
+
+#include "common/fam_internal.h"
+#include "common/fam_local_bypass.h"
+
+using namespace nvmm;
+
+namespace openfam {
+
+std::string fam_host_id() {
+    std::string bootId;
+    std::ifstream bootIdFile("/proc/sys/kernel/random/boot_id");
+    std::getline(bootIdFile, bootId);
+
+    char hostName[256];
+    if (gethostname(hostName, sizeof(hostName)) != 0)
+        hostName[0] = '\0';
+    hostName[sizeof(hostName) - 1] = '\0';
+
+    // Without a boot id the host can not be told apart from a namesake
+    if (bootId.empty())
+        return std::string();
+    return bootId + "/" + hostName;
+}
+
+Fam_Local_Bypass::Fam_Local_Bypass(uint64_t memoryServerId) {
+    memServerId = memoryServerId;
+    StartNVMM();
+    memoryManager = MemoryManager::GetInstance();
+    (void)pthread_rwlock_init(&heapLock, NULL);
+}
+
+Fam_Local_Bypass::~Fam_Local_Bypass() {
+    for (auto heapObj : heaps)
+        retire_heap(heapObj.second.heap);
+    heaps.clear();
+    for (auto heap : retiredHeaps) {
+        if (heap->IsOpen())
+            heap->Close();
+        delete heap;
+    }
+    retiredHeaps.clear();
+    (void)pthread_rwlock_destroy(&heapLock);
+}
+
+char *Fam_Local_Bypass::get_local_base(Fam_Descriptor *descriptor) {
+    Fam_Descriptor_Hot *hot = fam_descriptor_hot(descriptor);
+    if ((hot->localGeneration == 0) ||
+        (descriptor->get_memserver_id() != memServerId))
+        return NULL;
+
+    Fam_Global_Descriptor global = descriptor->get_global_descriptor();
+    uint64_t regionId = global.regionId & REGIONID_MASK;
+    uint64_t end = global.offset + hot->size;
+    if ((end < global.offset) || (end > hot->localHeapSize))
+        return NULL;
+
+    Heap *heap = NULL;
+    bool reopen = true;
+
+    (void)pthread_rwlock_rdlock(&heapLock);
+    auto heapObj = heaps.find(regionId);
+    if (heapObj != heaps.end()) {
+        Local_Heap &local = heapObj->second;
+        if (hot->localGeneration < local.generation) {
+            // The item belongs to a heap destroyed since; libfabric reports
+            // the error
+            reopen = false;
+        } else if ((hot->localGeneration == local.generation) &&
+                   ((end <= local.heapSize) || (local.heap == NULL))) {
+            heap = local.heap;
+            reopen = false;
+        }
+    }
+    (void)pthread_rwlock_unlock(&heapLock);
+
+    if (reopen)
+        heap = open_heap(regionId, hot->localGeneration, hot->localHeapSize);
+    if (heap == NULL)
+        return NULL;
+    return (char *)heap->OffsetToLocal(global.offset);
+}
+
+/*
+ * Open the heap of a region again for a newer generation or a larger size
+ * than the one open here. Opening after the memory server granted access
+ * maps at least heapSize bytes, since heaps do not shrink.
+ */
+Heap *Fam_Local_Bypass::open_heap(uint64_t regionId, uint64_t generation,
+                                  uint64_t heapSize) {
+    Heap *heap = NULL;
+    (void)pthread_rwlock_wrlock(&heapLock);
+    auto heapObj = heaps.find(regionId);
+    if (heapObj != heaps.end()) {
+        Local_Heap &local = heapObj->second;
+        if ((generation < local.generation) ||
+            ((generation == local.generation) &&
+             ((heapSize <= local.heapSize) || (local.heap == NULL)))) {
+            // Another thread got here first
+            heap = (generation == local.generation) ? local.heap : NULL;
+            (void)pthread_rwlock_unlock(&heapLock);
+            return heap;
+        }
+        retire_heap(local.heap);
+        heaps.erase(heapObj);
+    }
+
+    if (memoryManager->FindHeap((PoolId)regionId, &heap) == NO_ERROR) {
+        if (heap->Open() != NO_ERROR) {
+            delete heap;
+            heap = NULL;
+        }
+    } else {
+        heap = NULL;
+    }
+    heaps.insert({regionId, {heap, generation, heapSize}});
+    (void)pthread_rwlock_unlock(&heapLock);
+    return heap;
+}
+
+void Fam_Local_Bypass::retire_heap(Heap *heap) {
+    if (heap != NULL)
+        retiredHeaps.push_back(heap);
+}
+
+void Fam_Local_Bypass::forget_region(uint64_t regionId) {
+    (void)pthread_rwlock_wrlock(&heapLock);
+    auto heapObj = heaps.find(regionId & REGIONID_MASK);
+    if (heapObj != heaps.end()) {
+        retire_heap(heapObj->second.heap);
+        heaps.erase(heapObj);
+    }
+    (void)pthread_rwlock_unlock(&heapLock);
+}
+
+} // namespace openfam
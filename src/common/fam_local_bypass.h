@@ -0,0 +1,107 @@
+/*
+ * fam_local_bypass.h
+ * Copyright (c) 2019 Hewlett Packard Enterprise Development, LP. All rights
+ * reserved. Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ *    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * See https://spdx.org/licenses/BSD-3-Clause
+ *
+ */
+#ifndef FAM_LOCAL_BYPASS_H
+#define FAM_LOCAL_BYPASS_H
+
+#include <map>
+#include <pthread.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include <nvmm/heap.h>
+#include <nvmm/memory_manager.h>
+
+#include "fam/fam.h"
+
+namespace openfam {
+
+/*
+ * Identity of the host the calling process runs on. A client and a memory
+ * server with the same identity share the host, and with it the NVMM
+ * shelves that back the server's regions.
+ */
+std::string fam_host_id();
+
+/*
+ * Direct load/store access to the regions of a memory server running on
+ * the same host as the PE. The heaps of the server's regions are opened
+ * from the client process, so datapath operations on their data items
+ * are plain memory copies instead of loopback RDMA. Control operations
+ * still go to the memory server.
+ *
+ * Only data items the memory server granted direct access to are served,
+ * see Fam_Descriptor_Hot. The grant names the generation of the heap, so
+ * that a heap opened here for a region destroyed since, possibly by
+ * another PE, is not used for a new region with the same id, and its
+ * size, so that items in space added after the heap was opened here are
+ * not accessed through a stale mapping; both cases open the heap again.
+ * A heap which can not be opened from this process is remembered, and
+ * the items of that generation stay on libfabric.
+ */
+class Fam_Local_Bypass {
+  public:
+    Fam_Local_Bypass(uint64_t memoryServerId);
+
+    ~Fam_Local_Bypass();
+
+    /*
+     * Returns the local address of the data item, or NULL if the data item
+     * is on another memory server or has to be accessed over libfabric
+     */
+    char *get_local_base(Fam_Descriptor *descriptor);
+
+    /* Stop using the heap of a region, e.g. when the region is destroyed */
+    void forget_region(uint64_t regionId);
+
+  private:
+    typedef struct {
+        // NULL if the heap can not be opened locally
+        nvmm::Heap *heap;
+        uint64_t generation;
+        // Size of the heap when it was opened here
+        uint64_t heapSize;
+    } Local_Heap;
+
+    uint64_t memServerId;
+    nvmm::MemoryManager *memoryManager;
+    pthread_rwlock_t heapLock;
+    std::map<uint64_t, Local_Heap> heaps;
+    // Heaps replaced or forgotten; other threads may still be copying
+    // through them, so they are only closed with the bypass
+    std::vector<nvmm::Heap *> retiredHeaps;
+
+    nvmm::Heap *open_heap(uint64_t regionId, uint64_t generation,
+                          uint64_t heapSize);
+    void retire_heap(nvmm::Heap *heap);
+};
+
+} // namespace openfam
+#endif
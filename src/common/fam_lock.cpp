@@ -0,0 +1,396 @@
+/*
+ * fam_lock.cpp
+ * Copyright (c) 2019 Hewlett Packard Enterprise Development, LP. All rights
+ * reserved. Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ *    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * See https://spdx.org/licenses/BSD-3-Clause
+ *
+ */
+#include <sched.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <vector>
+
+#include "common/fam_lock.h"
+#include "common/fam_shared_item.h"
+#include "fam/fam_exception.h"
+
+/* Marks a data item initialized as a lock */
+#define FAM_LOCK_MAGIC 0x46414c4f434b3031ULL
+
+/* Queue nodes are a cache line of the memory server apart */
+#define FAM_LOCK_NODE_SIZE 64
+
+namespace openfam {
+
+Fam_Lock::Fam_Lock(Fam_Ops *ops, Fam_Descriptor *item)
+    : famOps(ops), item(item), type(FAM_LOCK_MUTEX), numNodes(0), myNode(0),
+      held(HELD_NONE) {}
+
+uint64_t Fam_Lock::item_size(uint64_t maxHolders) {
+    return (maxHolders + 1) * FAM_LOCK_NODE_SIZE;
+}
+
+uint64_t Fam_Lock::header(int word) {
+    return (uint64_t)word * sizeof(uint64_t);
+}
+
+uint64_t Fam_Lock::node(uint64_t id, int word) {
+    return id * FAM_LOCK_NODE_SIZE + (uint64_t)word * sizeof(uint64_t);
+}
+
+uint64_t Fam_Lock::fetch(uint64_t offset) {
+    return famOps->atomic_fetch_uint64(item, offset);
+}
+
+/*
+ * Stores are swaps rather than atomic sets, so that they have completed,
+ * and are seen by the other holders, when the next operation is issued
+ */
+void Fam_Lock::store(uint64_t offset, uint64_t value) {
+    famOps->swap(item, offset, value);
+}
+
+/* Hand the lock over to the holder of queue node id */
+void Fam_Lock::unblock(uint64_t id) {
+    famOps->atomic_fetch_and(item, node(id, NODE_STATE),
+                             ~(uint64_t)STATE_BLOCKED);
+}
+
+/* Prepare the queue node of this handle before it is put in the queue */
+void Fam_Lock::reset_node(uint64_t nodeClass) {
+    uint64_t words[NODE_WORDS - NODE_NEXT] = {0, STATE_BLOCKED, nodeClass};
+    famOps->put_blocking(words, item, node(myNode, NODE_NEXT), sizeof(words));
+}
+
+/*
+ * Polls the state of the queue node of this handle until the predecessor
+ * hands the lock over
+ */
+void Fam_Lock::wait_unblocked() {
+    Fam_Poll_Backoff backoff;
+    while (fetch(node(myNode, NODE_STATE)) & STATE_BLOCKED)
+        backoff.pause();
+}
+
+/*
+ * Polls the queue node of this handle until the successor, which has
+ * already swapped itself into the tail, links itself behind it
+ */
+uint64_t Fam_Lock::wait_next() {
+    uint64_t next;
+    while ((next = fetch(node(myNode, NODE_NEXT))) == 0)
+        sched_yield();
+    return next;
+}
+
+void Fam_Lock::check_acquire(bool shared) {
+    if (myNode == 0) {
+        throw Fam_InvalidOption_Exception("Lock is not open");
+    }
+    if (held != HELD_NONE) {
+        throw Fam_InvalidOption_Exception(
+            "Lock is already held through this handle");
+    }
+    if (shared && (type != FAM_LOCK_RW)) {
+        throw Fam_InvalidOption_Exception(
+            "Only reader-writer locks can be locked for reading");
+    }
+}
+
+void Fam_Lock::create(Fam_Lock_Type lockType, uint64_t maxHolders) {
+    std::vector<char> zeros(item_size(maxHolders), 0);
+    famOps->put_blocking(zeros.data(), item, 0, zeros.size());
+
+    uint64_t words[HEADER_WORDS] = {FAM_LOCK_MAGIC, (uint64_t)lockType,
+                                    maxHolders, 0, 0, 0};
+    fam_publish_header(famOps, item, words, HEADER_WORDS);
+    open();
+}
+
+void Fam_Lock::open() {
+    uint64_t words[HEADER_WORDS];
+    famOps->get_blocking(words, item, 0, sizeof(words));
+    if ((words[HEADER_MAGIC] != FAM_LOCK_MAGIC) ||
+        (words[HEADER_TYPE] > (uint64_t)FAM_LOCK_RW) ||
+        (words[HEADER_NUM_NODES] == 0) ||
+        (item_size(words[HEADER_NUM_NODES]) > item->get_size())) {
+        throw Fam_InvalidOption_Exception("Data item is not a lock");
+    }
+    type = (Fam_Lock_Type)words[HEADER_TYPE];
+    numNodes = words[HEADER_NUM_NODES];
+
+    // Start looking for a free node at a different place in every process
+    uint64_t start = (uint64_t)getpid() + (uint64_t)(uintptr_t)this / 64;
+    for (uint64_t i = 0; i < numNodes; i++) {
+        uint64_t id = (start + i) % numNodes + 1;
+        if (famOps->compare_swap(item, node(id, NODE_OWNER), (uint64_t)0,
+                                 (uint64_t)1) == 0) {
+            myNode = id;
+            return;
+        }
+    }
+    throw Fam_Allocator_Exception(FAM_ERR_RESOURCE,
+                                  "All queue nodes of the lock are in use");
+}
+
+void Fam_Lock::close() {
+    if (held != HELD_NONE) {
+        throw Fam_InvalidOption_Exception("Lock is held through this handle");
+    }
+    if (myNode != 0)
+        store(node(myNode, NODE_OWNER), 0);
+    myNode = 0;
+}
+
+void Fam_Lock::lock() {
+    check_acquire(false);
+    reset_node(CLASS_WRITER);
+    uint64_t pred = famOps->swap(item, header(HEADER_TAIL), myNode);
+    if (type == FAM_LOCK_MUTEX) {
+        if (pred != 0) {
+            store(node(pred, NODE_NEXT), myNode);
+            wait_unblocked();
+        }
+    } else if (pred == 0) {
+        // Readers that left the queue may still hold the lock
+        store(header(HEADER_NEXT_WRITER), myNode);
+        if ((fetch(header(HEADER_READERS)) != 0) ||
+            (famOps->swap(item, header(HEADER_NEXT_WRITER), (uint64_t)0) !=
+             myNode))
+            wait_unblocked();
+    } else {
+        famOps->atomic_fetch_or(item, node(pred, NODE_STATE),
+                                (uint64_t)STATE_WRITER_NEXT);
+        store(node(pred, NODE_NEXT), myNode);
+        wait_unblocked();
+    }
+    held = HELD_EXCLUSIVE;
+}
+
+bool Fam_Lock::try_lock() {
+    check_acquire(false);
+    if (type == FAM_LOCK_RW)
+        return try_write_lock();
+
+    // Skip the node reset while the lock is visibly held
+    if (fetch(header(HEADER_TAIL)) != 0)
+        return false;
+    reset_node(CLASS_WRITER);
+    if (famOps->compare_swap(item, header(HEADER_TAIL), (uint64_t)0,
+                             myNode) != 0)
+        return false;
+    held = HELD_EXCLUSIVE;
+    return true;
+}
+
+/*
+ * Readers that have left the queue may still hold a lock whose queue is
+ * empty. A writer that finds them has to back out of the queue, unless a
+ * holder queued behind it in the meantime; it then waits like lock().
+ */
+bool Fam_Lock::try_write_lock() {
+    if ((fetch(header(HEADER_TAIL)) != 0) ||
+        (fetch(header(HEADER_READERS)) != 0))
+        return false;
+    reset_node(CLASS_WRITER);
+    if (famOps->compare_swap(item, header(HEADER_TAIL), (uint64_t)0,
+                             myNode) != 0)
+        return false;
+
+    store(header(HEADER_NEXT_WRITER), myNode);
+    if ((fetch(header(HEADER_READERS)) == 0) &&
+        (famOps->swap(item, header(HEADER_NEXT_WRITER), (uint64_t)0) ==
+         myNode)) {
+        held = HELD_EXCLUSIVE;
+        return true;
+    }
+    if (famOps->swap(item, header(HEADER_NEXT_WRITER), (uint64_t)0) ==
+        myNode) {
+        if (famOps->compare_swap(item, header(HEADER_TAIL), myNode,
+                                 (uint64_t)0) == myNode)
+            return false;
+        // A successor waits for this handle to be given the lock
+        store(header(HEADER_NEXT_WRITER), myNode);
+        if ((fetch(header(HEADER_READERS)) == 0) &&
+            (famOps->swap(item, header(HEADER_NEXT_WRITER), (uint64_t)0) ==
+             myNode))
+            unblock(myNode);
+    }
+    // Otherwise the last reader has taken the writer to hand it the lock
+    wait_unblocked();
+    held = HELD_EXCLUSIVE;
+    return true;
+}
+
+/*
+ * Retries a try variant, pausing twice as long after every failure up to
+ * FAM_LOCK_MAX_BACKOFF_USEC, until it succeeds or the timeout expires
+ */
+bool Fam_Lock::retry_until(bool shared, uint64_t timeoutUsec) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    uint64_t start =
+        (uint64_t)now.tv_sec * 1000000 + (uint64_t)now.tv_nsec / 1000;
+    uint64_t pause = 1;
+    while (!(shared ? try_read_lock() : try_lock())) {
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        uint64_t elapsed =
+            (uint64_t)now.tv_sec * 1000000 + (uint64_t)now.tv_nsec / 1000 -
+            start;
+        if (elapsed >= timeoutUsec)
+            return false;
+        uint64_t left = timeoutUsec - elapsed;
+        usleep((useconds_t)(pause < left ? pause : left));
+        if (pause < FAM_LOCK_MAX_BACKOFF_USEC)
+            pause *= 2;
+    }
+    return true;
+}
+
+bool Fam_Lock::timed_lock(uint64_t timeoutUsec) {
+    return retry_until(false, timeoutUsec);
+}
+
+void Fam_Lock::read_lock() {
+    check_acquire(true);
+    reset_node(CLASS_READER);
+    uint64_t pred = famOps->swap(item, header(HEADER_TAIL), myNode);
+    if (pred == 0) {
+        famOps->atomic_fetch_add(item, header(HEADER_READERS), (uint64_t)1);
+        read_acquired(famOps->atomic_fetch_and(item, node(myNode, NODE_STATE),
+                                               ~(uint64_t)STATE_BLOCKED));
+        return;
+    }
+
+    // A writer or a waiting reader ahead lets this reader in
+    if ((fetch(node(pred, NODE_CLASS)) == CLASS_WRITER) ||
+        (famOps->compare_swap(item, node(pred, NODE_STATE),
+                              (uint64_t)STATE_BLOCKED,
+                              (uint64_t)(STATE_BLOCKED | STATE_READER_NEXT)) ==
+         STATE_BLOCKED)) {
+        store(node(pred, NODE_NEXT), myNode);
+        wait_unblocked();
+        read_acquired(fetch(node(myNode, NODE_STATE)));
+        return;
+    }
+
+    // The reader ahead holds the lock already
+    famOps->atomic_fetch_add(item, header(HEADER_READERS), (uint64_t)1);
+    store(node(pred, NODE_NEXT), myNode);
+    read_acquired(famOps->atomic_fetch_and(item, node(myNode, NODE_STATE),
+                                           ~(uint64_t)STATE_BLOCKED));
+}
+
+/*
+ * A reader given the lock lets in the reader that queued behind it while
+ * it was waiting
+ */
+void Fam_Lock::read_acquired(uint64_t oldState) {
+    if (oldState & STATE_READER_NEXT) {
+        uint64_t next = wait_next();
+        famOps->atomic_fetch_add(item, header(HEADER_READERS), (uint64_t)1);
+        unblock(next);
+    }
+    held = HELD_SHARED;
+}
+
+bool Fam_Lock::try_read_lock() {
+    check_acquire(true);
+    if (fetch(header(HEADER_TAIL)) != 0)
+        return false;
+    reset_node(CLASS_READER);
+    if (famOps->compare_swap(item, header(HEADER_TAIL), (uint64_t)0,
+                             myNode) != 0)
+        return false;
+    famOps->atomic_fetch_add(item, header(HEADER_READERS), (uint64_t)1);
+    read_acquired(famOps->atomic_fetch_and(item, node(myNode, NODE_STATE),
+                                           ~(uint64_t)STATE_BLOCKED));
+    return true;
+}
+
+bool Fam_Lock::timed_read_lock(uint64_t timeoutUsec) {
+    return retry_until(true, timeoutUsec);
+}
+
+void Fam_Lock::unlock() {
+    if (held == HELD_NONE) {
+        throw Fam_InvalidOption_Exception(
+            "Lock is not held through this handle");
+    }
+    if (held == HELD_SHARED)
+        read_unlock();
+    else if (type == FAM_LOCK_RW)
+        write_unlock();
+    else
+        mutex_unlock();
+    held = HELD_NONE;
+}
+
+void Fam_Lock::mutex_unlock() {
+    uint64_t next = fetch(node(myNode, NODE_NEXT));
+    if (next == 0) {
+        if (famOps->compare_swap(item, header(HEADER_TAIL), myNode,
+                                 (uint64_t)0) == myNode)
+            return;
+        next = wait_next();
+    }
+    unblock(next);
+}
+
+void Fam_Lock::write_unlock() {
+    uint64_t next = fetch(node(myNode, NODE_NEXT));
+    if (next == 0) {
+        if (famOps->compare_swap(item, header(HEADER_TAIL), myNode,
+                                 (uint64_t)0) == myNode)
+            return;
+        next = wait_next();
+    }
+    if (fetch(node(next, NODE_CLASS)) == CLASS_READER)
+        famOps->atomic_fetch_add(item, header(HEADER_READERS), (uint64_t)1);
+    unblock(next);
+}
+
+void Fam_Lock::read_unlock() {
+    uint64_t next = fetch(node(myNode, NODE_NEXT));
+    if ((next != 0) || (famOps->compare_swap(item, header(HEADER_TAIL),
+                                             myNode, (uint64_t)0) != myNode)) {
+        if (next == 0)
+            next = wait_next();
+        // The last reader to leave hands the lock to this writer
+        if (fetch(node(myNode, NODE_STATE)) & STATE_WRITER_NEXT)
+            store(header(HEADER_NEXT_WRITER), next);
+    }
+    if (famOps->atomic_fetch_add(item, header(HEADER_READERS),
+                                 (uint64_t)-1) == 1) {
+        uint64_t writer = fetch(header(HEADER_NEXT_WRITER));
+        if ((writer != 0) && (fetch(header(HEADER_READERS)) == 0) &&
+            (famOps->compare_swap(item, header(HEADER_NEXT_WRITER), writer,
+                                  (uint64_t)0) == writer))
+            unblock(writer);
+    }
+}
+
+} // namespace openfam
@@ -0,0 +1,154 @@
+/*
+ * fam_lock.h
+ * Copyright (c) 2019 Hewlett Packard Enterprise Development, LP. All rights
+ * reserved. Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ *    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * See https://spdx.org/licenses/BSD-3-Clause
+ *
+ */
+#ifndef FAM_LOCK_H
+#define FAM_LOCK_H
+
+#include <stdint.h>
+
+#include "common/fam_ops.h"
+#include "fam/fam.h"
+
+/*
+ * Longest pause between attempts of a timed lock, in microseconds
+ */
+#define FAM_LOCK_MAX_BACKOFF_USEC 1000
+
+namespace openfam {
+
+/*
+ * Handle of a queue lock kept in a data item in FAM, used through FAM
+ * atomics only. The item is laid out as
+ *
+ *   header | queue node 0 | queue node 1 | ...
+ *
+ * Every handle claims a queue node when it is opened. A holder queues by
+ * swapping its node into the tail of the lock, links itself behind its
+ * predecessor and then polls its own node until the predecessor hands the
+ * lock over, so waiters never poll a shared word. A release either swings
+ * the tail back to empty or updates the node of the successor, which takes
+ * O(1) FAM operations whatever the number of waiters.
+ *
+ * FAM_LOCK_MUTEX locks are MCS locks. FAM_LOCK_RW locks are the fair
+ * reader-writer queue locks of Mellor-Crummey and Scott: consecutive
+ * readers in the queue are let in together and counted in the header,
+ * and a writer queued behind readers is recorded in the header so that
+ * the last reader to leave can hand it the lock.
+ *
+ * Try and timed variants never queue: they take the lock only when the
+ * queue is empty, retrying with a growing pause until the timeout. Timed
+ * waiters are therefore not served in turn and can starve while holders
+ * keep queuing; a queue node cannot leave the middle of the queue, since
+ * its predecessor hands the lock over by writing to it.
+ *
+ * A handle must not be used by two threads at once; threads contending
+ * for a lock each open their own handle.
+ */
+class Fam_Lock {
+  public:
+    Fam_Lock(Fam_Ops *ops, Fam_Descriptor *item);
+
+    /* Size of the data item of a lock with maxHolders queue nodes */
+    static uint64_t item_size(uint64_t maxHolders);
+
+    /* Initialize the lock in a data item just allocated, and open it */
+    void create(Fam_Lock_Type type, uint64_t maxHolders);
+
+    /* Claim a free queue node of an existing lock */
+    void open();
+
+    /* Give up the queue node; the lock must not be held */
+    void close();
+
+    void lock();
+    bool try_lock();
+    bool timed_lock(uint64_t timeoutUsec);
+
+    void read_lock();
+    bool try_read_lock();
+    bool timed_read_lock(uint64_t timeoutUsec);
+
+    /* Release the lock in whichever mode it is held */
+    void unlock();
+
+    Fam_Descriptor *get_item() { return item; }
+    Fam_Lock_Type get_type() { return type; }
+
+  private:
+    enum {
+        HEADER_MAGIC = 0,
+        HEADER_TYPE,
+        HEADER_NUM_NODES,
+        HEADER_TAIL,
+        HEADER_READERS,
+        HEADER_NEXT_WRITER,
+        HEADER_WORDS
+    };
+
+    enum { NODE_OWNER = 0, NODE_NEXT, NODE_STATE, NODE_CLASS, NODE_WORDS };
+
+    /* Bits of the state word of a queue node */
+    enum {
+        STATE_BLOCKED = 1,
+        STATE_READER_NEXT = 2,
+        STATE_WRITER_NEXT = 4
+    };
+
+    enum { CLASS_READER = 1, CLASS_WRITER };
+
+    enum { HELD_NONE = 0, HELD_EXCLUSIVE, HELD_SHARED };
+
+    uint64_t header(int word);
+    uint64_t node(uint64_t id, int word);
+    uint64_t fetch(uint64_t offset);
+    void store(uint64_t offset, uint64_t value);
+    void unblock(uint64_t id);
+    void reset_node(uint64_t nodeClass);
+    void wait_unblocked();
+    uint64_t wait_next();
+    void check_acquire(bool shared);
+
+    bool try_write_lock();
+    bool retry_until(bool shared, uint64_t timeoutUsec);
+    void read_acquired(uint64_t oldState);
+    void mutex_unlock();
+    void read_unlock();
+    void write_unlock();
+
+    Fam_Ops *famOps;
+    Fam_Descriptor *item;
+    Fam_Lock_Type type;
+    uint64_t numNodes;
+    // Queue node of this handle, from 1; 0 stands for no node
+    uint64_t myNode;
+    int held;
+};
+
+} // namespace openfam
+#endif
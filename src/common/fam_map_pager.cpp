@@ -0,0 +1,476 @@
+/*
+ * fam_map_pager.cpp
+ * Copyright (c) 2019 Hewlett Packard Enterprise Development, LP. All rights
+ * reserved. Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ *    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * See https://spdx.org/licenses/BSD-3-Clause
+ *
+ */
+#include <errno.h>
+#include <fcntl.h>
+#include <linux/userfaultfd.h>
+#include <poll.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/eventfd.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "common/fam_map_pager.h"
+
+namespace openfam {
+
+Fam_Map_Pager::Fam_Map_Pager(Fam_Ops *ops, Fam_Thread_Model famTM,
+                             uint64_t readaheadPages,
+                             uint64_t maxResidentPages)
+    : famOps(ops), famThreadModel(famTM),
+      readahead(readaheadPages ? readaheadPages : 1),
+      maxResident(maxResidentPages), uffd(-1), stopFd(-1),
+      wpSupported(false), handlerRunning(false), bounce(NULL),
+      numResident(0) {
+    pageSize = (uint64_t)sysconf(_SC_PAGESIZE);
+    if (maxResident < readahead)
+        maxResident = readahead;
+    (void)pthread_mutex_init(&pagerLock, NULL);
+}
+
+Fam_Map_Pager::~Fam_Map_Pager() {
+    stop();
+    for (auto obj : windows)
+        release_window(obj.second);
+    windows.clear();
+    (void)pthread_mutex_destroy(&pagerLock);
+}
+
+/*
+ * Open the userfaultfd and start the fault handler. This is deferred to
+ * the first fam_map, so that a kernel without userfaultfd only fails
+ * applications that map data items.
+ */
+void Fam_Map_Pager::start() {
+    std::ostringstream message;
+    struct uffdio_api api;
+
+    for (int attempt = 0; attempt < 2; attempt++) {
+        uffd = (int)syscall(SYS_userfaultfd, O_CLOEXEC | O_NONBLOCK);
+        if (uffd < 0) {
+            message << "fam_map: userfaultfd failed: " << strerror(errno);
+            throw Fam_Datapath_Exception(FAM_ERR_RESOURCE,
+                                         message.str().c_str());
+        }
+        memset(&api, 0, sizeof(api));
+        api.api = UFFD_API;
+        // Ask for write-protect faults first and fall back to tracking
+        // missing-page faults only
+        api.features = attempt ? 0 : UFFD_FEATURE_PAGEFAULT_FLAG_WP;
+        if (ioctl(uffd, UFFDIO_API, &api) == 0)
+            break;
+        close(uffd);
+        uffd = -1;
+    }
+    if (uffd < 0) {
+        message << "fam_map: userfaultfd API handshake failed";
+        throw Fam_Datapath_Exception(FAM_ERR_RESOURCE, message.str().c_str());
+    }
+    wpSupported = (api.features & UFFD_FEATURE_PAGEFAULT_FLAG_WP) != 0;
+
+    if (posix_memalign((void **)&bounce, pageSize, readahead * pageSize) !=
+        0) {
+        bounce = NULL;
+        stop();
+        throw Fam_Datapath_Exception(
+            FAM_ERR_RESOURCE, "fam_map: bounce buffer allocation failed");
+    }
+    stopFd = eventfd(0, EFD_CLOEXEC);
+    if (stopFd < 0 ||
+        pthread_create(&handlerThread, NULL, fault_handler, this) != 0) {
+        stop();
+        throw Fam_Datapath_Exception(FAM_ERR_RESOURCE,
+                                     "fam_map: fault handler start failed");
+    }
+    handlerRunning = true;
+}
+
+void Fam_Map_Pager::stop() {
+    if (handlerRunning) {
+        uint64_t one = 1;
+        ssize_t ret = write(stopFd, &one, sizeof(one));
+        (void)ret;
+        pthread_join(handlerThread, NULL);
+        handlerRunning = false;
+    }
+    if (stopFd >= 0) {
+        close(stopFd);
+        stopFd = -1;
+    }
+    if (uffd >= 0) {
+        close(uffd);
+        uffd = -1;
+    }
+    free(bounce);
+    bounce = NULL;
+}
+
+void *Fam_Map_Pager::fault_handler(void *arg) {
+    ((Fam_Map_Pager *)arg)->serve_faults();
+    return NULL;
+}
+
+void Fam_Map_Pager::serve_faults() {
+    struct pollfd fds[2];
+    fds[0].fd = uffd;
+    fds[0].events = POLLIN;
+    fds[1].fd = stopFd;
+    fds[1].events = POLLIN;
+
+    for (;;) {
+        fds[0].revents = fds[1].revents = 0;
+        if (poll(fds, 2, -1) < 0) {
+            if (errno == EINTR)
+                continue;
+            break;
+        }
+        if (fds[1].revents)
+            break;
+
+        struct uffd_msg msg;
+        if (read(uffd, &msg, sizeof(msg)) != (ssize_t)sizeof(msg))
+            continue;
+        if (msg.event != UFFD_EVENT_PAGEFAULT)
+            continue;
+
+        (void)pthread_mutex_lock(&pagerLock);
+        try {
+            handle_fault(msg.arg.pagefault.address, msg.arg.pagefault.flags);
+        } catch (Fam_Exception &e) {
+            if (faultError.empty())
+                faultError = e.fam_error_msg();
+        }
+        (void)pthread_mutex_unlock(&pagerLock);
+    }
+}
+
+void Fam_Map_Pager::handle_fault(uint64_t address, uint64_t flags) {
+    Fam_Map_Window *window = find_window(address);
+    if (window == NULL) {
+        // The window was unmapped after the fault was raised
+        wake(address);
+        return;
+    }
+    uint64_t page = (address - (uint64_t)window->base) / pageSize;
+    uint8_t &state = window->pageState[page];
+
+    if (flags & UFFD_PAGEFAULT_FLAG_WP) {
+        if (state == PAGE_ABSENT) {
+            // Evicted while the store waited; retry as a missing page
+            wake(address);
+            return;
+        }
+        state = PAGE_DIRTY;
+        protect(window, page, 1, false);
+        return;
+    }
+    if (state != PAGE_ABSENT) {
+        // Installed by readahead after the fault was raised
+        wake(address);
+        return;
+    }
+    fetch_pages(window, page, (flags & UFFD_PAGEFAULT_FLAG_WRITE) != 0);
+}
+
+void Fam_Map_Pager::fetch_pages(Fam_Map_Window *window, uint64_t page,
+                                bool isWrite) {
+    uint64_t numPages = window->pageState.size();
+    uint64_t count = 1;
+    while (count < readahead && page + count < numPages &&
+           window->pageState[page + count] == PAGE_ABSENT)
+        count++;
+    make_room(count);
+
+    uint64_t offset = page * pageSize;
+    uint64_t nbytes = count * pageSize;
+    if (offset + nbytes > window->size)
+        nbytes = window->size - offset;
+    // Bytes of the last page beyond the end of the item read as zero
+    memset(bounce + nbytes, 0, count * pageSize - nbytes);
+
+    int ret;
+    try {
+        ret = famOps->get_blocking(bounce, window->descriptor, offset, nbytes);
+    } catch (Fam_Exception &e) {
+        // Resolve the fault with zeroes rather than leave the faulting
+        // thread blocked; the error is raised by the next sync or unmap
+        memset(bounce, 0, pageSize);
+        install_pages(window, page, 1, bounce, !isWrite);
+        throw;
+    }
+    if (ret != 0) {
+        memset(bounce, 0, pageSize);
+        install_pages(window, page, 1, bounce, !isWrite);
+        throw Fam_Datapath_Exception(FAM_ERR_LIBFABRIC,
+                                     "fam_map: page read from FAM failed");
+    }
+    // Install readahead pages first, so that the faulting thread resumes
+    // only after the pages following its own are present
+    if (count > 1)
+        install_pages(window, page + 1, count - 1, bounce + pageSize, true);
+    install_pages(window, page, 1, bounce, !isWrite);
+}
+
+void Fam_Map_Pager::install_pages(Fam_Map_Window *window, uint64_t page,
+                                  uint64_t count, char *src,
+                                  bool writeProtect) {
+    struct uffdio_copy copy;
+    copy.dst = (uint64_t)(window->base + page * pageSize);
+    copy.src = (uint64_t)src;
+    copy.len = count * pageSize;
+    copy.mode = (writeProtect && wpSupported) ? UFFDIO_COPY_MODE_WP : 0;
+    copy.copy = 0;
+    if (ioctl(uffd, UFFDIO_COPY, &copy) < 0 && errno != EEXIST) {
+        wake(copy.dst);
+        throw Fam_Datapath_Exception(FAM_ERR_RESOURCE,
+                                     "fam_map: page install failed");
+    }
+    uint8_t state = (!wpSupported || !writeProtect) ? PAGE_DIRTY : PAGE_CLEAN;
+    for (uint64_t i = page; i < page + count; i++) {
+        window->pageState[i] = state;
+        resident.push_back(std::make_pair(window, i));
+    }
+    numResident += count;
+}
+
+/*
+ * Evict the oldest resident pages until count more pages fit in the
+ * resident set. Dirty pages are written back before they are dropped.
+ */
+void Fam_Map_Pager::make_room(uint64_t count) {
+    while (numResident + count > maxResident && !resident.empty()) {
+        Fam_Map_Window *window = resident.front().first;
+        uint64_t page = resident.front().second;
+        resident.pop_front();
+        if (window->pageState[page] == PAGE_DIRTY)
+            write_back(window, page, 1);
+        (void)madvise(window->base + page * pageSize, pageSize,
+                      MADV_DONTNEED);
+        window->pageState[page] = PAGE_ABSENT;
+        numResident--;
+    }
+}
+
+/*
+ * Write a run of dirty pages back to FAM. The pages are write protected
+ * first, so a store racing with the write back faults and marks its page
+ * dirty again once the pager lock is released.
+ */
+void Fam_Map_Pager::write_back(Fam_Map_Window *window, uint64_t page,
+                               uint64_t count) {
+    if (wpSupported) {
+        protect(window, page, count, true);
+        for (uint64_t i = page; i < page + count; i++)
+            window->pageState[i] = PAGE_CLEAN;
+    }
+    uint64_t offset = page * pageSize;
+    uint64_t nbytes = count * pageSize;
+    if (offset + nbytes > window->size)
+        nbytes = window->size - offset;
+    if (famOps->put_blocking(window->base + offset, window->descriptor,
+                             offset, nbytes) != 0)
+        throw Fam_Datapath_Exception(FAM_ERR_LIBFABRIC,
+                                     "fam_map: page write to FAM failed");
+}
+
+void Fam_Map_Pager::sync_window(Fam_Map_Window *window) {
+    uint64_t numPages = window->pageState.size();
+    uint64_t page = 0;
+    while (page < numPages) {
+        if (window->pageState[page] != PAGE_DIRTY) {
+            page++;
+            continue;
+        }
+        uint64_t count = 1;
+        while (page + count < numPages &&
+               window->pageState[page + count] == PAGE_DIRTY)
+            count++;
+        write_back(window, page, count);
+        page += count;
+    }
+}
+
+void Fam_Map_Pager::release_window(Fam_Map_Window *window) {
+    for (auto it = resident.begin(); it != resident.end();) {
+        if (it->first == window)
+            it = resident.erase(it);
+        else
+            ++it;
+    }
+    for (auto state : window->pageState) {
+        if (state != PAGE_ABSENT)
+            numResident--;
+    }
+    if (uffd >= 0) {
+        struct uffdio_range range;
+        range.start = (uint64_t)window->base;
+        range.len = window->mapSize;
+        (void)ioctl(uffd, UFFDIO_UNREGISTER, &range);
+    }
+    (void)munmap(window->base, window->mapSize);
+    delete window;
+}
+
+void Fam_Map_Pager::protect(Fam_Map_Window *window, uint64_t page,
+                            uint64_t count, bool writeProtect) {
+    struct uffdio_writeprotect wp;
+    wp.range.start = (uint64_t)(window->base + page * pageSize);
+    wp.range.len = count * pageSize;
+    wp.mode = writeProtect ? UFFDIO_WRITEPROTECT_MODE_WP : 0;
+    if (ioctl(uffd, UFFDIO_WRITEPROTECT, &wp) < 0)
+        throw Fam_Datapath_Exception(FAM_ERR_RESOURCE,
+                                     "fam_map: write protect failed");
+}
+
+void Fam_Map_Pager::wake(uint64_t address) {
+    struct uffdio_range range;
+    range.start = address & ~(pageSize - 1);
+    range.len = pageSize;
+    (void)ioctl(uffd, UFFDIO_WAKE, &range);
+}
+
+Fam_Map_Window *Fam_Map_Pager::find_window(uint64_t address) {
+    auto obj = windows.upper_bound(address);
+    if (obj == windows.begin())
+        return NULL;
+    --obj;
+    Fam_Map_Window *window = obj->second;
+    if (address >= (uint64_t)window->base + window->mapSize)
+        return NULL;
+    return window;
+}
+
+void Fam_Map_Pager::throw_fault_error() {
+    if (faultError.empty())
+        return;
+    std::string message = faultError;
+    faultError.clear();
+    throw Fam_Datapath_Exception(FAM_ERR_LIBFABRIC, message.c_str());
+}
+
+void *Fam_Map_Pager::map(Fam_Descriptor *descriptor) {
+    uint64_t size = descriptor->get_size();
+    if (size == 0)
+        throw Fam_InvalidOption_Exception("fam_map: data item size is zero");
+    if (famThreadModel != FAM_THREAD_MULTIPLE)
+        throw Fam_InvalidOption_Exception(
+            "fam_map: memory servers require FAM_THREAD_MULTIPLE");
+
+    (void)pthread_mutex_lock(&pagerLock);
+    void *base;
+    try {
+        if (uffd < 0)
+            start();
+
+        uint64_t mapSize = (size + pageSize - 1) & ~(pageSize - 1);
+        base = mmap(NULL, mapSize, PROT_READ | PROT_WRITE,
+                    MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+        if (base == MAP_FAILED)
+            throw Fam_Datapath_Exception(FAM_ERR_RESOURCE,
+                                         "fam_map: mmap failed");
+
+        struct uffdio_register reg;
+        reg.range.start = (uint64_t)base;
+        reg.range.len = mapSize;
+        reg.mode = UFFDIO_REGISTER_MODE_MISSING;
+        if (wpSupported)
+            reg.mode |= UFFDIO_REGISTER_MODE_WP;
+        if (ioctl(uffd, UFFDIO_REGISTER, &reg) < 0) {
+            (void)munmap(base, mapSize);
+            throw Fam_Datapath_Exception(
+                FAM_ERR_RESOURCE, "fam_map: userfaultfd register failed");
+        }
+
+        Fam_Map_Window *window = new Fam_Map_Window();
+        window->descriptor = descriptor;
+        window->base = (char *)base;
+        window->size = size;
+        window->mapSize = mapSize;
+        window->pageState.assign(mapSize / pageSize, PAGE_ABSENT);
+        windows.insert({ (uint64_t)base, window });
+    } catch (...) {
+        (void)pthread_mutex_unlock(&pagerLock);
+        throw;
+    }
+    (void)pthread_mutex_unlock(&pagerLock);
+    return base;
+}
+
+void Fam_Map_Pager::unmap(void *local) {
+    (void)pthread_mutex_lock(&pagerLock);
+    try {
+        auto obj = windows.find((uint64_t)local);
+        if (obj == windows.end())
+            throw Fam_InvalidOption_Exception(
+                "fam_unmap: address was not returned by fam_map");
+        Fam_Map_Window *window = obj->second;
+        sync_window(window);
+        windows.erase(obj);
+        release_window(window);
+        throw_fault_error();
+    } catch (...) {
+        (void)pthread_mutex_unlock(&pagerLock);
+        throw;
+    }
+    (void)pthread_mutex_unlock(&pagerLock);
+}
+
+void Fam_Map_Pager::sync(Fam_Region_Descriptor *region) {
+    (void)pthread_mutex_lock(&pagerLock);
+    try {
+        for (auto obj : windows) {
+            Fam_Map_Window *window = obj.second;
+            if (region != NULL &&
+                window->descriptor->get_global_descriptor().regionId !=
+                    region->get_global_descriptor().regionId)
+                continue;
+            sync_window(window);
+        }
+        throw_fault_error();
+    } catch (...) {
+        (void)pthread_mutex_unlock(&pagerLock);
+        throw;
+    }
+    (void)pthread_mutex_unlock(&pagerLock);
+}
+
+void Fam_Map_Pager::finalize() {
+    sync();
+    (void)pthread_mutex_lock(&pagerLock);
+    for (auto obj : windows)
+        release_window(obj.second);
+    windows.clear();
+    (void)pthread_mutex_unlock(&pagerLock);
+    stop();
+}
+
+} // namespace openfam
@@ -0,0 +1,143 @@
+/*
+ * fam_map_pager.h
+ * Copyright (c) 2019 Hewlett Packard Enterprise Development, LP. All rights
+ * reserved. Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ *    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * See https://spdx.org/licenses/BSD-3-Clause
+ *
+ */
+#ifndef FAM_MAP_PAGER_H
+#define FAM_MAP_PAGER_H
+
+#include <deque>
+#include <map>
+#include <pthread.h>
+#include <stdint.h>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/fam_ops.h"
+#include "fam/fam.h"
+
+/*
+ * Pages fetched by one missing-page fault, including the faulting page
+ */
+#define FAM_MAP_READAHEAD_PAGES 8
+
+/*
+ * Upper bound of pages resident across all mapped windows of a pager
+ */
+#define FAM_MAP_MAX_RESIDENT_PAGES 16384
+
+namespace openfam {
+
+/*
+ * Local virtual memory window backing one data item mapped with fam_map
+ */
+struct Fam_Map_Window {
+    Fam_Descriptor *descriptor;
+    char *base;
+    uint64_t size;
+    uint64_t mapSize;
+    std::vector<uint8_t> pageState;
+};
+
+/*
+ * Demand pager behind fam_map when data items live on memory servers.
+ * A mapped item is an anonymous window registered with userfaultfd. A
+ * missing-page fault is served by reading the faulting page, along with
+ * the absent pages that follow it, from FAM. Pages are installed write
+ * protected, so the first store to a page raises a write-protect fault
+ * that marks it dirty. Dirty pages are written back to FAM by sync and
+ * unmap, and when the resident set is trimmed. Kernels without
+ * userfaultfd write protection treat every resident page as dirty.
+ * Faults are served by a thread of the pager through the contexts of
+ * the application, which are only locked with FAM_THREAD_MULTIPLE, so
+ * items can only be mapped with that thread model.
+ */
+class Fam_Map_Pager {
+  public:
+    Fam_Map_Pager(Fam_Ops *ops, Fam_Thread_Model famTM,
+                  uint64_t readaheadPages = FAM_MAP_READAHEAD_PAGES,
+                  uint64_t maxResidentPages = FAM_MAP_MAX_RESIDENT_PAGES);
+
+    ~Fam_Map_Pager();
+
+    void *map(Fam_Descriptor *descriptor);
+
+    void unmap(void *local);
+
+    /*
+     * Write back the dirty pages of the items in the region, or of every
+     * mapped item if region is NULL
+     */
+    void sync(Fam_Region_Descriptor *region = NULL);
+
+    /* Write back and unmap every window, and stop the fault handler */
+    void finalize();
+
+  private:
+    enum { PAGE_ABSENT = 0, PAGE_CLEAN, PAGE_DIRTY };
+
+    void start();
+    void stop();
+    static void *fault_handler(void *arg);
+    void serve_faults();
+    void handle_fault(uint64_t address, uint64_t flags);
+    void fetch_pages(Fam_Map_Window *window, uint64_t page, bool isWrite);
+    void install_pages(Fam_Map_Window *window, uint64_t page, uint64_t count,
+                       char *src, bool writeProtect);
+    void make_room(uint64_t count);
+    void write_back(Fam_Map_Window *window, uint64_t page, uint64_t count);
+    void sync_window(Fam_Map_Window *window);
+    void release_window(Fam_Map_Window *window);
+    void protect(Fam_Map_Window *window, uint64_t page, uint64_t count,
+                 bool writeProtect);
+    void wake(uint64_t address);
+    Fam_Map_Window *find_window(uint64_t address);
+    void throw_fault_error();
+
+    Fam_Ops *famOps;
+    Fam_Thread_Model famThreadModel;
+    uint64_t readahead;
+    uint64_t maxResident;
+    uint64_t pageSize;
+    int uffd;
+    int stopFd;
+    bool wpSupported;
+    bool handlerRunning;
+    pthread_t handlerThread;
+    pthread_mutex_t pagerLock;
+    char *bounce;
+    std::map<uint64_t, Fam_Map_Window *> windows;
+    // Resident pages in the order they were faulted in
+    std::deque<std::pair<Fam_Map_Window *, uint64_t> > resident;
+    uint64_t numResident;
+    // First error of a fault served while no caller was waiting on it
+    std::string faultError;
+};
+
+} // namespace openfam
+#endif
@@ -76,6 +76,13 @@ class Fam_Ops {
      */
     virtual void abort(int status) = 0;
 
+    /**
+     * Prepare a data item descriptor for datapath operations once its key
+     * is bound, so that later operations need not look anything up.
+     * @param descriptor - valid descriptor to area in FAM.
+     */
+    virtual void bind_descriptor(Fam_Descriptor *descriptor) = 0;
+
     /**
      * Copy data from FAM to node local memory, blocking the caller while the
      * copy is completed.
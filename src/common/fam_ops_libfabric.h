@@ -48,6 +48,8 @@
 #include "allocator/fam_allocator.h"
 #include "allocator/fam_allocator_grpc.h"
 #include "common/fam_context.h"
+#include "common/fam_context_table.h"
+#include "common/fam_local_bypass.h"
 #include "common/fam_ops.h"
 #include "common/fam_options.h"
 #include "fam/fam.h"
@@ -351,8 +353,32 @@ class Fam_Ops_Libfabric : public Fam_Ops {
 
     Fam_Context *get_context(Fam_Descriptor *descriptor);
 
+    void bind_descriptor(Fam_Descriptor *descriptor);
+
+    /*
+     * Fields of the descriptor the datapath needs, resolving the memory
+     * server address and context the first time the descriptor is used
+     */
+    Fam_Descriptor_Hot *get_hot(Fam_Descriptor *descriptor) {
+        Fam_Descriptor_Hot *hot = fam_descriptor_hot(descriptor);
+        if (!hot->bound)
+            bind_descriptor(descriptor);
+        return hot;
+    }
+
     void quiet_context(Fam_Context *context);
 
+    Fam_Context *find_context(Fam_Region_Descriptor *descriptor);
+
+    /*
+     * Local address of the data item if its memory server shares this
+     * host, or NULL. The range is checked against the item, and writes
+     * against the access the memory server granted, since no memory
+     * registration checks accesses on this path.
+     */
+    char *get_local_base(Fam_Descriptor *descriptor, uint64_t offset,
+                         uint64_t nbytes, bool isWrite);
+
     size_t get_addr_size() {
         return serverAddrNameLen;
     };
@@ -381,11 +407,12 @@ class Fam_Ops_Libfabric : public Fam_Ops {
     std::vector<fi_addr_t> *fiAddrs;
     std::map<uint64_t, fid_mr *> *fiMrs;
 
-    std::map<uint64_t, Fam_Context *> *contexts;
+    Fam_Context_Table *contexts;
     std::map<uint64_t, Fam_Context *> *defContexts;
     Fam_Thread_Model famThreadModel;
     Fam_Context_Model famContextModel;
     Fam_Allocator *famAllocator;
+    Fam_Local_Bypass *localBypass;
 };
 } // namespace openfam
 #endif
@@ -41,6 +41,7 @@
 
 #include "common/fam_async_qhandler.h"
 #include "common/fam_context.h"
+#include "common/fam_context_table.h"
 #include "common/fam_ops.h"
 #include "fam/fam.h"
 
@@ -53,7 +54,9 @@ namespace openfam {
 class Fam_Ops_NVMM : public Fam_Ops {
   public:
     Fam_Ops_NVMM(Fam_Thread_Model famTM, Fam_Context_Model famCM,
-                 Fam_Allocator *famAlloc, uint64_t numConsumer);
+                 Fam_Allocator *famAlloc, uint64_t numConsumer,
+                 uint64_t queueDepth = QHANDLER_DEFAULT_QUEUE_DEPTH,
+                 Fam_Persist_Mode persistMode = FAM_PERSIST_EAGER);
     ~Fam_Ops_NVMM();
 
     int initialize();
@@ -62,6 +65,8 @@ class Fam_Ops_NVMM : public Fam_Ops {
 
     void abort(int status);
 
+    void bind_descriptor(Fam_Descriptor *descriptor);
+
     Fam_Context *get_context(Fam_Descriptor *descriptor);
     int put_blocking(void *local, Fam_Descriptor *descriptor, uint64_t offset,
                      uint64_t nbytes);
@@ -283,15 +288,25 @@ class Fam_Ops_NVMM : public Fam_Ops {
 
     void quiet_context(Fam_Context *context);
 
+    Fam_Context *find_context(Fam_Region_Descriptor *descriptor);
+
+    /* Log recording the writes to defer, or NULL to persist them now */
+    Fam_Persist_Log *get_persist_log(Fam_Context *context) {
+        return (famPersistMode == FAM_PERSIST_DEFERRED)
+                   ? context->get_persist_log()
+                   : NULL;
+    }
+
   protected:
     Fam_Async_QHandler *asyncQHandler;
 
     pthread_mutex_t ctxLock;
 
     Fam_Context *defaultCtx;
-    std::map<uint64_t, Fam_Context *> *contexts;
+    Fam_Context_Table *contexts;
     Fam_Thread_Model famThreadModel;
     Fam_Context_Model famContextModel;
+    Fam_Persist_Mode famPersistMode;
     Fam_Allocator *famAllocator;
 };
 } // end namespace openfam
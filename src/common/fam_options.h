@@ -68,6 +68,17 @@ typedef enum {
     RUNTIME,
     /**Number of consumer threads in case of shared memory model**/
     NUM_CONSUMER,
+    /** Size of the chunks leased by fam_allocate_local_pool */
+    LOCAL_POOL_CHUNK_SIZE,
+    /** Depth of the queue of each thread posting nonblocking operations in
+        shared memory model */
+    ASYNC_QUEUE_DEPTH,
+    /** When shared memory writes are made persistent */
+    PERSIST_MODE,
+    /** Whether latency statistics of API calls are recorded */
+    FAM_STATS,
+    /** Whether API calls and fabric operations are traced */
+    FAM_TRACE,
     /** END of Option keys */
     END_OPT = -1
 } Fam_Option_Key;
@@ -88,6 +99,15 @@ typedef enum {
 #define FAM_OPTIONS_RUNTIME_PMI2_STR "PMI2"
 #define FAM_OPTIONS_RUNTIME_NONE_STR "NONE"
 
+#define FAM_PERSIST_EAGER_STR "FAM_PERSIST_EAGER"
+#define FAM_PERSIST_DEFERRED_STR "FAM_PERSIST_DEFERRED"
+
+#define FAM_STATS_ENABLE_STR "FAM_STATS_ENABLE"
+#define FAM_STATS_DISABLE_STR "FAM_STATS_DISABLE"
+
+#define FAM_TRACE_ENABLE_STR "FAM_TRACE_ENABLE"
+#define FAM_TRACE_DISABLE_STR "FAM_TRACE_DISABLE"
+
 typedef enum {
     /** For single threaded applicaiton */
     FAM_THREAD_SERIALIZE = 1,
@@ -100,4 +120,11 @@ typedef enum {
     FAM_CONTEXT_REGION
 } Fam_Context_Model;
 
+typedef enum {
+    /** Writes are persistent when the operation completes */
+    FAM_PERSIST_EAGER = 1,
+    /** Writes are made persistent by fam_quiet, for scratch data */
+    FAM_PERSIST_DEFERRED
+} Fam_Persist_Mode;
+
 #endif
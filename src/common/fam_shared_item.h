@@ -0,0 +1,90 @@
+/*
+ * fam_shared_item.h
+ * Copyright (c) 2019 Hewlett Packard Enterprise Development, LP. All rights
+ * reserved. Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ *    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * See https://spdx.org/licenses/BSD-3-Clause
+ *
+ */
+#ifndef FAM_SHARED_ITEM_H
+#define FAM_SHARED_ITEM_H
+
+#include <sched.h>
+#include <stdint.h>
+#include <time.h>
+
+#include "common/fam_ops.h"
+#include "fam/fam.h"
+
+/*
+ * Polls of FAM made back to back by a waiter before it starts to yield the
+ * processor, and then to sleep FAM_POLL_SLEEP_NSEC between polls
+ */
+#define FAM_POLL_SPIN_POLLS 64
+#define FAM_POLL_YIELD_POLLS 1024
+#define FAM_POLL_SLEEP_NSEC 20000
+
+namespace openfam {
+
+/*
+ * Pause between the polls of a waiter on a word of a data item shared by
+ * PEs, such as the queue node of a lock or a flag of a team. Every poll is
+ * a read from FAM, so a waiter that waits long backs off to yielding and
+ * sleeping.
+ */
+class Fam_Poll_Backoff {
+  public:
+    Fam_Poll_Backoff() : polls(0) {}
+
+    void pause() {
+        polls++;
+        if (polls < FAM_POLL_SPIN_POLLS)
+            return;
+        if (polls < FAM_POLL_YIELD_POLLS) {
+            sched_yield();
+        } else {
+            struct timespec sleep = {0, FAM_POLL_SLEEP_NSEC};
+            nanosleep(&sleep, NULL);
+        }
+    }
+
+  private:
+    uint64_t polls;
+};
+
+/*
+ * Write the header of a cleared data item shared by PEs, whose first word
+ * is a magic number that other PEs check before using the item. The magic
+ * number is written last, once the item is clear, so that a PE that finds
+ * it also finds the rest of the header and a cleared item.
+ */
+static inline void fam_publish_header(Fam_Ops *famOps, Fam_Descriptor *item,
+                                      uint64_t *words, uint64_t numWords) {
+    famOps->put_blocking(&words[1], item, sizeof(uint64_t),
+                         (numWords - 1) * sizeof(uint64_t));
+    famOps->put_blocking(&words[0], item, 0, sizeof(uint64_t));
+}
+
+} // namespace openfam
+#endif
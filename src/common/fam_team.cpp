@@ -0,0 +1,226 @@
+/*
+ * fam_team.cpp
+ * Copyright (c) 2019 Hewlett Packard Enterprise Development, LP. All rights
+ * reserved. Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ *    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * See https://spdx.org/licenses/BSD-3-Clause
+ *
+ */
+
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <vector>
+
+#include "common/fam_shared_item.h"
+#include "common/fam_team.h"
+#include "common/fam_util_reduce.h"
+#include "fam/fam_exception.h"
+
+/* Marks a scratch data item published by PE 0 of its team */
+#define FAM_TEAM_MAGIC 0x46415445414d3031ULL
+
+/* Largest put made to clear a scratch data item */
+#define FAM_TEAM_CLEAR_BYTES (1UL << 20)
+
+#define FAM_TEAM_ALIGN 64
+
+namespace openfam {
+
+Fam_Team::Fam_Team(Fam_Ops *ops, Fam_Descriptor *item, int numPEs, int myPE,
+                   uint64_t maxBytes)
+    : famOps(ops), item(item), numPEs(numPEs), myPE(myPE),
+      maxBytes(maxBytes), numBarriers(0), numBroadcasts(0) {
+    numRounds = num_rounds(numPEs);
+    uint64_t bufferSize = buffer_size(maxBytes);
+    broadcastOffset = broadcast_offset(numPEs);
+    contributionOffset = broadcastOffset + 2 * bufferSize;
+    resultOffset = contributionOffset + (uint64_t)numPEs * bufferSize;
+}
+
+uint64_t Fam_Team::num_rounds(int numPEs) {
+    uint64_t rounds = 0;
+    while ((1ULL << rounds) < (uint64_t)numPEs)
+        rounds++;
+    return rounds;
+}
+
+uint64_t Fam_Team::buffer_size(uint64_t maxBytes) {
+    return (maxBytes + FAM_TEAM_ALIGN - 1) / FAM_TEAM_ALIGN * FAM_TEAM_ALIGN;
+}
+
+/* The header and the barrier flags come before the buffers */
+uint64_t Fam_Team::broadcast_offset(int numPEs) {
+    uint64_t flagsSize =
+        num_rounds(numPEs) * (uint64_t)numPEs * sizeof(uint64_t);
+    return FAM_TEAM_ALIGN + buffer_size(flagsSize);
+}
+
+uint64_t Fam_Team::item_size(int numPEs, uint64_t maxBytes) {
+    return broadcast_offset(numPEs) +
+           ((uint64_t)numPEs + 3) * buffer_size(maxBytes);
+}
+
+uint64_t Fam_Team::flag_offset(uint64_t round, int pe) {
+    return FAM_TEAM_ALIGN +
+           (round * (uint64_t)numPEs + (uint64_t)pe) * sizeof(uint64_t);
+}
+
+/*
+ * Polls the flag at offset until it reaches value
+ */
+void Fam_Team::wait_for(uint64_t offset, uint64_t value) {
+    Fam_Poll_Backoff backoff;
+    while (famOps->atomic_fetch_uint64(item, offset) < value)
+        backoff.pause();
+}
+
+void Fam_Team::create() {
+    uint64_t size = item_size(numPEs, maxBytes);
+    uint64_t clearSize =
+        (size < FAM_TEAM_CLEAR_BYTES) ? size : FAM_TEAM_CLEAR_BYTES;
+    std::vector<char> zeros(clearSize, 0);
+    for (uint64_t offset = 0; offset < size; offset += clearSize) {
+        uint64_t nbytes =
+            (size - offset < clearSize) ? size - offset : clearSize;
+        famOps->put_blocking(zeros.data(), item, offset, nbytes);
+    }
+
+    uint64_t header[HEADER_WORDS];
+    header[HEADER_MAGIC] = FAM_TEAM_MAGIC;
+    header[HEADER_NUM_PES] = (uint64_t)numPEs;
+    header[HEADER_MAX_BYTES] = maxBytes;
+    header[HEADER_DEPARTED] = 0;
+    fam_publish_header(famOps, item, header, HEADER_WORDS);
+}
+
+bool Fam_Team::join(uint64_t timeoutSec) {
+    uint64_t header[HEADER_WORDS];
+    time_t deadline = time(NULL) + (time_t)timeoutSec;
+
+    for (;;) {
+        famOps->get_blocking(header, item, 0, sizeof(header));
+        if (header[HEADER_MAGIC] == FAM_TEAM_MAGIC)
+            break;
+        if (time(NULL) > deadline)
+            return false;
+        usleep(1000);
+    }
+    if ((header[HEADER_NUM_PES] != (uint64_t)numPEs) ||
+        (header[HEADER_MAX_BYTES] != maxBytes)) {
+        throw Fam_InvalidOption_Exception(
+            "Team was created with a different number of PEs or size");
+    }
+    return true;
+}
+
+void Fam_Team::barrier() {
+    numBarriers++;
+    for (uint64_t round = 0; round < numRounds; round++) {
+        int partner = (int)(((uint64_t)myPE + (1ULL << round)) %
+                            (uint64_t)numPEs);
+        famOps->atomic_add(item, flag_offset(round, partner), (uint64_t)1);
+        wait_for(flag_offset(round, myPE), numBarriers);
+    }
+}
+
+void Fam_Team::broadcast(void *data, uint64_t nbytes, int root) {
+    if ((nbytes > maxBytes) || (root < 0) || (root >= numPEs)) {
+        throw Fam_InvalidOption_Exception(
+            "Broadcast is larger than the team buffers or root is invalid");
+    }
+    if (numPEs == 1)
+        return;
+
+    uint64_t offset = broadcastOffset +
+                      (numBroadcasts++ % 2) * buffer_size(maxBytes);
+    if ((myPE == root) && nbytes)
+        famOps->put_blocking(data, item, offset, nbytes);
+    barrier();
+    if ((myPE != root) && nbytes)
+        famOps->get_blocking(data, item, offset, nbytes);
+}
+
+void Fam_Team::allreduce(void *data, uint64_t count, Fam_Data_Type type,
+                         Fam_Reduce_Op op) {
+    uint64_t elementSize = fam_data_type_size(type);
+    if ((elementSize == 0) || (count > maxBytes / elementSize) ||
+        ((uint32_t)op > (uint32_t)FAM_REDUCE_MAX)) {
+        throw Fam_InvalidOption_Exception(
+            "Allreduce is larger than the team buffers or type is invalid");
+    }
+    if (numPEs == 1)
+        return;
+
+    uint64_t bufferSize = buffer_size(maxBytes);
+    uint64_t nbytes = count * elementSize;
+    if (nbytes)
+        famOps->put_blocking(data, item,
+                             contributionOffset + (uint64_t)myPE * bufferSize,
+                             nbytes);
+    barrier();
+
+    // Reduce this PE's slice of the elements over all contributions
+    uint64_t first = count * (uint64_t)myPE / (uint64_t)numPEs;
+    uint64_t last = count * (uint64_t)(myPE + 1) / (uint64_t)numPEs;
+    if (last > first) {
+        uint64_t sliceBytes = (last - first) * elementSize;
+        std::vector<uint64_t> slices(
+            ((uint64_t)numPEs * sliceBytes + sizeof(uint64_t) - 1) /
+            sizeof(uint64_t));
+        char *buffer = (char *)slices.data();
+        for (int pe = 0; pe < numPEs; pe++) {
+            famOps->get_nonblocking(buffer + (uint64_t)pe * sliceBytes, item,
+                                    contributionOffset +
+                                        (uint64_t)pe * bufferSize +
+                                        first * elementSize,
+                                    sliceBytes);
+        }
+        famOps->quiet();
+        for (int pe = 1; pe < numPEs; pe++)
+            fam_reduce_elements(buffer, buffer + (uint64_t)pe * sliceBytes,
+                                last - first, type, op);
+        famOps->put_blocking(buffer, item, resultOffset + first * elementSize,
+                             sliceBytes);
+    }
+    barrier();
+
+    if (nbytes)
+        famOps->get_blocking(data, item, resultOffset, nbytes);
+}
+
+void Fam_Team::leave() {
+    barrier();
+    famOps->atomic_add(item, HEADER_DEPARTED * sizeof(uint64_t), (uint64_t)1);
+    famOps->quiet();
+    if (myPE != 0)
+        return;
+
+    // No PE reads the item once all have left; unpublish it
+    wait_for(HEADER_DEPARTED * sizeof(uint64_t), (uint64_t)numPEs);
+    uint64_t magic = 0;
+    famOps->put_blocking(&magic, item, 0, sizeof(uint64_t));
+}
+
+} // namespace openfam
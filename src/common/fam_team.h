@@ -0,0 +1,136 @@
+/*
+ * fam_team.h
+ * Copyright (c) 2019 Hewlett Packard Enterprise Development, LP. All rights
+ * reserved. Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ *    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * See https://spdx.org/licenses/BSD-3-Clause
+ *
+ */
+#ifndef FAM_TEAM_H
+#define FAM_TEAM_H
+
+#include <stdint.h>
+
+#include "common/fam_ops.h"
+#include "fam/fam.h"
+
+/*
+ * Time a PE creating a team waits for PE 0 to publish its scratch data item
+ */
+#define FAM_TEAM_JOIN_TIMEOUT_SEC 60
+
+namespace openfam {
+
+/*
+ * PEs running collectives over a scratch data item in FAM, with FAM
+ * atomics, puts and gets only, so that no runtime is needed. The item is
+ * laid out as
+ *
+ *   header | barrier flags | 2 broadcast buffers | contributions | result
+ *
+ * The barrier is a dissemination barrier: in round r of the log2(PEs)
+ * rounds, a PE adds 1 to its flag of round r at PE (pe + 2^r) % PEs, and
+ * waits for its own flag of the round to reach the number of barriers it
+ * has entered. Flags only grow, so they are never reset.
+ *
+ * A broadcast is a put of the root into a broadcast buffer, a barrier and
+ * a get by the other PEs. Consecutive broadcasts use alternate buffers, so
+ * the root of the next one cannot overwrite a buffer still being read.
+ *
+ * An allreduce is a reduce-scatter followed by an allgather through FAM.
+ * Each PE puts its elements into its contribution buffer. After a barrier,
+ * PE i reduces the i-th slice of the elements over all contributions and
+ * puts it into the result buffer. After a second barrier, every PE gets
+ * the result. Each PE moves about three times its elements whatever the
+ * number of PEs.
+ */
+class Fam_Team {
+  public:
+    Fam_Team(Fam_Ops *ops, Fam_Descriptor *item, int numPEs, int myPE,
+             uint64_t maxBytes);
+
+    /* Size of the scratch data item of a team */
+    static uint64_t item_size(int numPEs, uint64_t maxBytes);
+
+    /*
+     * Clear the scratch data item and publish it to the other PEs; called
+     * by PE 0 on an item it has just allocated
+     */
+    void create();
+
+    /*
+     * Wait for PE 0 to publish the scratch data item. Returns false if it
+     * is not published before timeoutSec.
+     */
+    bool join(uint64_t timeoutSec);
+
+    void barrier();
+
+    void broadcast(void *data, uint64_t nbytes, int root);
+
+    void allreduce(void *data, uint64_t count, Fam_Data_Type type,
+                   Fam_Reduce_Op op);
+
+    /*
+     * Leave the team after a last barrier. PE 0 returns once all PEs have
+     * left, when the scratch data item can be deallocated.
+     */
+    void leave();
+
+    Fam_Descriptor *get_item() { return item; }
+    int num_pes() { return numPEs; }
+    int my_pe() { return myPE; }
+    uint64_t max_bytes() { return maxBytes; }
+
+  private:
+    enum {
+        HEADER_MAGIC = 0,
+        HEADER_NUM_PES,
+        HEADER_MAX_BYTES,
+        HEADER_DEPARTED,
+        HEADER_WORDS
+    };
+
+    static uint64_t num_rounds(int numPEs);
+    static uint64_t buffer_size(uint64_t maxBytes);
+    static uint64_t broadcast_offset(int numPEs);
+    uint64_t flag_offset(uint64_t round, int pe);
+    void wait_for(uint64_t offset, uint64_t value);
+
+    Fam_Ops *famOps;
+    Fam_Descriptor *item;
+    int numPEs;
+    int myPE;
+    uint64_t maxBytes;
+    uint64_t numRounds;
+    uint64_t broadcastOffset;
+    uint64_t contributionOffset;
+    uint64_t resultOffset;
+    // Barriers and broadcasts this PE has entered
+    uint64_t numBarriers;
+    uint64_t numBroadcasts;
+};
+
+} // namespace openfam
+#endif
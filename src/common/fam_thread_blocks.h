@@ -0,0 +1,120 @@
+/*
+ * fam_thread_blocks.h
+ * Copyright (c) 2019 Hewlett Packard Enterprise Development, LP. All rights
+ * reserved. Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ *    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * See https://spdx.org/licenses/BSD-3-Clause
+ *
+ */
+#ifndef FAM_THREAD_BLOCKS_H_
+#define FAM_THREAD_BLOCKS_H_
+
+#include <atomic>
+#include <pthread.h>
+#include <stdint.h>
+#include <vector>
+
+namespace openfam {
+
+/*
+ * Blocks of counters private to each thread that records into an instance
+ * of a statistics class, so that recording takes no lock. A thread finds
+ * its block through a thread local cache; instance ids distinguish the
+ * instances a thread may record into, so that the cached block of an
+ * instance is never used for another one. The owner of the registry
+ * deletes the blocks.
+ */
+template <typename Block> class Fam_Thread_Blocks {
+  public:
+    Fam_Thread_Blocks() {
+        instanceId = next_instance_id().fetch_add(1);
+        (void)pthread_mutex_init(&blocksLock, NULL);
+    }
+
+    ~Fam_Thread_Blocks() { (void)pthread_mutex_destroy(&blocksLock); }
+
+    /*
+     * Returns the block of the calling thread, made by create() on the
+     * first call. A block left behind by an exited thread is taken over by
+     * a new thread that gets the same pthread id, which keeps a single
+     * writer per block.
+     */
+    template <typename Create> Block *get(Create create) {
+        Thread_Cache &threadCache = thread_cache();
+        if (threadCache.instanceId == instanceId)
+            return threadCache.block;
+
+        pthread_t self = pthread_self();
+        Block *block = NULL;
+        lock();
+        for (uint64_t i = 0; i < owners.size(); i++) {
+            if (pthread_equal(owners[i], self)) {
+                block = blocks[i];
+                break;
+            }
+        }
+        if (block == NULL) {
+            // Published under the lock, so readers see it initialized
+            block = create();
+            owners.push_back(self);
+            blocks.push_back(block);
+        }
+        unlock();
+
+        threadCache.instanceId = instanceId;
+        threadCache.block = block;
+        return block;
+    }
+
+    void lock() { (void)pthread_mutex_lock(&blocksLock); }
+
+    void unlock() { (void)pthread_mutex_unlock(&blocksLock); }
+
+    /* Blocks of all threads, read with the registry locked */
+    const std::vector<Block *> &get_blocks() { return blocks; }
+
+  private:
+    struct Thread_Cache {
+        uint64_t instanceId;
+        Block *block;
+    };
+
+    static std::atomic<uint64_t> &next_instance_id() {
+        static std::atomic<uint64_t> nextInstanceId(1);
+        return nextInstanceId;
+    }
+
+    static Thread_Cache &thread_cache() {
+        static thread_local Thread_Cache threadCache = {0, NULL};
+        return threadCache;
+    }
+
+    uint64_t instanceId;
+    pthread_mutex_t blocksLock;
+    std::vector<pthread_t> owners;
+    std::vector<Block *> blocks;
+};
+
+} // namespace openfam
+#endif // FAM_THREAD_BLOCKS_H_
@@ -0,0 +1,273 @@
+/*
+ * fam_trace.cpp
+ * Copyright (c) 2019 Hewlett Packard Enterprise Development, LP. All rights
+ * reserved. Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ *    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * See https://spdx.org/licenses/BSD-3-Clause
+ *
+ */
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <vector>
+
+#include "common/fam_trace.h"
+
+namespace openfam {
+
+static const char *pointNames[] = {
+#undef FAM_COUNTER
+#define FAM_COUNTER(name) #name,
+#include "fam-api/fam_counters.tbl"
+#undef FAM_COUNTER
+#define FAM_TRACE_POINT(name) #name,
+#include "common/fam_trace.tbl"
+#undef FAM_TRACE_POINT
+};
+
+static const char *phaseNames[] = {"validate", "submit", "wait", "complete"};
+
+std::atomic<bool> Fam_Trace::enabled(false);
+thread_local Fam_Trace_Ring *Fam_Trace::threadRing = NULL;
+
+static pthread_mutex_t traceLock = PTHREAD_MUTEX_INITIALIZER;
+static std::vector<Fam_Trace_Ring *> rings;
+static uint64_t enableCount = 0;
+static int dumpPipe[2] = {-1, -1};
+static pthread_t dumpThread;
+static struct sigaction oldAction;
+
+/*
+ * Hands the ring of a thread back for reuse when the thread exits
+ */
+struct Fam_Trace_Ring_Owner {
+    Fam_Trace_Ring *ring;
+    Fam_Trace_Ring_Owner() : ring(NULL) {}
+    ~Fam_Trace_Ring_Owner() {
+        if (ring)
+            ring->inUse.store(false, std::memory_order_release);
+    }
+};
+
+static thread_local Fam_Trace_Ring_Owner ringOwner;
+
+/*
+ * Returns a ring for the calling thread, reusing one left by an exited
+ * thread. A reused ring starts empty so events are not attributed to the
+ * wrong thread.
+ */
+Fam_Trace_Ring *Fam_Trace::acquire_ring() {
+    Fam_Trace_Ring *ring = NULL;
+    (void)pthread_mutex_lock(&traceLock);
+    for (auto candidate : rings) {
+        if (!candidate->inUse.load(std::memory_order_acquire)) {
+            ring = candidate;
+            break;
+        }
+    }
+    if (ring == NULL) {
+        ring = new Fam_Trace_Ring();
+        rings.push_back(ring);
+    }
+    ring->head.store(0, std::memory_order_relaxed);
+    ring->inUse.store(true, std::memory_order_relaxed);
+    ring->tid = (pid_t)syscall(SYS_gettid);
+    ring->depth = 0;
+    (void)pthread_mutex_unlock(&traceLock);
+
+    ringOwner.ring = ring;
+    return ring;
+}
+
+void Fam_Trace::dump_signal(int signum) {
+    int savedErrno = errno;
+    char request = 'd';
+    // Fails only when the pipe is full of pending dump requests
+    ssize_t ret = write(dumpPipe[1], &request, 1);
+    (void)ret;
+    errno = savedErrno;
+}
+
+/*
+ * Dumps requested from the signal handler are written here, outside of
+ * signal context
+ */
+void *Fam_Trace::dump_handler(void *arg) {
+    char request;
+    char path[64];
+    while (read(dumpPipe[0], &request, 1) == 1) {
+        snprintf(path, sizeof(path), FAM_TRACE_DUMP_FILE, (int)getpid());
+        (void)dump(path);
+    }
+    return NULL;
+}
+
+void Fam_Trace::enable() {
+    (void)pthread_mutex_lock(&traceLock);
+    if (enableCount++ == 0) {
+        if (pipe2(dumpPipe, O_CLOEXEC) == 0) {
+            (void)fcntl(dumpPipe[1], F_SETFL, O_NONBLOCK);
+            if (pthread_create(&dumpThread, NULL, dump_handler, NULL) == 0) {
+                struct sigaction action;
+                memset(&action, 0, sizeof(action));
+                action.sa_handler = dump_signal;
+                action.sa_flags = SA_RESTART;
+                sigemptyset(&action.sa_mask);
+                (void)sigaction(FAM_TRACE_SIGNAL, &action, &oldAction);
+            } else {
+                close(dumpPipe[0]);
+                close(dumpPipe[1]);
+                dumpPipe[0] = dumpPipe[1] = -1;
+            }
+        }
+        enabled.store(true, std::memory_order_relaxed);
+    }
+    (void)pthread_mutex_unlock(&traceLock);
+}
+
+void Fam_Trace::disable() {
+    (void)pthread_mutex_lock(&traceLock);
+    if (enableCount && --enableCount == 0) {
+        enabled.store(false, std::memory_order_relaxed);
+        if (dumpPipe[1] >= 0) {
+            (void)sigaction(FAM_TRACE_SIGNAL, &oldAction, NULL);
+            // The dump thread exits at the end of the pipe
+            close(dumpPipe[1]);
+            (void)pthread_mutex_unlock(&traceLock);
+            (void)pthread_join(dumpThread, NULL);
+            (void)pthread_mutex_lock(&traceLock);
+            close(dumpPipe[0]);
+            dumpPipe[0] = dumpPipe[1] = -1;
+        }
+    }
+    (void)pthread_mutex_unlock(&traceLock);
+}
+
+static void dump_event(FILE *file, bool *first, const char *name,
+                       const char *cat, const char *ph, uint64_t time,
+                       pid_t tid) {
+    fprintf(file, "%s\n{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"%s\","
+                  "\"ts\":%lu.%03lu,\"pid\":%d,\"tid\":%d",
+            *first ? "" : ",", name, cat, ph, time / 1000, time % 1000,
+            (int)getpid(), (int)tid);
+    *first = false;
+}
+
+/*
+ * Write the events of one ring. Every traced call becomes a slice, with a
+ * nested slice for each of its phases; calls still running at the time of
+ * the dump are left open.
+ */
+static void dump_ring(FILE *file, bool *first, pid_t tid,
+                      std::vector<Fam_Trace_Event> &events) {
+    struct Open_Slice {
+        uint16_t point;
+        bool isPhase;
+        const char *name;
+    };
+    std::vector<Open_Slice> stack;
+
+    for (auto &event : events) {
+        if (event.point >= trace_point_max || event.phase > FAM_TRACE_COMPLETE)
+            continue;
+        const char *cat = (event.point < trace_api_max) ? "fam" : "fabric";
+        if (!stack.empty() && stack.back().point == event.point &&
+            stack.back().isPhase) {
+            dump_event(file, first, stack.back().name, cat, "E", event.time,
+                       tid);
+            fprintf(file, "}");
+            stack.pop_back();
+        }
+        bool callOpen = !stack.empty() && stack.back().point == event.point;
+        if (event.phase == FAM_TRACE_COMPLETE) {
+            if (callOpen) {
+                dump_event(file, first, pointNames[event.point], cat, "E",
+                           event.time, tid);
+                fprintf(file, "}");
+                stack.pop_back();
+            }
+            continue;
+        }
+        if (!callOpen) {
+            dump_event(file, first, pointNames[event.point], cat, "B",
+                       event.time, tid);
+            if (event.point < trace_api_max) {
+                fprintf(file, ",\"args\":{\"memory_server\":");
+                if (event.memserverId == UINT32_MAX)
+                    fprintf(file, "null");
+                else
+                    fprintf(file, "%u", event.memserverId);
+                fprintf(file, ",\"region\":%lu,", event.object);
+            } else {
+                fprintf(file, ",\"args\":{\"key\":%lu,", event.object);
+            }
+            fprintf(file, "\"offset\":%lu,\"bytes\":%lu}}", event.offset,
+                    event.bytes);
+            stack.push_back({event.point, false, pointNames[event.point]});
+        }
+        dump_event(file, first, phaseNames[event.phase], cat, "B", event.time,
+                   tid);
+        fprintf(file, "}");
+        stack.push_back({event.point, true, phaseNames[event.phase]});
+    }
+}
+
+int Fam_Trace::dump(const char *path) {
+    FILE *file = fopen(path, "w");
+    if (file == NULL)
+        return -1;
+
+    bool first = true;
+    fprintf(file, "{\"traceEvents\":[");
+    std::vector<Fam_Trace_Event> events;
+    (void)pthread_mutex_lock(&traceLock);
+    for (auto ring : rings) {
+        uint64_t head = ring->head.load(std::memory_order_acquire);
+        uint64_t start =
+            (head > FAM_TRACE_RING_EVENTS) ? head - FAM_TRACE_RING_EVENTS : 0;
+        events.clear();
+        for (uint64_t i = start; i < head; i++)
+            events.push_back(ring->events[i & (FAM_TRACE_RING_EVENTS - 1)]);
+
+        // Drop the events the owner may have overwritten meanwhile
+        uint64_t newHead = ring->head.load(std::memory_order_acquire);
+        if (newHead >= start + FAM_TRACE_RING_EVENTS) {
+            uint64_t overwritten = newHead - FAM_TRACE_RING_EVENTS + 1 - start;
+            if (overwritten > events.size())
+                overwritten = events.size();
+            events.erase(events.begin(),
+                         events.begin() + (int64_t)overwritten);
+        }
+        dump_ring(file, &first, ring->tid, events);
+    }
+    (void)pthread_mutex_unlock(&traceLock);
+    fprintf(file, "\n],\"displayTimeUnit\":\"ns\"}\n");
+
+    return (fclose(file) == 0) ? 0 : -1;
+}
+
+} // namespace openfam
@@ -0,0 +1,268 @@
+/*
+ * fam_trace.h
+ * Copyright (c) 2019 Hewlett Packard Enterprise Development, LP. All rights
+ * reserved. Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ *    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * See https://spdx.org/licenses/BSD-3-Clause
+ *
+ */
+#ifndef FAM_TRACE_H
+#define FAM_TRACE_H
+
+#include <atomic>
+#include <pthread.h>
+#include <signal.h>
+#include <stdint.h>
+#include <sys/types.h>
+#include <time.h>
+
+#include "fam/fam.h"
+
+/*
+ * Events kept per thread; older events are overwritten
+ */
+#define FAM_TRACE_RING_EVENTS 16384
+
+/*
+ * Nesting of traced calls tracked per thread, which is enough for an API
+ * call and the fabric operations it issues
+ */
+#define FAM_TRACE_MAX_DEPTH 8
+
+/*
+ * Signal that dumps the trace to FAM_TRACE_DUMP_FILE while tracing is on
+ */
+#define FAM_TRACE_SIGNAL SIGUSR2
+#define FAM_TRACE_DUMP_FILE "fam_trace.%d.json"
+
+namespace openfam {
+
+/*
+ * Traced calls: the entry points of fam::Impl_, followed by the fabric
+ * operations of fam_libfabric.cpp
+ */
+typedef enum {
+#undef FAM_COUNTER
+#define FAM_COUNTER(name) trace_##name,
+#include "fam-api/fam_counters.tbl"
+#undef FAM_COUNTER
+    trace_api_max,
+    // Fabric operations are numbered from trace_api_max on
+    trace_api_last = trace_api_max - 1,
+#define FAM_TRACE_POINT(name) trace_##name,
+#include "common/fam_trace.tbl"
+#undef FAM_TRACE_POINT
+    trace_point_max
+} Fam_Trace_Point;
+
+/*
+ * Phase of a traced call that starts with the event. A call ends with
+ * FAM_TRACE_COMPLETE; the other phases last until the next event of the
+ * same call.
+ */
+typedef enum {
+    /** Checking the descriptor, including requests to memory servers */
+    FAM_TRACE_VALIDATE = 0,
+    /** Posting the operation */
+    FAM_TRACE_SUBMIT,
+    /** Waiting for completions, transmit credits or retries */
+    FAM_TRACE_WAIT,
+    /** End of the call */
+    FAM_TRACE_COMPLETE
+} Fam_Trace_Phase;
+
+struct Fam_Trace_Event {
+    uint64_t time;
+    uint16_t point;
+    uint8_t phase;
+    // Memory server id truncated to 32 bits, all ones if there is none
+    uint32_t memserverId;
+    // Region id for API calls, memory key for fabric operations
+    uint64_t object;
+    uint64_t offset;
+    uint64_t bytes;
+};
+
+/*
+ * Events of one thread. Only the owner thread writes events, then
+ * publishes them by advancing head; a dump copies the published events and
+ * drops the ones overwritten while it copied them.
+ */
+struct Fam_Trace_Ring {
+    std::atomic<uint64_t> head;
+    std::atomic<bool> inUse;
+    pid_t tid;
+    uint32_t depth;
+    uint16_t open[FAM_TRACE_MAX_DEPTH];
+    Fam_Trace_Event events[FAM_TRACE_RING_EVENTS];
+};
+
+/*
+ * Process wide trace of OpenFAM calls, enabled with the FAM_TRACE option.
+ * Recording an event costs a clock read and a few stores into a ring
+ * private to the calling thread. The trace is written as Chrome trace-event
+ * JSON by dump(), or on FAM_TRACE_SIGNAL.
+ */
+class Fam_Trace {
+  public:
+    static bool is_enabled() {
+        return enabled.load(std::memory_order_relaxed);
+    }
+
+    static void enable();
+
+    static void disable();
+
+    static void record(Fam_Trace_Point point, Fam_Trace_Phase phase,
+                       uint64_t memserverId, uint64_t object, uint64_t offset,
+                       uint64_t bytes) {
+        Fam_Trace_Ring *ring = get_ring();
+        uint64_t head = ring->head.load(std::memory_order_relaxed);
+        Fam_Trace_Event *event =
+            &ring->events[head & (FAM_TRACE_RING_EVENTS - 1)];
+        struct timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        event->time = (uint64_t)now.tv_sec * 1000000000ULL +
+                      (uint64_t)now.tv_nsec;
+        event->point = (uint16_t)point;
+        event->phase = (uint8_t)phase;
+        event->memserverId = (uint32_t)memserverId;
+        event->object = object;
+        event->offset = offset;
+        event->bytes = bytes;
+        ring->head.store(head + 1, std::memory_order_release);
+    }
+
+    /*
+     * Start a new phase of the innermost traced call of the thread, for
+     * code that waits or retries on behalf of whichever operation runs
+     */
+    static void phase(Fam_Trace_Phase phase) {
+        if (!is_enabled())
+            return;
+        Fam_Trace_Ring *ring = get_ring();
+        if (ring->depth == 0 || ring->depth > FAM_TRACE_MAX_DEPTH)
+            return;
+        record((Fam_Trace_Point)ring->open[ring->depth - 1], phase,
+               FAM_STATS_NO_MEMSERVER, 0, 0, 0);
+    }
+
+    static void push(Fam_Trace_Point point) {
+        Fam_Trace_Ring *ring = get_ring();
+        if (ring->depth < FAM_TRACE_MAX_DEPTH)
+            ring->open[ring->depth] = (uint16_t)point;
+        ring->depth++;
+    }
+
+    static void pop() { get_ring()->depth--; }
+
+    /*
+     * Write the events of all threads to path as Chrome trace-event JSON
+     * @return - 0 on success, -1 if the file could not be written
+     */
+    static int dump(const char *path);
+
+  private:
+    static Fam_Trace_Ring *get_ring() {
+        if (threadRing == NULL)
+            threadRing = acquire_ring();
+        return threadRing;
+    }
+
+    static Fam_Trace_Ring *acquire_ring();
+    static void *dump_handler(void *arg);
+    static void dump_signal(int signum);
+
+    static std::atomic<bool> enabled;
+    static thread_local Fam_Trace_Ring *threadRing;
+};
+
+/*
+ * Traces the enclosing call from construction, in the given phase, to the
+ * end of the scope; does nothing while tracing is off
+ */
+class Fam_Trace_Scope {
+  public:
+    Fam_Trace_Scope(Fam_Trace_Point point,
+                    Fam_Trace_Phase phase = FAM_TRACE_VALIDATE,
+                    uint64_t object = 0, uint64_t offset = 0,
+                    uint64_t bytes = 0)
+        : tracePoint(point), active(Fam_Trace::is_enabled()) {
+        if (active)
+            begin(phase, FAM_STATS_NO_MEMSERVER, object, offset, bytes);
+    }
+
+    Fam_Trace_Scope(Fam_Trace_Point point, Fam_Descriptor *descriptor,
+                    uint64_t offset = 0, uint64_t bytes = 0)
+        : tracePoint(point), active(Fam_Trace::is_enabled()) {
+        if (active) {
+            uint64_t memserverId = FAM_STATS_NO_MEMSERVER, regionId = 0;
+            if (descriptor) {
+                memserverId = descriptor->get_memserver_id();
+                regionId = descriptor->get_global_descriptor().regionId;
+            }
+            begin(FAM_TRACE_VALIDATE, memserverId, regionId, offset, bytes);
+        }
+    }
+
+    Fam_Trace_Scope(Fam_Trace_Point point, Fam_Region_Descriptor *descriptor)
+        : tracePoint(point), active(Fam_Trace::is_enabled()) {
+        if (active) {
+            uint64_t memserverId = FAM_STATS_NO_MEMSERVER, regionId = 0;
+            if (descriptor) {
+                memserverId = descriptor->get_memserver_id();
+                regionId = descriptor->get_global_descriptor().regionId;
+            }
+            begin(FAM_TRACE_VALIDATE, memserverId, regionId, 0, 0);
+        }
+    }
+
+    ~Fam_Trace_Scope() {
+        if (active) {
+            Fam_Trace::record(tracePoint, FAM_TRACE_COMPLETE,
+                              FAM_STATS_NO_MEMSERVER, 0, 0, 0);
+            Fam_Trace::pop();
+        }
+    }
+
+    void submit() {
+        if (active)
+            Fam_Trace::record(tracePoint, FAM_TRACE_SUBMIT,
+                              FAM_STATS_NO_MEMSERVER, 0, 0, 0);
+    }
+
+  private:
+    void begin(Fam_Trace_Phase phase, uint64_t memserverId, uint64_t object,
+               uint64_t offset, uint64_t bytes) {
+        Fam_Trace::push(tracePoint);
+        Fam_Trace::record(tracePoint, phase, memserverId, object, offset,
+                          bytes);
+    }
+
+    Fam_Trace_Point tracePoint;
+    bool active;
+};
+
+} // namespace openfam
+#endif
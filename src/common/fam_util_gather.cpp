@@ -0,0 +1,460 @@
+/*
+ * fam_util_gather.cpp
+ * Copyright (c) 2019 Hewlett Packard Enterprise Development, LP. All rights
+ * reserved. Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ *    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * See https://spdx.org/licenses/BSD-3-Clause
+ *
+ */
+
+#include <limits.h>
+#include <string.h>
+
+#include "common/fam_internal.h"
+#include "common/fam_util_gather.h"
+#include "common/fam_util_simd.h"
+
+#ifdef FAM_UTIL_SIMD
+#include <immintrin.h>
+#endif
+
+/*
+ * Number of elements ahead of the current one that index kernels
+ * prefetch. Strided accesses are left to the hardware prefetcher.
+ */
+#define FAM_GATHER_PREFETCH_DIST 16
+
+#define FAM_GATHER_LINE_SIZE 64
+
+namespace openfam {
+
+/*
+ * Accumulates the address range written by a scatter, so that elements
+ * on the same or adjacent cache lines are flushed or logged together.
+ */
+class Persist_Range {
+  public:
+    Persist_Range(Fam_Persist_Log *log)
+        : start(NULL), end(NULL), persistLog(log) {}
+
+    void add(char *addr, uint64_t size) {
+        char *lineEnd = (char *)(((uint64_t)end + FAM_GATHER_LINE_SIZE - 1) &
+                                 ~((uint64_t)FAM_GATHER_LINE_SIZE - 1));
+        if (start && (addr >= start) && (addr <= lineEnd)) {
+            if (addr + size > end)
+                end = addr + size;
+            return;
+        }
+        flush();
+        start = addr;
+        end = addr + size;
+    }
+
+    void flush() {
+        if (start) {
+            if (persistLog)
+                persistLog->add(start, (uint64_t)(end - start));
+            else
+                openfam_flush(start, (uint64_t)(end - start));
+        }
+        start = NULL;
+    }
+
+    /* Flush the last range and wait for all write-backs */
+    void persist() {
+        flush();
+        if (!persistLog)
+            openfam_persist_fence();
+    }
+
+  private:
+    char *start;
+    char *end;
+    Fam_Persist_Log *persistLog;
+};
+
+/*
+ * Scalar kernels. SIZE is the element size, or 0 when it is only known
+ * at run time, in which case size is used.
+ */
+template <uint64_t SIZE>
+static void gather_stride_kernel(char *out, const char *in, uint64_t nElements,
+                                 uint64_t strideBytes, uint64_t size) {
+    const uint64_t len = SIZE ? SIZE : size;
+    for (uint64_t i = 0; i < nElements; i++)
+        memcpy(out + i * len, in + i * strideBytes, len);
+}
+
+template <uint64_t SIZE>
+static void gather_index_kernel(char *out, const char *base,
+                                uint64_t nElements, const uint64_t *index,
+                                uint64_t size) {
+    const uint64_t len = SIZE ? SIZE : size;
+    for (uint64_t i = 0; i < nElements; i++) {
+        if (i + FAM_GATHER_PREFETCH_DIST < nElements)
+            __builtin_prefetch(
+                base + index[i + FAM_GATHER_PREFETCH_DIST] * len, 0, 0);
+        memcpy(out + i * len, base + index[i] * len, len);
+    }
+}
+
+template <uint64_t SIZE>
+static void scatter_stride_kernel(char *out, const char *in,
+                                  uint64_t nElements, uint64_t strideBytes,
+                                  uint64_t size, Fam_Persist_Log *persistLog) {
+    const uint64_t len = SIZE ? SIZE : size;
+    Persist_Range range(persistLog);
+    for (uint64_t i = 0; i < nElements; i++) {
+        char *dest = out + i * strideBytes;
+        memcpy(dest, in + i * len, len);
+        range.add(dest, len);
+    }
+    range.persist();
+}
+
+template <uint64_t SIZE>
+static void scatter_index_kernel(char *base, const char *in,
+                                 uint64_t nElements, const uint64_t *index,
+                                 uint64_t size, Fam_Persist_Log *persistLog) {
+    const uint64_t len = SIZE ? SIZE : size;
+    Persist_Range range(persistLog);
+    for (uint64_t i = 0; i < nElements; i++) {
+        if (i + FAM_GATHER_PREFETCH_DIST < nElements)
+            __builtin_prefetch(
+                base + index[i + FAM_GATHER_PREFETCH_DIST] * len, 1, 0);
+        char *dest = base + index[i] * len;
+        memcpy(dest, in + i * len, len);
+        range.add(dest, len);
+    }
+    range.persist();
+}
+
+#ifdef FAM_UTIL_SIMD
+/*
+ * Vector gather kernels. Each handles whole vectors and leaves the
+ * remaining elements to the scalar kernel. Stride kernels use 32-bit
+ * byte offsets for 4 byte elements, so the caller checks that a vector
+ * of offsets fits.
+ */
+static inline void prefetch_index(const char *base, const uint64_t *index,
+                                  uint64_t from, uint64_t count,
+                                  uint64_t nElements, uint64_t size) {
+    for (uint64_t j = from; (j < from + count) && (j < nElements); j++)
+        __builtin_prefetch(base + index[j] * size, 0, 0);
+}
+
+__attribute__((target("avx2"))) static void
+gather_index_avx2_4(char *out, const char *base, uint64_t nElements,
+                    const uint64_t *index) {
+    uint64_t i = 0;
+    for (; i + 4 <= nElements; i += 4) {
+        prefetch_index(base, index, i + FAM_GATHER_PREFETCH_DIST, 4,
+                       nElements, 4);
+        __m256i idx = _mm256_loadu_si256((const __m256i *)(index + i));
+        __m128i val = _mm256_i64gather_epi32((const int *)base, idx, 4);
+        _mm_storeu_si128((__m128i *)(out + i * 4), val);
+    }
+    gather_index_kernel<4>(out + i * 4, base, nElements - i, index + i, 4);
+}
+
+__attribute__((target("avx2"))) static void
+gather_index_avx2_8(char *out, const char *base, uint64_t nElements,
+                    const uint64_t *index) {
+    uint64_t i = 0;
+    for (; i + 4 <= nElements; i += 4) {
+        prefetch_index(base, index, i + FAM_GATHER_PREFETCH_DIST, 4,
+                       nElements, 8);
+        __m256i idx = _mm256_loadu_si256((const __m256i *)(index + i));
+        __m256i val =
+            _mm256_i64gather_epi64((const long long *)base, idx, 8);
+        _mm256_storeu_si256((__m256i *)(out + i * 8), val);
+    }
+    gather_index_kernel<8>(out + i * 8, base, nElements - i, index + i, 8);
+}
+
+__attribute__((target("avx2"))) static void
+gather_stride_avx2_4(char *out, const char *in, uint64_t nElements,
+                     uint64_t strideBytes) {
+    int s = (int)strideBytes;
+    __m256i offsets =
+        _mm256_setr_epi32(0, s, 2 * s, 3 * s, 4 * s, 5 * s, 6 * s, 7 * s);
+    uint64_t i = 0;
+    for (; i + 8 <= nElements; i += 8) {
+        __m256i val = _mm256_i32gather_epi32(
+            (const int *)(in + i * strideBytes), offsets, 1);
+        _mm256_storeu_si256((__m256i *)(out + i * 4), val);
+    }
+    gather_stride_kernel<4>(out + i * 4, in + i * strideBytes, nElements - i,
+                            strideBytes, 4);
+}
+
+__attribute__((target("avx2"))) static void
+gather_stride_avx2_8(char *out, const char *in, uint64_t nElements,
+                     uint64_t strideBytes) {
+    long long s = (long long)strideBytes;
+    __m256i offsets = _mm256_setr_epi64x(0, s, 2 * s, 3 * s);
+    uint64_t i = 0;
+    for (; i + 4 <= nElements; i += 4) {
+        __m256i val = _mm256_i64gather_epi64(
+            (const long long *)(in + i * strideBytes), offsets, 1);
+        _mm256_storeu_si256((__m256i *)(out + i * 8), val);
+    }
+    gather_stride_kernel<8>(out + i * 8, in + i * strideBytes, nElements - i,
+                            strideBytes, 8);
+}
+
+// The AVX-512 gathers use the masked forms with a zeroed source and every
+// lane enabled, as GCC reports the unmasked forms as reading an
+// uninitialized source.
+__attribute__((target("avx512f"))) static void
+gather_index_avx512_4(char *out, const char *base, uint64_t nElements,
+                      const uint64_t *index) {
+    uint64_t i = 0;
+    for (; i + 8 <= nElements; i += 8) {
+        prefetch_index(base, index, i + FAM_GATHER_PREFETCH_DIST, 8,
+                       nElements, 4);
+        __m512i idx = _mm512_loadu_si512((const void *)(index + i));
+        __m256i val = _mm512_mask_i64gather_epi32(
+            _mm256_setzero_si256(), (__mmask8)0xff, idx, (const void *)base, 4);
+        _mm256_storeu_si256((__m256i *)(out + i * 4), val);
+    }
+    gather_index_kernel<4>(out + i * 4, base, nElements - i, index + i, 4);
+}
+
+__attribute__((target("avx512f"))) static void
+gather_index_avx512_8(char *out, const char *base, uint64_t nElements,
+                      const uint64_t *index) {
+    uint64_t i = 0;
+    for (; i + 8 <= nElements; i += 8) {
+        prefetch_index(base, index, i + FAM_GATHER_PREFETCH_DIST, 8,
+                       nElements, 8);
+        __m512i idx = _mm512_loadu_si512((const void *)(index + i));
+        __m512i val = _mm512_mask_i64gather_epi64(
+            _mm512_setzero_si512(), (__mmask8)0xff, idx, (const void *)base, 8);
+        _mm512_storeu_si512((void *)(out + i * 8), val);
+    }
+    gather_index_kernel<8>(out + i * 8, base, nElements - i, index + i, 8);
+}
+
+__attribute__((target("avx512f"))) static void
+gather_stride_avx512_4(char *out, const char *in, uint64_t nElements,
+                       uint64_t strideBytes) {
+    int s = (int)strideBytes;
+    __m512i offsets = _mm512_setr_epi32(
+        0, s, 2 * s, 3 * s, 4 * s, 5 * s, 6 * s, 7 * s, 8 * s, 9 * s, 10 * s,
+        11 * s, 12 * s, 13 * s, 14 * s, 15 * s);
+    uint64_t i = 0;
+    for (; i + 16 <= nElements; i += 16) {
+        __m512i val = _mm512_mask_i32gather_epi32(
+            _mm512_setzero_si512(), (__mmask16)0xffff, offsets,
+            (const void *)(in + i * strideBytes), 1);
+        _mm512_storeu_si512((void *)(out + i * 4), val);
+    }
+    gather_stride_kernel<4>(out + i * 4, in + i * strideBytes, nElements - i,
+                            strideBytes, 4);
+}
+
+__attribute__((target("avx512f"))) static void
+gather_stride_avx512_8(char *out, const char *in, uint64_t nElements,
+                       uint64_t strideBytes) {
+    long long s = (long long)strideBytes;
+    __m512i offsets =
+        _mm512_setr_epi64(0, s, 2 * s, 3 * s, 4 * s, 5 * s, 6 * s, 7 * s);
+    uint64_t i = 0;
+    for (; i + 8 <= nElements; i += 8) {
+        __m512i val = _mm512_mask_i64gather_epi64(
+            _mm512_setzero_si512(), (__mmask8)0xff, offsets,
+            (const void *)(in + i * strideBytes), 1);
+        _mm512_storeu_si512((void *)(out + i * 8), val);
+    }
+    gather_stride_kernel<8>(out + i * 8, in + i * strideBytes, nElements - i,
+                            strideBytes, 8);
+}
+#endif
+
+void fam_gather_stride(void *local, void *base, uint64_t nElements,
+                       uint64_t firstElement, uint64_t stride,
+                       uint64_t elementSize) {
+    char *out = (char *)local;
+    const char *in = (const char *)base + firstElement * elementSize;
+    uint64_t strideBytes = stride * elementSize;
+
+#ifdef USE_FAM_INVALIDATE
+    for (uint64_t i = 0; i < nElements; i++)
+        openfam_invalidate((void *)(in + i * strideBytes), elementSize);
+#endif
+
+    // Contiguous elements need a single copy
+    if (stride == 1) {
+        memcpy(out, in, nElements * elementSize);
+        return;
+    }
+
+    switch (elementSize) {
+    case 4:
+#ifdef FAM_UTIL_SIMD
+        if ((fam_simd_level() == SIMD_AVX512) &&
+            (strideBytes <= INT_MAX / 16)) {
+            gather_stride_avx512_4(out, in, nElements, strideBytes);
+            return;
+        }
+        if ((fam_simd_level() >= SIMD_AVX2) && (strideBytes <= INT_MAX / 8)) {
+            gather_stride_avx2_4(out, in, nElements, strideBytes);
+            return;
+        }
+#endif
+        gather_stride_kernel<4>(out, in, nElements, strideBytes, 4);
+        break;
+    case 8:
+#ifdef FAM_UTIL_SIMD
+        if (fam_simd_level() == SIMD_AVX512) {
+            gather_stride_avx512_8(out, in, nElements, strideBytes);
+            return;
+        }
+        if (fam_simd_level() >= SIMD_AVX2) {
+            gather_stride_avx2_8(out, in, nElements, strideBytes);
+            return;
+        }
+#endif
+        gather_stride_kernel<8>(out, in, nElements, strideBytes, 8);
+        break;
+    case 16:
+        gather_stride_kernel<16>(out, in, nElements, strideBytes, 16);
+        break;
+    default:
+        gather_stride_kernel<0>(out, in, nElements, strideBytes, elementSize);
+        break;
+    }
+}
+
+void fam_gather_index(void *local, void *base, uint64_t nElements,
+                      uint64_t *elementIndex, uint64_t elementSize) {
+    char *out = (char *)local;
+    const char *in = (const char *)base;
+
+#ifdef USE_FAM_INVALIDATE
+    for (uint64_t i = 0; i < nElements; i++)
+        openfam_invalidate((void *)(in + elementIndex[i] * elementSize),
+                           elementSize);
+#endif
+
+    switch (elementSize) {
+    case 4:
+#ifdef FAM_UTIL_SIMD
+        if (fam_simd_level() == SIMD_AVX512) {
+            gather_index_avx512_4(out, in, nElements, elementIndex);
+            return;
+        }
+        if (fam_simd_level() >= SIMD_AVX2) {
+            gather_index_avx2_4(out, in, nElements, elementIndex);
+            return;
+        }
+#endif
+        gather_index_kernel<4>(out, in, nElements, elementIndex, 4);
+        break;
+    case 8:
+#ifdef FAM_UTIL_SIMD
+        if (fam_simd_level() == SIMD_AVX512) {
+            gather_index_avx512_8(out, in, nElements, elementIndex);
+            return;
+        }
+        if (fam_simd_level() >= SIMD_AVX2) {
+            gather_index_avx2_8(out, in, nElements, elementIndex);
+            return;
+        }
+#endif
+        gather_index_kernel<8>(out, in, nElements, elementIndex, 8);
+        break;
+    case 16:
+        gather_index_kernel<16>(out, in, nElements, elementIndex, 16);
+        break;
+    default:
+        gather_index_kernel<0>(out, in, nElements, elementIndex, elementSize);
+        break;
+    }
+}
+
+void fam_scatter_stride(void *local, void *base, uint64_t nElements,
+                        uint64_t firstElement, uint64_t stride,
+                        uint64_t elementSize, Fam_Persist_Log *persistLog) {
+    const char *in = (const char *)local;
+    char *out = (char *)base + firstElement * elementSize;
+    uint64_t strideBytes = stride * elementSize;
+
+    // Contiguous elements need a single copy and persist
+    if (stride == 1) {
+        Persist_Range range(persistLog);
+        memcpy(out, in, nElements * elementSize);
+        range.add(out, nElements * elementSize);
+        range.persist();
+        return;
+    }
+
+    switch (elementSize) {
+    case 4:
+        scatter_stride_kernel<4>(out, in, nElements, strideBytes, 4,
+                                 persistLog);
+        break;
+    case 8:
+        scatter_stride_kernel<8>(out, in, nElements, strideBytes, 8,
+                                 persistLog);
+        break;
+    case 16:
+        scatter_stride_kernel<16>(out, in, nElements, strideBytes, 16,
+                                  persistLog);
+        break;
+    default:
+        scatter_stride_kernel<0>(out, in, nElements, strideBytes, elementSize,
+                                 persistLog);
+        break;
+    }
+}
+
+void fam_scatter_index(void *local, void *base, uint64_t nElements,
+                       uint64_t *elementIndex, uint64_t elementSize,
+                       Fam_Persist_Log *persistLog) {
+    const char *in = (const char *)local;
+    char *out = (char *)base;
+
+    switch (elementSize) {
+    case 4:
+        scatter_index_kernel<4>(out, in, nElements, elementIndex, 4,
+                                persistLog);
+        break;
+    case 8:
+        scatter_index_kernel<8>(out, in, nElements, elementIndex, 8,
+                                persistLog);
+        break;
+    case 16:
+        scatter_index_kernel<16>(out, in, nElements, elementIndex, 16,
+                                 persistLog);
+        break;
+    default:
+        scatter_index_kernel<0>(out, in, nElements, elementIndex, elementSize,
+                                persistLog);
+        break;
+    }
+}
+
+} // namespace openfam
@@ -0,0 +1,66 @@
+/*
+ * fam_util_gather.h
+ * Copyright (c) 2019 Hewlett Packard Enterprise Development, LP. All rights
+ * reserved. Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ *    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * See https://spdx.org/licenses/BSD-3-Clause
+ *
+ */
+#ifndef FAM_UTIL_GATHER_H
+#define FAM_UTIL_GATHER_H
+
+#include <stdint.h>
+
+#include "common/fam_util_persist.h"
+
+namespace openfam {
+
+/*
+ * Copy kernels for the gather and scatter operations of NVMM mode and of
+ * memory servers co-located with the PE. Elements of 4, 8 and 16 bytes use kernels specialized for the
+ * element size; gathers of 4 and 8 byte elements use AVX2 or AVX-512
+ * gather instructions when the CPU supports them. The caller checks
+ * bounds and permissions.
+ */
+void fam_gather_stride(void *local, void *base, uint64_t nElements,
+                       uint64_t firstElement, uint64_t stride,
+                       uint64_t elementSize);
+void fam_gather_index(void *local, void *base, uint64_t nElements,
+                      uint64_t *elementIndex, uint64_t elementSize);
+
+/*
+ * Scatter kernels write back the cache lines of the written elements,
+ * merging elements on adjacent lines into one range, and fence once at
+ * the end. With a persist log the ranges are recorded for fam_quiet
+ * instead.
+ */
+void fam_scatter_stride(void *local, void *base, uint64_t nElements,
+                        uint64_t firstElement, uint64_t stride,
+                        uint64_t elementSize, Fam_Persist_Log *persistLog);
+void fam_scatter_index(void *local, void *base, uint64_t nElements,
+                       uint64_t *elementIndex, uint64_t elementSize,
+                       Fam_Persist_Log *persistLog);
+
+} // namespace openfam
+#endif
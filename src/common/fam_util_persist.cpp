@@ -0,0 +1,114 @@
+/*
+ * fam_util_persist.cpp
+ * Copyright (c) 2019 Hewlett Packard Enterprise Development, LP. All rights
+ * reserved. Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ *    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * See https://spdx.org/licenses/BSD-3-Clause
+ *
+ */
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#include <cpuid.h>
+#include <immintrin.h>
+#define FAM_PERSIST_X86
+#endif
+
+#include "common/fam_util_persist.h"
+
+namespace openfam {
+
+#ifdef FAM_PERSIST_X86
+#define FAM_PERSIST_LINE_SIZE 64
+
+typedef enum {
+    FLUSH_CLFLUSH = 0,
+    FLUSH_CLFLUSHOPT,
+    FLUSH_CLWB
+} Fam_Flush_Insn;
+
+/*
+ * clwb writes a line back and keeps it cached, clflushopt evicts it; both
+ * are weakly ordered and need a fence. clflush is ordered by itself.
+ */
+static Fam_Flush_Insn flush_insn() {
+    static const Fam_Flush_Insn insn = []() {
+        unsigned int eax, ebx, ecx, edx;
+        if (!__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx))
+            return FLUSH_CLFLUSH;
+        if (ebx & bit_CLWB)
+            return FLUSH_CLWB;
+        if (ebx & bit_CLFLUSHOPT)
+            return FLUSH_CLFLUSHOPT;
+        return FLUSH_CLFLUSH;
+    }();
+    return insn;
+}
+
+__attribute__((target("clwb"))) static void flush_clwb(char *line,
+                                                       char *end) {
+    for (; line < end; line += FAM_PERSIST_LINE_SIZE)
+        _mm_clwb(line);
+}
+
+__attribute__((target("clflushopt"))) static void
+flush_clflushopt(char *line, char *end) {
+    for (; line < end; line += FAM_PERSIST_LINE_SIZE)
+        _mm_clflushopt(line);
+}
+
+static void flush_clflush(char *line, char *end) {
+    for (; line < end; line += FAM_PERSIST_LINE_SIZE)
+        _mm_clflush(line);
+}
+
+void openfam_flush(void *addr, uint64_t size) {
+    if (!size)
+        return;
+    char *line =
+        (char *)((uint64_t)addr & ~((uint64_t)FAM_PERSIST_LINE_SIZE - 1));
+    char *end = (char *)addr + size;
+    switch (flush_insn()) {
+    case FLUSH_CLWB:
+        flush_clwb(line, end);
+        break;
+    case FLUSH_CLFLUSHOPT:
+        flush_clflushopt(line, end);
+        break;
+    case FLUSH_CLFLUSH:
+        flush_clflush(line, end);
+        break;
+    }
+}
+
+void openfam_persist_fence() { _mm_sfence(); }
+#else
+/*
+ * Elsewhere fam_persist flushes and fences each range itself
+ */
+void openfam_flush(void *addr, uint64_t size) { fam_persist(addr, size); }
+
+void openfam_persist_fence() {}
+#endif
+
+} // namespace openfam
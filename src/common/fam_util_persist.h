@@ -0,0 +1,85 @@
+/*
+ * fam_util_persist.h
+ * Copyright (c) 2019 Hewlett Packard Enterprise Development, LP. All rights
+ * reserved. Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ *    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * See https://spdx.org/licenses/BSD-3-Clause
+ *
+ */
+#ifndef FAM_UTIL_PERSIST_H
+#define FAM_UTIL_PERSIST_H
+
+#include <atomic>
+#include <stdint.h>
+
+#include "common/fam_internal.h"
+
+/*
+ * Number of ranges a context records before further deferred writes are
+ * flushed as they are made
+ */
+#define FAM_PERSIST_LOG_SIZE 256
+
+namespace openfam {
+
+/*
+ * Ranges written through a context in FAM_PERSIST_DEFERRED mode. Writers
+ * record ranges concurrently; persist() is called with no writer active,
+ * from fam_quiet while it holds the context write lock.
+ */
+class Fam_Persist_Log {
+  public:
+    Fam_Persist_Log() : numRanges(0) {}
+
+    void add(void *addr, uint64_t size) {
+        uint64_t slot = numRanges.fetch_add(1, std::memory_order_relaxed);
+        if (slot < FAM_PERSIST_LOG_SIZE) {
+            ranges[slot].addr = addr;
+            ranges[slot].size = size;
+        } else {
+            openfam_flush(addr, size);
+        }
+    }
+
+    /* Write back all recorded ranges and fence once */
+    void persist() {
+        uint64_t count = numRanges.load(std::memory_order_acquire);
+        if (count > FAM_PERSIST_LOG_SIZE)
+            count = FAM_PERSIST_LOG_SIZE;
+        for (uint64_t i = 0; i < count; i++)
+            openfam_flush(ranges[i].addr, ranges[i].size);
+        openfam_persist_fence();
+        numRanges.store(0, std::memory_order_release);
+    }
+
+  private:
+    struct {
+        void *addr;
+        uint64_t size;
+    } ranges[FAM_PERSIST_LOG_SIZE];
+    std::atomic<uint64_t> numRanges;
+};
+
+} // namespace openfam
+#endif
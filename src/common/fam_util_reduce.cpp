@@ -0,0 +1,275 @@
+/*
+ * fam_util_reduce.cpp
+ * Copyright (c) 2019 Hewlett Packard Enterprise Development, LP. All rights
+ * reserved. Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ *    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * See https://spdx.org/licenses/BSD-3-Clause
+ *
+ */
+
+#include <string.h>
+#include <thread>
+#include <vector>
+
+#include "common/fam_util_reduce.h"
+#include "common/fam_util_simd.h"
+
+namespace openfam {
+
+template <typename A, Fam_Reduce_Op OP> static inline A combine(A x, A y) {
+    if (OP == FAM_REDUCE_SUM)
+        return x + y;
+    if (OP == FAM_REDUCE_MIN)
+        return (y < x) ? y : x;
+    return (y > x) ? y : x;
+}
+
+/*
+ * Reduces n elements of type T into an accumulator of type A, which is
+ * wider than T for sums. LANES elements are converted to A and combined
+ * with LANES independent accumulators at once, using GCC vector types that
+ * compile to the vector instructions of the enclosing target. The lanes are
+ * combined at the end, so floating point sums are not accumulated in
+ * element order.
+ */
+template <typename T, typename A, Fam_Reduce_Op OP, int LANES>
+static inline __attribute__((always_inline)) A
+reduce_block(const T *in, uint64_t n, A init) {
+    typedef T Element_Vector __attribute__((vector_size(LANES * sizeof(T))));
+    typedef A Acc_Vector __attribute__((vector_size(LANES * sizeof(A))));
+
+    Acc_Vector acc;
+    for (int l = 0; l < LANES; l++)
+        acc[l] = init;
+    uint64_t i = 0;
+    for (; i + LANES <= n; i += LANES) {
+        Element_Vector elements;
+        memcpy(&elements, in + i, sizeof(elements));
+        Acc_Vector x = __builtin_convertvector(elements, Acc_Vector);
+        if (OP == FAM_REDUCE_SUM)
+            acc += x;
+        else if (OP == FAM_REDUCE_MIN)
+            acc = (x < acc) ? x : acc;
+        else
+            acc = (x > acc) ? x : acc;
+    }
+
+    A result = init;
+    if (i) {
+        result = acc[0];
+        for (int l = 1; l < LANES; l++)
+            result = combine<A, OP>(result, acc[l]);
+    }
+    for (; i < n; i++)
+        result = combine<A, OP>(result, (A)in[i]);
+    return result;
+}
+
+#ifdef FAM_UTIL_SIMD
+template <typename T, typename A, Fam_Reduce_Op OP>
+__attribute__((target("avx512f"))) static A
+reduce_avx512(const T *in, uint64_t n, A init) {
+    return reduce_block<T, A, OP, 16>(in, n, init);
+}
+
+template <typename T, typename A, Fam_Reduce_Op OP>
+__attribute__((target("avx2"))) static A reduce_avx2(const T *in, uint64_t n,
+                                                     A init) {
+    return reduce_block<T, A, OP, 8>(in, n, init);
+}
+#endif
+
+template <typename T, typename A, Fam_Reduce_Op OP>
+static A reduce_range(const T *in, uint64_t n, A init) {
+#ifdef FAM_UTIL_SIMD
+    if (fam_simd_level() == SIMD_AVX512)
+        return reduce_avx512<T, A, OP>(in, n, init);
+    if (fam_simd_level() == SIMD_AVX2)
+        return reduce_avx2<T, A, OP>(in, n, init);
+#endif
+    return reduce_block<T, A, OP, 4>(in, n, init);
+}
+
+/*
+ * Splits the elements into one contiguous range per thread. init is the
+ * identity of a sum, or an element of the array for a minimum or maximum,
+ * so it can start every range.
+ */
+template <typename T, typename A, Fam_Reduce_Op OP>
+static A reduce_parallel(const T *in, uint64_t n, A init) {
+    uint64_t numThreads = fam_util_num_threads(n * sizeof(T));
+    if (numThreads == 1)
+        return reduce_range<T, A, OP>(in, n, init);
+
+    uint64_t chunk = n / numThreads;
+    std::vector<A> partial(numThreads);
+    std::vector<std::thread> threads;
+    for (uint64_t t = 1; t < numThreads; t++) {
+        uint64_t count = (t == numThreads - 1) ? n - t * chunk : chunk;
+        threads.push_back(std::thread([&partial, in, chunk, count, init, t]() {
+            partial[t] = reduce_range<T, A, OP>(in + t * chunk, count, init);
+        }));
+    }
+    partial[0] = reduce_range<T, A, OP>(in, chunk, init);
+    A result = partial[0];
+    for (uint64_t t = 1; t < numThreads; t++) {
+        threads[t - 1].join();
+        result = combine<A, OP>(result, partial[t]);
+    }
+    return result;
+}
+
+/*
+ * Sums are accumulated in SumT; integer sums wrap around modulo 2^64
+ */
+template <typename T, typename SumT>
+static int reduce_type(const void *base, uint64_t count, Fam_Reduce_Op op,
+                       void *result) {
+    const T *in = (const T *)base;
+    switch (op) {
+    case FAM_REDUCE_SUM: {
+        SumT sum = reduce_parallel<T, SumT, FAM_REDUCE_SUM>(in, count, 0);
+        memcpy(result, &sum, sizeof(SumT));
+        return 0;
+    }
+    case FAM_REDUCE_MIN: {
+        if (count == 0)
+            return -1;
+        T min = reduce_parallel<T, T, FAM_REDUCE_MIN>(in, count, in[0]);
+        memcpy(result, &min, sizeof(T));
+        return 0;
+    }
+    case FAM_REDUCE_MAX: {
+        if (count == 0)
+            return -1;
+        T max = reduce_parallel<T, T, FAM_REDUCE_MAX>(in, count, in[0]);
+        memcpy(result, &max, sizeof(T));
+        return 0;
+    }
+    default:
+        return -1;
+    }
+}
+
+int fam_reduce_local(const void *base, uint64_t count, Fam_Data_Type type,
+                     Fam_Reduce_Op op, void *result) {
+    switch (type) {
+    case FAM_INT32:
+        return reduce_type<int32_t, uint64_t>(base, count, op, result);
+    case FAM_INT64:
+        return reduce_type<int64_t, uint64_t>(base, count, op, result);
+    case FAM_UINT32:
+        return reduce_type<uint32_t, uint64_t>(base, count, op, result);
+    case FAM_UINT64:
+        return reduce_type<uint64_t, uint64_t>(base, count, op, result);
+    case FAM_FLOAT:
+        return reduce_type<float, double>(base, count, op, result);
+    case FAM_DOUBLE:
+        return reduce_type<double, double>(base, count, op, result);
+    default:
+        return -1;
+    }
+}
+
+/*
+ * Sums of elements wrap around; signed integers are added as unsigned ones
+ */
+template <typename T> static inline T wrapping_add(T x, T y) { return x + y; }
+
+template <> inline int32_t wrapping_add(int32_t x, int32_t y) {
+    return (int32_t)((uint32_t)x + (uint32_t)y);
+}
+
+template <> inline int64_t wrapping_add(int64_t x, int64_t y) {
+    return (int64_t)((uint64_t)x + (uint64_t)y);
+}
+
+template <typename T, Fam_Reduce_Op OP>
+static void combine_elements(T *inout, const T *in, uint64_t count) {
+    for (uint64_t i = 0; i < count; i++) {
+        if (OP == FAM_REDUCE_SUM)
+            inout[i] = wrapping_add<T>(inout[i], in[i]);
+        else
+            inout[i] = combine<T, OP>(inout[i], in[i]);
+    }
+}
+
+template <typename T>
+static int combine_type(void *inout, const void *in, uint64_t count,
+                        Fam_Reduce_Op op) {
+    switch (op) {
+    case FAM_REDUCE_SUM:
+        combine_elements<T, FAM_REDUCE_SUM>((T *)inout, (const T *)in, count);
+        return 0;
+    case FAM_REDUCE_MIN:
+        combine_elements<T, FAM_REDUCE_MIN>((T *)inout, (const T *)in, count);
+        return 0;
+    case FAM_REDUCE_MAX:
+        combine_elements<T, FAM_REDUCE_MAX>((T *)inout, (const T *)in, count);
+        return 0;
+    default:
+        return -1;
+    }
+}
+
+int fam_reduce_elements(void *inout, const void *in, uint64_t count,
+                        Fam_Data_Type type, Fam_Reduce_Op op) {
+    switch (type) {
+    case FAM_INT32:
+        return combine_type<int32_t>(inout, in, count, op);
+    case FAM_INT64:
+        return combine_type<int64_t>(inout, in, count, op);
+    case FAM_UINT32:
+        return combine_type<uint32_t>(inout, in, count, op);
+    case FAM_UINT64:
+        return combine_type<uint64_t>(inout, in, count, op);
+    case FAM_FLOAT:
+        return combine_type<float>(inout, in, count, op);
+    case FAM_DOUBLE:
+        return combine_type<double>(inout, in, count, op);
+    default:
+        return -1;
+    }
+}
+
+uint64_t fam_data_type_size(Fam_Data_Type type) {
+    switch (type) {
+    case FAM_INT32:
+    case FAM_UINT32:
+    case FAM_FLOAT:
+        return 4;
+    case FAM_INT64:
+    case FAM_UINT64:
+    case FAM_DOUBLE:
+        return 8;
+    default:
+        return 0;
+    }
+}
+
+uint64_t fam_reduce_result_size(Fam_Data_Type type, Fam_Reduce_Op op) {
+    return (op == FAM_REDUCE_SUM) ? 8 : fam_data_type_size(type);
+}
+
+} // namespace openfam
@@ -0,0 +1,66 @@
+/*
+ * fam_util_reduce.h
+ * Copyright (c) 2019 Hewlett Packard Enterprise Development, LP. All rights
+ * reserved. Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ *    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * See https://spdx.org/licenses/BSD-3-Clause
+ *
+ */
+#ifndef FAM_UTIL_REDUCE_H
+#define FAM_UTIL_REDUCE_H
+
+#include <stdint.h>
+
+#include "fam/fam.h"
+
+namespace openfam {
+
+/*
+ * Reduction kernels of fam_reduce, run by the memory server, or by the PE
+ * in NVMM mode, over the local memory of a data item. Elements are read
+ * with AVX-512, AVX2 or baseline vector code chosen at run time, and large
+ * arrays are split across threads. A sum is returned as an int64_t for
+ * signed types, a uint64_t for unsigned types and a double for floating
+ * point types; a minimum or maximum as an element. Returns -1 for a minimum
+ * or maximum of no elements. The caller checks bounds and permissions.
+ */
+int fam_reduce_local(const void *base, uint64_t count, Fam_Data_Type type,
+                     Fam_Reduce_Op op, void *result);
+
+/*
+ * Combines count elements of in into those of inout, one by one, as
+ * fam_allreduce does. Sums are computed in the element type, so integer
+ * sums wrap around. Returns -1 for an unknown type or reduction.
+ */
+int fam_reduce_elements(void *inout, const void *in, uint64_t count,
+                        Fam_Data_Type type, Fam_Reduce_Op op);
+
+/* Size of an element, or 0 for an unknown type */
+uint64_t fam_data_type_size(Fam_Data_Type type);
+
+/* Size of the result written by fam_reduce_local() */
+uint64_t fam_reduce_result_size(Fam_Data_Type type, Fam_Reduce_Op op);
+
+} // namespace openfam
+#endif
@@ -0,0 +1,354 @@
+/*
+ * fam_util_scan.cpp
+ * Copyright (c) 2019 Hewlett Packard Enterprise Development, LP. All rights
+ * reserved. Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ *    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * See https://spdx.org/licenses/BSD-3-Clause
+ *
+ */
+
+#include <string.h>
+#include <thread>
+#include <vector>
+
+#include "common/fam_util_reduce.h"
+#include "common/fam_util_scan.h"
+#include "common/fam_util_simd.h"
+
+/*
+ * Records evaluated against one term at a time; the bitmaps of a block
+ * stay in cache while the terms are combined
+ */
+#define FAM_SCAN_BLOCK_RECORDS 4096
+
+namespace openfam {
+
+template <typename T> static inline T load_field(const char *p) {
+    T value;
+    memcpy(&value, p, sizeof(T));
+    return value;
+}
+
+template <Fam_Compare_Op OP, typename T> static inline bool compare(T x, T y) {
+    if (OP == FAM_CMP_EQ)
+        return x == y;
+    if (OP == FAM_CMP_NE)
+        return x != y;
+    if (OP == FAM_CMP_LT)
+        return x < y;
+    if (OP == FAM_CMP_LE)
+        return x <= y;
+    if (OP == FAM_CMP_GT)
+        return x > y;
+    return x >= y;
+}
+
+/*
+ * Sets bit i of bits if the field of type T of record i, stride bytes
+ * apart from in, compares true against value, for n records. LANES fields
+ * are compared at once with GCC vector types, which compile to the vector
+ * instructions of the enclosing target; a vector compare yields -1 in the
+ * lanes that match and 0 in the others. Fields of contiguous records are
+ * loaded as a vector, others are gathered one at a time.
+ */
+template <typename T, Fam_Compare_Op OP, int LANES>
+static inline __attribute__((always_inline)) void
+match_block(const char *in, uint64_t stride, uint64_t n, T value,
+            uint64_t *bits) {
+    typedef T Vector __attribute__((vector_size(LANES * sizeof(T))));
+
+    Vector constant;
+    for (int l = 0; l < LANES; l++)
+        constant[l] = value;
+    uint64_t i = 0;
+    for (; i + 64 <= n; i += 64) {
+        uint64_t word = 0;
+        for (int j = 0; j < 64; j += LANES) {
+            const char *p = in + (i + (uint64_t)j) * stride;
+            Vector x;
+            if (stride == sizeof(T)) {
+                memcpy(&x, p, sizeof(x));
+            } else {
+                for (int l = 0; l < LANES; l++)
+                    x[l] = load_field<T>(p + (uint64_t)l * stride);
+            }
+            decltype(x == constant) match;
+            if (OP == FAM_CMP_EQ)
+                match = x == constant;
+            else if (OP == FAM_CMP_NE)
+                match = x != constant;
+            else if (OP == FAM_CMP_LT)
+                match = x < constant;
+            else if (OP == FAM_CMP_LE)
+                match = x <= constant;
+            else if (OP == FAM_CMP_GT)
+                match = x > constant;
+            else
+                match = x >= constant;
+            for (int l = 0; l < LANES; l++)
+                word |= (uint64_t)(match[l] & 1) << (j + l);
+        }
+        bits[i / 64] = word;
+    }
+    if (i < n) {
+        uint64_t word = 0;
+        for (uint64_t k = i; k < n; k++) {
+            T x = load_field<T>(in + k * stride);
+            word |= (uint64_t)compare<OP>(x, value) << (k - i);
+        }
+        bits[i / 64] = word;
+    }
+}
+
+template <typename T, int LANES>
+static inline __attribute__((always_inline)) void
+match_type(const char *in, uint64_t stride, uint64_t n, Fam_Compare_Op op,
+           T value, uint64_t *bits) {
+    switch (op) {
+    case FAM_CMP_EQ:
+        return match_block<T, FAM_CMP_EQ, LANES>(in, stride, n, value, bits);
+    case FAM_CMP_NE:
+        return match_block<T, FAM_CMP_NE, LANES>(in, stride, n, value, bits);
+    case FAM_CMP_LT:
+        return match_block<T, FAM_CMP_LT, LANES>(in, stride, n, value, bits);
+    case FAM_CMP_LE:
+        return match_block<T, FAM_CMP_LE, LANES>(in, stride, n, value, bits);
+    case FAM_CMP_GT:
+        return match_block<T, FAM_CMP_GT, LANES>(in, stride, n, value, bits);
+    case FAM_CMP_GE:
+        return match_block<T, FAM_CMP_GE, LANES>(in, stride, n, value, bits);
+    }
+}
+
+template <int LANES>
+static inline __attribute__((always_inline)) void
+match_lanes(const char *records, uint64_t recordSize, uint64_t n,
+            const Fam_Scan_Term *term, uint64_t *bits) {
+    const char *in = records + term->fieldOffset;
+    const Fam_Scan_Value &value = term->value;
+    switch (term->type) {
+    case FAM_INT32:
+        return match_type<int32_t, LANES>(in, recordSize, n, term->op,
+                                          value.i32, bits);
+    case FAM_INT64:
+        return match_type<int64_t, LANES>(in, recordSize, n, term->op,
+                                          value.i64, bits);
+    case FAM_UINT32:
+        return match_type<uint32_t, LANES>(in, recordSize, n, term->op,
+                                           value.u32, bits);
+    case FAM_UINT64:
+        return match_type<uint64_t, LANES>(in, recordSize, n, term->op,
+                                           value.u64, bits);
+    case FAM_FLOAT:
+        return match_type<float, LANES>(in, recordSize, n, term->op,
+                                        value.f32, bits);
+    case FAM_DOUBLE:
+        return match_type<double, LANES>(in, recordSize, n, term->op,
+                                         value.f64, bits);
+    }
+}
+
+#ifdef FAM_UTIL_SIMD
+__attribute__((target("avx512f"))) static void
+match_avx512(const char *records, uint64_t recordSize, uint64_t n,
+             const Fam_Scan_Term *term, uint64_t *bits) {
+    match_lanes<16>(records, recordSize, n, term, bits);
+}
+
+__attribute__((target("avx2"))) static void
+match_avx2(const char *records, uint64_t recordSize, uint64_t n,
+           const Fam_Scan_Term *term, uint64_t *bits) {
+    match_lanes<8>(records, recordSize, n, term, bits);
+}
+#endif
+
+static void match_term(const char *records, uint64_t recordSize, uint64_t n,
+                       const Fam_Scan_Term *term, uint64_t *bits) {
+#ifdef FAM_UTIL_SIMD
+    if (fam_simd_level() == SIMD_AVX512)
+        return match_avx512(records, recordSize, n, term, bits);
+    if (fam_simd_level() == SIMD_AVX2)
+        return match_avx2(records, recordSize, n, term, bits);
+#endif
+    match_lanes<4>(records, recordSize, n, term, bits);
+}
+
+/*
+ * Counts the matches among records [first, last) of base, and appends the
+ * indices of the first limit of them to matched unless it is NULL
+ */
+static uint64_t scan_range(const char *base, uint64_t recordSize,
+                           uint64_t first, uint64_t last,
+                           const Fam_Scan_Predicate *predicate,
+                           std::vector<uint64_t> *matched, uint64_t limit) {
+    uint64_t bits[FAM_SCAN_BLOCK_RECORDS / 64];
+    uint64_t termBits[FAM_SCAN_BLOCK_RECORDS / 64];
+    uint64_t count = 0;
+
+    for (uint64_t i = first; i < last; i += FAM_SCAN_BLOCK_RECORDS) {
+        uint64_t n = last - i;
+        if (n > FAM_SCAN_BLOCK_RECORDS)
+            n = FAM_SCAN_BLOCK_RECORDS;
+        uint64_t numWords = (n + 63) / 64;
+        const char *records = base + i * recordSize;
+
+        match_term(records, recordSize, n, &predicate->terms[0], bits);
+        for (uint32_t t = 1; t < predicate->numTerms; t++) {
+            match_term(records, recordSize, n, &predicate->terms[t],
+                       termBits);
+            for (uint64_t w = 0; w < numWords; w++) {
+                if (predicate->combine == FAM_SCAN_AND)
+                    bits[w] &= termBits[w];
+                else
+                    bits[w] |= termBits[w];
+            }
+        }
+
+        for (uint64_t w = 0; w < numWords; w++) {
+            uint64_t word = bits[w];
+            count += (uint64_t)__builtin_popcountll(word);
+            if (matched == NULL)
+                continue;
+            while (word && matched->size() < limit) {
+                matched->push_back(i + w * 64 +
+                                   (uint64_t)__builtin_ctzll(word));
+                word &= word - 1;
+            }
+        }
+    }
+    return count;
+}
+
+static void write_results(const char *base, uint64_t recordSize,
+                          const uint64_t *indices, uint64_t n,
+                          Fam_Scan_Output output, char *dest) {
+    if (output == FAM_SCAN_INDICES) {
+        memcpy(dest, indices, n * sizeof(uint64_t));
+        return;
+    }
+    for (uint64_t k = 0; k < n; k++)
+        memcpy(dest + k * recordSize, base + indices[k] * recordSize,
+               recordSize);
+}
+
+int fam_scan_local(const void *base, uint64_t recordSize, uint64_t numRecords,
+                   const Fam_Scan_Predicate *predicate, Fam_Scan_Output output,
+                   void *dest, uint64_t destSize, uint64_t *matches) {
+    if (!fam_scan_output_valid(output) ||
+        !fam_scan_predicate_valid(predicate, recordSize))
+        return -1;
+    const char *records = (const char *)base;
+    uint64_t resultSize = fam_scan_result_size(output, recordSize);
+    uint64_t capacity = resultSize ? destSize / resultSize : 0;
+
+    uint64_t numThreads = fam_util_num_threads(numRecords * recordSize);
+
+    // Each thread scans one contiguous range of records
+    uint64_t chunk = numRecords / numThreads;
+    std::vector<std::vector<uint64_t> > matched(numThreads);
+    std::vector<uint64_t> counts(numThreads);
+    std::vector<std::thread> threads;
+    for (uint64_t t = 0; t < numThreads; t++) {
+        uint64_t first = t * chunk;
+        uint64_t last = (t == numThreads - 1) ? numRecords : first + chunk;
+        std::vector<uint64_t> *list = resultSize ? &matched[t] : NULL;
+        auto scan = [=, &counts]() {
+            counts[t] = scan_range(records, recordSize, first, last,
+                                   predicate, list, capacity);
+        };
+        if (t == numThreads - 1)
+            scan();
+        else
+            threads.push_back(std::thread(scan));
+    }
+    for (auto &thread : threads)
+        thread.join();
+    threads.clear();
+
+    // Results of a range follow those of the ranges before it
+    uint64_t total = 0;
+    for (uint64_t t = 0; t < numThreads; t++) {
+        uint64_t position = total;
+        total += counts[t];
+        if (!resultSize || position >= capacity)
+            continue;
+        uint64_t n = matched[t].size();
+        if (n > capacity - position)
+            n = capacity - position;
+        const uint64_t *indices = matched[t].data();
+        char *out = (char *)dest + position * resultSize;
+        auto write = [=]() {
+            write_results(records, recordSize, indices, n, output, out);
+        };
+        if (numThreads == 1)
+            write();
+        else
+            threads.push_back(std::thread(write));
+    }
+    for (auto &thread : threads)
+        thread.join();
+
+    *matches = total;
+    return 0;
+}
+
+bool fam_scan_output_valid(Fam_Scan_Output output) {
+    return (output == FAM_SCAN_COUNT) || (output == FAM_SCAN_INDICES) ||
+           (output == FAM_SCAN_RECORDS);
+}
+
+bool fam_scan_predicate_valid(const Fam_Scan_Predicate *predicate,
+                              uint64_t recordSize) {
+    if ((predicate->numTerms == 0) ||
+        (predicate->numTerms > FAM_SCAN_MAX_TERMS))
+        return false;
+    if ((predicate->combine != FAM_SCAN_AND) &&
+        (predicate->combine != FAM_SCAN_OR))
+        return false;
+    for (uint32_t t = 0; t < predicate->numTerms; t++) {
+        const Fam_Scan_Term *term = &predicate->terms[t];
+        uint64_t fieldSize = fam_data_type_size(term->type);
+        if ((fieldSize == 0) || (fieldSize > recordSize) ||
+            (term->fieldOffset > recordSize - fieldSize))
+            return false;
+        if ((uint32_t)term->op > (uint32_t)FAM_CMP_GE)
+            return false;
+    }
+    return true;
+}
+
+uint64_t fam_scan_result_size(Fam_Scan_Output output, uint64_t recordSize) {
+    switch (output) {
+    case FAM_SCAN_COUNT:
+        return 0;
+    case FAM_SCAN_INDICES:
+        return sizeof(uint64_t);
+    case FAM_SCAN_RECORDS:
+        return recordSize;
+    default:
+        return 0;
+    }
+}
+
+} // namespace openfam
@@ -0,0 +1,67 @@
+/*
+ * fam_util_scan.h
+ * Copyright (c) 2019 Hewlett Packard Enterprise Development, LP. All rights
+ * reserved. Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ *    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * See https://spdx.org/licenses/BSD-3-Clause
+ *
+ */
+#ifndef FAM_UTIL_SCAN_H
+#define FAM_UTIL_SCAN_H
+
+#include <stdint.h>
+
+#include "fam/fam.h"
+
+namespace openfam {
+
+/*
+ * Predicate scan of fam_scan, run by the memory server, or by the PE in
+ * NVMM mode, over numRecords records of recordSize bytes at base. Each
+ * term is evaluated over a block of records at a time into a bitmap, with
+ * AVX-512, AVX2 or baseline vector compares chosen at run time, and the
+ * bitmaps of the terms are combined. The matching records are then
+ * compacted, in record order, into dest as indices relative to base or as
+ * copies of the records; results beyond destSize bytes are dropped. Large
+ * scans are split across threads. Sets matches to the number of matching
+ * records. Returns -1 if the predicate or output is invalid. The caller
+ * checks bounds and permissions, and that dest does not overlap the
+ * records.
+ */
+int fam_scan_local(const void *base, uint64_t recordSize, uint64_t numRecords,
+                   const Fam_Scan_Predicate *predicate, Fam_Scan_Output output,
+                   void *dest, uint64_t destSize, uint64_t *matches);
+
+/* Whether output is one of the Fam_Scan_Output values */
+bool fam_scan_output_valid(Fam_Scan_Output output);
+
+/* Whether the predicate only reads fields within records of recordSize */
+bool fam_scan_predicate_valid(const Fam_Scan_Predicate *predicate,
+                              uint64_t recordSize);
+
+/* Size of a result written by fam_scan_local(), or 0 for FAM_SCAN_COUNT */
+uint64_t fam_scan_result_size(Fam_Scan_Output output, uint64_t recordSize);
+
+} // namespace openfam
+#endif
@@ -0,0 +1,61 @@
+/*
+ * fam_util_simd.cpp
+ * Copyright (c) 2019 Hewlett Packard Enterprise Development, LP. All rights
+ * reserved. Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ *    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * See https://spdx.org/licenses/BSD-3-Clause
+ *
+ */
+
+#include <thread>
+
+#include "common/fam_util_simd.h"
+
+namespace openfam {
+
+Fam_Simd_Level fam_simd_level() {
+#ifdef FAM_UTIL_SIMD
+    static const Fam_Simd_Level level =
+        __builtin_cpu_supports("avx512f")
+            ? SIMD_AVX512
+            : (__builtin_cpu_supports("avx2") ? SIMD_AVX2 : SIMD_NONE);
+    return level;
+#else
+    return SIMD_NONE;
+#endif
+}
+
+uint64_t fam_util_num_threads(uint64_t nbytes) {
+    uint64_t numThreads = nbytes / FAM_UTIL_THREAD_BYTES;
+    uint64_t numCores = std::thread::hardware_concurrency();
+    if (numThreads > numCores)
+        numThreads = numCores;
+    if (numThreads > FAM_UTIL_MAX_THREADS)
+        numThreads = FAM_UTIL_MAX_THREADS;
+    if (numThreads == 0)
+        numThreads = 1;
+    return numThreads;
+}
+
+} // namespace openfam
@@ -35,16 +35,24 @@
 #include "allocator/fam_allocator.h"
 #include "allocator/fam_allocator_grpc.h"
 #include "allocator/fam_allocator_nvmm.h"
+#include "allocator/fam_local_pool.h"
 #include "common/fam_libfabric.h"
+#include "common/fam_map_pager.h"
 #include "common/fam_ops.h"
 #include "common/fam_ops_libfabric.h"
 #include "common/fam_ops_nvmm.h"
 #include "common/fam_options.h"
+#include "common/fam_lock.h"
+#include "common/fam_team.h"
+#include "common/fam_trace.h"
+#include "common/fam_util_reduce.h"
+#include "common/fam_util_scan.h"
 #include "fam/fam.h"
 #include "fam/fam_exception.h"
 #include "pmi/fam_runtime.h"
 #include "pmi/runtime_pmi2.h"
 #include "pmi/runtime_pmix.h"
+#include "fam_stats.h"
 #ifdef FAM_PROFILE
 #include "fam_counters.h"
 #endif
@@ -68,7 +76,12 @@ const char *supportedOptionList[] = { "VERSION",             // index #0
                                       "PE_ID",               // index #10
                                       "RUNTIME",             // index #11
                                       "NUM_CONSUMER",        // index #12
-                                      NULL                   // index #13
+                                      "LOCAL_POOL_CHUNK_SIZE", // index #13
+                                      "ASYNC_QUEUE_DEPTH",   // index #14
+                                      "PERSIST_MODE",        // index #15
+                                      "FAM_STATS",           // index #16
+                                      "FAM_TRACE",           // index #17
+                                      NULL                   // index #18
 };
 
 namespace openfam {
@@ -85,19 +98,30 @@ class fam::Impl_ {
         groupName = NULL;
         famOps = NULL;
         famAllocator = NULL;
+        mapPager = NULL;
         famRuntime = NULL;
+        localPool = NULL;
+        famStats = NULL;
+        famStatsEnabled = false;
+        famTraceEnabled = false;
         memset((void *)&famOptions, 0, sizeof(Fam_Options));
     }
 
     ~Impl_() {
         if (groupName)
             free(groupName);
+        if (mapPager)
+            delete mapPager;
         if (famOps)
             delete (famOps);
+        if (localPool)
+            delete localPool;
         if (famAllocator)
             delete famAllocator;
         if (famRuntime)
             delete famRuntime;
+        if (famStats)
+            delete famStats;
     }
 
     int fam_initialize(const char *groupName, Fam_Options *options);
@@ -130,8 +154,21 @@ class fam::Impl_ {
                                  mode_t accessPermissions,
                                  Fam_Region_Descriptor *region);
 
+    Fam_Descriptor *fam_allocate_local_pool(uint64_t nbytes,
+                                            mode_t accessPermissions,
+                                            Fam_Region_Descriptor *region);
+
     void fam_deallocate(Fam_Descriptor *descriptor);
 
+    Fam_Async_Handle *fam_allocate_async(const char *name, uint64_t nbytes,
+                                         mode_t accessPermissions,
+                                         Fam_Region_Descriptor *region);
+    Fam_Async_Handle *fam_lookup_async(const char *itemName,
+                                       const char *regionName);
+    Fam_Async_Handle *fam_deallocate_async(Fam_Descriptor *descriptor);
+    bool fam_async_test(Fam_Async_Handle *handle);
+    Fam_Descriptor *fam_async_wait(Fam_Async_Handle *handle);
+
     int fam_change_permissions(Fam_Descriptor *descriptor,
                                mode_t accessPermissions);
 
@@ -195,6 +232,15 @@ class fam::Impl_ {
 
     void fam_copy_wait(void *waitObj);
 
+    void fam_reduce(Fam_Descriptor *descriptor, uint64_t offset,
+                    uint64_t count, Fam_Data_Type type, Fam_Reduce_Op op,
+                    void *result);
+
+    uint64_t fam_scan(Fam_Descriptor *source, uint64_t offset,
+                      uint64_t recordSize, uint64_t numRecords,
+                      Fam_Scan_Predicate *predicate, Fam_Scan_Output output,
+                      Fam_Descriptor *destination, uint64_t destOffset);
+
     void fam_set(Fam_Descriptor *descriptor, uint64_t offset, int32_t value);
     void fam_set(Fam_Descriptor *descriptor, uint64_t offset, int64_t value);
     void fam_set(Fam_Descriptor *descriptor, uint64_t offset, int128_t value);
@@ -345,9 +391,38 @@ class fam::Impl_ {
     void fam_fence(Fam_Region_Descriptor *descriptor = NULL);
     void fam_quiet(Fam_Region_Descriptor *descriptor = NULL);
 
+    Fam_Team *fam_team_create(const char *name, const char *regionName,
+                              uint64_t maxBytes);
+    Fam_Team *fam_team_create(const char *name, const char *regionName,
+                              uint64_t maxBytes, int numPEs, int myPE);
+    void fam_team_destroy(Fam_Team *team);
+    void fam_barrier(Fam_Team *team);
+    void fam_broadcast(Fam_Team *team, void *data, uint64_t nbytes, int root);
+    void fam_allreduce(Fam_Team *team, void *data, uint64_t count,
+                       Fam_Data_Type type, Fam_Reduce_Op op);
+
+    fam_lock_t *fam_lock_create(const char *name,
+                                Fam_Region_Descriptor *region,
+                                Fam_Lock_Type type, uint64_t maxHolders);
+    fam_lock_t *fam_lock_open(const char *name, const char *regionName);
+    void fam_lock_close(fam_lock_t *lock);
+    void fam_lock_destroy(fam_lock_t *lock);
+    void fam_lock(fam_lock_t *lock);
+    bool fam_trylock(fam_lock_t *lock);
+    bool fam_timedlock(fam_lock_t *lock, uint64_t timeoutUsec);
+    void fam_rdlock(fam_lock_t *lock);
+    bool fam_tryrdlock(fam_lock_t *lock);
+    bool fam_timedrdlock(fam_lock_t *lock, uint64_t timeoutUsec);
+    void fam_unlock(fam_lock_t *lock);
+
+    Fam_Stats_Snapshot *fam_stats_snapshot(void);
+
+    Fam_Server_Stats *fam_server_stats(uint64_t memoryServerId);
+
     int validate_fam_options(Fam_Options *options);
     void clean_fam_options();
     int validate_item(Fam_Descriptor *descriptor);
+    void check_not_pool_item(Fam_Descriptor *descriptor);
 
   private:
     uid_t uid;
@@ -358,8 +433,14 @@ class fam::Impl_ {
     std::map<std::string, const void *> *optValueMap;
     Fam_Ops *famOps;
     Fam_Allocator *famAllocator;
+    Fam_Map_Pager *mapPager;
+    Fam_Local_Pool *localPool;
     Fam_Thread_Model famThreadModel;
     Fam_Context_Model famContextModel;
+    Fam_Persist_Mode famPersistMode;
+    bool famStatsEnabled;
+    bool famTraceEnabled;
+    Fam_Stats *famStats;
     Fam_Runtime *famRuntime;
     uint64_t memoryServerCount;
     uint64_t generate_memory_server_id(const char *name) {
@@ -671,7 +752,9 @@ int fam::Impl_::fam_initialize(const char *grpName, Fam_Options *options) {
         // initialize NVMM client
         famAllocator = new Fam_Allocator_NVMM();
         famOps = new Fam_Ops_NVMM(famThreadModel, famContextModel, famAllocator,
-                                  atoi(famOptions.numConsumer));
+                                  atoi(famOptions.numConsumer),
+                                  strtoul(famOptions.asyncQueueDepth, NULL, 0),
+                                  famPersistMode);
         ret = famOps->initialize();
     } else {
         std::string memoryServer = famOptions.memoryServer;
@@ -711,7 +794,16 @@ int fam::Impl_::fam_initialize(const char *grpName, Fam_Options *options) {
                 famRuntime->runtime_fini();
             throw Fam_Datapath_Exception(message.str().c_str());
         }
-    }
+        mapPager = new Fam_Map_Pager(famOps, famThreadModel);
+        ((Fam_Allocator_Grpc *)famAllocator)->set_map_pager(mapPager);
+    }
+    localPool = new Fam_Local_Pool(
+        famAllocator, strtoul(famOptions.localPoolChunkSize, NULL, 0),
+        (strcmp(famOptions.allocator, FAM_OPTIONS_NVMM_STR) == 0));
+    if (famStatsEnabled)
+        famStats = new Fam_Stats(memoryServerCount);
+    if (famTraceEnabled)
+        Fam_Trace::enable();
     FAM_PROFILE_START_TIME();
     return ret;
 }
@@ -833,6 +925,81 @@ int fam::Impl_::validate_fam_options(Fam_Options *options) {
     optValueMap->insert(
         { supportedOptionList[NUM_CONSUMER], famOptions.numConsumer });
 
+    if (options && options->localPoolChunkSize)
+        famOptions.localPoolChunkSize = strdup(options->localPoolChunkSize);
+    else
+        famOptions.localPoolChunkSize = strdup("1048576");
+    if (strtoul(famOptions.localPoolChunkSize, NULL, 0) == 0) {
+        message << "Invalid value specified for localPoolChunkSize: "
+                << famOptions.localPoolChunkSize;
+        throw Fam_InvalidOption_Exception(message.str().c_str());
+    }
+    optValueMap->insert({ supportedOptionList[LOCAL_POOL_CHUNK_SIZE],
+                          famOptions.localPoolChunkSize });
+
+    if (options && options->asyncQueueDepth)
+        famOptions.asyncQueueDepth = strdup(options->asyncQueueDepth);
+    else
+        famOptions.asyncQueueDepth = strdup("1024");
+    if (strtoul(famOptions.asyncQueueDepth, NULL, 0) == 0) {
+        message << "Invalid value specified for asyncQueueDepth: "
+                << famOptions.asyncQueueDepth;
+        throw Fam_InvalidOption_Exception(message.str().c_str());
+    }
+    optValueMap->insert({ supportedOptionList[ASYNC_QUEUE_DEPTH],
+                          famOptions.asyncQueueDepth });
+
+    if (options && options->persistMode)
+        famOptions.persistMode = strdup(options->persistMode);
+    else
+        famOptions.persistMode = strdup(FAM_PERSIST_EAGER_STR);
+
+    if (strcmp(famOptions.persistMode, FAM_PERSIST_EAGER_STR) == 0)
+        famPersistMode = FAM_PERSIST_EAGER;
+    else if (strcmp(famOptions.persistMode, FAM_PERSIST_DEFERRED_STR) == 0)
+        famPersistMode = FAM_PERSIST_DEFERRED;
+    else {
+        message << "Invalid value specified for persistMode: "
+                << famOptions.persistMode;
+        throw Fam_InvalidOption_Exception(message.str().c_str());
+    }
+    optValueMap->insert(
+        { supportedOptionList[PERSIST_MODE], famOptions.persistMode });
+
+    if (options && options->famStats)
+        famOptions.famStats = strdup(options->famStats);
+    else
+        famOptions.famStats = strdup(FAM_STATS_DISABLE_STR);
+
+    if (strcmp(famOptions.famStats, FAM_STATS_ENABLE_STR) == 0)
+        famStatsEnabled = true;
+    else if (strcmp(famOptions.famStats, FAM_STATS_DISABLE_STR) == 0)
+        famStatsEnabled = false;
+    else {
+        message << "Invalid value specified for famStats: "
+                << famOptions.famStats;
+        throw Fam_InvalidOption_Exception(message.str().c_str());
+    }
+    optValueMap->insert(
+        { supportedOptionList[FAM_STATS], famOptions.famStats });
+
+    if (options && options->famTrace)
+        famOptions.famTrace = strdup(options->famTrace);
+    else
+        famOptions.famTrace = strdup(FAM_TRACE_DISABLE_STR);
+
+    if (strcmp(famOptions.famTrace, FAM_TRACE_ENABLE_STR) == 0)
+        famTraceEnabled = true;
+    else if (strcmp(famOptions.famTrace, FAM_TRACE_DISABLE_STR) == 0)
+        famTraceEnabled = false;
+    else {
+        message << "Invalid value specified for famTrace: "
+                << famOptions.famTrace;
+        throw Fam_InvalidOption_Exception(message.str().c_str());
+    }
+    optValueMap->insert(
+        { supportedOptionList[FAM_TRACE], famOptions.famTrace });
+
     return ret;
 }
 
@@ -870,6 +1037,7 @@ int fam::Impl_::validate_item(Fam_Descriptor *descriptor) {
         if (strcmp(famOptions.allocator, FAM_OPTIONS_NVMM_STR) == 0) {
             descriptor->set_base_address(itemInfo.base);
         }
+        famOps->bind_descriptor(descriptor);
     }
 
     if (key == FAM_KEY_INVALID) {
@@ -879,6 +1047,19 @@ int fam::Impl_::validate_item(Fam_Descriptor *descriptor) {
     return 0;
 }
 
+/*
+ * check_not_pool_item - Operations executed by the memory server resolve a
+ * data item from its offset, which for an item of fam_allocate_local_pool is
+ * the chunk it was carved out of. Such operations are rejected for these
+ * items, rather than applied to the whole chunk.
+ */
+void fam::Impl_::check_not_pool_item(Fam_Descriptor *descriptor) {
+    if (descriptor->is_pool_item()) {
+        throw Fam_InvalidOption_Exception(
+            "Operation not supported on items of fam_allocate_local_pool");
+    }
+}
+
 /**
  * Finalize the fam library. Once finalized, the process can continue work, but
  * it is disconnected from the OpenFAM library functions.
@@ -888,6 +1069,18 @@ int fam::Impl_::validate_item(Fam_Descriptor *descriptor) {
 void fam::Impl_::fam_finalize(const char *groupName) {
     FAM_PROFILE_END();
 
+    // Events recorded so far can still be dumped
+    if (famTraceEnabled)
+        Fam_Trace::disable();
+
+    // Write back and unmap data items mapped over the data path
+    if (mapPager != NULL)
+        mapPager->finalize();
+
+    // Return unused chunks before the allocator is finalized
+    if (localPool != NULL)
+        localPool->finalize();
+
     // Calling destructor for allocator
     if (famAllocator != NULL)
         famAllocator->allocator_finalize();
@@ -985,7 +1178,10 @@ const void *fam::Impl_::fam_get_option(char *optionName) {
  */
 Fam_Region_Descriptor *fam::Impl_::fam_lookup_region(const char *name) {
     FAM_CNTR_INC_API(fam_lookup_region);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_lookup_region);
+    Fam_Trace_Scope traceScope(trace_fam_lookup_region);
     FAM_PROFILE_START_ALLOCATOR(fam_lookup_region);
+    traceScope.submit();
     uint64_t memoryServerId = generate_memory_server_id(name);
     auto ret = famAllocator->lookup_region(name, memoryServerId);
     FAM_PROFILE_END_ALLOCATOR(fam_lookup_region);
@@ -1005,7 +1201,10 @@ Fam_Region_Descriptor *fam::Impl_::fam_lookup_region(const char *name) {
 Fam_Descriptor *fam::Impl_::fam_lookup(const char *itemName,
                                        const char *regionName) {
     FAM_CNTR_INC_API(fam_lookup);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_lookup);
+    Fam_Trace_Scope traceScope(trace_fam_lookup);
     FAM_PROFILE_START_ALLOCATOR(fam_lookup);
+    traceScope.submit();
     uint64_t memoryServerId = generate_memory_server_id(regionName);
     auto ret = famAllocator->lookup(itemName, regionName, memoryServerId);
     FAM_PROFILE_END_ALLOCATOR(fam_lookup);
@@ -1038,7 +1237,10 @@ fam::Impl_::fam_create_region(const char *name, uint64_t size,
                               mode_t permissions,
                               Fam_Redundancy_Level redundancyLevel, ...) {
     FAM_CNTR_INC_API(fam_create_region);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_create_region);
+    Fam_Trace_Scope traceScope(trace_fam_create_region);
     FAM_PROFILE_START_ALLOCATOR(fam_create_region);
+    traceScope.submit();
     uint64_t memoryServerId = generate_memory_server_id(name);
     auto ret = famAllocator->create_region(name, size, permissions,
                                            redundancyLevel, memoryServerId);
@@ -1058,7 +1260,11 @@ fam::Impl_::fam_create_region(const char *name, uint64_t size,
  */
 void fam::Impl_::fam_destroy_region(Fam_Region_Descriptor *descriptor) {
     FAM_CNTR_INC_API(fam_destroy_region);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_destroy_region, descriptor);
+    Fam_Trace_Scope traceScope(trace_fam_destroy_region, descriptor);
     FAM_PROFILE_START_ALLOCATOR(fam_destroy_region);
+    traceScope.submit();
+    localPool->release_region(descriptor);
     famAllocator->destroy_region(descriptor);
     FAM_PROFILE_END_ALLOCATOR(fam_destroy_region);
     return;
@@ -1080,7 +1286,10 @@ void fam::Impl_::fam_destroy_region(Fam_Region_Descriptor *descriptor) {
 int fam::Impl_::fam_resize_region(Fam_Region_Descriptor *descriptor,
                                   uint64_t nbytes) {
     FAM_CNTR_INC_API(fam_resize_region);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_resize_region, descriptor);
+    Fam_Trace_Scope traceScope(trace_fam_resize_region, descriptor);
     FAM_PROFILE_START_ALLOCATOR(fam_resize_region);
+    traceScope.submit();
     auto ret = famAllocator->resize_region(descriptor, nbytes);
     FAM_PROFILE_END_ALLOCATOR(fam_resize_region);
     return ret;
@@ -1111,12 +1320,45 @@ Fam_Descriptor *fam::Impl_::fam_allocate(const char *name, uint64_t nbytes,
                                          mode_t accessPermissions,
                                          Fam_Region_Descriptor *region) {
     FAM_CNTR_INC_API(fam_allocate);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_allocate, region);
+    Fam_Trace_Scope traceScope(trace_fam_allocate, region);
     FAM_PROFILE_START_ALLOCATOR(fam_allocate);
+    traceScope.submit();
     auto ret = famAllocator->allocate(name, nbytes, accessPermissions, region);
     FAM_PROFILE_END_ALLOCATOR(fam_allocate);
     return ret;
 }
 
+/**
+ * Allocate some unnamed space within a region from a chunk leased by the
+ * client, without a round trip to the memory server for every item.
+ * @param nybtes - size of the space to allocate in bytes.
+ * @param accessPermissions - permissions associated with this space
+ * @param region - descriptor of the region within which the space is being
+ * allocated.
+ * @return - descriptor that can be used within the program to refer to this
+ * space
+ * @see #fam_deallocate()
+ */
+Fam_Descriptor *
+fam::Impl_::fam_allocate_local_pool(uint64_t nbytes, mode_t accessPermissions,
+                                    Fam_Region_Descriptor *region) {
+    FAM_CNTR_INC_API(fam_allocate_local_pool);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_allocate_local_pool, region);
+    Fam_Trace_Scope traceScope(trace_fam_allocate_local_pool, region);
+    FAM_PROFILE_START_ALLOCATOR(fam_allocate_local_pool);
+    traceScope.submit();
+    if (region == NULL) {
+        throw Fam_InvalidOption_Exception("Region descriptor is null");
+    }
+    auto ret = localPool->allocate(nbytes, accessPermissions, region);
+    // Items larger than a chunk are allocated by the memory server
+    if (ret == NULL)
+        ret = famAllocator->allocate("", nbytes, accessPermissions, region);
+    FAM_PROFILE_END_ALLOCATOR(fam_allocate_local_pool);
+    return ret;
+}
+
 /**
  * Deallocate allocated space in memory
  * @param descriptor - descriptor associated with the space.
@@ -1124,12 +1366,131 @@ Fam_Descriptor *fam::Impl_::fam_allocate(const char *name, uint64_t nbytes,
  */
 void fam::Impl_::fam_deallocate(Fam_Descriptor *descriptor) {
     FAM_CNTR_INC_API(fam_deallocate);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_deallocate, descriptor);
+    Fam_Trace_Scope traceScope(trace_fam_deallocate, descriptor);
     FAM_PROFILE_START_ALLOCATOR(fam_deallocate);
-    famAllocator->deallocate(descriptor);
+    traceScope.submit();
+    if (!localPool->deallocate(descriptor))
+        famAllocator->deallocate(descriptor);
     FAM_PROFILE_END_ALLOCATOR(fam_deallocate);
     return;
 }
 
+/**
+ * Start allocating a named data item, without waiting for the memory server.
+ * @param name - name of the data item
+ * @param nbytes - size of the data item in bytes
+ * @param accessPermissions - permissions of the data item
+ * @param region - region within which the data item is allocated
+ * @return - handle of the operation
+ * @see #fam_async_wait()
+ */
+Fam_Async_Handle *
+fam::Impl_::fam_allocate_async(const char *name, uint64_t nbytes,
+                               mode_t accessPermissions,
+                               Fam_Region_Descriptor *region) {
+    FAM_CNTR_INC_API(fam_allocate_async);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_allocate_async, region);
+    Fam_Trace_Scope traceScope(trace_fam_allocate_async, region);
+    FAM_PROFILE_START_ALLOCATOR(fam_allocate_async);
+    traceScope.submit();
+    auto ret = famAllocator->allocate_async(name, nbytes, accessPermissions,
+                                            region);
+    FAM_PROFILE_END_ALLOCATOR(fam_allocate_async);
+    return ret;
+}
+
+/**
+ * Start looking up a data item, without waiting for the memory server.
+ * @param itemName - name of the data item
+ * @param regionName - name of the region containing the data item
+ * @return - handle of the operation
+ * @see #fam_async_wait()
+ */
+Fam_Async_Handle *fam::Impl_::fam_lookup_async(const char *itemName,
+                                               const char *regionName) {
+    FAM_CNTR_INC_API(fam_lookup_async);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_lookup_async);
+    Fam_Trace_Scope traceScope(trace_fam_lookup_async);
+    FAM_PROFILE_START_ALLOCATOR(fam_lookup_async);
+    traceScope.submit();
+    uint64_t memoryServerId = generate_memory_server_id(regionName);
+    auto ret = famAllocator->lookup_async(itemName, regionName, memoryServerId);
+    FAM_PROFILE_END_ALLOCATOR(fam_lookup_async);
+    return ret;
+}
+
+/**
+ * Start deallocating a data item, without waiting for the memory server.
+ * Items of the local pool are released at once.
+ * @param descriptor - descriptor of the data item
+ * @return - handle of the operation
+ * @see #fam_async_wait()
+ */
+Fam_Async_Handle *
+fam::Impl_::fam_deallocate_async(Fam_Descriptor *descriptor) {
+    FAM_CNTR_INC_API(fam_deallocate_async);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_deallocate_async,
+                               descriptor);
+    Fam_Trace_Scope traceScope(trace_fam_deallocate_async, descriptor);
+    FAM_PROFILE_START_ALLOCATOR(fam_deallocate_async);
+    traceScope.submit();
+    Fam_Async_Handle *ret;
+    if (localPool->deallocate(descriptor)) {
+        ret = new Fam_Async_Handle();
+        ret->complete(NULL);
+    } else {
+        ret = famAllocator->deallocate_async(descriptor);
+    }
+    FAM_PROFILE_END_ALLOCATOR(fam_deallocate_async);
+    return ret;
+}
+
+/**
+ * Check whether an asynchronous operation has completed.
+ * @param handle - handle of the operation
+ * @return - true if the operation has completed
+ */
+bool fam::Impl_::fam_async_test(Fam_Async_Handle *handle) {
+    FAM_CNTR_INC_API(fam_async_test);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_async_test);
+    Fam_Trace_Scope traceScope(trace_fam_async_test);
+    FAM_PROFILE_START_ALLOCATOR(fam_async_test);
+    if (handle == NULL) {
+        throw Fam_InvalidOption_Exception("Invalid Options");
+    }
+    traceScope.submit();
+    bool ret = handle->is_complete();
+    FAM_PROFILE_END_ALLOCATOR(fam_async_test);
+    return ret;
+}
+
+/**
+ * Wait for an asynchronous operation and release its handle.
+ * @param handle - handle of the operation
+ * @return - descriptor of the data item allocated or looked up, or NULL
+ */
+Fam_Descriptor *fam::Impl_::fam_async_wait(Fam_Async_Handle *handle) {
+    FAM_CNTR_INC_API(fam_async_wait);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_async_wait);
+    Fam_Trace_Scope traceScope(trace_fam_async_wait);
+    FAM_PROFILE_START_ALLOCATOR(fam_async_wait);
+    if (handle == NULL) {
+        throw Fam_InvalidOption_Exception("Invalid Options");
+    }
+    traceScope.submit();
+    Fam_Descriptor *ret;
+    try {
+        ret = handle->wait();
+    } catch (...) {
+        delete handle;
+        throw;
+    }
+    delete handle;
+    FAM_PROFILE_END_ALLOCATOR(fam_async_wait);
+    return ret;
+}
+
 /**
  * Change permissions associated with a data item descriptor.
  * @param descriptor - descriptor associated with some data item
@@ -1140,7 +1501,12 @@ void fam::Impl_::fam_deallocate(Fam_Descriptor *descriptor) {
 int fam::Impl_::fam_change_permissions(Fam_Descriptor *descriptor,
                                        mode_t accessPermissions) {
     FAM_CNTR_INC_API(fam_change_permissions);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_change_permissions,
+                               descriptor);
+    Fam_Trace_Scope traceScope(trace_fam_change_permissions, descriptor);
     FAM_PROFILE_START_ALLOCATOR(fam_change_permissions);
+    check_not_pool_item(descriptor);
+    traceScope.submit();
     auto ret = famAllocator->change_permission(descriptor, accessPermissions);
     FAM_PROFILE_END_ALLOCATOR(fam_change_permissions);
     return ret;
@@ -1156,7 +1522,11 @@ int fam::Impl_::fam_change_permissions(Fam_Descriptor *descriptor,
 int fam::Impl_::fam_change_permissions(Fam_Region_Descriptor *descriptor,
                                        mode_t accessPermissions) {
     FAM_CNTR_INC_API(fam_change_permissions);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_change_permissions,
+                               descriptor);
+    Fam_Trace_Scope traceScope(trace_fam_change_permissions, descriptor);
     FAM_PROFILE_START_ALLOCATOR(fam_change_permissions);
+    traceScope.submit();
     auto ret = famAllocator->change_permission(descriptor, accessPermissions);
     FAM_PROFILE_END_ALLOCATOR(fam_change_permissions);
     return ret;
@@ -1207,14 +1577,18 @@ uint64_t fam::Impl_::fam_size(Fam_Region_Descriptor *descriptor) {
 void *fam::Impl_::fam_map(Fam_Descriptor *descriptor) {
     void *result = NULL;
     FAM_CNTR_INC_API(fam_map);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_map, descriptor);
+    Fam_Trace_Scope traceScope(trace_fam_map, descriptor);
     FAM_PROFILE_START_ALLOCATOR(fam_map);
     if (descriptor == NULL) {
         throw Fam_InvalidOption_Exception("Invalid Options");
     }
+    check_not_pool_item(descriptor);
     int ret = validate_item(descriptor);
     FAM_PROFILE_END_ALLOCATOR(fam_map);
 
     FAM_PROFILE_START_OPS(fam_map);
+    traceScope.submit();
     if (ret == 0) {
         void *address;
         address = famAllocator->fam_map(descriptor);
@@ -1236,6 +1610,8 @@ void *fam::Impl_::fam_map(Fam_Descriptor *descriptor) {
  */
 void fam::Impl_::fam_unmap(void *local, Fam_Descriptor *descriptor) {
     FAM_CNTR_INC_API(fam_unmap);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_unmap, descriptor);
+    Fam_Trace_Scope traceScope(trace_fam_unmap, descriptor);
     FAM_PROFILE_START_ALLOCATOR(fam_unmap);
     if (descriptor == NULL || local == NULL) {
         throw Fam_InvalidOption_Exception("Invalid Options");
@@ -1244,6 +1620,7 @@ void fam::Impl_::fam_unmap(void *local, Fam_Descriptor *descriptor) {
     int ret = validate_item(descriptor);
     FAM_PROFILE_END_ALLOCATOR(fam_unmap);
     FAM_PROFILE_START_OPS(fam_unmap);
+    traceScope.submit();
     if (ret == 0) {
         famAllocator->fam_unmap(local, descriptor);
     }
@@ -1278,6 +1655,10 @@ int fam::Impl_::fam_get_blocking(void *local, Fam_Descriptor *descriptor,
     std::ostringstream message;
 
     FAM_CNTR_INC_API(fam_get_blocking);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_get_blocking, descriptor,
+                               nbytes);
+    Fam_Trace_Scope traceScope(trace_fam_get_blocking, descriptor, offset,
+                               nbytes);
     FAM_PROFILE_START_ALLOCATOR(fam_get_blocking);
     if ((local == NULL) || (descriptor == NULL) || (nbytes == 0)) {
         throw Fam_InvalidOption_Exception("Invalid Options");
@@ -1285,6 +1666,7 @@ int fam::Impl_::fam_get_blocking(void *local, Fam_Descriptor *descriptor,
     ret = validate_item(descriptor);
     FAM_PROFILE_END_ALLOCATOR(fam_get_blocking);
     FAM_PROFILE_START_OPS(fam_get_blocking);
+    traceScope.submit();
     if (ret == 0) {
         // Read data from FAM region with this key
         ret = famOps->get_blocking(local, descriptor, offset, nbytes);
@@ -1307,6 +1689,10 @@ void fam::Impl_::fam_get_nonblocking(void *local, Fam_Descriptor *descriptor,
                                      uint64_t offset, uint64_t nbytes) {
 
     FAM_CNTR_INC_API(fam_get_nonblocking);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_get_nonblocking, descriptor,
+                               nbytes);
+    Fam_Trace_Scope traceScope(trace_fam_get_nonblocking, descriptor, offset,
+                               nbytes);
     FAM_PROFILE_START_ALLOCATOR(fam_get_nonblocking);
     if ((local == NULL) || (descriptor == NULL) || (nbytes == 0)) {
         throw Fam_InvalidOption_Exception("Invalid Options");
@@ -1314,6 +1700,7 @@ void fam::Impl_::fam_get_nonblocking(void *local, Fam_Descriptor *descriptor,
     int ret = validate_item(descriptor);
     FAM_PROFILE_END_ALLOCATOR(fam_get_nonblocking);
     FAM_PROFILE_START_OPS(fam_get_nonblocking);
+    traceScope.submit();
     if (ret == 0) {
         // Read data from FAM region with this key
         famOps->get_nonblocking(local, descriptor, offset, nbytes);
@@ -1343,6 +1730,10 @@ int fam::Impl_::fam_put_blocking(void *local, Fam_Descriptor *descriptor,
     std::ostringstream message;
 
     FAM_CNTR_INC_API(fam_put_blocking);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_put_blocking, descriptor,
+                               nbytes);
+    Fam_Trace_Scope traceScope(trace_fam_put_blocking, descriptor, offset,
+                               nbytes);
     FAM_PROFILE_START_ALLOCATOR(fam_put_blocking);
     if ((local == NULL) || (descriptor == NULL) || (nbytes == 0)) {
         throw Fam_InvalidOption_Exception("Invalid Options");
@@ -1352,6 +1743,7 @@ int fam::Impl_::fam_put_blocking(void *local, Fam_Descriptor *descriptor,
     ret = validate_item(descriptor);
     FAM_PROFILE_END_ALLOCATOR(fam_put_blocking);
     FAM_PROFILE_START_OPS(fam_put_blocking);
+    traceScope.submit();
     if (ret == 0) {
         ret = famOps->put_blocking(local, descriptor, offset, nbytes);
     }
@@ -1372,6 +1764,10 @@ int fam::Impl_::fam_put_blocking(void *local, Fam_Descriptor *descriptor,
 void fam::Impl_::fam_put_nonblocking(void *local, Fam_Descriptor *descriptor,
                                      uint64_t offset, uint64_t nbytes) {
     FAM_CNTR_INC_API(fam_put_nonblocking);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_put_nonblocking, descriptor,
+                               nbytes);
+    Fam_Trace_Scope traceScope(trace_fam_put_nonblocking, descriptor, offset,
+                               nbytes);
     FAM_PROFILE_START_ALLOCATOR(fam_put_nonblocking);
     if ((local == NULL) || (descriptor == NULL) || (nbytes == 0)) {
         throw Fam_InvalidOption_Exception("Invalid Options");
@@ -1380,6 +1776,7 @@ void fam::Impl_::fam_put_nonblocking(void *local, Fam_Descriptor *descriptor,
     int ret = validate_item(descriptor);
     FAM_PROFILE_END_ALLOCATOR(fam_put_nonblocking);
     FAM_PROFILE_START_OPS(fam_put_nonblocking);
+    traceScope.submit();
     if (ret == 0) {
         famOps->put_nonblocking(local, descriptor, offset, nbytes);
     }
@@ -1412,6 +1809,11 @@ int fam::Impl_::fam_gather_blocking(void *local, Fam_Descriptor *descriptor,
                                     uint64_t nElements, uint64_t firstElement,
                                     uint64_t stride, uint64_t elementSize) {
     FAM_CNTR_INC_API(fam_gather_blocking);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_gather_blocking, descriptor,
+                               nElements * elementSize);
+    Fam_Trace_Scope traceScope(trace_fam_gather_blocking, descriptor,
+                               firstElement * elementSize,
+                               nElements * elementSize);
     FAM_PROFILE_START_ALLOCATOR(fam_gather_blocking);
     if ((local == NULL) || (descriptor == NULL) || (nElements == 0)) {
         throw Fam_InvalidOption_Exception("Invalid Options");
@@ -1420,6 +1822,7 @@ int fam::Impl_::fam_gather_blocking(void *local, Fam_Descriptor *descriptor,
     int ret = validate_item(descriptor);
     FAM_PROFILE_END_ALLOCATOR(fam_gather_blocking);
     FAM_PROFILE_START_OPS(fam_gather_blocking);
+    traceScope.submit();
     if (ret == 0) {
         ret = famOps->gather_blocking(local, descriptor, nElements,
                                       firstElement, stride, elementSize);
@@ -1448,6 +1851,10 @@ int fam::Impl_::fam_gather_blocking(void *local, Fam_Descriptor *descriptor,
                                     uint64_t nElements, uint64_t *elementIndex,
                                     uint64_t elementSize) {
     FAM_CNTR_INC_API(fam_gather_blocking);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_gather_blocking, descriptor,
+                               nElements * elementSize);
+    Fam_Trace_Scope traceScope(trace_fam_gather_blocking, descriptor, 0,
+                               nElements * elementSize);
     FAM_PROFILE_START_ALLOCATOR(fam_gather_blocking);
     if ((local == NULL) || (descriptor == NULL) || (nElements == 0)) {
         throw Fam_InvalidOption_Exception("Invalid Options");
@@ -1456,6 +1863,7 @@ int fam::Impl_::fam_gather_blocking(void *local, Fam_Descriptor *descriptor,
     int ret = validate_item(descriptor);
     FAM_PROFILE_END_ALLOCATOR(fam_gather_blocking);
     FAM_PROFILE_START_OPS(fam_gather_blocking);
+    traceScope.submit();
     if (ret == 0) {
         ret = famOps->gather_blocking(local, descriptor, nElements,
                                       elementIndex, elementSize);
@@ -1484,6 +1892,11 @@ void fam::Impl_::fam_gather_nonblocking(void *local, Fam_Descriptor *descriptor,
                                         uint64_t firstElement, uint64_t stride,
                                         uint64_t elementSize) {
     FAM_CNTR_INC_API(fam_gather_nonblocking);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_gather_nonblocking,
+                               descriptor, nElements * elementSize);
+    Fam_Trace_Scope traceScope(trace_fam_gather_nonblocking, descriptor,
+                               firstElement * elementSize,
+                               nElements * elementSize);
     FAM_PROFILE_START_ALLOCATOR(fam_gather_nonblocking);
     if ((local == NULL) || (descriptor == NULL) || (nElements == 0)) {
         throw Fam_InvalidOption_Exception("Invalid Options");
@@ -1492,6 +1905,7 @@ void fam::Impl_::fam_gather_nonblocking(void *local, Fam_Descriptor *descriptor,
     int ret = validate_item(descriptor);
     FAM_PROFILE_END_ALLOCATOR(fam_gather_nonblocking);
     FAM_PROFILE_START_OPS(fam_gather_nonblocking);
+    traceScope.submit();
     if (ret == 0) {
         famOps->gather_nonblocking(local, descriptor, nElements, firstElement,
                                    stride, elementSize);
@@ -1519,6 +1933,10 @@ void fam::Impl_::fam_gather_nonblocking(void *local, Fam_Descriptor *descriptor,
                                         uint64_t *elementIndex,
                                         uint64_t elementSize) {
     FAM_CNTR_INC_API(fam_gather_nonblocking);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_gather_nonblocking,
+                               descriptor, nElements * elementSize);
+    Fam_Trace_Scope traceScope(trace_fam_gather_nonblocking, descriptor, 0,
+                               nElements * elementSize);
     FAM_PROFILE_START_ALLOCATOR(fam_gather_nonblocking);
     if ((local == NULL) || (descriptor == NULL) || (nElements == 0)) {
         throw Fam_InvalidOption_Exception("Invalid Options");
@@ -1527,6 +1945,7 @@ void fam::Impl_::fam_gather_nonblocking(void *local, Fam_Descriptor *descriptor,
     int ret = validate_item(descriptor);
     FAM_PROFILE_END_ALLOCATOR(fam_gather_nonblocking);
     FAM_PROFILE_START_OPS(fam_gather_nonblocking);
+    traceScope.submit();
     if (ret == 0) {
         famOps->gather_nonblocking(local, descriptor, nElements, elementIndex,
                                    elementSize);
@@ -1557,6 +1976,11 @@ int fam::Impl_::fam_scatter_blocking(void *local, Fam_Descriptor *descriptor,
                                      uint64_t stride, uint64_t elementSize) {
 
     FAM_CNTR_INC_API(fam_scatter_blocking);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_scatter_blocking, descriptor,
+                               nElements * elementSize);
+    Fam_Trace_Scope traceScope(trace_fam_scatter_blocking, descriptor,
+                               firstElement * elementSize,
+                               nElements * elementSize);
     FAM_PROFILE_START_ALLOCATOR(fam_scatter_blocking);
     if ((local == NULL) || (descriptor == NULL) || (nElements == 0)) {
         throw Fam_InvalidOption_Exception("Invalid Options");
@@ -1565,6 +1989,7 @@ int fam::Impl_::fam_scatter_blocking(void *local, Fam_Descriptor *descriptor,
     int ret = validate_item(descriptor);
     FAM_PROFILE_END_ALLOCATOR(fam_scatter_blocking);
     FAM_PROFILE_START_OPS(fam_scatter_blocking);
+    traceScope.submit();
     if (ret == 0) {
         ret = famOps->scatter_blocking(local, descriptor, nElements,
                                        firstElement, stride, elementSize);
@@ -1593,6 +2018,10 @@ int fam::Impl_::fam_scatter_blocking(void *local, Fam_Descriptor *descriptor,
                                      uint64_t elementSize) {
 
     FAM_CNTR_INC_API(fam_scatter_blocking);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_scatter_blocking, descriptor,
+                               nElements * elementSize);
+    Fam_Trace_Scope traceScope(trace_fam_scatter_blocking, descriptor, 0,
+                               nElements * elementSize);
     FAM_PROFILE_START_ALLOCATOR(fam_scatter_blocking);
     if ((local == NULL) || (descriptor == NULL) || (nElements == 0)) {
         throw Fam_InvalidOption_Exception("Invalid Options");
@@ -1601,6 +2030,7 @@ int fam::Impl_::fam_scatter_blocking(void *local, Fam_Descriptor *descriptor,
     int ret = validate_item(descriptor);
     FAM_PROFILE_END_ALLOCATOR(fam_scatter_blocking);
     FAM_PROFILE_START_OPS(fam_scatter_blocking);
+    traceScope.submit();
     if (ret == 0) {
         ret = famOps->scatter_blocking(local, descriptor, nElements,
                                        elementIndex, elementSize);
@@ -1632,6 +2062,11 @@ void fam::Impl_::fam_scatter_nonblocking(void *local,
                                          uint64_t firstElement, uint64_t stride,
                                          uint64_t elementSize) {
     FAM_CNTR_INC_API(fam_scatter_nonblocking);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_scatter_nonblocking,
+                               descriptor, nElements * elementSize);
+    Fam_Trace_Scope traceScope(trace_fam_scatter_nonblocking, descriptor,
+                               firstElement * elementSize,
+                               nElements * elementSize);
     FAM_PROFILE_START_ALLOCATOR(fam_scatter_nonblocking);
     if ((local == NULL) || (descriptor == NULL) || (nElements == 0)) {
         throw Fam_InvalidOption_Exception("Invalid Options");
@@ -1640,6 +2075,7 @@ void fam::Impl_::fam_scatter_nonblocking(void *local,
     int ret = validate_item(descriptor);
     FAM_PROFILE_END_ALLOCATOR(fam_scatter_nonblocking);
     FAM_PROFILE_START_OPS(fam_scatter_nonblocking);
+    traceScope.submit();
     if (ret == 0) {
         famOps->scatter_nonblocking(local, descriptor, nElements, firstElement,
                                     stride, elementSize);
@@ -1669,6 +2105,10 @@ void fam::Impl_::fam_scatter_nonblocking(void *local,
                                          uint64_t *elementIndex,
                                          uint64_t elementSize) {
     FAM_CNTR_INC_API(fam_scatter_nonblocking);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_scatter_nonblocking,
+                               descriptor, nElements * elementSize);
+    Fam_Trace_Scope traceScope(trace_fam_scatter_nonblocking, descriptor, 0,
+                               nElements * elementSize);
     FAM_PROFILE_START_ALLOCATOR(fam_scatter_nonblocking);
     if ((local == NULL) || (descriptor == NULL) || (nElements == 0)) {
         throw Fam_InvalidOption_Exception("Invalid Options");
@@ -1677,6 +2117,7 @@ void fam::Impl_::fam_scatter_nonblocking(void *local,
     int ret = validate_item(descriptor);
     FAM_PROFILE_END_ALLOCATOR(fam_scatter_nonblocking);
     FAM_PROFILE_START_OPS(fam_scatter_nonblocking);
+    traceScope.submit();
     if (ret == 0) {
         famOps->scatter_nonblocking(local, descriptor, nElements, elementIndex,
                                     elementSize);
@@ -1703,14 +2144,18 @@ void *fam::Impl_::fam_copy(Fam_Descriptor *src, uint64_t srcOffset,
                            uint64_t nbytes) {
     void *result = NULL;
     FAM_CNTR_INC_API(fam_copy);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_copy, src, nbytes);
+    Fam_Trace_Scope traceScope(trace_fam_copy, src, srcOffset, nbytes);
     FAM_PROFILE_START_ALLOCATOR(fam_copy);
     if ((src == NULL) || (nbytes == 0)) {
         throw Fam_InvalidOption_Exception("Invalid Options");
     }
+    check_not_pool_item(src);
 
     int ret = validate_item(src);
     FAM_PROFILE_END_ALLOCATOR(fam_copy);
     FAM_PROFILE_START_OPS(fam_copy);
+    traceScope.submit();
     if (ret == 0) {
         result = famOps->copy(src, srcOffset, dest, destOffset, nbytes);
     }
@@ -1720,7 +2165,10 @@ void *fam::Impl_::fam_copy(Fam_Descriptor *src, uint64_t srcOffset,
 
 void fam::Impl_::fam_copy_wait(void *waitObj) {
     FAM_CNTR_INC_API(fam_copy_wait);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_copy_wait);
+    Fam_Trace_Scope traceScope(trace_fam_copy_wait);
     FAM_PROFILE_START_ALLOCATOR(fam_copy_wait);
+    traceScope.submit();
     if (waitObj == NULL) {
         throw Fam_InvalidOption_Exception("Invalid Options");
     }
@@ -1730,6 +2178,81 @@ void fam::Impl_::fam_copy_wait(void *waitObj) {
     return;
 }
 
+// REDUCTION Subgroup
+
+/**
+ * Reduce count elements of a data item on the memory server holding it.
+ * @param descriptor - valid descriptor to a data item in FAM.
+ * @param offset - byte offset of the first element within the data item
+ * @param count - number of elements to reduce
+ * @param type - type of the elements
+ * @param op - reduction to compute
+ * @param result - result, see fam.h for its type
+ */
+void fam::Impl_::fam_reduce(Fam_Descriptor *descriptor, uint64_t offset,
+                            uint64_t count, Fam_Data_Type type,
+                            Fam_Reduce_Op op, void *result) {
+    uint64_t nbytes = count * fam_data_type_size(type);
+    FAM_CNTR_INC_API(fam_reduce);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_reduce, descriptor, nbytes);
+    Fam_Trace_Scope traceScope(trace_fam_reduce, descriptor, offset, nbytes);
+    FAM_PROFILE_START_ALLOCATOR(fam_reduce);
+    if ((descriptor == NULL) || (result == NULL)) {
+        throw Fam_InvalidOption_Exception("Invalid Options");
+    }
+    check_not_pool_item(descriptor);
+
+    validate_item(descriptor);
+    traceScope.submit();
+    famAllocator->reduce(descriptor, offset, count, type, op, result);
+    FAM_PROFILE_END_ALLOCATOR(fam_reduce);
+}
+
+/**
+ * Filter records of a data item on the memory server holding it.
+ * @param source - valid descriptor to a data item in FAM.
+ * @param offset - byte offset of the first record within the data item
+ * @param recordSize - size of a record in bytes
+ * @param numRecords - number of records to scan
+ * @param predicate - predicate the records are matched against
+ * @param output - what is written for a matching record
+ * @param destination - data item written to, or NULL with FAM_SCAN_COUNT
+ * @param destOffset - byte offset of the first result in the destination
+ * @return - number of matching records
+ */
+uint64_t fam::Impl_::fam_scan(Fam_Descriptor *source, uint64_t offset,
+                              uint64_t recordSize, uint64_t numRecords,
+                              Fam_Scan_Predicate *predicate,
+                              Fam_Scan_Output output,
+                              Fam_Descriptor *destination,
+                              uint64_t destOffset) {
+    uint64_t nbytes = recordSize * numRecords;
+    uint64_t matches;
+    FAM_CNTR_INC_API(fam_scan);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_scan, source, nbytes);
+    Fam_Trace_Scope traceScope(trace_fam_scan, source, offset, nbytes);
+    FAM_PROFILE_START_ALLOCATOR(fam_scan);
+    if ((source == NULL) || (predicate == NULL) ||
+        !fam_scan_output_valid(output) ||
+        ((destination == NULL) && (output != FAM_SCAN_COUNT))) {
+        throw Fam_InvalidOption_Exception("Invalid Options");
+    }
+
+    check_not_pool_item(source);
+    validate_item(source);
+    if (output != FAM_SCAN_COUNT) {
+        check_not_pool_item(destination);
+        validate_item(destination);
+    } else {
+        destination = NULL;
+    }
+    traceScope.submit();
+    matches = famAllocator->scan(source, offset, recordSize, numRecords,
+                                 predicate, output, destination, destOffset);
+    FAM_PROFILE_END_ALLOCATOR(fam_scan);
+    return matches;
+}
+
 // ATOMICS Group
 
 // NON fetching routines
@@ -1745,6 +2268,10 @@ void fam::Impl_::fam_set(Fam_Descriptor *descriptor, uint64_t offset,
                          int32_t value) {
     std::ostringstream message;
     FAM_CNTR_INC_API(fam_set);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_set, descriptor,
+                               sizeof(value));
+    Fam_Trace_Scope traceScope(trace_fam_set, descriptor, offset,
+                               sizeof(value));
     FAM_PROFILE_START_ALLOCATOR(fam_set);
     if (descriptor == NULL) {
         throw Fam_InvalidOption_Exception("Invalid Options");
@@ -1753,6 +2280,7 @@ void fam::Impl_::fam_set(Fam_Descriptor *descriptor, uint64_t offset,
     int ret = validate_item(descriptor);
     FAM_PROFILE_END_ALLOCATOR(fam_set);
     FAM_PROFILE_START_OPS(fam_set);
+    traceScope.submit();
     if (ret == 0) {
         famOps->atomic_set(descriptor, offset, value);
     }
@@ -1763,6 +2291,10 @@ void fam::Impl_::fam_set(Fam_Descriptor *descriptor, uint64_t offset,
                          int64_t value) {
     std::ostringstream message;
     FAM_CNTR_INC_API(fam_set);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_set, descriptor,
+                               sizeof(value));
+    Fam_Trace_Scope traceScope(trace_fam_set, descriptor, offset,
+                               sizeof(value));
     FAM_PROFILE_START_ALLOCATOR(fam_set);
     if (descriptor == NULL) {
         throw Fam_InvalidOption_Exception("Invalid Options");
@@ -1772,6 +2304,7 @@ void fam::Impl_::fam_set(Fam_Descriptor *descriptor, uint64_t offset,
     FAM_PROFILE_END_ALLOCATOR(fam_set);
 
     FAM_PROFILE_START_OPS(fam_set);
+    traceScope.submit();
     if (ret == 0) {
         famOps->atomic_set(descriptor, offset, value);
     }
@@ -1782,6 +2315,10 @@ void fam::Impl_::fam_set(Fam_Descriptor *descriptor, uint64_t offset,
                          int128_t value) {
     std::ostringstream message;
     FAM_CNTR_INC_API(fam_set);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_set, descriptor,
+                               sizeof(value));
+    Fam_Trace_Scope traceScope(trace_fam_set, descriptor, offset,
+                               sizeof(value));
     FAM_PROFILE_START_ALLOCATOR(fam_set);
     if (descriptor == NULL) {
         throw Fam_InvalidOption_Exception("Invalid Options");
@@ -1791,6 +2328,7 @@ void fam::Impl_::fam_set(Fam_Descriptor *descriptor, uint64_t offset,
     FAM_PROFILE_END_ALLOCATOR(fam_set);
 
     FAM_PROFILE_START_OPS(fam_set);
+    traceScope.submit();
     if (ret == 0) {
         famOps->atomic_set(descriptor, offset, value);
     }
@@ -1802,6 +2340,10 @@ void fam::Impl_::fam_set(Fam_Descriptor *descriptor, uint64_t offset,
                          uint32_t value) {
     std::ostringstream message;
     FAM_CNTR_INC_API(fam_set);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_set, descriptor,
+                               sizeof(value));
+    Fam_Trace_Scope traceScope(trace_fam_set, descriptor, offset,
+                               sizeof(value));
     FAM_PROFILE_START_ALLOCATOR(fam_set);
     if (descriptor == NULL) {
         throw Fam_InvalidOption_Exception("Invalid Options");
@@ -1811,6 +2353,7 @@ void fam::Impl_::fam_set(Fam_Descriptor *descriptor, uint64_t offset,
     FAM_PROFILE_END_ALLOCATOR(fam_set);
 
     FAM_PROFILE_START_OPS(fam_set);
+    traceScope.submit();
     if (ret == 0) {
         famOps->atomic_set(descriptor, offset, value);
     }
@@ -1821,6 +2364,10 @@ void fam::Impl_::fam_set(Fam_Descriptor *descriptor, uint64_t offset,
                          uint64_t value) {
     std::ostringstream message;
     FAM_CNTR_INC_API(fam_set);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_set, descriptor,
+                               sizeof(value));
+    Fam_Trace_Scope traceScope(trace_fam_set, descriptor, offset,
+                               sizeof(value));
     FAM_PROFILE_START_ALLOCATOR(fam_set);
     if (descriptor == NULL) {
         throw Fam_InvalidOption_Exception("Invalid Options");
@@ -1830,6 +2377,7 @@ void fam::Impl_::fam_set(Fam_Descriptor *descriptor, uint64_t offset,
     FAM_PROFILE_END_ALLOCATOR(fam_set);
 
     FAM_PROFILE_START_OPS(fam_set);
+    traceScope.submit();
     if (ret == 0) {
         famOps->atomic_set(descriptor, offset, value);
     }
@@ -1840,6 +2388,10 @@ void fam::Impl_::fam_set(Fam_Descriptor *descriptor, uint64_t offset,
                          float value) {
     std::ostringstream message;
     FAM_CNTR_INC_API(fam_set);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_set, descriptor,
+                               sizeof(value));
+    Fam_Trace_Scope traceScope(trace_fam_set, descriptor, offset,
+                               sizeof(value));
     FAM_PROFILE_START_ALLOCATOR(fam_set);
     if (descriptor == NULL) {
         throw Fam_InvalidOption_Exception("Invalid Options");
@@ -1849,6 +2401,7 @@ void fam::Impl_::fam_set(Fam_Descriptor *descriptor, uint64_t offset,
     FAM_PROFILE_END_ALLOCATOR(fam_set);
 
     FAM_PROFILE_START_OPS(fam_set);
+    traceScope.submit();
     if (ret == 0) {
         famOps->atomic_set(descriptor, offset, value);
     }
@@ -1859,6 +2412,10 @@ void fam::Impl_::fam_set(Fam_Descriptor *descriptor, uint64_t offset,
                          double value) {
     std::ostringstream message;
     FAM_CNTR_INC_API(fam_set);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_set, descriptor,
+                               sizeof(value));
+    Fam_Trace_Scope traceScope(trace_fam_set, descriptor, offset,
+                               sizeof(value));
     FAM_PROFILE_START_ALLOCATOR(fam_set);
     if (descriptor == NULL) {
         throw Fam_InvalidOption_Exception("Invalid Options");
@@ -1868,6 +2425,7 @@ void fam::Impl_::fam_set(Fam_Descriptor *descriptor, uint64_t offset,
     FAM_PROFILE_END_ALLOCATOR(fam_set);
 
     FAM_PROFILE_START_OPS(fam_set);
+    traceScope.submit();
     if (ret == 0) {
         famOps->atomic_set(descriptor, offset, value);
     }
@@ -1886,6 +2444,10 @@ void fam::Impl_::fam_add(Fam_Descriptor *descriptor, uint64_t offset,
                          int32_t value) {
     std::ostringstream message;
     FAM_CNTR_INC_API(fam_add);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_add, descriptor,
+                               sizeof(value));
+    Fam_Trace_Scope traceScope(trace_fam_add, descriptor, offset,
+                               sizeof(value));
     FAM_PROFILE_START_ALLOCATOR(fam_add);
     if (descriptor == NULL) {
         throw Fam_InvalidOption_Exception("Invalid Options");
@@ -1895,6 +2457,7 @@ void fam::Impl_::fam_add(Fam_Descriptor *descriptor, uint64_t offset,
     FAM_PROFILE_END_ALLOCATOR(fam_add);
 
     FAM_PROFILE_START_OPS(fam_add);
+    traceScope.submit();
     if (ret == 0) {
         famOps->atomic_add(descriptor, offset, value);
     }
@@ -1905,6 +2468,10 @@ void fam::Impl_::fam_add(Fam_Descriptor *descriptor, uint64_t offset,
                          int64_t value) {
     std::ostringstream message;
     FAM_CNTR_INC_API(fam_add);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_add, descriptor,
+                               sizeof(value));
+    Fam_Trace_Scope traceScope(trace_fam_add, descriptor, offset,
+                               sizeof(value));
     FAM_PROFILE_START_ALLOCATOR(fam_add);
     if (descriptor == NULL) {
         throw Fam_InvalidOption_Exception("Invalid Options");
@@ -1914,6 +2481,7 @@ void fam::Impl_::fam_add(Fam_Descriptor *descriptor, uint64_t offset,
     FAM_PROFILE_END_ALLOCATOR(fam_add);
 
     FAM_PROFILE_START_OPS(fam_add);
+    traceScope.submit();
     if (ret == 0) {
         famOps->atomic_add(descriptor, offset, value);
     }
@@ -1924,6 +2492,10 @@ void fam::Impl_::fam_add(Fam_Descriptor *descriptor, uint64_t offset,
                          uint32_t value) {
     std::ostringstream message;
     FAM_CNTR_INC_API(fam_add);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_add, descriptor,
+                               sizeof(value));
+    Fam_Trace_Scope traceScope(trace_fam_add, descriptor, offset,
+                               sizeof(value));
     FAM_PROFILE_START_ALLOCATOR(fam_add);
     if (descriptor == NULL) {
         throw Fam_InvalidOption_Exception("Invalid Options");
@@ -1933,6 +2505,7 @@ void fam::Impl_::fam_add(Fam_Descriptor *descriptor, uint64_t offset,
     FAM_PROFILE_END_ALLOCATOR(fam_add);
 
     FAM_PROFILE_START_OPS(fam_add);
+    traceScope.submit();
     if (ret == 0) {
         famOps->atomic_add(descriptor, offset, value);
     }
@@ -1943,6 +2516,10 @@ void fam::Impl_::fam_add(Fam_Descriptor *descriptor, uint64_t offset,
                          uint64_t value) {
     std::ostringstream message;
     FAM_CNTR_INC_API(fam_add);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_add, descriptor,
+                               sizeof(value));
+    Fam_Trace_Scope traceScope(trace_fam_add, descriptor, offset,
+                               sizeof(value));
     FAM_PROFILE_START_ALLOCATOR(fam_add);
     if (descriptor == NULL) {
         throw Fam_InvalidOption_Exception("Invalid Options");
@@ -1952,6 +2529,7 @@ void fam::Impl_::fam_add(Fam_Descriptor *descriptor, uint64_t offset,
     FAM_PROFILE_END_ALLOCATOR(fam_add);
 
     FAM_PROFILE_START_OPS(fam_add);
+    traceScope.submit();
     if (ret == 0) {
         famOps->atomic_add(descriptor, offset, value);
     }
@@ -1962,6 +2540,10 @@ void fam::Impl_::fam_add(Fam_Descriptor *descriptor, uint64_t offset,
                          float value) {
     std::ostringstream message;
     FAM_CNTR_INC_API(fam_add);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_add, descriptor,
+                               sizeof(value));
+    Fam_Trace_Scope traceScope(trace_fam_add, descriptor, offset,
+                               sizeof(value));
     FAM_PROFILE_START_ALLOCATOR(fam_add);
     if (descriptor == NULL) {
         throw Fam_InvalidOption_Exception("Invalid Options");
@@ -1971,6 +2553,7 @@ void fam::Impl_::fam_add(Fam_Descriptor *descriptor, uint64_t offset,
     FAM_PROFILE_END_ALLOCATOR(fam_add);
 
     FAM_PROFILE_START_OPS(fam_add);
+    traceScope.submit();
     if (ret == 0) {
         famOps->atomic_add(descriptor, offset, value);
     }
@@ -1981,6 +2564,10 @@ void fam::Impl_::fam_add(Fam_Descriptor *descriptor, uint64_t offset,
                          double value) {
     std::ostringstream message;
     FAM_CNTR_INC_API(fam_add);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_add, descriptor,
+                               sizeof(value));
+    Fam_Trace_Scope traceScope(trace_fam_add, descriptor, offset,
+                               sizeof(value));
     FAM_PROFILE_START_ALLOCATOR(fam_add);
     if (descriptor == NULL) {
         throw Fam_InvalidOption_Exception("Invalid Options");
@@ -1990,6 +2577,7 @@ void fam::Impl_::fam_add(Fam_Descriptor *descriptor, uint64_t offset,
     FAM_PROFILE_END_ALLOCATOR(fam_add);
 
     FAM_PROFILE_START_OPS(fam_add);
+    traceScope.submit();
     if (ret == 0) {
         famOps->atomic_add(descriptor, offset, value);
     }
@@ -2009,6 +2597,10 @@ void fam::Impl_::fam_subtract(Fam_Descriptor *descriptor, uint64_t offset,
                               int32_t value) {
     std::ostringstream message;
     FAM_CNTR_INC_API(fam_subtract);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_subtract, descriptor,
+                               sizeof(value));
+    Fam_Trace_Scope traceScope(trace_fam_subtract, descriptor, offset,
+                               sizeof(value));
     FAM_PROFILE_START_ALLOCATOR(fam_subtract);
     if (descriptor == NULL) {
         throw Fam_InvalidOption_Exception("Invalid Options");
@@ -2018,6 +2610,7 @@ void fam::Impl_::fam_subtract(Fam_Descriptor *descriptor, uint64_t offset,
     FAM_PROFILE_END_ALLOCATOR(fam_subtract);
 
     FAM_PROFILE_START_OPS(fam_subtract);
+    traceScope.submit();
     if (ret == 0) {
         famOps->atomic_subtract(descriptor, offset, value);
     }
@@ -2028,6 +2621,10 @@ void fam::Impl_::fam_subtract(Fam_Descriptor *descriptor, uint64_t offset,
                               int64_t value) {
     std::ostringstream message;
     FAM_CNTR_INC_API(fam_subtract);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_subtract, descriptor,
+                               sizeof(value));
+    Fam_Trace_Scope traceScope(trace_fam_subtract, descriptor, offset,
+                               sizeof(value));
     FAM_PROFILE_START_ALLOCATOR(fam_subtract);
     if (descriptor == NULL) {
         throw Fam_InvalidOption_Exception("Invalid Options");
@@ -2037,6 +2634,7 @@ void fam::Impl_::fam_subtract(Fam_Descriptor *descriptor, uint64_t offset,
     FAM_PROFILE_END_ALLOCATOR(fam_subtract);
 
     FAM_PROFILE_START_OPS(fam_subtract);
+    traceScope.submit();
     if (ret == 0) {
         famOps->atomic_subtract(descriptor, offset, value);
     }
@@ -2047,6 +2645,10 @@ void fam::Impl_::fam_subtract(Fam_Descriptor *descriptor, uint64_t offset,
                               uint32_t value) {
     std::ostringstream message;
     FAM_CNTR_INC_API(fam_subtract);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_subtract, descriptor,
+                               sizeof(value));
+    Fam_Trace_Scope traceScope(trace_fam_subtract, descriptor, offset,
+                               sizeof(value));
     FAM_PROFILE_START_ALLOCATOR(fam_subtract);
     if (descriptor == NULL) {
         throw Fam_InvalidOption_Exception("Invalid Options");
@@ -2056,6 +2658,7 @@ void fam::Impl_::fam_subtract(Fam_Descriptor *descriptor, uint64_t offset,
     FAM_PROFILE_END_ALLOCATOR(fam_subtract);
 
     FAM_PROFILE_START_OPS(fam_subtract);
+    traceScope.submit();
     if (ret == 0) {
         famOps->atomic_subtract(descriptor, offset, value);
     }
@@ -2066,6 +2669,10 @@ void fam::Impl_::fam_subtract(Fam_Descriptor *descriptor, uint64_t offset,
                               uint64_t value) {
     std::ostringstream message;
     FAM_CNTR_INC_API(fam_subtract);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_subtract, descriptor,
+                               sizeof(value));
+    Fam_Trace_Scope traceScope(trace_fam_subtract, descriptor, offset,
+                               sizeof(value));
     FAM_PROFILE_START_ALLOCATOR(fam_subtract);
     if (descriptor == NULL) {
         throw Fam_InvalidOption_Exception("Invalid Options");
@@ -2075,6 +2682,7 @@ void fam::Impl_::fam_subtract(Fam_Descriptor *descriptor, uint64_t offset,
     FAM_PROFILE_END_ALLOCATOR(fam_subtract);
 
     FAM_PROFILE_START_OPS(fam_subtract);
+    traceScope.submit();
     if (ret == 0) {
         famOps->atomic_subtract(descriptor, offset, value);
     }
@@ -2085,6 +2693,10 @@ void fam::Impl_::fam_subtract(Fam_Descriptor *descriptor, uint64_t offset,
                               float value) {
     std::ostringstream message;
     FAM_CNTR_INC_API(fam_subtract);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_subtract, descriptor,
+                               sizeof(value));
+    Fam_Trace_Scope traceScope(trace_fam_subtract, descriptor, offset,
+                               sizeof(value));
     FAM_PROFILE_START_ALLOCATOR(fam_subtract);
     if (descriptor == NULL) {
         throw Fam_InvalidOption_Exception("Invalid Options");
@@ -2094,6 +2706,7 @@ void fam::Impl_::fam_subtract(Fam_Descriptor *descriptor, uint64_t offset,
     FAM_PROFILE_END_ALLOCATOR(fam_subtract);
 
     FAM_PROFILE_START_OPS(fam_subtract);
+    traceScope.submit();
     if (ret == 0) {
         famOps->atomic_subtract(descriptor, offset, value);
     }
@@ -2104,6 +2717,10 @@ void fam::Impl_::fam_subtract(Fam_Descriptor *descriptor, uint64_t offset,
                               double value) {
     std::ostringstream message;
     FAM_CNTR_INC_API(fam_subtract);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_subtract, descriptor,
+                               sizeof(value));
+    Fam_Trace_Scope traceScope(trace_fam_subtract, descriptor, offset,
+                               sizeof(value));
     FAM_PROFILE_START_ALLOCATOR(fam_subtract);
     if (descriptor == NULL) {
         throw Fam_InvalidOption_Exception("Invalid Options");
@@ -2113,6 +2730,7 @@ void fam::Impl_::fam_subtract(Fam_Descriptor *descriptor, uint64_t offset,
     FAM_PROFILE_END_ALLOCATOR(fam_subtract);
 
     FAM_PROFILE_START_OPS(fam_subtract);
+    traceScope.submit();
     if (ret == 0) {
         famOps->atomic_subtract(descriptor, offset, value);
     }
@@ -2132,6 +2750,10 @@ void fam::Impl_::fam_min(Fam_Descriptor *descriptor, uint64_t offset,
                          int32_t value) {
     std::ostringstream message;
     FAM_CNTR_INC_API(fam_min);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_min, descriptor,
+                               sizeof(value));
+    Fam_Trace_Scope traceScope(trace_fam_min, descriptor, offset,
+                               sizeof(value));
     FAM_PROFILE_START_ALLOCATOR(fam_min);
     if (descriptor == NULL) {
         throw Fam_InvalidOption_Exception("Invalid Options");
@@ -2141,6 +2763,7 @@ void fam::Impl_::fam_min(Fam_Descriptor *descriptor, uint64_t offset,
     FAM_PROFILE_END_ALLOCATOR(fam_min);
 
     FAM_PROFILE_START_OPS(fam_min);
+    traceScope.submit();
     if (ret == 0) {
         famOps->atomic_min(descriptor, offset, value);
     }
@@ -2151,6 +2774,10 @@ void fam::Impl_::fam_min(Fam_Descriptor *descriptor, uint64_t offset,
                          int64_t value) {
     std::ostringstream message;
     FAM_CNTR_INC_API(fam_min);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_min, descriptor,
+                               sizeof(value));
+    Fam_Trace_Scope traceScope(trace_fam_min, descriptor, offset,
+                               sizeof(value));
     FAM_PROFILE_START_ALLOCATOR(fam_min);
     if (descriptor == NULL) {
         throw Fam_InvalidOption_Exception("Invalid Options");
@@ -2160,6 +2787,7 @@ void fam::Impl_::fam_min(Fam_Descriptor *descriptor, uint64_t offset,
     FAM_PROFILE_END_ALLOCATOR(fam_min);
 
     FAM_PROFILE_START_OPS(fam_min);
+    traceScope.submit();
     if (ret == 0) {
         famOps->atomic_min(descriptor, offset, value);
     }
@@ -2170,6 +2798,10 @@ void fam::Impl_::fam_min(Fam_Descriptor *descriptor, uint64_t offset,
                          uint32_t value) {
     std::ostringstream message;
     FAM_CNTR_INC_API(fam_min);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_min, descriptor,
+                               sizeof(value));
+    Fam_Trace_Scope traceScope(trace_fam_min, descriptor, offset,
+                               sizeof(value));
     FAM_PROFILE_START_ALLOCATOR(fam_min);
     if (descriptor == NULL) {
         throw Fam_InvalidOption_Exception("Invalid Options");
@@ -2179,6 +2811,7 @@ void fam::Impl_::fam_min(Fam_Descriptor *descriptor, uint64_t offset,
     FAM_PROFILE_END_ALLOCATOR(fam_min);
 
     FAM_PROFILE_START_OPS(fam_min);
+    traceScope.submit();
     if (ret == 0) {
         famOps->atomic_min(descriptor, offset, value);
     }
@@ -2189,6 +2822,10 @@ void fam::Impl_::fam_min(Fam_Descriptor *descriptor, uint64_t offset,
                          uint64_t value) {
     std::ostringstream message;
     FAM_CNTR_INC_API(fam_min);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_min, descriptor,
+                               sizeof(value));
+    Fam_Trace_Scope traceScope(trace_fam_min, descriptor, offset,
+                               sizeof(value));
     FAM_PROFILE_START_ALLOCATOR(fam_min);
     if (descriptor == NULL) {
         throw Fam_InvalidOption_Exception("Invalid Options");
@@ -2198,6 +2835,7 @@ void fam::Impl_::fam_min(Fam_Descriptor *descriptor, uint64_t offset,
     FAM_PROFILE_END_ALLOCATOR(fam_min);
 
     FAM_PROFILE_START_OPS(fam_min);
+    traceScope.submit();
     if (ret == 0) {
         famOps->atomic_min(descriptor, offset, value);
     }
@@ -2208,6 +2846,10 @@ void fam::Impl_::fam_min(Fam_Descriptor *descriptor, uint64_t offset,
                          float value) {
     std::ostringstream message;
     FAM_CNTR_INC_API(fam_min);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_min, descriptor,
+                               sizeof(value));
+    Fam_Trace_Scope traceScope(trace_fam_min, descriptor, offset,
+                               sizeof(value));
     FAM_PROFILE_START_ALLOCATOR(fam_min);
     if (descriptor == NULL) {
         throw Fam_InvalidOption_Exception("Invalid Options");
@@ -2217,6 +2859,7 @@ void fam::Impl_::fam_min(Fam_Descriptor *descriptor, uint64_t offset,
     FAM_PROFILE_END_ALLOCATOR(fam_min);
 
     FAM_PROFILE_START_OPS(fam_min);
+    traceScope.submit();
     if (ret == 0) {
         famOps->atomic_min(descriptor, offset, value);
     }
@@ -2227,6 +2870,10 @@ void fam::Impl_::fam_min(Fam_Descriptor *descriptor, uint64_t offset,
                          double value) {
     std::ostringstream message;
     FAM_CNTR_INC_API(fam_min);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_min, descriptor,
+                               sizeof(value));
+    Fam_Trace_Scope traceScope(trace_fam_min, descriptor, offset,
+                               sizeof(value));
     FAM_PROFILE_START_ALLOCATOR(fam_min);
     if (descriptor == NULL) {
         throw Fam_InvalidOption_Exception("Invalid Options");
@@ -2236,6 +2883,7 @@ void fam::Impl_::fam_min(Fam_Descriptor *descriptor, uint64_t offset,
     FAM_PROFILE_END_ALLOCATOR(fam_min);
 
     FAM_PROFILE_START_OPS(fam_min);
+    traceScope.submit();
     if (ret == 0) {
         famOps->atomic_min(descriptor, offset, value);
     }
@@ -2255,6 +2903,10 @@ void fam::Impl_::fam_max(Fam_Descriptor *descriptor, uint64_t offset,
                          int32_t value) {
     std::ostringstream message;
     FAM_CNTR_INC_API(fam_max);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_max, descriptor,
+                               sizeof(value));
+    Fam_Trace_Scope traceScope(trace_fam_max, descriptor, offset,
+                               sizeof(value));
     FAM_PROFILE_START_ALLOCATOR(fam_max);
     if (descriptor == NULL) {
         throw Fam_InvalidOption_Exception("Invalid Options");
@@ -2264,6 +2916,7 @@ void fam::Impl_::fam_max(Fam_Descriptor *descriptor, uint64_t offset,
     FAM_PROFILE_END_ALLOCATOR(fam_max);
 
     FAM_PROFILE_START_OPS(fam_max);
+    traceScope.submit();
     if (ret == 0) {
         famOps->atomic_max(descriptor, offset, value);
     }
@@ -2274,6 +2927,10 @@ void fam::Impl_::fam_max(Fam_Descriptor *descriptor, uint64_t offset,
                          int64_t value) {
     std::ostringstream message;
     FAM_CNTR_INC_API(fam_max);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_max, descriptor,
+                               sizeof(value));
+    Fam_Trace_Scope traceScope(trace_fam_max, descriptor, offset,
+                               sizeof(value));
     FAM_PROFILE_START_ALLOCATOR(fam_max);
     if (descriptor == NULL) {
         throw Fam_InvalidOption_Exception("Invalid Options");
@@ -2283,6 +2940,7 @@ void fam::Impl_::fam_max(Fam_Descriptor *descriptor, uint64_t offset,
     FAM_PROFILE_END_ALLOCATOR(fam_max);
 
     FAM_PROFILE_START_OPS(fam_max);
+    traceScope.submit();
     if (ret == 0) {
         famOps->atomic_max(descriptor, offset, value);
     }
@@ -2293,6 +2951,10 @@ void fam::Impl_::fam_max(Fam_Descriptor *descriptor, uint64_t offset,
                          uint32_t value) {
     std::ostringstream message;
     FAM_CNTR_INC_API(fam_max);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_max, descriptor,
+                               sizeof(value));
+    Fam_Trace_Scope traceScope(trace_fam_max, descriptor, offset,
+                               sizeof(value));
     FAM_PROFILE_START_ALLOCATOR(fam_max);
     if (descriptor == NULL) {
         throw Fam_InvalidOption_Exception("Invalid Options");
@@ -2302,6 +2964,7 @@ void fam::Impl_::fam_max(Fam_Descriptor *descriptor, uint64_t offset,
     FAM_PROFILE_END_ALLOCATOR(fam_max);
 
     FAM_PROFILE_START_OPS(fam_max);
+    traceScope.submit();
     if (ret == 0) {
         famOps->atomic_max(descriptor, offset, value);
     }
@@ -2312,6 +2975,10 @@ void fam::Impl_::fam_max(Fam_Descriptor *descriptor, uint64_t offset,
                          uint64_t value) {
     std::ostringstream message;
     FAM_CNTR_INC_API(fam_max);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_max, descriptor,
+                               sizeof(value));
+    Fam_Trace_Scope traceScope(trace_fam_max, descriptor, offset,
+                               sizeof(value));
     FAM_PROFILE_START_ALLOCATOR(fam_max);
     if (descriptor == NULL) {
         throw Fam_InvalidOption_Exception("Invalid Options");
@@ -2321,6 +2988,7 @@ void fam::Impl_::fam_max(Fam_Descriptor *descriptor, uint64_t offset,
     FAM_PROFILE_END_ALLOCATOR(fam_max);
 
     FAM_PROFILE_START_OPS(fam_max);
+    traceScope.submit();
     if (ret == 0) {
         famOps->atomic_max(descriptor, offset, value);
     }
@@ -2331,6 +2999,10 @@ void fam::Impl_::fam_max(Fam_Descriptor *descriptor, uint64_t offset,
                          float value) {
     std::ostringstream message;
     FAM_CNTR_INC_API(fam_max);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_max, descriptor,
+                               sizeof(value));
+    Fam_Trace_Scope traceScope(trace_fam_max, descriptor, offset,
+                               sizeof(value));
     FAM_PROFILE_START_ALLOCATOR(fam_max);
     if (descriptor == NULL) {
         throw Fam_InvalidOption_Exception("Invalid Options");
@@ -2340,6 +3012,7 @@ void fam::Impl_::fam_max(Fam_Descriptor *descriptor, uint64_t offset,
     FAM_PROFILE_END_ALLOCATOR(fam_max);
 
     FAM_PROFILE_START_OPS(fam_max);
+    traceScope.submit();
     if (ret == 0) {
         famOps->atomic_max(descriptor, offset, value);
     }
@@ -2350,6 +3023,10 @@ void fam::Impl_::fam_max(Fam_Descriptor *descriptor, uint64_t offset,
                          double value) {
     std::ostringstream message;
     FAM_CNTR_INC_API(fam_max);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_max, descriptor,
+                               sizeof(value));
+    Fam_Trace_Scope traceScope(trace_fam_max, descriptor, offset,
+                               sizeof(value));
     FAM_PROFILE_START_ALLOCATOR(fam_max);
     if (descriptor == NULL) {
         throw Fam_InvalidOption_Exception("Invalid Options");
@@ -2359,6 +3036,7 @@ void fam::Impl_::fam_max(Fam_Descriptor *descriptor, uint64_t offset,
     FAM_PROFILE_END_ALLOCATOR(fam_max);
 
     FAM_PROFILE_START_OPS(fam_max);
+    traceScope.submit();
     if (ret == 0) {
         famOps->atomic_max(descriptor, offset, value);
     }
@@ -2378,6 +3056,10 @@ void fam::Impl_::fam_and(Fam_Descriptor *descriptor, uint64_t offset,
                          uint32_t value) {
     std::ostringstream message;
     FAM_CNTR_INC_API(fam_and);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_and, descriptor,
+                               sizeof(value));
+    Fam_Trace_Scope traceScope(trace_fam_and, descriptor, offset,
+                               sizeof(value));
     FAM_PROFILE_START_ALLOCATOR(fam_and);
     if (descriptor == NULL) {
         throw Fam_InvalidOption_Exception("Invalid Options");
@@ -2387,6 +3069,7 @@ void fam::Impl_::fam_and(Fam_Descriptor *descriptor, uint64_t offset,
     FAM_PROFILE_END_ALLOCATOR(fam_and);
 
     FAM_PROFILE_START_OPS(fam_and);
+    traceScope.submit();
     if (ret == 0) {
         famOps->atomic_and(descriptor, offset, value);
     }
@@ -2397,6 +3080,10 @@ void fam::Impl_::fam_and(Fam_Descriptor *descriptor, uint64_t offset,
                          uint64_t value) {
     std::ostringstream message;
     FAM_CNTR_INC_API(fam_and);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_and, descriptor,
+                               sizeof(value));
+    Fam_Trace_Scope traceScope(trace_fam_and, descriptor, offset,
+                               sizeof(value));
     FAM_PROFILE_START_ALLOCATOR(fam_and);
     if (descriptor == NULL) {
         throw Fam_InvalidOption_Exception("Invalid Options");
@@ -2406,6 +3093,7 @@ void fam::Impl_::fam_and(Fam_Descriptor *descriptor, uint64_t offset,
     FAM_PROFILE_END_ALLOCATOR(fam_and);
 
     FAM_PROFILE_START_OPS(fam_and);
+    traceScope.submit();
     if (ret == 0) {
         famOps->atomic_and(descriptor, offset, value);
     }
@@ -2425,6 +3113,9 @@ void fam::Impl_::fam_or(Fam_Descriptor *descriptor, uint64_t offset,
                         uint32_t value) {
     std::ostringstream message;
     FAM_CNTR_INC_API(fam_or);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_or, descriptor,
+                               sizeof(value));
+    Fam_Trace_Scope traceScope(trace_fam_or, descriptor, offset, sizeof(value));
     FAM_PROFILE_START_ALLOCATOR(fam_or);
     if (descriptor == NULL) {
         throw Fam_InvalidOption_Exception("Invalid Options");
@@ -2434,6 +3125,7 @@ void fam::Impl_::fam_or(Fam_Descriptor *descriptor, uint64_t offset,
     FAM_PROFILE_END_ALLOCATOR(fam_or);
 
     FAM_PROFILE_START_OPS(fam_or);
+    traceScope.submit();
     if (ret == 0) {
         famOps->atomic_or(descriptor, offset, value);
     }
@@ -2444,6 +3136,9 @@ void fam::Impl_::fam_or(Fam_Descriptor *descriptor, uint64_t offset,
                         uint64_t value) {
     std::ostringstream message;
     FAM_CNTR_INC_API(fam_or);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_or, descriptor,
+                               sizeof(value));
+    Fam_Trace_Scope traceScope(trace_fam_or, descriptor, offset, sizeof(value));
     FAM_PROFILE_START_ALLOCATOR(fam_or);
     if (descriptor == NULL) {
         throw Fam_InvalidOption_Exception("Invalid Options");
@@ -2453,6 +3148,7 @@ void fam::Impl_::fam_or(Fam_Descriptor *descriptor, uint64_t offset,
     FAM_PROFILE_END_ALLOCATOR(fam_or);
 
     FAM_PROFILE_START_OPS(fam_or);
+    traceScope.submit();
     if (ret == 0) {
         famOps->atomic_or(descriptor, offset, value);
     }
@@ -2472,6 +3168,10 @@ void fam::Impl_::fam_xor(Fam_Descriptor *descriptor, uint64_t offset,
                          uint32_t value) {
     std::ostringstream message;
     FAM_CNTR_INC_API(fam_xor);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_xor, descriptor,
+                               sizeof(value));
+    Fam_Trace_Scope traceScope(trace_fam_xor, descriptor, offset,
+                               sizeof(value));
     FAM_PROFILE_START_ALLOCATOR(fam_xor);
     if (descriptor == NULL) {
         throw Fam_InvalidOption_Exception("Invalid Options");
@@ -2481,6 +3181,7 @@ void fam::Impl_::fam_xor(Fam_Descriptor *descriptor, uint64_t offset,
     FAM_PROFILE_END_ALLOCATOR(fam_xor);
 
     FAM_PROFILE_START_OPS(fam_xor);
+    traceScope.submit();
     if (ret == 0) {
         famOps->atomic_xor(descriptor, offset, value);
     }
@@ -2491,6 +3192,10 @@ void fam::Impl_::fam_xor(Fam_Descriptor *descriptor, uint64_t offset,
                          uint64_t value) {
     std::ostringstream message;
     FAM_CNTR_INC_API(fam_xor);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_xor, descriptor,
+                               sizeof(value));
+    Fam_Trace_Scope traceScope(trace_fam_xor, descriptor, offset,
+                               sizeof(value));
     FAM_PROFILE_START_ALLOCATOR(fam_xor);
     if (descriptor == NULL) {
         throw Fam_InvalidOption_Exception("Invalid Options");
@@ -2500,6 +3205,7 @@ void fam::Impl_::fam_xor(Fam_Descriptor *descriptor, uint64_t offset,
     FAM_PROFILE_END_ALLOCATOR(fam_xor);
 
     FAM_PROFILE_START_OPS(fam_xor);
+    traceScope.submit();
     if (ret == 0) {
         famOps->atomic_xor(descriptor, offset, value);
     }
@@ -2520,6 +3226,10 @@ int32_t fam::Impl_::fam_fetch_int32(Fam_Descriptor *descriptor,
                                     uint64_t offset) {
     std::ostringstream message;
     FAM_CNTR_INC_API(fam_fetch);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_fetch, descriptor,
+                               sizeof(int32_t));
+    Fam_Trace_Scope traceScope(trace_fam_fetch, descriptor, offset,
+                               sizeof(int32_t));
     FAM_PROFILE_START_ALLOCATOR(fam_fetch);
     int32_t res = 0;
     if (descriptor == NULL) {
@@ -2530,6 +3240,7 @@ int32_t fam::Impl_::fam_fetch_int32(Fam_Descriptor *descriptor,
     FAM_PROFILE_END_ALLOCATOR(fam_fetch);
 
     FAM_PROFILE_START_OPS(fam_fetch);
+    traceScope.submit();
     if (ret == 0) {
         res = famOps->atomic_fetch_int32(descriptor, offset);
     }
@@ -2540,6 +3251,10 @@ int64_t fam::Impl_::fam_fetch_int64(Fam_Descriptor *descriptor,
                                     uint64_t offset) {
     std::ostringstream message;
     FAM_CNTR_INC_API(fam_fetch);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_fetch, descriptor,
+                               sizeof(int64_t));
+    Fam_Trace_Scope traceScope(trace_fam_fetch, descriptor, offset,
+                               sizeof(int64_t));
     FAM_PROFILE_START_ALLOCATOR(fam_fetch);
     int64_t res = 0;
     if (descriptor == NULL) {
@@ -2550,6 +3265,7 @@ int64_t fam::Impl_::fam_fetch_int64(Fam_Descriptor *descriptor,
     FAM_PROFILE_END_ALLOCATOR(fam_fetch);
 
     FAM_PROFILE_START_OPS(fam_fetch);
+    traceScope.submit();
     if (ret == 0) {
         res = famOps->atomic_fetch_int64(descriptor, offset);
     }
@@ -2560,6 +3276,10 @@ int128_t fam::Impl_::fam_fetch_int128(Fam_Descriptor *descriptor,
                                       uint64_t offset) {
     std::ostringstream message;
     FAM_CNTR_INC_API(fam_fetch);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_fetch, descriptor,
+                               sizeof(int128_t));
+    Fam_Trace_Scope traceScope(trace_fam_fetch, descriptor, offset,
+                               sizeof(int128_t));
     FAM_PROFILE_START_ALLOCATOR(fam_fetch);
     int128_t res = 0;
     if (descriptor == NULL) {
@@ -2570,6 +3290,7 @@ int128_t fam::Impl_::fam_fetch_int128(Fam_Descriptor *descriptor,
     FAM_PROFILE_END_ALLOCATOR(fam_fetch);
 
     FAM_PROFILE_START_OPS(fam_fetch);
+    traceScope.submit();
     if (ret == 0) {
         res = famOps->atomic_fetch_int128(descriptor, offset);
     }
@@ -2581,6 +3302,10 @@ uint32_t fam::Impl_::fam_fetch_uint32(Fam_Descriptor *descriptor,
                                       uint64_t offset) {
     std::ostringstream message;
     FAM_CNTR_INC_API(fam_fetch);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_fetch, descriptor,
+                               sizeof(uint32_t));
+    Fam_Trace_Scope traceScope(trace_fam_fetch, descriptor, offset,
+                               sizeof(uint32_t));
     FAM_PROFILE_START_ALLOCATOR(fam_fetch);
     uint32_t res = 0;
     if (descriptor == NULL) {
@@ -2591,6 +3316,7 @@ uint32_t fam::Impl_::fam_fetch_uint32(Fam_Descriptor *descriptor,
     FAM_PROFILE_END_ALLOCATOR(fam_fetch);
 
     FAM_PROFILE_START_OPS(fam_fetch);
+    traceScope.submit();
     if (ret == 0) {
         res = famOps->atomic_fetch_uint32(descriptor, offset);
     }
@@ -2601,6 +3327,10 @@ uint64_t fam::Impl_::fam_fetch_uint64(Fam_Descriptor *descriptor,
                                       uint64_t offset) {
     std::ostringstream message;
     FAM_CNTR_INC_API(fam_fetch);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_fetch, descriptor,
+                               sizeof(uint64_t));
+    Fam_Trace_Scope traceScope(trace_fam_fetch, descriptor, offset,
+                               sizeof(uint64_t));
     FAM_PROFILE_START_ALLOCATOR(fam_fetch);
     uint64_t res = 0;
     if (descriptor == NULL) {
@@ -2611,6 +3341,7 @@ uint64_t fam::Impl_::fam_fetch_uint64(Fam_Descriptor *descriptor,
     FAM_PROFILE_END_ALLOCATOR(fam_fetch);
 
     FAM_PROFILE_START_OPS(fam_fetch);
+    traceScope.submit();
     if (ret == 0) {
         res = famOps->atomic_fetch_uint64(descriptor, offset);
     }
@@ -2620,6 +3351,10 @@ uint64_t fam::Impl_::fam_fetch_uint64(Fam_Descriptor *descriptor,
 float fam::Impl_::fam_fetch_float(Fam_Descriptor *descriptor, uint64_t offset) {
     std::ostringstream message;
     FAM_CNTR_INC_API(fam_fetch);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_fetch, descriptor,
+                               sizeof(float));
+    Fam_Trace_Scope traceScope(trace_fam_fetch, descriptor, offset,
+                               sizeof(float));
     FAM_PROFILE_START_ALLOCATOR(fam_fetch);
     float res = 0;
     if (descriptor == NULL) {
@@ -2630,6 +3365,7 @@ float fam::Impl_::fam_fetch_float(Fam_Descriptor *descriptor, uint64_t offset) {
     FAM_PROFILE_END_ALLOCATOR(fam_fetch);
 
     FAM_PROFILE_START_OPS(fam_fetch);
+    traceScope.submit();
     if (ret == 0) {
         res = famOps->atomic_fetch_float(descriptor, offset);
     }
@@ -2640,6 +3376,10 @@ double fam::Impl_::fam_fetch_double(Fam_Descriptor *descriptor,
                                     uint64_t offset) {
     std::ostringstream message;
     FAM_CNTR_INC_API(fam_fetch);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_fetch, descriptor,
+                               sizeof(double));
+    Fam_Trace_Scope traceScope(trace_fam_fetch, descriptor, offset,
+                               sizeof(double));
     FAM_PROFILE_START_ALLOCATOR(fam_fetch);
     double res = 0;
     if (descriptor == NULL) {
@@ -2650,6 +3390,7 @@ double fam::Impl_::fam_fetch_double(Fam_Descriptor *descriptor,
     FAM_PROFILE_END_ALLOCATOR(fam_fetch);
 
     FAM_PROFILE_START_OPS(fam_fetch);
+    traceScope.submit();
     if (ret == 0) {
         res = famOps->atomic_fetch_double(descriptor, offset);
     }
@@ -2670,6 +3411,10 @@ int32_t fam::Impl_::fam_swap(Fam_Descriptor *descriptor, uint64_t offset,
                              int32_t value) {
     std::ostringstream message;
     FAM_CNTR_INC_API(fam_swap);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_swap, descriptor,
+                               sizeof(value));
+    Fam_Trace_Scope traceScope(trace_fam_swap, descriptor, offset,
+                               sizeof(value));
     FAM_PROFILE_START_ALLOCATOR(fam_swap);
     int32_t res = 0;
     if (descriptor == NULL) {
@@ -2680,6 +3425,7 @@ int32_t fam::Impl_::fam_swap(Fam_Descriptor *descriptor, uint64_t offset,
     FAM_PROFILE_END_ALLOCATOR(fam_swap);
 
     FAM_PROFILE_START_OPS(fam_swap);
+    traceScope.submit();
     if (ret == 0) {
         res = famOps->swap(descriptor, offset, value);
     }
@@ -2690,6 +3436,10 @@ int64_t fam::Impl_::fam_swap(Fam_Descriptor *descriptor, uint64_t offset,
                              int64_t value) {
     std::ostringstream message;
     FAM_CNTR_INC_API(fam_swap);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_swap, descriptor,
+                               sizeof(value));
+    Fam_Trace_Scope traceScope(trace_fam_swap, descriptor, offset,
+                               sizeof(value));
     FAM_PROFILE_START_ALLOCATOR(fam_swap);
     int64_t res = 0;
     if (descriptor == NULL) {
@@ -2700,6 +3450,7 @@ int64_t fam::Impl_::fam_swap(Fam_Descriptor *descriptor, uint64_t offset,
     FAM_PROFILE_END_ALLOCATOR(fam_swap);
 
     FAM_PROFILE_START_OPS(fam_swap);
+    traceScope.submit();
     if (ret == 0) {
         res = famOps->swap(descriptor, offset, value);
     }
@@ -2710,6 +3461,10 @@ uint32_t fam::Impl_::fam_swap(Fam_Descriptor *descriptor, uint64_t offset,
                               uint32_t value) {
     std::ostringstream message;
     FAM_CNTR_INC_API(fam_swap);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_swap, descriptor,
+                               sizeof(value));
+    Fam_Trace_Scope traceScope(trace_fam_swap, descriptor, offset,
+                               sizeof(value));
     FAM_PROFILE_START_ALLOCATOR(fam_swap);
     uint32_t res = 0;
     if (descriptor == NULL) {
@@ -2720,6 +3475,7 @@ uint32_t fam::Impl_::fam_swap(Fam_Descriptor *descriptor, uint64_t offset,
     FAM_PROFILE_END_ALLOCATOR(fam_swap);
 
     FAM_PROFILE_START_OPS(fam_swap);
+    traceScope.submit();
     if (ret == 0) {
         res = famOps->swap(descriptor, offset, value);
     }
@@ -2730,6 +3486,10 @@ uint64_t fam::Impl_::fam_swap(Fam_Descriptor *descriptor, uint64_t offset,
                               uint64_t value) {
     std::ostringstream message;
     FAM_CNTR_INC_API(fam_swap);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_swap, descriptor,
+                               sizeof(value));
+    Fam_Trace_Scope traceScope(trace_fam_swap, descriptor, offset,
+                               sizeof(value));
     FAM_PROFILE_START_ALLOCATOR(fam_swap);
     uint64_t res = 0;
     if (descriptor == NULL) {
@@ -2740,6 +3500,7 @@ uint64_t fam::Impl_::fam_swap(Fam_Descriptor *descriptor, uint64_t offset,
     FAM_PROFILE_END_ALLOCATOR(fam_swap);
 
     FAM_PROFILE_START_OPS(fam_swap);
+    traceScope.submit();
     if (ret == 0) {
         res = famOps->swap(descriptor, offset, value);
     }
@@ -2750,6 +3511,10 @@ float fam::Impl_::fam_swap(Fam_Descriptor *descriptor, uint64_t offset,
                            float value) {
     std::ostringstream message;
     FAM_CNTR_INC_API(fam_swap);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_swap, descriptor,
+                               sizeof(value));
+    Fam_Trace_Scope traceScope(trace_fam_swap, descriptor, offset,
+                               sizeof(value));
     FAM_PROFILE_START_ALLOCATOR(fam_swap);
     float res = 0;
     if (descriptor == NULL) {
@@ -2760,6 +3525,7 @@ float fam::Impl_::fam_swap(Fam_Descriptor *descriptor, uint64_t offset,
     FAM_PROFILE_END_ALLOCATOR(fam_swap);
 
     FAM_PROFILE_START_OPS(fam_swap);
+    traceScope.submit();
     if (ret == 0) {
         res = famOps->swap(descriptor, offset, value);
     }
@@ -2770,6 +3536,10 @@ double fam::Impl_::fam_swap(Fam_Descriptor *descriptor, uint64_t offset,
                             double value) {
     std::ostringstream message;
     FAM_CNTR_INC_API(fam_swap);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_swap, descriptor,
+                               sizeof(value));
+    Fam_Trace_Scope traceScope(trace_fam_swap, descriptor, offset,
+                               sizeof(value));
     FAM_PROFILE_START_ALLOCATOR(fam_swap);
     double res = 0;
     if (descriptor == NULL) {
@@ -2780,6 +3550,7 @@ double fam::Impl_::fam_swap(Fam_Descriptor *descriptor, uint64_t offset,
     FAM_PROFILE_END_ALLOCATOR(fam_swap);
 
     FAM_PROFILE_START_OPS(fam_swap);
+    traceScope.submit();
     if (ret == 0) {
         res = famOps->swap(descriptor, offset, value);
     }
@@ -2803,6 +3574,10 @@ int32_t fam::Impl_::fam_compare_swap(Fam_Descriptor *descriptor,
                                      int32_t newValue) {
     std::ostringstream message;
     FAM_CNTR_INC_API(fam_compare_swap);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_compare_swap, descriptor,
+                               sizeof(oldValue));
+    Fam_Trace_Scope traceScope(trace_fam_compare_swap, descriptor, offset,
+                               sizeof(oldValue));
     FAM_PROFILE_START_ALLOCATOR(fam_compare_swap);
     int32_t res = 0;
     if (descriptor == NULL) {
@@ -2813,6 +3588,7 @@ int32_t fam::Impl_::fam_compare_swap(Fam_Descriptor *descriptor,
     FAM_PROFILE_END_ALLOCATOR(fam_compare_swap);
 
     FAM_PROFILE_START_OPS(fam_compare_swap);
+    traceScope.submit();
     if (ret == 0) {
         res = famOps->compare_swap(descriptor, offset, oldValue, newValue);
     }
@@ -2824,6 +3600,10 @@ int64_t fam::Impl_::fam_compare_swap(Fam_Descriptor *descriptor,
                                      int64_t newValue) {
     std::ostringstream message;
     FAM_CNTR_INC_API(fam_compare_swap);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_compare_swap, descriptor,
+                               sizeof(oldValue));
+    Fam_Trace_Scope traceScope(trace_fam_compare_swap, descriptor, offset,
+                               sizeof(oldValue));
     FAM_PROFILE_START_ALLOCATOR(fam_compare_swap);
     int64_t res = 0;
     if (descriptor == NULL) {
@@ -2834,6 +3614,7 @@ int64_t fam::Impl_::fam_compare_swap(Fam_Descriptor *descriptor,
     FAM_PROFILE_END_ALLOCATOR(fam_compare_swap);
 
     FAM_PROFILE_START_OPS(fam_compare_swap);
+    traceScope.submit();
     if (ret == 0) {
         res = famOps->compare_swap(descriptor, offset, oldValue, newValue);
     }
@@ -2845,6 +3626,10 @@ uint32_t fam::Impl_::fam_compare_swap(Fam_Descriptor *descriptor,
                                       uint32_t newValue) {
     std::ostringstream message;
     FAM_CNTR_INC_API(fam_compare_swap);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_compare_swap, descriptor,
+                               sizeof(oldValue));
+    Fam_Trace_Scope traceScope(trace_fam_compare_swap, descriptor, offset,
+                               sizeof(oldValue));
     FAM_PROFILE_START_ALLOCATOR(fam_compare_swap);
     uint32_t res = 0;
     if (descriptor == NULL) {
@@ -2855,6 +3640,7 @@ uint32_t fam::Impl_::fam_compare_swap(Fam_Descriptor *descriptor,
     FAM_PROFILE_END_ALLOCATOR(fam_compare_swap);
 
     FAM_PROFILE_START_OPS(fam_compare_swap);
+    traceScope.submit();
     if (ret == 0) {
         res = famOps->compare_swap(descriptor, offset, oldValue, newValue);
     }
@@ -2866,6 +3652,10 @@ uint64_t fam::Impl_::fam_compare_swap(Fam_Descriptor *descriptor,
                                       uint64_t newValue) {
     std::ostringstream message;
     FAM_CNTR_INC_API(fam_compare_swap);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_compare_swap, descriptor,
+                               sizeof(oldValue));
+    Fam_Trace_Scope traceScope(trace_fam_compare_swap, descriptor, offset,
+                               sizeof(oldValue));
     FAM_PROFILE_START_ALLOCATOR(fam_compare_swap);
     uint64_t res = 0;
     if (descriptor == NULL) {
@@ -2876,6 +3666,7 @@ uint64_t fam::Impl_::fam_compare_swap(Fam_Descriptor *descriptor,
     FAM_PROFILE_END_ALLOCATOR(fam_compare_swap);
 
     FAM_PROFILE_START_OPS(fam_compare_swap);
+    traceScope.submit();
     if (ret == 0) {
         res = famOps->compare_swap(descriptor, offset, oldValue, newValue);
     }
@@ -2887,6 +3678,10 @@ int128_t fam::Impl_::fam_compare_swap(Fam_Descriptor *descriptor,
                                       int128_t newValue) {
     std::ostringstream message;
     FAM_CNTR_INC_API(fam_compare_swap);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_compare_swap, descriptor,
+                               sizeof(oldValue));
+    Fam_Trace_Scope traceScope(trace_fam_compare_swap, descriptor, offset,
+                               sizeof(oldValue));
     FAM_PROFILE_START_ALLOCATOR(fam_compare_swap);
     int128_t res = 0;
     if (descriptor == NULL) {
@@ -2897,6 +3692,7 @@ int128_t fam::Impl_::fam_compare_swap(Fam_Descriptor *descriptor,
     FAM_PROFILE_END_ALLOCATOR(fam_compare_swap);
 
     FAM_PROFILE_START_OPS(fam_compare_swap);
+    traceScope.submit();
     if (ret == 0) {
         res = famOps->compare_swap(descriptor, offset, oldValue, newValue);
     }
@@ -2916,6 +3712,10 @@ int32_t fam::Impl_::fam_fetch_add(Fam_Descriptor *descriptor, uint64_t offset,
                                   int32_t value) {
     std::ostringstream message;
     FAM_CNTR_INC_API(fam_fetch_add);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_fetch_add, descriptor,
+                               sizeof(value));
+    Fam_Trace_Scope traceScope(trace_fam_fetch_add, descriptor, offset,
+                               sizeof(value));
     FAM_PROFILE_START_ALLOCATOR(fam_fetch_add);
     int32_t old = 0;
     if (descriptor == NULL) {
@@ -2926,6 +3726,7 @@ int32_t fam::Impl_::fam_fetch_add(Fam_Descriptor *descriptor, uint64_t offset,
     FAM_PROFILE_END_ALLOCATOR(fam_fetch_add);
 
     FAM_PROFILE_START_OPS(fam_fetch_add);
+    traceScope.submit();
     if (ret == 0) {
         old = famOps->atomic_fetch_add(descriptor, offset, value);
     }
@@ -2936,6 +3737,10 @@ int64_t fam::Impl_::fam_fetch_add(Fam_Descriptor *descriptor, uint64_t offset,
                                   int64_t value) {
     std::ostringstream message;
     FAM_CNTR_INC_API(fam_fetch_add);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_fetch_add, descriptor,
+                               sizeof(value));
+    Fam_Trace_Scope traceScope(trace_fam_fetch_add, descriptor, offset,
+                               sizeof(value));
     FAM_PROFILE_START_ALLOCATOR(fam_fetch_add);
     int64_t old = 0;
     if (descriptor == NULL) {
@@ -2946,6 +3751,7 @@ int64_t fam::Impl_::fam_fetch_add(Fam_Descriptor *descriptor, uint64_t offset,
     FAM_PROFILE_END_ALLOCATOR(fam_fetch_add);
 
     FAM_PROFILE_START_OPS(fam_fetch_add);
+    traceScope.submit();
     if (ret == 0) {
         old = famOps->atomic_fetch_add(descriptor, offset, value);
     }
@@ -2956,6 +3762,10 @@ uint32_t fam::Impl_::fam_fetch_add(Fam_Descriptor *descriptor, uint64_t offset,
                                    uint32_t value) {
     std::ostringstream message;
     FAM_CNTR_INC_API(fam_fetch_add);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_fetch_add, descriptor,
+                               sizeof(value));
+    Fam_Trace_Scope traceScope(trace_fam_fetch_add, descriptor, offset,
+                               sizeof(value));
     FAM_PROFILE_START_ALLOCATOR(fam_fetch_add);
     uint32_t old = 0;
     if (descriptor == NULL) {
@@ -2966,6 +3776,7 @@ uint32_t fam::Impl_::fam_fetch_add(Fam_Descriptor *descriptor, uint64_t offset,
     FAM_PROFILE_END_ALLOCATOR(fam_fetch_add);
 
     FAM_PROFILE_START_OPS(fam_fetch_add);
+    traceScope.submit();
     if (ret == 0) {
         old = famOps->atomic_fetch_add(descriptor, offset, value);
     }
@@ -2977,6 +3788,10 @@ uint64_t fam::Impl_::fam_fetch_add(Fam_Descriptor *descriptor, uint64_t offset,
                                    uint64_t value) {
     std::ostringstream message;
     FAM_CNTR_INC_API(fam_fetch_add);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_fetch_add, descriptor,
+                               sizeof(value));
+    Fam_Trace_Scope traceScope(trace_fam_fetch_add, descriptor, offset,
+                               sizeof(value));
     FAM_PROFILE_START_ALLOCATOR(fam_fetch_add);
     uint64_t old = 0;
     if (descriptor == NULL) {
@@ -2987,6 +3802,7 @@ uint64_t fam::Impl_::fam_fetch_add(Fam_Descriptor *descriptor, uint64_t offset,
     FAM_PROFILE_END_ALLOCATOR(fam_fetch_add);
 
     FAM_PROFILE_START_OPS(fam_fetch_add);
+    traceScope.submit();
     if (ret == 0) {
         old = famOps->atomic_fetch_add(descriptor, offset, value);
     }
@@ -2998,6 +3814,10 @@ float fam::Impl_::fam_fetch_add(Fam_Descriptor *descriptor, uint64_t offset,
                                 float value) {
     std::ostringstream message;
     FAM_CNTR_INC_API(fam_fetch_add);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_fetch_add, descriptor,
+                               sizeof(value));
+    Fam_Trace_Scope traceScope(trace_fam_fetch_add, descriptor, offset,
+                               sizeof(value));
     FAM_PROFILE_START_ALLOCATOR(fam_fetch_add);
     float old = 0;
     if (descriptor == NULL) {
@@ -3008,6 +3828,7 @@ float fam::Impl_::fam_fetch_add(Fam_Descriptor *descriptor, uint64_t offset,
     FAM_PROFILE_END_ALLOCATOR(fam_fetch_add);
 
     FAM_PROFILE_START_OPS(fam_fetch_add);
+    traceScope.submit();
     if (ret == 0) {
         old = famOps->atomic_fetch_add(descriptor, offset, value);
     }
@@ -3018,6 +3839,10 @@ double fam::Impl_::fam_fetch_add(Fam_Descriptor *descriptor, uint64_t offset,
                                  double value) {
     std::ostringstream message;
     FAM_CNTR_INC_API(fam_fetch_add);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_fetch_add, descriptor,
+                               sizeof(value));
+    Fam_Trace_Scope traceScope(trace_fam_fetch_add, descriptor, offset,
+                               sizeof(value));
     FAM_PROFILE_START_ALLOCATOR(fam_fetch_add);
     double old = 0;
     if (descriptor == NULL) {
@@ -3028,6 +3853,7 @@ double fam::Impl_::fam_fetch_add(Fam_Descriptor *descriptor, uint64_t offset,
     FAM_PROFILE_END_ALLOCATOR(fam_fetch_add);
 
     FAM_PROFILE_START_OPS(fam_fetch_add);
+    traceScope.submit();
     if (ret == 0) {
         old = famOps->atomic_fetch_add(descriptor, offset, value);
     }
@@ -3048,6 +3874,10 @@ int32_t fam::Impl_::fam_fetch_subtract(Fam_Descriptor *descriptor,
                                        uint64_t offset, int32_t value) {
     std::ostringstream message;
     FAM_CNTR_INC_API(fam_fetch_subtract);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_fetch_subtract, descriptor,
+                               sizeof(value));
+    Fam_Trace_Scope traceScope(trace_fam_fetch_subtract, descriptor, offset,
+                               sizeof(value));
     FAM_PROFILE_START_ALLOCATOR(fam_fetch_subtract);
     int32_t old = 0;
     if (descriptor == NULL) {
@@ -3058,6 +3888,7 @@ int32_t fam::Impl_::fam_fetch_subtract(Fam_Descriptor *descriptor,
     FAM_PROFILE_END_ALLOCATOR(fam_fetch_subtract);
 
     FAM_PROFILE_START_OPS(fam_fetch_subtract);
+    traceScope.submit();
     if (ret == 0) {
         old = famOps->atomic_fetch_subtract(descriptor, offset, value);
     }
@@ -3068,6 +3899,10 @@ int64_t fam::Impl_::fam_fetch_subtract(Fam_Descriptor *descriptor,
                                        uint64_t offset, int64_t value) {
     std::ostringstream message;
     FAM_CNTR_INC_API(fam_fetch_subtract);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_fetch_subtract, descriptor,
+                               sizeof(value));
+    Fam_Trace_Scope traceScope(trace_fam_fetch_subtract, descriptor, offset,
+                               sizeof(value));
     FAM_PROFILE_START_ALLOCATOR(fam_fetch_subtract);
     int64_t old = 0;
     if (descriptor == NULL) {
@@ -3078,6 +3913,7 @@ int64_t fam::Impl_::fam_fetch_subtract(Fam_Descriptor *descriptor,
     FAM_PROFILE_END_ALLOCATOR(fam_fetch_subtract);
 
     FAM_PROFILE_START_OPS(fam_fetch_subtract);
+    traceScope.submit();
     if (ret == 0) {
         old = famOps->atomic_fetch_subtract(descriptor, offset, value);
     }
@@ -3089,6 +3925,10 @@ uint32_t fam::Impl_::fam_fetch_subtract(Fam_Descriptor *descriptor,
 
     std::ostringstream message;
     FAM_CNTR_INC_API(fam_fetch_subtract);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_fetch_subtract, descriptor,
+                               sizeof(value));
+    Fam_Trace_Scope traceScope(trace_fam_fetch_subtract, descriptor, offset,
+                               sizeof(value));
     FAM_PROFILE_START_ALLOCATOR(fam_fetch_subtract);
     uint32_t old = 0;
     if (descriptor == NULL) {
@@ -3099,6 +3939,7 @@ uint32_t fam::Impl_::fam_fetch_subtract(Fam_Descriptor *descriptor,
     FAM_PROFILE_END_ALLOCATOR(fam_fetch_subtract);
 
     FAM_PROFILE_START_OPS(fam_fetch_subtract);
+    traceScope.submit();
     if (ret == 0) {
         old = famOps->atomic_fetch_subtract(descriptor, offset, value);
     }
@@ -3110,6 +3951,10 @@ uint64_t fam::Impl_::fam_fetch_subtract(Fam_Descriptor *descriptor,
 
     std::ostringstream message;
     FAM_CNTR_INC_API(fam_fetch_subtract);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_fetch_subtract, descriptor,
+                               sizeof(value));
+    Fam_Trace_Scope traceScope(trace_fam_fetch_subtract, descriptor, offset,
+                               sizeof(value));
     FAM_PROFILE_START_ALLOCATOR(fam_fetch_subtract);
     uint64_t old = 0;
     if (descriptor == NULL) {
@@ -3120,6 +3965,7 @@ uint64_t fam::Impl_::fam_fetch_subtract(Fam_Descriptor *descriptor,
     FAM_PROFILE_END_ALLOCATOR(fam_fetch_subtract);
 
     FAM_PROFILE_START_OPS(fam_fetch_subtract);
+    traceScope.submit();
     if (ret == 0) {
         old = famOps->atomic_fetch_subtract(descriptor, offset, value);
     }
@@ -3130,6 +3976,10 @@ float fam::Impl_::fam_fetch_subtract(Fam_Descriptor *descriptor,
                                      uint64_t offset, float value) {
     std::ostringstream message;
     FAM_CNTR_INC_API(fam_fetch_subtract);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_fetch_subtract, descriptor,
+                               sizeof(value));
+    Fam_Trace_Scope traceScope(trace_fam_fetch_subtract, descriptor, offset,
+                               sizeof(value));
     FAM_PROFILE_START_ALLOCATOR(fam_fetch_subtract);
     float old = 0;
     if (descriptor == NULL) {
@@ -3140,6 +3990,7 @@ float fam::Impl_::fam_fetch_subtract(Fam_Descriptor *descriptor,
     FAM_PROFILE_END_ALLOCATOR(fam_fetch_subtract);
 
     FAM_PROFILE_START_OPS(fam_fetch_subtract);
+    traceScope.submit();
     if (ret == 0) {
         old = famOps->atomic_fetch_subtract(descriptor, offset, value);
     }
@@ -3150,6 +4001,10 @@ double fam::Impl_::fam_fetch_subtract(Fam_Descriptor *descriptor,
                                       uint64_t offset, double value) {
     std::ostringstream message;
     FAM_CNTR_INC_API(fam_fetch_subtract);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_fetch_subtract, descriptor,
+                               sizeof(value));
+    Fam_Trace_Scope traceScope(trace_fam_fetch_subtract, descriptor, offset,
+                               sizeof(value));
     FAM_PROFILE_START_ALLOCATOR(fam_fetch_subtract);
     double old = 0;
     if (descriptor == NULL) {
@@ -3160,6 +4015,7 @@ double fam::Impl_::fam_fetch_subtract(Fam_Descriptor *descriptor,
     FAM_PROFILE_END_ALLOCATOR(fam_fetch_subtract);
 
     FAM_PROFILE_START_OPS(fam_fetch_subtract);
+    traceScope.submit();
     if (ret == 0) {
         old = famOps->atomic_fetch_subtract(descriptor, offset, value);
     }
@@ -3181,6 +4037,10 @@ int32_t fam::Impl_::fam_fetch_min(Fam_Descriptor *descriptor, uint64_t offset,
                                   int32_t value) {
     std::ostringstream message;
     FAM_CNTR_INC_API(fam_fetch_min);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_fetch_min, descriptor,
+                               sizeof(value));
+    Fam_Trace_Scope traceScope(trace_fam_fetch_min, descriptor, offset,
+                               sizeof(value));
     FAM_PROFILE_START_ALLOCATOR(fam_fetch_min);
     int32_t old = 0;
     if (descriptor == NULL) {
@@ -3191,6 +4051,7 @@ int32_t fam::Impl_::fam_fetch_min(Fam_Descriptor *descriptor, uint64_t offset,
     FAM_PROFILE_END_ALLOCATOR(fam_fetch_min);
 
     FAM_PROFILE_START_OPS(fam_fetch_min);
+    traceScope.submit();
     if (ret == 0) {
         old = famOps->atomic_fetch_min(descriptor, offset, value);
     }
@@ -3201,6 +4062,10 @@ int64_t fam::Impl_::fam_fetch_min(Fam_Descriptor *descriptor, uint64_t offset,
                                   int64_t value) {
     std::ostringstream message;
     FAM_CNTR_INC_API(fam_fetch_min);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_fetch_min, descriptor,
+                               sizeof(value));
+    Fam_Trace_Scope traceScope(trace_fam_fetch_min, descriptor, offset,
+                               sizeof(value));
     FAM_PROFILE_START_ALLOCATOR(fam_fetch_min);
     int64_t old = 0;
     if (descriptor == NULL) {
@@ -3211,6 +4076,7 @@ int64_t fam::Impl_::fam_fetch_min(Fam_Descriptor *descriptor, uint64_t offset,
     FAM_PROFILE_END_ALLOCATOR(fam_fetch_min);
 
     FAM_PROFILE_START_OPS(fam_fetch_min);
+    traceScope.submit();
     if (ret == 0) {
         old = famOps->atomic_fetch_min(descriptor, offset, value);
     }
@@ -3221,6 +4087,10 @@ uint32_t fam::Impl_::fam_fetch_min(Fam_Descriptor *descriptor, uint64_t offset,
                                    uint32_t value) {
     std::ostringstream message;
     FAM_CNTR_INC_API(fam_fetch_min);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_fetch_min, descriptor,
+                               sizeof(value));
+    Fam_Trace_Scope traceScope(trace_fam_fetch_min, descriptor, offset,
+                               sizeof(value));
     FAM_PROFILE_START_ALLOCATOR(fam_fetch_min);
     uint32_t old = 0;
     if (descriptor == NULL) {
@@ -3231,6 +4101,7 @@ uint32_t fam::Impl_::fam_fetch_min(Fam_Descriptor *descriptor, uint64_t offset,
     FAM_PROFILE_END_ALLOCATOR(fam_fetch_min);
 
     FAM_PROFILE_START_OPS(fam_fetch_min);
+    traceScope.submit();
     if (ret == 0) {
         old = famOps->atomic_fetch_min(descriptor, offset, value);
     }
@@ -3241,6 +4112,10 @@ uint64_t fam::Impl_::fam_fetch_min(Fam_Descriptor *descriptor, uint64_t offset,
                                    uint64_t value) {
     std::ostringstream message;
     FAM_CNTR_INC_API(fam_fetch_min);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_fetch_min, descriptor,
+                               sizeof(value));
+    Fam_Trace_Scope traceScope(trace_fam_fetch_min, descriptor, offset,
+                               sizeof(value));
     FAM_PROFILE_START_ALLOCATOR(fam_fetch_min);
     uint64_t old = 0;
     if (descriptor == NULL) {
@@ -3251,6 +4126,7 @@ uint64_t fam::Impl_::fam_fetch_min(Fam_Descriptor *descriptor, uint64_t offset,
     FAM_PROFILE_END_ALLOCATOR(fam_fetch_min);
 
     FAM_PROFILE_START_OPS(fam_fetch_min);
+    traceScope.submit();
     if (ret == 0) {
         old = famOps->atomic_fetch_min(descriptor, offset, value);
     }
@@ -3261,6 +4137,10 @@ float fam::Impl_::fam_fetch_min(Fam_Descriptor *descriptor, uint64_t offset,
                                 float value) {
     std::ostringstream message;
     FAM_CNTR_INC_API(fam_fetch_min);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_fetch_min, descriptor,
+                               sizeof(value));
+    Fam_Trace_Scope traceScope(trace_fam_fetch_min, descriptor, offset,
+                               sizeof(value));
     FAM_PROFILE_START_ALLOCATOR(fam_fetch_min);
     float old = 0;
     if (descriptor == NULL) {
@@ -3271,6 +4151,7 @@ float fam::Impl_::fam_fetch_min(Fam_Descriptor *descriptor, uint64_t offset,
     FAM_PROFILE_END_ALLOCATOR(fam_fetch_min);
 
     FAM_PROFILE_START_OPS(fam_fetch_min);
+    traceScope.submit();
     if (ret == 0) {
         old = famOps->atomic_fetch_min(descriptor, offset, value);
     }
@@ -3281,6 +4162,10 @@ double fam::Impl_::fam_fetch_min(Fam_Descriptor *descriptor, uint64_t offset,
                                  double value) {
     std::ostringstream message;
     FAM_CNTR_INC_API(fam_fetch_min);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_fetch_min, descriptor,
+                               sizeof(value));
+    Fam_Trace_Scope traceScope(trace_fam_fetch_min, descriptor, offset,
+                               sizeof(value));
     FAM_PROFILE_START_ALLOCATOR(fam_fetch_min);
     double old = 0;
     if (descriptor == NULL) {
@@ -3291,6 +4176,7 @@ double fam::Impl_::fam_fetch_min(Fam_Descriptor *descriptor, uint64_t offset,
     FAM_PROFILE_END_ALLOCATOR(fam_fetch_min);
 
     FAM_PROFILE_START_OPS(fam_fetch_min);
+    traceScope.submit();
     if (ret == 0) {
         old = famOps->atomic_fetch_min(descriptor, offset, value);
     }
@@ -3312,6 +4198,10 @@ int32_t fam::Impl_::fam_fetch_max(Fam_Descriptor *descriptor, uint64_t offset,
                                   int32_t value) {
     std::ostringstream message;
     FAM_CNTR_INC_API(fam_fetch_max);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_fetch_max, descriptor,
+                               sizeof(value));
+    Fam_Trace_Scope traceScope(trace_fam_fetch_max, descriptor, offset,
+                               sizeof(value));
     FAM_PROFILE_START_ALLOCATOR(fam_fetch_max);
     int32_t old = 0;
     if (descriptor == NULL) {
@@ -3322,6 +4212,7 @@ int32_t fam::Impl_::fam_fetch_max(Fam_Descriptor *descriptor, uint64_t offset,
     FAM_PROFILE_END_ALLOCATOR(fam_fetch_max);
 
     FAM_PROFILE_START_OPS(fam_fetch_max);
+    traceScope.submit();
     if (ret == 0) {
         old = famOps->atomic_fetch_max(descriptor, offset, value);
     }
@@ -3332,6 +4223,10 @@ int64_t fam::Impl_::fam_fetch_max(Fam_Descriptor *descriptor, uint64_t offset,
                                   int64_t value) {
     std::ostringstream message;
     FAM_CNTR_INC_API(fam_fetch_max);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_fetch_max, descriptor,
+                               sizeof(value));
+    Fam_Trace_Scope traceScope(trace_fam_fetch_max, descriptor, offset,
+                               sizeof(value));
     FAM_PROFILE_START_ALLOCATOR(fam_fetch_max);
     int64_t old = 0;
     if (descriptor == NULL) {
@@ -3342,6 +4237,7 @@ int64_t fam::Impl_::fam_fetch_max(Fam_Descriptor *descriptor, uint64_t offset,
     FAM_PROFILE_END_ALLOCATOR(fam_fetch_max);
 
     FAM_PROFILE_START_OPS(fam_fetch_max);
+    traceScope.submit();
     if (ret == 0) {
         old = famOps->atomic_fetch_max(descriptor, offset, value);
     }
@@ -3352,6 +4248,10 @@ uint32_t fam::Impl_::fam_fetch_max(Fam_Descriptor *descriptor, uint64_t offset,
                                    uint32_t value) {
     std::ostringstream message;
     FAM_CNTR_INC_API(fam_fetch_max);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_fetch_max, descriptor,
+                               sizeof(value));
+    Fam_Trace_Scope traceScope(trace_fam_fetch_max, descriptor, offset,
+                               sizeof(value));
     FAM_PROFILE_START_ALLOCATOR(fam_fetch_max);
     uint32_t old = 0;
     if (descriptor == NULL) {
@@ -3362,6 +4262,7 @@ uint32_t fam::Impl_::fam_fetch_max(Fam_Descriptor *descriptor, uint64_t offset,
     FAM_PROFILE_END_ALLOCATOR(fam_fetch_max);
 
     FAM_PROFILE_START_OPS(fam_fetch_max);
+    traceScope.submit();
     if (ret == 0) {
         old = famOps->atomic_fetch_max(descriptor, offset, value);
     }
@@ -3372,6 +4273,10 @@ uint64_t fam::Impl_::fam_fetch_max(Fam_Descriptor *descriptor, uint64_t offset,
                                    uint64_t value) {
     std::ostringstream message;
     FAM_CNTR_INC_API(fam_fetch_max);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_fetch_max, descriptor,
+                               sizeof(value));
+    Fam_Trace_Scope traceScope(trace_fam_fetch_max, descriptor, offset,
+                               sizeof(value));
     FAM_PROFILE_START_ALLOCATOR(fam_fetch_max);
     uint64_t old = 0;
     if (descriptor == NULL) {
@@ -3382,6 +4287,7 @@ uint64_t fam::Impl_::fam_fetch_max(Fam_Descriptor *descriptor, uint64_t offset,
     FAM_PROFILE_END_ALLOCATOR(fam_fetch_max);
 
     FAM_PROFILE_START_OPS(fam_fetch_max);
+    traceScope.submit();
     if (ret == 0) {
         old = famOps->atomic_fetch_max(descriptor, offset, value);
     }
@@ -3392,6 +4298,10 @@ float fam::Impl_::fam_fetch_max(Fam_Descriptor *descriptor, uint64_t offset,
                                 float value) {
     std::ostringstream message;
     FAM_CNTR_INC_API(fam_fetch_max);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_fetch_max, descriptor,
+                               sizeof(value));
+    Fam_Trace_Scope traceScope(trace_fam_fetch_max, descriptor, offset,
+                               sizeof(value));
     FAM_PROFILE_START_ALLOCATOR(fam_fetch_max);
     float old = 0;
     if (descriptor == NULL) {
@@ -3402,6 +4312,7 @@ float fam::Impl_::fam_fetch_max(Fam_Descriptor *descriptor, uint64_t offset,
     FAM_PROFILE_END_ALLOCATOR(fam_fetch_max);
 
     FAM_PROFILE_START_OPS(fam_fetch_max);
+    traceScope.submit();
     if (ret == 0) {
         old = famOps->atomic_fetch_max(descriptor, offset, value);
     }
@@ -3412,6 +4323,10 @@ double fam::Impl_::fam_fetch_max(Fam_Descriptor *descriptor, uint64_t offset,
                                  double value) {
     std::ostringstream message;
     FAM_CNTR_INC_API(fam_fetch_max);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_fetch_max, descriptor,
+                               sizeof(value));
+    Fam_Trace_Scope traceScope(trace_fam_fetch_max, descriptor, offset,
+                               sizeof(value));
     FAM_PROFILE_START_ALLOCATOR(fam_fetch_max);
     double old = 0;
     if (descriptor == NULL) {
@@ -3422,6 +4337,7 @@ double fam::Impl_::fam_fetch_max(Fam_Descriptor *descriptor, uint64_t offset,
     FAM_PROFILE_END_ALLOCATOR(fam_fetch_max);
 
     FAM_PROFILE_START_OPS(fam_fetch_max);
+    traceScope.submit();
     if (ret == 0) {
         old = famOps->atomic_fetch_max(descriptor, offset, value);
     }
@@ -3443,6 +4359,10 @@ uint32_t fam::Impl_::fam_fetch_and(Fam_Descriptor *descriptor, uint64_t offset,
                                    uint32_t value) {
     std::ostringstream message;
     FAM_CNTR_INC_API(fam_fetch_and);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_fetch_and, descriptor,
+                               sizeof(value));
+    Fam_Trace_Scope traceScope(trace_fam_fetch_and, descriptor, offset,
+                               sizeof(value));
     FAM_PROFILE_START_ALLOCATOR(fam_fetch_and);
     uint32_t old = 0;
     if (descriptor == NULL) {
@@ -3453,6 +4373,7 @@ uint32_t fam::Impl_::fam_fetch_and(Fam_Descriptor *descriptor, uint64_t offset,
     FAM_PROFILE_END_ALLOCATOR(fam_fetch_and);
 
     FAM_PROFILE_START_OPS(fam_fetch_and);
+    traceScope.submit();
     if (ret == 0) {
         old = famOps->atomic_fetch_and(descriptor, offset, value);
     }
@@ -3463,6 +4384,10 @@ uint64_t fam::Impl_::fam_fetch_and(Fam_Descriptor *descriptor, uint64_t offset,
                                    uint64_t value) {
     std::ostringstream message;
     FAM_CNTR_INC_API(fam_fetch_and);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_fetch_and, descriptor,
+                               sizeof(value));
+    Fam_Trace_Scope traceScope(trace_fam_fetch_and, descriptor, offset,
+                               sizeof(value));
     FAM_PROFILE_START_ALLOCATOR(fam_fetch_and);
     uint64_t old = 0;
     if (descriptor == NULL) {
@@ -3473,6 +4398,7 @@ uint64_t fam::Impl_::fam_fetch_and(Fam_Descriptor *descriptor, uint64_t offset,
     FAM_PROFILE_END_ALLOCATOR(fam_fetch_and);
 
     FAM_PROFILE_START_OPS(fam_fetch_and);
+    traceScope.submit();
     if (ret == 0) {
         old = famOps->atomic_fetch_and(descriptor, offset, value);
     }
@@ -3494,6 +4420,10 @@ uint32_t fam::Impl_::fam_fetch_or(Fam_Descriptor *descriptor, uint64_t offset,
                                   uint32_t value) {
     std::ostringstream message;
     FAM_CNTR_INC_API(fam_fetch_or);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_fetch_or, descriptor,
+                               sizeof(value));
+    Fam_Trace_Scope traceScope(trace_fam_fetch_or, descriptor, offset,
+                               sizeof(value));
     FAM_PROFILE_START_ALLOCATOR(fam_fetch_or);
     uint32_t old = 0;
     if (descriptor == NULL) {
@@ -3504,6 +4434,7 @@ uint32_t fam::Impl_::fam_fetch_or(Fam_Descriptor *descriptor, uint64_t offset,
     FAM_PROFILE_END_ALLOCATOR(fam_fetch_or);
 
     FAM_PROFILE_START_OPS(fam_fetch_or);
+    traceScope.submit();
     if (ret == 0) {
         old = famOps->atomic_fetch_or(descriptor, offset, value);
     }
@@ -3514,6 +4445,10 @@ uint64_t fam::Impl_::fam_fetch_or(Fam_Descriptor *descriptor, uint64_t offset,
                                   uint64_t value) {
     std::ostringstream message;
     FAM_CNTR_INC_API(fam_fetch_or);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_fetch_or, descriptor,
+                               sizeof(value));
+    Fam_Trace_Scope traceScope(trace_fam_fetch_or, descriptor, offset,
+                               sizeof(value));
     FAM_PROFILE_START_ALLOCATOR(fam_fetch_or);
     uint64_t old = 0;
     if (descriptor == NULL) {
@@ -3524,6 +4459,7 @@ uint64_t fam::Impl_::fam_fetch_or(Fam_Descriptor *descriptor, uint64_t offset,
     FAM_PROFILE_END_ALLOCATOR(fam_fetch_or);
 
     FAM_PROFILE_START_OPS(fam_fetch_or);
+    traceScope.submit();
     if (ret == 0) {
         old = famOps->atomic_fetch_or(descriptor, offset, value);
     }
@@ -3545,6 +4481,10 @@ uint32_t fam::Impl_::fam_fetch_xor(Fam_Descriptor *descriptor, uint64_t offset,
                                    uint32_t value) {
     std::ostringstream message;
     FAM_CNTR_INC_API(fam_fetch_xor);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_fetch_xor, descriptor,
+                               sizeof(value));
+    Fam_Trace_Scope traceScope(trace_fam_fetch_xor, descriptor, offset,
+                               sizeof(value));
     FAM_PROFILE_START_ALLOCATOR(fam_fetch_xor);
     uint32_t old = 0;
     if (descriptor == NULL) {
@@ -3555,6 +4495,7 @@ uint32_t fam::Impl_::fam_fetch_xor(Fam_Descriptor *descriptor, uint64_t offset,
     FAM_PROFILE_END_ALLOCATOR(fam_fetch_xor);
 
     FAM_PROFILE_START_OPS(fam_fetch_xor);
+    traceScope.submit();
     if (ret == 0) {
         old = famOps->atomic_fetch_xor(descriptor, offset, value);
     }
@@ -3565,6 +4506,10 @@ uint64_t fam::Impl_::fam_fetch_xor(Fam_Descriptor *descriptor, uint64_t offset,
                                    uint64_t value) {
     std::ostringstream message;
     FAM_CNTR_INC_API(fam_fetch_xor);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_fetch_xor, descriptor,
+                               sizeof(value));
+    Fam_Trace_Scope traceScope(trace_fam_fetch_xor, descriptor, offset,
+                               sizeof(value));
     FAM_PROFILE_START_ALLOCATOR(fam_fetch_xor);
     uint64_t old = 0;
     if (descriptor == NULL) {
@@ -3575,6 +4520,7 @@ uint64_t fam::Impl_::fam_fetch_xor(Fam_Descriptor *descriptor, uint64_t offset,
     FAM_PROFILE_END_ALLOCATOR(fam_fetch_xor);
 
     FAM_PROFILE_START_OPS(fam_fetch_xor);
+    traceScope.submit();
     if (ret == 0) {
         old = famOps->atomic_fetch_xor(descriptor, offset, value);
     }
@@ -3588,11 +4534,17 @@ uint64_t fam::Impl_::fam_fetch_xor(Fam_Descriptor *descriptor, uint64_t offset,
  * fam_fence - ensures that FAM operations (put, scatter, atomics, copy) issued
  * by the calling PE thread before the fence are ordered before FAM operations
  * issued by the calling thread after the fence Note that method this does NOT
- * order load/store accesses by the processor to FAM enabled by fam_map().
+ * order load/store accesses by the processor to FAM enabled by fam_map(),
+ * except that pages of data items mapped over memory servers are written back.
  */
 void fam::Impl_::fam_fence(Fam_Region_Descriptor *descriptor) {
     FAM_CNTR_INC_API(fam_fence);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_fence, descriptor);
+    Fam_Trace_Scope traceScope(trace_fam_fence, descriptor);
     FAM_PROFILE_START_OPS(fam_fence);
+    traceScope.submit();
+    if (mapPager != NULL)
+        mapPager->sync(descriptor);
     famOps->fence(descriptor);
     FAM_PROFILE_END_OPS(fam_fence);
     return;
@@ -3602,16 +4554,457 @@ void fam::Impl_::fam_fence(Fam_Region_Descriptor *descriptor) {
  * fam_quiet - blocks the calling PE thread until all its pending FAM operations
  * (put, scatter, atomics, copy) are completed. Note that method this does NOT
  * order or wait for completion of load/store accesses by the processor to FAM
- * enabled by fam_map().
+ * enabled by fam_map(), except that pages of data items mapped over memory
+ * servers are written back.
  */
 void fam::Impl_::fam_quiet(Fam_Region_Descriptor *descriptor) {
     FAM_CNTR_INC_API(fam_quiet);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_quiet, descriptor);
+    Fam_Trace_Scope traceScope(trace_fam_quiet, descriptor);
     FAM_PROFILE_START_OPS(fam_quiet);
+    traceScope.submit();
+    if (mapPager != NULL)
+        mapPager->sync(descriptor);
     famOps->quiet(descriptor);
     FAM_PROFILE_END_OPS(fam_quiet);
     return;
 }
 
+// COLLECTIVES Routines
+
+/**
+ * Create a team of all PEs started by the runtime.
+ * @see fam_team_create(const char *, const char *, uint64_t, int, int)
+ */
+Fam_Team *fam::Impl_::fam_team_create(const char *name,
+                                      const char *regionName,
+                                      uint64_t maxBytes) {
+    int numPEs = *(const int *)optValueMap->at(supportedOptionList[PE_COUNT]);
+    int myPE = *(const int *)optValueMap->at(supportedOptionList[PE_ID]);
+    return fam_team_create(name, regionName, maxBytes, numPEs, myPE);
+}
+
+/**
+ * Create a team of numPEs PEs. PE 0 allocates and publishes the scratch
+ * data item, which the other PEs look up until it is found.
+ * @param name - name of the scratch data item
+ * @param regionName - name of the region holding the scratch data item
+ * @param maxBytes - largest broadcast or allreduce of the team
+ * @param numPEs - number of PEs in the team
+ * @param myPE - index of the calling PE in the team
+ * @return - team to pass to the collectives
+ */
+Fam_Team *fam::Impl_::fam_team_create(const char *name,
+                                      const char *regionName,
+                                      uint64_t maxBytes, int numPEs,
+                                      int myPE) {
+    FAM_CNTR_INC_API(fam_team_create);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_team_create);
+    Fam_Trace_Scope traceScope(trace_fam_team_create);
+    FAM_PROFILE_START_ALLOCATOR(fam_team_create);
+    if ((name == NULL) || (regionName == NULL) || (maxBytes == 0) ||
+        (numPEs < 1) || (myPE < 0) || (myPE >= numPEs)) {
+        throw Fam_InvalidOption_Exception("Invalid Options");
+    }
+    traceScope.submit();
+
+    Fam_Descriptor *item = NULL;
+    if (myPE == 0) {
+        Fam_Region_Descriptor *region = fam_lookup_region(regionName);
+        item = fam_allocate(name, Fam_Team::item_size(numPEs, maxBytes),
+                            S_IRUSR | S_IWUSR, region);
+        delete region;
+    } else {
+        time_t deadline = time(NULL) + FAM_TEAM_JOIN_TIMEOUT_SEC;
+        while (item == NULL) {
+            try {
+                item = fam_lookup(name, regionName);
+            } catch (Fam_Exception &e) {
+                if (e.fam_error() != FAM_ERR_NOTFOUND)
+                    throw;
+            }
+            if ((item == NULL) && (time(NULL) > deadline))
+                throw Fam_Timeout_Exception("Team was not created by PE 0");
+            if (item == NULL)
+                usleep(1000);
+        }
+    }
+    validate_item(item);
+
+    Fam_Team *team = new Fam_Team(famOps, item, numPEs, myPE, maxBytes);
+    if (myPE == 0) {
+        team->create();
+    } else if (!team->join(FAM_TEAM_JOIN_TIMEOUT_SEC)) {
+        delete team;
+        delete item;
+        throw Fam_Timeout_Exception("Team was not published by PE 0");
+    }
+    team->barrier();
+    FAM_PROFILE_END_ALLOCATOR(fam_team_create);
+    return team;
+}
+
+/**
+ * Leave a team; PE 0 deallocates the scratch data item once all PEs left.
+ * @param team - team from fam_team_create()
+ */
+void fam::Impl_::fam_team_destroy(Fam_Team *team) {
+    FAM_CNTR_INC_API(fam_team_destroy);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_team_destroy);
+    Fam_Trace_Scope traceScope(trace_fam_team_destroy);
+    FAM_PROFILE_START_ALLOCATOR(fam_team_destroy);
+    if (team == NULL) {
+        throw Fam_InvalidOption_Exception("Invalid Options");
+    }
+    traceScope.submit();
+    Fam_Descriptor *item = team->get_item();
+    team->leave();
+    if (team->my_pe() == 0)
+        fam_deallocate(item);
+    delete team;
+    delete item;
+    FAM_PROFILE_END_ALLOCATOR(fam_team_destroy);
+}
+
+/**
+ * Dissemination barrier of the PEs of a team over FAM atomics.
+ * @param team - team from fam_team_create()
+ */
+void fam::Impl_::fam_barrier(Fam_Team *team) {
+    FAM_CNTR_INC_API(fam_barrier);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_barrier);
+    Fam_Trace_Scope traceScope(trace_fam_barrier);
+    FAM_PROFILE_START_OPS(fam_barrier);
+    if (team == NULL) {
+        throw Fam_InvalidOption_Exception("Invalid Options");
+    }
+    traceScope.submit();
+    team->barrier();
+    FAM_PROFILE_END_OPS(fam_barrier);
+}
+
+/**
+ * Copy data from the root PE of a team to the others through FAM.
+ * @param team - team from fam_team_create()
+ * @param data - data at the root, buffer at the other PEs
+ * @param nbytes - size of the data
+ * @param root - PE sending the data
+ */
+void fam::Impl_::fam_broadcast(Fam_Team *team, void *data, uint64_t nbytes,
+                               int root) {
+    FAM_CNTR_INC_API(fam_broadcast);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_broadcast,
+                               team ? team->get_item() : NULL, nbytes);
+    Fam_Trace_Scope traceScope(trace_fam_broadcast,
+                               team ? team->get_item() : NULL, 0, nbytes);
+    FAM_PROFILE_START_OPS(fam_broadcast);
+    if ((team == NULL) || ((data == NULL) && nbytes)) {
+        throw Fam_InvalidOption_Exception("Invalid Options");
+    }
+    traceScope.submit();
+    team->broadcast(data, nbytes, root);
+    FAM_PROFILE_END_OPS(fam_broadcast);
+}
+
+/**
+ * Reduce arrays of the PEs of a team element by element through FAM.
+ * @param team - team from fam_team_create()
+ * @param data - elements of the PE, replaced by the result
+ * @param count - number of elements
+ * @param type - type of the elements
+ * @param op - reduction to compute
+ */
+void fam::Impl_::fam_allreduce(Fam_Team *team, void *data, uint64_t count,
+                               Fam_Data_Type type, Fam_Reduce_Op op) {
+    uint64_t nbytes = count * fam_data_type_size(type);
+    FAM_CNTR_INC_API(fam_allreduce);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_allreduce,
+                               team ? team->get_item() : NULL, nbytes);
+    Fam_Trace_Scope traceScope(trace_fam_allreduce,
+                               team ? team->get_item() : NULL, 0, nbytes);
+    FAM_PROFILE_START_OPS(fam_allreduce);
+    if ((team == NULL) || ((data == NULL) && count)) {
+        throw Fam_InvalidOption_Exception("Invalid Options");
+    }
+    traceScope.submit();
+    team->allreduce(data, count, type, op);
+    FAM_PROFILE_END_OPS(fam_allreduce);
+}
+
+// LOCKS Routines
+
+/**
+ * Allocate a data item holding a lock and open it.
+ * @param name - name of the data item
+ * @param region - region in which to allocate the data item
+ * @param type - FAM_LOCK_MUTEX or FAM_LOCK_RW
+ * @param maxHolders - largest number of handles open on the lock at once
+ * @return - handle of the lock
+ */
+fam_lock_t *fam::Impl_::fam_lock_create(const char *name,
+                                        Fam_Region_Descriptor *region,
+                                        Fam_Lock_Type type,
+                                        uint64_t maxHolders) {
+    FAM_CNTR_INC_API(fam_lock_create);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_lock_create, region);
+    Fam_Trace_Scope traceScope(trace_fam_lock_create, region);
+    FAM_PROFILE_START_ALLOCATOR(fam_lock_create);
+    if ((name == NULL) || (region == NULL) || (maxHolders == 0) ||
+        ((type != FAM_LOCK_MUTEX) && (type != FAM_LOCK_RW))) {
+        throw Fam_InvalidOption_Exception("Invalid Options");
+    }
+    traceScope.submit();
+
+    Fam_Descriptor *item = fam_allocate(name, Fam_Lock::item_size(maxHolders),
+                                        S_IRUSR | S_IWUSR, region);
+    validate_item(item);
+    Fam_Lock *lock = new Fam_Lock(famOps, item);
+    lock->create(type, maxHolders);
+    FAM_PROFILE_END_ALLOCATOR(fam_lock_create);
+    return lock;
+}
+
+/**
+ * Open a lock by claiming one of its queue nodes.
+ * @param name - name of the data item holding the lock
+ * @param regionName - name of the region holding the data item
+ * @return - handle of the lock
+ */
+fam_lock_t *fam::Impl_::fam_lock_open(const char *name,
+                                      const char *regionName) {
+    FAM_CNTR_INC_API(fam_lock_open);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_lock_open);
+    Fam_Trace_Scope traceScope(trace_fam_lock_open);
+    FAM_PROFILE_START_ALLOCATOR(fam_lock_open);
+    if ((name == NULL) || (regionName == NULL)) {
+        throw Fam_InvalidOption_Exception("Invalid Options");
+    }
+    traceScope.submit();
+
+    Fam_Descriptor *item = fam_lookup(name, regionName);
+    Fam_Lock *lock = new Fam_Lock(famOps, item);
+    try {
+        validate_item(item);
+        lock->open();
+    } catch (...) {
+        delete lock;
+        delete item;
+        throw;
+    }
+    FAM_PROFILE_END_ALLOCATOR(fam_lock_open);
+    return lock;
+}
+
+/**
+ * Close a handle of a lock, giving up its queue node.
+ * @param lock - handle of the lock
+ */
+void fam::Impl_::fam_lock_close(fam_lock_t *lock) {
+    FAM_CNTR_INC_API(fam_lock_close);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_lock_close,
+                               lock ? lock->get_item() : NULL);
+    Fam_Trace_Scope traceScope(trace_fam_lock_close,
+                               lock ? lock->get_item() : NULL);
+    FAM_PROFILE_START_ALLOCATOR(fam_lock_close);
+    if (lock == NULL) {
+        throw Fam_InvalidOption_Exception("Invalid Options");
+    }
+    traceScope.submit();
+    Fam_Descriptor *item = lock->get_item();
+    lock->close();
+    delete lock;
+    delete item;
+    FAM_PROFILE_END_ALLOCATOR(fam_lock_close);
+}
+
+/**
+ * Close a handle of a lock and deallocate the data item holding the lock.
+ * @param lock - handle of the lock
+ */
+void fam::Impl_::fam_lock_destroy(fam_lock_t *lock) {
+    FAM_CNTR_INC_API(fam_lock_destroy);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_lock_destroy,
+                               lock ? lock->get_item() : NULL);
+    Fam_Trace_Scope traceScope(trace_fam_lock_destroy,
+                               lock ? lock->get_item() : NULL);
+    FAM_PROFILE_START_ALLOCATOR(fam_lock_destroy);
+    if (lock == NULL) {
+        throw Fam_InvalidOption_Exception("Invalid Options");
+    }
+    traceScope.submit();
+    Fam_Descriptor *item = lock->get_item();
+    lock->close();
+    fam_deallocate(item);
+    delete lock;
+    delete item;
+    FAM_PROFILE_END_ALLOCATOR(fam_lock_destroy);
+}
+
+/**
+ * Take a lock exclusively, waiting in its queue.
+ * @param lock - handle of the lock
+ */
+void fam::Impl_::fam_lock(fam_lock_t *lock) {
+    FAM_CNTR_INC_API(fam_lock);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_lock,
+                               lock ? lock->get_item() : NULL);
+    Fam_Trace_Scope traceScope(trace_fam_lock,
+                               lock ? lock->get_item() : NULL);
+    FAM_PROFILE_START_OPS(fam_lock);
+    if (lock == NULL) {
+        throw Fam_InvalidOption_Exception("Invalid Options");
+    }
+    traceScope.submit();
+    lock->lock();
+    FAM_PROFILE_END_OPS(fam_lock);
+}
+
+/**
+ * Take a lock exclusively if no PE holds it or waits for it.
+ * @param lock - handle of the lock
+ * @return - true if the lock was taken
+ */
+bool fam::Impl_::fam_trylock(fam_lock_t *lock) {
+    FAM_CNTR_INC_API(fam_trylock);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_trylock,
+                               lock ? lock->get_item() : NULL);
+    Fam_Trace_Scope traceScope(trace_fam_trylock,
+                               lock ? lock->get_item() : NULL);
+    FAM_PROFILE_START_OPS(fam_trylock);
+    if (lock == NULL) {
+        throw Fam_InvalidOption_Exception("Invalid Options");
+    }
+    traceScope.submit();
+    bool taken = lock->try_lock();
+    FAM_PROFILE_END_OPS(fam_trylock);
+    return taken;
+}
+
+/**
+ * Retry taking a lock exclusively until the timeout expires.
+ * @param lock - handle of the lock
+ * @param timeoutUsec - timeout in microseconds
+ * @return - true if the lock was taken
+ */
+bool fam::Impl_::fam_timedlock(fam_lock_t *lock, uint64_t timeoutUsec) {
+    FAM_CNTR_INC_API(fam_timedlock);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_timedlock,
+                               lock ? lock->get_item() : NULL);
+    Fam_Trace_Scope traceScope(trace_fam_timedlock,
+                               lock ? lock->get_item() : NULL);
+    FAM_PROFILE_START_OPS(fam_timedlock);
+    if (lock == NULL) {
+        throw Fam_InvalidOption_Exception("Invalid Options");
+    }
+    traceScope.submit();
+    bool taken = lock->timed_lock(timeoutUsec);
+    FAM_PROFILE_END_OPS(fam_timedlock);
+    return taken;
+}
+
+/**
+ * Take a reader-writer lock as a reader, waiting in its queue.
+ * @param lock - handle of the lock
+ */
+void fam::Impl_::fam_rdlock(fam_lock_t *lock) {
+    FAM_CNTR_INC_API(fam_rdlock);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_rdlock,
+                               lock ? lock->get_item() : NULL);
+    Fam_Trace_Scope traceScope(trace_fam_rdlock,
+                               lock ? lock->get_item() : NULL);
+    FAM_PROFILE_START_OPS(fam_rdlock);
+    if (lock == NULL) {
+        throw Fam_InvalidOption_Exception("Invalid Options");
+    }
+    traceScope.submit();
+    lock->read_lock();
+    FAM_PROFILE_END_OPS(fam_rdlock);
+}
+
+/**
+ * Take a reader-writer lock as a reader if no PE is queued on it.
+ * @param lock - handle of the lock
+ * @return - true if the lock was taken
+ */
+bool fam::Impl_::fam_tryrdlock(fam_lock_t *lock) {
+    FAM_CNTR_INC_API(fam_tryrdlock);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_tryrdlock,
+                               lock ? lock->get_item() : NULL);
+    Fam_Trace_Scope traceScope(trace_fam_tryrdlock,
+                               lock ? lock->get_item() : NULL);
+    FAM_PROFILE_START_OPS(fam_tryrdlock);
+    if (lock == NULL) {
+        throw Fam_InvalidOption_Exception("Invalid Options");
+    }
+    traceScope.submit();
+    bool taken = lock->try_read_lock();
+    FAM_PROFILE_END_OPS(fam_tryrdlock);
+    return taken;
+}
+
+/**
+ * Retry taking a reader-writer lock as a reader until the timeout expires.
+ * @param lock - handle of the lock
+ * @param timeoutUsec - timeout in microseconds
+ * @return - true if the lock was taken
+ */
+bool fam::Impl_::fam_timedrdlock(fam_lock_t *lock, uint64_t timeoutUsec) {
+    FAM_CNTR_INC_API(fam_timedrdlock);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_timedrdlock,
+                               lock ? lock->get_item() : NULL);
+    Fam_Trace_Scope traceScope(trace_fam_timedrdlock,
+                               lock ? lock->get_item() : NULL);
+    FAM_PROFILE_START_OPS(fam_timedrdlock);
+    if (lock == NULL) {
+        throw Fam_InvalidOption_Exception("Invalid Options");
+    }
+    traceScope.submit();
+    bool taken = lock->timed_read_lock(timeoutUsec);
+    FAM_PROFILE_END_OPS(fam_timedrdlock);
+    return taken;
+}
+
+/**
+ * Release a lock and hand it to the next PE in its queue.
+ * @param lock - handle of the lock
+ */
+void fam::Impl_::fam_unlock(fam_lock_t *lock) {
+    FAM_CNTR_INC_API(fam_unlock);
+    Fam_Stats_Scope statsScope(famStats, prof_fam_unlock,
+                               lock ? lock->get_item() : NULL);
+    Fam_Trace_Scope traceScope(trace_fam_unlock,
+                               lock ? lock->get_item() : NULL);
+    FAM_PROFILE_START_OPS(fam_unlock);
+    if (lock == NULL) {
+        throw Fam_InvalidOption_Exception("Invalid Options");
+    }
+    traceScope.submit();
+    lock->unlock();
+    FAM_PROFILE_END_OPS(fam_unlock);
+}
+
+/**
+ * fam_stats_snapshot - copy of the latency statistics recorded so far by all
+ * threads; empty unless the FAM_STATS option is FAM_STATS_ENABLE
+ */
+Fam_Stats_Snapshot *fam::Impl_::fam_stats_snapshot(void) {
+    if (famStats == NULL) {
+        Fam_Stats_Snapshot *snapshot = new Fam_Stats_Snapshot();
+        snapshot->numEntries = 0;
+        snapshot->entries = NULL;
+        return snapshot;
+    }
+    return famStats->snapshot();
+}
+
+/**
+ * fam_server_stats - state of a memory server, read from the server with
+ * the gRPC allocator or from the heaps open in this process with NVMM
+ */
+Fam_Server_Stats *fam::Impl_::fam_server_stats(uint64_t memoryServerId) {
+    return famAllocator->get_server_stats(memoryServerId);
+}
+
 /**
  * Initialize the OpenFAM library. This method is required to be the first
  * method called when a process uses the OpenFAM library.
@@ -3778,6 +5171,26 @@ Fam_Descriptor *fam::fam_allocate(const char *name, uint64_t nbytes,
     return pimpl_->fam_allocate(name, nbytes, accessPermissions, region);
 }
 
+/**
+ * Allocate some unnamed space within a region from a chunk of FAM leased by
+ * this PE.
+ * @param nybtes - size of the space to allocate in bytes.
+ * @param accessPermissions - permissions associated with this space
+ * @param region - descriptor of the region within which the space is being
+ * allocated.
+ * @throws Fam_InvalidOption_Exception - if region is null
+ * @throws Fam_Allocator_Exception - exceptionObj->fam_error() may return:
+ *         FAM_ERR_NOPERM, FAM_ERR_GRPC
+ * @return - descriptor that can be used within the program to refer to this
+ * space
+ * @see #fam_deallocate()
+ */
+Fam_Descriptor *fam::fam_allocate_local_pool(uint64_t nbytes,
+                                             mode_t accessPermissions,
+                                             Fam_Region_Descriptor *region) {
+    return pimpl_->fam_allocate_local_pool(nbytes, accessPermissions, region);
+}
+
 /**
  * Deallocate allocated space in memory
  * @param descriptor - descriptor associated with the space.
@@ -3789,6 +5202,68 @@ void fam::fam_deallocate(Fam_Descriptor *descriptor) {
     pimpl_->fam_deallocate(descriptor);
 }
 
+/**
+ * fam_allocate_async - starts allocating a named data item and returns
+ * without waiting for the memory server.
+ * @param name - name of the data item
+ * @param nbytes - size of the data item in bytes
+ * @param accessPermissions - permissions of the data item
+ * @param region - region within which the data item is allocated
+ * @return - handle to pass to fam_async_wait()
+ * @see #fam_allocate()
+ */
+Fam_Async_Handle *fam::fam_allocate_async(const char *name, uint64_t nbytes,
+                                          mode_t accessPermissions,
+                                          Fam_Region_Descriptor *region) {
+    return pimpl_->fam_allocate_async(name, nbytes, accessPermissions, region);
+}
+
+/**
+ * fam_lookup_async - starts looking up a data item and returns without
+ * waiting for the memory server.
+ * @param itemName - name of the data item
+ * @param regionName - name of the region containing the data item
+ * @return - handle to pass to fam_async_wait()
+ * @see #fam_lookup()
+ */
+Fam_Async_Handle *fam::fam_lookup_async(const char *itemName,
+                                        const char *regionName) {
+    return pimpl_->fam_lookup_async(itemName, regionName);
+}
+
+/**
+ * fam_deallocate_async - starts deallocating a data item and returns without
+ * waiting for the memory server.
+ * @param descriptor - descriptor of the data item
+ * @return - handle to pass to fam_async_wait()
+ * @see #fam_deallocate()
+ */
+Fam_Async_Handle *fam::fam_deallocate_async(Fam_Descriptor *descriptor) {
+    return pimpl_->fam_deallocate_async(descriptor);
+}
+
+/**
+ * fam_async_test - checks whether an asynchronous operation has completed.
+ * @param handle - handle of the operation
+ * @return - true if the operation has completed
+ * @throws Fam_InvalidOption_Exception.
+ */
+bool fam::fam_async_test(Fam_Async_Handle *handle) {
+    return pimpl_->fam_async_test(handle);
+}
+
+/**
+ * fam_async_wait - waits for an asynchronous operation to complete and
+ * releases its handle.
+ * @param handle - handle of the operation
+ * @return - descriptor of the data item allocated or looked up, NULL for a
+ * deallocation
+ * @throws Fam_InvalidOption_Exception, Fam_Allocator_Exception.
+ */
+Fam_Descriptor *fam::fam_async_wait(Fam_Async_Handle *handle) {
+    return pimpl_->fam_async_wait(handle);
+}
+
 /**
  * Change permissions associated with a data item descriptor.
  * @param descriptor - descriptor associated with some data item
@@ -4190,6 +5665,53 @@ void *fam::fam_copy(Fam_Descriptor *src, uint64_t srcOffset,
 
 void fam::fam_copy_wait(void *waitObj) { pimpl_->fam_copy_wait(waitObj); }
 
+/**
+ * fam_reduce - reduces an array of elements of a data item where it resides
+ * and returns only the result.
+ * @param descriptor - valid descriptor to a data item in FAM.
+ * @param offset - byte offset of the first element within the data item
+ * @param count - number of elements to reduce
+ * @param type - type of the elements
+ * @param op - reduction to compute
+ * @param result - sum as int64_t, uint64_t or double for signed, unsigned
+ * and floating point types, or minimum or maximum as an element
+ * @throws Fam_InvalidOption_Exception.
+ * @throws Fam_Allocator_Exception - excptObj->fam_error() may return:
+ *         FAM_ERR_NOPERM, FAM_ERR_NOTFOUND, FAM_ERR_OUTOFRANGE,
+ *         FAM_ERR_INVALID, FAM_ERR_GRPC
+ */
+void fam::fam_reduce(Fam_Descriptor *descriptor, uint64_t offset,
+                     uint64_t count, Fam_Data_Type type, Fam_Reduce_Op op,
+                     void *result) {
+    pimpl_->fam_reduce(descriptor, offset, count, type, op, result);
+}
+
+/**
+ * fam_scan - filters an array of fixed size records of a data item where it
+ * resides, writing the indices or copies of the matching records to another
+ * data item on the same memory server.
+ * @param source - valid descriptor to a data item in FAM.
+ * @param offset - byte offset of the first record within the data item
+ * @param recordSize - size of a record in bytes
+ * @param numRecords - number of records to scan
+ * @param predicate - predicate the records are matched against
+ * @param output - what is written for a matching record
+ * @param destination - data item written to, or NULL with FAM_SCAN_COUNT
+ * @param destOffset - byte offset of the first result in the destination
+ * @return - number of matching records, including those not written
+ * @throws Fam_InvalidOption_Exception.
+ * @throws Fam_Allocator_Exception - excptObj->fam_error() may return:
+ *         FAM_ERR_NOPERM, FAM_ERR_NOTFOUND, FAM_ERR_OUTOFRANGE,
+ *         FAM_ERR_INVALID, FAM_ERR_GRPC
+ */
+uint64_t fam::fam_scan(Fam_Descriptor *source, uint64_t offset,
+                       uint64_t recordSize, uint64_t numRecords,
+                       Fam_Scan_Predicate *predicate, Fam_Scan_Output output,
+                       Fam_Descriptor *destination, uint64_t destOffset) {
+    return pimpl_->fam_scan(source, offset, recordSize, numRecords, predicate,
+                            output, destination, destOffset);
+}
+
 // ATOMICS Group
 
 // NON fetching routines
@@ -4783,6 +6305,242 @@ void fam::fam_fence() { pimpl_->fam_fence(); }
  */
 void fam::fam_quiet() { pimpl_->fam_quiet(); }
 
+/**
+ * fam_team_create - creates a team of all PE_COUNT PEs, over a scratch data
+ * item allocated by PE 0. Must be called by all of them.
+ * @param name - name of the scratch data item
+ * @param regionName - name of the region holding the scratch data item
+ * @param maxBytes - largest broadcast or allreduce of the team, in bytes
+ * @return - team to pass to the collectives
+ * @throws Fam_InvalidOption_Exception, Fam_Timeout_Exception.
+ * @throws Fam_Allocator_Exception.
+ */
+Fam_Team *fam::fam_team_create(const char *name, const char *regionName,
+                               uint64_t maxBytes) {
+    return pimpl_->fam_team_create(name, regionName, maxBytes);
+}
+
+/**
+ * fam_team_create - creates a team of numPEs PEs not started by a runtime.
+ * @param numPEs - number of PEs in the team
+ * @param myPE - index of the calling PE in the team
+ */
+Fam_Team *fam::fam_team_create(const char *name, const char *regionName,
+                               uint64_t maxBytes, int numPEs, int myPE) {
+    return pimpl_->fam_team_create(name, regionName, maxBytes, numPEs, myPE);
+}
+
+/**
+ * fam_team_destroy - leaves a team after a last barrier.
+ * @param team - team from fam_team_create()
+ */
+void fam::fam_team_destroy(Fam_Team *team) { pimpl_->fam_team_destroy(team); }
+
+/**
+ * fam_barrier - suspends the calling PE until all PEs of the team have called
+ * fam_barrier.
+ * @param team - team from fam_team_create()
+ */
+void fam::fam_barrier(Fam_Team *team) { pimpl_->fam_barrier(team); }
+
+/**
+ * fam_broadcast - copies data from the root PE of the team to all others.
+ * @param team - team from fam_team_create()
+ * @param data - data at the root, buffer at the other PEs
+ * @param nbytes - size of the data
+ * @param root - PE sending the data
+ * @throws Fam_InvalidOption_Exception.
+ */
+void fam::fam_broadcast(Fam_Team *team, void *data, uint64_t nbytes,
+                        int root) {
+    pimpl_->fam_broadcast(team, data, nbytes, root);
+}
+
+/**
+ * fam_allreduce - combines arrays of all PEs of the team element by element
+ * and returns the result to all of them.
+ * @param team - team from fam_team_create()
+ * @param data - elements of the PE, replaced by the result
+ * @param count - number of elements
+ * @param type - type of the elements
+ * @param op - reduction to compute
+ * @throws Fam_InvalidOption_Exception.
+ */
+void fam::fam_allreduce(Fam_Team *team, void *data, uint64_t count,
+                        Fam_Data_Type type, Fam_Reduce_Op op) {
+    pimpl_->fam_allreduce(team, data, count, type, op);
+}
+
+/**
+ * fam_lock_create - allocates a data item holding a lock, and opens it.
+ * @param name - name of the data item
+ * @param region - region in which to allocate the data item
+ * @param type - FAM_LOCK_MUTEX or FAM_LOCK_RW
+ * @param maxHolders - largest number of handles open on the lock at once
+ * @return - handle of the lock
+ * @throws Fam_InvalidOption_Exception, Fam_Allocator_Exception.
+ */
+fam_lock_t *fam::fam_lock_create(const char *name,
+                                 Fam_Region_Descriptor *region,
+                                 Fam_Lock_Type type, uint64_t maxHolders) {
+    return pimpl_->fam_lock_create(name, region, type, maxHolders);
+}
+
+/**
+ * fam_lock_open - opens a lock created by fam_lock_create().
+ * @param name - name of the data item holding the lock
+ * @param regionName - name of the region holding the data item
+ * @return - handle of the lock
+ * @throws Fam_InvalidOption_Exception, Fam_Allocator_Exception.
+ */
+fam_lock_t *fam::fam_lock_open(const char *name, const char *regionName) {
+    return pimpl_->fam_lock_open(name, regionName);
+}
+
+/**
+ * fam_lock_close - closes a handle of a lock.
+ * @param lock - handle of the lock
+ * @throws Fam_InvalidOption_Exception.
+ */
+void fam::fam_lock_close(fam_lock_t *lock) { pimpl_->fam_lock_close(lock); }
+
+/**
+ * fam_lock_destroy - closes a handle of a lock and deallocates the data item
+ * holding the lock.
+ * @param lock - handle of the lock
+ * @throws Fam_InvalidOption_Exception, Fam_Allocator_Exception.
+ */
+void fam::fam_lock_destroy(fam_lock_t *lock) {
+    pimpl_->fam_lock_destroy(lock);
+}
+
+/**
+ * fam_lock - takes a lock exclusively, waiting in its queue.
+ * @param lock - handle of the lock
+ * @throws Fam_InvalidOption_Exception.
+ */
+void fam::fam_lock(fam_lock_t *lock) { pimpl_->fam_lock(lock); }
+
+/**
+ * fam_trylock - takes a lock exclusively if no PE holds it or waits for it.
+ * @param lock - handle of the lock
+ * @return - true if the lock was taken
+ * @throws Fam_InvalidOption_Exception.
+ */
+bool fam::fam_trylock(fam_lock_t *lock) { return pimpl_->fam_trylock(lock); }
+
+/**
+ * fam_timedlock - retries fam_trylock() until the timeout expires. It never
+ * queues, so it can fail while the queue stays busy with other waiters.
+ * @param lock - handle of the lock
+ * @param timeoutUsec - timeout in microseconds
+ * @return - true if the lock was taken
+ * @throws Fam_InvalidOption_Exception.
+ */
+bool fam::fam_timedlock(fam_lock_t *lock, uint64_t timeoutUsec) {
+    return pimpl_->fam_timedlock(lock, timeoutUsec);
+}
+
+/**
+ * fam_rdlock - takes a reader-writer lock as a reader, waiting in its queue.
+ * @param lock - handle of the lock
+ * @throws Fam_InvalidOption_Exception.
+ */
+void fam::fam_rdlock(fam_lock_t *lock) { pimpl_->fam_rdlock(lock); }
+
+/**
+ * fam_tryrdlock - takes a reader-writer lock as a reader if no PE is queued
+ * on it.
+ * @param lock - handle of the lock
+ * @return - true if the lock was taken
+ * @throws Fam_InvalidOption_Exception.
+ */
+bool fam::fam_tryrdlock(fam_lock_t *lock) {
+    return pimpl_->fam_tryrdlock(lock);
+}
+
+/**
+ * fam_timedrdlock - retries fam_tryrdlock() until the timeout expires. It
+ * never queues, so it can fail while the queue stays busy with other
+ * waiters.
+ * @param lock - handle of the lock
+ * @param timeoutUsec - timeout in microseconds
+ * @return - true if the lock was taken
+ * @throws Fam_InvalidOption_Exception.
+ */
+bool fam::fam_timedrdlock(fam_lock_t *lock, uint64_t timeoutUsec) {
+    return pimpl_->fam_timedrdlock(lock, timeoutUsec);
+}
+
+/**
+ * fam_unlock - releases a lock and hands it to the next PE in its queue.
+ * @param lock - handle of the lock
+ * @throws Fam_InvalidOption_Exception.
+ */
+void fam::fam_unlock(fam_lock_t *lock) { pimpl_->fam_unlock(lock); }
+
+/**
+ * fam_stats_snapshot - returns the latency histograms recorded so far by all
+ * threads of the PE, per API, memory server and transfer size class.
+ * @return - snapshot to be released with fam_stats_free(); it has no entries
+ * unless the FAM_STATS option is FAM_STATS_ENABLE
+ */
+Fam_Stats_Snapshot *fam::fam_stats_snapshot() {
+    return pimpl_->fam_stats_snapshot();
+}
+
+/**
+ * fam_stats_free - releases a snapshot from fam_stats_snapshot()
+ * @param snapshot - snapshot to be released
+ */
+void fam::fam_stats_free(Fam_Stats_Snapshot *snapshot) {
+    Fam_Stats::free_snapshot(snapshot);
+}
+
+/**
+ * fam_stats_json - formats a snapshot as a JSON document
+ * @param snapshot - snapshot from fam_stats_snapshot()
+ * @return - NUL terminated JSON text, to be released with free()
+ */
+char *fam::fam_stats_json(Fam_Stats_Snapshot *snapshot) {
+    return Fam_Stats::to_json(snapshot);
+}
+
+/**
+ * fam_server_stats - returns the state of a memory server: open heaps,
+ * registered memory, usage of each open region, RPC calls and handler
+ * latency, copies and progress thread activity.
+ * @param memoryServerId - memory server to query
+ * @return - statistics to be released with fam_server_stats_free()
+ * @throws Fam_Allocator_Exception - excptObj->fam_error() may return:
+ *         FAM_ERR_RPC_CLIENT_NOTFOUND, FAM_ERR_GRPC
+ */
+Fam_Server_Stats *fam::fam_server_stats(uint64_t memoryServerId) {
+    return pimpl_->fam_server_stats(memoryServerId);
+}
+
+/**
+ * fam_server_stats_free - releases statistics from fam_server_stats()
+ * @param stats - statistics to be released
+ */
+void fam::fam_server_stats_free(Fam_Server_Stats *stats) {
+    if (stats == NULL)
+        return;
+    for (uint64_t i = 0; i < stats->numRpcs; i++)
+        free(stats->rpcs[i].rpc);
+    delete[] stats->rpcs;
+    delete[] stats->regions;
+    delete stats;
+}
+
+/**
+ * fam_trace_dump - writes the recent API calls and fabric operations of all
+ * threads as Chrome trace-event JSON
+ * @param path - file to write the trace to
+ * @return - 0 on success, -1 if the file could not be written
+ */
+int fam::fam_trace_dump(const char *path) { return Fam_Trace::dump(path); }
+
 /**
  * fam() - constructor for fam class
  */
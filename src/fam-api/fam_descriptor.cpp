@@ -27,8 +27,11 @@
  * See https://spdx.org/licenses/BSD-3-Clause
  *
  */
+#include <atomic>
 #include <iostream>
+#include <new>
 #include <sstream>
+#include <stdlib.h>
 #include <string>
 #include <unistd.h>
 
@@ -38,105 +41,120 @@
 using namespace std;
 using namespace openfam;
 /*
- * Internal implementation of Fam_Descriptor
+ * Internal implementation of Fam_Descriptor. The fields the datapath reads
+ * are kept in the descriptor itself, see Fam_Descriptor_Hot.
  */
 class Fam_Descriptor::FamDescriptorImpl_ {
   public:
-    FamDescriptorImpl_(Fam_Global_Descriptor globalDesc, uint64_t itemSize) {
-        gDescriptor = globalDesc;
-        key = FAM_KEY_UNINITIALIZED;
-        context = NULL;
-        base = NULL;
-        size = itemSize;
-    }
-
     FamDescriptorImpl_(Fam_Global_Descriptor globalDesc) {
         gDescriptor = globalDesc;
-        key = FAM_KEY_UNINITIALIZED;
-        context = NULL;
         base = NULL;
-        size = 0;
+        poolItem = false;
+        poolReleased = false;
     }
 
     FamDescriptorImpl_() {
         gDescriptor = { FAM_INVALID_REGION, 0 };
-        key = FAM_KEY_UNINITIALIZED;
-        context = NULL;
         base = NULL;
-        size = 0;
+        poolItem = false;
+        poolReleased = false;
     }
 
     ~FamDescriptorImpl_() {
         gDescriptor = { FAM_INVALID_REGION, 0 };
-        key = FAM_KEY_UNINITIALIZED;
-        context = NULL;
         base = NULL;
-        size = 0;
     }
 
     Fam_Global_Descriptor get_global_descriptor() { return this->gDescriptor; }
 
-    void bind_key(uint64_t tempKey) {
-        if (key == FAM_KEY_UNINITIALIZED)
-            key = tempKey;
-        //      key = check_permissions_get_key(gDescriptor.regionID,
-        //      gDescriptor.offset);
-    }
-
-    uint64_t get_key() { return key; }
-
-    void set_context(void *ctx) { context = ctx; }
-
-    void *get_context() { return context; }
-
     void set_base_address(void *address) { base = address; }
 
     void *get_base_address() { return base; }
 
-    void set_size(uint64_t itemSize) {
-        if (size == 0)
-            size = itemSize;
-    }
-
-    uint64_t get_size() { return size; }
-
     uint64_t get_memserver_id() {
         return (gDescriptor.regionId) >> MEMSERVERID_SHIFT;
     }
 
+    void set_pool_item() { poolItem = true; }
+
+    bool is_pool_item() { return poolItem; }
+
+    bool release_pool_item() { return !poolReleased.exchange(true); }
+
   private:
     Fam_Global_Descriptor gDescriptor;
-    /* libfabric access key*/
-    uint64_t key;
-    void *context;
     void *base;
-    uint64_t size;
+    bool poolItem;
+    std::atomic<bool> poolReleased;
 };
 
+static void reset_hot(Fam_Descriptor_Hot *hot) {
+    hot->key = FAM_KEY_UNINITIALIZED;
+    hot->size = 0;
+    hot->keyOffset = 0;
+    hot->fiAddr = 0;
+    hot->context = NULL;
+    hot->localGeneration = 0;
+    hot->localHeapSize = 0;
+    hot->bound = false;
+    hot->localWrite = false;
+}
+
 Fam_Descriptor::Fam_Descriptor(Fam_Global_Descriptor gDescriptor,
                                uint64_t itemSize) {
-    fdimpl_ = new FamDescriptorImpl_(gDescriptor, itemSize);
+    Fam_Descriptor_Hot *hot = new (hot_) Fam_Descriptor_Hot();
+    reset_hot(hot);
+    hot->size = itemSize;
+    fdimpl_ = new FamDescriptorImpl_(gDescriptor);
 }
 
 Fam_Descriptor::Fam_Descriptor(Fam_Global_Descriptor gDescriptor) {
+    reset_hot(new (hot_) Fam_Descriptor_Hot());
     fdimpl_ = new FamDescriptorImpl_(gDescriptor);
 }
 
-Fam_Descriptor::Fam_Descriptor() { fdimpl_ = new FamDescriptorImpl_(); }
+Fam_Descriptor::Fam_Descriptor() {
+    reset_hot(new (hot_) Fam_Descriptor_Hot());
+    fdimpl_ = new FamDescriptorImpl_();
+}
+
+Fam_Descriptor::~Fam_Descriptor() {
+    reset_hot(fam_descriptor_hot(this));
+    delete fdimpl_;
+}
+
+/*
+ * Allocated on a cache line boundary so that the hot fields, placed first,
+ * occupy exactly one line
+ */
+void *Fam_Descriptor::operator new(size_t size) {
+    void *ptr;
+    if (posix_memalign(&ptr, alignof(Fam_Descriptor_Hot), size) != 0)
+        throw std::bad_alloc();
+    return ptr;
+}
 
-Fam_Descriptor::~Fam_Descriptor() { delete fdimpl_; }
+void Fam_Descriptor::operator delete(void *ptr) { free(ptr); }
 
 Fam_Global_Descriptor Fam_Descriptor::get_global_descriptor() {
     return fdimpl_->get_global_descriptor();
 }
 
-void Fam_Descriptor::bind_key(uint64_t tempkey) { fdimpl_->bind_key(tempkey); }
+void Fam_Descriptor::bind_key(uint64_t tempkey) {
+    Fam_Descriptor_Hot *hot = fam_descriptor_hot(this);
+    if (hot->key == FAM_KEY_UNINITIALIZED)
+        hot->key = tempkey;
+}
 
-uint64_t Fam_Descriptor::get_key() { return fdimpl_->get_key(); }
+uint64_t Fam_Descriptor::get_key() { return fam_descriptor_hot(this)->key; }
 
-void Fam_Descriptor::set_context(void *ctx) { fdimpl_->set_context(ctx); }
+void Fam_Descriptor::set_context(void *ctx) {
+    fam_descriptor_hot(this)->context = ctx;
+}
 
-void *Fam_Descriptor::get_context() { return fdimpl_->get_context(); }
+void *Fam_Descriptor::get_context() {
+    return fam_descriptor_hot(this)->context;
+}
 
 void Fam_Descriptor::set_base_address(void *address) {
     fdimpl_->set_base_address(address);
@@ -145,14 +163,33 @@ void Fam_Descriptor::set_base_address(void *address) {
 void *Fam_Descriptor::get_base_address() { return fdimpl_->get_base_address(); }
 
 void Fam_Descriptor::set_size(uint64_t itemSize) {
-    return fdimpl_->set_size(itemSize);
+    Fam_Descriptor_Hot *hot = fam_descriptor_hot(this);
+    if (hot->size == 0)
+        hot->size = itemSize;
 }
 
-uint64_t Fam_Descriptor::get_size() { return fdimpl_->get_size(); }
+uint64_t Fam_Descriptor::get_size() { return fam_descriptor_hot(this)->size; }
 
 uint64_t Fam_Descriptor::get_memserver_id() {
     return fdimpl_->get_memserver_id();
 }
+
+void Fam_Descriptor::set_key_offset(uint64_t keyOffset) {
+    fam_descriptor_hot(this)->keyOffset = keyOffset;
+}
+
+uint64_t Fam_Descriptor::get_key_offset() {
+    return fam_descriptor_hot(this)->keyOffset;
+}
+
+void Fam_Descriptor::set_pool_item() { fdimpl_->set_pool_item(); }
+
+bool Fam_Descriptor::is_pool_item() { return fdimpl_->is_pool_item(); }
+
+bool Fam_Descriptor::release_pool_item() {
+    return fdimpl_->release_pool_item();
+}
+
 /*
  * Internal implementation of Fam_Region_Descriptor
  */
@@ -39,6 +39,7 @@
 #include "common/fam_libfabric.h"
 #include "common/fam_ops.h"
 #include "common/fam_ops_libfabric.h"
+#include "common/fam_util_gather.h"
 #include "fam/fam.h"
 #include "fam/fam_exception.h"
 
@@ -74,7 +75,7 @@ Fam_Ops_Libfabric::Fam_Ops_Libfabric(const char *memServerName,
 
     fiAddrs = new std::vector<fi_addr_t>();
     fiMrs = new std::map<uint64_t, fid_mr *>();
-    contexts = new std::map<uint64_t, Fam_Context *>();
+    contexts = new Fam_Context_Table();
     defContexts = new std::map<uint64_t, Fam_Context *>();
 
     fi = NULL;
@@ -84,6 +85,7 @@ Fam_Ops_Libfabric::Fam_Ops_Libfabric(const char *memServerName,
     av = NULL;
     serverAddrNameLen = 0;
     serverAddrName = NULL;
+    localBypass = NULL;
 
     if (!isSource && famAllocator == NULL) {
         message << "Fam Invalid Option Fam_Alloctor: NULL value specified"
@@ -108,7 +110,7 @@ Fam_Ops_Libfabric::Fam_Ops_Libfabric(MemServerMap memServerList,
 
     fiAddrs = new std::vector<fi_addr_t>();
     fiMrs = new std::map<uint64_t, fid_mr *>();
-    contexts = new std::map<uint64_t, Fam_Context *>();
+    contexts = new Fam_Context_Table();
     defContexts = new std::map<uint64_t, Fam_Context *>();
 
     fi = NULL;
@@ -118,6 +120,7 @@ Fam_Ops_Libfabric::Fam_Ops_Libfabric(MemServerMap memServerList,
     av = NULL;
     serverAddrNameLen = 0;
     serverAddrName = NULL;
+    localBypass = NULL;
 
     if (!isSource && famAllocator == NULL) {
         message << "Fam Invalid Option Fam_Alloctor: NULL value specified"
@@ -226,9 +229,57 @@ int Fam_Ops_Libfabric::initialize() {
     }
     fabric_iov_limit = fi->tx_attr->rma_iov_limit;
 
+    // Datapath to a memory server on this host goes through shared memory
+    if (!isSource)
+        localBypass = ((Fam_Allocator_Grpc *)famAllocator)->get_local_bypass();
+
     return 0;
 }
 
+char *Fam_Ops_Libfabric::get_local_base(Fam_Descriptor *descriptor,
+                                        uint64_t offset, uint64_t nbytes,
+                                        bool isWrite) {
+    if (localBypass == NULL)
+        return NULL;
+    char *base = localBypass->get_local_base(descriptor);
+    if (base == NULL)
+        return NULL;
+
+    uint64_t size = descriptor->get_size();
+    if ((offset > size) || ((offset + nbytes) > size)) {
+        throw Fam_Datapath_Exception(FAM_ERR_OUTOFRANGE,
+                                     "offset or data size is out of bound");
+    }
+    if (isWrite && !fam_descriptor_hot(descriptor)->localWrite) {
+        throw Fam_Datapath_Exception(FAM_ERR_NOPERM,
+                                     "not permitted to write into dataitem");
+    }
+    return base;
+}
+
+/*
+ * Byte range of the elements of a strided or indexed gather and scatter,
+ * as offset and length within the data item
+ */
+static void stride_extent(uint64_t nElements, uint64_t firstElement,
+                          uint64_t stride, uint64_t elementSize,
+                          uint64_t &offset, uint64_t &nbytes) {
+    offset = firstElement * elementSize;
+    nbytes = nElements ? ((nElements - 1) * stride + 1) * elementSize : 0;
+}
+
+static void index_extent(uint64_t nElements, uint64_t *elementIndex,
+                         uint64_t elementSize, uint64_t &offset,
+                         uint64_t &nbytes) {
+    uint64_t lastIndex = 0;
+    for (uint64_t i = 0; i < nElements; i++) {
+        if (elementIndex[i] > lastIndex)
+            lastIndex = elementIndex[i];
+    }
+    offset = 0;
+    nbytes = nElements ? (lastIndex + 1) * elementSize : 0;
+}
+
 Fam_Context *Fam_Ops_Libfabric::get_context(Fam_Descriptor *descriptor) {
     std::ostringstream message;
     // Case - FAM_CONTEXT_DEFAULT
@@ -245,28 +296,30 @@ Fam_Context *Fam_Ops_Libfabric::get_context(Fam_Descriptor *descriptor) {
         uint64_t regionId = global.regionId;
         int ret = 0;
 
-        // ctx mutex lock
-        (void)pthread_mutex_lock(&ctxLock);
-
-        auto ctxObj = contexts->find(regionId);
-        if (ctxObj == contexts->end()) {
-            ctx = new Fam_Context(fi, domain, famThreadModel);
-            contexts->insert({regionId, ctx});
-            ret = fabric_enable_bind_ep(fi, av, eq, ctx->get_ep());
-            if (ret < 0) {
-                // ctx mutex unlock
-                (void)pthread_mutex_unlock(&ctxLock);
-                message << "Fam libfabric fabric_enable_bind_ep failed: "
-                        << fabric_strerror(ret);
-                throw Fam_Datapath_Exception(message.str().c_str());
+        ctx = contexts->find(regionId);
+        if (ctx == NULL) {
+            // ctx mutex lock; only creating a context is serialized
+            (void)pthread_mutex_lock(&ctxLock);
+
+            ctx = contexts->find(regionId);
+            if (ctx == NULL) {
+                ctx = new Fam_Context(fi, domain, famThreadModel);
+                ret = fabric_enable_bind_ep(fi, av, eq, ctx->get_ep());
+                if (ret < 0) {
+                    delete ctx;
+                    // ctx mutex unlock
+                    (void)pthread_mutex_unlock(&ctxLock);
+                    message << "Fam libfabric fabric_enable_bind_ep failed: "
+                            << fabric_strerror(ret);
+                    throw Fam_Datapath_Exception(message.str().c_str());
+                }
+                contexts->insert(regionId, ctx);
             }
-        } else {
-            ctx = ctxObj->second;
+
+            // ctx mutex unlock
+            (void)pthread_mutex_unlock(&ctxLock);
         }
         descriptor->set_context(ctx);
-
-        // ctx mutex unlock
-        (void)pthread_mutex_unlock(&ctxLock);
         return ctx;
     } else {
         message << "Fam Invalid Option FAM_CONTEXT_MODEL: " << famContextModel;
@@ -274,6 +327,24 @@ Fam_Context *Fam_Ops_Libfabric::get_context(Fam_Descriptor *descriptor) {
     }
 }
 
+/*
+ * Resolve the fabric address of the memory server holding the data item and
+ * the context its operations go through, so that the datapath finds
+ * everything it needs in the descriptor's hot fields
+ */
+void Fam_Ops_Libfabric::bind_descriptor(Fam_Descriptor *descriptor) {
+    Fam_Descriptor_Hot *hot = fam_descriptor_hot(descriptor);
+    if (hot->bound)
+        return;
+
+    uint64_t nodeId = descriptor->get_memserver_id();
+    if (nodeId >= fiAddrs->size())
+        throw Fam_Datapath_Exception("Address for memserver not found");
+    hot->fiAddr = (*fiAddrs)[nodeId];
+    hot->context = get_context(descriptor);
+    hot->bound = true;
+}
+
 void Fam_Ops_Libfabric::finalize() {
     fabric_finalize();
     if (fiMrs != NULL) {
@@ -284,9 +355,8 @@ void Fam_Ops_Libfabric::finalize() {
     }
 
     if (contexts != NULL) {
-        for (auto fam_ctx : *contexts) {
-            delete fam_ctx.second;
-        }
+        contexts->for_each(
+            [](uint64_t regionId, Fam_Context *ctx) { delete ctx; });
         contexts->clear();
     }
 
@@ -327,27 +397,37 @@ void Fam_Ops_Libfabric::finalize() {
 
 int Fam_Ops_Libfabric::put_blocking(void *local, Fam_Descriptor *descriptor,
                                     uint64_t offset, uint64_t nbytes) {
+    char *famBase = get_local_base(descriptor, offset, nbytes, true);
+    if (famBase != NULL) {
+        memcpy(famBase + offset, local, nbytes);
+        openfam_persist(famBase + offset, nbytes);
+        return 0;
+    }
+
     std::ostringstream message;
     // Write data into memory region with this key
-    uint64_t key;
-    key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-    std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
-    int ret = fabric_write(key, local, nbytes, offset, (*fiAddr)[nodeId],
-                           get_context(descriptor));
+    Fam_Descriptor_Hot *hot = get_hot(descriptor);
+    offset += hot->keyOffset;
+    int ret = fabric_write(hot->key, local, nbytes, offset, hot->fiAddr,
+                           (Fam_Context *)hot->context);
     return ret;
 }
 
 int Fam_Ops_Libfabric::get_blocking(void *local, Fam_Descriptor *descriptor,
                                     uint64_t offset, uint64_t nbytes) {
+    char *famBase = get_local_base(descriptor, offset, nbytes, false);
+    if (famBase != NULL) {
+        openfam_invalidate(famBase + offset, nbytes);
+        memcpy(local, famBase + offset, nbytes);
+        return 0;
+    }
+
     std::ostringstream message;
     // Write data into memory region with this key
-    uint64_t key;
-    key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-    std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
-    int ret = fabric_read(key, local, nbytes, offset, (*fiAddr)[nodeId],
-                          get_context(descriptor));
+    Fam_Descriptor_Hot *hot = get_hot(descriptor);
+    offset += hot->keyOffset;
+    int ret = fabric_read(hot->key, local, nbytes, offset, hot->fiAddr,
+                          (Fam_Context *)hot->context);
 
     return ret;
 }
@@ -357,14 +437,21 @@ int Fam_Ops_Libfabric::gather_blocking(void *local, Fam_Descriptor *descriptor,
                                        uint64_t firstElement, uint64_t stride,
                                        uint64_t elementSize) {
 
-    uint64_t key;
+    uint64_t famOffset, famBytes;
+    stride_extent(nElements, firstElement, stride, elementSize, famOffset,
+                  famBytes);
+    char *famBase = get_local_base(descriptor, famOffset, famBytes, false);
+    if (famBase != NULL) {
+        fam_gather_stride(local, famBase, nElements, firstElement, stride,
+                          elementSize);
+        return 0;
+    }
 
-    key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-    std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
+    Fam_Descriptor_Hot *hot = get_hot(descriptor);
     int ret = fabric_gather_stride_blocking(
-        key, local, elementSize, firstElement, nElements, stride,
-        (*fiAddr)[nodeId], get_context(descriptor), fabric_iov_limit);
+        hot->key, local, elementSize, hot->keyOffset, firstElement,
+        nElements, stride, hot->fiAddr, (Fam_Context *)hot->context,
+        fabric_iov_limit);
     return ret;
 }
 
@@ -372,14 +459,20 @@ int Fam_Ops_Libfabric::gather_blocking(void *local, Fam_Descriptor *descriptor,
                                        uint64_t nElements,
                                        uint64_t *elementIndex,
                                        uint64_t elementSize) {
-    uint64_t key;
+    uint64_t famOffset, famBytes;
+    index_extent(nElements, elementIndex, elementSize, famOffset, famBytes);
+    char *famBase = get_local_base(descriptor, famOffset, famBytes, false);
+    if (famBase != NULL) {
+        fam_gather_index(local, famBase, nElements, elementIndex,
+                         elementSize);
+        return 0;
+    }
 
-    key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-    std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
+    Fam_Descriptor_Hot *hot = get_hot(descriptor);
     int ret = fabric_gather_index_blocking(
-        key, local, elementSize, elementIndex, nElements, (*fiAddr)[nodeId],
-        get_context(descriptor), fabric_iov_limit);
+        hot->key, local, elementSize, hot->keyOffset, elementIndex,
+        nElements, hot->fiAddr, (Fam_Context *)hot->context,
+        fabric_iov_limit);
     return ret;
 }
 
@@ -388,14 +481,21 @@ int Fam_Ops_Libfabric::scatter_blocking(void *local, Fam_Descriptor *descriptor,
                                         uint64_t firstElement, uint64_t stride,
                                         uint64_t elementSize) {
 
-    uint64_t key;
+    uint64_t famOffset, famBytes;
+    stride_extent(nElements, firstElement, stride, elementSize, famOffset,
+                  famBytes);
+    char *famBase = get_local_base(descriptor, famOffset, famBytes, true);
+    if (famBase != NULL) {
+        fam_scatter_stride(local, famBase, nElements, firstElement, stride,
+                           elementSize, NULL);
+        return 0;
+    }
 
-    key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-    std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
+    Fam_Descriptor_Hot *hot = get_hot(descriptor);
     int ret = fabric_scatter_stride_blocking(
-        key, local, elementSize, firstElement, nElements, stride,
-        (*fiAddr)[nodeId], get_context(descriptor), fabric_iov_limit);
+        hot->key, local, elementSize, hot->keyOffset, firstElement,
+        nElements, stride, hot->fiAddr, (Fam_Context *)hot->context,
+        fabric_iov_limit);
     return ret;
 }
 
@@ -403,39 +503,53 @@ int Fam_Ops_Libfabric::scatter_blocking(void *local, Fam_Descriptor *descriptor,
                                         uint64_t nElements,
                                         uint64_t *elementIndex,
                                         uint64_t elementSize) {
-    uint64_t key;
+    uint64_t famOffset, famBytes;
+    index_extent(nElements, elementIndex, elementSize, famOffset, famBytes);
+    char *famBase = get_local_base(descriptor, famOffset, famBytes, true);
+    if (famBase != NULL) {
+        fam_scatter_index(local, famBase, nElements, elementIndex,
+                          elementSize, NULL);
+        return 0;
+    }
 
-    key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-    std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
+    Fam_Descriptor_Hot *hot = get_hot(descriptor);
     int ret = fabric_scatter_index_blocking(
-        key, local, elementSize, elementIndex, nElements, (*fiAddr)[nodeId],
-        get_context(descriptor), fabric_iov_limit);
+        hot->key, local, elementSize, hot->keyOffset, elementIndex,
+        nElements, hot->fiAddr, (Fam_Context *)hot->context,
+        fabric_iov_limit);
     return ret;
 }
 
 void Fam_Ops_Libfabric::put_nonblocking(void *local, Fam_Descriptor *descriptor,
                                         uint64_t offset, uint64_t nbytes) {
 
-    uint64_t key;
+    char *famBase = get_local_base(descriptor, offset, nbytes, true);
+    if (famBase != NULL) {
+        memcpy(famBase + offset, local, nbytes);
+        openfam_persist(famBase + offset, nbytes);
+        return;
+    }
 
-    key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-    std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
-    fabric_write_nonblocking(key, local, nbytes, offset, (*fiAddr)[nodeId],
-                             get_context(descriptor));
+    Fam_Descriptor_Hot *hot = get_hot(descriptor);
+    offset += hot->keyOffset;
+    fabric_write_nonblocking(hot->key, local, nbytes, offset, hot->fiAddr,
+                             (Fam_Context *)hot->context);
     return;
 }
 
 void Fam_Ops_Libfabric::get_nonblocking(void *local, Fam_Descriptor *descriptor,
                                         uint64_t offset, uint64_t nbytes) {
-    uint64_t key;
+    char *famBase = get_local_base(descriptor, offset, nbytes, false);
+    if (famBase != NULL) {
+        openfam_invalidate(famBase + offset, nbytes);
+        memcpy(local, famBase + offset, nbytes);
+        return;
+    }
 
-    key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-    std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
-    fabric_read_nonblocking(key, local, nbytes, offset, (*fiAddr)[nodeId],
-                            get_context(descriptor));
+    Fam_Descriptor_Hot *hot = get_hot(descriptor);
+    offset += hot->keyOffset;
+    fabric_read_nonblocking(hot->key, local, nbytes, offset, hot->fiAddr,
+                            (Fam_Context *)hot->context);
     return;
 }
 
@@ -443,14 +557,21 @@ void Fam_Ops_Libfabric::gather_nonblocking(
     void *local, Fam_Descriptor *descriptor, uint64_t nElements,
     uint64_t firstElement, uint64_t stride, uint64_t elementSize) {
 
-    uint64_t key;
+    uint64_t famOffset, famBytes;
+    stride_extent(nElements, firstElement, stride, elementSize, famOffset,
+                  famBytes);
+    char *famBase = get_local_base(descriptor, famOffset, famBytes, false);
+    if (famBase != NULL) {
+        fam_gather_stride(local, famBase, nElements, firstElement, stride,
+                          elementSize);
+        return;
+    }
 
-    key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-    std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
-    fabric_gather_stride_nonblocking(key, local, elementSize, firstElement,
-                                     nElements, stride, (*fiAddr)[nodeId],
-                                     get_context(descriptor), fabric_iov_limit);
+    Fam_Descriptor_Hot *hot = get_hot(descriptor);
+    fabric_gather_stride_nonblocking(
+        hot->key, local, elementSize, hot->keyOffset, firstElement,
+        nElements, stride, hot->fiAddr, (Fam_Context *)hot->context,
+        fabric_iov_limit);
     return;
 }
 
@@ -459,14 +580,20 @@ void Fam_Ops_Libfabric::gather_nonblocking(void *local,
                                            uint64_t nElements,
                                            uint64_t *elementIndex,
                                            uint64_t elementSize) {
-    uint64_t key;
+    uint64_t famOffset, famBytes;
+    index_extent(nElements, elementIndex, elementSize, famOffset, famBytes);
+    char *famBase = get_local_base(descriptor, famOffset, famBytes, false);
+    if (famBase != NULL) {
+        fam_gather_index(local, famBase, nElements, elementIndex,
+                         elementSize);
+        return;
+    }
 
-    key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-    std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
-    fabric_gather_index_nonblocking(key, local, elementSize, elementIndex,
-                                    nElements, (*fiAddr)[nodeId],
-                                    get_context(descriptor), fabric_iov_limit);
+    Fam_Descriptor_Hot *hot = get_hot(descriptor);
+    fabric_gather_index_nonblocking(
+        hot->key, local, elementSize, hot->keyOffset, elementIndex,
+        nElements, hot->fiAddr, (Fam_Context *)hot->context,
+        fabric_iov_limit);
     return;
 }
 
@@ -474,14 +601,21 @@ void Fam_Ops_Libfabric::scatter_nonblocking(
     void *local, Fam_Descriptor *descriptor, uint64_t nElements,
     uint64_t firstElement, uint64_t stride, uint64_t elementSize) {
 
-    uint64_t key;
+    uint64_t famOffset, famBytes;
+    stride_extent(nElements, firstElement, stride, elementSize, famOffset,
+                  famBytes);
+    char *famBase = get_local_base(descriptor, famOffset, famBytes, true);
+    if (famBase != NULL) {
+        fam_scatter_stride(local, famBase, nElements, firstElement, stride,
+                           elementSize, NULL);
+        return;
+    }
 
-    key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-    std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
+    Fam_Descriptor_Hot *hot = get_hot(descriptor);
     fabric_scatter_stride_nonblocking(
-        key, local, elementSize, firstElement, nElements, stride,
-        (*fiAddr)[nodeId], get_context(descriptor), fabric_iov_limit);
+        hot->key, local, elementSize, hot->keyOffset, firstElement,
+        nElements, stride, hot->fiAddr, (Fam_Context *)hot->context,
+        fabric_iov_limit);
     return;
 }
 
@@ -490,14 +624,20 @@ void Fam_Ops_Libfabric::scatter_nonblocking(void *local,
                                             uint64_t nElements,
                                             uint64_t *elementIndex,
                                             uint64_t elementSize) {
-    uint64_t key;
+    uint64_t famOffset, famBytes;
+    index_extent(nElements, elementIndex, elementSize, famOffset, famBytes);
+    char *famBase = get_local_base(descriptor, famOffset, famBytes, true);
+    if (famBase != NULL) {
+        fam_scatter_index(local, famBase, nElements, elementIndex,
+                          elementSize, NULL);
+        return;
+    }
 
-    key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-    std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
-    fabric_scatter_index_nonblocking(key, local, elementSize, elementIndex,
-                                     nElements, (*fiAddr)[nodeId],
-                                     get_context(descriptor), fabric_iov_limit);
+    Fam_Descriptor_Hot *hot = get_hot(descriptor);
+    fabric_scatter_index_nonblocking(
+        hot->key, local, elementSize, hot->keyOffset, elementIndex,
+        nElements, hot->fiAddr, (Fam_Context *)hot->context,
+        fabric_iov_limit);
     return;
 }
 
@@ -511,6 +651,22 @@ void Fam_Ops_Libfabric::wait_for_copy(void *waitObj) {
     return famAllocator->wait_for_copy(waitObj);
 }
 
+/*
+ * Context of the region of the descriptor, or NULL if no operation on the
+ * region created one yet
+ */
+Fam_Context *
+Fam_Ops_Libfabric::find_context(Fam_Region_Descriptor *descriptor) {
+    Fam_Context *ctx = (Fam_Context *)descriptor->get_context();
+    if (ctx == NULL) {
+        Fam_Global_Descriptor global = descriptor->get_global_descriptor();
+        ctx = contexts->find(global.regionId);
+        if (ctx)
+            descriptor->set_context(ctx);
+    }
+    return ctx;
+}
+
 void Fam_Ops_Libfabric::fence(Fam_Region_Descriptor *descriptor) {
     std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
 
@@ -521,39 +677,16 @@ void Fam_Ops_Libfabric::fence(Fam_Region_Descriptor *descriptor) {
             nodeId++;
         }
     } else if (famContextModel == FAM_CONTEXT_REGION) {
-        // ctx mutex lock
-        (void)pthread_mutex_lock(&ctxLock);
-
-        try {
-            if (descriptor) {
-                nodeId = descriptor->get_memserver_id();
-                Fam_Context *ctx = (Fam_Context *)descriptor->get_context();
-                if (ctx) {
-                    fabric_fence((*fiAddr)[nodeId], ctx);
-                } else {
-                    Fam_Global_Descriptor global =
-                        descriptor->get_global_descriptor();
-                    uint64_t regionId = global.regionId;
-                    auto ctxObj = contexts->find(regionId);
-                    if (ctxObj != contexts->end()) {
-                        descriptor->set_context(ctxObj->second);
-                        fabric_fence((*fiAddr)[nodeId], ctxObj->second);
-                    }
-                }
-            } else {
-                for (auto fam_ctx : *contexts) {
-                    fabric_fence(
-                        (*fiAddr)[(fam_ctx.first) >> MEMSERVERID_SHIFT],
-                        fam_ctx.second);
-                }
-            }
-        } catch (...) {
-            // ctx mutex unlock
-            (void)pthread_mutex_unlock(&ctxLock);
-            throw;
+        if (descriptor) {
+            nodeId = descriptor->get_memserver_id();
+            Fam_Context *ctx = find_context(descriptor);
+            if (ctx)
+                fabric_fence((*fiAddr)[nodeId], ctx);
+        } else {
+            contexts->for_each([&](uint64_t regionId, Fam_Context *ctx) {
+                fabric_fence((*fiAddr)[regionId >> MEMSERVERID_SHIFT], ctx);
+            });
         }
-        // ctx mutex unlock
-        (void)pthread_mutex_unlock(&ctxLock);
     }
 }
 
@@ -572,178 +705,135 @@ void Fam_Ops_Libfabric::quiet(Fam_Region_Descriptor *descriptor) {
         quiet_context();
         return;
     } else if (famContextModel == FAM_CONTEXT_REGION) {
-        // ctx mutex lock
-        (void)pthread_mutex_lock(&ctxLock);
-        try {
-            if (descriptor) {
-                Fam_Context *ctx = (Fam_Context *)descriptor->get_context();
-                if (ctx) {
-                    quiet_context(ctx);
-                } else {
-                    Fam_Global_Descriptor global =
-                        descriptor->get_global_descriptor();
-                    uint64_t regionId = global.regionId;
-                    auto ctxObj = contexts->find(regionId);
-                    if (ctxObj != contexts->end()) {
-                        descriptor->set_context(ctxObj->second);
-                        quiet_context(ctxObj->second);
-                    }
-                }
-            } else {
-                for (auto fam_ctx : *contexts)
-                    quiet_context(fam_ctx.second);
-            }
-        } catch (...) {
-            // ctx mutex unlock
-            (void)pthread_mutex_unlock(&ctxLock);
-            throw;
+        if (descriptor) {
+            Fam_Context *ctx = find_context(descriptor);
+            if (ctx)
+                quiet_context(ctx);
+        } else {
+            contexts->for_each([&](uint64_t regionId, Fam_Context *ctx) {
+                quiet_context(ctx);
+            });
         }
-        // ctx mutex unlock
-        (void)pthread_mutex_unlock(&ctxLock);
     }
 }
 
 void Fam_Ops_Libfabric::atomic_set(Fam_Descriptor *descriptor, uint64_t offset,
                                    int32_t value) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-
-    std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
-    fabric_atomic(key, (void *)&value, offset, FI_ATOMIC_WRITE, FI_INT32,
-                  (*fiAddr)[nodeId], get_context(descriptor));
+    Fam_Descriptor_Hot *hot = get_hot(descriptor);
+    offset += hot->keyOffset;
+    fabric_atomic(hot->key, (void *)&value, offset, FI_ATOMIC_WRITE, FI_INT32,
+                  hot->fiAddr, (Fam_Context *)hot->context);
     return;
 }
 
 void Fam_Ops_Libfabric::atomic_set(Fam_Descriptor *descriptor, uint64_t offset,
                                    int64_t value) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-
-    std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
-    fabric_atomic(key, (void *)&value, offset, FI_ATOMIC_WRITE, FI_INT64,
-                  (*fiAddr)[nodeId], get_context(descriptor));
+    Fam_Descriptor_Hot *hot = get_hot(descriptor);
+    offset += hot->keyOffset;
+    fabric_atomic(hot->key, (void *)&value, offset, FI_ATOMIC_WRITE, FI_INT64,
+                  hot->fiAddr, (Fam_Context *)hot->context);
     return;
 }
 
 void Fam_Ops_Libfabric::atomic_set(Fam_Descriptor *descriptor, uint64_t offset,
                                    uint32_t value) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-
-    std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
-    fabric_atomic(key, (void *)&value, offset, FI_ATOMIC_WRITE, FI_UINT32,
-                  (*fiAddr)[nodeId], get_context(descriptor));
+    Fam_Descriptor_Hot *hot = get_hot(descriptor);
+    offset += hot->keyOffset;
+    fabric_atomic(hot->key, (void *)&value, offset, FI_ATOMIC_WRITE, FI_UINT32,
+                  hot->fiAddr, (Fam_Context *)hot->context);
     return;
 }
 
 void Fam_Ops_Libfabric::atomic_set(Fam_Descriptor *descriptor, uint64_t offset,
                                    uint64_t value) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-
-    std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
-    fabric_atomic(key, (void *)&value, offset, FI_ATOMIC_WRITE, FI_UINT64,
-                  (*fiAddr)[nodeId], get_context(descriptor));
+    Fam_Descriptor_Hot *hot = get_hot(descriptor);
+    offset += hot->keyOffset;
+    fabric_atomic(hot->key, (void *)&value, offset, FI_ATOMIC_WRITE, FI_UINT64,
+                  hot->fiAddr, (Fam_Context *)hot->context);
     return;
 }
 
 void Fam_Ops_Libfabric::atomic_set(Fam_Descriptor *descriptor, uint64_t offset,
                                    float value) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-
-    std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
-    fabric_atomic(key, (void *)&value, offset, FI_ATOMIC_WRITE, FI_FLOAT,
-                  (*fiAddr)[nodeId], get_context(descriptor));
+    Fam_Descriptor_Hot *hot = get_hot(descriptor);
+    offset += hot->keyOffset;
+    fabric_atomic(hot->key, (void *)&value, offset, FI_ATOMIC_WRITE, FI_FLOAT,
+                  hot->fiAddr, (Fam_Context *)hot->context);
     return;
 }
 
 void Fam_Ops_Libfabric::atomic_set(Fam_Descriptor *descriptor, uint64_t offset,
                                    double value) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-
-    std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
-    fabric_atomic(key, (void *)&value, offset, FI_ATOMIC_WRITE, FI_DOUBLE,
-                  (*fiAddr)[nodeId], get_context(descriptor));
+    Fam_Descriptor_Hot *hot = get_hot(descriptor);
+    offset += hot->keyOffset;
+    fabric_atomic(hot->key, (void *)&value, offset, FI_ATOMIC_WRITE, FI_DOUBLE,
+                  hot->fiAddr, (Fam_Context *)hot->context);
     return;
 }
 
 void Fam_Ops_Libfabric::atomic_add(Fam_Descriptor *descriptor, uint64_t offset,
                                    int32_t value) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-
-    std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
-    fabric_atomic(key, (void *)&value, offset, FI_SUM, FI_INT32,
-                  (*fiAddr)[nodeId], get_context(descriptor));
+    Fam_Descriptor_Hot *hot = get_hot(descriptor);
+    offset += hot->keyOffset;
+    fabric_atomic(hot->key, (void *)&value, offset, FI_SUM, FI_INT32,
+                  hot->fiAddr, (Fam_Context *)hot->context);
     return;
 }
 
 void Fam_Ops_Libfabric::atomic_add(Fam_Descriptor *descriptor, uint64_t offset,
                                    int64_t value) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-
-    std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
-    fabric_atomic(key, (void *)&value, offset, FI_SUM, FI_INT64,
-                  (*fiAddr)[nodeId], get_context(descriptor));
+    Fam_Descriptor_Hot *hot = get_hot(descriptor);
+    offset += hot->keyOffset;
+    fabric_atomic(hot->key, (void *)&value, offset, FI_SUM, FI_INT64,
+                  hot->fiAddr, (Fam_Context *)hot->context);
     return;
 }
 
 void Fam_Ops_Libfabric::atomic_add(Fam_Descriptor *descriptor, uint64_t offset,
                                    uint32_t value) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-
-    std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
-    fabric_atomic(key, (void *)&value, offset, FI_SUM, FI_UINT32,
-                  (*fiAddr)[nodeId], get_context(descriptor));
+    Fam_Descriptor_Hot *hot = get_hot(descriptor);
+    offset += hot->keyOffset;
+    fabric_atomic(hot->key, (void *)&value, offset, FI_SUM, FI_UINT32,
+                  hot->fiAddr, (Fam_Context *)hot->context);
     return;
 }
 
 void Fam_Ops_Libfabric::atomic_add(Fam_Descriptor *descriptor, uint64_t offset,
                                    uint64_t value) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-
-    std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
-    fabric_atomic(key, (void *)&value, offset, FI_SUM, FI_UINT64,
-                  (*fiAddr)[nodeId], get_context(descriptor));
+    Fam_Descriptor_Hot *hot = get_hot(descriptor);
+    offset += hot->keyOffset;
+    fabric_atomic(hot->key, (void *)&value, offset, FI_SUM, FI_UINT64,
+                  hot->fiAddr, (Fam_Context *)hot->context);
     return;
 }
 
 void Fam_Ops_Libfabric::atomic_add(Fam_Descriptor *descriptor, uint64_t offset,
                                    float value) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-
-    std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
-    fabric_atomic(key, (void *)&value, offset, FI_SUM, FI_FLOAT,
-                  (*fiAddr)[nodeId], get_context(descriptor));
+    Fam_Descriptor_Hot *hot = get_hot(descriptor);
+    offset += hot->keyOffset;
+    fabric_atomic(hot->key, (void *)&value, offset, FI_SUM, FI_FLOAT,
+                  hot->fiAddr, (Fam_Context *)hot->context);
     return;
 }
 
 void Fam_Ops_Libfabric::atomic_add(Fam_Descriptor *descriptor, uint64_t offset,
                                    double value) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-
-    std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
-    fabric_atomic(key, (void *)&value, offset, FI_SUM, FI_DOUBLE,
-                  (*fiAddr)[nodeId], get_context(descriptor));
+    Fam_Descriptor_Hot *hot = get_hot(descriptor);
+    offset += hot->keyOffset;
+    fabric_atomic(hot->key, (void *)&value, offset, FI_SUM, FI_DOUBLE,
+                  hot->fiAddr, (Fam_Context *)hot->context);
     return;
 }
 
@@ -786,300 +876,252 @@ void Fam_Ops_Libfabric::atomic_subtract(Fam_Descriptor *descriptor,
 void Fam_Ops_Libfabric::atomic_min(Fam_Descriptor *descriptor, uint64_t offset,
                                    int32_t value) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-
-    std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
-    fabric_atomic(key, (void *)&value, offset, FI_MIN, FI_INT32,
-                  (*fiAddr)[nodeId], get_context(descriptor));
+    Fam_Descriptor_Hot *hot = get_hot(descriptor);
+    offset += hot->keyOffset;
+    fabric_atomic(hot->key, (void *)&value, offset, FI_MIN, FI_INT32,
+                  hot->fiAddr, (Fam_Context *)hot->context);
     return;
 }
 
 void Fam_Ops_Libfabric::atomic_min(Fam_Descriptor *descriptor, uint64_t offset,
                                    int64_t value) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-
-    std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
-    fabric_atomic(key, (void *)&value, offset, FI_MIN, FI_INT64,
-                  (*fiAddr)[nodeId], get_context(descriptor));
+    Fam_Descriptor_Hot *hot = get_hot(descriptor);
+    offset += hot->keyOffset;
+    fabric_atomic(hot->key, (void *)&value, offset, FI_MIN, FI_INT64,
+                  hot->fiAddr, (Fam_Context *)hot->context);
     return;
 }
 
 void Fam_Ops_Libfabric::atomic_min(Fam_Descriptor *descriptor, uint64_t offset,
                                    uint32_t value) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-
-    std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
-    fabric_atomic(key, (void *)&value, offset, FI_MIN, FI_UINT32,
-                  (*fiAddr)[nodeId], get_context(descriptor));
+    Fam_Descriptor_Hot *hot = get_hot(descriptor);
+    offset += hot->keyOffset;
+    fabric_atomic(hot->key, (void *)&value, offset, FI_MIN, FI_UINT32,
+                  hot->fiAddr, (Fam_Context *)hot->context);
     return;
 }
 
 void Fam_Ops_Libfabric::atomic_min(Fam_Descriptor *descriptor, uint64_t offset,
                                    uint64_t value) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-
-    std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
-    fabric_atomic(key, (void *)&value, offset, FI_MIN, FI_UINT64,
-                  (*fiAddr)[nodeId], get_context(descriptor));
+    Fam_Descriptor_Hot *hot = get_hot(descriptor);
+    offset += hot->keyOffset;
+    fabric_atomic(hot->key, (void *)&value, offset, FI_MIN, FI_UINT64,
+                  hot->fiAddr, (Fam_Context *)hot->context);
     return;
 }
 
 void Fam_Ops_Libfabric::atomic_min(Fam_Descriptor *descriptor, uint64_t offset,
                                    float value) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-
-    std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
-    fabric_atomic(key, (void *)&value, offset, FI_MIN, FI_FLOAT,
-                  (*fiAddr)[nodeId], get_context(descriptor));
+    Fam_Descriptor_Hot *hot = get_hot(descriptor);
+    offset += hot->keyOffset;
+    fabric_atomic(hot->key, (void *)&value, offset, FI_MIN, FI_FLOAT,
+                  hot->fiAddr, (Fam_Context *)hot->context);
     return;
 }
 
 void Fam_Ops_Libfabric::atomic_min(Fam_Descriptor *descriptor, uint64_t offset,
                                    double value) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-
-    std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
-    fabric_atomic(key, (void *)&value, offset, FI_MIN, FI_DOUBLE,
-                  (*fiAddr)[nodeId], get_context(descriptor));
+    Fam_Descriptor_Hot *hot = get_hot(descriptor);
+    offset += hot->keyOffset;
+    fabric_atomic(hot->key, (void *)&value, offset, FI_MIN, FI_DOUBLE,
+                  hot->fiAddr, (Fam_Context *)hot->context);
     return;
 }
 
 void Fam_Ops_Libfabric::atomic_max(Fam_Descriptor *descriptor, uint64_t offset,
                                    int32_t value) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-
-    std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
-    fabric_atomic(key, (void *)&value, offset, FI_MAX, FI_INT32,
-                  (*fiAddr)[nodeId], get_context(descriptor));
+    Fam_Descriptor_Hot *hot = get_hot(descriptor);
+    offset += hot->keyOffset;
+    fabric_atomic(hot->key, (void *)&value, offset, FI_MAX, FI_INT32,
+                  hot->fiAddr, (Fam_Context *)hot->context);
     return;
 }
 
 void Fam_Ops_Libfabric::atomic_max(Fam_Descriptor *descriptor, uint64_t offset,
                                    int64_t value) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-
-    std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
-    fabric_atomic(key, (void *)&value, offset, FI_MAX, FI_INT64,
-                  (*fiAddr)[nodeId], get_context(descriptor));
+    Fam_Descriptor_Hot *hot = get_hot(descriptor);
+    offset += hot->keyOffset;
+    fabric_atomic(hot->key, (void *)&value, offset, FI_MAX, FI_INT64,
+                  hot->fiAddr, (Fam_Context *)hot->context);
     return;
 }
 
 void Fam_Ops_Libfabric::atomic_max(Fam_Descriptor *descriptor, uint64_t offset,
                                    uint32_t value) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-
-    std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
-    fabric_atomic(key, (void *)&value, offset, FI_MAX, FI_UINT32,
-                  (*fiAddr)[nodeId], get_context(descriptor));
+    Fam_Descriptor_Hot *hot = get_hot(descriptor);
+    offset += hot->keyOffset;
+    fabric_atomic(hot->key, (void *)&value, offset, FI_MAX, FI_UINT32,
+                  hot->fiAddr, (Fam_Context *)hot->context);
     return;
 }
 
 void Fam_Ops_Libfabric::atomic_max(Fam_Descriptor *descriptor, uint64_t offset,
                                    uint64_t value) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-
-    std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
-    fabric_atomic(key, (void *)&value, offset, FI_MAX, FI_UINT64,
-                  (*fiAddr)[nodeId], get_context(descriptor));
+    Fam_Descriptor_Hot *hot = get_hot(descriptor);
+    offset += hot->keyOffset;
+    fabric_atomic(hot->key, (void *)&value, offset, FI_MAX, FI_UINT64,
+                  hot->fiAddr, (Fam_Context *)hot->context);
     return;
 }
 
 void Fam_Ops_Libfabric::atomic_max(Fam_Descriptor *descriptor, uint64_t offset,
                                    float value) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-
-    std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
-    fabric_atomic(key, (void *)&value, offset, FI_MAX, FI_FLOAT,
-                  (*fiAddr)[nodeId], get_context(descriptor));
+    Fam_Descriptor_Hot *hot = get_hot(descriptor);
+    offset += hot->keyOffset;
+    fabric_atomic(hot->key, (void *)&value, offset, FI_MAX, FI_FLOAT,
+                  hot->fiAddr, (Fam_Context *)hot->context);
     return;
 }
 
 void Fam_Ops_Libfabric::atomic_max(Fam_Descriptor *descriptor, uint64_t offset,
                                    double value) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-
-    std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
-    fabric_atomic(key, (void *)&value, offset, FI_MAX, FI_DOUBLE,
-                  (*fiAddr)[nodeId], get_context(descriptor));
+    Fam_Descriptor_Hot *hot = get_hot(descriptor);
+    offset += hot->keyOffset;
+    fabric_atomic(hot->key, (void *)&value, offset, FI_MAX, FI_DOUBLE,
+                  hot->fiAddr, (Fam_Context *)hot->context);
     return;
 }
 
 void Fam_Ops_Libfabric::atomic_and(Fam_Descriptor *descriptor, uint64_t offset,
                                    uint32_t value) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-
-    std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
-    fabric_atomic(key, (void *)&value, offset, FI_BAND, FI_UINT32,
-                  (*fiAddr)[nodeId], get_context(descriptor));
+    Fam_Descriptor_Hot *hot = get_hot(descriptor);
+    offset += hot->keyOffset;
+    fabric_atomic(hot->key, (void *)&value, offset, FI_BAND, FI_UINT32,
+                  hot->fiAddr, (Fam_Context *)hot->context);
     return;
 }
 
 void Fam_Ops_Libfabric::atomic_and(Fam_Descriptor *descriptor, uint64_t offset,
                                    uint64_t value) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-
-    std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
-    fabric_atomic(key, (void *)&value, offset, FI_BAND, FI_UINT64,
-                  (*fiAddr)[nodeId], get_context(descriptor));
+    Fam_Descriptor_Hot *hot = get_hot(descriptor);
+    offset += hot->keyOffset;
+    fabric_atomic(hot->key, (void *)&value, offset, FI_BAND, FI_UINT64,
+                  hot->fiAddr, (Fam_Context *)hot->context);
     return;
 }
 
 void Fam_Ops_Libfabric::atomic_or(Fam_Descriptor *descriptor, uint64_t offset,
                                   uint32_t value) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-
-    std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
-    fabric_atomic(key, (void *)&value, offset, FI_BOR, FI_UINT32,
-                  (*fiAddr)[nodeId], get_context(descriptor));
+    Fam_Descriptor_Hot *hot = get_hot(descriptor);
+    offset += hot->keyOffset;
+    fabric_atomic(hot->key, (void *)&value, offset, FI_BOR, FI_UINT32,
+                  hot->fiAddr, (Fam_Context *)hot->context);
     return;
 }
 
 void Fam_Ops_Libfabric::atomic_or(Fam_Descriptor *descriptor, uint64_t offset,
                                   uint64_t value) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-
-    std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
-    fabric_atomic(key, (void *)&value, offset, FI_BOR, FI_UINT64,
-                  (*fiAddr)[nodeId], get_context(descriptor));
+    Fam_Descriptor_Hot *hot = get_hot(descriptor);
+    offset += hot->keyOffset;
+    fabric_atomic(hot->key, (void *)&value, offset, FI_BOR, FI_UINT64,
+                  hot->fiAddr, (Fam_Context *)hot->context);
     return;
 }
 
 void Fam_Ops_Libfabric::atomic_xor(Fam_Descriptor *descriptor, uint64_t offset,
                                    uint32_t value) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-
-    std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
-    fabric_atomic(key, (void *)&value, offset, FI_BXOR, FI_UINT32,
-                  (*fiAddr)[nodeId], get_context(descriptor));
+    Fam_Descriptor_Hot *hot = get_hot(descriptor);
+    offset += hot->keyOffset;
+    fabric_atomic(hot->key, (void *)&value, offset, FI_BXOR, FI_UINT32,
+                  hot->fiAddr, (Fam_Context *)hot->context);
     return;
 }
 
 void Fam_Ops_Libfabric::atomic_xor(Fam_Descriptor *descriptor, uint64_t offset,
                                    uint64_t value) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-
-    std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
-    fabric_atomic(key, (void *)&value, offset, FI_BXOR, FI_UINT64,
-                  (*fiAddr)[nodeId], get_context(descriptor));
+    Fam_Descriptor_Hot *hot = get_hot(descriptor);
+    offset += hot->keyOffset;
+    fabric_atomic(hot->key, (void *)&value, offset, FI_BXOR, FI_UINT64,
+                  hot->fiAddr, (Fam_Context *)hot->context);
     return;
 }
 
 int32_t Fam_Ops_Libfabric::swap(Fam_Descriptor *descriptor, uint64_t offset,
                                 int32_t value) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-
-    std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
+    Fam_Descriptor_Hot *hot = get_hot(descriptor);
+    offset += hot->keyOffset;
     int32_t old;
-    fabric_fetch_atomic(key, (void *)&value, (void *)&old, offset,
-                        FI_ATOMIC_WRITE, FI_INT32, (*fiAddr)[nodeId],
-                        get_context(descriptor));
+    fabric_fetch_atomic(hot->key, (void *)&value, (void *)&old, offset,
+                        FI_ATOMIC_WRITE, FI_INT32, hot->fiAddr,
+                        (Fam_Context *)hot->context);
     return old;
 }
 
 int64_t Fam_Ops_Libfabric::swap(Fam_Descriptor *descriptor, uint64_t offset,
                                 int64_t value) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-
-    std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
+    Fam_Descriptor_Hot *hot = get_hot(descriptor);
+    offset += hot->keyOffset;
     int64_t old;
-    fabric_fetch_atomic(key, (void *)&value, (void *)&old, offset,
-                        FI_ATOMIC_WRITE, FI_INT64, (*fiAddr)[nodeId],
-                        get_context(descriptor));
+    fabric_fetch_atomic(hot->key, (void *)&value, (void *)&old, offset,
+                        FI_ATOMIC_WRITE, FI_INT64, hot->fiAddr,
+                        (Fam_Context *)hot->context);
     return old;
 }
 
 uint32_t Fam_Ops_Libfabric::swap(Fam_Descriptor *descriptor, uint64_t offset,
                                  uint32_t value) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-
-    std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
+    Fam_Descriptor_Hot *hot = get_hot(descriptor);
+    offset += hot->keyOffset;
     uint32_t old;
-    fabric_fetch_atomic(key, (void *)&value, (void *)&old, offset,
-                        FI_ATOMIC_WRITE, FI_UINT32, (*fiAddr)[nodeId],
-                        get_context(descriptor));
+    fabric_fetch_atomic(hot->key, (void *)&value, (void *)&old, offset,
+                        FI_ATOMIC_WRITE, FI_UINT32, hot->fiAddr,
+                        (Fam_Context *)hot->context);
     return old;
 }
 
 uint64_t Fam_Ops_Libfabric::swap(Fam_Descriptor *descriptor, uint64_t offset,
                                  uint64_t value) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-
-    std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
+    Fam_Descriptor_Hot *hot = get_hot(descriptor);
+    offset += hot->keyOffset;
     uint64_t old;
-    fabric_fetch_atomic(key, (void *)&value, (void *)&old, offset,
-                        FI_ATOMIC_WRITE, FI_UINT64, (*fiAddr)[nodeId],
-                        get_context(descriptor));
+    fabric_fetch_atomic(hot->key, (void *)&value, (void *)&old, offset,
+                        FI_ATOMIC_WRITE, FI_UINT64, hot->fiAddr,
+                        (Fam_Context *)hot->context);
     return old;
 }
 
 float Fam_Ops_Libfabric::swap(Fam_Descriptor *descriptor, uint64_t offset,
                               float value) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-
-    std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
+    Fam_Descriptor_Hot *hot = get_hot(descriptor);
+    offset += hot->keyOffset;
     float old;
-    fabric_fetch_atomic(key, (void *)&value, (void *)&old, offset,
-                        FI_ATOMIC_WRITE, FI_FLOAT, (*fiAddr)[nodeId],
-                        get_context(descriptor));
+    fabric_fetch_atomic(hot->key, (void *)&value, (void *)&old, offset,
+                        FI_ATOMIC_WRITE, FI_FLOAT, hot->fiAddr,
+                        (Fam_Context *)hot->context);
     return old;
 }
 
 double Fam_Ops_Libfabric::swap(Fam_Descriptor *descriptor, uint64_t offset,
                                double value) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-
-    std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
+    Fam_Descriptor_Hot *hot = get_hot(descriptor);
+    offset += hot->keyOffset;
     double old;
-    fabric_fetch_atomic(key, (void *)&value, (void *)&old, offset,
-                        FI_ATOMIC_WRITE, FI_DOUBLE, (*fiAddr)[nodeId],
-                        get_context(descriptor));
+    fabric_fetch_atomic(hot->key, (void *)&value, (void *)&old, offset,
+                        FI_ATOMIC_WRITE, FI_DOUBLE, hot->fiAddr,
+                        (Fam_Context *)hot->context);
     return old;
 }
 
@@ -1087,14 +1129,12 @@ int32_t Fam_Ops_Libfabric::compare_swap(Fam_Descriptor *descriptor,
                                         uint64_t offset, int32_t oldValue,
                                         int32_t newValue) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-
-    std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
+    Fam_Descriptor_Hot *hot = get_hot(descriptor);
+    offset += hot->keyOffset;
     int32_t old;
-    fabric_compare_atomic(key, (void *)&oldValue, (void *)&old,
+    fabric_compare_atomic(hot->key, (void *)&oldValue, (void *)&old,
                           (void *)&newValue, offset, FI_CSWAP, FI_INT32,
-                          (*fiAddr)[nodeId], get_context(descriptor));
+                          hot->fiAddr, (Fam_Context *)hot->context);
     return old;
 }
 
@@ -1102,14 +1142,12 @@ int64_t Fam_Ops_Libfabric::compare_swap(Fam_Descriptor *descriptor,
                                         uint64_t offset, int64_t oldValue,
                                         int64_t newValue) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-
-    std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
+    Fam_Descriptor_Hot *hot = get_hot(descriptor);
+    offset += hot->keyOffset;
     int64_t old;
-    fabric_compare_atomic(key, (void *)&oldValue, (void *)&old,
+    fabric_compare_atomic(hot->key, (void *)&oldValue, (void *)&old,
                           (void *)&newValue, offset, FI_CSWAP, FI_INT64,
-                          (*fiAddr)[nodeId], get_context(descriptor));
+                          hot->fiAddr, (Fam_Context *)hot->context);
     return old;
 }
 
@@ -1117,14 +1155,12 @@ uint32_t Fam_Ops_Libfabric::compare_swap(Fam_Descriptor *descriptor,
                                          uint64_t offset, uint32_t oldValue,
                                          uint32_t newValue) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-
-    std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
+    Fam_Descriptor_Hot *hot = get_hot(descriptor);
+    offset += hot->keyOffset;
     uint32_t old;
-    fabric_compare_atomic(key, (void *)&oldValue, (void *)&old,
+    fabric_compare_atomic(hot->key, (void *)&oldValue, (void *)&old,
                           (void *)&newValue, offset, FI_CSWAP, FI_UINT32,
-                          (*fiAddr)[nodeId], get_context(descriptor));
+                          hot->fiAddr, (Fam_Context *)hot->context);
     return old;
 }
 
@@ -1132,14 +1168,12 @@ uint64_t Fam_Ops_Libfabric::compare_swap(Fam_Descriptor *descriptor,
                                          uint64_t offset, uint64_t oldValue,
                                          uint64_t newValue) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-
-    std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
+    Fam_Descriptor_Hot *hot = get_hot(descriptor);
+    offset += hot->keyOffset;
     uint64_t old;
-    fabric_compare_atomic(key, (void *)&oldValue, (void *)&old,
+    fabric_compare_atomic(hot->key, (void *)&oldValue, (void *)&old,
                           (void *)&newValue, offset, FI_CSWAP, FI_UINT64,
-                          (*fiAddr)[nodeId], get_context(descriptor));
+                          hot->fiAddr, (Fam_Context *)hot->context);
     return old;
 }
 
@@ -1147,16 +1181,14 @@ int128_t Fam_Ops_Libfabric::compare_swap(Fam_Descriptor *descriptor,
                                          uint64_t offset, int128_t oldValue,
                                          int128_t newValue) {
 
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-
-    std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
+    Fam_Descriptor_Hot *hot = get_hot(descriptor);
+    offset += hot->keyOffset;
     int128_t local;
 
     famAllocator->acquire_CAS_lock(descriptor);
     try {
-        fabric_read(key, &local, sizeof(int128_t), offset, (*fiAddr)[nodeId],
-                    get_context(descriptor));
+        fabric_read(hot->key, &local, sizeof(int128_t), offset, hot->fiAddr,
+                    (Fam_Context *)hot->context);
     } catch (...) {
         famAllocator->release_CAS_lock(descriptor);
         throw;
@@ -1164,8 +1196,8 @@ int128_t Fam_Ops_Libfabric::compare_swap(Fam_Descriptor *descriptor,
 
     if (local == oldValue) {
         try {
-            fabric_write(key, &newValue, sizeof(int128_t), offset,
-                         (*fiAddr)[nodeId], get_context(descriptor));
+            fabric_write(hot->key, &newValue, sizeof(int128_t), offset,
+                         hot->fiAddr, (Fam_Context *)hot->context);
         } catch (...) {
             famAllocator->release_CAS_lock(descriptor);
             throw;
@@ -1178,162 +1210,138 @@ int128_t Fam_Ops_Libfabric::compare_swap(Fam_Descriptor *descriptor,
 int32_t Fam_Ops_Libfabric::atomic_fetch_int32(Fam_Descriptor *descriptor,
                                               uint64_t offset) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-
-    std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
+    Fam_Descriptor_Hot *hot = get_hot(descriptor);
+    offset += hot->keyOffset;
     int32_t result;
-    fabric_fetch_atomic(key, (void *)&result, (void *)&result, offset,
-                        FI_ATOMIC_READ, FI_INT32, (*fiAddr)[nodeId],
-                        get_context(descriptor));
+    fabric_fetch_atomic(hot->key, (void *)&result, (void *)&result, offset,
+                        FI_ATOMIC_READ, FI_INT32, hot->fiAddr,
+                        (Fam_Context *)hot->context);
     return result;
 }
 
 int64_t Fam_Ops_Libfabric::atomic_fetch_int64(Fam_Descriptor *descriptor,
                                               uint64_t offset) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-
-    std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
+    Fam_Descriptor_Hot *hot = get_hot(descriptor);
+    offset += hot->keyOffset;
     int64_t result;
-    fabric_fetch_atomic(key, (void *)&result, (void *)&result, offset,
-                        FI_ATOMIC_READ, FI_INT64, (*fiAddr)[nodeId],
-                        get_context(descriptor));
+    fabric_fetch_atomic(hot->key, (void *)&result, (void *)&result, offset,
+                        FI_ATOMIC_READ, FI_INT64, hot->fiAddr,
+                        (Fam_Context *)hot->context);
     return result;
 }
 
 uint32_t Fam_Ops_Libfabric::atomic_fetch_uint32(Fam_Descriptor *descriptor,
                                                 uint64_t offset) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-
-    std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
+    Fam_Descriptor_Hot *hot = get_hot(descriptor);
+    offset += hot->keyOffset;
     uint32_t result;
-    fabric_fetch_atomic(key, (void *)&result, (void *)&result, offset,
-                        FI_ATOMIC_READ, FI_UINT32, (*fiAddr)[nodeId],
-                        get_context(descriptor));
+    fabric_fetch_atomic(hot->key, (void *)&result, (void *)&result, offset,
+                        FI_ATOMIC_READ, FI_UINT32, hot->fiAddr,
+                        (Fam_Context *)hot->context);
     return result;
 }
 
 uint64_t Fam_Ops_Libfabric::atomic_fetch_uint64(Fam_Descriptor *descriptor,
                                                 uint64_t offset) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-
-    std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
+    Fam_Descriptor_Hot *hot = get_hot(descriptor);
+    offset += hot->keyOffset;
     uint64_t result;
-    fabric_fetch_atomic(key, (void *)&result, (void *)&result, offset,
-                        FI_ATOMIC_READ, FI_UINT64, (*fiAddr)[nodeId],
-                        get_context(descriptor));
+    fabric_fetch_atomic(hot->key, (void *)&result, (void *)&result, offset,
+                        FI_ATOMIC_READ, FI_UINT64, hot->fiAddr,
+                        (Fam_Context *)hot->context);
     return result;
 }
 
 float Fam_Ops_Libfabric::atomic_fetch_float(Fam_Descriptor *descriptor,
                                             uint64_t offset) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-
-    std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
+    Fam_Descriptor_Hot *hot = get_hot(descriptor);
+    offset += hot->keyOffset;
     float result;
-    fabric_fetch_atomic(key, (void *)&result, (void *)&result, offset,
-                        FI_ATOMIC_READ, FI_FLOAT, (*fiAddr)[nodeId],
-                        get_context(descriptor));
+    fabric_fetch_atomic(hot->key, (void *)&result, (void *)&result, offset,
+                        FI_ATOMIC_READ, FI_FLOAT, hot->fiAddr,
+                        (Fam_Context *)hot->context);
     return result;
 }
 
 double Fam_Ops_Libfabric::atomic_fetch_double(Fam_Descriptor *descriptor,
                                               uint64_t offset) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-
-    std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
+    Fam_Descriptor_Hot *hot = get_hot(descriptor);
+    offset += hot->keyOffset;
     double result;
-    fabric_fetch_atomic(key, (void *)&result, (void *)&result, offset,
-                        FI_ATOMIC_READ, FI_DOUBLE, (*fiAddr)[nodeId],
-                        get_context(descriptor));
+    fabric_fetch_atomic(hot->key, (void *)&result, (void *)&result, offset,
+                        FI_ATOMIC_READ, FI_DOUBLE, hot->fiAddr,
+                        (Fam_Context *)hot->context);
     return result;
 }
 
 int32_t Fam_Ops_Libfabric::atomic_fetch_add(Fam_Descriptor *descriptor,
                                             uint64_t offset, int32_t value) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-
-    std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
+    Fam_Descriptor_Hot *hot = get_hot(descriptor);
+    offset += hot->keyOffset;
     int32_t old;
-    fabric_fetch_atomic(key, (void *)&value, (void *)&old, offset, FI_SUM,
-                        FI_INT32, (*fiAddr)[nodeId], get_context(descriptor));
+    fabric_fetch_atomic(hot->key, (void *)&value, (void *)&old, offset, FI_SUM,
+                        FI_INT32, hot->fiAddr, (Fam_Context *)hot->context);
     return old;
 }
 
 int64_t Fam_Ops_Libfabric::atomic_fetch_add(Fam_Descriptor *descriptor,
                                             uint64_t offset, int64_t value) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-
-    std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
+    Fam_Descriptor_Hot *hot = get_hot(descriptor);
+    offset += hot->keyOffset;
     int64_t old;
-    fabric_fetch_atomic(key, (void *)&value, (void *)&old, offset, FI_SUM,
-                        FI_INT64, (*fiAddr)[nodeId], get_context(descriptor));
+    fabric_fetch_atomic(hot->key, (void *)&value, (void *)&old, offset, FI_SUM,
+                        FI_INT64, hot->fiAddr, (Fam_Context *)hot->context);
     return old;
 }
 
 uint32_t Fam_Ops_Libfabric::atomic_fetch_add(Fam_Descriptor *descriptor,
                                              uint64_t offset, uint32_t value) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-
-    std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
+    Fam_Descriptor_Hot *hot = get_hot(descriptor);
+    offset += hot->keyOffset;
     uint32_t old;
-    fabric_fetch_atomic(key, (void *)&value, (void *)&old, offset, FI_SUM,
-                        FI_UINT32, (*fiAddr)[nodeId], get_context(descriptor));
+    fabric_fetch_atomic(hot->key, (void *)&value, (void *)&old, offset, FI_SUM,
+                        FI_UINT32, hot->fiAddr, (Fam_Context *)hot->context);
     return old;
 }
 
 uint64_t Fam_Ops_Libfabric::atomic_fetch_add(Fam_Descriptor *descriptor,
                                              uint64_t offset, uint64_t value) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-
-    std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
+    Fam_Descriptor_Hot *hot = get_hot(descriptor);
+    offset += hot->keyOffset;
     uint64_t old;
-    fabric_fetch_atomic(key, (void *)&value, (void *)&old, offset, FI_SUM,
-                        FI_UINT64, (*fiAddr)[nodeId], get_context(descriptor));
+    fabric_fetch_atomic(hot->key, (void *)&value, (void *)&old, offset, FI_SUM,
+                        FI_UINT64, hot->fiAddr, (Fam_Context *)hot->context);
     return old;
 }
 
 float Fam_Ops_Libfabric::atomic_fetch_add(Fam_Descriptor *descriptor,
                                           uint64_t offset, float value) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-
-    std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
+    Fam_Descriptor_Hot *hot = get_hot(descriptor);
+    offset += hot->keyOffset;
     float old;
-    fabric_fetch_atomic(key, (void *)&value, (void *)&old, offset, FI_SUM,
-                        FI_FLOAT, (*fiAddr)[nodeId], get_context(descriptor));
+    fabric_fetch_atomic(hot->key, (void *)&value, (void *)&old, offset, FI_SUM,
+                        FI_FLOAT, hot->fiAddr, (Fam_Context *)hot->context);
     return old;
 }
 
 double Fam_Ops_Libfabric::atomic_fetch_add(Fam_Descriptor *descriptor,
                                            uint64_t offset, double value) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-
-    std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
+    Fam_Descriptor_Hot *hot = get_hot(descriptor);
+    offset += hot->keyOffset;
     double old;
-    fabric_fetch_atomic(key, (void *)&value, (void *)&old, offset, FI_SUM,
-                        FI_DOUBLE, (*fiAddr)[nodeId], get_context(descriptor));
+    fabric_fetch_atomic(hot->key, (void *)&value, (void *)&old, offset, FI_SUM,
+                        FI_DOUBLE, hot->fiAddr, (Fam_Context *)hot->context);
     return old;
 }
 
@@ -1374,234 +1382,198 @@ double Fam_Ops_Libfabric::atomic_fetch_subtract(Fam_Descriptor *descriptor,
 int32_t Fam_Ops_Libfabric::atomic_fetch_min(Fam_Descriptor *descriptor,
                                             uint64_t offset, int32_t value) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-
-    std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
+    Fam_Descriptor_Hot *hot = get_hot(descriptor);
+    offset += hot->keyOffset;
     int32_t old;
-    fabric_fetch_atomic(key, (void *)&value, (void *)&old, offset, FI_MIN,
-                        FI_INT32, (*fiAddr)[nodeId], get_context(descriptor));
+    fabric_fetch_atomic(hot->key, (void *)&value, (void *)&old, offset, FI_MIN,
+                        FI_INT32, hot->fiAddr, (Fam_Context *)hot->context);
     return old;
 }
 
 int64_t Fam_Ops_Libfabric::atomic_fetch_min(Fam_Descriptor *descriptor,
                                             uint64_t offset, int64_t value) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-
-    std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
+    Fam_Descriptor_Hot *hot = get_hot(descriptor);
+    offset += hot->keyOffset;
     int64_t old;
-    fabric_fetch_atomic(key, (void *)&value, (void *)&old, offset, FI_MIN,
-                        FI_INT64, (*fiAddr)[nodeId], get_context(descriptor));
+    fabric_fetch_atomic(hot->key, (void *)&value, (void *)&old, offset, FI_MIN,
+                        FI_INT64, hot->fiAddr, (Fam_Context *)hot->context);
     return old;
 }
 
 uint32_t Fam_Ops_Libfabric::atomic_fetch_min(Fam_Descriptor *descriptor,
                                              uint64_t offset, uint32_t value) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-
-    std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
+    Fam_Descriptor_Hot *hot = get_hot(descriptor);
+    offset += hot->keyOffset;
     uint32_t old;
-    fabric_fetch_atomic(key, (void *)&value, (void *)&old, offset, FI_MIN,
-                        FI_UINT32, (*fiAddr)[nodeId], get_context(descriptor));
+    fabric_fetch_atomic(hot->key, (void *)&value, (void *)&old, offset, FI_MIN,
+                        FI_UINT32, hot->fiAddr, (Fam_Context *)hot->context);
     return old;
 }
 
 uint64_t Fam_Ops_Libfabric::atomic_fetch_min(Fam_Descriptor *descriptor,
                                              uint64_t offset, uint64_t value) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-
-    std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
+    Fam_Descriptor_Hot *hot = get_hot(descriptor);
+    offset += hot->keyOffset;
     uint64_t old;
-    fabric_fetch_atomic(key, (void *)&value, (void *)&old, offset, FI_MIN,
-                        FI_UINT64, (*fiAddr)[nodeId], get_context(descriptor));
+    fabric_fetch_atomic(hot->key, (void *)&value, (void *)&old, offset, FI_MIN,
+                        FI_UINT64, hot->fiAddr, (Fam_Context *)hot->context);
     return old;
 }
 
 float Fam_Ops_Libfabric::atomic_fetch_min(Fam_Descriptor *descriptor,
                                           uint64_t offset, float value) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-
-    std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
+    Fam_Descriptor_Hot *hot = get_hot(descriptor);
+    offset += hot->keyOffset;
     float old;
-    fabric_fetch_atomic(key, (void *)&value, (void *)&old, offset, FI_MIN,
-                        FI_FLOAT, (*fiAddr)[nodeId], get_context(descriptor));
+    fabric_fetch_atomic(hot->key, (void *)&value, (void *)&old, offset, FI_MIN,
+                        FI_FLOAT, hot->fiAddr, (Fam_Context *)hot->context);
     return old;
 }
 
 double Fam_Ops_Libfabric::atomic_fetch_min(Fam_Descriptor *descriptor,
                                            uint64_t offset, double value) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-
-    std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
+    Fam_Descriptor_Hot *hot = get_hot(descriptor);
+    offset += hot->keyOffset;
     double old;
-    fabric_fetch_atomic(key, (void *)&value, (void *)&old, offset, FI_MIN,
-                        FI_DOUBLE, (*fiAddr)[nodeId], get_context(descriptor));
+    fabric_fetch_atomic(hot->key, (void *)&value, (void *)&old, offset, FI_MIN,
+                        FI_DOUBLE, hot->fiAddr, (Fam_Context *)hot->context);
     return old;
 }
 
 int32_t Fam_Ops_Libfabric::atomic_fetch_max(Fam_Descriptor *descriptor,
                                             uint64_t offset, int32_t value) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-
-    std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
+    Fam_Descriptor_Hot *hot = get_hot(descriptor);
+    offset += hot->keyOffset;
     int32_t old;
-    fabric_fetch_atomic(key, (void *)&value, (void *)&old, offset, FI_MAX,
-                        FI_INT32, (*fiAddr)[nodeId], get_context(descriptor));
+    fabric_fetch_atomic(hot->key, (void *)&value, (void *)&old, offset, FI_MAX,
+                        FI_INT32, hot->fiAddr, (Fam_Context *)hot->context);
     return old;
 }
 
 int64_t Fam_Ops_Libfabric::atomic_fetch_max(Fam_Descriptor *descriptor,
                                             uint64_t offset, int64_t value) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-
-    std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
+    Fam_Descriptor_Hot *hot = get_hot(descriptor);
+    offset += hot->keyOffset;
     int64_t old;
-    fabric_fetch_atomic(key, (void *)&value, (void *)&old, offset, FI_MAX,
-                        FI_INT64, (*fiAddr)[nodeId], get_context(descriptor));
+    fabric_fetch_atomic(hot->key, (void *)&value, (void *)&old, offset, FI_MAX,
+                        FI_INT64, hot->fiAddr, (Fam_Context *)hot->context);
     return old;
 }
 
 uint32_t Fam_Ops_Libfabric::atomic_fetch_max(Fam_Descriptor *descriptor,
                                              uint64_t offset, uint32_t value) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-
-    std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
+    Fam_Descriptor_Hot *hot = get_hot(descriptor);
+    offset += hot->keyOffset;
     uint32_t old;
-    fabric_fetch_atomic(key, (void *)&value, (void *)&old, offset, FI_MAX,
-                        FI_UINT32, (*fiAddr)[nodeId], get_context(descriptor));
+    fabric_fetch_atomic(hot->key, (void *)&value, (void *)&old, offset, FI_MAX,
+                        FI_UINT32, hot->fiAddr, (Fam_Context *)hot->context);
     return old;
 }
 
 uint64_t Fam_Ops_Libfabric::atomic_fetch_max(Fam_Descriptor *descriptor,
                                              uint64_t offset, uint64_t value) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-
-    std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
+    Fam_Descriptor_Hot *hot = get_hot(descriptor);
+    offset += hot->keyOffset;
     uint64_t old;
-    fabric_fetch_atomic(key, (void *)&value, (void *)&old, offset, FI_MAX,
-                        FI_UINT64, (*fiAddr)[nodeId], get_context(descriptor));
+    fabric_fetch_atomic(hot->key, (void *)&value, (void *)&old, offset, FI_MAX,
+                        FI_UINT64, hot->fiAddr, (Fam_Context *)hot->context);
     return old;
 }
 
 float Fam_Ops_Libfabric::atomic_fetch_max(Fam_Descriptor *descriptor,
                                           uint64_t offset, float value) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-
-    std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
+    Fam_Descriptor_Hot *hot = get_hot(descriptor);
+    offset += hot->keyOffset;
     float old;
-    fabric_fetch_atomic(key, (void *)&value, (void *)&old, offset, FI_MAX,
-                        FI_FLOAT, (*fiAddr)[nodeId], get_context(descriptor));
+    fabric_fetch_atomic(hot->key, (void *)&value, (void *)&old, offset, FI_MAX,
+                        FI_FLOAT, hot->fiAddr, (Fam_Context *)hot->context);
     return old;
 }
 
 double Fam_Ops_Libfabric::atomic_fetch_max(Fam_Descriptor *descriptor,
                                            uint64_t offset, double value) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-
-    std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
+    Fam_Descriptor_Hot *hot = get_hot(descriptor);
+    offset += hot->keyOffset;
     double old;
-    fabric_fetch_atomic(key, (void *)&value, (void *)&old, offset, FI_MAX,
-                        FI_DOUBLE, (*fiAddr)[nodeId], get_context(descriptor));
+    fabric_fetch_atomic(hot->key, (void *)&value, (void *)&old, offset, FI_MAX,
+                        FI_DOUBLE, hot->fiAddr, (Fam_Context *)hot->context);
     return old;
 }
 
 uint32_t Fam_Ops_Libfabric::atomic_fetch_and(Fam_Descriptor *descriptor,
                                              uint64_t offset, uint32_t value) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-
-    std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
+    Fam_Descriptor_Hot *hot = get_hot(descriptor);
+    offset += hot->keyOffset;
     uint32_t old;
-    fabric_fetch_atomic(key, (void *)&value, (void *)&old, offset, FI_BAND,
-                        FI_UINT32, (*fiAddr)[nodeId], get_context(descriptor));
+    fabric_fetch_atomic(hot->key, (void *)&value, (void *)&old, offset, FI_BAND,
+                        FI_UINT32, hot->fiAddr, (Fam_Context *)hot->context);
     return old;
 }
 
 uint64_t Fam_Ops_Libfabric::atomic_fetch_and(Fam_Descriptor *descriptor,
                                              uint64_t offset, uint64_t value) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-
-    std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
+    Fam_Descriptor_Hot *hot = get_hot(descriptor);
+    offset += hot->keyOffset;
     uint64_t old;
-    fabric_fetch_atomic(key, (void *)&value, (void *)&old, offset, FI_BAND,
-                        FI_UINT64, (*fiAddr)[nodeId], get_context(descriptor));
+    fabric_fetch_atomic(hot->key, (void *)&value, (void *)&old, offset, FI_BAND,
+                        FI_UINT64, hot->fiAddr, (Fam_Context *)hot->context);
     return old;
 }
 
 uint32_t Fam_Ops_Libfabric::atomic_fetch_or(Fam_Descriptor *descriptor,
                                             uint64_t offset, uint32_t value) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-
-    std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
+    Fam_Descriptor_Hot *hot = get_hot(descriptor);
+    offset += hot->keyOffset;
     uint32_t old;
-    fabric_fetch_atomic(key, (void *)&value, (void *)&old, offset, FI_BOR,
-                        FI_UINT32, (*fiAddr)[nodeId], get_context(descriptor));
+    fabric_fetch_atomic(hot->key, (void *)&value, (void *)&old, offset, FI_BOR,
+                        FI_UINT32, hot->fiAddr, (Fam_Context *)hot->context);
     return old;
 }
 
 uint64_t Fam_Ops_Libfabric::atomic_fetch_or(Fam_Descriptor *descriptor,
                                             uint64_t offset, uint64_t value) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-
-    std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
+    Fam_Descriptor_Hot *hot = get_hot(descriptor);
+    offset += hot->keyOffset;
     uint64_t old;
-    fabric_fetch_atomic(key, (void *)&value, (void *)&old, offset, FI_BOR,
-                        FI_UINT64, (*fiAddr)[nodeId], get_context(descriptor));
+    fabric_fetch_atomic(hot->key, (void *)&value, (void *)&old, offset, FI_BOR,
+                        FI_UINT64, hot->fiAddr, (Fam_Context *)hot->context);
     return old;
 }
 
 uint32_t Fam_Ops_Libfabric::atomic_fetch_xor(Fam_Descriptor *descriptor,
                                              uint64_t offset, uint32_t value) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-
-    std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
+    Fam_Descriptor_Hot *hot = get_hot(descriptor);
+    offset += hot->keyOffset;
     uint32_t old;
-    fabric_fetch_atomic(key, (void *)&value, (void *)&old, offset, FI_BXOR,
-                        FI_UINT32, (*fiAddr)[nodeId], get_context(descriptor));
+    fabric_fetch_atomic(hot->key, (void *)&value, (void *)&old, offset, FI_BXOR,
+                        FI_UINT32, hot->fiAddr, (Fam_Context *)hot->context);
     return old;
 }
 
 uint64_t Fam_Ops_Libfabric::atomic_fetch_xor(Fam_Descriptor *descriptor,
                                              uint64_t offset, uint64_t value) {
     std::ostringstream message;
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-
-    std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
+    Fam_Descriptor_Hot *hot = get_hot(descriptor);
+    offset += hot->keyOffset;
     uint64_t old;
-    fabric_fetch_atomic(key, (void *)&value, (void *)&old, offset, FI_BXOR,
-                        FI_UINT64, (*fiAddr)[nodeId], get_context(descriptor));
+    fabric_fetch_atomic(hot->key, (void *)&value, (void *)&old, offset, FI_BXOR,
+                        FI_UINT64, hot->fiAddr, (Fam_Context *)hot->context);
     return old;
 }
 
@@ -1609,14 +1581,12 @@ void Fam_Ops_Libfabric::abort(int status) FAM_OPS_UNIMPLEMENTED(void_);
 
 void Fam_Ops_Libfabric::atomic_set(Fam_Descriptor *descriptor, uint64_t offset,
                                    int128_t value) {
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-
-    std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
+    Fam_Descriptor_Hot *hot = get_hot(descriptor);
+    offset += hot->keyOffset;
     famAllocator->acquire_CAS_lock(descriptor);
     try {
-        fabric_write(key, &value, sizeof(int128_t), offset, (*fiAddr)[nodeId],
-                     get_context(descriptor));
+        fabric_write(hot->key, &value, sizeof(int128_t), offset, hot->fiAddr,
+                     (Fam_Context *)hot->context);
     } catch (...) {
         famAllocator->release_CAS_lock(descriptor);
         throw;
@@ -1626,15 +1596,13 @@ void Fam_Ops_Libfabric::atomic_set(Fam_Descriptor *descriptor, uint64_t offset,
 
 int128_t Fam_Ops_Libfabric::atomic_fetch_int128(Fam_Descriptor *descriptor,
                                                 uint64_t offset) {
-    uint64_t key = descriptor->get_key();
-    uint64_t nodeId = descriptor->get_memserver_id();
-
+    Fam_Descriptor_Hot *hot = get_hot(descriptor);
+    offset += hot->keyOffset;
     int128_t local;
-    std::vector<fi_addr_t> *fiAddr = get_fiAddrs();
     famAllocator->acquire_CAS_lock(descriptor);
     try {
-        fabric_read(key, &local, sizeof(int128_t), offset, (*fiAddr)[nodeId],
-                    get_context(descriptor));
+        fabric_read(hot->key, &local, sizeof(int128_t), offset, hot->fiAddr,
+                    (Fam_Context *)hot->context);
     } catch (...) {
         famAllocator->release_CAS_lock(descriptor);
         throw;
@@ -41,6 +41,7 @@
 #include "common/fam_ops.h"
 #include "common/fam_ops_nvmm.h"
 #include "common/fam_util_atomic.h"
+#include "common/fam_util_gather.h"
 #include "fam/fam.h"
 #include "fam/fam_exception.h"
 #include "nvmm/nvmm_fam_atomic.h"
@@ -48,12 +49,14 @@
 using namespace std;
 namespace openfam {
 Fam_Ops_NVMM::Fam_Ops_NVMM(Fam_Thread_Model famTM, Fam_Context_Model famCM,
-                           Fam_Allocator *famAlloc, uint64_t numConsumer) {
-    asyncQHandler = new Fam_Async_QHandler(numConsumer);
+                           Fam_Allocator *famAlloc, uint64_t numConsumer,
+                           uint64_t queueDepth, Fam_Persist_Mode persistMode) {
+    asyncQHandler = new Fam_Async_QHandler(numConsumer, queueDepth);
     famThreadModel = famTM;
     famContextModel = famCM;
+    famPersistMode = persistMode;
     famAllocator = famAlloc;
-    contexts = new std::map<uint64_t, Fam_Context *>();
+    contexts = new Fam_Context_Table();
 }
 
 Fam_Ops_NVMM::~Fam_Ops_NVMM() { finalize(); }
@@ -66,7 +69,7 @@ int Fam_Ops_NVMM::initialize() {
     // Initialize defaultCtx
     if (famContextModel == FAM_CONTEXT_DEFAULT) {
         defaultCtx = new Fam_Context(famThreadModel);
-        contexts->insert({0, defaultCtx});
+        contexts->insert(0, defaultCtx);
     }
 
     return 0;
@@ -74,9 +77,8 @@ int Fam_Ops_NVMM::initialize() {
 
 void Fam_Ops_NVMM::finalize() {
     if (contexts != NULL) {
-        for (auto fam_ctx : *contexts) {
-            delete fam_ctx.second;
-        }
+        contexts->for_each(
+            [](uint64_t regionId, Fam_Context *ctx) { delete ctx; });
         contexts->clear();
     }
 }
@@ -96,20 +98,21 @@ Fam_Context *Fam_Ops_NVMM::get_context(Fam_Descriptor *descriptor) {
         Fam_Global_Descriptor global = descriptor->get_global_descriptor();
         uint64_t regionId = global.regionId;
 
-        // ctx mutex lock
-        (void)pthread_mutex_lock(&ctxLock);
+        ctx = contexts->find(regionId);
+        if (ctx == NULL) {
+            // ctx mutex lock; only creating a context is serialized
+            (void)pthread_mutex_lock(&ctxLock);
 
-        auto ctxObj = contexts->find(regionId);
-        if (ctxObj == contexts->end()) {
-            ctx = new Fam_Context(famThreadModel);
-            contexts->insert({regionId, ctx});
-        } else {
-            ctx = ctxObj->second;
+            ctx = contexts->find(regionId);
+            if (ctx == NULL) {
+                ctx = new Fam_Context(famThreadModel);
+                contexts->insert(regionId, ctx);
+            }
+
+            // ctx mutex unlock
+            (void)pthread_mutex_unlock(&ctxLock);
         }
         descriptor->set_context(ctx);
-
-        // ctx mutex unlock
-        (void)pthread_mutex_unlock(&ctxLock);
         return ctx;
     } else {
         message << "Fam Invalid Option FAM_CONTEXT_MODEL: " << famContextModel;
@@ -141,7 +144,11 @@ int Fam_Ops_NVMM::put_blocking(void *local, Fam_Descriptor *descriptor,
     famCtx->aquire_RDLock();
 
     memcpy(dest, local, nbytes);
-    openfam_persist(dest, nbytes);
+    Fam_Persist_Log *persistLog = get_persist_log(famCtx);
+    if (persistLog)
+        persistLog->add(dest, nbytes);
+    else
+        openfam_persist(dest, nbytes);
 
     // Release Fam_Context read lock
     famCtx->release_lock();
@@ -188,9 +195,6 @@ int Fam_Ops_NVMM::gather_blocking(void *local, Fam_Descriptor *descriptor,
     uint64_t size = descriptor->get_size();
     uint64_t key = descriptor->get_key();
 
-    void *src;
-    void *dest;
-
     if (((firstElement * elementSize) > size) ||
         ((firstElement * elementSize) + elementSize * stride * nElements) >
             size) {
@@ -208,13 +212,8 @@ int Fam_Ops_NVMM::gather_blocking(void *local, Fam_Descriptor *descriptor,
     // Take Fam_Context read lock
     famCtx->aquire_RDLock();
 
-    for (uint64_t i = 0; i < nElements; i++) {
-        src = (void *)((uint64_t)base + ((firstElement * elementSize) +
-                                         elementSize * stride * i));
-        dest = (void *)((uint64_t)local + (i * elementSize));
-        openfam_invalidate(src, elementSize);
-        memcpy(dest, src, elementSize);
-    }
+    fam_gather_stride(local, base, nElements, firstElement, stride,
+                      elementSize);
 
     // Release Fam_Context read lock
     famCtx->release_lock();
@@ -229,9 +228,6 @@ int Fam_Ops_NVMM::gather_blocking(void *local, Fam_Descriptor *descriptor,
     uint64_t size = descriptor->get_size();
     uint64_t key = descriptor->get_key();
 
-    void *src;
-    void *dest;
-
     uint64_t maxOffset = elementIndex[0];
     for (uint64_t i = 0; i < nElements; i++) {
         if (maxOffset < elementIndex[i])
@@ -253,12 +249,7 @@ int Fam_Ops_NVMM::gather_blocking(void *local, Fam_Descriptor *descriptor,
     // Take Fam_Context read lock
     famCtx->aquire_RDLock();
 
-    for (uint64_t i = 0; i < nElements; i++) {
-        src = (void *)((uint64_t)base + (elementIndex[i] * elementSize));
-        dest = (void *)((uint64_t)local + (i * elementSize));
-        openfam_invalidate(src, elementSize);
-        memcpy(dest, src, elementSize);
-    }
+    fam_gather_index(local, base, nElements, elementIndex, elementSize);
 
     // Release Fam_Context read lock
     famCtx->release_lock();
@@ -273,9 +264,6 @@ int Fam_Ops_NVMM::scatter_blocking(void *local, Fam_Descriptor *descriptor,
     uint64_t size = descriptor->get_size();
     uint64_t key = descriptor->get_key();
 
-    void *src;
-    void *dest;
-
     if (((firstElement * elementSize) > size) ||
         ((firstElement * elementSize) + elementSize * stride * nElements) >
             size) {
@@ -293,13 +281,8 @@ int Fam_Ops_NVMM::scatter_blocking(void *local, Fam_Descriptor *descriptor,
     // Take Fam_Context read lock
     famCtx->aquire_RDLock();
 
-    for (uint64_t i = 0; i < nElements; i++) {
-        src = (void *)((uint64_t)local + (i * elementSize));
-        dest = (void *)((uint64_t)base + ((firstElement * elementSize) +
-                                          elementSize * stride * i));
-        memcpy(dest, src, elementSize);
-        openfam_persist(dest, elementSize);
-    }
+    fam_scatter_stride(local, base, nElements, firstElement, stride,
+                       elementSize, get_persist_log(famCtx));
 
     // Release Fam_Context read lock
     famCtx->release_lock();
@@ -314,9 +297,6 @@ int Fam_Ops_NVMM::scatter_blocking(void *local, Fam_Descriptor *descriptor,
     uint64_t size = descriptor->get_size();
     uint64_t key = descriptor->get_key();
 
-    void *src;
-    void *dest;
-
     uint64_t maxOffset = elementIndex[0];
     for (uint64_t i = 0; i < nElements; i++) {
         if (maxOffset < elementIndex[i])
@@ -338,12 +318,8 @@ int Fam_Ops_NVMM::scatter_blocking(void *local, Fam_Descriptor *descriptor,
     // Take Fam_Context read lock
     famCtx->aquire_RDLock();
 
-    for (uint64_t i = 0; i < nElements; i++) {
-        src = (void *)((uint64_t)local + (i * elementSize));
-        dest = (void *)((uint64_t)base + elementIndex[i] * elementSize);
-        memcpy(dest, src, elementSize);
-        openfam_persist(dest, elementSize);
-    }
+    fam_scatter_index(local, base, nElements, elementIndex, elementSize,
+                      get_persist_log(famCtx));
 
     // Release Fam_Context read lock
     famCtx->release_lock();
@@ -364,8 +340,18 @@ void Fam_Ops_NVMM::put_nonblocking(void *local, Fam_Descriptor *descriptor,
     famCtx->aquire_RDLock();
 
     void *dest = (void *)((uint64_t)base + offset);
-    Fam_Ops_Info opsInfo = {WRITE,      local, dest,     nbytes, offset,
-                            upperBound, key,   itemSize, NULL};
+    Fam_Ops_Info opsInfo = {WRITE,
+                            local,
+                            dest,
+                            nbytes,
+                            offset,
+                            upperBound,
+                            key,
+                            itemSize,
+                            famCtx->get_tx_completion(),
+                            get_persist_log(famCtx),
+                            NULL,
+                            NULL};
     asyncQHandler->initiate_operation(opsInfo);
     famCtx->inc_num_tx_ops();
 
@@ -389,8 +375,18 @@ void Fam_Ops_NVMM::get_nonblocking(void *local, Fam_Descriptor *descriptor,
 
     void *src = (void *)((uint64_t)base + offset);
 
-    Fam_Ops_Info opsInfo = {READ,       src, local,    nbytes, offset,
-                            upperBound, key, itemSize, NULL};
+    Fam_Ops_Info opsInfo = {READ,
+                            src,
+                            local,
+                            nbytes,
+                            offset,
+                            upperBound,
+                            key,
+                            itemSize,
+                            famCtx->get_rx_completion(),
+                            NULL,
+                            NULL,
+                            NULL};
     asyncQHandler->initiate_operation(opsInfo);
     famCtx->inc_num_rx_ops();
 
@@ -421,8 +417,18 @@ void Fam_Ops_NVMM::gather_nonblocking(void *local, Fam_Descriptor *descriptor,
         src = (void *)((uint64_t)base + ((firstElement * elementSize) +
                                          elementSize * stride * i));
         dest = (void *)((uint64_t)local + (i * elementSize));
-        Fam_Ops_Info opsInfo = {READ,       src, dest,     elementSize, offset,
-                                upperBound, key, itemSize, NULL};
+        Fam_Ops_Info opsInfo = {READ,
+                                src,
+                                dest,
+                                elementSize,
+                                offset,
+                                upperBound,
+                                key,
+                                itemSize,
+                                famCtx->get_rx_completion(),
+                                NULL,
+                                NULL,
+                                NULL};
         asyncQHandler->initiate_operation(opsInfo);
         famCtx->inc_num_rx_ops();
     }
@@ -454,9 +460,18 @@ void Fam_Ops_NVMM::gather_nonblocking(void *local, Fam_Descriptor *descriptor,
         src = (void *)((uint64_t)base + (elementIndex[i] * elementSize));
         dest = (void *)((uint64_t)local + (i * elementSize));
         upperBound = elementIndex[i] + elementSize;
-        Fam_Ops_Info opsInfo = {
-            READ,       src, dest,     elementSize, elementIndex[i],
-            upperBound, key, itemSize, NULL};
+        Fam_Ops_Info opsInfo = {READ,
+                                src,
+                                dest,
+                                elementSize,
+                                elementIndex[i],
+                                upperBound,
+                                key,
+                                itemSize,
+                                famCtx->get_rx_completion(),
+                                NULL,
+                                NULL,
+                                NULL};
         asyncQHandler->initiate_operation(opsInfo);
         famCtx->inc_num_rx_ops();
     }
@@ -489,8 +504,18 @@ void Fam_Ops_NVMM::scatter_nonblocking(void *local, Fam_Descriptor *descriptor,
         src = (void *)((uint64_t)local + (i * elementSize));
         dest = (void *)((uint64_t)base + ((firstElement * elementSize) +
                                           elementSize * stride * i));
-        Fam_Ops_Info opsInfo = {WRITE,      src, dest,     elementSize, offset,
-                                upperBound, key, itemSize, NULL};
+        Fam_Ops_Info opsInfo = {WRITE,
+                                src,
+                                dest,
+                                elementSize,
+                                offset,
+                                upperBound,
+                                key,
+                                itemSize,
+                                famCtx->get_tx_completion(),
+                                get_persist_log(famCtx),
+                                NULL,
+                                NULL};
         asyncQHandler->initiate_operation(opsInfo);
         famCtx->inc_num_tx_ops();
     }
@@ -520,9 +545,18 @@ void Fam_Ops_NVMM::scatter_nonblocking(void *local, Fam_Descriptor *descriptor,
         src = (void *)((uint64_t)local + (i * elementSize));
         dest = (void *)((uint64_t)base + elementIndex[i] * elementSize);
         upperBound = elementIndex[i] + elementSize;
-        Fam_Ops_Info opsInfo = {
-            WRITE,      src, dest,     elementSize, elementIndex[i],
-            upperBound, key, itemSize, NULL};
+        Fam_Ops_Info opsInfo = {WRITE,
+                                src,
+                                dest,
+                                elementSize,
+                                elementIndex[i],
+                                upperBound,
+                                key,
+                                itemSize,
+                                famCtx->get_tx_completion(),
+                                get_persist_log(famCtx),
+                                NULL,
+                                NULL};
         asyncQHandler->initiate_operation(opsInfo);
         famCtx->inc_num_tx_ops();
     }
@@ -539,6 +573,8 @@ void Fam_Ops_NVMM::quiet_context(Fam_Context *famCtx) {
     famCtx->aquire_WRLock();
 
     asyncQHandler->quiet(famCtx);
+    if (famPersistMode == FAM_PERSIST_DEFERRED)
+        famCtx->get_persist_log()->persist();
 
     // Release Fam_Context write lock
     famCtx->release_lock();
@@ -546,45 +582,47 @@ void Fam_Ops_NVMM::quiet_context(Fam_Context *famCtx) {
     return;
 }
 
+/*
+ * Context of the region of the descriptor, or NULL if no operation on the
+ * region created one yet
+ */
+Fam_Context *Fam_Ops_NVMM::find_context(Fam_Region_Descriptor *descriptor) {
+    Fam_Context *ctx = (Fam_Context *)descriptor->get_context();
+    if (ctx == NULL) {
+        Fam_Global_Descriptor global = descriptor->get_global_descriptor();
+        ctx = contexts->find(global.regionId);
+        if (ctx)
+            descriptor->set_context(ctx);
+    }
+    return ctx;
+}
+
 void Fam_Ops_NVMM::quiet(Fam_Region_Descriptor *descriptor) {
 
     if (famContextModel == FAM_CONTEXT_DEFAULT) {
         quiet_context(get_defaultCtx());
         return;
     } else if (famContextModel == FAM_CONTEXT_REGION) {
-        // ctx mutex lock
-        (void)pthread_mutex_lock(&ctxLock);
-        try {
-            if (descriptor) {
-                Fam_Context *ctx = (Fam_Context *)descriptor->get_context();
-                if (ctx) {
-                    quiet_context(ctx);
-                } else {
-                    Fam_Global_Descriptor global =
-                        descriptor->get_global_descriptor();
-                    uint64_t regionId = global.regionId;
-                    auto ctxObj = contexts->find(regionId);
-                    if (ctxObj != contexts->end()) {
-                        descriptor->set_context(ctxObj->second);
-                        quiet_context(ctxObj->second);
-                    }
-                }
-            } else {
-                for (auto fam_ctx : *contexts)
-                    quiet_context(fam_ctx.second);
-            }
-        } catch (...) {
-            // ctx mutex unlock
-            (void)pthread_mutex_unlock(&ctxLock);
-            throw;
+        if (descriptor) {
+            Fam_Context *ctx = find_context(descriptor);
+            if (ctx)
+                quiet_context(ctx);
+        } else {
+            contexts->for_each([&](uint64_t regionId, Fam_Context *ctx) {
+                quiet_context(ctx);
+            });
         }
-        // ctx mutex unlock
-        (void)pthread_mutex_unlock(&ctxLock);
     }
 }
 
 void Fam_Ops_NVMM::abort(int status) FAM_OPS_UNIMPLEMENTED(void_);
 
+/*
+ * Data items are accessed through the local address the allocator binds
+ * with the key, so there is nothing more to resolve ahead of the datapath
+ */
+void Fam_Ops_NVMM::bind_descriptor(Fam_Descriptor *descriptor) {}
+
 void *Fam_Ops_NVMM::copy(Fam_Descriptor *src, uint64_t srcOffset,
                          Fam_Descriptor **dest, uint64_t destOffset,
                          uint64_t nbytes) {
@@ -611,10 +649,10 @@ void *Fam_Ops_NVMM::copy(Fam_Descriptor *src, uint64_t srcOffset,
 
     void *baseDest = (*dest)->get_base_address();
     Copy_Tag *tag = new Copy_Tag();
-    tag->copyDone.store(false, boost::memory_order_seq_cst);
 
     Fam_Ops_Info opsInfo = {COPY, baseSrc, baseDest,      nbytes, 0,
-                            0,    0,       itemInfo.size, tag};
+                            0,    0,       itemInfo.size, NULL,   NULL,
+                            tag,  NULL};
     asyncQHandler->initiate_operation(opsInfo);
 
     return (void *)tag;
@@ -0,0 +1,215 @@
+/*
+ * fam_stats.cpp
+ * Copyright (c) 2019 Hewlett Packard Enterprise Development, LP. All rights
+ * reserved. Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ *    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * See https://spdx.org/licenses/BSD-3-Clause
+ *
+ */
+#include <math.h>
+#include <sstream>
+#include <stdlib.h>
+#include <string.h>
+
+#include "fam_stats.h"
+
+namespace openfam {
+
+static const char *apiNames[] = {
+#undef FAM_COUNTER
+#define FAM_COUNTER(name) #name,
+#include "fam_counters.tbl"
+};
+
+static const uint64_t sizeClassBound[FAM_STATS_SIZE_CLASSES] = {
+    0, 64, 512, 4096, 32768, 262144, 2097152, FAM_STATS_NO_SIZE_LIMIT};
+
+Fam_Stats_Histogram::Fam_Stats_Histogram() {
+    for (uint64_t i = 0; i < FAM_STATS_BUCKETS; i++)
+        buckets[i].store(0, std::memory_order_relaxed);
+    count.store(0, std::memory_order_relaxed);
+    total.store(0, std::memory_order_relaxed);
+    max.store(0, std::memory_order_relaxed);
+}
+
+Fam_Stats::Fam_Stats(uint64_t numMemservers) {
+    numServers = numMemservers;
+    numSlots = fam_counter_max * (numServers + 1) * FAM_STATS_SIZE_CLASSES;
+}
+
+Fam_Stats::~Fam_Stats() {
+    for (auto block : threadBlocks.get_blocks()) {
+        for (uint64_t i = 0; i < numSlots; i++)
+            delete block->histograms[i].load(std::memory_order_relaxed);
+        delete[] block->histograms;
+        delete block;
+    }
+}
+
+uint64_t Fam_Stats::size_class(uint64_t nbytes) {
+    uint64_t sizeClass = 0;
+    while (nbytes > sizeClassBound[sizeClass])
+        sizeClass++;
+    return sizeClass;
+}
+
+Fam_Stats::Thread_Block *Fam_Stats::get_thread_block() {
+    uint64_t slots = numSlots;
+    return threadBlocks.get([slots]() {
+        Thread_Block *block = new Thread_Block();
+        block->histograms = new std::atomic<Fam_Stats_Histogram *>[slots];
+        for (uint64_t i = 0; i < slots; i++)
+            block->histograms[i].store(NULL, std::memory_order_relaxed);
+        return block;
+    });
+}
+
+void Fam_Stats::record(Fam_Counter_Enum_T api, uint64_t memserverId,
+                       uint64_t nbytes, uint64_t latency) {
+    Thread_Block *block = get_thread_block();
+    uint64_t server = (memserverId < numServers) ? memserverId : numServers;
+    std::atomic<Fam_Stats_Histogram *> &entry =
+        block->histograms[slot(api, server, size_class(nbytes))];
+
+    Fam_Stats_Histogram *histogram = entry.load(std::memory_order_relaxed);
+    if (histogram == NULL) {
+        // Published with release so that snapshots see it zeroed
+        histogram = new Fam_Stats_Histogram();
+        entry.store(histogram, std::memory_order_release);
+    }
+    histogram->record(latency);
+}
+
+/*
+ * Value below which the given fraction of the recorded samples falls
+ */
+static uint64_t percentile(uint64_t *buckets, uint64_t count, uint64_t max,
+                           double fraction) {
+    uint64_t rank = (uint64_t)ceil(fraction * (double)count);
+    if (rank < 1)
+        rank = 1;
+    uint64_t seen = 0;
+    for (uint64_t i = 0; i < FAM_STATS_BUCKETS; i++) {
+        seen += buckets[i];
+        if (seen >= rank) {
+            uint64_t bound = Fam_Stats_Histogram::bucket_upper_bound(i);
+            return (bound < max) ? bound : max;
+        }
+    }
+    return max;
+}
+
+Fam_Stats_Snapshot *Fam_Stats::snapshot() {
+    std::vector<Fam_Stats_Entry> entries;
+    uint64_t *buckets = new uint64_t[FAM_STATS_BUCKETS];
+
+    threadBlocks.lock();
+    for (uint64_t api = 0; api < fam_counter_max; api++) {
+        for (uint64_t server = 0; server <= numServers; server++) {
+            for (uint64_t sizeClass = 0; sizeClass < FAM_STATS_SIZE_CLASSES;
+                 sizeClass++) {
+                uint64_t idx = slot(api, server, sizeClass);
+                Fam_Stats_Entry entry;
+                memset(&entry, 0, sizeof(entry));
+                memset(buckets, 0, FAM_STATS_BUCKETS * sizeof(uint64_t));
+                for (auto block : threadBlocks.get_blocks()) {
+                    Fam_Stats_Histogram *histogram =
+                        block->histograms[idx].load(std::memory_order_acquire);
+                    if (histogram == NULL)
+                        continue;
+                    for (uint64_t i = 0; i < FAM_STATS_BUCKETS; i++)
+                        buckets[i] += histogram->buckets[i].load(
+                            std::memory_order_relaxed);
+                    entry.count +=
+                        histogram->count.load(std::memory_order_relaxed);
+                    entry.total +=
+                        histogram->total.load(std::memory_order_relaxed);
+                    uint64_t max =
+                        histogram->max.load(std::memory_order_relaxed);
+                    if (max > entry.max)
+                        entry.max = max;
+                }
+                if (entry.count == 0)
+                    continue;
+                entry.api = apiNames[api];
+                entry.memoryServerId =
+                    (server < numServers) ? server : FAM_STATS_NO_MEMSERVER;
+                entry.maxBytes = sizeClassBound[sizeClass];
+                entry.p50 = percentile(buckets, entry.count, entry.max, 0.5);
+                entry.p99 = percentile(buckets, entry.count, entry.max, 0.99);
+                entry.p999 =
+                    percentile(buckets, entry.count, entry.max, 0.999);
+                entries.push_back(entry);
+            }
+        }
+    }
+    threadBlocks.unlock();
+    delete[] buckets;
+
+    Fam_Stats_Snapshot *snap = new Fam_Stats_Snapshot();
+    snap->numEntries = entries.size();
+    snap->entries = NULL;
+    if (snap->numEntries) {
+        snap->entries = new Fam_Stats_Entry[snap->numEntries];
+        memcpy(snap->entries, entries.data(),
+               snap->numEntries * sizeof(Fam_Stats_Entry));
+    }
+    return snap;
+}
+
+void Fam_Stats::free_snapshot(Fam_Stats_Snapshot *snapshot) {
+    if (snapshot == NULL)
+        return;
+    delete[] snapshot->entries;
+    delete snapshot;
+}
+
+char *Fam_Stats::to_json(Fam_Stats_Snapshot *snapshot) {
+    std::ostringstream json;
+    json << "{\"stats\":[";
+    for (uint64_t i = 0; snapshot && i < snapshot->numEntries; i++) {
+        Fam_Stats_Entry *entry = &snapshot->entries[i];
+        if (i)
+            json << ",";
+        json << "{\"api\":\"" << entry->api << "\",\"memory_server\":";
+        if (entry->memoryServerId == FAM_STATS_NO_MEMSERVER)
+            json << "null";
+        else
+            json << entry->memoryServerId;
+        json << ",\"max_bytes\":";
+        if (entry->maxBytes == FAM_STATS_NO_SIZE_LIMIT)
+            json << "null";
+        else
+            json << entry->maxBytes;
+        json << ",\"count\":" << entry->count
+             << ",\"total_ns\":" << entry->total
+             << ",\"p50_ns\":" << entry->p50 << ",\"p99_ns\":" << entry->p99
+             << ",\"p999_ns\":" << entry->p999 << ",\"max_ns\":" << entry->max
+             << "}";
+    }
+    json << "]}";
+    return strdup(json.str().c_str());
+}
+
+} // namespace openfam
@@ -0,0 +1,216 @@
+/*
+ * fam_stats.h
+ * Copyright (c) 2019 Hewlett Packard Enterprise Development, LP. All rights
+ * reserved. Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ *    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * See https://spdx.org/licenses/BSD-3-Clause
+ *
+ */
+#ifndef FAM_STATS_H_
+#define FAM_STATS_H_
+
+#include <atomic>
+#include <pthread.h>
+#include <stdint.h>
+#include <time.h>
+#include <vector>
+
+#include "common/fam_thread_blocks.h"
+#include "fam/fam.h"
+#include "fam_counters.h"
+
+/*
+ * Values below 2^FAM_STATS_SUB_BUCKET_BITS get a bucket each; above that,
+ * every power of two is split into 2^FAM_STATS_SUB_BUCKET_BITS linear
+ * sub-buckets, which bounds the error of a percentile to about 6%
+ */
+#define FAM_STATS_SUB_BUCKET_BITS 4
+#define FAM_STATS_SUB_BUCKETS (1ULL << FAM_STATS_SUB_BUCKET_BITS)
+
+/*
+ * Latencies of 2^FAM_STATS_MAX_VALUE_BITS ns (about 18 minutes) or more all
+ * land in the last bucket
+ */
+#define FAM_STATS_MAX_VALUE_BITS 40
+#define FAM_STATS_BUCKETS                                                      \
+    ((FAM_STATS_MAX_VALUE_BITS - FAM_STATS_SUB_BUCKET_BITS + 1) *              \
+     FAM_STATS_SUB_BUCKETS)
+
+/*
+ * Transfer size classes: no data, then up to 64B, 512B, 4KiB, 32KiB,
+ * 256KiB, 2MiB and larger
+ */
+#define FAM_STATS_SIZE_CLASSES 8
+
+namespace openfam {
+
+/*
+ * Log-linear latency histogram. Each histogram is updated only by the
+ * thread that owns it, so counters are bumped with plain relaxed loads and
+ * stores and never need a locked instruction; snapshots read them
+ * concurrently and may miss the samples being recorded at that moment.
+ */
+struct Fam_Stats_Histogram {
+    Fam_Stats_Histogram();
+
+    void record(uint64_t value) {
+        bump(buckets[bucket_index(value)], 1);
+        bump(count, 1);
+        bump(total, value);
+        if (value > max.load(std::memory_order_relaxed))
+            max.store(value, std::memory_order_relaxed);
+    }
+
+    static uint64_t bucket_index(uint64_t value) {
+        if (value < FAM_STATS_SUB_BUCKETS)
+            return value;
+        uint64_t exponent = 63 - __builtin_clzll(value);
+        if (exponent >= FAM_STATS_MAX_VALUE_BITS)
+            return FAM_STATS_BUCKETS - 1;
+        uint64_t shift = exponent - FAM_STATS_SUB_BUCKET_BITS;
+        return ((shift + 1) << FAM_STATS_SUB_BUCKET_BITS) +
+               ((value >> shift) & (FAM_STATS_SUB_BUCKETS - 1));
+    }
+
+    /* Largest value counted in the bucket */
+    static uint64_t bucket_upper_bound(uint64_t index) {
+        if (index < FAM_STATS_SUB_BUCKETS)
+            return index;
+        uint64_t shift = (index >> FAM_STATS_SUB_BUCKET_BITS) - 1;
+        uint64_t lower = (FAM_STATS_SUB_BUCKETS +
+                          (index & (FAM_STATS_SUB_BUCKETS - 1)))
+                         << shift;
+        return lower + (1ULL << shift) - 1;
+    }
+
+    std::atomic<uint64_t> buckets[FAM_STATS_BUCKETS];
+    std::atomic<uint64_t> count;
+    std::atomic<uint64_t> total;
+    std::atomic<uint64_t> max;
+
+  private:
+    static void bump(std::atomic<uint64_t> &counter, uint64_t value) {
+        counter.store(counter.load(std::memory_order_relaxed) + value,
+                      std::memory_order_relaxed);
+    }
+};
+
+/*
+ * Runtime latency statistics of the OpenFAM API, enabled with the
+ * FAM_STATS option. Every API in fam_counters.tbl keeps one histogram per
+ * memory server and transfer size class, in a block private to the calling
+ * thread; snapshots merge the blocks of all threads.
+ */
+class Fam_Stats {
+  public:
+    Fam_Stats(uint64_t numMemservers);
+
+    ~Fam_Stats();
+
+    static uint64_t get_time() {
+        struct timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        return (uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec;
+    }
+
+    static uint64_t size_class(uint64_t nbytes);
+
+    void record(Fam_Counter_Enum_T api, uint64_t memserverId, uint64_t nbytes,
+                uint64_t latency);
+
+    Fam_Stats_Snapshot *snapshot();
+
+    static void free_snapshot(Fam_Stats_Snapshot *snapshot);
+
+    static char *to_json(Fam_Stats_Snapshot *snapshot);
+
+  private:
+    struct Thread_Block {
+        std::atomic<Fam_Stats_Histogram *> *histograms;
+    };
+
+    Thread_Block *get_thread_block();
+
+    uint64_t slot(uint64_t api, uint64_t server, uint64_t sizeClass) {
+        return (api * (numServers + 1) + server) * FAM_STATS_SIZE_CLASSES +
+               sizeClass;
+    }
+
+    uint64_t numServers;
+    uint64_t numSlots;
+    Fam_Thread_Blocks<Thread_Block> threadBlocks;
+};
+
+/*
+ * Times the enclosing API call and records it when the scope ends, on
+ * return or on exception; does nothing when stats are disabled
+ */
+class Fam_Stats_Scope {
+  public:
+    Fam_Stats_Scope(Fam_Stats *stats, Fam_Counter_Enum_T api,
+                    uint64_t nbytes = 0)
+        : famStats(stats), apiIdx(api), memserverId(FAM_STATS_NO_MEMSERVER),
+          size(nbytes), start(0) {
+        if (famStats)
+            start = Fam_Stats::get_time();
+    }
+
+    Fam_Stats_Scope(Fam_Stats *stats, Fam_Counter_Enum_T api,
+                    Fam_Descriptor *descriptor, uint64_t nbytes = 0)
+        : famStats(stats), apiIdx(api), memserverId(FAM_STATS_NO_MEMSERVER),
+          size(nbytes), start(0) {
+        if (famStats) {
+            if (descriptor)
+                memserverId = descriptor->get_memserver_id();
+            start = Fam_Stats::get_time();
+        }
+    }
+
+    Fam_Stats_Scope(Fam_Stats *stats, Fam_Counter_Enum_T api,
+                    Fam_Region_Descriptor *descriptor, uint64_t nbytes = 0)
+        : famStats(stats), apiIdx(api), memserverId(FAM_STATS_NO_MEMSERVER),
+          size(nbytes), start(0) {
+        if (famStats) {
+            if (descriptor)
+                memserverId = descriptor->get_memserver_id();
+            start = Fam_Stats::get_time();
+        }
+    }
+
+    ~Fam_Stats_Scope() {
+        if (famStats)
+            famStats->record(apiIdx, memserverId, size,
+                             Fam_Stats::get_time() - start);
+    }
+
+  private:
+    Fam_Stats *famStats;
+    Fam_Counter_Enum_T apiIdx;
+    uint64_t memserverId;
+    uint64_t size;
+    uint64_t start;
+};
+
+} // namespace openfam
+#endif // FAM_STATS_H_
@@ -54,6 +54,7 @@ int main(int argc, char *argv[]) {
     char *name = strdup("127.0.0.1");
     char *libfabricPort = strdup("7500");
     char *provider = strdup("sockets");
+    uint64_t recoveryThreads = 8;
 
     for (int i = 1; i < argc; i++) {
         if ((std::string(argv[i]) == "-h") ||
@@ -73,6 +74,9 @@ int main(int argc, char *argv[]) {
                  << "\t-p/--provider       : Libfabric provider (default value "
                     "is \"sockets\") \n"
                  << "\n"
+                 << "\t-t/--recoverythreads : Number of threads opening the "
+                    "existing regions at startup (default value is 8) \n"
+                 << "\n"
                  << endl;
             exit(0);
         } else if ((std::string(argv[i]) == "-m") ||
@@ -87,6 +91,9 @@ int main(int argc, char *argv[]) {
         } else if ((std::string(argv[i]) == "-p") ||
                    (std::string(argv[i]) == "--provider")) {
             provider = strdup(argv[++i]);
+        } else if ((std::string(argv[i]) == "-t") ||
+                   (std::string(argv[i]) == "--recoverythreads")) {
+            recoveryThreads = atoi(argv[++i]);
         }
     }
 
@@ -98,7 +105,8 @@ int main(int argc, char *argv[]) {
 
     Fam_Rpc_Server *rpcService = NULL;
     try {
-        rpcService = new Fam_Rpc_Server(rpcPort, name, libfabricPort, provider);
+        rpcService = new Fam_Rpc_Server(rpcPort, name, libfabricPort, provider,
+                                        recoveryThreads);
         rpcService->run();
     } catch (Memserver_Exception &e) {
         if (rpcService) {
@@ -53,6 +53,9 @@ KeyValueStore::IndexType const KVSTYPE = KeyValueStore::RADIX_TREE;
 
 size_t const max_val_len = 4096;
 
+// Prefix of the region Id KVS keys holding the slab directory of a region
+#define SLAB_DIR_KEY_PREFIX "slabdir."
+
 inline void ResetBuf(char *buf, size_t &len, size_t const max_len) {
     memset(buf, 0, max_len);
     len = max_len;
@@ -91,6 +94,14 @@ class FAM_Metadata_Manager::Impl_ {
     int metadata_modify_region(const std::string regionName,
                                Fam_Region_Metadata *region);
 
+    int metadata_insert_slab_directory(const uint64_t regionId,
+                                       const uint64_t dirOffset);
+
+    int metadata_delete_slab_directory(const uint64_t regionId);
+
+    int metadata_find_slab_directory(const uint64_t regionId,
+                                     uint64_t &dirOffset);
+
     int metadata_insert_dataitem(const uint64_t dataitemId,
                                  const uint64_t regionId,
                                  Fam_DataItem_Metadata *dataitem,
@@ -811,6 +822,89 @@ FAM_Metadata_Manager::Impl_::metadata_delete_region(const uint64_t regionId) {
     return ret;
 }
 
+/**
+ * metadata_insert_slab_directory - Record the offset of the slab directory
+ * 	of a region. The offset is kept under its own key in the region Id KVS,
+ * 	so that the layout of the region descriptor is not changed.
+ * @param regionId - Region ID
+ * @param dirOffset - Offset of the slab directory in the region heap
+ * @return - META_NO_ERROR if key added successfully, META_KEY_ALREADY_EXIST if
+ * 	key already exists
+ */
+int FAM_Metadata_Manager::Impl_::metadata_insert_slab_directory(
+    const uint64_t regionId, const uint64_t dirOffset) {
+
+    int ret;
+    std::string slabKey = SLAB_DIR_KEY_PREFIX + std::to_string(regionId);
+    char val_buf[max_val_len];
+    size_t val_len;
+
+    ResetBuf(val_buf, val_len, max_val_len);
+
+    ret = regionIdKVS->FindOrCreate(slabKey.c_str(), slabKey.size(),
+                                    (char const *)&dirOffset, sizeof(uint64_t),
+                                    val_buf, val_len);
+    if (ret == META_NO_ERROR) {
+        return ret;
+    } else if (ret == META_KEY_ALREADY_EXIST) {
+        return META_KEY_ALREADY_EXIST;
+    } else {
+        DEBUG_STDERR(regionId, "FindOrCreate failed.");
+        return META_ERROR;
+    }
+}
+
+/**
+ * metadata_delete_slab_directory - delete the slab directory key of a region
+ * @param regionId - Region ID
+ * @return - META_NO_ERROR if the key is deleted successfully,
+ * META_KEY_DOES_NOT_EXIST if key not found.
+ */
+int FAM_Metadata_Manager::Impl_::metadata_delete_slab_directory(
+    const uint64_t regionId) {
+
+    int ret;
+    std::string slabKey = SLAB_DIR_KEY_PREFIX + std::to_string(regionId);
+
+    ret = regionIdKVS->Del(slabKey.c_str(), slabKey.size());
+    if ((ret == META_NO_ERROR) || (ret == META_KEY_DOES_NOT_EXIST)) {
+        return ret;
+    } else {
+        DEBUG_STDERR(regionId, "Del failed.");
+        return META_ERROR;
+    }
+}
+
+/**
+ * metadata_find_slab_directory - Lookup the slab directory of a region.
+ * 	Regions created without a slab directory have no such key.
+ * @param regionId - Region ID
+ * @param dirOffset - return the offset of the slab directory if it exists
+ * @return - META_NO_ERROR if key exists, META_KEY_DOES_NOT_EXIST if key not
+ *	found
+ */
+int FAM_Metadata_Manager::Impl_::metadata_find_slab_directory(
+    const uint64_t regionId, uint64_t &dirOffset) {
+
+    int ret;
+    std::string slabKey = SLAB_DIR_KEY_PREFIX + std::to_string(regionId);
+    char val_buf[max_val_len];
+    size_t val_len;
+
+    ResetBuf(val_buf, val_len, max_val_len);
+
+    ret = regionIdKVS->Get(slabKey.c_str(), slabKey.size(), val_buf, val_len);
+    if (ret == META_NO_ERROR) {
+        memcpy((char *)&dirOffset, val_buf, sizeof(uint64_t));
+        return META_NO_ERROR;
+    } else if (ret == META_KEY_DOES_NOT_EXIST) {
+        return ret;
+    } else {
+        DEBUG_STDERR(regionId, ret);
+        return META_ERROR;
+    }
+}
+
 /**
  * metadata_insert_dataitem - Insert the dataitem id in the dataitem KVS
  * @param dataitemId- dataitem Id to be inserted
@@ -1934,6 +2028,24 @@ int FAM_Metadata_Manager::metadata_modify_region(const std::string regionName,
     return pimpl_->metadata_modify_region(regionName, region);
 }
 
+int FAM_Metadata_Manager::metadata_insert_slab_directory(
+    const uint64_t regionId, const uint64_t dirOffset) {
+
+    return pimpl_->metadata_insert_slab_directory(regionId, dirOffset);
+}
+
+int FAM_Metadata_Manager::metadata_delete_slab_directory(
+    const uint64_t regionId) {
+
+    return pimpl_->metadata_delete_slab_directory(regionId);
+}
+
+int FAM_Metadata_Manager::metadata_find_slab_directory(const uint64_t regionId,
+                                                       uint64_t &dirOffset) {
+
+    return pimpl_->metadata_find_slab_directory(regionId, dirOffset);
+}
+
 int FAM_Metadata_Manager::metadata_insert_dataitem(
     const uint64_t dataitemId, const std::string regionName,
     Fam_DataItem_Metadata *dataitem, std::string dataitemName) {
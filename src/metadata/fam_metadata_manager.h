@@ -160,6 +160,12 @@ class FAM_Metadata_Manager {
     int metadata_modify_region(const std::string regionName,
                                Fam_Region_Metadata *region);
 
+    int metadata_insert_slab_directory(const uint64_t regionId,
+                                       const uint64_t dirOffset);
+    int metadata_delete_slab_directory(const uint64_t regionId);
+    int metadata_find_slab_directory(const uint64_t regionId,
+                                     uint64_t &dirOffset);
+
     int metadata_insert_dataitem(const uint64_t dataitemId,
                                  const uint64_t regionId,
                                  Fam_DataItem_Metadata *dataitem,
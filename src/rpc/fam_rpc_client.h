@@ -39,6 +39,7 @@
 #include <sys/types.h>
 #include <unistd.h>
 
+#include "common/fam_async_handle.h"
 #include "fam/fam.h"
 #include "fam/fam_exception.h"
 #include "rpc/fam_rpc.grpc.pb.h"
@@ -75,6 +76,41 @@ typedef struct {
         responseReader;
 } Fam_Copy_Tag;
 
+/**
+ * Data item operations that can be issued asynchronously
+ */
+typedef enum {
+    FAM_DATAITEM_ALLOCATE,
+    FAM_DATAITEM_LOOKUP,
+    FAM_DATAITEM_DEALLOCATE
+} Fam_Dataitem_Op;
+
+/**
+ * structure for keeping state and data information of an asynchronous
+ * allocate, lookup or deallocate
+ */
+typedef struct {
+    // Container for the data we expect from the server.
+    Fam_Dataitem_Response res;
+
+    ::grpc::ClientContext ctx;
+
+    ::grpc::Status status;
+
+    Fam_Dataitem_Op op;
+
+    uint64_t memServerId;
+
+    // Size of the data item being allocated
+    uint64_t nbytes;
+
+    // Completed with the outcome of the operation
+    Fam_Async_Handle *handle;
+
+    std::unique_ptr<::grpc::ClientAsyncResponseReader<Fam_Dataitem_Response>>
+        responseReader;
+} Fam_Dataitem_Tag;
+
 class Fam_Rpc_Client {
   public:
     Fam_Rpc_Client(const char *name, uint64_t port) {
@@ -123,6 +159,7 @@ class Fam_Rpc_Client {
             memcpy(((uint32_t *)memServerFabricAddr + readCount), &lastBytes,
                    lastBytesCount);
         }
+        memServerHostId = res.hostid();
     }
 
     ~Fam_Rpc_Client() {
@@ -262,17 +299,7 @@ class Fam_Rpc_Client {
         Fam_Dataitem_Response res;
         ::grpc::ClientContext ctx;
 
-        Fam_Global_Descriptor globalDescriptor =
-            region->get_global_descriptor();
-        req.set_name(name);
-        req.set_regionid(globalDescriptor.regionId & REGIONID_MASK);
-        req.set_size(nbytes);
-        req.set_perm(permission);
-        req.set_uid(uid);
-        req.set_gid(gid);
-        req.set_dup(false);
-        uint64_t nodeId = region->get_memserver_id();
-
+        allocate_request(&req, name, nbytes, permission, region);
         ::grpc::Status status = stub->allocate(&ctx, req, &res);
 
         if (status.ok()) {
@@ -280,13 +307,8 @@ class Fam_Rpc_Client {
                 throw Fam_Allocator_Exception((enum Fam_Error)res.errorcode(),
                                               (res.errormsg()).c_str());
             } else {
-                globalDescriptor.regionId =
-                    res.regionid() | (nodeId << MEMSERVERID_SHIFT);
-                globalDescriptor.offset = res.offset();
-                Fam_Descriptor *dataItem =
-                    new Fam_Descriptor(globalDescriptor, nbytes);
-                dataItem->bind_key(res.key());
-                return dataItem;
+                return allocated_dataitem(res, region->get_memserver_id(),
+                                          nbytes);
             }
         } else {
             throw Fam_Allocator_Exception(FAM_ERR_GRPC,
@@ -305,14 +327,7 @@ class Fam_Rpc_Client {
         Fam_Dataitem_Response res;
         ::grpc::ClientContext ctx;
 
-        Fam_Global_Descriptor globalDescriptor =
-            dataitem->get_global_descriptor();
-        req.set_regionid(globalDescriptor.regionId & REGIONID_MASK);
-        req.set_offset(globalDescriptor.offset);
-        req.set_uid(uid);
-        req.set_gid(gid);
-        req.set_key(dataitem->get_key());
-
+        deallocate_request(&req, dataitem);
         ::grpc::Status status = stub->deallocate(&ctx, req, &res);
 
         if (status.ok()) {
@@ -433,11 +448,7 @@ class Fam_Rpc_Client {
         Fam_Dataitem_Response res;
         ::grpc::ClientContext ctx;
 
-        req.set_name(itemName);
-        req.set_regionname(regionName);
-        req.set_uid(uid);
-        req.set_gid(gid);
-
+        lookup_request(&req, itemName, regionName);
         ::grpc::Status status = stub->lookup(&ctx, req, &res);
 
         if (status.ok()) {
@@ -445,14 +456,7 @@ class Fam_Rpc_Client {
                 throw Fam_Allocator_Exception((enum Fam_Error)res.errorcode(),
                                               (res.errormsg()).c_str());
             } else {
-                Fam_Global_Descriptor globalDescriptor;
-                globalDescriptor.regionId =
-                    res.regionid() | (memoryServerId << MEMSERVERID_SHIFT);
-                globalDescriptor.offset = res.offset();
-                Fam_Descriptor *dataItem =
-                    new Fam_Descriptor(globalDescriptor, res.size());
-                dataItem->bind_key(FAM_KEY_UNINITIALIZED);
-                return dataItem;
+                return looked_up_dataitem(res, memoryServerId);
             }
         } else {
             throw Fam_Allocator_Exception(FAM_ERR_GRPC,
@@ -460,6 +464,103 @@ class Fam_Rpc_Client {
         }
     }
 
+    /**
+     * Starts an allocate, lookup or deallocate without waiting for the
+     * server. Its reply is delivered to the completion queue cq, whose
+     * thread passes it to complete_dataitem(), which completes the handle.
+     * @see allocate(), lookup(), deallocate()
+     **/
+    void allocate_async(const char *name, size_t nbytes, mode_t permission,
+                        Fam_Region_Descriptor *region,
+                        ::grpc::CompletionQueue *cq,
+                        Fam_Async_Handle *handle) {
+        Fam_Dataitem_Request req;
+        allocate_request(&req, name, nbytes, permission, region);
+
+        Fam_Dataitem_Tag *tag = new Fam_Dataitem_Tag();
+        tag->op = FAM_DATAITEM_ALLOCATE;
+        tag->memServerId = region->get_memserver_id();
+        tag->nbytes = nbytes;
+        tag->handle = handle;
+        tag->responseReader = stub->PrepareAsyncallocate(&tag->ctx, req, cq);
+        tag->responseReader->StartCall();
+        tag->responseReader->Finish(&tag->res, &tag->status, (void *)tag);
+    }
+
+    void lookup_async(const char *itemName, const char *regionName,
+                      uint64_t memoryServerId, ::grpc::CompletionQueue *cq,
+                      Fam_Async_Handle *handle) {
+        Fam_Dataitem_Request req;
+        lookup_request(&req, itemName, regionName);
+
+        Fam_Dataitem_Tag *tag = new Fam_Dataitem_Tag();
+        tag->op = FAM_DATAITEM_LOOKUP;
+        tag->memServerId = memoryServerId;
+        tag->nbytes = 0;
+        tag->handle = handle;
+        tag->responseReader = stub->PrepareAsynclookup(&tag->ctx, req, cq);
+        tag->responseReader->StartCall();
+        tag->responseReader->Finish(&tag->res, &tag->status, (void *)tag);
+    }
+
+    void deallocate_async(Fam_Descriptor *dataitem,
+                          ::grpc::CompletionQueue *cq,
+                          Fam_Async_Handle *handle) {
+        Fam_Dataitem_Request req;
+        deallocate_request(&req, dataitem);
+
+        Fam_Dataitem_Tag *tag = new Fam_Dataitem_Tag();
+        tag->op = FAM_DATAITEM_DEALLOCATE;
+        tag->memServerId = dataitem->get_memserver_id();
+        tag->nbytes = 0;
+        tag->handle = handle;
+        tag->responseReader =
+            stub->PrepareAsyncdeallocate(&tag->ctx, req, cq);
+        tag->responseReader->StartCall();
+        tag->responseReader->Finish(&tag->res, &tag->status, (void *)tag);
+    }
+
+    /**
+     * Completes the handle of an operation started by allocate_async(),
+     * lookup_async() or deallocate_async() with its reply
+     * @param waitObj - tag returned by the completion queue
+     * @param ok - whether the completion queue delivered the reply
+     **/
+    static void complete_dataitem(void *waitObj, bool ok) {
+        Fam_Dataitem_Tag *tag = static_cast<Fam_Dataitem_Tag *>(waitObj);
+        try {
+            if (!ok) {
+                throw Fam_Allocator_Exception(FAM_ERR_GRPC,
+                                              "RPC did not complete");
+            }
+            if (!tag->status.ok()) {
+                throw Fam_Allocator_Exception(
+                    FAM_ERR_GRPC, (tag->status.error_message()).c_str());
+            }
+            if (tag->res.errorcode()) {
+                throw Fam_Allocator_Exception(
+                    (enum Fam_Error)tag->res.errorcode(),
+                    (tag->res.errormsg()).c_str());
+            }
+            Fam_Descriptor *dataItem = NULL;
+            switch (tag->op) {
+            case FAM_DATAITEM_ALLOCATE:
+                dataItem =
+                    allocated_dataitem(tag->res, tag->memServerId, tag->nbytes);
+                break;
+            case FAM_DATAITEM_LOOKUP:
+                dataItem = looked_up_dataitem(tag->res, tag->memServerId);
+                break;
+            case FAM_DATAITEM_DEALLOCATE:
+                break;
+            }
+            tag->handle->complete(dataItem);
+        } catch (...) {
+            tag->handle->fail(std::current_exception());
+        }
+        delete tag;
+    }
+
     Fam_Region_Item_Info
     check_permission_get_info(Fam_Region_Descriptor *region) {
         Fam_Region_Request req;
@@ -513,6 +614,7 @@ class Fam_Rpc_Client {
             } else {
                 itemInfo.key = res.key();
                 itemInfo.size = res.size();
+                grant_local_access(dataitem, res);
                 return itemInfo;
             }
         } else {
@@ -566,6 +668,7 @@ class Fam_Rpc_Client {
                 destGlobalDescriptor.offset = res.offset();
                 *dest = new Fam_Descriptor(destGlobalDescriptor, res.size());
                 (*dest)->bind_key(res.key());
+                grant_local_access(*dest, res);
             }
         } else {
             throw Fam_Allocator_Exception(FAM_ERR_GRPC,
@@ -596,6 +699,112 @@ class Fam_Rpc_Client {
         return (void *)tag;
     }
 
+    /**
+     * Reduces elements of a dataitem on the memory server
+     * @param dataitem - Descriptor of the dataitem
+     * @param offset - byte offset of the first element
+     * @param count - number of elements
+     * @param type - type of the elements
+     * @param op - reduction to compute
+     * @param result - result, fam_reduce_result_size() bytes long
+     * @see fam_rpc.proto
+     **/
+    void reduce(Fam_Descriptor *dataitem, uint64_t offset, uint64_t count,
+                Fam_Data_Type type, Fam_Reduce_Op op, void *result) {
+        Fam_Reduce_Request req;
+        Fam_Reduce_Response res;
+        ::grpc::ClientContext ctx;
+
+        Fam_Global_Descriptor globalDescriptor =
+            dataitem->get_global_descriptor();
+        req.set_regionid(globalDescriptor.regionId & REGIONID_MASK);
+        req.set_offset(globalDescriptor.offset);
+        req.set_uid(uid);
+        req.set_gid(gid);
+        req.set_start(offset);
+        req.set_count(count);
+        req.set_type(type);
+        req.set_op(op);
+
+        ::grpc::Status status = stub->reduce(&ctx, req, &res);
+
+        if (status.ok()) {
+            if (res.errorcode()) {
+                throw Fam_Allocator_Exception((enum Fam_Error)res.errorcode(),
+                                              (res.errormsg()).c_str());
+            } else {
+                memcpy(result, res.result().data(), res.result().size());
+            }
+        } else {
+            throw Fam_Allocator_Exception(FAM_ERR_GRPC,
+                                          (status.error_message()).c_str());
+        }
+    }
+
+    /**
+     * Scans records of a dataitem on the memory server
+     * @param src - Descriptor of the dataitem scanned
+     * @param offset - byte offset of the first record
+     * @param recordSize - size of a record
+     * @param numRecords - number of records
+     * @param predicate - predicate the records are matched against
+     * @param output - results written for the matching records
+     * @param dest - Descriptor of the dataitem written, on this memory
+     * server, or NULL with FAM_SCAN_COUNT
+     * @param destOffset - byte offset of the first result
+     * @return number of matching records
+     * @see fam_rpc.proto
+     **/
+    uint64_t scan(Fam_Descriptor *src, uint64_t offset, uint64_t recordSize,
+                  uint64_t numRecords, Fam_Scan_Predicate *predicate,
+                  Fam_Scan_Output output, Fam_Descriptor *dest,
+                  uint64_t destOffset) {
+        Fam_Scan_Request req;
+        Fam_Scan_Response res;
+        ::grpc::ClientContext ctx;
+
+        Fam_Global_Descriptor globalDescriptor = src->get_global_descriptor();
+        req.set_regionid(globalDescriptor.regionId & REGIONID_MASK);
+        req.set_offset(globalDescriptor.offset);
+        req.set_uid(uid);
+        req.set_gid(gid);
+        req.set_start(offset);
+        req.set_recordsize(recordSize);
+        req.set_numrecords(numRecords);
+        req.set_combine(predicate->combine);
+        for (uint32_t t = 0; t < predicate->numTerms; t++) {
+            ::Fam_Scan_Predicate_Term *term = req.add_terms();
+            uint64_t value;
+            memcpy(&value, &predicate->terms[t].value, sizeof(value));
+            term->set_fieldoffset(predicate->terms[t].fieldOffset);
+            term->set_type(predicate->terms[t].type);
+            term->set_op(predicate->terms[t].op);
+            term->set_value(value);
+        }
+        req.set_output(output);
+        if (dest != NULL) {
+            Fam_Global_Descriptor destGlobalDescriptor =
+                dest->get_global_descriptor();
+            req.set_destregionid(destGlobalDescriptor.regionId &
+                                 REGIONID_MASK);
+            req.set_destoffset(destGlobalDescriptor.offset);
+            req.set_deststart(destOffset);
+        }
+
+        ::grpc::Status status = stub->scan(&ctx, req, &res);
+
+        if (status.ok()) {
+            if (res.errorcode()) {
+                throw Fam_Allocator_Exception((enum Fam_Error)res.errorcode(),
+                                              (res.errormsg()).c_str());
+            }
+        } else {
+            throw Fam_Allocator_Exception(FAM_ERR_GRPC,
+                                          (status.error_message()).c_str());
+        }
+        return res.matches();
+    }
+
     void wait_for_copy(void *waitObj) {
         void *got_tag;
         bool ok = false;
@@ -712,16 +921,153 @@ class Fam_Rpc_Client {
         }
     }
 
+    /**
+     * Reads the statistics of the memory server
+     * @param memoryServerId - Id of the memory server, copied to the result
+     * @return - statistics to be released with fam_server_stats_free()
+     * @see fam_rpc.proto
+     **/
+    Fam_Server_Stats *get_stats(uint64_t memoryServerId) {
+        Fam_Request req;
+        Fam_Server_Stats_Response res;
+        ::grpc::ClientContext ctx;
+
+        ::grpc::Status status = stub->get_stats(&ctx, req, &res);
+        if (!status.ok()) {
+            throw Fam_Allocator_Exception(FAM_ERR_GRPC,
+                                          (status.error_message()).c_str());
+        }
+
+        Fam_Server_Stats *stats = new Fam_Server_Stats();
+        stats->memoryServerId = memoryServerId;
+        stats->numHeaps = res.heaps();
+        stats->numMemoryRegistrations = res.memoryregistrations();
+        stats->numClients = res.clients();
+        stats->copiesInProgress = res.copiesinprogress();
+        stats->numCopies = res.copies();
+        stats->progressLoops = res.progressloops();
+        stats->ready = res.ready();
+        stats->recoveryRegions = res.recoveryregions();
+        stats->recoveredRegions = res.recoveredregions();
+        stats->recoveryFailures = res.recoveryfailures();
+        stats->recoveryNs = res.recoveryns();
+
+        stats->numRegions = (uint64_t)res.regions_size();
+        stats->regions = NULL;
+        if (stats->numRegions)
+            stats->regions = new Fam_Server_Region_Stats[stats->numRegions];
+        for (int i = 0; i < res.regions_size(); i++) {
+            const Fam_Heap_Stats &heap = res.regions(i);
+            Fam_Server_Region_Stats *region = &stats->regions[i];
+            region->regionId = heap.regionid();
+            region->numDataitems = heap.dataitems();
+            region->allocatedBytes = heap.allocatedbytes();
+            region->reservedBytes = heap.reservedbytes();
+            region->numMerges = heap.merges();
+            region->totalMergeNs = heap.totalmergens();
+            region->freedBytesSinceMerge = heap.freedbytessincemerge();
+            region->allocFailures = heap.allocfailures();
+        }
+
+        stats->numRpcs = (uint64_t)res.rpcs_size();
+        stats->rpcs = NULL;
+        if (stats->numRpcs)
+            stats->rpcs = new Fam_Server_Rpc_Stats[stats->numRpcs];
+        for (int i = 0; i < res.rpcs_size(); i++) {
+            const Fam_Rpc_Stats &entry = res.rpcs(i);
+            Fam_Server_Rpc_Stats *rpc = &stats->rpcs[i];
+            rpc->rpc = strdup(entry.name().c_str());
+            rpc->calls = entry.calls();
+            rpc->totalNs = entry.totalns();
+            rpc->maxNs = entry.maxns();
+        }
+        return stats;
+    }
+
     size_t get_addr_size() { return memServerFabricAddrSize; };
     char *get_addr() { return memServerFabricAddr; };
 
+    std::string get_host_id() { return memServerHostId; };
+
   private:
+    void allocate_request(Fam_Dataitem_Request *req, const char *name,
+                          size_t nbytes, mode_t permission,
+                          Fam_Region_Descriptor *region) {
+        Fam_Global_Descriptor globalDescriptor =
+            region->get_global_descriptor();
+        req->set_name(name);
+        req->set_regionid(globalDescriptor.regionId & REGIONID_MASK);
+        req->set_size(nbytes);
+        req->set_perm(permission);
+        req->set_uid(uid);
+        req->set_gid(gid);
+        req->set_dup(false);
+    }
+
+    void lookup_request(Fam_Dataitem_Request *req, const char *itemName,
+                        const char *regionName) {
+        req->set_name(itemName);
+        req->set_regionname(regionName);
+        req->set_uid(uid);
+        req->set_gid(gid);
+    }
+
+    void deallocate_request(Fam_Dataitem_Request *req,
+                            Fam_Descriptor *dataitem) {
+        Fam_Global_Descriptor globalDescriptor =
+            dataitem->get_global_descriptor();
+        req->set_regionid(globalDescriptor.regionId & REGIONID_MASK);
+        req->set_offset(globalDescriptor.offset);
+        req->set_uid(uid);
+        req->set_gid(gid);
+        req->set_key(dataitem->get_key());
+    }
+
+    static Fam_Descriptor *allocated_dataitem(const Fam_Dataitem_Response &res,
+                                              uint64_t nodeId,
+                                              uint64_t nbytes) {
+        Fam_Global_Descriptor globalDescriptor;
+        globalDescriptor.regionId =
+            res.regionid() | (nodeId << MEMSERVERID_SHIFT);
+        globalDescriptor.offset = res.offset();
+        Fam_Descriptor *dataItem = new Fam_Descriptor(globalDescriptor, nbytes);
+        dataItem->bind_key(res.key());
+        grant_local_access(dataItem, res);
+        return dataItem;
+    }
+
+    /*
+     * Record the direct access to the data item the memory server granted,
+     * used if the memory server shares the host with this PE
+     */
+    static void grant_local_access(Fam_Descriptor *dataItem,
+                                   const Fam_Dataitem_Response &res) {
+        Fam_Descriptor_Hot *hot = fam_descriptor_hot(dataItem);
+        hot->localHeapSize = res.heapsize();
+        hot->localWrite = res.localwrite();
+        hot->localGeneration = res.generation();
+    }
+
+    static Fam_Descriptor *
+    looked_up_dataitem(const Fam_Dataitem_Response &res,
+                       uint64_t memoryServerId) {
+        Fam_Global_Descriptor globalDescriptor;
+        globalDescriptor.regionId =
+            res.regionid() | (memoryServerId << MEMSERVERID_SHIFT);
+        globalDescriptor.offset = res.offset();
+        Fam_Descriptor *dataItem =
+            new Fam_Descriptor(globalDescriptor, res.size());
+        dataItem->bind_key(FAM_KEY_UNINITIALIZED);
+        return dataItem;
+    }
+
     std::unique_ptr<Fam_Rpc::Stub> stub;
     uint32_t uid;
     uint32_t gid;
 
     size_t memServerFabricAddrSize;
     char *memServerFabricAddr;
+    std::string memServerHostId;
 
     ::grpc::CompletionQueue cq;
 };
@@ -41,12 +41,16 @@ typedef Fam_Rpc::WithAsyncMethod_copy<Fam_Rpc_Service_Impl> sType;
 class Fam_Rpc_Server {
   public:
     Fam_Rpc_Server(uint64_t rpcPort, char *name, char *libfabricPort,
-                   char *provider)
+                   char *provider, uint64_t recoveryThreads)
         : serverAddress(name), port(rpcPort) {
-        allocator = new Memserver_Allocator();
+        // The memory server is the only process allocating from its heaps
+        allocator = new Memserver_Allocator(true);
         service = new sType();
         service->rpc_service_initialize(name, libfabricPort, provider,
                                         allocator);
+        // Open the heaps of existing regions while the server starts
+        // accepting requests
+        allocator->start_recovery(recoveryThreads);
     }
 
     ~Fam_Rpc_Server() { delete service; }
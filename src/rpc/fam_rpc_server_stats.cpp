@@ -0,0 +1,88 @@
+/*
+ * fam_rpc_server_stats.cpp
+ * Copyright (c) 2019 Hewlett Packard Enterprise Development, LP. All rights
+ * reserved. Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ *    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * See https://spdx.org/licenses/BSD-3-Clause
+ *
+ */
+#include "rpc/fam_rpc_server_stats.h"
+
+namespace openfam {
+
+static const char *rpcNames[] = {
+#undef FAM_RPC_STAT
+#define FAM_RPC_STAT(name) #name,
+#include "fam_rpc_stats.tbl"
+};
+
+Fam_Rpc_Server_Stats::Fam_Rpc_Server_Stats() {}
+
+Fam_Rpc_Server_Stats::~Fam_Rpc_Server_Stats() {
+    for (auto block : threadBlocks.get_blocks())
+        delete block;
+}
+
+Fam_Rpc_Server_Stats::Thread_Block *Fam_Rpc_Server_Stats::get_thread_block() {
+    return threadBlocks.get([]() {
+        Thread_Block *block = new Thread_Block();
+        for (uint64_t i = 0; i < fam_rpc_stat_max; i++) {
+            block->counters[i].calls.store(0, std::memory_order_relaxed);
+            block->counters[i].totalNs.store(0, std::memory_order_relaxed);
+            block->counters[i].maxNs.store(0, std::memory_order_relaxed);
+        }
+        return block;
+    });
+}
+
+void Fam_Rpc_Server_Stats::record(Fam_Rpc_Stat_Enum_T rpc, uint64_t elapsed) {
+    Rpc_Counters &counters = get_thread_block()->counters[rpc];
+    bump(counters.calls, 1);
+    bump(counters.totalNs, elapsed);
+    if (elapsed > counters.maxNs.load(std::memory_order_relaxed))
+        counters.maxNs.store(elapsed, std::memory_order_relaxed);
+}
+
+/*
+ * Sums the counters of all threads; RPCs never called are left out
+ */
+void Fam_Rpc_Server_Stats::get_stats(std::vector<Fam_Rpc_Stat_Entry> &stats) {
+    threadBlocks.lock();
+    for (uint64_t rpc = 0; rpc < fam_rpc_stat_max; rpc++) {
+        Fam_Rpc_Stat_Entry entry = {rpcNames[rpc], 0, 0, 0};
+        for (auto block : threadBlocks.get_blocks()) {
+            Rpc_Counters &counters = block->counters[rpc];
+            entry.calls += counters.calls.load(std::memory_order_relaxed);
+            entry.totalNs += counters.totalNs.load(std::memory_order_relaxed);
+            uint64_t maxNs = counters.maxNs.load(std::memory_order_relaxed);
+            if (maxNs > entry.maxNs)
+                entry.maxNs = maxNs;
+        }
+        if (entry.calls)
+            stats.push_back(entry);
+    }
+    threadBlocks.unlock();
+}
+
+} // namespace openfam
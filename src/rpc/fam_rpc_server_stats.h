@@ -0,0 +1,96 @@
+/*
+ * fam_rpc_server_stats.h
+ * Copyright (c) 2019 Hewlett Packard Enterprise Development, LP. All rights
+ * reserved. Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ *    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * See https://spdx.org/licenses/BSD-3-Clause
+ *
+ */
+#ifndef FAM_RPC_SERVER_STATS_H_
+#define FAM_RPC_SERVER_STATS_H_
+
+#include <atomic>
+#include <stdint.h>
+#include <vector>
+
+#include "common/fam_thread_blocks.h"
+
+namespace openfam {
+
+typedef enum Fam_Rpc_Stat_Enum {
+#undef FAM_RPC_STAT
+#define FAM_RPC_STAT(name) fam_rpc_##name,
+#include "fam_rpc_stats.tbl"
+    fam_rpc_stat_max
+} Fam_Rpc_Stat_Enum_T;
+
+/*
+ * Calls of one RPC and the time spent in its handler, in nanoseconds
+ */
+typedef struct {
+    const char *name;
+    uint64_t calls;
+    uint64_t totalNs;
+    uint64_t maxNs;
+} Fam_Rpc_Stat_Entry;
+
+/*
+ * Call counts and handler latency of the RPCs in fam_rpc_stats.tbl. Every
+ * handler thread records into a block of counters private to it, with
+ * relaxed single-writer updates, so handlers take no locks and no locked
+ * instructions; get_stats() sums the blocks of all threads.
+ */
+class Fam_Rpc_Server_Stats {
+  public:
+    Fam_Rpc_Server_Stats();
+
+    ~Fam_Rpc_Server_Stats();
+
+    void record(Fam_Rpc_Stat_Enum_T rpc, uint64_t elapsed);
+
+    void get_stats(std::vector<Fam_Rpc_Stat_Entry> &stats);
+
+  private:
+    struct Rpc_Counters {
+        std::atomic<uint64_t> calls;
+        std::atomic<uint64_t> totalNs;
+        std::atomic<uint64_t> maxNs;
+    };
+
+    struct Thread_Block {
+        Rpc_Counters counters[fam_rpc_stat_max];
+    };
+
+    Thread_Block *get_thread_block();
+
+    static void bump(std::atomic<uint64_t> &counter, uint64_t value) {
+        counter.store(counter.load(std::memory_order_relaxed) + value,
+                      std::memory_order_relaxed);
+    }
+
+    Fam_Thread_Blocks<Thread_Block> threadBlocks;
+};
+
+} // namespace openfam
+#endif // FAM_RPC_SERVER_STATS_H_
@@ -40,6 +40,10 @@ void Fam_Rpc_Service_Impl::progress_thread() {
                 famOps->quiet();
             else
                 break;
+            // Only this thread updates the counter
+            progressLoops.store(
+                progressLoops.load(std::memory_order_relaxed) + 1,
+                std::memory_order_relaxed);
         }
     }
 }
@@ -49,6 +53,9 @@ void Fam_Rpc_Service_Impl::rpc_service_initialize(
     message << "Error while initializing RPC service : ";
     numClients = 0;
     shouldShutdown = false;
+    copiesInProgress = 0;
+    numCopies = 0;
+    progressLoops = 0;
     allocator = memAlloc;
     famOps =
         new Fam_Ops_Libfabric(name, service, true, provider,
@@ -100,6 +107,7 @@ Fam_Rpc_Service_Impl::~Fam_Rpc_Service_Impl() {
 Fam_Rpc_Service_Impl::signal_start(::grpc::ServerContext *context,
                                    const ::Fam_Request *request,
                                    ::Fam_Start_Response *response) {
+    Fam_Rpc_Server_Timer serverTimer(context, &rpcStats, fam_rpc_signal_start);
     __sync_add_and_fetch(&numClients, 1);
 
     size_t addrSize = famOps->get_addr_size();
@@ -121,6 +129,9 @@ Fam_Rpc_Service_Impl::signal_start(::grpc::ServerContext *context,
         response->add_addrname(lastBytes);
     }
 
+    // Lets a client on the same host bypass libfabric for the datapath
+    response->set_hostid(fam_host_id());
+
     return ::grpc::Status::OK;
 }
 
@@ -128,14 +139,73 @@ Fam_Rpc_Service_Impl::signal_start(::grpc::ServerContext *context,
 Fam_Rpc_Service_Impl::signal_termination(::grpc::ServerContext *context,
                                          const ::Fam_Request *request,
                                          ::Fam_Response *response) {
+    Fam_Rpc_Server_Timer serverTimer(context, &rpcStats,
+                                     fam_rpc_signal_termination);
     __sync_add_and_fetch(&numClients, -1);
     return ::grpc::Status::OK;
 }
 
+/*
+ * Counters of the memory server, each read without stopping the handlers
+ * or the progress thread that update it
+ */
+::grpc::Status
+Fam_Rpc_Service_Impl::get_stats(::grpc::ServerContext *context,
+                                const ::Fam_Request *request,
+                                ::Fam_Server_Stats_Response *response) {
+    Fam_Rpc_Server_Timer serverTimer(context, &rpcStats, fam_rpc_get_stats);
+    response->set_heaps(allocator->get_num_heaps());
+    pthread_mutex_lock(famOps->get_mr_lock());
+    response->set_memoryregistrations(fiMrs->size());
+    pthread_mutex_unlock(famOps->get_mr_lock());
+    response->set_clients((uint64_t)numClients);
+    response->set_copiesinprogress(
+        copiesInProgress.load(std::memory_order_relaxed));
+    response->set_copies(numCopies.load(std::memory_order_relaxed));
+    response->set_progressloops(progressLoops.load(std::memory_order_relaxed));
+
+    Memserver_Recovery_Status recovery;
+    allocator->get_recovery_status(recovery);
+    response->set_ready(recovery.ready);
+    response->set_recoveryregions(recovery.numRegions);
+    response->set_recoveredregions(recovery.numRecovered);
+    response->set_recoveryfailures(recovery.numFailed);
+    response->set_recoveryns(recovery.recoveryNs);
+
+    std::vector<Heap_Maintenance_Stats> heapStats;
+    allocator->get_heap_stats(heapStats);
+    for (auto stats : heapStats) {
+        ::Fam_Heap_Stats *region = response->add_regions();
+        region->set_regionid(stats.regionId);
+        region->set_merges(stats.numMerges);
+        region->set_mergefailures(stats.numMergeFailures);
+        region->set_freessincemerge(stats.freesSinceMerge);
+        region->set_freedbytessincemerge(stats.freedBytesSinceMerge);
+        region->set_allocfailures(stats.allocFailures);
+        region->set_lastmergens(stats.lastMergeNs);
+        region->set_totalmergens(stats.totalMergeNs);
+        region->set_dataitems(stats.numDataitems);
+        region->set_allocatedbytes(stats.allocatedBytes);
+        region->set_reservedbytes(stats.reservedBytes);
+    }
+
+    std::vector<Fam_Rpc_Stat_Entry> rpcEntries;
+    rpcStats.get_stats(rpcEntries);
+    for (auto entry : rpcEntries) {
+        ::Fam_Rpc_Stats *rpc = response->add_rpcs();
+        rpc->set_name(entry.name);
+        rpc->set_calls(entry.calls);
+        rpc->set_totalns(entry.totalNs);
+        rpc->set_maxns(entry.maxNs);
+    }
+    return ::grpc::Status::OK;
+}
+
 ::grpc::Status
 Fam_Rpc_Service_Impl::create_region(::grpc::ServerContext *context,
                                     const ::Fam_Region_Request *request,
                                     ::Fam_Region_Response *response) {
+    Fam_Rpc_Server_Timer serverTimer(context, &rpcStats, fam_rpc_create_region);
     uint64_t regionId;
     try {
         allocator->create_region(
@@ -157,6 +227,8 @@ Fam_Rpc_Service_Impl::create_region(::grpc::ServerContext *context,
 Fam_Rpc_Service_Impl::destroy_region(::grpc::ServerContext *context,
                                      const ::Fam_Region_Request *request,
                                      ::Fam_Region_Response *response) {
+    Fam_Rpc_Server_Timer serverTimer(context, &rpcStats,
+                                     fam_rpc_destroy_region);
     try {
         allocator->destroy_region(request->regionid(), request->uid(),
                                   request->gid());
@@ -175,6 +247,7 @@ Fam_Rpc_Service_Impl::resize_region(::grpc::ServerContext *context,
                                     const ::Fam_Region_Request *request,
                                     ::Fam_Region_Response *response) {
 
+    Fam_Rpc_Server_Timer serverTimer(context, &rpcStats, fam_rpc_resize_region);
     try {
         allocator->resize_region(request->regionid(), request->uid(),
                                  request->gid(), request->size());
@@ -192,6 +265,7 @@ Fam_Rpc_Service_Impl::resize_region(::grpc::ServerContext *context,
 Fam_Rpc_Service_Impl::allocate(::grpc::ServerContext *context,
                                const ::Fam_Dataitem_Request *request,
                                ::Fam_Dataitem_Response *response) {
+    Fam_Rpc_Server_Timer serverTimer(context, &rpcStats, fam_rpc_allocate);
     ostringstream message;
     uint64_t offset;
     uint64_t key;
@@ -259,6 +333,7 @@ Fam_Rpc_Service_Impl::allocate(::grpc::ServerContext *context,
     response->set_key(key);
     response->set_regionid(request->regionid());
     response->set_offset(offset);
+    set_local_access(request->regionid(), key, response);
 
     // Return status OK
     return ::grpc::Status::OK;
@@ -268,6 +343,7 @@ Fam_Rpc_Service_Impl::allocate(::grpc::ServerContext *context,
 Fam_Rpc_Service_Impl::deallocate(::grpc::ServerContext *context,
                                  const ::Fam_Dataitem_Request *request,
                                  ::Fam_Dataitem_Response *response) {
+    Fam_Rpc_Server_Timer serverTimer(context, &rpcStats, fam_rpc_deallocate);
     ostringstream message;
     try {
         allocator->deallocate(request->regionid(), request->offset(),
@@ -295,6 +371,8 @@ Fam_Rpc_Service_Impl::deallocate(::grpc::ServerContext *context,
 ::grpc::Status Fam_Rpc_Service_Impl::change_region_permission(
     ::grpc::ServerContext *context, const ::Fam_Region_Request *request,
     ::Fam_Region_Response *response) {
+    Fam_Rpc_Server_Timer serverTimer(context, &rpcStats,
+                                     fam_rpc_change_region_permission);
     try {
         allocator->change_region_permission(request->regionid(),
                                             (mode_t)request->perm(),
@@ -312,6 +390,8 @@ Fam_Rpc_Service_Impl::deallocate(::grpc::ServerContext *context,
 ::grpc::Status Fam_Rpc_Service_Impl::change_dataitem_permission(
     ::grpc::ServerContext *context, const ::Fam_Dataitem_Request *request,
     ::Fam_Dataitem_Response *response) {
+    Fam_Rpc_Server_Timer serverTimer(context, &rpcStats,
+                                     fam_rpc_change_dataitem_permission);
     try {
         allocator->change_dataitem_permission(
             request->regionid(), request->offset(), (mode_t)request->perm(),
@@ -330,6 +410,7 @@ Fam_Rpc_Service_Impl::deallocate(::grpc::ServerContext *context,
 Fam_Rpc_Service_Impl::lookup_region(::grpc::ServerContext *context,
                                     const ::Fam_Region_Request *request,
                                     ::Fam_Region_Response *response) {
+    Fam_Rpc_Server_Timer serverTimer(context, &rpcStats, fam_rpc_lookup_region);
     ostringstream message;
     Fam_Region_Metadata region;
     try {
@@ -365,6 +446,7 @@ Fam_Rpc_Service_Impl::lookup_region(::grpc::ServerContext *context,
 Fam_Rpc_Service_Impl::lookup(::grpc::ServerContext *context,
                              const ::Fam_Dataitem_Request *request,
                              ::Fam_Dataitem_Response *response) {
+    Fam_Rpc_Server_Timer serverTimer(context, &rpcStats, fam_rpc_lookup);
     Fam_DataItem_Metadata dataitem;
     ostringstream message;
     try {
@@ -435,6 +517,8 @@ response->set_key(key);
     ::grpc::ServerContext *context, const ::Fam_Region_Request *request,
     ::Fam_Region_Response *response) {
 
+    Fam_Rpc_Server_Timer serverTimer(context, &rpcStats,
+                                     fam_rpc_check_permission_get_region_info);
     Fam_Region_Metadata region;
     ostringstream message;
     try {
@@ -464,6 +548,8 @@ response->set_key(key);
     ::grpc::ServerContext *context, const ::Fam_Dataitem_Request *request,
     ::Fam_Dataitem_Response *response) {
 
+    Fam_Rpc_Server_Timer serverTimer(context, &rpcStats,
+                                     fam_rpc_check_permission_get_item_info);
     Fam_DataItem_Metadata dataitem;
     uint64_t key;
     ostringstream message;
@@ -508,6 +594,7 @@ response->set_key(key);
     response->set_offset(dataitem.offset);
     response->set_key(key);
     response->set_size(dataitem.size);
+    set_local_access(dataitem.regionId, key, response);
 
     // Return status OK
     return ::grpc::Status::OK;
@@ -516,9 +603,93 @@ response->set_key(key);
 ::grpc::Status Fam_Rpc_Service_Impl::copy(::grpc::ServerContext *context,
                                           const ::Fam_Copy_Request *request,
                                           ::Fam_Copy_Response *response) {
+    Fam_Rpc_Server_Timer serverTimer(context, &rpcStats, fam_rpc_copy);
+    copiesInProgress.fetch_add(1, std::memory_order_relaxed);
+    numCopies.fetch_add(1, std::memory_order_relaxed);
+    copiesInProgress.fetch_sub(1, std::memory_order_relaxed);
+    return ::grpc::Status::OK;
+}
+
+::grpc::Status
+Fam_Rpc_Service_Impl::reduce(::grpc::ServerContext *context,
+                             const ::Fam_Reduce_Request *request,
+                             ::Fam_Reduce_Response *response) {
+    Fam_Rpc_Server_Timer serverTimer(context, &rpcStats, fam_rpc_reduce);
+    Fam_Data_Type type = (Fam_Data_Type)request->type();
+    Fam_Reduce_Op op = (Fam_Reduce_Op)request->op();
+    uint64_t result = 0;
+    try {
+        allocator->reduce(request->regionid(), request->offset(),
+                          request->start(), request->count(), type, op,
+                          request->uid(), request->gid(), &result);
+    } catch (Memserver_Exception &e) {
+        response->set_errorcode(e.fam_error());
+        response->set_errormsg(e.fam_error_msg());
+        return ::grpc::Status::OK;
+    }
+    response->set_result(&result, fam_reduce_result_size(type, op));
+
+    // Return status OK
     return ::grpc::Status::OK;
 }
 
+::grpc::Status Fam_Rpc_Service_Impl::scan(::grpc::ServerContext *context,
+                                          const ::Fam_Scan_Request *request,
+                                          ::Fam_Scan_Response *response) {
+    Fam_Rpc_Server_Timer serverTimer(context, &rpcStats, fam_rpc_scan);
+    Fam_Scan_Predicate predicate;
+    uint64_t matches = 0;
+
+    if (request->terms_size() > FAM_SCAN_MAX_TERMS) {
+        response->set_errorcode(FAM_ERR_INVALID);
+        response->set_errormsg("Too many terms in scan predicate");
+        return ::grpc::Status::OK;
+    }
+    memset(&predicate, 0, sizeof(predicate));
+    predicate.combine = (Fam_Scan_Combine)request->combine();
+    predicate.numTerms = (uint32_t)request->terms_size();
+    for (int t = 0; t < request->terms_size(); t++) {
+        const ::Fam_Scan_Predicate_Term &term = request->terms(t);
+        predicate.terms[t].fieldOffset = term.fieldoffset();
+        predicate.terms[t].type = (Fam_Data_Type)term.type();
+        predicate.terms[t].op = (Fam_Compare_Op)term.op();
+        predicate.terms[t].value.u64 = term.value();
+    }
+
+    try {
+        allocator->scan(request->regionid(), request->offset(),
+                        request->start(), request->recordsize(),
+                        request->numrecords(), &predicate,
+                        (Fam_Scan_Output)request->output(),
+                        request->destregionid(), request->destoffset(),
+                        request->deststart(), request->uid(), request->gid(),
+                        &matches);
+    } catch (Memserver_Exception &e) {
+        response->set_errorcode(e.fam_error());
+        response->set_errormsg(e.fam_error_msg());
+        return ::grpc::Status::OK;
+    }
+    response->set_matches(matches);
+
+    // Return status OK
+    return ::grpc::Status::OK;
+}
+
+/*
+ * Grant direct access to the dataitem for a client on the same host: the
+ * generation and size of the heap it may open, and write access if the
+ * access key generated for the client allows writing
+ */
+void Fam_Rpc_Service_Impl::set_local_access(
+    uint64_t regionId, uint64_t key, ::Fam_Dataitem_Response *response) {
+    uint64_t generation, heapSize;
+    if (!allocator->get_heap_generation(regionId, generation, heapSize))
+        return;
+    response->set_generation(generation);
+    response->set_heapsize(heapSize);
+    response->set_localwrite((key & FAM_WRITE_KEY_FABRIC) != 0);
+}
+
 uint64_t Fam_Rpc_Service_Impl::generate_access_key(uint64_t regionId,
                                                    uint64_t dataitemId,
                                                    bool permission) {
@@ -679,6 +850,8 @@ int Fam_Rpc_Service_Impl::deregister_memory(uint64_t regionId,
 Fam_Rpc_Service_Impl::acquire_CAS_lock(::grpc::ServerContext *context,
                                        const ::Fam_Dataitem_Request *request,
                                        ::Fam_Dataitem_Response *response) {
+    Fam_Rpc_Server_Timer serverTimer(context, &rpcStats,
+                                     fam_rpc_acquire_CAS_lock);
     int idx = LOCKHASH(request->offset());
     pthread_mutex_lock(&casLock[idx]);
 
@@ -690,6 +863,8 @@ Fam_Rpc_Service_Impl::acquire_CAS_lock(::grpc::ServerContext *context,
 Fam_Rpc_Service_Impl::release_CAS_lock(::grpc::ServerContext *context,
                                        const ::Fam_Dataitem_Request *request,
                                        ::Fam_Dataitem_Response *response) {
+    Fam_Rpc_Server_Timer serverTimer(context, &rpcStats,
+                                     fam_rpc_release_CAS_lock);
     int idx = LOCKHASH(request->offset());
     pthread_mutex_unlock(&casLock[idx]);
 
@@ -34,6 +34,7 @@
 #include <iostream>
 #include <map>
 #include <thread>
+#include <time.h>
 #include <unistd.h>
 
 #include "grpcpp/grpcpp.h"
@@ -42,9 +43,11 @@
 #include "allocator/rbtree.h"
 #include "metadata/fam_metadata_manager.h"
 #include "rpc/fam_rpc.grpc.pb.h"
+#include "rpc/fam_rpc_server_stats.h"
 
 #include "common/fam_internal.h"
 #include "common/fam_libfabric.h"
+#include "common/fam_local_bypass.h"
 #include "common/fam_ops_libfabric.h"
 #include "common/fam_options.h"
 #include "common/memserver_exception.h"
@@ -77,6 +80,36 @@ using grpc::Status;
              << " is Not Yet Implemented...!!!" << endl;                       \
     }
 
+/*
+ * Times an RPC handler, records the time in the server statistics and
+ * returns it to the client in the trailing metadata FAM_RPC_SERVER_TIME_KEY
+ */
+class Fam_Rpc_Server_Timer {
+  public:
+    Fam_Rpc_Server_Timer(::grpc::ServerContext *context,
+                         Fam_Rpc_Server_Stats *stats, Fam_Rpc_Stat_Enum_T rpc)
+        : context(context), rpcStats(stats), rpcIdx(rpc) {
+        clock_gettime(CLOCK_MONOTONIC, &start);
+    }
+
+    ~Fam_Rpc_Server_Timer() {
+        struct timespec end;
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        uint64_t elapsed =
+            (uint64_t)(end.tv_sec - start.tv_sec) * 1000000000UL +
+            (uint64_t)end.tv_nsec - (uint64_t)start.tv_nsec;
+        rpcStats->record(rpcIdx, elapsed);
+        context->AddTrailingMetadata(FAM_RPC_SERVER_TIME_KEY,
+                                     std::to_string(elapsed));
+    }
+
+  private:
+    ::grpc::ServerContext *context;
+    Fam_Rpc_Server_Stats *rpcStats;
+    Fam_Rpc_Stat_Enum_T rpcIdx;
+    struct timespec start;
+};
+
 class Fam_Rpc_Service_Impl : public Fam_Rpc::Service {
   public:
     Fam_Rpc_Service_Impl() {}
@@ -96,6 +129,10 @@ class Fam_Rpc_Service_Impl : public Fam_Rpc::Service {
                                       const ::Fam_Request *request,
                                       ::Fam_Response *response) override;
 
+    ::grpc::Status get_stats(::grpc::ServerContext *context,
+                             const ::Fam_Request *request,
+                             ::Fam_Server_Stats_Response *response) override;
+
     ::grpc::Status create_region(::grpc::ServerContext *context,
                                  const ::Fam_Region_Request *request,
                                  ::Fam_Region_Response *response) override;
@@ -147,6 +184,14 @@ class Fam_Rpc_Service_Impl : public Fam_Rpc::Service {
                         const ::Fam_Copy_Request *request,
                         ::Fam_Copy_Response *response) override;
 
+    ::grpc::Status reduce(::grpc::ServerContext *context,
+                          const ::Fam_Reduce_Request *request,
+                          ::Fam_Reduce_Response *response) override;
+
+    ::grpc::Status scan(::grpc::ServerContext *context,
+                        const ::Fam_Scan_Request *request,
+                        ::Fam_Scan_Response *response) override;
+
     ::grpc::Status acquire_CAS_lock(::grpc::ServerContext *context,
                                     const ::Fam_Dataitem_Request *request,
                                     ::Fam_Dataitem_Response *response) override;
@@ -170,9 +215,17 @@ class Fam_Rpc_Service_Impl : public Fam_Rpc::Service {
 
     std::map<uint64_t, fid_mr *> *fiMrs;
 
+    Fam_Rpc_Server_Stats rpcStats;
+    std::atomic<uint64_t> copiesInProgress;
+    std::atomic<uint64_t> numCopies;
+    std::atomic<uint64_t> progressLoops;
+
     uint64_t generate_access_key(uint64_t regionId, uint64_t dataitemId,
                                  bool permission);
 
+    void set_local_access(uint64_t regionId, uint64_t key,
+                          ::Fam_Dataitem_Response *response);
+
     int deregister_memory(uint64_t regionId, uint64_t offset);
 
     int register_memory(Fam_DataItem_Metadata dataitem, void *localPointer,
@@ -0,0 +1,700 @@
+/*
+ * fam_bench.cpp
+ * Copyright (c) 2019 Hewlett Packard Enterprise Development, LP. All rights
+ * reserved. Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ *    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * See https://spdx.org/licenses/BSD-3-Clause
+ *
+ */
+#include <algorithm>
+#include <fam/fam_exception.h>
+#include <iostream>
+#include <pthread.h>
+#include <sstream>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <time.h>
+#include <vector>
+
+#include <fam/fam.h>
+
+#include "common/fam_test_config.h"
+
+/*
+ * Defaults of the sweep; every one of them can be changed on the command line
+ */
+#define BENCH_SIZES "8,64,512,4096,32768,262144"
+#define BENCH_THREADS "1"
+#define BENCH_OPS "put,get,scatter,gather,atomic,copy,allocate,lookup"
+#define BENCH_MODES "blocking,nonblocking"
+#define BENCH_CONTEXTS "default"
+#define BENCH_WARMUP_MS 200
+#define BENCH_DURATION_MS 1000
+#define BENCH_BATCH 16
+#define BENCH_ELEMENTS 4
+
+/*
+ * Latency samples kept per thread and run; beyond this, samples are
+ * reservoir sampled so that percentiles stay unbiased
+ */
+#define BENCH_MAX_SAMPLES (1 << 20)
+
+using namespace std;
+using namespace openfam;
+
+typedef enum {
+    BENCH_PUT = 0,
+    BENCH_GET,
+    BENCH_SCATTER,
+    BENCH_GATHER,
+    BENCH_ATOMIC,
+    BENCH_COPY,
+    BENCH_ALLOCATE,
+    BENCH_LOOKUP,
+    BENCH_OP_MAX
+} Bench_Op;
+
+static const char *opNames[BENCH_OP_MAX] = {
+    "put", "get", "scatter", "gather", "atomic", "copy", "allocate", "lookup"};
+
+struct Bench_Config {
+    vector<uint64_t> sizes;
+    vector<uint64_t> threads;
+    vector<int> ops;
+    vector<bool> modes;
+    vector<string> contexts;
+    uint64_t warmupMs;
+    uint64_t durationMs;
+    uint64_t batch;
+    uint64_t elements;
+    uint64_t regionSize;
+    string format;
+    string output;
+    Fam_Options famOpts;
+};
+
+struct Bench_Result {
+    string context;
+    int op;
+    bool nonblocking;
+    uint64_t size;
+    uint64_t threads;
+    uint64_t ops;
+    uint64_t bytes;
+    double seconds;
+    uint64_t p50;
+    uint64_t p99;
+    uint64_t p999;
+    uint64_t max;
+};
+
+struct Bench_Run;
+
+struct Bench_Thread {
+    Bench_Run *run;
+    pthread_t thread;
+    Fam_Descriptor *item;
+    const char *itemName;
+    char *local;
+    uint64_t *indexes;
+    uint64_t ops;
+    uint64_t seen;
+    uint64_t elapsed;
+    unsigned int seed;
+    vector<uint64_t> samples;
+    string error;
+};
+
+struct Bench_Run {
+    fam *famObj;
+    Bench_Config *config;
+    Fam_Region_Descriptor *region;
+    const char *regionName;
+    int op;
+    bool nonblocking;
+    uint64_t size;
+    pthread_barrier_t barrier;
+};
+
+static uint64_t bench_time() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+/*
+ * Bytes moved by one operation of the run
+ */
+static uint64_t bench_bytes(Bench_Run *run) {
+    uint64_t elementSize;
+    switch (run->op) {
+    case BENCH_SCATTER:
+    case BENCH_GATHER:
+        elementSize = run->size / run->config->elements;
+        return (elementSize ? elementSize : 1) * run->config->elements;
+    case BENCH_ATOMIC:
+        return sizeof(int64_t);
+    case BENCH_LOOKUP:
+        return 0;
+    default:
+        return run->size;
+    }
+}
+
+/*
+ * Issue one operation, or one batch of non-blocking operations followed by
+ * the call that waits for them. Returns the number of operations done, and
+ * their latency in latency.
+ */
+static uint64_t bench_issue(Bench_Run *run, Bench_Thread *t,
+                            uint64_t *latency) {
+    fam *famObj = run->famObj;
+    uint64_t count = run->nonblocking ? run->config->batch : 1;
+    uint64_t elements = run->config->elements;
+    uint64_t elementSize = bench_bytes(run) / elements;
+    vector<Fam_Descriptor *> copies(count);
+    vector<void *> waitObjs(count);
+    Fam_Descriptor *descriptor;
+    uint64_t start = bench_time();
+
+    switch (run->op) {
+    case BENCH_PUT:
+        if (!run->nonblocking) {
+            famObj->fam_put_blocking(t->local, t->item, 0, run->size);
+            break;
+        }
+        for (uint64_t i = 0; i < count; i++)
+            famObj->fam_put_nonblocking(t->local, t->item, 0, run->size);
+        famObj->fam_quiet();
+        break;
+    case BENCH_GET:
+        if (!run->nonblocking) {
+            famObj->fam_get_blocking(t->local, t->item, 0, run->size);
+            break;
+        }
+        for (uint64_t i = 0; i < count; i++)
+            famObj->fam_get_nonblocking(t->local, t->item, 0, run->size);
+        famObj->fam_quiet();
+        break;
+    case BENCH_SCATTER:
+        if (!run->nonblocking) {
+            famObj->fam_scatter_blocking(t->local, t->item, elements,
+                                         t->indexes, elementSize);
+            break;
+        }
+        for (uint64_t i = 0; i < count; i++)
+            famObj->fam_scatter_nonblocking(t->local, t->item, elements,
+                                            t->indexes, elementSize);
+        famObj->fam_quiet();
+        break;
+    case BENCH_GATHER:
+        if (!run->nonblocking) {
+            famObj->fam_gather_blocking(t->local, t->item, elements,
+                                        t->indexes, elementSize);
+            break;
+        }
+        for (uint64_t i = 0; i < count; i++)
+            famObj->fam_gather_nonblocking(t->local, t->item, elements,
+                                           t->indexes, elementSize);
+        famObj->fam_quiet();
+        break;
+    case BENCH_ATOMIC:
+        if (!run->nonblocking) {
+            famObj->fam_fetch_add(t->item, 0, (int64_t)1);
+            break;
+        }
+        for (uint64_t i = 0; i < count; i++)
+            famObj->fam_add(t->item, 0, (int64_t)1);
+        famObj->fam_quiet();
+        break;
+    case BENCH_COPY:
+        // Every copy creates a new data item, which is released afterwards
+        for (uint64_t i = 0; i < count; i++)
+            waitObjs[i] =
+                famObj->fam_copy(t->item, 0, &copies[i], 0, run->size);
+        for (uint64_t i = 0; i < count; i++)
+            famObj->fam_copy_wait(waitObjs[i]);
+        *latency = bench_time() - start;
+        for (uint64_t i = 0; i < count; i++) {
+            famObj->fam_deallocate(copies[i]);
+            delete copies[i];
+        }
+        return count;
+    case BENCH_ALLOCATE:
+        descriptor = famObj->fam_allocate(run->size, 0777, run->region);
+        famObj->fam_deallocate(descriptor);
+        delete descriptor;
+        break;
+    case BENCH_LOOKUP:
+        descriptor = famObj->fam_lookup(t->itemName, run->regionName);
+        delete descriptor;
+        break;
+    }
+    *latency = bench_time() - start;
+    return count;
+}
+
+static void bench_sample(Bench_Thread *t, uint64_t latency) {
+    t->seen++;
+    if (t->samples.size() < BENCH_MAX_SAMPLES) {
+        t->samples.push_back(latency);
+        return;
+    }
+    uint64_t slot = ((uint64_t)rand_r(&t->seed) * (RAND_MAX + 1ULL) +
+                     (uint64_t)rand_r(&t->seed)) %
+                    t->seen;
+    if (slot < BENCH_MAX_SAMPLES)
+        t->samples[slot] = latency;
+}
+
+static void *bench_thread(void *arg) {
+    Bench_Thread *t = (Bench_Thread *)arg;
+    Bench_Run *run = t->run;
+    uint64_t warmup = run->config->warmupMs * 1000000ULL;
+    uint64_t duration = run->config->durationMs * 1000000ULL;
+    uint64_t start, end, now, done, latency;
+    bool timed = false;
+
+    pthread_barrier_wait(&run->barrier);
+    try {
+        end = bench_time() + warmup;
+        while (bench_time() < end)
+            bench_issue(run, t, &latency);
+
+        // Every thread enters the timed window after all warmups end
+        pthread_barrier_wait(&run->barrier);
+        timed = true;
+        start = now = bench_time();
+        end = start + duration;
+        while (now < end) {
+            done = bench_issue(run, t, &latency);
+            t->ops += done;
+            // Non-blocking batches are charged evenly to their operations
+            for (uint64_t i = 0; i < done; i++)
+                bench_sample(t, latency / done);
+            now = bench_time();
+        }
+        t->elapsed = now - start;
+    } catch (Fam_Exception &e) {
+        t->error = e.fam_error_msg();
+        // Keep the other threads from waiting on this one forever
+        if (!timed)
+            pthread_barrier_wait(&run->barrier);
+    }
+    return NULL;
+}
+
+static uint64_t bench_percentile(vector<uint64_t> &samples, double pct) {
+    if (samples.empty())
+        return 0;
+    uint64_t rank = (uint64_t)(pct * (double)samples.size());
+    if (rank >= samples.size())
+        rank = samples.size() - 1;
+    return samples[rank];
+}
+
+/*
+ * Run one point of the sweep with the first numThreads of threads
+ */
+static bool bench_run(Bench_Run *run, vector<Bench_Thread> &threads,
+                      uint64_t numThreads, Bench_Result *result) {
+    vector<uint64_t> samples;
+    bool ok = true;
+
+    pthread_barrier_init(&run->barrier, NULL, (unsigned)numThreads);
+    for (uint64_t i = 0; i < numThreads; i++) {
+        Bench_Thread *t = &threads[i];
+        t->run = run;
+        t->ops = t->seen = t->elapsed = 0;
+        t->samples.clear();
+        t->error.clear();
+        pthread_create(&t->thread, NULL, bench_thread, t);
+    }
+
+    result->ops = 0;
+    result->seconds = 0;
+    for (uint64_t i = 0; i < numThreads; i++) {
+        Bench_Thread *t = &threads[i];
+        pthread_join(t->thread, NULL);
+        if (!t->error.empty()) {
+            cerr << opNames[run->op] << ": thread " << i << ": " << t->error
+                 << endl;
+            ok = false;
+        }
+        result->ops += t->ops;
+        result->seconds = max(result->seconds, (double)t->elapsed / 1e9);
+        samples.insert(samples.end(), t->samples.begin(), t->samples.end());
+    }
+    pthread_barrier_destroy(&run->barrier);
+
+    sort(samples.begin(), samples.end());
+    result->op = run->op;
+    result->nonblocking = run->nonblocking;
+    result->size = run->size;
+    result->threads = numThreads;
+    result->bytes = bench_bytes(run);
+    result->p50 = bench_percentile(samples, 0.5);
+    result->p99 = bench_percentile(samples, 0.99);
+    result->p999 = bench_percentile(samples, 0.999);
+    result->max = samples.empty() ? 0 : samples.back();
+    return ok;
+}
+
+/*
+ * Sweep every point for one context model
+ */
+static int bench_context(Bench_Config *config, const string &context,
+                         vector<Bench_Result> &results) {
+    uint64_t maxThreads =
+        *max_element(config->threads.begin(), config->threads.end());
+    uint64_t maxSize = *max_element(config->sizes.begin(), config->sizes.end());
+    uint64_t itemSize = max(maxSize, (uint64_t)sizeof(int64_t));
+    Fam_Options famOpts = config->famOpts;
+    vector<Bench_Thread> threads(maxThreads);
+    Bench_Run run;
+    int ret = 0;
+
+    famOpts.famContextModel = strdup(context == "region"
+                                         ? "FAM_CONTEXT_REGION"
+                                         : "FAM_CONTEXT_DEFAULT");
+    if (maxThreads > 1)
+        famOpts.famThreadModel = strdup("FAM_THREAD_MULTIPLE");
+
+    fam *famObj = new fam();
+    try {
+        famObj->fam_initialize("default", &famOpts);
+    } catch (Fam_Exception &e) {
+        cerr << "fam initialization failed: " << e.fam_error_msg() << endl;
+        delete famObj;
+        return -1;
+    }
+
+    run.famObj = famObj;
+    run.config = config;
+    run.regionName = get_uniq_str("fam_bench", famObj);
+    // Room for the per thread items, the in-flight copies and allocations
+    uint64_t regionSize =
+        config->regionSize
+            ? config->regionSize
+            : maxThreads * itemSize * (config->batch + 2) + (64ULL << 20);
+
+    try {
+        run.region = famObj->fam_create_region(run.regionName, regionSize,
+                                               0777, RAID1);
+        for (uint64_t i = 0; i < maxThreads; i++) {
+            Bench_Thread *t = &threads[i];
+            ostringstream name;
+            name << "fam_bench_item_" << i;
+            t->itemName = strdup(name.str().c_str());
+            t->item = famObj->fam_allocate(t->itemName, itemSize, 0777,
+                                           run.region);
+            t->local = (char *)calloc(1, itemSize);
+            t->indexes = new uint64_t[config->elements];
+            for (uint64_t e = 0; e < config->elements; e++)
+                t->indexes[e] = e;
+            t->seed = (unsigned int)(i + 1);
+        }
+    } catch (Fam_Exception &e) {
+        cerr << "fam_bench setup failed: " << e.fam_error_msg() << endl;
+        famObj->fam_finalize("default");
+        delete famObj;
+        return -1;
+    }
+
+    for (int op : config->ops) {
+        for (bool nonblocking : config->modes) {
+            // Control path operations have no non-blocking form
+            if (nonblocking && (op == BENCH_ALLOCATE || op == BENCH_LOOKUP))
+                continue;
+            for (uint64_t size : config->sizes) {
+                if ((op == BENCH_ATOMIC || op == BENCH_LOOKUP) &&
+                    size != config->sizes[0])
+                    continue;
+                for (uint64_t numThreads : config->threads) {
+                    Bench_Result result;
+                    run.op = op;
+                    run.nonblocking = nonblocking;
+                    run.size = size;
+                    cerr << "fam_bench: " << context << " " << opNames[op]
+                         << (nonblocking ? " nonblocking " : " blocking ")
+                         << bench_bytes(&run) << " bytes " << numThreads
+                         << " threads" << endl;
+                    if (!bench_run(&run, threads, numThreads, &result))
+                        ret = -1;
+                    result.context = context;
+                    results.push_back(result);
+                }
+            }
+        }
+    }
+
+    try {
+        for (uint64_t i = 0; i < maxThreads; i++) {
+            famObj->fam_deallocate(threads[i].item);
+            delete threads[i].item;
+            free((void *)threads[i].itemName);
+            free(threads[i].local);
+            delete[] threads[i].indexes;
+        }
+        famObj->fam_destroy_region(run.region);
+        delete run.region;
+    } catch (Fam_Exception &e) {
+        cerr << "fam_bench cleanup failed: " << e.fam_error_msg() << endl;
+        ret = -1;
+    }
+    free((void *)run.regionName);
+    famObj->fam_finalize("default");
+    delete famObj;
+    return ret;
+}
+
+static void bench_report(Bench_Config *config, vector<Bench_Result> &results,
+                         FILE *out) {
+    bool json = (config->format == "json");
+
+    if (json)
+        fprintf(out, "{\"results\":[");
+    else
+        fprintf(out, "context,op,mode,size,threads,ops,seconds,ops_per_sec,"
+                     "mb_per_sec,p50_ns,p99_ns,p999_ns,max_ns\n");
+    for (size_t i = 0; i < results.size(); i++) {
+        Bench_Result *r = &results[i];
+        double opsPerSec = r->seconds ? (double)r->ops / r->seconds : 0;
+        double mbPerSec = opsPerSec * (double)r->bytes / 1e6;
+        const char *mode = r->nonblocking ? "nonblocking" : "blocking";
+        if (json)
+            fprintf(out,
+                    "%s\n{\"context\":\"%s\",\"op\":\"%s\",\"mode\":\"%s\","
+                    "\"size\":%lu,\"threads\":%lu,\"ops\":%lu,"
+                    "\"seconds\":%.6f,\"ops_per_sec\":%.1f,"
+                    "\"mb_per_sec\":%.3f,\"p50_ns\":%lu,\"p99_ns\":%lu,"
+                    "\"p999_ns\":%lu,\"max_ns\":%lu}",
+                    i ? "," : "", r->context.c_str(), opNames[r->op], mode,
+                    r->bytes, r->threads, r->ops, r->seconds, opsPerSec,
+                    mbPerSec, r->p50, r->p99, r->p999, r->max);
+        else
+            fprintf(out,
+                    "%s,%s,%s,%lu,%lu,%lu,%.6f,%.1f,%.3f,%lu,%lu,%lu,%lu\n",
+                    r->context.c_str(), opNames[r->op], mode, r->bytes,
+                    r->threads, r->ops, r->seconds, opsPerSec, mbPerSec,
+                    r->p50, r->p99, r->p999, r->max);
+    }
+    if (json)
+        fprintf(out, "\n]}\n");
+}
+
+static bool parse_numbers(const char *arg, vector<uint64_t> &values) {
+    istringstream list(arg);
+    string value;
+    values.clear();
+    while (getline(list, value, ',')) {
+        char *end;
+        uint64_t number = strtoull(value.c_str(), &end, 0);
+        if (value.empty() || *end != '\0' || number == 0)
+            return false;
+        values.push_back(number);
+    }
+    return !values.empty();
+}
+
+static bool parse_names(const char *arg, vector<string> &values) {
+    istringstream list(arg);
+    string value;
+    values.clear();
+    while (getline(list, value, ','))
+        values.push_back(value);
+    return !values.empty();
+}
+
+static bool parse_config(Bench_Config *config, const char *sizes,
+                         const char *threads, const char *ops,
+                         const char *modes, const char *contexts) {
+    vector<string> names;
+
+    if (!parse_numbers(sizes, config->sizes)) {
+        cerr << "Invalid sizes: " << sizes << endl;
+        return false;
+    }
+    if (!parse_numbers(threads, config->threads)) {
+        cerr << "Invalid thread counts: " << threads << endl;
+        return false;
+    }
+
+    parse_names(ops, names);
+    for (string &name : names) {
+        int op = 0;
+        while (op < BENCH_OP_MAX && name != opNames[op])
+            op++;
+        if (op == BENCH_OP_MAX) {
+            cerr << "Invalid operation: " << name << endl;
+            return false;
+        }
+        config->ops.push_back(op);
+    }
+
+    parse_names(modes, names);
+    for (string &name : names) {
+        if (name != "blocking" && name != "nonblocking") {
+            cerr << "Invalid mode: " << name << endl;
+            return false;
+        }
+        config->modes.push_back(name == "nonblocking");
+    }
+
+    parse_names(contexts, config->contexts);
+    for (string &name : config->contexts) {
+        if (name != "default" && name != "region") {
+            cerr << "Invalid context model: " << name << endl;
+            return false;
+        }
+    }
+
+    if (config->format != "csv" && config->format != "json") {
+        cerr << "Invalid format: " << config->format << endl;
+        return false;
+    }
+    return (config->batch != 0) && (config->elements != 0);
+}
+
+static void usage() {
+    cout << "Usage : \n"
+         << "\tfam_bench <options> \n"
+         << "\t-h/--help : Display the usage\n"
+         << "\t-s/--sizes <list> : Message sizes in bytes [" BENCH_SIZES "]\n"
+         << "\t-t/--threads <list> : Thread counts [" BENCH_THREADS "]\n"
+         << "\t-o/--ops <list> : Operations [" BENCH_OPS "]\n"
+         << "\t-m/--modes <list> : Issue modes [" BENCH_MODES "]\n"
+         << "\t-c/--contexts <list> : Context models, default and/or region"
+            " [" BENCH_CONTEXTS "]\n"
+         << "\t-w/--warmup <ms> : Warmup window per point\n"
+         << "\t-d/--duration <ms> : Timed window per point\n"
+         << "\t-b/--batch <count> : Non-blocking operations per wait\n"
+         << "\t-e/--elements <count> : Elements per scatter and gather\n"
+         << "\t-f/--format <csv|json> : Output format\n"
+         << "\t--output <file> : Write results to file instead of stdout\n"
+         << "\t--region-size <bytes> : Size of the benchmark region\n"
+         << "\t--memoryserver <list> : Memory servers, eg. 0:127.0.0.1\n"
+         << "\t--grpcport <port> : Memory server RPC port\n"
+         << "\t--libfabricport <port> : Memory server libfabric port\n"
+         << "\t--provider <name> : Libfabric provider, eg. sockets\n"
+         << "\t--runtime <name> : PMIX, PMI2 or NONE\n"
+         << endl;
+}
+
+int main(int argc, char **argv) {
+    Bench_Config config;
+    const char *sizes = BENCH_SIZES;
+    const char *threads = BENCH_THREADS;
+    const char *ops = BENCH_OPS;
+    const char *modes = BENCH_MODES;
+    const char *contexts = BENCH_CONTEXTS;
+    vector<Bench_Result> results;
+    FILE *out = stdout;
+    int ret = 0;
+
+    config.warmupMs = BENCH_WARMUP_MS;
+    config.durationMs = BENCH_DURATION_MS;
+    config.batch = BENCH_BATCH;
+    config.elements = BENCH_ELEMENTS;
+    config.regionSize = 0;
+    config.format = "csv";
+    init_fam_options(&config.famOpts);
+
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "-h" || arg == "--help") {
+            usage();
+            return 0;
+        }
+        if (i + 1 >= argc) {
+            cerr << "Missing value for " << arg << endl;
+            usage();
+            return 1;
+        }
+        const char *value = argv[++i];
+        if (arg == "-s" || arg == "--sizes") {
+            sizes = value;
+        } else if (arg == "-t" || arg == "--threads") {
+            threads = value;
+        } else if (arg == "-o" || arg == "--ops") {
+            ops = value;
+        } else if (arg == "-m" || arg == "--modes") {
+            modes = value;
+        } else if (arg == "-c" || arg == "--contexts") {
+            contexts = value;
+        } else if (arg == "-w" || arg == "--warmup") {
+            config.warmupMs = strtoull(value, NULL, 0);
+        } else if (arg == "-d" || arg == "--duration") {
+            config.durationMs = strtoull(value, NULL, 0);
+        } else if (arg == "-b" || arg == "--batch") {
+            config.batch = strtoull(value, NULL, 0);
+        } else if (arg == "-e" || arg == "--elements") {
+            config.elements = strtoull(value, NULL, 0);
+        } else if (arg == "-f" || arg == "--format") {
+            config.format = value;
+        } else if (arg == "--output") {
+            config.output = value;
+        } else if (arg == "--region-size") {
+            config.regionSize = strtoull(value, NULL, 0);
+        } else if (arg == "--memoryserver") {
+            config.famOpts.memoryServer = strdup(value);
+        } else if (arg == "--grpcport") {
+            config.famOpts.grpcPort = strdup(value);
+        } else if (arg == "--libfabricport") {
+            config.famOpts.libfabricPort = strdup(value);
+        } else if (arg == "--provider") {
+            config.famOpts.libfabricProvider = strdup(value);
+        } else if (arg == "--runtime") {
+            config.famOpts.runtime = strdup(value);
+        } else {
+            cerr << "Invalid option: " << arg << endl;
+            usage();
+            return 1;
+        }
+    }
+
+    if (!parse_config(&config, sizes, threads, ops, modes, contexts)) {
+        usage();
+        return 1;
+    }
+
+    for (string &context : config.contexts) {
+        if (bench_context(&config, context, results) < 0)
+            ret = 1;
+    }
+
+    if (!config.output.empty()) {
+        out = fopen(config.output.c_str(), "w");
+        if (out == NULL) {
+            cerr << "Could not open " << config.output << endl;
+            return 1;
+        }
+    }
+    bench_report(&config, results, out);
+    if (out != stdout)
+        fclose(out);
+    return ret;
+}
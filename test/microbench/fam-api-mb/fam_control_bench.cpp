@@ -0,0 +1,761 @@
+/*
+ * fam_control_bench.cpp
+ * Copyright (c) 2019 Hewlett Packard Enterprise Development, LP. All rights
+ * reserved. Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ *    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * See https://spdx.org/licenses/BSD-3-Clause
+ *
+ */
+#include <algorithm>
+#include <grpcpp/grpcpp.h>
+#include <iostream>
+#include <pthread.h>
+#include <sstream>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+#include <vector>
+
+#include "common/fam_internal.h"
+#include "common/fam_test_config.h"
+#include "rpc/fam_rpc.grpc.pb.h"
+
+/*
+ * Defaults of the load; every one of them can be changed on the command line
+ */
+#define CTL_PROCESSES 4
+#define CTL_THREADS 16
+#define CTL_MIX                                                                \
+    "region:1,allocate:4,lookup_region:4,lookup:8,region_permission:1,"        \
+    "permission:2"
+#define CTL_WARMUP_MS 500
+#define CTL_DURATION_MS 5000
+#define CTL_ITEMS 64
+#define CTL_REGION_SIZE 1048576
+#define CTL_ITEM_SIZE 4096
+
+/*
+ * Samples kept per thread and RPC; beyond this, samples are reservoir
+ * sampled so that percentiles stay unbiased
+ */
+#define CTL_MAX_SAMPLES (1 << 18)
+
+using namespace std;
+using namespace openfam;
+
+typedef enum {
+    CTL_CREATE_REGION = 0,
+    CTL_DESTROY_REGION,
+    CTL_ALLOCATE,
+    CTL_DEALLOCATE,
+    CTL_LOOKUP_REGION,
+    CTL_LOOKUP,
+    CTL_CHANGE_REGION_PERMISSION,
+    CTL_CHANGE_DATAITEM_PERMISSION,
+    CTL_RPC_MAX
+} Ctl_Rpc;
+
+static const char *rpcNames[CTL_RPC_MAX] = {"create_region",
+                                            "destroy_region",
+                                            "allocate",
+                                            "deallocate",
+                                            "lookup_region",
+                                            "lookup",
+                                            "change_region_permission",
+                                            "change_dataitem_permission"};
+
+/*
+ * Operations of the mix; region and allocate are each a pair of RPCs that
+ * create and release what they created
+ */
+typedef enum {
+    CTL_MIX_REGION = 0,
+    CTL_MIX_ALLOCATE,
+    CTL_MIX_LOOKUP_REGION,
+    CTL_MIX_LOOKUP,
+    CTL_MIX_REGION_PERMISSION,
+    CTL_MIX_PERMISSION,
+    CTL_MIX_MAX
+} Ctl_Mix;
+
+static const char *mixNames[CTL_MIX_MAX] = {
+    "region",         "allocate",          "lookup_region",
+    "lookup",         "region_permission", "permission"};
+
+struct Ctl_Config {
+    string server;
+    uint64_t processes;
+    uint64_t threads;
+    uint64_t weights[CTL_MIX_MAX];
+    uint64_t totalWeight;
+    uint64_t warmupMs;
+    uint64_t durationMs;
+    uint64_t items;
+    uint64_t regionSize;
+    uint64_t itemSize;
+    string format;
+    string output;
+};
+
+/*
+ * Client and server side latency of one call
+ */
+struct Ctl_Sample {
+    uint64_t client;
+    uint64_t server;
+};
+
+struct Ctl_Samples {
+    uint64_t calls;
+    uint64_t errors;
+    uint64_t seen;
+    vector<Ctl_Sample> samples;
+};
+
+/*
+ * State shared by the threads of one client process
+ */
+struct Ctl_Process {
+    Ctl_Config *config;
+    std::unique_ptr<Fam_Rpc::Stub> stub;
+    pthread_barrier_t *barrier;
+    uint32_t uid;
+    uint32_t gid;
+    uint64_t regionId;
+    string regionName;
+    vector<string> itemNames;
+    vector<uint64_t> itemOffsets;
+};
+
+struct Ctl_Thread {
+    Ctl_Process *process;
+    pthread_t thread;
+    uint64_t id;
+    uint64_t serial;
+    unsigned int seed;
+    bool timed;
+    uint64_t elapsed;
+    Ctl_Samples rpcs[CTL_RPC_MAX];
+};
+
+static uint64_t ctl_time() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static uint64_t ctl_random(Ctl_Thread *t, uint64_t bound) {
+    return (((uint64_t)rand_r(&t->seed) << 31) ^ (uint64_t)rand_r(&t->seed)) %
+           bound;
+}
+
+static void ctl_sample(Ctl_Thread *t, Ctl_Samples *rpc, Ctl_Sample sample) {
+    rpc->seen++;
+    if (rpc->samples.size() < CTL_MAX_SAMPLES) {
+        rpc->samples.push_back(sample);
+        return;
+    }
+    uint64_t slot = ctl_random(t, rpc->seen);
+    if (slot < CTL_MAX_SAMPLES)
+        rpc->samples[slot] = sample;
+}
+
+/*
+ * Issue one RPC through call and, in the timed window, record its latency
+ * along with the handler time the memory server returned
+ */
+template <typename Response, typename Call>
+static bool ctl_call(Ctl_Thread *t, int rpc, Response *res, Call call) {
+    ::grpc::ClientContext ctx;
+    Ctl_Sample sample;
+
+    uint64_t start = ctl_time();
+    ::grpc::Status status = call(&ctx);
+    sample.client = ctl_time() - start;
+    bool ok = status.ok() && (res->errorcode() == 0);
+    if (!t->timed)
+        return ok;
+
+    sample.server = 0;
+    const multimap<::grpc::string_ref, ::grpc::string_ref> &trailers =
+        ctx.GetServerTrailingMetadata();
+    auto serverTime = trailers.find(FAM_RPC_SERVER_TIME_KEY);
+    if (serverTime != trailers.end())
+        sample.server = strtoull(
+            string(serverTime->second.data(), serverTime->second.size())
+                .c_str(),
+            NULL, 10);
+
+    Ctl_Samples *samples = &t->rpcs[rpc];
+    samples->calls++;
+    if (!ok)
+        samples->errors++;
+    ctl_sample(t, samples, sample);
+    return ok;
+}
+
+static void ctl_issue(Ctl_Thread *t, int op) {
+    Ctl_Process *p = t->process;
+    Fam_Rpc::Stub *stub = p->stub.get();
+    Fam_Region_Request regionReq;
+    Fam_Region_Response regionRes;
+    Fam_Dataitem_Request itemReq;
+    Fam_Dataitem_Response itemRes;
+    ostringstream name;
+    uint64_t item;
+
+    regionReq.set_uid(p->uid);
+    regionReq.set_gid(p->gid);
+    itemReq.set_uid(p->uid);
+    itemReq.set_gid(p->gid);
+
+    switch (op) {
+    case CTL_MIX_REGION:
+        name << p->regionName << "_" << t->id << "_" << t->serial++;
+        regionReq.set_name(name.str());
+        regionReq.set_size(p->config->regionSize);
+        regionReq.set_perm(0777);
+        if (!ctl_call(t, CTL_CREATE_REGION, &regionRes,
+                      [&](::grpc::ClientContext *ctx) {
+                          return stub->create_region(ctx, regionReq,
+                                                     &regionRes);
+                      }))
+            break;
+        regionReq.Clear();
+        regionReq.set_uid(p->uid);
+        regionReq.set_gid(p->gid);
+        regionReq.set_regionid(regionRes.regionid());
+        ctl_call(t, CTL_DESTROY_REGION, &regionRes,
+                 [&](::grpc::ClientContext *ctx) {
+                     return stub->destroy_region(ctx, regionReq, &regionRes);
+                 });
+        break;
+    case CTL_MIX_ALLOCATE:
+        itemReq.set_name("");
+        itemReq.set_regionid(p->regionId);
+        itemReq.set_size(p->config->itemSize);
+        itemReq.set_perm(0777);
+        itemReq.set_dup(false);
+        if (!ctl_call(t, CTL_ALLOCATE, &itemRes,
+                      [&](::grpc::ClientContext *ctx) {
+                          return stub->allocate(ctx, itemReq, &itemRes);
+                      }))
+            break;
+        itemReq.set_offset(itemRes.offset());
+        itemReq.set_key(itemRes.key());
+        ctl_call(t, CTL_DEALLOCATE, &itemRes, [&](::grpc::ClientContext *ctx) {
+            return stub->deallocate(ctx, itemReq, &itemRes);
+        });
+        break;
+    case CTL_MIX_LOOKUP_REGION:
+        regionReq.set_name(p->regionName);
+        ctl_call(t, CTL_LOOKUP_REGION, &regionRes,
+                 [&](::grpc::ClientContext *ctx) {
+                     return stub->lookup_region(ctx, regionReq, &regionRes);
+                 });
+        break;
+    case CTL_MIX_LOOKUP:
+        item = ctl_random(t, p->itemNames.size());
+        itemReq.set_name(p->itemNames[item]);
+        itemReq.set_regionname(p->regionName);
+        ctl_call(t, CTL_LOOKUP, &itemRes, [&](::grpc::ClientContext *ctx) {
+            return stub->lookup(ctx, itemReq, &itemRes);
+        });
+        break;
+    case CTL_MIX_REGION_PERMISSION:
+        regionReq.set_regionid(p->regionId);
+        regionReq.set_perm(0777);
+        ctl_call(t, CTL_CHANGE_REGION_PERMISSION, &regionRes,
+                 [&](::grpc::ClientContext *ctx) {
+                     return stub->change_region_permission(ctx, regionReq,
+                                                           &regionRes);
+                 });
+        break;
+    case CTL_MIX_PERMISSION:
+        item = ctl_random(t, p->itemOffsets.size());
+        itemReq.set_regionid(p->regionId);
+        itemReq.set_offset(p->itemOffsets[item]);
+        itemReq.set_perm(0777);
+        ctl_call(t, CTL_CHANGE_DATAITEM_PERMISSION, &itemRes,
+                 [&](::grpc::ClientContext *ctx) {
+                     return stub->change_dataitem_permission(ctx, itemReq,
+                                                             &itemRes);
+                 });
+        break;
+    }
+}
+
+/*
+ * Pick an operation of the mix in proportion to its weight
+ */
+static int ctl_pick(Ctl_Thread *t) {
+    Ctl_Config *config = t->process->config;
+    uint64_t pick = ctl_random(t, config->totalWeight);
+    int op = 0;
+    while (pick >= config->weights[op]) {
+        pick -= config->weights[op];
+        op++;
+    }
+    return op;
+}
+
+static void *ctl_thread(void *arg) {
+    Ctl_Thread *t = (Ctl_Thread *)arg;
+    Ctl_Config *config = t->process->config;
+    uint64_t start, end;
+
+    // Every thread of every process starts each window together
+    pthread_barrier_wait(t->process->barrier);
+    end = ctl_time() + config->warmupMs * 1000000ULL;
+    while (ctl_time() < end)
+        ctl_issue(t, ctl_pick(t));
+
+    pthread_barrier_wait(t->process->barrier);
+    t->timed = true;
+    start = ctl_time();
+    end = start + config->durationMs * 1000000ULL;
+    while (ctl_time() < end)
+        ctl_issue(t, ctl_pick(t));
+    t->elapsed = ctl_time() - start;
+    return NULL;
+}
+
+/*
+ * Create the region and the data items shared by the threads of a process
+ */
+static bool ctl_setup(Ctl_Process *p) {
+    Fam_Region_Request regionReq;
+    Fam_Region_Response regionRes;
+    ::grpc::ClientContext ctx;
+    ostringstream name;
+
+    name << "fam_ctl_" << getpid();
+    p->regionName = name.str();
+    regionReq.set_name(p->regionName);
+    // Room for the named items and the items of the allocate mix
+    regionReq.set_size(p->config->itemSize *
+                           (p->config->items + p->config->threads) +
+                       p->config->regionSize);
+    regionReq.set_perm(0777);
+    regionReq.set_uid(p->uid);
+    regionReq.set_gid(p->gid);
+    ::grpc::Status status = p->stub->create_region(&ctx, regionReq, &regionRes);
+    if (!status.ok() || regionRes.errorcode()) {
+        cerr << "create_region failed: "
+             << (status.ok() ? regionRes.errormsg() : status.error_message())
+             << endl;
+        return false;
+    }
+    p->regionId = regionRes.regionid();
+
+    for (uint64_t i = 0; i < p->config->items; i++) {
+        Fam_Dataitem_Request itemReq;
+        Fam_Dataitem_Response itemRes;
+        ::grpc::ClientContext itemCtx;
+        ostringstream itemName;
+        itemName << "item_" << i;
+        itemReq.set_name(itemName.str());
+        itemReq.set_regionid(p->regionId);
+        itemReq.set_size(p->config->itemSize);
+        itemReq.set_perm(0777);
+        itemReq.set_uid(p->uid);
+        itemReq.set_gid(p->gid);
+        itemReq.set_dup(false);
+        status = p->stub->allocate(&itemCtx, itemReq, &itemRes);
+        if (!status.ok() || itemRes.errorcode()) {
+            cerr << "allocate failed: "
+                 << (status.ok() ? itemRes.errormsg() : status.error_message())
+                 << endl;
+            return false;
+        }
+        p->itemNames.push_back(itemName.str());
+        p->itemOffsets.push_back(itemRes.offset());
+    }
+    return true;
+}
+
+static void ctl_teardown(Ctl_Process *p) {
+    Fam_Region_Request regionReq;
+    Fam_Region_Response regionRes;
+    ::grpc::ClientContext ctx;
+
+    regionReq.set_regionid(p->regionId);
+    regionReq.set_uid(p->uid);
+    regionReq.set_gid(p->gid);
+    p->stub->destroy_region(&ctx, regionReq, &regionRes);
+}
+
+static bool ctl_write(int fd, const void *buf, size_t len) {
+    const char *data = (const char *)buf;
+    while (len > 0) {
+        ssize_t written = write(fd, data, len);
+        if (written <= 0)
+            return false;
+        data += written;
+        len -= (size_t)written;
+    }
+    return true;
+}
+
+static bool ctl_read(int fd, void *buf, size_t len) {
+    char *data = (char *)buf;
+    while (len > 0) {
+        ssize_t got = read(fd, data, len);
+        if (got <= 0)
+            return false;
+        data += got;
+        len -= (size_t)got;
+    }
+    return true;
+}
+
+/*
+ * Body of a client process: run the threads and send their merged samples
+ * to the parent through fd
+ */
+static int ctl_process(Ctl_Config *config, pthread_barrier_t *barrier,
+                       int fd) {
+    Ctl_Process p;
+    vector<Ctl_Thread> threads(config->threads);
+    uint64_t elapsed = 0;
+    bool ready;
+
+    p.config = config;
+    p.barrier = barrier;
+    p.uid = (uint32_t)getuid();
+    p.gid = (uint32_t)getgid();
+    p.stub = Fam_Rpc::NewStub(grpc::CreateChannel(
+        config->server, ::grpc::InsecureChannelCredentials()));
+    ready = ctl_setup(&p);
+    if (!ctl_write(fd, &ready, sizeof(ready)))
+        return 1;
+    if (!ready)
+        return 1;
+
+    for (uint64_t i = 0; i < config->threads; i++) {
+        Ctl_Thread *t = &threads[i];
+        t->process = &p;
+        t->id = i;
+        t->serial = 0;
+        t->seed = (unsigned int)(getpid() * 1000 + i);
+        t->timed = false;
+        t->elapsed = 0;
+        for (int r = 0; r < CTL_RPC_MAX; r++)
+            t->rpcs[r].calls = t->rpcs[r].errors = t->rpcs[r].seen = 0;
+        pthread_create(&t->thread, NULL, ctl_thread, t);
+    }
+    for (uint64_t i = 0; i < config->threads; i++) {
+        pthread_join(threads[i].thread, NULL);
+        elapsed = max(elapsed, threads[i].elapsed);
+    }
+    ctl_teardown(&p);
+
+    ctl_write(fd, &elapsed, sizeof(elapsed));
+    for (int r = 0; r < CTL_RPC_MAX; r++) {
+        uint64_t calls = 0, errors = 0, count = 0;
+        for (uint64_t i = 0; i < config->threads; i++) {
+            calls += threads[i].rpcs[r].calls;
+            errors += threads[i].rpcs[r].errors;
+            count += threads[i].rpcs[r].samples.size();
+        }
+        ctl_write(fd, &calls, sizeof(calls));
+        ctl_write(fd, &errors, sizeof(errors));
+        ctl_write(fd, &count, sizeof(count));
+        for (uint64_t i = 0; i < config->threads; i++) {
+            vector<Ctl_Sample> &samples = threads[i].rpcs[r].samples;
+            if (!samples.empty() &&
+                !ctl_write(fd, samples.data(),
+                           samples.size() * sizeof(Ctl_Sample)))
+                return 1;
+        }
+    }
+    return 0;
+}
+
+static uint64_t ctl_percentile(vector<uint64_t> &values, double pct) {
+    if (values.empty())
+        return 0;
+    uint64_t rank = (uint64_t)(pct * (double)values.size());
+    if (rank >= values.size())
+        rank = values.size() - 1;
+    return values[rank];
+}
+
+static void ctl_report(Ctl_Config *config, double seconds,
+                       vector<Ctl_Samples> &rpcs, FILE *out) {
+    bool json = (config->format == "json");
+    bool first = true;
+
+    if (json)
+        fprintf(out, "{\"processes\":%lu,\"threads\":%lu,\"seconds\":%.6f,"
+                     "\"results\":[",
+                config->processes, config->threads, seconds);
+    else
+        fprintf(out, "rpc,calls,errors,calls_per_sec,p50_ns,p99_ns,p999_ns,"
+                     "max_ns,server_p50_ns,server_p99_ns,server_p999_ns,"
+                     "server_max_ns\n");
+    for (int r = 0; r < CTL_RPC_MAX; r++) {
+        Ctl_Samples *rpc = &rpcs[r];
+        vector<uint64_t> client, server;
+        if (rpc->calls == 0)
+            continue;
+        for (Ctl_Sample &sample : rpc->samples) {
+            client.push_back(sample.client);
+            server.push_back(sample.server);
+        }
+        sort(client.begin(), client.end());
+        sort(server.begin(), server.end());
+        double callsPerSec = seconds ? (double)rpc->calls / seconds : 0;
+        uint64_t values[8] = {ctl_percentile(client, 0.5),
+                              ctl_percentile(client, 0.99),
+                              ctl_percentile(client, 0.999),
+                              client.empty() ? 0 : client.back(),
+                              ctl_percentile(server, 0.5),
+                              ctl_percentile(server, 0.99),
+                              ctl_percentile(server, 0.999),
+                              server.empty() ? 0 : server.back()};
+        if (json)
+            fprintf(out,
+                    "%s\n{\"rpc\":\"%s\",\"calls\":%lu,\"errors\":%lu,"
+                    "\"calls_per_sec\":%.1f,\"p50_ns\":%lu,\"p99_ns\":%lu,"
+                    "\"p999_ns\":%lu,\"max_ns\":%lu,\"server_p50_ns\":%lu,"
+                    "\"server_p99_ns\":%lu,\"server_p999_ns\":%lu,"
+                    "\"server_max_ns\":%lu}",
+                    first ? "" : ",", rpcNames[r], rpc->calls, rpc->errors,
+                    callsPerSec, values[0], values[1], values[2], values[3],
+                    values[4], values[5], values[6], values[7]);
+        else
+            fprintf(out, "%s,%lu,%lu,%.1f,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu\n",
+                    rpcNames[r], rpc->calls, rpc->errors, callsPerSec,
+                    values[0], values[1], values[2], values[3], values[4],
+                    values[5], values[6], values[7]);
+        first = false;
+    }
+    if (json)
+        fprintf(out, "\n]}\n");
+}
+
+static bool parse_mix(Ctl_Config *config, const char *mix) {
+    istringstream list(mix);
+    string entry;
+
+    memset(config->weights, 0, sizeof(config->weights));
+    config->totalWeight = 0;
+    while (getline(list, entry, ',')) {
+        size_t colon = entry.find(':');
+        string name = entry.substr(0, colon);
+        uint64_t weight =
+            (colon == string::npos)
+                ? 1
+                : strtoull(entry.substr(colon + 1).c_str(), NULL, 0);
+        int op = 0;
+        while (op < CTL_MIX_MAX && name != mixNames[op])
+            op++;
+        if (op == CTL_MIX_MAX) {
+            cerr << "Invalid operation in mix: " << name << endl;
+            return false;
+        }
+        config->weights[op] = weight;
+        config->totalWeight += weight;
+    }
+    return config->totalWeight != 0;
+}
+
+static void usage() {
+    cout << "Usage : \n"
+         << "\tfam_control_bench <options> \n"
+         << "\t-h/--help : Display the usage\n"
+         << "\t-s/--server <host:port> : Memory server RPC address\n"
+         << "\t-p/--processes <count> : Client processes\n"
+         << "\t-t/--threads <count> : Threads per client process\n"
+         << "\t-m/--mix <op:weight,...> : Operations and their weights\n"
+         << "\t\t[" CTL_MIX "]\n"
+         << "\t-w/--warmup <ms> : Warmup window\n"
+         << "\t-d/--duration <ms> : Timed window\n"
+         << "\t-i/--items <count> : Data items looked up per process\n"
+         << "\t--region-size <bytes> : Size of the regions created\n"
+         << "\t--item-size <bytes> : Size of the data items allocated\n"
+         << "\t-f/--format <csv|json> : Output format\n"
+         << "\t--output <file> : Write results to file instead of stdout\n"
+         << endl;
+}
+
+int main(int argc, char **argv) {
+    Ctl_Config config;
+    const char *mix = CTL_MIX;
+    FILE *out = stdout;
+    int ret = 0;
+
+    config.server = string("127.0.0.1:") + TEST_GRPC_PORT;
+    config.processes = CTL_PROCESSES;
+    config.threads = CTL_THREADS;
+    config.warmupMs = CTL_WARMUP_MS;
+    config.durationMs = CTL_DURATION_MS;
+    config.items = CTL_ITEMS;
+    config.regionSize = CTL_REGION_SIZE;
+    config.itemSize = CTL_ITEM_SIZE;
+    config.format = "csv";
+
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "-h" || arg == "--help") {
+            usage();
+            return 0;
+        }
+        if (i + 1 >= argc) {
+            cerr << "Missing value for " << arg << endl;
+            usage();
+            return 1;
+        }
+        const char *value = argv[++i];
+        if (arg == "-s" || arg == "--server") {
+            config.server = value;
+        } else if (arg == "-p" || arg == "--processes") {
+            config.processes = strtoull(value, NULL, 0);
+        } else if (arg == "-t" || arg == "--threads") {
+            config.threads = strtoull(value, NULL, 0);
+        } else if (arg == "-m" || arg == "--mix") {
+            mix = value;
+        } else if (arg == "-w" || arg == "--warmup") {
+            config.warmupMs = strtoull(value, NULL, 0);
+        } else if (arg == "-d" || arg == "--duration") {
+            config.durationMs = strtoull(value, NULL, 0);
+        } else if (arg == "-i" || arg == "--items") {
+            config.items = strtoull(value, NULL, 0);
+        } else if (arg == "--region-size") {
+            config.regionSize = strtoull(value, NULL, 0);
+        } else if (arg == "--item-size") {
+            config.itemSize = strtoull(value, NULL, 0);
+        } else if (arg == "-f" || arg == "--format") {
+            config.format = value;
+        } else if (arg == "--output") {
+            config.output = value;
+        } else {
+            cerr << "Invalid option: " << arg << endl;
+            usage();
+            return 1;
+        }
+    }
+
+    if (!parse_mix(&config, mix) || config.processes == 0 ||
+        config.threads == 0 || config.items == 0 ||
+        (config.format != "csv" && config.format != "json")) {
+        usage();
+        return 1;
+    }
+
+    // The threads of all client processes meet at a process shared barrier
+    pthread_barrier_t *barrier = (pthread_barrier_t *)mmap(
+        NULL, sizeof(pthread_barrier_t), PROT_READ | PROT_WRITE,
+        MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (barrier == MAP_FAILED) {
+        cerr << "mmap failed" << endl;
+        return 1;
+    }
+    pthread_barrierattr_t attr;
+    pthread_barrierattr_init(&attr);
+    pthread_barrierattr_setpshared(&attr, PTHREAD_PROCESS_SHARED);
+    pthread_barrier_init(barrier, &attr,
+                         (unsigned)(config.processes * config.threads));
+
+    // No gRPC state may exist before fork, so only children create channels
+    vector<pid_t> pids;
+    vector<int> fds;
+    for (uint64_t i = 0; i < config.processes; i++) {
+        int pipeFds[2];
+        if (pipe(pipeFds) < 0) {
+            cerr << "pipe failed" << endl;
+            return 1;
+        }
+        pid_t pid = fork();
+        if (pid == 0) {
+            close(pipeFds[0]);
+            _exit(ctl_process(&config, barrier, pipeFds[1]));
+        }
+        close(pipeFds[1]);
+        pids.push_back(pid);
+        fds.push_back(pipeFds[0]);
+    }
+
+    // A process that failed to set up would leave the others at the barrier
+    for (uint64_t i = 0; i < config.processes; i++) {
+        bool ready = false;
+        if (!ctl_read(fds[i], &ready, sizeof(ready)) || !ready) {
+            cerr << "client process setup failed" << endl;
+            for (pid_t pid : pids)
+                kill(pid, SIGKILL);
+            return 1;
+        }
+    }
+
+    vector<Ctl_Samples> rpcs(CTL_RPC_MAX);
+    double seconds = 0;
+    for (int r = 0; r < CTL_RPC_MAX; r++)
+        rpcs[r].calls = rpcs[r].errors = rpcs[r].seen = 0;
+    for (uint64_t i = 0; i < config.processes; i++) {
+        uint64_t elapsed;
+        if (!ctl_read(fds[i], &elapsed, sizeof(elapsed))) {
+            ret = 1;
+            continue;
+        }
+        seconds = max(seconds, (double)elapsed / 1e9);
+        for (int r = 0; r < CTL_RPC_MAX; r++) {
+            uint64_t calls, errors, count;
+            ctl_read(fds[i], &calls, sizeof(calls));
+            ctl_read(fds[i], &errors, sizeof(errors));
+            ctl_read(fds[i], &count, sizeof(count));
+            size_t old = rpcs[r].samples.size();
+            rpcs[r].samples.resize(old + count);
+            if (count && !ctl_read(fds[i], &rpcs[r].samples[old],
+                                   count * sizeof(Ctl_Sample)))
+                ret = 1;
+            rpcs[r].calls += calls;
+            rpcs[r].errors += errors;
+        }
+        close(fds[i]);
+    }
+    for (pid_t pid : pids) {
+        int status;
+        waitpid(pid, &status, 0);
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != 0)
+            ret = 1;
+    }
+
+    if (!config.output.empty()) {
+        out = fopen(config.output.c_str(), "w");
+        if (out == NULL) {
+            cerr << "Could not open " << config.output << endl;
+            return 1;
+        }
+    }
+    ctl_report(&config, seconds, rpcs, out);
+    if (out != stdout)
+        fclose(out);
+    return ret;
+}
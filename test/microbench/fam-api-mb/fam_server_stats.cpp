@@ -0,0 +1,230 @@
+/*
+ * fam_server_stats.cpp
+ * Copyright (c) 2019 Hewlett Packard Enterprise Development, LP. All rights
+ * reserved. Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ *    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * See https://spdx.org/licenses/BSD-3-Clause
+ *
+ */
+#include <fam/fam_exception.h>
+#include <iostream>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+#include <fam/fam.h>
+
+#include "common/fam_test_config.h"
+
+using namespace std;
+using namespace openfam;
+
+/*
+ * Share of the bytes reserved for the dataitems of a region that is lost to
+ * rounding up to the object or slab class size
+ */
+static double fragmentation(Fam_Server_Region_Stats *region) {
+    if (region->reservedBytes == 0)
+        return 0;
+    return 1.0 - (double)region->allocatedBytes / (double)region->reservedBytes;
+}
+
+static void print_text(Fam_Server_Stats *stats) {
+    printf("memory server %lu: heaps %lu, memory registrations %lu, "
+           "clients %lu\n",
+           stats->memoryServerId, stats->numHeaps,
+           stats->numMemoryRegistrations, stats->numClients);
+    printf("  copies %lu in progress, %lu total; progress loops %lu\n",
+           stats->copiesInProgress, stats->numCopies, stats->progressLoops);
+    printf("  recovery %s: %lu of %lu regions, %lu failed, %lu ms\n",
+           stats->ready ? "done" : "in progress", stats->recoveredRegions,
+           stats->recoveryRegions, stats->recoveryFailures,
+           stats->recoveryNs / 1000000);
+
+    printf("  %-20s %10s %14s %14s %6s %14s %8s %8s\n", "region",
+           "dataitems", "allocated", "reserved", "frag", "unmerged", "merges",
+           "failures");
+    for (uint64_t i = 0; i < stats->numRegions; i++) {
+        Fam_Server_Region_Stats *region = &stats->regions[i];
+        printf("  %-20lu %10lu %14lu %14lu %5.1f%% %14lu %8lu %8lu\n",
+               region->regionId, region->numDataitems, region->allocatedBytes,
+               region->reservedBytes, 100 * fragmentation(region),
+               region->freedBytesSinceMerge, region->numMerges,
+               region->allocFailures);
+    }
+
+    printf("  %-32s %12s %12s %12s\n", "rpc", "calls", "avg_ns", "max_ns");
+    for (uint64_t i = 0; i < stats->numRpcs; i++) {
+        Fam_Server_Rpc_Stats *rpc = &stats->rpcs[i];
+        printf("  %-32s %12lu %12lu %12lu\n", rpc->rpc, rpc->calls,
+               rpc->calls ? rpc->totalNs / rpc->calls : 0, rpc->maxNs);
+    }
+}
+
+static void print_json(Fam_Server_Stats *stats) {
+    printf("{\"memory_server\":%lu,\"heaps\":%lu,\"memory_registrations\":%lu,"
+           "\"clients\":%lu,\"copies_in_progress\":%lu,\"copies\":%lu,"
+           "\"progress_loops\":%lu,\"ready\":%s,\"recovery_regions\":%lu,"
+           "\"recovered_regions\":%lu,\"recovery_failures\":%lu,"
+           "\"recovery_ns\":%lu,\"regions\":[",
+           stats->memoryServerId, stats->numHeaps,
+           stats->numMemoryRegistrations, stats->numClients,
+           stats->copiesInProgress, stats->numCopies, stats->progressLoops,
+           stats->ready ? "true" : "false", stats->recoveryRegions,
+           stats->recoveredRegions, stats->recoveryFailures,
+           stats->recoveryNs);
+    for (uint64_t i = 0; i < stats->numRegions; i++) {
+        Fam_Server_Region_Stats *region = &stats->regions[i];
+        printf("%s{\"region\":%lu,\"dataitems\":%lu,\"allocated_bytes\":%lu,"
+               "\"reserved_bytes\":%lu,\"fragmentation\":%.4f,"
+               "\"unmerged_bytes\":%lu,\"merges\":%lu,"
+               "\"total_merge_ns\":%lu,\"alloc_failures\":%lu}",
+               i ? "," : "", region->regionId, region->numDataitems,
+               region->allocatedBytes, region->reservedBytes,
+               fragmentation(region), region->freedBytesSinceMerge,
+               region->numMerges, region->totalMergeNs, region->allocFailures);
+    }
+    printf("],\"rpcs\":[");
+    for (uint64_t i = 0; i < stats->numRpcs; i++) {
+        Fam_Server_Rpc_Stats *rpc = &stats->rpcs[i];
+        printf("%s{\"rpc\":\"%s\",\"calls\":%lu,\"total_ns\":%lu,"
+               "\"max_ns\":%lu}",
+               i ? "," : "", rpc->rpc, rpc->calls, rpc->totalNs, rpc->maxNs);
+    }
+    printf("]}\n");
+}
+
+static void usage() {
+    cout << "Usage : \n"
+         << "\tfam_server_stats <options> \n"
+         << "\t-h/--help : Display the usage\n"
+         << "\t-s/--servers <list> : Memory server ids to query [0]\n"
+         << "\t-i/--interval <ms> : Query again every interval\n"
+         << "\t-c/--count <count> : Number of queries with an interval [1]\n"
+         << "\t-f/--format <text|json> : Output format [text]\n"
+         << "\t--memoryserver <list> : Memory servers, eg. 0:127.0.0.1\n"
+         << "\t--grpcport <port> : Memory server RPC port\n"
+         << "\t--libfabricport <port> : Memory server libfabric port\n"
+         << "\t--provider <name> : Libfabric provider, eg. sockets\n"
+         << "\t--runtime <name> : PMIX, PMI2 or NONE [NONE]\n"
+         << endl;
+}
+
+int main(int argc, char **argv) {
+    Fam_Options famOpts;
+    vector<uint64_t> servers;
+    string serverList = "0";
+    string format = "text";
+    uint64_t intervalMs = 0;
+    uint64_t count = 1;
+    int ret = 0;
+
+    init_fam_options(&famOpts);
+    famOpts.runtime = strdup("NONE");
+
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "-h" || arg == "--help") {
+            usage();
+            return 0;
+        }
+        if (i + 1 >= argc) {
+            cerr << "Missing value for " << arg << endl;
+            usage();
+            return 1;
+        }
+        const char *value = argv[++i];
+        if (arg == "-s" || arg == "--servers") {
+            serverList = value;
+        } else if (arg == "-i" || arg == "--interval") {
+            intervalMs = strtoull(value, NULL, 0);
+        } else if (arg == "-c" || arg == "--count") {
+            count = strtoull(value, NULL, 0);
+        } else if (arg == "-f" || arg == "--format") {
+            format = value;
+        } else if (arg == "--memoryserver") {
+            famOpts.memoryServer = strdup(value);
+        } else if (arg == "--grpcport") {
+            famOpts.grpcPort = strdup(value);
+        } else if (arg == "--libfabricport") {
+            famOpts.libfabricPort = strdup(value);
+        } else if (arg == "--provider") {
+            famOpts.libfabricProvider = strdup(value);
+        } else if (arg == "--runtime") {
+            famOpts.runtime = strdup(value);
+        } else {
+            cerr << "Invalid option: " << arg << endl;
+            usage();
+            return 1;
+        }
+    }
+
+    char *list = strdup(serverList.c_str());
+    for (char *token = strtok(list, ","); token; token = strtok(NULL, ","))
+        servers.push_back(strtoull(token, NULL, 0));
+    free(list);
+    if (servers.empty() || (format != "text" && format != "json") ||
+        count == 0) {
+        usage();
+        return 1;
+    }
+
+    fam *famObj = new fam();
+    try {
+        famObj->fam_initialize("default", &famOpts);
+    } catch (Fam_Exception &e) {
+        cerr << "fam initialization failed: " << e.fam_error_msg() << endl;
+        delete famObj;
+        return 1;
+    }
+
+    for (uint64_t n = 0; n < count; n++) {
+        if (n)
+            usleep((useconds_t)(intervalMs * 1000));
+        for (uint64_t server : servers) {
+            Fam_Server_Stats *stats = NULL;
+            try {
+                stats = famObj->fam_server_stats(server);
+            } catch (Fam_Exception &e) {
+                cerr << "Memory server " << server << ": "
+                     << e.fam_error_msg() << endl;
+                ret = 1;
+                continue;
+            }
+            if (format == "json")
+                print_json(stats);
+            else
+                print_text(stats);
+            famObj->fam_server_stats_free(stats);
+        }
+        fflush(stdout);
+    }
+
+    famObj->fam_finalize("default");
+    delete famObj;
+    return ret;
+}
@@ -0,0 +1,58 @@
+ #
+ # run_fam_bench.sh
+ # Copyright (c) 2019 Hewlett Packard Enterprise Development, LP. All rights
+ # reserved. Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions are met:
+ # 1. Redistributions of source code must retain the above copyright notice,
+ # this list of conditions and the following disclaimer.
+ # 2. Redistributions in binary form must reproduce the above copyright notice,
+ # this list of conditions and the following disclaimer in the documentation
+ # and/or other materials provided with the distribution.
+ # 3. Neither the name of the copyright holder nor the names of its contributors
+ # may be used to endorse or promote products derived from this software without
+ # specific prior written permission.
+ #
+ #    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ # IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ # ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ # LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ # CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ # SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ #    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ # CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ # ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ # POSSIBILITY OF SUCH DAMAGE.
+ #
+ # See https://spdx.org/licenses/BSD-3-Clause
+ #
+ #
+
+#!/bin/bash
+
+if [ $# -lt 2 ]
+then
+echo "Error: Base dir or result file not specified."
+echo "usage: ./run_fam_bench.sh <base_dir> <result_file> [fam_bench options]"
+exit 1
+fi
+
+base_dir=$1
+result_file=$2
+shift 2
+build_dir=${base_dir}/build/build-rpc
+
+#Start a memory server on this host with the sockets provider
+pkill memoryserver
+${build_dir}/src/memoryserver -m 127.0.0.1 -r 8787 -l 7500 -p sockets &
+server=$!
+sleep 2
+
+${build_dir}/test/microbench/fam-api-mb/fam_bench --memoryserver 0:127.0.0.1 \
+	--grpcport 8787 --libfabricport 7500 --provider sockets --runtime NONE \
+	--output $result_file "$@"
+ret=$?
+
+kill $server
+wait
+exit $ret
@@ -0,0 +1,118 @@
+/*
+ * fam_map_memserver_reg_test.cpp
+ * Copyright (c) 2019 Hewlett Packard Enterprise Development, LP. All rights
+ * reserved. Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ *    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * See https://spdx.org/licenses/BSD-3-Clause
+ *
+ */
+#include <fam/fam_exception.h>
+#include <gtest/gtest.h>
+#include <iostream>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <fam/fam.h>
+
+#include "common/fam_test_config.h"
+
+using namespace std;
+using namespace openfam;
+
+fam *my_fam;
+Fam_Options fam_opts;
+
+// Test case 1 - data put into FAM is visible through the mapping, and
+// stores to the mapping reach FAM once the PE quiets.
+TEST(FamMapMemserver, LoadStoreSuccess) {
+    Fam_Region_Descriptor *desc;
+    Fam_Descriptor *item;
+    const char *testRegion = get_uniq_str("test", my_fam);
+    const char *firstItem = get_uniq_str("first", my_fam);
+    // Span several pages and end part way into the last one
+    uint64_t itemSize = 5 * sysconf(_SC_PAGESIZE) + 100;
+    char *local = (char *)malloc(itemSize);
+    char *local2 = (char *)malloc(itemSize);
+    char *base = NULL;
+
+    EXPECT_NO_THROW(desc = my_fam->fam_create_region(testRegion, 1048576,
+                                                     0777, RAID1));
+    EXPECT_NE((void *)NULL, desc);
+
+    EXPECT_NO_THROW(item =
+                        my_fam->fam_allocate(firstItem, itemSize, 0777, desc));
+    EXPECT_NE((void *)NULL, item);
+
+    for (uint64_t i = 0; i < itemSize; i++)
+        local[i] = (char)(i % 251);
+    EXPECT_NO_THROW(my_fam->fam_put_blocking(local, item, 0, itemSize));
+
+    EXPECT_NO_THROW(base = (char *)my_fam->fam_map(item));
+    EXPECT_NE((void *)NULL, base);
+    EXPECT_EQ(0, memcmp(local, base, itemSize));
+
+    for (uint64_t i = 0; i < itemSize; i += 1000)
+        base[i] = 'x';
+    EXPECT_NO_THROW(my_fam->fam_quiet());
+
+    EXPECT_NO_THROW(my_fam->fam_get_blocking(local2, item, 0, itemSize));
+    EXPECT_EQ(0, memcmp(base, local2, itemSize));
+
+    // Stores made just before unmap are written back by it
+    base[itemSize - 1] = 'y';
+    EXPECT_NO_THROW(my_fam->fam_unmap(base, item));
+    EXPECT_NO_THROW(my_fam->fam_get_blocking(local2, item, itemSize - 1, 1));
+    EXPECT_EQ('y', local2[0]);
+
+    EXPECT_NO_THROW(my_fam->fam_deallocate(item));
+    EXPECT_NO_THROW(my_fam->fam_destroy_region(desc));
+
+    delete item;
+    delete desc;
+
+    free(local);
+    free(local2);
+    free((void *)testRegion);
+    free((void *)firstItem);
+}
+
+int main(int argc, char **argv) {
+    int ret;
+    ::testing::InitGoogleTest(&argc, argv);
+
+    my_fam = new fam();
+
+    init_fam_options(&fam_opts);
+    // The pager serves faults alongside the threads of the application
+    fam_opts.famThreadModel = strdup("FAM_THREAD_MULTIPLE");
+
+    EXPECT_NO_THROW(my_fam->fam_initialize("default", &fam_opts));
+
+    ret = RUN_ALL_TESTS();
+
+    EXPECT_NO_THROW(my_fam->fam_finalize("default"));
+
+    return ret;
+}
@@ -0,0 +1,148 @@
+/*
+ * memserver_heap_maintainer_test.cpp
+ * Copyright (c) 2019 Hewlett Packard Enterprise Development, LP. All rights
+ * reserved. Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ *    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * See https://spdx.org/licenses/BSD-3-Clause
+ *
+ */
+#include <iostream>
+#include <stdint.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <vector>
+
+#include "allocator/memserver_allocator.h"
+
+using namespace std;
+using namespace openfam;
+
+#define MAINT_TEST_REGION "heap_maintainer_test_region"
+#define MAINT_TEST_REGION_SIZE (4 * MIN_REGION_SIZE)
+#define MAINT_TEST_ITEM_SIZE (64 * 1024)
+
+static bool get_stats(Memserver_Allocator *allocator, uint64_t regionId,
+                      Heap_Maintenance_Stats &stats) {
+    std::vector<Heap_Maintenance_Stats> heapStats;
+    allocator->get_heap_stats(heapStats);
+    for (auto entry : heapStats) {
+        if (entry.regionId == regionId) {
+            stats = entry;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * 1. Fill a region with dataitems until an allocation fails. The failing
+ *    allocation merges the heap and retries once before it fails.
+ * 2. Deallocate all dataitems, which fragments the heap. The maintenance
+ *    thread must merge the free space in the background.
+ * 3. Allocate a dataitem of half the region, which only fits after the
+ *    merge, without any further allocation failure.
+ */
+int main() {
+    uint32_t uid = (uint32_t)getuid();
+    uint32_t gid = (uint32_t)getgid();
+    uint64_t regionId;
+    std::vector<uint64_t> offsets;
+    Heap_Maintenance_Stats stats;
+    int ret = 0;
+
+    Memserver_Allocator *allocator = new Memserver_Allocator();
+    try {
+        allocator->create_region(MAINT_TEST_REGION, regionId,
+                                 MAINT_TEST_REGION_SIZE, 0777, uid, gid);
+    } catch (Memserver_Exception &e) {
+        cout << "create region failed: " << e.fam_error_msg() << endl;
+        exit(1);
+    }
+
+    while (true) {
+        uint64_t offset;
+        Fam_DataItem_Metadata dataitem;
+        void *local;
+        try {
+            allocator->allocate("", regionId, MAINT_TEST_ITEM_SIZE, offset,
+                                0777, uid, gid, dataitem, local);
+        } catch (Memserver_Exception &e) {
+            break;
+        }
+        offsets.push_back(offset);
+    }
+    if (!get_stats(allocator, regionId, stats) || (stats.allocFailures != 1)) {
+        cout << "failed allocation not reported" << endl;
+        ret = -1;
+    } else if (stats.numMerges + stats.numMergeFailures == 0) {
+        cout << "failed allocation did not merge the heap" << endl;
+        ret = -1;
+    }
+    cout << offsets.size() << " dataitems allocated" << endl;
+
+    uint64_t mergesBefore = stats.numMerges;
+    try {
+        for (auto offset : offsets)
+            allocator->deallocate(regionId, offset, uid, gid);
+
+        // Blocks freed after the last fragmentation merge are merged once
+        // the heap is idle
+        uint64_t waitedMs = 0;
+        while (get_stats(allocator, regionId, stats) &&
+               (stats.freedBytesSinceMerge != 0) &&
+               (waitedMs < 2 * HEAP_MAINT_IDLE_MS)) {
+            usleep(10000);
+            waitedMs += 10;
+        }
+        if ((stats.numMerges == mergesBefore) ||
+            (stats.freedBytesSinceMerge != 0)) {
+            cout << "fragmented heap not merged after " << waitedMs << " ms"
+                 << endl;
+            ret = -1;
+        }
+
+        uint64_t offset;
+        Fam_DataItem_Metadata dataitem;
+        void *local;
+        allocator->allocate("", regionId, MAINT_TEST_REGION_SIZE / 2, offset,
+                            0777, uid, gid, dataitem, local);
+        allocator->deallocate(regionId, offset, uid, gid);
+        if (get_stats(allocator, regionId, stats) &&
+            (stats.allocFailures != 1)) {
+            cout << "allocation failed after the merge" << endl;
+            ret = -1;
+        }
+
+        allocator->destroy_region(regionId, uid, gid);
+    } catch (Memserver_Exception &e) {
+        cout << "heap maintainer test failed: " << e.fam_error_msg() << endl;
+        ret = -1;
+    }
+    allocator->memserver_allocator_finalize();
+    delete allocator;
+
+    if (ret == 0)
+        cout << "heap maintainer test passed" << endl;
+    return ret;
+}
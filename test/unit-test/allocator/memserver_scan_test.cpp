@@ -0,0 +1,115 @@
+/*
+ * memserver_scan_test.cpp
+ * Copyright (c) 2019 Hewlett Packard Enterprise Development, LP. All rights
+ * reserved. Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ *    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * See https://spdx.org/licenses/BSD-3-Clause
+ *
+ */
+#include <iostream>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "allocator/memserver_allocator.h"
+
+using namespace std;
+using namespace openfam;
+
+#define SCAN_TEST_REGION "scan_test_region"
+#define SCAN_TEST_RECORDS 1024
+
+/**
+ * 1. Create a region and a dataitem of 64-bit records.
+ * 2. Scan with an output that is not one of the Fam_Scan_Output values,
+ *    and check that the memory server rejects it as an invalid argument
+ *    rather than sizing results from it.
+ * 3. Check that a valid count scan of the same records still succeeds.
+ * 4. Deallocate the dataitem and destroy the region.
+ */
+int main() {
+    uint32_t uid = (uint32_t)getuid();
+    uint32_t gid = (uint32_t)getgid();
+    uint64_t regionId, offset, matches = 0;
+    Fam_DataItem_Metadata dataitem;
+    void *local;
+    int ret = 0;
+
+    Fam_Scan_Predicate predicate;
+    memset(&predicate, 0, sizeof(predicate));
+    predicate.combine = FAM_SCAN_AND;
+    predicate.numTerms = 1;
+    predicate.terms[0].fieldOffset = 0;
+    predicate.terms[0].type = FAM_UINT64;
+    predicate.terms[0].op = FAM_CMP_LT;
+    predicate.terms[0].value.u64 = SCAN_TEST_RECORDS / 2;
+
+    Memserver_Allocator *allocator = new Memserver_Allocator();
+    try {
+        allocator->create_region(SCAN_TEST_REGION, regionId, 8 * 1024 * 1024,
+                                 0777, uid, gid);
+        allocator->allocate("", regionId, SCAN_TEST_RECORDS * sizeof(uint64_t),
+                            offset, 0777, uid, gid, dataitem, local);
+        for (uint64_t i = 0; i < SCAN_TEST_RECORDS; i++)
+            ((uint64_t *)local)[i] = i;
+    } catch (Memserver_Exception &e) {
+        cout << "scan test setup failed: " << e.fam_error_msg() << endl;
+        exit(1);
+    }
+
+    try {
+        allocator->scan(regionId, offset, 0, sizeof(uint64_t),
+                        SCAN_TEST_RECORDS, &predicate, (Fam_Scan_Output)7,
+                        regionId, offset, 0, uid, gid, &matches);
+        cout << "scan with an invalid output succeeded" << endl;
+        ret = 1;
+    } catch (Memserver_Exception &e) {
+        if (e.fam_error() != FAM_ERR_INVALID) {
+            cout << "unexpected error: " << e.fam_error_msg() << endl;
+            ret = 1;
+        }
+    }
+
+    try {
+        allocator->scan(regionId, offset, 0, sizeof(uint64_t),
+                        SCAN_TEST_RECORDS, &predicate, FAM_SCAN_COUNT, 0, 0,
+                        0, uid, gid, &matches);
+        if (matches != SCAN_TEST_RECORDS / 2) {
+            cout << "count scan matched " << matches << endl;
+            ret = 1;
+        }
+        allocator->deallocate(regionId, offset, uid, gid);
+        allocator->destroy_region(regionId, uid, gid);
+    } catch (Memserver_Exception &e) {
+        cout << "scan test failed: " << e.fam_error_msg() << endl;
+        ret = 1;
+    }
+    allocator->memserver_allocator_finalize();
+    delete allocator;
+
+    if (ret == 0)
+        cout << "scan output test passed" << endl;
+    return ret;
+}
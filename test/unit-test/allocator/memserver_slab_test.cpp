@@ -0,0 +1,150 @@
+/*
+ * memserver_slab_test.cpp
+ * Copyright (c) 2019 Hewlett Packard Enterprise Development, LP. All rights
+ * reserved. Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ *    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * See https://spdx.org/licenses/BSD-3-Clause
+ *
+ */
+#include <iostream>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <vector>
+
+#include "allocator/memserver_allocator.h"
+
+using namespace std;
+using namespace openfam;
+
+#define SLAB_TEST_REGION "slab_test_region"
+#define SLAB_TEST_ITEMS (4 * SLAB_CACHE_MAX)
+#define SLAB_TEST_SIZE 200
+
+static uint64_t allocate_items(Memserver_Allocator *allocator,
+                               uint64_t regionId, uint32_t uid, uint32_t gid,
+                               std::vector<uint64_t> &offsets) {
+    for (int i = 0; i < SLAB_TEST_ITEMS; i++) {
+        uint64_t offset;
+        Fam_DataItem_Metadata dataitem;
+        void *local;
+        allocator->allocate("", regionId, SLAB_TEST_SIZE, offset, 0777, uid,
+                            gid, dataitem, local);
+        memset(local, (int)(offset / MIN_OBJ_SIZE) & 0xff, SLAB_TEST_SIZE);
+        offsets.push_back(offset);
+    }
+    return offsets.size();
+}
+
+static bool check_item(Memserver_Allocator *allocator, uint64_t regionId,
+                       uint64_t offset) {
+    char *local = (char *)allocator->get_local_pointer(regionId, offset);
+    for (int i = 0; i < SLAB_TEST_SIZE; i++) {
+        if (local[i] != (char)((offset / MIN_OBJ_SIZE) & 0xff))
+            return false;
+    }
+    return true;
+}
+
+/**
+ * 1. Create a region and allocate small dataitems, which are served from
+ *    the slabs of the region.
+ * 2. Deallocate every other dataitem and close the allocator.
+ * 3. Reopen the allocator, so that the slabs of the region are recovered
+ *    from the slab directory.
+ * 4. Check that the remaining dataitems and their data are intact.
+ * 5. Allocate again and check that no live dataitem is handed out twice.
+ * 6. Deallocate all dataitems and destroy the region.
+ */
+int main() {
+    uint32_t uid = (uint32_t)getuid();
+    uint32_t gid = (uint32_t)getgid();
+    uint64_t regionId;
+    std::vector<uint64_t> offsets, live;
+
+    Memserver_Allocator *allocator = new Memserver_Allocator(true);
+    try {
+        allocator->create_region(SLAB_TEST_REGION, regionId, 8 * 1024 * 1024,
+                                 0777, uid, gid);
+        allocate_items(allocator, regionId, uid, gid, offsets);
+        for (size_t i = 0; i < offsets.size(); i++) {
+            if (i % 2)
+                allocator->deallocate(regionId, offsets[i], uid, gid);
+            else
+                live.push_back(offsets[i]);
+        }
+    } catch (Memserver_Exception &e) {
+        cout << "slab allocation failed: " << e.fam_error_msg() << endl;
+        exit(1);
+    }
+    allocator->memserver_allocator_finalize();
+    delete allocator;
+
+    // Reopen the region and recover its slabs
+    allocator = new Memserver_Allocator(true);
+    try {
+        for (auto offset : live) {
+            Fam_DataItem_Metadata dataitem;
+            allocator->get_dataitem(regionId, offset, uid, gid, dataitem);
+            if (!check_item(allocator, regionId, offset)) {
+                cout << "dataitem at 0x" << hex << offset
+                     << " changed after recovery" << endl;
+                exit(1);
+            }
+        }
+
+        offsets.clear();
+        allocate_items(allocator, regionId, uid, gid, offsets);
+        for (auto offset : offsets) {
+            for (auto liveOffset : live) {
+                if (offset == liveOffset) {
+                    cout << "live dataitem at 0x" << hex << offset
+                         << " allocated again after recovery" << endl;
+                    exit(1);
+                }
+            }
+        }
+        for (auto offset : live) {
+            if (!check_item(allocator, regionId, offset)) {
+                cout << "dataitem at 0x" << hex << offset
+                     << " overwritten after recovery" << endl;
+                exit(1);
+            }
+        }
+
+        offsets.insert(offsets.end(), live.begin(), live.end());
+        for (auto offset : offsets)
+            allocator->deallocate(regionId, offset, uid, gid);
+        allocator->destroy_region(regionId, uid, gid);
+    } catch (Memserver_Exception &e) {
+        cout << "slab recovery failed: " << e.fam_error_msg() << endl;
+        exit(1);
+    }
+    allocator->memserver_allocator_finalize();
+    delete allocator;
+
+    cout << "slab recovery test passed" << endl;
+    return 0;
+}
@@ -40,10 +40,37 @@
 #include <pthread.h>
 #include <sys/types.h>
 #include <sys/syscall.h>
+#include <time.h>
 
 using namespace std;
 
+/*
+ * Throughput benchmark: BENCH_THREADS threads (or argv[1]) repeatedly
+ * reserve and release bits of a bitmap of at least BENCH_WORDS words, of
+ * which BENCH_FILL_PERCENT are kept permanently allocated. Each thread
+ * holds up to BENCH_HOLD bits at a time; the bitmap is grown so that twice
+ * the bits held by all threads remain free. Every reserved bit is checked
+ * to be owned by a single thread.
+ */
+#define BENCH_THREADS 4
+#define BENCH_MAX_THREADS 64
+#define BENCH_WORDS 256
+#define BENCH_FILL_PERCENT 90
+#define BENCH_ITERATIONS 200000
+#define BENCH_HOLD 32
+#define BENCH_FREE_WORDS(threads)                                              \
+    ((2 * (threads)*BENCH_HOLD * 100 / (100 - BENCH_FILL_PERCENT) +            \
+      BITSIZE - 1) /                                                           \
+     BITSIZE)
+#define BENCH_MAX_WORDS                                                        \
+    (BENCH_FREE_WORDS(BENCH_MAX_THREADS) > BENCH_WORDS                         \
+         ? BENCH_FREE_WORDS(BENCH_MAX_THREADS)                                 \
+         : BENCH_WORDS)
+
 bitmap *bmap = new bitmap();
+bitmap *benchBmap = new bitmap();
+int64_t benchBuf[BENCH_MAX_WORDS];
+uint64_t benchOwner[BENCH_MAX_WORDS * BITSIZE];
 
 void *worker1(void *vargp) {
 
@@ -110,6 +137,93 @@ void *worker2(void *vargp) {
     pthread_exit(NULL);
 }
 
+void *bench_worker(void *vargp) {
+    uint64_t self = (uint64_t)vargp + 1;
+    int64_t held[BENCH_HOLD];
+
+    for (uint64_t i = 0; i < BENCH_ITERATIONS; i++) {
+        // Release the oldest bit held by this thread
+        if (i >= BENCH_HOLD) {
+            int64_t pos = held[i % BENCH_HOLD];
+            __sync_lock_release(&benchOwner[pos]);
+            bitmap_reset(benchBmap, pos);
+        }
+
+        int64_t pos = bitmap_find_and_reserve(benchBmap, 0, 0);
+        if (pos == -1) {
+            cout << syscall(SYS_gettid) << ": failed to get free bitmap"
+                 << endl;
+            return (void *)-1;
+        }
+        if (!__sync_bool_compare_and_swap(&benchOwner[pos], 0, self)) {
+            cout << syscall(SYS_gettid) << ": bit " << pos
+                 << " reserved twice" << endl;
+            return (void *)-1;
+        }
+        held[i % BENCH_HOLD] = pos;
+    }
+
+    for (uint64_t i = 0; i < BENCH_HOLD; i++) {
+        __sync_lock_release(&benchOwner[held[i]]);
+        bitmap_reset(benchBmap, held[i]);
+    }
+    return NULL;
+}
+
+int run_benchmark(int numThreads) {
+    pthread_t threads[BENCH_MAX_THREADS];
+    struct timespec begin, end;
+    int ret = 0;
+    uint64_t numWords = BENCH_FREE_WORDS((uint64_t)numThreads);
+    if (numWords < BENCH_WORDS)
+        numWords = BENCH_WORDS;
+
+    benchBmap->size = numWords * sizeof(int64_t);
+    benchBmap->map = benchBuf;
+    if (bitmap_init(benchBmap)) {
+        cout << "bitmap initialization failed" << endl;
+        return -1;
+    }
+
+    // Keep a scattered part of the bitmap allocated, so that the searches
+    // have to skip full and partially full words
+    srand(1);
+    for (uint64_t i = 0; i < numWords * BITSIZE; i++) {
+        if ((uint64_t)(rand() % 100) < BENCH_FILL_PERCENT) {
+            bitmap_set(benchBmap, i);
+            benchOwner[i] = BENCH_MAX_THREADS + 1;
+        }
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &begin);
+    for (int i = 0; i < numThreads; i++) {
+        int pret = pthread_create(&threads[i], NULL, bench_worker,
+                                  (void *)(uint64_t)i);
+        if (pret) {
+            cout << "pthread_create() return code: " << pret << endl;
+            exit(1);
+        }
+    }
+    for (int i = 0; i < numThreads; i++) {
+        void *result;
+        pthread_join(threads[i], &result);
+        if (result != NULL)
+            ret = -1;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    double elapsed = (double)(end.tv_sec - begin.tv_sec) +
+                     (double)(end.tv_nsec - begin.tv_nsec) / 1e9;
+    double ops = (double)numThreads * BENCH_ITERATIONS;
+    cout << "bitmap_find_and_reserve: " << numThreads << " threads, "
+         << numWords * BITSIZE << " bits, " << BENCH_FILL_PERCENT
+         << "% full: " << (uint64_t)(ops / elapsed) << " reservations/sec"
+         << endl;
+
+    bitmap_free(benchBmap);
+    return ret;
+}
+
 int main(int argc, char *argv[]) {
 
     int ret;
@@ -147,6 +261,15 @@ int main(int argc, char *argv[]) {
        return -1;
     }
 
-    return 0;
+    int numThreads = BENCH_THREADS;
+    if (argc > 1)
+        numThreads = atoi(argv[1]);
+    if ((numThreads < 1) || (numThreads > BENCH_MAX_THREADS)) {
+        cout << "Number of threads must be between 1 and "
+             << BENCH_MAX_THREADS << endl;
+        return -1;
+    }
+
+    return run_benchmark(numThreads);
 
 }
@@ -0,0 +1,170 @@
+/*
+ * fam_allocate_local_pool.cpp
+ * Copyright (c) 2019 Hewlett Packard Enterprise Development, LP. All rights
+ * reserved. Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ *    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * See https://spdx.org/licenses/BSD-3-Clause
+ *
+ */
+#include <fam/fam_exception.h>
+#include <iostream>
+#include <stdio.h>
+#include <string.h>
+
+#include <fam/fam.h>
+
+#include "common/fam_test_config.h"
+
+#define NUM_ITEMS 16
+#define ITEM_SIZE 100
+
+using namespace std;
+using namespace openfam;
+
+int main() {
+    fam *my_fam = new fam();
+    Fam_Options fam_opts;
+    Fam_Region_Descriptor *desc;
+    Fam_Descriptor *item[NUM_ITEMS];
+    int ret = 0;
+
+    memset((void *)&fam_opts, 0, sizeof(Fam_Options));
+
+    fam_opts.memoryServer = strdup(TEST_MEMORY_SERVER);
+    fam_opts.grpcPort = strdup(TEST_GRPC_PORT);
+    fam_opts.libfabricPort = strdup(TEST_LIBFABRIC_PORT);
+    fam_opts.allocator = strdup(TEST_ALLOCATOR);
+    // Small chunks, so that the items span more than one chunk
+    fam_opts.localPoolChunkSize = strdup("1024");
+
+    if (my_fam->fam_initialize("default", &fam_opts) < 0) {
+        cout << "fam initialization failed" << endl;
+        exit(1);
+    } else {
+        cout << "fam initialization successful" << endl;
+    }
+
+    desc = my_fam->fam_create_region("test", 1048576, 0777, RAID1);
+    if (desc == NULL) {
+        cout << "fam create region failed" << endl;
+        exit(1);
+    }
+
+    try {
+        // Allocating data items from the local pool
+        for (int i = 0; i < NUM_ITEMS; i++) {
+            item[i] = my_fam->fam_allocate_local_pool(ITEM_SIZE, 0777, desc);
+            if (item[i] == NULL) {
+                cout << "fam allocation from local pool failed" << endl;
+                exit(1);
+            }
+        }
+
+        for (int i = 0; i < NUM_ITEMS; i++) {
+            char local[ITEM_SIZE];
+            memset(local, 'a' + i, ITEM_SIZE);
+            my_fam->fam_put_blocking(local, item[i], 0, ITEM_SIZE);
+        }
+
+        // Items must not overlap within a chunk
+        for (int i = 0; i < NUM_ITEMS; i++) {
+            char local[ITEM_SIZE], expected[ITEM_SIZE];
+            memset(expected, 'a' + i, ITEM_SIZE);
+            my_fam->fam_get_blocking(local, item[i], 0, ITEM_SIZE);
+            if (memcmp(local, expected, ITEM_SIZE) != 0) {
+                cout << "Read and Written Data are different for item " << i
+                     << endl;
+                ret = -1;
+            }
+        }
+
+        // Deallocating data items, which returns the exhausted chunks to
+        // the memory server
+        for (int i = 0; i < NUM_ITEMS; i++)
+            my_fam->fam_deallocate(item[i]);
+
+        // New chunks may be leased at the offsets of the returned ones.
+        // Deallocating an item must not release the rest of its chunk.
+        for (int i = 0; i < NUM_ITEMS; i++) {
+            char local[ITEM_SIZE];
+            item[i] = my_fam->fam_allocate_local_pool(ITEM_SIZE, 0777, desc);
+            memset(local, 'A' + i, ITEM_SIZE);
+            my_fam->fam_put_blocking(local, item[i], 0, ITEM_SIZE);
+        }
+        for (int i = 0; i < NUM_ITEMS; i += 2)
+            my_fam->fam_deallocate(item[i]);
+
+        Fam_Descriptor *other[NUM_ITEMS];
+        for (int i = 0; i < NUM_ITEMS; i++) {
+            char local[ITEM_SIZE * 8];
+            other[i] = my_fam->fam_allocate(ITEM_SIZE * 8, 0777, desc);
+            memset(local, 'z', ITEM_SIZE * 8);
+            my_fam->fam_put_blocking(local, other[i], 0, ITEM_SIZE * 8);
+        }
+        for (int i = 1; i < NUM_ITEMS; i += 2) {
+            char local[ITEM_SIZE], expected[ITEM_SIZE];
+            memset(expected, 'A' + i, ITEM_SIZE);
+            my_fam->fam_get_blocking(local, item[i], 0, ITEM_SIZE);
+            if (memcmp(local, expected, ITEM_SIZE) != 0) {
+                cout << "Item " << i << " overwritten after its chunk was "
+                     << "leased again" << endl;
+                ret = -1;
+            }
+        }
+
+        // Operations on whole data items are rejected for pool items
+        try {
+            my_fam->fam_change_permissions(item[1], 0444);
+            cout << "fam_change_permissions accepted a local pool item"
+                 << endl;
+            ret = -1;
+        } catch (Fam_Exception &e) {
+        }
+
+        for (int i = 0; i < NUM_ITEMS; i++)
+            my_fam->fam_deallocate(other[i]);
+        for (int i = 1; i < NUM_ITEMS; i += 2)
+            my_fam->fam_deallocate(item[i]);
+
+        // Deallocating an item again is an error
+        try {
+            my_fam->fam_deallocate(item[1]);
+            cout << "pool item deallocated twice" << endl;
+            ret = -1;
+        } catch (Fam_Exception &e) {
+        }
+    } catch (Fam_Exception &e) {
+        cout << "Exception caught" << endl;
+        cout << "Error msg: " << e.fam_error_msg() << endl;
+        cout << "Error: " << e.fam_error() << endl;
+        ret = -1;
+    }
+
+    // Destroying the region
+    my_fam->fam_destroy_region(desc);
+
+    my_fam->fam_finalize("default");
+    cout << "fam finalize successful" << endl;
+    return ret;
+}
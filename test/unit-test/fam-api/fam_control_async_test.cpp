@@ -0,0 +1,141 @@
+/*
+ * fam_control_async_test.cpp
+ * Copyright (c) 2019 Hewlett Packard Enterprise Development, LP. All rights
+ * reserved. Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ *    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * See https://spdx.org/licenses/BSD-3-Clause
+ *
+ */
+#include <fam/fam_exception.h>
+#include <iostream>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+
+#include <fam/fam.h>
+
+#include "common/fam_test_config.h"
+
+#define NUM_ITEMS 32
+
+using namespace std;
+using namespace openfam;
+
+int main() {
+    fam *my_fam = new fam();
+    Fam_Options fam_opts;
+    Fam_Region_Descriptor *desc;
+    Fam_Async_Handle *handles[NUM_ITEMS];
+    Fam_Descriptor *items[NUM_ITEMS];
+    int ret = 0;
+
+    memset((void *)&fam_opts, 0, sizeof(Fam_Options));
+
+    fam_opts.memoryServer = strdup(TEST_MEMORY_SERVER);
+    fam_opts.grpcPort = strdup(TEST_GRPC_PORT);
+    fam_opts.libfabricPort = strdup(TEST_LIBFABRIC_PORT);
+    fam_opts.allocator = strdup(TEST_ALLOCATOR);
+
+    if (my_fam->fam_initialize("default", &fam_opts) < 0) {
+        cout << "fam initialization failed" << endl;
+        exit(1);
+    } else {
+        cout << "fam initialization successful" << endl;
+    }
+
+    desc = my_fam->fam_create_region("test", 8388608, 0777, RAID1);
+    if (desc == NULL) {
+        cout << "fam create region failed" << endl;
+        exit(1);
+    }
+
+    try {
+        // All allocations are in flight before the first is waited for
+        for (int i = 0; i < NUM_ITEMS; i++) {
+            string name = "async_item" + to_string(i);
+            handles[i] =
+                my_fam->fam_allocate_async(name.c_str(), 1024, 0777, desc);
+        }
+        for (int i = 0; i < NUM_ITEMS; i++)
+            items[i] = my_fam->fam_async_wait(handles[i]);
+
+        // Lookups find the items just allocated
+        for (int i = 0; i < NUM_ITEMS; i++) {
+            string name = "async_item" + to_string(i);
+            handles[i] = my_fam->fam_lookup_async(name.c_str(), "test");
+        }
+        for (int i = 0; i < NUM_ITEMS; i++) {
+            Fam_Descriptor *item = my_fam->fam_async_wait(handles[i]);
+            Fam_Global_Descriptor expected = items[i]->get_global_descriptor();
+            Fam_Global_Descriptor found = item->get_global_descriptor();
+            if ((item->get_size() != 1024) ||
+                (expected.regionId != found.regionId) ||
+                (expected.offset != found.offset)) {
+                cout << "Lookup of item " << i << " found another item"
+                     << endl;
+                ret = -1;
+            }
+            delete item;
+        }
+
+        for (int i = 0; i < NUM_ITEMS; i++)
+            handles[i] = my_fam->fam_deallocate_async(items[i]);
+        for (int i = 0; i < NUM_ITEMS; i++) {
+            if (my_fam->fam_async_wait(handles[i]) != NULL) {
+                cout << "Deallocation returned a descriptor" << endl;
+                ret = -1;
+            }
+            delete items[i];
+        }
+
+        // Errors of the memory server are thrown by fam_async_wait
+        Fam_Async_Handle *handle =
+            my_fam->fam_lookup_async("async_item0", "test");
+        while (!my_fam->fam_async_test(handle))
+            ;
+        try {
+            my_fam->fam_async_wait(handle);
+            cout << "Lookup of a deallocated item succeeded" << endl;
+            ret = -1;
+        } catch (Fam_Exception &e) {
+            if (e.fam_error() != FAM_ERR_NOTFOUND) {
+                cout << "Unexpected error: " << e.fam_error_msg() << endl;
+                ret = -1;
+            }
+        }
+    } catch (Fam_Exception &e) {
+        cout << "Exception caught" << endl;
+        cout << "Error msg: " << e.fam_error_msg() << endl;
+        cout << "Error: " << e.fam_error() << endl;
+        ret = -1;
+    }
+
+    // Destroying the region
+    my_fam->fam_destroy_region(desc);
+
+    my_fam->fam_finalize("default");
+    cout << "fam finalize successful" << endl;
+    return ret;
+}
@@ -0,0 +1,198 @@
+/*
+ * fam_local_bypass_test.cpp
+ * Copyright (c) 2019 Hewlett Packard Enterprise Development, LP. All rights
+ * reserved. Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ *    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * See https://spdx.org/licenses/BSD-3-Clause
+ *
+ */
+#include <fam/fam_exception.h>
+#include <iostream>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+
+#include <fam/fam.h>
+
+#include "common/fam_test_config.h"
+
+#define REGION_SIZE 1048576
+#define ITEM_SIZE 65536
+#define NUM_ELEMENTS 256
+
+using namespace std;
+using namespace openfam;
+
+/*
+ * Datapath operations on a memory server sharing the host with the PE go
+ * through its heaps directly. Checks that they see the same data as the
+ * memory server, enforce the access it granted, and follow the heap of a
+ * region as it grows or is destroyed and created again.
+ */
+
+/*
+ * Writes a pattern starting from seed and reads it back, whole and with
+ * indexed and strided gathers
+ */
+static int check_put_get(fam *my_fam, Fam_Descriptor *item, uint64_t seed) {
+    uint64_t *out = new uint64_t[ITEM_SIZE / sizeof(uint64_t)];
+    uint64_t *in = new uint64_t[ITEM_SIZE / sizeof(uint64_t)];
+    uint64_t elementIndex[NUM_ELEMENTS];
+    uint64_t nWords = ITEM_SIZE / sizeof(uint64_t);
+    int ret = 0;
+
+    for (uint64_t i = 0; i < nWords; i++)
+        out[i] = seed + i;
+    my_fam->fam_put_blocking(out, item, 0, ITEM_SIZE);
+    my_fam->fam_get_blocking(in, item, 0, ITEM_SIZE);
+    if (memcmp(in, out, ITEM_SIZE) != 0) {
+        cout << "fam_get_blocking returned wrong data" << endl;
+        ret = -1;
+    }
+
+    // Sparse elements, far apart, in decreasing order
+    for (uint64_t i = 0; i < NUM_ELEMENTS; i++)
+        elementIndex[i] = (NUM_ELEMENTS - 1 - i) * (nWords / NUM_ELEMENTS);
+    memset(in, 0, ITEM_SIZE);
+    my_fam->fam_gather_blocking(in, item, NUM_ELEMENTS, elementIndex,
+                                sizeof(uint64_t));
+    for (uint64_t i = 0; i < NUM_ELEMENTS; i++) {
+        if (in[i] != seed + elementIndex[i]) {
+            cout << "indexed gather returned wrong element " << i << endl;
+            ret = -1;
+            break;
+        }
+    }
+
+    memset(in, 0, ITEM_SIZE);
+    my_fam->fam_gather_blocking(in, item, NUM_ELEMENTS, 1, 3,
+                                sizeof(uint64_t));
+    for (uint64_t i = 0; i < NUM_ELEMENTS; i++) {
+        if (in[i] != seed + 1 + i * 3) {
+            cout << "strided gather returned wrong element " << i << endl;
+            ret = -1;
+            break;
+        }
+    }
+
+    delete[] out;
+    delete[] in;
+    return ret;
+}
+
+int main() {
+    fam *my_fam = new fam();
+    Fam_Options fam_opts;
+    Fam_Region_Descriptor *desc;
+    Fam_Descriptor *item;
+    int ret = 0;
+
+    memset((void *)&fam_opts, 0, sizeof(Fam_Options));
+
+    fam_opts.memoryServer = strdup(TEST_MEMORY_SERVER);
+    fam_opts.grpcPort = strdup(TEST_GRPC_PORT);
+    fam_opts.libfabricPort = strdup(TEST_LIBFABRIC_PORT);
+    fam_opts.allocator = strdup(TEST_ALLOCATOR);
+
+    if (my_fam->fam_initialize("default", &fam_opts) < 0) {
+        cout << "fam initialization failed" << endl;
+        exit(1);
+    } else {
+        cout << "fam initialization successful" << endl;
+    }
+
+    desc = my_fam->fam_create_region("bypass", REGION_SIZE, 0777, RAID1);
+    if (desc == NULL) {
+        cout << "fam create region failed" << endl;
+        exit(1);
+    }
+
+    try {
+        item = my_fam->fam_allocate("bypass_item", ITEM_SIZE, 0777, desc);
+        if (check_put_get(my_fam, item, 1) < 0)
+            ret = -1;
+
+        // A looked up item gets its access from the memory server too
+        Fam_Descriptor *lookedUp = my_fam->fam_lookup("bypass_item", "bypass");
+        uint64_t value = 0;
+        my_fam->fam_get_blocking(&value, lookedUp, 8, sizeof(value));
+        if (value != 2) {
+            cout << "looked up item returned wrong data" << endl;
+            ret = -1;
+        }
+        delete lookedUp;
+        my_fam->fam_deallocate(item);
+
+        // Writes to a read-only item must fail on this path as well
+        item = my_fam->fam_allocate("bypass_ro", ITEM_SIZE, 0444, desc);
+        try {
+            my_fam->fam_put_blocking(&value, item, 0, sizeof(value));
+            cout << "write to a read-only item succeeded" << endl;
+            ret = -1;
+        } catch (Fam_Exception &e) {
+            cout << "write to a read-only item failed as expected" << endl;
+        }
+        my_fam->fam_get_blocking(&value, item, 0, sizeof(value));
+        my_fam->fam_deallocate(item);
+
+        // Items in space added after the heap was first accessed; more
+        // than the initial size is allocated so that some land there
+        Fam_Descriptor *filler[2 * REGION_SIZE / ITEM_SIZE];
+        uint64_t numFillers = 0;
+        my_fam->fam_resize_region(desc, 4 * REGION_SIZE);
+        for (uint64_t i = 0; i < 2 * REGION_SIZE / ITEM_SIZE; i++) {
+            string name = "bypass_fill_" + to_string(i);
+            filler[numFillers++] =
+                my_fam->fam_allocate(name.c_str(), ITEM_SIZE, 0777, desc);
+            if (check_put_get(my_fam, filler[i], i * 1000) < 0) {
+                cout << "item " << i << " after resize failed" << endl;
+                ret = -1;
+                break;
+            }
+        }
+        for (uint64_t i = 0; i < numFillers; i++)
+            my_fam->fam_deallocate(filler[i]);
+        my_fam->fam_destroy_region(desc);
+
+        // A region created again, likely with the same id, gets a new heap
+        desc = my_fam->fam_create_region("bypass", REGION_SIZE, 0777, RAID1);
+        item = my_fam->fam_allocate("bypass_item", ITEM_SIZE, 0777, desc);
+        if (check_put_get(my_fam, item, 7) < 0)
+            ret = -1;
+        my_fam->fam_deallocate(item);
+    } catch (Fam_Exception &e) {
+        cout << "Exception caught" << endl;
+        cout << "Error msg: " << e.fam_error_msg() << endl;
+        cout << "Error: " << e.fam_error() << endl;
+        ret = -1;
+    }
+
+    // Destroying the region
+    my_fam->fam_destroy_region(desc);
+
+    my_fam->fam_finalize("default");
+    cout << "fam finalize successful" << endl;
+    return ret;
+}
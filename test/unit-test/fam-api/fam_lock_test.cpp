@@ -0,0 +1,220 @@
+/*
+ * fam_lock_test.cpp
+ * Copyright (c) 2019 Hewlett Packard Enterprise Development, LP. All rights
+ * reserved. Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ *    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * See https://spdx.org/licenses/BSD-3-Clause
+ *
+ */
+#include <atomic>
+#include <fam/fam_exception.h>
+#include <iostream>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <fam/fam.h>
+
+#include "common/fam_test_config.h"
+
+#define NUM_THREADS 4
+#define NUM_ITERATIONS 200
+
+using namespace std;
+using namespace openfam;
+
+fam *my_fam;
+Fam_Descriptor *counterItem;
+std::atomic<int> failures(0);
+std::atomic<int> writers(0);
+std::atomic<int> readers(0);
+
+// Increments a counter in FAM with a get and a put, under the lock
+void *mutex_func(void *arg) {
+    int id = (int)(uint64_t)arg;
+    try {
+        fam_lock_t *lock = my_fam->fam_lock_open("mutex_item", "test");
+        for (int i = 0; i < NUM_ITERATIONS; i++) {
+            if ((i % 4) == 0) {
+                if (!my_fam->fam_timedlock(lock, 10000000)) {
+                    cout << "Thread " << id << ": timed lock expired" << endl;
+                    failures++;
+                    continue;
+                }
+            } else {
+                my_fam->fam_lock(lock);
+            }
+            if (++writers != 1)
+                failures++;
+            uint64_t value;
+            my_fam->fam_get_blocking(&value, counterItem, 0, sizeof(value));
+            value++;
+            my_fam->fam_put_blocking(&value, counterItem, 0, sizeof(value));
+            writers--;
+            my_fam->fam_unlock(lock);
+        }
+        my_fam->fam_lock_close(lock);
+    } catch (Fam_Exception &e) {
+        cout << "Thread " << id << ": " << e.fam_error_msg() << endl;
+        failures++;
+    }
+    pthread_exit(NULL);
+}
+
+// Half of the threads read, the others write
+void *rw_func(void *arg) {
+    int id = (int)(uint64_t)arg;
+    try {
+        fam_lock_t *lock = my_fam->fam_lock_open("rw_item", "test");
+        for (int i = 0; i < NUM_ITERATIONS; i++) {
+            if (id % 2) {
+                my_fam->fam_rdlock(lock);
+                readers++;
+                if (writers != 0)
+                    failures++;
+                readers--;
+            } else {
+                my_fam->fam_lock(lock);
+                if ((++writers != 1) || (readers != 0))
+                    failures++;
+                writers--;
+            }
+            my_fam->fam_unlock(lock);
+        }
+        my_fam->fam_lock_close(lock);
+    } catch (Fam_Exception &e) {
+        cout << "Thread " << id << ": " << e.fam_error_msg() << endl;
+        failures++;
+    }
+    pthread_exit(NULL);
+}
+
+int run_threads(void *(*func)(void *)) {
+    pthread_t thr[NUM_THREADS];
+    int rc;
+
+    for (uint64_t i = 0; i < NUM_THREADS; ++i) {
+        if ((rc = pthread_create(&thr[i], NULL, func, (void *)i))) {
+            fprintf(stderr, "error: pthread_create, rc: %d\n", rc);
+            return -1;
+        }
+    }
+    for (int i = 0; i < NUM_THREADS; ++i) {
+        pthread_join(thr[i], NULL);
+    }
+    return 0;
+}
+
+int main() {
+    Fam_Options fam_opts;
+    Fam_Region_Descriptor *desc;
+
+    my_fam = new fam();
+    memset((void *)&fam_opts, 0, sizeof(Fam_Options));
+
+    fam_opts.memoryServer = strdup(TEST_MEMORY_SERVER);
+    fam_opts.grpcPort = strdup(TEST_GRPC_PORT);
+    fam_opts.libfabricPort = strdup(TEST_LIBFABRIC_PORT);
+    fam_opts.allocator = strdup(TEST_ALLOCATOR);
+
+    if (my_fam->fam_initialize("default", &fam_opts) < 0) {
+        cout << "fam initialization failed" << endl;
+        exit(1);
+    } else {
+        cout << "fam initialization successful" << endl;
+    }
+
+    desc = my_fam->fam_create_region("test", 8388608, 0777, RAID1);
+    if (desc == NULL) {
+        cout << "fam create region failed" << endl;
+        exit(1);
+    }
+
+    try {
+        counterItem = my_fam->fam_allocate("counter", sizeof(uint64_t), 0777,
+                                           desc);
+        uint64_t zero = 0;
+        my_fam->fam_put_blocking(&zero, counterItem, 0, sizeof(zero));
+
+        fam_lock_t *mutex = my_fam->fam_lock_create(
+            "mutex_item", desc, FAM_LOCK_MUTEX, NUM_THREADS + 2);
+
+        // A held lock can be neither tried nor waited for
+        fam_lock_t *other = my_fam->fam_lock_open("mutex_item", "test");
+        my_fam->fam_lock(mutex);
+        if (my_fam->fam_trylock(other) || my_fam->fam_timedlock(other, 1000)) {
+            cout << "Held lock was taken" << endl;
+            failures++;
+        }
+        my_fam->fam_unlock(mutex);
+        if (!my_fam->fam_trylock(other)) {
+            cout << "Free lock was not taken" << endl;
+            failures++;
+        } else {
+            my_fam->fam_unlock(other);
+        }
+        my_fam->fam_lock_close(other);
+
+        run_threads(mutex_func);
+        uint64_t value;
+        my_fam->fam_get_blocking(&value, counterItem, 0, sizeof(value));
+        if (value != NUM_THREADS * NUM_ITERATIONS) {
+            cout << "Counter is " << value << endl;
+            failures++;
+        }
+        my_fam->fam_lock_destroy(mutex);
+
+        fam_lock_t *rw =
+            my_fam->fam_lock_create("rw_item", desc, FAM_LOCK_RW, NUM_THREADS);
+        // Readers share the lock, and keep writers out
+        fam_lock_t *reader = my_fam->fam_lock_open("rw_item", "test");
+        if (!my_fam->fam_tryrdlock(rw)) {
+            cout << "Free lock was not taken" << endl;
+            failures++;
+        }
+        my_fam->fam_rdlock(reader);
+        my_fam->fam_unlock(rw);
+        if (my_fam->fam_trylock(rw) || my_fam->fam_timedlock(rw, 1000)) {
+            cout << "Writer got in with a reader" << endl;
+            failures++;
+        }
+        my_fam->fam_unlock(reader);
+        my_fam->fam_lock_close(reader);
+
+        run_threads(rw_func);
+        my_fam->fam_lock_destroy(rw);
+        my_fam->fam_deallocate(counterItem);
+    } catch (Fam_Exception &e) {
+        cout << "Error: " << e.fam_error_msg() << endl;
+        failures++;
+    }
+
+    // Destroying the region
+    my_fam->fam_destroy_region(desc);
+
+    my_fam->fam_finalize("default");
+    cout << "fam finalize successful" << endl;
+    return failures ? -1 : 0;
+}
@@ -0,0 +1,145 @@
+/*
+ * fam_reduce_test.cpp
+ * Copyright (c) 2019 Hewlett Packard Enterprise Development, LP. All rights
+ * reserved. Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ *    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * See https://spdx.org/licenses/BSD-3-Clause
+ *
+ */
+#include <fam/fam_exception.h>
+#include <iostream>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <fam/fam.h>
+
+#include "common/fam_test_config.h"
+
+#define NUM_ELEMENTS 100003
+
+using namespace std;
+using namespace openfam;
+
+int main() {
+    fam *my_fam = new fam();
+    Fam_Options fam_opts;
+    Fam_Region_Descriptor *desc;
+    Fam_Descriptor *item;
+    int ret = 0;
+
+    memset((void *)&fam_opts, 0, sizeof(Fam_Options));
+
+    fam_opts.memoryServer = strdup(TEST_MEMORY_SERVER);
+    fam_opts.grpcPort = strdup(TEST_GRPC_PORT);
+    fam_opts.libfabricPort = strdup(TEST_LIBFABRIC_PORT);
+    fam_opts.allocator = strdup(TEST_ALLOCATOR);
+
+    if (my_fam->fam_initialize("default", &fam_opts) < 0) {
+        cout << "fam initialization failed" << endl;
+        exit(1);
+    } else {
+        cout << "fam initialization successful" << endl;
+    }
+
+    desc = my_fam->fam_create_region("test", 8388608, 0777, RAID1);
+    if (desc == NULL) {
+        cout << "fam create region failed" << endl;
+        exit(1);
+    }
+
+    uint64_t itemSize = NUM_ELEMENTS * sizeof(int64_t);
+    int64_t *values = new int64_t[NUM_ELEMENTS];
+    double *reals = (double *)values;
+    try {
+        item = my_fam->fam_allocate("reduce_item", itemSize, 0777, desc);
+
+        int64_t sum = 0;
+        for (int64_t i = 0; i < NUM_ELEMENTS; i++) {
+            values[i] = (i % 2) ? i : -i;
+            sum += values[i];
+        }
+        my_fam->fam_put_blocking(values, item, 0, itemSize);
+
+        int64_t result;
+        my_fam->fam_reduce(item, 0, NUM_ELEMENTS, FAM_INT64, FAM_REDUCE_SUM,
+                           &result);
+        if (result != sum) {
+            cout << "Sum " << result << " expected " << sum << endl;
+            ret = -1;
+        }
+        my_fam->fam_reduce(item, 0, NUM_ELEMENTS, FAM_INT64, FAM_REDUCE_MIN,
+                           &result);
+        if (result != -(NUM_ELEMENTS - 1)) {
+            cout << "Min " << result << endl;
+            ret = -1;
+        }
+        // Skips the first element
+        my_fam->fam_reduce(item, sizeof(int64_t), NUM_ELEMENTS - 1, FAM_INT64,
+                           FAM_REDUCE_MAX, &result);
+        if (result != NUM_ELEMENTS - 2) {
+            cout << "Max " << result << endl;
+            ret = -1;
+        }
+
+        for (int64_t i = 0; i < NUM_ELEMENTS; i++)
+            reals[i] = 0.5;
+        my_fam->fam_put_blocking(reals, item, 0, itemSize);
+        double realSum;
+        my_fam->fam_reduce(item, 0, NUM_ELEMENTS, FAM_DOUBLE, FAM_REDUCE_SUM,
+                           &realSum);
+        if (realSum != NUM_ELEMENTS * 0.5) {
+            cout << "Sum of doubles " << realSum << endl;
+            ret = -1;
+        }
+
+        // Reading past the end of the data item fails
+        try {
+            my_fam->fam_reduce(item, 8, NUM_ELEMENTS, FAM_INT64,
+                               FAM_REDUCE_SUM, &result);
+            cout << "Reduction past the end of the item succeeded" << endl;
+            ret = -1;
+        } catch (Fam_Exception &e) {
+            if (e.fam_error() != FAM_ERR_OUTOFRANGE) {
+                cout << "Unexpected error: " << e.fam_error_msg() << endl;
+                ret = -1;
+            }
+        }
+
+        my_fam->fam_deallocate(item);
+    } catch (Fam_Exception &e) {
+        cout << "Exception caught" << endl;
+        cout << "Error msg: " << e.fam_error_msg() << endl;
+        cout << "Error: " << e.fam_error() << endl;
+        ret = -1;
+    }
+    delete[] values;
+
+    // Destroying the region
+    my_fam->fam_destroy_region(desc);
+
+    my_fam->fam_finalize("default");
+    cout << "fam finalize successful" << endl;
+    return ret;
+}
@@ -0,0 +1,220 @@
+/*
+ * fam_scan_test.cpp
+ * Copyright (c) 2019 Hewlett Packard Enterprise Development, LP. All rights
+ * reserved. Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ *    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * See https://spdx.org/licenses/BSD-3-Clause
+ *
+ */
+#include <fam/fam_exception.h>
+#include <iostream>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+#include <fam/fam.h>
+
+#include "common/fam_test_config.h"
+
+#define NUM_RECORDS 50000
+
+using namespace std;
+using namespace openfam;
+
+typedef struct {
+    int64_t id;
+    double score;
+    int32_t flag;
+    uint32_t pad;
+} Test_Record;
+
+int main() {
+    fam *my_fam = new fam();
+    Fam_Options fam_opts;
+    Fam_Region_Descriptor *desc;
+    Fam_Descriptor *table, *result;
+    int ret = 0;
+
+    memset((void *)&fam_opts, 0, sizeof(Fam_Options));
+
+    fam_opts.memoryServer = strdup(TEST_MEMORY_SERVER);
+    fam_opts.grpcPort = strdup(TEST_GRPC_PORT);
+    fam_opts.libfabricPort = strdup(TEST_LIBFABRIC_PORT);
+    fam_opts.allocator = strdup(TEST_ALLOCATOR);
+
+    if (my_fam->fam_initialize("default", &fam_opts) < 0) {
+        cout << "fam initialization failed" << endl;
+        exit(1);
+    } else {
+        cout << "fam initialization successful" << endl;
+    }
+
+    desc = my_fam->fam_create_region("test", 8388608, 0777, RAID1);
+    if (desc == NULL) {
+        cout << "fam create region failed" << endl;
+        exit(1);
+    }
+
+    uint64_t tableSize = NUM_RECORDS * sizeof(Test_Record);
+    Test_Record *records = new Test_Record[NUM_RECORDS];
+    Test_Record *found = new Test_Record[NUM_RECORDS];
+    uint64_t *indices = (uint64_t *)found;
+    try {
+        table = my_fam->fam_allocate("scan_table", tableSize, 0777, desc);
+        result = my_fam->fam_allocate("scan_result", tableSize, 0777, desc);
+
+        vector<uint64_t> expected;
+        for (int64_t i = 0; i < NUM_RECORDS; i++) {
+            records[i].id = i;
+            records[i].score = (double)((i * 7919) % 1000) / 1000.0;
+            records[i].flag = (int32_t)(i % 3 == 0);
+            records[i].pad = 0;
+            if ((records[i].score > 0.5) && (records[i].flag == 1))
+                expected.push_back((uint64_t)i);
+        }
+        my_fam->fam_put_blocking(records, table, 0, tableSize);
+
+        // Indices of the records with score > 0.5 and flag == 1
+        Fam_Scan_Predicate predicate;
+        memset(&predicate, 0, sizeof(predicate));
+        predicate.combine = FAM_SCAN_AND;
+        predicate.numTerms = 2;
+        predicate.terms[0].fieldOffset = offsetof(Test_Record, score);
+        predicate.terms[0].type = FAM_DOUBLE;
+        predicate.terms[0].op = FAM_CMP_GT;
+        predicate.terms[0].value.f64 = 0.5;
+        predicate.terms[1].fieldOffset = offsetof(Test_Record, flag);
+        predicate.terms[1].type = FAM_INT32;
+        predicate.terms[1].op = FAM_CMP_EQ;
+        predicate.terms[1].value.i32 = 1;
+
+        uint64_t matches =
+            my_fam->fam_scan(table, 0, sizeof(Test_Record), NUM_RECORDS,
+                             &predicate, FAM_SCAN_INDICES, result, 0);
+        if (matches != expected.size()) {
+            cout << "Matches " << matches << " expected " << expected.size()
+                 << endl;
+            ret = -1;
+        } else {
+            my_fam->fam_get_blocking(indices, result, 0,
+                                     matches * sizeof(uint64_t));
+            for (uint64_t i = 0; i < matches; i++) {
+                if (indices[i] != expected[i]) {
+                    cout << "Index " << i << " is " << indices[i]
+                         << " expected " << expected[i] << endl;
+                    ret = -1;
+                    break;
+                }
+            }
+        }
+
+        // Records with id < 10 or id >= NUM_RECORDS - 10, skipping the first
+        memset(&predicate, 0, sizeof(predicate));
+        predicate.combine = FAM_SCAN_OR;
+        predicate.numTerms = 2;
+        predicate.terms[0].fieldOffset = offsetof(Test_Record, id);
+        predicate.terms[0].type = FAM_INT64;
+        predicate.terms[0].op = FAM_CMP_LT;
+        predicate.terms[0].value.i64 = 10;
+        predicate.terms[1].fieldOffset = offsetof(Test_Record, id);
+        predicate.terms[1].type = FAM_INT64;
+        predicate.terms[1].op = FAM_CMP_GE;
+        predicate.terms[1].value.i64 = NUM_RECORDS - 10;
+
+        matches = my_fam->fam_scan(table, sizeof(Test_Record),
+                                   sizeof(Test_Record), NUM_RECORDS - 1,
+                                   &predicate, FAM_SCAN_RECORDS, result, 0);
+        if (matches != 19) {
+            cout << "Matching records " << matches << endl;
+            ret = -1;
+        } else {
+            my_fam->fam_get_blocking(found, result, 0,
+                                     matches * sizeof(Test_Record));
+            for (uint64_t i = 0; i < matches; i++) {
+                int64_t id = (int64_t)((i < 9) ? i + 1 : NUM_RECORDS - 19 + i);
+                if (memcmp(&found[i], &records[id], sizeof(Test_Record))) {
+                    cout << "Record " << i << " is " << found[i].id
+                         << " expected " << id << endl;
+                    ret = -1;
+                    break;
+                }
+            }
+        }
+
+        // Counting only needs no destination
+        matches = my_fam->fam_scan(table, 0, sizeof(Test_Record), NUM_RECORDS,
+                                   &predicate, FAM_SCAN_COUNT, NULL, 0);
+        if (matches != 20) {
+            cout << "Count " << matches << endl;
+            ret = -1;
+        }
+
+        // A term reading past the end of the record is rejected
+        predicate.terms[1].fieldOffset = sizeof(Test_Record) - 4;
+        try {
+            my_fam->fam_scan(table, 0, sizeof(Test_Record), NUM_RECORDS,
+                             &predicate, FAM_SCAN_COUNT, NULL, 0);
+            cout << "Scan with an invalid predicate succeeded" << endl;
+            ret = -1;
+        } catch (Fam_Exception &e) {
+            if (e.fam_error() != FAM_ERR_INVALID) {
+                cout << "Unexpected error: " << e.fam_error_msg() << endl;
+                ret = -1;
+            }
+        }
+
+        // An output other than count, indices or records is rejected
+        predicate.terms[1].fieldOffset = offsetof(Test_Record, id);
+        try {
+            my_fam->fam_scan(table, 0, sizeof(Test_Record), NUM_RECORDS,
+                             &predicate, (Fam_Scan_Output)7, result, 0);
+            cout << "Scan with an invalid output succeeded" << endl;
+            ret = -1;
+        } catch (Fam_Exception &e) {
+            if (e.fam_error() != FAM_ERR_INVALID) {
+                cout << "Unexpected error: " << e.fam_error_msg() << endl;
+                ret = -1;
+            }
+        }
+
+        my_fam->fam_deallocate(result);
+        my_fam->fam_deallocate(table);
+    } catch (Fam_Exception &e) {
+        cout << "Exception caught" << endl;
+        cout << "Error msg: " << e.fam_error_msg() << endl;
+        cout << "Error: " << e.fam_error() << endl;
+        ret = -1;
+    }
+    delete[] found;
+    delete[] records;
+
+    // Destroying the region
+    my_fam->fam_destroy_region(desc);
+
+    my_fam->fam_finalize("default");
+    cout << "fam finalize successful" << endl;
+    return ret;
+}
@@ -0,0 +1,147 @@
+/*
+ * fam_server_stats_test.cpp
+ * Copyright (c) 2019 Hewlett Packard Enterprise Development, LP. All rights
+ * reserved. Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ *    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * See https://spdx.org/licenses/BSD-3-Clause
+ *
+ */
+#include <fam/fam_exception.h>
+#include <iostream>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <fam/fam.h>
+
+#include "common/fam_test_config.h"
+
+#define ITEM_SIZE 4096
+
+using namespace std;
+using namespace openfam;
+
+/*
+ * Sums the usage of all regions open on memory server 0
+ */
+static void region_usage(fam *my_fam, uint64_t &dataitems, uint64_t &allocated,
+                         uint64_t &reserved) {
+    Fam_Server_Stats *stats = my_fam->fam_server_stats(0);
+    dataitems = allocated = reserved = 0;
+    for (uint64_t i = 0; i < stats->numRegions; i++) {
+        dataitems += stats->regions[i].numDataitems;
+        allocated += stats->regions[i].allocatedBytes;
+        reserved += stats->regions[i].reservedBytes;
+    }
+    my_fam->fam_server_stats_free(stats);
+}
+
+int main() {
+    fam *my_fam = new fam();
+    Fam_Options fam_opts;
+    Fam_Region_Descriptor *desc;
+    Fam_Descriptor *item;
+    int ret = 0;
+
+    memset((void *)&fam_opts, 0, sizeof(Fam_Options));
+
+    fam_opts.memoryServer = strdup(TEST_MEMORY_SERVER);
+    fam_opts.grpcPort = strdup(TEST_GRPC_PORT);
+    fam_opts.libfabricPort = strdup(TEST_LIBFABRIC_PORT);
+    fam_opts.allocator = strdup(TEST_ALLOCATOR);
+
+    if (my_fam->fam_initialize("default", &fam_opts) < 0) {
+        cout << "fam initialization failed" << endl;
+        exit(1);
+    } else {
+        cout << "fam initialization successful" << endl;
+    }
+
+    desc = my_fam->fam_create_region("test", 1048576, 0777, RAID1);
+    if (desc == NULL) {
+        cout << "fam create region failed" << endl;
+        exit(1);
+    }
+
+    try {
+        uint64_t dataitems, allocated, reserved;
+        uint64_t baseDataitems, baseAllocated, baseReserved;
+        region_usage(my_fam, baseDataitems, baseAllocated, baseReserved);
+
+        item = my_fam->fam_allocate("stats_item", ITEM_SIZE, 0777, desc);
+        region_usage(my_fam, dataitems, allocated, reserved);
+        if ((dataitems != baseDataitems + 1) ||
+            (allocated != baseAllocated + ITEM_SIZE) ||
+            (reserved < baseReserved + ITEM_SIZE)) {
+            cout << "Allocation not accounted: " << dataitems << " dataitems, "
+                 << allocated << " bytes allocated, " << reserved
+                 << " bytes reserved" << endl;
+            ret = -1;
+        }
+
+        Fam_Server_Stats *stats = my_fam->fam_server_stats(0);
+        if (stats->numHeaps == 0 || stats->numRegions == 0) {
+            cout << "No open heap reported" << endl;
+            ret = -1;
+        }
+        if ((stats->recoveredRegions + stats->recoveryFailures >
+             stats->recoveryRegions) ||
+            (stats->ready && (stats->recoveredRegions +
+                                  stats->recoveryFailures !=
+                              stats->recoveryRegions))) {
+            cout << "Inconsistent recovery status" << endl;
+            ret = -1;
+        }
+        for (uint64_t i = 0; i < stats->numRpcs; i++) {
+            Fam_Server_Rpc_Stats *rpc = &stats->rpcs[i];
+            cout << rpc->rpc << ": " << rpc->calls << " calls, "
+                 << rpc->totalNs << " ns" << endl;
+            if (rpc->calls == 0 || rpc->maxNs > rpc->totalNs) {
+                cout << "Inconsistent statistics of " << rpc->rpc << endl;
+                ret = -1;
+            }
+        }
+        my_fam->fam_server_stats_free(stats);
+
+        my_fam->fam_deallocate(item);
+        region_usage(my_fam, dataitems, allocated, reserved);
+        if ((dataitems != baseDataitems) || (allocated != baseAllocated) ||
+            (reserved != baseReserved)) {
+            cout << "Deallocation not accounted" << endl;
+            ret = -1;
+        }
+    } catch (Fam_Exception &e) {
+        cout << "Exception caught" << endl;
+        cout << "Error msg: " << e.fam_error_msg() << endl;
+        cout << "Error: " << e.fam_error() << endl;
+        ret = -1;
+    }
+
+    // Destroying the region
+    my_fam->fam_destroy_region(desc);
+
+    my_fam->fam_finalize("default");
+    cout << "fam finalize successful" << endl;
+    return ret;
+}
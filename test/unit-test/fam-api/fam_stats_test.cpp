@@ -0,0 +1,127 @@
+/*
+ * fam_stats_test.cpp
+ * Copyright (c) 2019 Hewlett Packard Enterprise Development, LP. All rights
+ * reserved. Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ *    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * See https://spdx.org/licenses/BSD-3-Clause
+ *
+ */
+#include <fam/fam_exception.h>
+#include <iostream>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <fam/fam.h>
+
+#include "common/fam_test_config.h"
+
+#define NUM_OPS 100
+#define ITEM_SIZE 4096
+
+using namespace std;
+using namespace openfam;
+
+int main() {
+    fam *my_fam = new fam();
+    Fam_Options fam_opts;
+    Fam_Region_Descriptor *desc;
+    Fam_Descriptor *item;
+    int ret = 0;
+
+    memset((void *)&fam_opts, 0, sizeof(Fam_Options));
+
+    fam_opts.memoryServer = strdup(TEST_MEMORY_SERVER);
+    fam_opts.grpcPort = strdup(TEST_GRPC_PORT);
+    fam_opts.libfabricPort = strdup(TEST_LIBFABRIC_PORT);
+    fam_opts.allocator = strdup(TEST_ALLOCATOR);
+    fam_opts.famStats = strdup("FAM_STATS_ENABLE");
+
+    if (my_fam->fam_initialize("default", &fam_opts) < 0) {
+        cout << "fam initialization failed" << endl;
+        exit(1);
+    } else {
+        cout << "fam initialization successful" << endl;
+    }
+
+    desc = my_fam->fam_create_region("test", 1048576, 0777, RAID1);
+    if (desc == NULL) {
+        cout << "fam create region failed" << endl;
+        exit(1);
+    }
+
+    try {
+        char local[ITEM_SIZE];
+        memset(local, 'a', ITEM_SIZE);
+        item = my_fam->fam_allocate("stats_item", ITEM_SIZE, 0777, desc);
+        for (int i = 0; i < NUM_OPS; i++)
+            my_fam->fam_put_blocking(local, item, 0, ITEM_SIZE);
+
+        Fam_Stats_Snapshot *snapshot = my_fam->fam_stats_snapshot();
+        uint64_t puts = 0;
+        for (uint64_t i = 0; i < snapshot->numEntries; i++) {
+            Fam_Stats_Entry *entry = &snapshot->entries[i];
+            if (strcmp(entry->api, "fam_put_blocking") != 0)
+                continue;
+            // All puts fall in the same size class
+            if (entry->maxBytes != ITEM_SIZE) {
+                cout << "Unexpected size class " << entry->maxBytes << endl;
+                ret = -1;
+            }
+            if ((entry->p50 > entry->p99) || (entry->p99 > entry->p999) ||
+                (entry->p999 > entry->max)) {
+                cout << "Percentiles out of order" << endl;
+                ret = -1;
+            }
+            puts += entry->count;
+        }
+        if (puts != NUM_OPS) {
+            cout << "Recorded " << puts << " of " << NUM_OPS << " puts" << endl;
+            ret = -1;
+        }
+
+        char *json = my_fam->fam_stats_json(snapshot);
+        cout << json << endl;
+        if (strstr(json, "\"api\":\"fam_put_blocking\"") == NULL) {
+            cout << "fam_put_blocking missing from JSON" << endl;
+            ret = -1;
+        }
+        free(json);
+        my_fam->fam_stats_free(snapshot);
+
+        my_fam->fam_deallocate(item);
+    } catch (Fam_Exception &e) {
+        cout << "Exception caught" << endl;
+        cout << "Error msg: " << e.fam_error_msg() << endl;
+        cout << "Error: " << e.fam_error() << endl;
+        ret = -1;
+    }
+
+    // Destroying the region
+    my_fam->fam_destroy_region(desc);
+
+    my_fam->fam_finalize("default");
+    cout << "fam finalize successful" << endl;
+    return ret;
+}
@@ -0,0 +1,163 @@
+/*
+ * fam_team_test.cpp
+ * Copyright (c) 2019 Hewlett Packard Enterprise Development, LP. All rights
+ * reserved. Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its contributors
+ * may be used to endorse or promote products derived from this software without
+ * specific prior written permission.
+ *
+ *    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ *    INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * See https://spdx.org/licenses/BSD-3-Clause
+ *
+ */
+#include <atomic>
+#include <fam/fam_exception.h>
+#include <iostream>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <fam/fam.h>
+
+#include "common/fam_test_config.h"
+
+// Threads of this process act as the PEs of the team
+#define NUM_PES 4
+#define NUM_ELEMENTS 100
+#define NUM_ITERATIONS 20
+
+using namespace std;
+using namespace openfam;
+
+fam *my_fam;
+std::atomic<int> failures(0);
+
+void *pe_func(void *arg) {
+    int pe = (int)(uint64_t)arg;
+    try {
+        Fam_Team *team = my_fam->fam_team_create(
+            "team_scratch", "test", NUM_ELEMENTS * sizeof(int64_t), NUM_PES,
+            pe);
+
+        for (int64_t iter = 0; iter < NUM_ITERATIONS; iter++) {
+            int64_t values[NUM_ELEMENTS];
+            for (int64_t i = 0; i < NUM_ELEMENTS; i++)
+                values[i] = pe * iter + i;
+            my_fam->fam_allreduce(team, values, NUM_ELEMENTS, FAM_INT64,
+                                  FAM_REDUCE_SUM);
+            for (int64_t i = 0; i < NUM_ELEMENTS; i++) {
+                int64_t expected = 0;
+                for (int64_t p = 0; p < NUM_PES; p++)
+                    expected += p * iter + i;
+                if (values[i] != expected) {
+                    cout << "PE " << pe << ": sum " << values[i]
+                         << " expected " << expected << endl;
+                    failures++;
+                    break;
+                }
+            }
+
+            double maximum = (double)pe;
+            my_fam->fam_allreduce(team, &maximum, 1, FAM_DOUBLE,
+                                  FAM_REDUCE_MAX);
+            if (maximum != NUM_PES - 1) {
+                cout << "PE " << pe << ": max " << maximum << endl;
+                failures++;
+            }
+
+            int root = (int)(iter % NUM_PES);
+            int64_t message[2] = {-1, -1};
+            if (pe == root) {
+                message[0] = iter;
+                message[1] = root;
+            }
+            my_fam->fam_broadcast(team, message, sizeof(message), root);
+            if ((message[0] != iter) || (message[1] != root)) {
+                cout << "PE " << pe << ": broadcast " << message[0] << endl;
+                failures++;
+            }
+
+            my_fam->fam_barrier(team);
+        }
+
+        my_fam->fam_team_destroy(team);
+    } catch (Fam_Exception &e) {
+        cout << "PE " << pe << ": " << e.fam_error_msg() << endl;
+        failures++;
+    }
+    pthread_exit(NULL);
+}
+
+int main() {
+    Fam_Options fam_opts;
+    Fam_Region_Descriptor *desc;
+    pthread_t thr[NUM_PES];
+    int rc;
+
+    my_fam = new fam();
+    memset((void *)&fam_opts, 0, sizeof(Fam_Options));
+
+    fam_opts.memoryServer = strdup(TEST_MEMORY_SERVER);
+    fam_opts.grpcPort = strdup(TEST_GRPC_PORT);
+    fam_opts.libfabricPort = strdup(TEST_LIBFABRIC_PORT);
+    fam_opts.allocator = strdup(TEST_ALLOCATOR);
+
+    if (my_fam->fam_initialize("default", &fam_opts) < 0) {
+        cout << "fam initialization failed" << endl;
+        exit(1);
+    } else {
+        cout << "fam initialization successful" << endl;
+    }
+
+    desc = my_fam->fam_create_region("test", 8388608, 0777, RAID1);
+    if (desc == NULL) {
+        cout << "fam create region failed" << endl;
+        exit(1);
+    }
+
+    for (uint64_t i = 0; i < NUM_PES; ++i) {
+        if ((rc = pthread_create(&thr[i], NULL, pe_func, (void *)i))) {
+            fprintf(stderr, "error: pthread_create, rc: %d\n", rc);
+            return -1;
+        }
+    }
+
+    for (int i = 0; i < NUM_PES; ++i) {
+        pthread_join(thr[i], NULL);
+    }
+
+    // The scratch data item is gone once the team is destroyed
+    try {
+        Fam_Descriptor *item = my_fam->fam_lookup("team_scratch", "test");
+        if (item != NULL) {
+            cout << "Scratch data item still exists" << endl;
+            failures++;
+        }
+    } catch (Fam_Exception &e) {
+    }
+
+    // Destroying the region
+    my_fam->fam_destroy_region(desc);
+
+    my_fam->fam_finalize("default");
+    cout << "fam finalize successful" << endl;
+    return failures ? -1 : 0;
+}